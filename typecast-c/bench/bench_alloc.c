@@ -0,0 +1,87 @@
+/**
+ * Typecast C SDK benchmark - allocation counting
+ *
+ * On glibc, malloc / calloc / realloc are wrapped around their __libc_
+ * entry points and counted per thread while tracking is on. Sanitised
+ * builds bring their own allocator, so nothing is counted there.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bench_alloc.h"
+
+#if defined(__has_feature)
+    #if __has_feature(address_sanitizer)
+        #define BENCH_SANITIZED 1
+    #endif
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+    #define BENCH_SANITIZED 1
+#endif
+
+#if defined(__GLIBC__) && !defined(BENCH_SANITIZED)
+#define BENCH_COUNT_ALLOCS 1
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static __thread int alloc_counting;
+static __thread uint64_t alloc_count;
+static __thread uint64_t alloc_bytes;
+
+static void count_alloc(size_t size) {
+    if (!alloc_counting) return;
+    alloc_count++;
+    alloc_bytes += size;
+}
+
+void* malloc(size_t size) {
+    count_alloc(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    count_alloc(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    count_alloc(size);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+#endif
+
+void bench_alloc_track(int on) {
+#ifdef BENCH_COUNT_ALLOCS
+    alloc_counting = on;
+#else
+    (void)on;
+#endif
+}
+
+void bench_alloc_read(uint64_t* count, uint64_t* bytes) {
+#ifdef BENCH_COUNT_ALLOCS
+    *count = alloc_count;
+    *bytes = alloc_bytes;
+#else
+    *count = 0;
+    *bytes = 0;
+#endif
+}
+
+int bench_alloc_counted(void) {
+#ifdef BENCH_COUNT_ALLOCS
+    return 1;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,19 @@
+/**
+ * Typecast C SDK benchmark - allocation counting
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BENCH_ALLOC_H
+#define TYPECAST_BENCH_ALLOC_H
+
+#include <stdint.h>
+
+/* Count the calling thread's allocations while `on` */
+void bench_alloc_track(int on);
+/* The calling thread's totals so far; zero when not counted */
+void bench_alloc_read(uint64_t* count, uint64_t* bytes);
+/* Whether this build counts allocations at all */
+int bench_alloc_counted(void);
+
+#endif /* TYPECAST_BENCH_ALLOC_H */
@@ -0,0 +1,93 @@
+/**
+ * Typecast C SDK benchmark - response bodies
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_payload.h"
+
+static void put_le32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void put_le16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+/* 16-bit mono 44.1 kHz WAV of `size` bytes in total */
+uint8_t* bench_wav(size_t size) {
+    if (size < 44) size = 44;
+    uint8_t* wav = (uint8_t*)malloc(size);
+    if (!wav) return NULL;
+    memcpy(wav, "RIFF", 4);
+    put_le32(wav + 4, (uint32_t)(size - 8));
+    memcpy(wav + 8, "WAVEfmt ", 8);
+    put_le32(wav + 16, 16);
+    put_le16(wav + 20, 1);
+    put_le16(wav + 22, 1);
+    put_le32(wav + 24, 44100);
+    put_le32(wav + 28, 44100 * 2);
+    put_le16(wav + 32, 2);
+    put_le16(wav + 34, 16);
+    memcpy(wav + 36, "data", 4);
+    put_le32(wav + 40, (uint32_t)(size - 44));
+    for (size_t i = 44; i < size; i++) wav[i] = (uint8_t)(i * 31u);
+    return wav;
+}
+
+static char* base64_encode(const uint8_t* data, size_t len, size_t* out_len) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t n = (len + 2) / 3 * 4;
+    char* out = (char*)malloc(n + 1);
+    if (!out) return NULL;
+    char* p = out;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < len) v |= data[i + 2];
+        *p++ = table[(v >> 18) & 63];
+        *p++ = table[(v >> 12) & 63];
+        *p++ = i + 1 < len ? table[(v >> 6) & 63] : '=';
+        *p++ = i + 2 < len ? table[v & 63] : '=';
+    }
+    *p = '\0';
+    *out_len = n;
+    return out;
+}
+
+/* A with-timestamps body: the WAV as base64 plus one word per six
+ * characters of text */
+char* bench_timestamps_json(const uint8_t* wav, size_t wav_len, size_t text_chars, size_t* out_len) {
+    size_t b64_len = 0;
+    char* b64 = base64_encode(wav, wav_len, &b64_len);
+    if (!b64) return NULL;
+    size_t words = text_chars / 6 + 1;
+    size_t cap = b64_len + words * 64 + 256;
+    char* json = (char*)malloc(cap);
+    if (!json) {
+        free(b64);
+        return NULL;
+    }
+    double duration = (double)(wav_len - 44) / (44100.0 * 2.0);
+    size_t len = (size_t)snprintf(json, cap,
+        "{\"audio\":\"%s\",\"audio_format\":\"wav\",\"audio_duration\":%.3f,\"words\":[", b64, duration);
+    free(b64);
+    for (size_t i = 0; i < words; i++) {
+        double start = duration * (double)i / (double)words;
+        double end = duration * (double)(i + 1) / (double)words;
+        len += (size_t)snprintf(json + len, cap - len, "%s{\"text\":\"word%zu\",\"start\":%.3f,\"end\":%.3f}",
+            i ? "," : "", i, start, end);
+    }
+    len += (size_t)snprintf(json + len, cap - len, "],\"characters\":null}");
+    *out_len = len;
+    return json;
+}
@@ -0,0 +1,26 @@
+/**
+ * Typecast C SDK benchmark - response bodies
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BENCH_PAYLOAD_H
+#define TYPECAST_BENCH_PAYLOAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint8_t* wav;
+    size_t wav_len;
+    char* timestamps_json;
+    size_t timestamps_len;
+} Payload;
+
+/* 16-bit mono 44.1 kHz WAV of `size` bytes in total (at least 44) */
+uint8_t* bench_wav(size_t size);
+/* A with-timestamps body: the WAV as base64 plus one word per six
+ * characters of text */
+char* bench_timestamps_json(const uint8_t* wav, size_t wav_len, size_t text_chars, size_t* out_len);
+
+#endif /* TYPECAST_BENCH_PAYLOAD_H */
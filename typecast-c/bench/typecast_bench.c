@@ -0,0 +1,403 @@
+/**
+ * Typecast C SDK benchmark
+ *
+ * Drives the TTS, streaming, compose and with-timestamps paths against the
+ * local mock server (tests/mock_server.h) and prints one JSON object per
+ * scenario on stdout, so runs can be diffed and plotted:
+ *
+ *   {"path":"tts","text_chars":200,"response_bytes":65536,"concurrency":4,
+ *    "calls":400,"errors":0,"new_connections":0,"seconds":0.41,"rps":975.6,
+ *    "p50_us":3890,"p99_us":7012,"max_us":9120,"allocs_per_call":41.2,
+ *    "alloc_bytes_per_call":70213.0}
+ *
+ * The sweep covers text sizes (short sentences up to the 2000-character
+ * limit), response sizes (a few KiB up to multi-MiB WAV) and concurrency
+ * levels on one thread-safe client. Latency is measured per call around
+ * the public API; the first call of every worker warms its connection and
+ * is not counted, and new_connections is how many connections the timed
+ * calls opened on top of those. Allocations are counted per calling
+ * thread through a malloc shim on glibc (the mock server's own threads
+ * are not counted); elsewhere the allocation fields are null.
+ *
+ * Usage: typecast_bench [--quick] [--calls N] [--path NAME]
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+#include "bench_alloc.h"
+#include "bench_payload.h"
+
+/* ============================================
+ * Scenarios
+ * ============================================ */
+
+typedef enum {
+    PATH_TTS,
+    PATH_STREAM,
+    PATH_COMPOSE,
+    PATH_TIMESTAMPS,
+    PATH_TIMESTAMPS_DECODED,
+    PATH_COUNT
+} BenchPath;
+
+static const char* const PATH_NAMES[PATH_COUNT] = {
+    "tts", "stream", "compose", "timestamps", "timestamps_decoded"
+};
+
+typedef struct {
+    size_t text_chars;
+    size_t response_bytes;
+    int concurrency;
+} Scenario;
+
+/* Text sweep, response sweep and concurrency sweep around a 200-character,
+ * 64 KiB, single-threaded baseline */
+static const Scenario SCENARIOS[] = {
+    {16, 64 * 1024, 1},
+    {200, 64 * 1024, 1},
+    {2000, 64 * 1024, 1},
+    {200, 4 * 1024, 1},
+    {200, 1024 * 1024, 1},
+    {200, 8 * 1024 * 1024, 1},
+    {200, 64 * 1024, 4},
+    {200, 64 * 1024, 16},
+};
+
+#define SCENARIO_COUNT (sizeof(SCENARIOS) / sizeof(SCENARIOS[0]))
+
+/* Calls per scenario: bounded by the bytes moved, so the multi-MiB rows
+ * do not dominate the run */
+#define BYTES_BUDGET (256u * 1024u * 1024u)
+#define MIN_CALLS 50
+#define MAX_CALLS 400
+
+#define STREAM_CHUNK_SIZE 16384
+
+/* ============================================
+ * Mock responses (bodies from bench_payload.c)
+ * ============================================ */
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    const Payload* payload = (const Payload*)user_data;
+    if (strncmp(req->path, "/v1/text-to-speech/with-timestamps", 34) == 0) {
+        snprintf(resp->headers, sizeof(resp->headers), "Content-Type: application/json\r\n");
+        resp->body = (const uint8_t*)payload->timestamps_json;
+        resp->body_len = payload->timestamps_len;
+        return;
+    }
+    snprintf(resp->headers, sizeof(resp->headers), "Content-Type: audio/wav\r\n");
+    resp->body = payload->wav;
+    resp->body_len = payload->wav_len;
+    if (strcmp(req->path, "/v1/text-to-speech/stream") == 0) resp->chunk_size = STREAM_CHUNK_SIZE;
+}
+
+/* ============================================
+ * Workers
+ * ============================================ */
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int ready;
+    int go;
+} StartGate;
+
+typedef struct {
+    TypecastClient* client;
+    BenchPath path;
+    const char* text;
+    int calls;
+    StartGate* gate;
+    int64_t* latencies_us;          /* calls entries */
+    int errors;
+    char first_error[256];
+    uint64_t allocs;
+    uint64_t alloc_bytes;
+} Worker;
+
+static int64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int discard_chunk(const uint8_t* data, size_t len, void* user_data) {
+    (void)data;
+    *(size_t*)user_data += len;
+    return 0;
+}
+
+static int run_call(Worker* w) {
+    switch (w->path) {
+        case PATH_TTS: {
+            TypecastTTSRequest req = {0};
+            req.text = w->text;
+            req.voice_id = "tc_bench";
+            req.model = TYPECAST_MODEL_SSFM_V30;
+            TypecastTTSResponse* resp = typecast_text_to_speech(w->client, &req);
+            typecast_tts_response_free(resp);
+            return resp != NULL;
+        }
+        case PATH_STREAM: {
+            TypecastTTSRequestStream req = {0};
+            req.text = w->text;
+            req.voice_id = "tc_bench";
+            req.model = TYPECAST_MODEL_SSFM_V30;
+            size_t received = 0;
+            return typecast_text_to_speech_stream(w->client, &req, discard_chunk, &received) == TYPECAST_OK;
+        }
+        case PATH_COMPOSE: {
+            TypecastSpeechComposer* composer = typecast_speech_composer_create(w->client);
+            if (!composer) return 0;
+            TypecastComposerSettings defaults = {0};
+            defaults.voice_id = "tc_bench";
+            defaults.use_model = 1;
+            defaults.model = TYPECAST_MODEL_SSFM_V30;
+            int ok = typecast_speech_composer_defaults(composer, &defaults) == TYPECAST_OK &&
+                     typecast_speech_composer_say(composer, w->text, NULL) == TYPECAST_OK &&
+                     typecast_speech_composer_pause(composer, 0.2f) == TYPECAST_OK;
+            TypecastTTSResponse* resp = ok ? typecast_speech_composer_generate(composer, TYPECAST_AUDIO_FORMAT_WAV) : NULL;
+            typecast_tts_response_free(resp);
+            typecast_speech_composer_destroy(composer);
+            return resp != NULL;
+        }
+        case PATH_TIMESTAMPS:
+        case PATH_TIMESTAMPS_DECODED: {
+            TypecastTTSRequestWithTimestamps req = {0};
+            req.text = w->text;
+            req.voice_id = "tc_bench";
+            req.model = TYPECAST_MODEL_SSFM_V30;
+            if (w->path == PATH_TIMESTAMPS_DECODED) {
+                TypecastTTSWithTimestampsDecodedResponse* decoded = NULL;
+                TypecastErrorCode rc = typecast_text_to_speech_with_timestamps_decoded(w->client, &req, NULL, NULL,
+                    &decoded);
+                typecast_tts_with_timestamps_decoded_response_free(decoded);
+                return rc == TYPECAST_OK;
+            }
+            TypecastTTSWithTimestampsResponse* resp = NULL;
+            TypecastErrorCode rc = typecast_text_to_speech_with_timestamps(w->client, &req, &resp);
+            typecast_tts_with_timestamps_response_free(resp);
+            return rc == TYPECAST_OK;
+        }
+        default:
+            return 0;
+    }
+}
+
+/* The client is thread-safe, so its last error belongs to this thread */
+static void worker_failed(Worker* w) {
+    if (w->errors++ > 0) return;
+    const TypecastError* error = typecast_client_get_error(w->client);
+    snprintf(w->first_error, sizeof(w->first_error), "%s",
+             error && error->message ? error->message : "unknown error");
+}
+
+static void* worker_main(void* arg) {
+    Worker* w = (Worker*)arg;
+    if (!run_call(w)) worker_failed(w);
+
+    pthread_mutex_lock(&w->gate->lock);
+    w->gate->ready++;
+    pthread_cond_broadcast(&w->gate->changed);
+    while (!w->gate->go) pthread_cond_wait(&w->gate->changed, &w->gate->lock);
+    pthread_mutex_unlock(&w->gate->lock);
+
+    uint64_t allocs_before, bytes_before;
+    bench_alloc_read(&allocs_before, &bytes_before);
+    for (int i = 0; i < w->calls; i++) {
+        int64_t start = now_us();
+        bench_alloc_track(1);
+        int ok = run_call(w);
+        bench_alloc_track(0);
+        w->latencies_us[i] = now_us() - start;
+        if (!ok) worker_failed(w);
+    }
+    uint64_t allocs_after, bytes_after;
+    bench_alloc_read(&allocs_after, &bytes_after);
+    w->allocs = allocs_after - allocs_before;
+    w->alloc_bytes = bytes_after - bytes_before;
+    return NULL;
+}
+
+static int compare_i64(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int64_t percentile(const int64_t* sorted, size_t n, double p) {
+    if (n == 0) return 0;
+    size_t index = (size_t)(p * (double)(n - 1) + 0.5);
+    return sorted[index < n ? index : n - 1];
+}
+
+static char* make_text(size_t chars) {
+    static const char sentence[] = "The quick brown fox jumps over the lazy dog. ";
+    char* text = (char*)malloc(chars + 1);
+    if (!text) return NULL;
+    for (size_t i = 0; i < chars; i++) text[i] = sentence[i % (sizeof(sentence) - 1)];
+    if (chars > 0 && text[chars - 1] == ' ') text[chars - 1] = '.';
+    text[chars] = '\0';
+    return text;
+}
+
+static int scenario_calls(const Scenario* s, int quick, int fixed_calls) {
+    if (fixed_calls > 0) return fixed_calls;
+    size_t calls = BYTES_BUDGET / s->response_bytes;
+    if (calls < MIN_CALLS) calls = MIN_CALLS;
+    if (calls > MAX_CALLS) calls = MAX_CALLS;
+    if (quick) calls = calls / 10 > 5 ? calls / 10 : 5;
+    return (int)calls;
+}
+
+static int run_scenario(BenchPath path, const Scenario* s, int calls) {
+    Payload payload = {0};
+    payload.wav = bench_wav(s->response_bytes);
+    payload.wav_len = s->response_bytes < 44 ? 44 : s->response_bytes;
+    char* text = make_text(s->text_chars);
+    if (path == PATH_TIMESTAMPS || path == PATH_TIMESTAMPS_DECODED) {
+        payload.timestamps_json = bench_timestamps_json(payload.wav, payload.wav_len, s->text_chars,
+                                                       &payload.timestamps_len);
+    }
+    int per_worker = (calls + s->concurrency - 1) / s->concurrency;
+    int64_t* latencies = (int64_t*)calloc((size_t)per_worker * (size_t)s->concurrency, sizeof(int64_t));
+    Worker* workers = (Worker*)calloc((size_t)s->concurrency, sizeof(Worker));
+    pthread_t* threads = (pthread_t*)calloc((size_t)s->concurrency, sizeof(pthread_t));
+    if (!payload.wav || !text || !latencies || !workers || !threads ||
+        ((path == PATH_TIMESTAMPS || path == PATH_TIMESTAMPS_DECODED) && !payload.timestamps_json)) {
+        fprintf(stderr, "typecast_bench: out of memory\n");
+        return 0;
+    }
+
+    MockServer server;
+    if (!mock_server_start(&server, route, &payload)) {
+        fprintf(stderr, "typecast_bench: mock server failed to start\n");
+        return 0;
+    }
+    char host[64];
+    mock_server_host(&server, host, sizeof(host));
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    options.max_idle_handles = (size_t)s->concurrency;
+    TypecastClient* client = typecast_client_create_with_options("bench-key", host, &options);
+
+    StartGate gate;
+    pthread_mutex_init(&gate.lock, NULL);
+    pthread_cond_init(&gate.changed, NULL);
+    gate.ready = 0;
+    gate.go = 0;
+    for (int i = 0; i < s->concurrency; i++) {
+        workers[i].client = client;
+        workers[i].path = path;
+        workers[i].text = text;
+        workers[i].calls = per_worker;
+        workers[i].gate = &gate;
+        workers[i].latencies_us = latencies + (size_t)i * (size_t)per_worker;
+        pthread_create(&threads[i], NULL, worker_main, &workers[i]);
+    }
+    pthread_mutex_lock(&gate.lock);
+    while (gate.ready < s->concurrency) pthread_cond_wait(&gate.changed, &gate.lock);
+    int64_t started = now_us();
+    int warm_connections = server.connections;
+    gate.go = 1;
+    pthread_cond_broadcast(&gate.changed);
+    pthread_mutex_unlock(&gate.lock);
+    for (int i = 0; i < s->concurrency; i++) pthread_join(threads[i], NULL);
+    double seconds = (double)(now_us() - started) / 1e6;
+    pthread_mutex_lock(&server.lock);
+    int connections = server.connections - warm_connections;
+    pthread_mutex_unlock(&server.lock);
+
+    int errors = 0;
+    const char* first_error = NULL;
+    uint64_t allocs = 0, alloc_bytes = 0;
+    for (int i = 0; i < s->concurrency; i++) {
+        if (workers[i].errors && !first_error) first_error = workers[i].first_error;
+        errors += workers[i].errors;
+        allocs += workers[i].allocs;
+        alloc_bytes += workers[i].alloc_bytes;
+    }
+    if (errors > 0) {
+        fprintf(stderr, "typecast_bench: %s: %d failed calls (%s)\n", PATH_NAMES[path], errors, first_error);
+    }
+    size_t total = (size_t)per_worker * (size_t)s->concurrency;
+    qsort(latencies, total, sizeof(int64_t), compare_i64);
+
+    printf("{\"path\":\"%s\",\"text_chars\":%zu,\"response_bytes\":%zu,\"concurrency\":%d,"
+           "\"calls\":%zu,\"errors\":%d,\"new_connections\":%d,\"seconds\":%.4f,\"rps\":%.1f,"
+           "\"p50_us\":%lld,\"p99_us\":%lld,\"max_us\":%lld,",
+           PATH_NAMES[path], s->text_chars, s->response_bytes, s->concurrency,
+           total, errors, connections, seconds, seconds > 0 ? (double)total / seconds : 0.0,
+           (long long)percentile(latencies, total, 0.50), (long long)percentile(latencies, total, 0.99),
+           (long long)(total ? latencies[total - 1] : 0));
+if (bench_alloc_counted()) {
+        printf("\"allocs_per_call\":%.1f,\"alloc_bytes_per_call\":%.1f}\n",
+               (double)allocs / (double)total, (double)alloc_bytes / (double)total);
+    } else {
+        printf("\"allocs_per_call\":null,\"alloc_bytes_per_call\":null}\n");
+    }
+    fflush(stdout);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+    pthread_cond_destroy(&gate.changed);
+    pthread_mutex_destroy(&gate.lock);
+    free(threads);
+    free(workers);
+    free(latencies);
+    free(text);
+    free(payload.timestamps_json);
+    free(payload.wav);
+    return errors == 0;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: typecast_bench [--quick] [--calls N] [--path NAME]\n"
+        "  --quick      a tenth of the calls, for smoke runs\n"
+        "  --calls N    exactly N calls per scenario\n"
+        "  --path NAME  only one of: tts, stream, compose, timestamps, timestamps_decoded\n");
+}
+
+int main(int argc, char** argv) {
+    int quick = 0;
+    int fixed_calls = 0;
+    int only = -1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = 1;
+        } else if (strcmp(argv[i], "--calls") == 0 && i + 1 < argc) {
+            fixed_calls = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--path") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            for (int p = 0; p < PATH_COUNT; p++) {
+                if (strcmp(name, PATH_NAMES[p]) == 0) only = p;
+            }
+            if (only < 0) {
+                usage();
+                return 2;
+            }
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    int ok = 1;
+    for (int p = 0; p < PATH_COUNT; p++) {
+        if (only >= 0 && p != only) continue;
+        for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+            const Scenario* s = &SCENARIOS[i];
+            if (!run_scenario((BenchPath)p, s, scenario_calls(s, quick, fixed_calls))) ok = 0;
+        }
+    }
+    return ok ? 0 : 1;
+}
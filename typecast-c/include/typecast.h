@@ -70,6 +70,7 @@ extern "C" {
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 /* Library version */
 #define TYPECAST_VERSION_MAJOR 1
@@ -107,6 +108,7 @@ typedef enum {
     TYPECAST_ERROR_CURL_INIT = -3,
     TYPECAST_ERROR_NETWORK = -4,
     TYPECAST_ERROR_JSON_PARSE = -5,
+    TYPECAST_ERROR_CANCELLED = -6,
     TYPECAST_ERROR_BAD_REQUEST = 400,
     TYPECAST_ERROR_UNAUTHORIZED = 401,
     TYPECAST_ERROR_PAYMENT_REQUIRED = 402,
@@ -187,6 +189,9 @@ typedef enum {
 
 typedef struct TypecastClient TypecastClient;
 typedef struct TypecastSpeechComposer TypecastSpeechComposer;
+typedef struct TypecastAsyncJob TypecastAsyncJob;
+typedef struct TypecastCancelToken TypecastCancelToken;
+typedef struct TypecastStreamBuffer TypecastStreamBuffer;
 
 /* ============================================
  * TTS Request
@@ -286,6 +291,18 @@ typedef struct {
     size_t characters_count;                 /* Number of character segments */
 } TypecastTTSWithTimestampsResponse;
 
+/**
+ * Result of typecast_text_to_speech_with_timestamps_decoded.
+ * The audio arrives already decoded, so timestamps.audio_base64 is NULL;
+ * pass &timestamps to the caption helpers as usual.
+ */
+typedef struct {
+    TypecastTTSWithTimestampsResponse timestamps;  /* Format, duration and segments */
+    uint8_t* audio_data;                           /* Decoded audio (NULL when streamed
+                                                      to a callback) */
+    size_t audio_size;                             /* Size of audio_data in bytes */
+} TypecastTTSWithTimestampsDecodedResponse;
+
 /**
  * Output settings for streaming TTS request.
  *
@@ -320,6 +337,19 @@ typedef struct {
  * TTS Response
  * ============================================ */
 
+/**
+ * Memory allocator for response audio (see TypecastClientOptions.allocator).
+ *
+ * Set alloc_fn and free_fn together, or neither for malloc/free.
+ * realloc_fn is optional; without it a buffer grows by alloc, copy and free.
+ */
+typedef struct {
+    void* (*alloc_fn)(size_t size, void* user_data);
+    void* (*realloc_fn)(void* ptr, size_t size, void* user_data);
+    void (*free_fn)(void* ptr, void* user_data);
+    void* user_data;
+} TypecastAllocator;
+
 /**
  * TTS Response structure
  */
@@ -365,6 +395,14 @@ typedef struct {
     int is_pause;
 } TypecastSpeechPart;
 
+/** A part of pause-marked text as a view into the text itself */
+typedef struct {
+    size_t offset;                   /* Text: first byte; pause: where its token starts */
+    size_t length;                   /* Text bytes, 0 for a pause */
+    float pause_seconds;
+    int is_pause;
+} TypecastSpeechSpan;
+
 /* ============================================
  * Voice Model Info
  * ============================================ */
@@ -465,10 +503,333 @@ typedef struct {
     char* message;
 } TypecastError;
 
+/* ============================================
+ * Client Options
+ * ============================================ */
+
+typedef enum {
+    TYPECAST_HTTP_VERSION_DEFAULT = 0,   /* HTTP/2 over TLS, HTTP/1.1 otherwise */
+    TYPECAST_HTTP_VERSION_1_1,           /* always HTTP/1.1 */
+    TYPECAST_HTTP_VERSION_2              /* HTTP/2, also over plain HTTP (prior knowledge) */
+} TypecastHttpVersion;
+
+/* Calls reported through TypecastRequestMetrics */
+typedef enum {
+    TYPECAST_REQUEST_TTS = 0,        /* text_to_speech, generate_to_file / _fp / _fd */
+    TYPECAST_REQUEST_COMPOSE,
+    TYPECAST_REQUEST_STREAM,
+    TYPECAST_REQUEST_TIMESTAMPS,
+    TYPECAST_REQUEST_VOICES,         /* get_voices, get_voice, recommend_voices */
+    TYPECAST_REQUEST_SUBSCRIPTION,
+    TYPECAST_REQUEST_CLONE,
+    TYPECAST_REQUEST_DELETE
+} TypecastRequestType;
+
+/**
+ * Timing of one SDK call that went to the network (cache hits are not
+ * reported). Times are in microseconds.
+ */
+typedef struct {
+    TypecastRequestType type;
+    TypecastErrorCode result;        /* what the call returned */
+    long http_status;                /* of the last attempt, 0 without a response */
+    unsigned int attempts;           /* HTTP requests sent, retries included */
+    int connection_reused;           /* the last attempt needed no new connection */
+    /* Phases of the last attempt, each counted from its start like
+     * libcurl's CURLINFO_*_TIME_T: DNS done, TCP connected, TLS done,
+     * first response byte, complete */
+    int64_t dns_us;
+    int64_t connect_us;
+    int64_t tls_us;
+    int64_t first_byte_us;
+    int64_t transfer_us;
+    /* Start of the call to the first audio handed to a stream or audio
+     * callback, 0 when there was none */
+    int64_t first_audio_us;
+    int64_t call_us;                 /* the whole call, retry waits included */
+    int64_t prepare_us;              /* building and serializing the request */
+    int64_t parse_us;                /* parsing the response and building the result */
+    int64_t decode_us;               /* base64 audio decoding during the call */
+    uint64_t bytes_sent;             /* request bodies, all attempts */
+    uint64_t bytes_received;         /* response bodies as transferred, all attempts */
+    unsigned int hedges;             /* duplicates sent by hedging, see hedge_after_ms */
+    int hedge_won;                   /* the result came from a duplicate */
+    /* Response bodies after content decoding, all attempts; larger than
+     * bytes_received when the server compressed them */
+    uint64_t bytes_decoded;
+} TypecastRequestMetrics;
+
+/**
+ * Receives the metrics of each call, on the thread that made it (for
+ * async jobs, the thread driving the engine). Must not call back into
+ * the client.
+ */
+typedef void (*typecast_metrics_callback_t)(const TypecastRequestMetrics* metrics, void* user_data);
+
+/**
+ * Running totals of a client's TypecastRequestMetrics, see
+ * typecast_client_metrics
+ */
+typedef struct {
+    unsigned long long calls;
+    unsigned long long failed_calls;
+    unsigned long long attempts;
+    unsigned long long reused_connections;   /* calls whose last attempt reused a connection */
+    unsigned long long bytes_sent;
+    unsigned long long bytes_received;
+    unsigned long long call_us;              /* summed call_us */
+    unsigned long long first_byte_us;        /* summed first_byte_us */
+    unsigned long long sdk_us;               /* summed prepare_us + parse_us + decode_us */
+    unsigned long long hedged_calls;         /* calls that sent a duplicate */
+    unsigned long long hedge_wins;           /* of those, answered by the duplicate */
+    unsigned long long bytes_decoded;        /* bytes_received after content decoding */
+} TypecastClientMetrics;
+
+/**
+ * Options for typecast_client_create_with_options().
+ *
+ * Zero-initialize and set only the fields you need; a zero field always
+ * means the default. New fields are only ever appended.
+ */
+typedef struct {
+    /**
+     * Non-zero makes the client safe to share between threads:
+     * - each call checks out its own easy handle from a pool,
+     * - pooled handles share the connection cache, DNS cache and TLS
+     *   sessions (warm connections are reused across threads),
+     * - typecast_client_get_error() reports the last error of the
+     *   calling thread.
+     * The async API of one client must still be driven from one thread
+     * at a time.
+     */
+    int thread_safe;
+    /**
+     * Idle easy handles kept in the pool (0 = 8), and idle connections
+     * kept in the shared connection cache. Thread-safe mode only.
+     */
+    size_t max_idle_handles;
+
+    /* Connection reuse. Connections are kept alive and reused between
+     * requests by default, which avoids a TCP and TLS handshake per call. */
+
+    /** Non-zero turns off TCP keep-alive probes on idle connections. */
+    int disable_tcp_keepalive;
+    /** Idle seconds before the first keep-alive probe (0 = 30). */
+    long tcp_keepalive_idle_secs;
+    /** Seconds between keep-alive probes (0 = 15). */
+    long tcp_keepalive_interval_secs;
+    /** Preferred HTTP version (default: HTTP/2 over TLS, else HTTP/1.1). */
+    TypecastHttpVersion http_version;
+    /** Non-zero closes the connection after every request. */
+    int disable_connection_reuse;
+    /** Max seconds an idle connection is reused (0 = libcurl default, 118). */
+    long max_connection_idle_secs;
+
+    /* Response buffers */
+
+    /** Allocator for TTS audio buffers (zero = malloc/free). */
+    TypecastAllocator allocator;
+    /**
+     * Initial audio buffer size in bytes when the response has no
+     * Content-Length (0 = 4096). When Content-Length is present the buffer
+     * is sized from it and is not reallocated.
+     */
+    size_t response_size_hint;
+
+    /* Voice catalog cache */
+
+    /**
+     * Seconds a typecast_get_voices / typecast_get_voice /
+     * typecast_recommend_voices response is served from the cache
+     * (0 = no cache). An expired entry is revalidated with the ETag the
+     * server sent, when it sent one, so unchanged voices are not
+     * downloaded again. typecast_get_voice is answered from a cached
+     * voice list when that list contains the voice.
+     */
+    unsigned long voice_cache_ttl_secs;
+    /**
+     * Optional file the cache is saved to and loaded from, so a new
+     * process starts warm. Only read back by clients with the same host
+     * and API key; the key itself is not stored.
+     */
+    const char* voice_cache_path;
+
+    /* TTS result cache */
+
+    /**
+     * Bytes of audio kept in memory for repeated typecast_text_to_speech,
+     * typecast_generate_to_file / _fp / _fd and with-timestamps requests
+     * (0 = no memory tier). An identical request is answered from the
+     * cache; least recently used results are evicted past this size.
+     */
+    size_t result_cache_max_bytes;
+    /**
+     * Optional existing directory holding one file per cached result, so
+     * results survive restarts and are shared between processes. Used in
+     * addition to the memory tier, or alone. Never pruned by the SDK.
+     */
+    const char* result_cache_dir;
+    /**
+     * Only requests with a non-zero seed are cached by default, as others
+     * may render differently each time. Non-zero caches them as well.
+     */
+    int result_cache_unseeded;
+
+    /* Rate limiting and retries. They apply to the TTS calls
+     * (text_to_speech, generate_to_file / _fp / _fd, with-timestamps,
+     * compose and stream) and their async jobs, across every thread using
+     * the client. An async job waits for its slot or retry in the job
+     * list, so typecast_async_poll() keeps returning it as running. */
+
+    /**
+     * Times a request answered with 429 or 5xx is sent again (0 = never,
+     * the error is returned at once). Streams are not retried since
+     * their body already went to the callback.
+     */
+    unsigned int max_retries;
+    /**
+     * Backoff before the first retry in milliseconds, doubled for each
+     * further retry, with jitter (0 = 500). A Retry-After header from the
+     * server is used instead when present.
+     */
+    long retry_base_delay_ms;
+    /**
+     * Longest backoff in milliseconds (0 = 30000). A longer Retry-After
+     * ends the retries and returns the error.
+     */
+    long retry_max_delay_ms;
+    /**
+     * Most requests in flight at once (0 = no cap). After a 429 the
+     * client halves its own limit and grows it back by one per round of
+     * successful requests, up to this cap.
+     */
+    int max_concurrent_requests;
+    /**
+     * Non-zero takes the cap from limits.concurrency_limit of
+     * typecast_get_my_subscription, fetched once while the client is
+     * created (a failed lookup keeps max_concurrent_requests). The lower
+     * of the two wins when max_concurrent_requests is also set.
+     */
+    int concurrency_from_subscription;
+
+    /* Timeouts. An expired one fails the request with TYPECAST_ERROR_NETWORK. */
+
+    /**
+     * Whole-request timeout of text_to_speech, generate_to_file / _fp /
+     * _fd, with-timestamps, compose and stream in seconds (0 = 60)
+     */
+    long request_timeout_secs;
+    /** Timeout of voice, subscription and delete requests (0 = 30) */
+    long query_timeout_secs;
+    /** Timeout of voice cloning uploads (0 = 120) */
+    long upload_timeout_secs;
+    /** Time allowed to connect, within the timeouts above (0 = libcurl's 300) */
+    long connect_timeout_secs;
+    /**
+     * Abort a request that transfers fewer than low_speed_limit_bytes per
+     * second for low_speed_time_secs seconds in a row (either 0 = off).
+     * Catches a stalled connection long before the whole-request timeout.
+     */
+    long low_speed_limit_bytes;
+    long low_speed_time_secs;
+
+    /* Metrics */
+
+    /** Called with the metrics of each call, see TypecastRequestMetrics */
+    typecast_metrics_callback_t metrics_callback;
+    void* metrics_user_data;
+
+    /* Hedging. Applies to blocking typecast_text_to_speech calls with a
+     * non-zero seed, which render the same audio whichever request
+     * answers. */
+
+    /**
+     * Send a duplicate of a request that has received no response byte
+     * after this many milliseconds (0 = never). The first definite
+     * answer wins and the other request is cancelled. Each request is
+     * hedged at most once per attempt.
+     */
+    long hedge_after_ms;
+    /**
+     * Non-zero (1-99) derives the delay from that percentile of the first
+     * byte times of recent calls instead, e.g. 95. hedge_after_ms is used
+     * until enough calls were seen.
+     */
+    unsigned int hedge_percentile;
+    /**
+     * Hosts duplicates go to in turn, e.g. other regions (NULL = the
+     * client's host). Copied at create.
+     */
+    const char* const* hedge_hosts;
+    size_t hedge_host_count;
+
+    /* Compression */
+
+    /**
+     * JSON responses (voices, recommendations, subscription and
+     * with-timestamps) are requested compressed with every encoding
+     * libcurl was built with (gzip, deflate, br, zstd) and decoded as
+     * they arrive. Non-zero asks for them uncompressed. Audio bodies are
+     * never compressed.
+     */
+    int disable_compression;
+} TypecastClientOptions;
+
+/**
+ * Per-call limits, see typecast_set_call_options. Zero fields keep the
+ * client's settings.
+ */
+typedef struct {
+    long timeout_ms;                 /* whole-request timeout of each request */
+    long connect_timeout_ms;         /* connect timeout of each request */
+    /**
+     * Time budget shared by every request made under these options,
+     * counted from typecast_set_call_options. Requests, and the waits
+     * before their retries, are cut short to end within it.
+     */
+    long deadline_ms;
+    /**
+     * Token another thread can fire to abort the requests made under these
+     * options (NULL = none). They fail with TYPECAST_ERROR_CANCELLED. Must
+     * outlive those requests, including async jobs.
+     */
+    TypecastCancelToken* cancel;
+} TypecastCallOptions;
+
+/**
+ * Result cache counters, see typecast_result_cache_stats
+ */
+typedef struct {
+    unsigned long long hits;         /* requests answered from the cache */
+    unsigned long long disk_hits;    /* of those, read from result_cache_dir */
+    unsigned long long misses;       /* cacheable requests sent to the API */
+    size_t entries;                  /* results in the memory tier */
+    size_t bytes;                    /* audio bytes in the memory tier */
+} TypecastResultCacheStats;
+
 /* ============================================
  * Client API
  * ============================================ */
 
+/**
+ * Initialize the SDK's process-wide state (libcurl) ahead of the first
+ * client. Optional: clients initialize it on first use, once per process.
+ * Calling it at startup keeps that cost out of the first request, and it
+ * is safe to call from several threads. Calls nest; pair each successful
+ * call with typecast_global_cleanup().
+ *
+ * @return TYPECAST_OK, or TYPECAST_ERROR_CURL_INIT when libcurl fails to
+ *         initialize
+ */
+TYPECAST_API TypecastErrorCode typecast_global_init(void);
+
+/**
+ * Release the state set up by typecast_global_init() once every call has
+ * been paired. Only call it after every client is destroyed; a client
+ * created later initializes the SDK again.
+ */
+TYPECAST_API void typecast_global_cleanup(void);
+
 /**
  * Create a new Typecast client
  *
@@ -489,6 +850,21 @@ TYPECAST_API TypecastClient* typecast_client_create_with_host(
     const char* host
 );
 
+/**
+ * Create a new Typecast client with options
+ *
+ * @param api_key API key for authentication (required)
+ * @param host Custom API host URL, or NULL for the default host
+ * @param options Client options, or NULL for defaults
+ * @return Pointer to TypecastClient, or NULL on failure (including an
+ *         allocator with only one of alloc_fn / free_fn set)
+ */
+TYPECAST_API TypecastClient* typecast_client_create_with_options(
+    const char* api_key,
+    const char* host,
+    const TypecastClientOptions* options
+);
+
 /**
  * Destroy the Typecast client and free resources
  *
@@ -499,6 +875,9 @@ TYPECAST_API void typecast_client_destroy(TypecastClient* client);
 /**
  * Get the last error from the client
  *
+ * For a thread-safe client this is the last error raised on the calling
+ * thread.
+ *
  * @param client Pointer to TypecastClient
  * @return Pointer to TypecastError (valid until next API call)
  */
@@ -506,6 +885,100 @@ TYPECAST_API const TypecastError* typecast_client_get_error(
     const TypecastClient* client
 );
 
+/**
+ * Open a connection to the client's host ahead of the first real request:
+ * resolves the host, completes the TCP and TLS handshakes with a HEAD
+ * request and leaves the connection in the client's connection cache (or
+ * the shared one of a thread_safe client), so the next request skips
+ * them. Any HTTP answer counts as warm.
+ *
+ * With `preload_voices`, the voice catalog (GET /v2/voices without a
+ * filter) is fetched as well, into the voice cache when the client has
+ * one.
+ *
+ * @param client Pointer to TypecastClient
+ * @param preload_voices Non-zero to also fetch the voice catalog
+ * @return TYPECAST_OK, TYPECAST_ERROR_INVALID_PARAM for a NULL client, or
+ *         the transport error (details via typecast_client_get_error)
+ */
+TYPECAST_API TypecastErrorCode typecast_client_warmup(
+    TypecastClient* client,
+    int preload_voices
+);
+
+/**
+ * Apply per-call limits to the following requests of the calling thread
+ * on this client (or of every thread, for a client without thread_safe),
+ * until replaced or cleared with NULL. Requests take the limits when they
+ * start; async jobs keep those of the thread that submitted them.
+ *
+ * @param client Pointer to TypecastClient
+ * @param options Limits to apply, copied; NULL restores the client's
+ * @return TYPECAST_OK, TYPECAST_ERROR_INVALID_PARAM for a NULL client or
+ *         negative values, TYPECAST_ERROR_OUT_OF_MEMORY
+ */
+TYPECAST_API TypecastErrorCode typecast_set_call_options(
+    TypecastClient* client,
+    const TypecastCallOptions* options
+);
+
+/**
+ * Read the running totals of the client's call metrics
+ *
+ * @param client Pointer to TypecastClient
+ * @param out Receives the totals
+ * @return TYPECAST_OK, or TYPECAST_ERROR_INVALID_PARAM for NULL arguments
+ */
+TYPECAST_API TypecastErrorCode typecast_client_metrics(TypecastClient* client, TypecastClientMetrics* out);
+
+/**
+ * Reset the client's metric totals to zero
+ *
+ * @param client Pointer to TypecastClient
+ */
+TYPECAST_API void typecast_client_metrics_reset(TypecastClient* client);
+
+/* ============================================
+ * Cancellation
+ * ============================================ */
+
+/**
+ * Create a cancel token for TypecastCallOptions.cancel. One token may be
+ * shared by any number of requests, clients and threads.
+ *
+ * @return Token, or NULL when out of memory (free with
+ *         typecast_cancel_token_free)
+ */
+TYPECAST_API TypecastCancelToken* typecast_cancel_token_create(void);
+
+/**
+ * Cancel every request using the token, from any thread. Requests in
+ * flight stop within about a second, later ones fail at once.
+ *
+ * @param token Token, NULL is a no-op
+ */
+TYPECAST_API void typecast_cancel_token_cancel(TypecastCancelToken* token);
+
+/**
+ * @param token Token
+ * @return Non-zero once the token was cancelled and not reset
+ */
+TYPECAST_API int typecast_cancel_token_is_cancelled(const TypecastCancelToken* token);
+
+/**
+ * Make a cancelled token usable for new requests again
+ *
+ * @param token Token, NULL is a no-op
+ */
+TYPECAST_API void typecast_cancel_token_reset(TypecastCancelToken* token);
+
+/**
+ * Free a token. No request may still be using it.
+ *
+ * @param token Token, NULL is a no-op
+ */
+TYPECAST_API void typecast_cancel_token_free(TypecastCancelToken* token);
+
 /* ============================================
  * Text-to-Speech API
  * ============================================ */
@@ -526,6 +999,11 @@ TYPECAST_API TypecastTTSResponse* typecast_text_to_speech(
 /**
  * Convert text to speech and write the audio bytes to a file.
  *
+ * Audio is written to a temporary file next to file_path as it arrives and
+ * renamed into place once the response is complete, so memory use does not
+ * grow with the length of the audio and file_path is never left partially
+ * written.
+ *
  * @param client Pointer to TypecastClient
  * @param file_path Destination file path
  * @param request Pointer to GenerateToFileRequest
@@ -537,6 +1015,159 @@ TYPECAST_API TypecastErrorCode typecast_generate_to_file(
     const TypecastGenerateToFileRequest* request
 );
 
+/** What typecast_generate_to_file_with_info() wrote */
+typedef struct {
+    float duration;                  /* seconds, from the response (0 = not reported) */
+    TypecastAudioFormat format;      /* format of the written audio */
+} TypecastGeneratedAudio;
+
+/**
+ * Same as typecast_generate_to_file(), also reporting the duration and
+ * format of the written audio.
+ *
+ * @param client Pointer to TypecastClient
+ * @param file_path Destination file path
+ * @param request Pointer to GenerateToFileRequest
+ * @param out_info Filled on success (may be NULL)
+ * @return TYPECAST_OK on success, otherwise an error code
+ */
+TYPECAST_API TypecastErrorCode typecast_generate_to_file_with_info(
+    TypecastClient* client,
+    const char* file_path,
+    const TypecastGenerateToFileRequest* request,
+    TypecastGeneratedAudio* out_info
+);
+
+/**
+ * Convert text to speech and write the audio bytes to an open stream as
+ * they arrive. The stream is flushed but not closed.
+ *
+ * Without request->output the server's default audio format is used, since
+ * there is no file name to infer it from. On failure part of the audio may
+ * already have been written.
+ *
+ * @param client Pointer to TypecastClient
+ * @param file Destination stream, opened for binary writing
+ * @param request Pointer to GenerateToFileRequest
+ * @return TYPECAST_OK on success, otherwise an error code
+ */
+TYPECAST_API TypecastErrorCode typecast_generate_to_fp(
+    TypecastClient* client,
+    FILE* file,
+    const TypecastGenerateToFileRequest* request
+);
+
+/**
+ * Same as typecast_generate_to_fp(), writing to a file descriptor (a file,
+ * pipe or socket). The descriptor is not closed.
+ *
+ * @param client Pointer to TypecastClient
+ * @param fd Destination file descriptor
+ * @param request Pointer to GenerateToFileRequest
+ * @return TYPECAST_OK on success, otherwise an error code
+ */
+TYPECAST_API TypecastErrorCode typecast_generate_to_fd(
+    TypecastClient* client,
+    int fd,
+    const TypecastGenerateToFileRequest* request
+);
+
+/* ============================================
+ * Batch Generation
+ * ============================================ */
+
+/**
+ * One output of a batch: the file and the request that renders it
+ */
+typedef struct {
+    const char* path;                        /* Required: destination file */
+    TypecastGenerateToFileRequest request;
+} TypecastBatchItem;
+
+typedef enum {
+    TYPECAST_BATCH_ITEM_WRITTEN = 0,         /* rendered and moved into place */
+    TYPECAST_BATCH_ITEM_SKIPPED = 1,         /* the output already existed and was complete */
+    TYPECAST_BATCH_ITEM_FAILED = 2
+} TypecastBatchItemStatus;
+
+/**
+ * Called once per finished item, in completion order, from inside the
+ * batch call. `error` is NULL unless the item failed.
+ */
+typedef void (*typecast_batch_callback_t)(
+    size_t index,
+    const char* path,
+    TypecastBatchItemStatus status,
+    const TypecastError* error,
+    void* user_data
+);
+
+typedef struct {
+    size_t max_in_flight;    /* Requests running at once (0 = 4) */
+    int overwrite;           /* 1 = render items whose output already exists */
+    int stop_on_error;       /* 1 = start no new items after the first failure */
+} TypecastBatchOptions;
+
+typedef struct {
+    size_t written;
+    size_t skipped;
+    size_t failed;
+    size_t not_started;      /* left over by stop_on_error */
+} TypecastBatchSummary;
+
+/**
+ * Render many files, keeping up to max_in_flight requests running on the
+ * client's async engine.
+ *
+ * Every item is written like typecast_generate_to_file(): into a temporary
+ * file next to its path, renamed into place once complete. An item whose
+ * path already holds a complete file is skipped without a request, so a
+ * batch that was interrupted can be run again and only renders what is
+ * missing.
+ *
+ * A failed item does not stop the others (unless stop_on_error is set).
+ * The async engine of the client must not be driven by anyone else during
+ * the call.
+ *
+ * @param client      Pointer to TypecastClient
+ * @param items       Array of `count` items
+ * @param count       Number of items
+ * @param options     Optional; NULL for the defaults
+ * @param on_item     Optional; per-item completion callback
+ * @param user_data   Passed to on_item
+ * @param out_summary Optional; receives the per-status counts
+ * @return TYPECAST_OK when every item was written or skipped, otherwise the
+ *         code of the first failure (its message is the client's last error)
+ */
+TYPECAST_API TypecastErrorCode typecast_generate_batch(
+    TypecastClient* client,
+    const TypecastBatchItem* items,
+    size_t count,
+    const TypecastBatchOptions* options,
+    typecast_batch_callback_t on_item,
+    void* user_data,
+    TypecastBatchSummary* out_summary
+);
+
+/**
+ * Same as typecast_generate_batch(), reading the items from a JSON Lines
+ * manifest: one object per line with "path", "text" and "voice_id", and
+ * optionally "model", "language" and "seed". Blank lines are ignored and
+ * relative paths are resolved against the manifest's directory. The index
+ * passed to on_item counts items, not lines.
+ *
+ * A manifest that cannot be read or has an invalid line fails with
+ * TYPECAST_ERROR_INVALID_PARAM before any item is started.
+ */
+TYPECAST_API TypecastErrorCode typecast_generate_batch_from_manifest(
+    TypecastClient* client,
+    const char* manifest_path,
+    const TypecastBatchOptions* options,
+    typecast_batch_callback_t on_item,
+    void* user_data,
+    TypecastBatchSummary* out_summary
+);
+
 /**
  * Free TTS response
  *
@@ -544,6 +1175,19 @@ TYPECAST_API TypecastErrorCode typecast_generate_to_file(
  */
 TYPECAST_API void typecast_tts_response_free(TypecastTTSResponse* response);
 
+/**
+ * Take ownership of a response's audio buffer, leaving the response empty.
+ *
+ * The buffer was allocated with the client's allocator (malloc when none
+ * was configured) and must be released with the matching free function.
+ * The response itself must still be freed with typecast_tts_response_free.
+ *
+ * @param response Pointer to TTSResponse
+ * @param size Receives the audio size in bytes (may be NULL)
+ * @return Audio buffer, or NULL if the response has none
+ */
+TYPECAST_API uint8_t* typecast_tts_response_take_audio(TypecastTTSResponse* response, size_t* size);
+
 /**
  * Parse pause markup in text. Valid tokens use <|{seconds}s|>, for example
  * <|3s|>, <|0.3s|>, or <|0.34413s|>. Invalid tokens are preserved as text.
@@ -559,6 +1203,26 @@ TYPECAST_API TypecastErrorCode typecast_parse_pause_markup(
     size_t* out_count
 );
 
+/**
+ * Parse pause markup without copying or allocating. The parts are the
+ * same as typecast_parse_pause_markup() returns, each given as a span of
+ * `text`, which must outlive them.
+ *
+ * @param text      Input text
+ * @param spans     Receives up to `capacity` parts (may be NULL when
+ *                  capacity is 0)
+ * @param capacity  Size of `spans`
+ * @param out_count Total number of parts, which may exceed `capacity`;
+ *                  call with capacity 0 to size the array
+ * @return TYPECAST_OK on success
+ */
+TYPECAST_API TypecastErrorCode typecast_parse_pause_markup_spans(
+    const char* text,
+    TypecastSpeechSpan* spans,
+    size_t capacity,
+    size_t* out_count
+);
+
 TYPECAST_API void typecast_speech_parts_free(
     TypecastSpeechPart* parts,
     size_t count
@@ -604,6 +1268,84 @@ TYPECAST_API TypecastTTSResponse* typecast_speech_composer_generate(
     TypecastAudioFormat output_format
 );
 
+/**
+ * Render the composition segment by segment, in parallel, and stitch the
+ * result on the client.
+ *
+ * Unlike typecast_speech_composer_generate(), which sends one request to
+ * the compose endpoint, every speech segment (including the pieces split
+ * out by inline pause markup) becomes its own text-to-speech request. Up
+ * to `max_concurrency` of them run at once on the client's async engine,
+ * so a long script takes roughly as long as its slowest segment. The WAV
+ * segments are joined in order and pauses become silence.
+ *
+ * Output is always WAV. All segments must come back with the same sample
+ * format. Runs the async engine of the client until done, so completion
+ * callbacks of other async jobs on the same client may fire meanwhile.
+ *
+ * @param composer        Speech composer (required)
+ * @param max_concurrency Segments in flight at once (0 = 4); the
+ *                        subscription's limits.concurrency_limit is a good
+ *                        value
+ * @return Stitched WAV response, or NULL on failure (details via
+ *         typecast_client_get_error; the first failing segment's error)
+ */
+TYPECAST_API TypecastTTSResponse* typecast_speech_composer_generate_parallel(
+    TypecastSpeechComposer* composer,
+    size_t max_concurrency
+);
+
+/**
+ * Keep the rendered audio of each segment so that
+ * typecast_speech_composer_generate_parallel() only requests the segments
+ * that changed since an earlier call and splices them with the kept audio.
+ *
+ * A segment is keyed on its text and its merged settings (voice, model,
+ * language, prompt, output, seed), so editing one sentence, changing its
+ * overrides or changing the defaults it relies on re-renders exactly the
+ * segments affected. Unseeded segments are kept too: within a composer a
+ * re-render is expected to reuse earlier takes. Least recently used
+ * segments are dropped past `max_bytes`.
+ *
+ * @param composer  Speech composer (required)
+ * @param max_bytes Audio bytes to keep; 0 turns the cache off and drops it
+ * @return TYPECAST_OK, or TYPECAST_ERROR_OUT_OF_MEMORY
+ */
+TYPECAST_API TypecastErrorCode typecast_speech_composer_enable_cache(
+    TypecastSpeechComposer* composer,
+    size_t max_bytes
+);
+
+/**
+ * Read the segment cache counters: hits and misses count segments looked
+ * up by typecast_speech_composer_generate_parallel(). All zero while the
+ * cache is off.
+ */
+TYPECAST_API TypecastErrorCode typecast_speech_composer_cache_stats(
+    TypecastSpeechComposer* composer,
+    TypecastResultCacheStats* out
+);
+
+/**
+ * Replace the text of the index-th part of the script, counting say() and
+ * pause() calls in order. The part keeps its overrides. Returns
+ * TYPECAST_ERROR_INVALID_PARAM for an index past the end or a pause part.
+ */
+TYPECAST_API TypecastErrorCode typecast_speech_composer_set_text(
+    TypecastSpeechComposer* composer,
+    size_t index,
+    const char* text
+);
+
+/**
+ * Remove every part so the script can be built again. Defaults and the
+ * segment cache are kept, so unchanged segments of the new script still
+ * come from the cache.
+ */
+TYPECAST_API void typecast_speech_composer_clear(
+    TypecastSpeechComposer* composer
+);
+
 /* ============================================
  * Text-to-Speech with Timestamps API
  * ============================================ */
@@ -651,6 +1393,8 @@ TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_to_vtt(
 
 /**
  * Decode and return the raw audio bytes from a timestamps response.
+ * Responses returned by the SDK decode audio_base64 once and keep the
+ * result, so repeated calls (and save_audio) only copy it.
  * Caller must free the returned buffer with free().
  *
  * @param response  Pointer to a TypecastTTSWithTimestampsResponse
@@ -725,48 +1469,621 @@ TYPECAST_API TypecastErrorCode typecast_text_to_speech_stream(
     void* user_data
 );
 
-/* ============================================
- * Voices API
- * ============================================ */
+/** Sample format of a framed stream, reported before its first chunk */
+typedef struct {
+    TypecastAudioFormat audio_format;
+    uint32_t sample_rate;            /**< Hz */
+    uint16_t channels;
+    uint16_t bits_per_sample;        /**< WAV; 0 for MP3 */
+    uint16_t block_align;            /**< WAV bytes per sample frame; 0 for MP3 */
+    uint16_t format_tag;             /**< WAV format code (1 = PCM, 3 = float); 0 for MP3 */
+    uint32_t bitrate_kbps;           /**< MP3 bitrate of the first frame; 0 for WAV */
+} TypecastStreamFormat;
 
 /**
- * Get available voices (V2 API)
+ * Stream format callback.
  *
- * @param client Pointer to TypecastClient
- * @param filter Optional filter (can be NULL)
- * @return Pointer to VoicesResponse, or NULL on failure
- *         (must be freed with typecast_voices_response_free)
+ * @return 0 to continue, non-zero to abort the stream
  */
-TYPECAST_API TypecastVoicesResponse* typecast_get_voices(
-    TypecastClient* client,
-    const TypecastVoicesFilter* filter
+typedef int (*typecast_stream_format_callback_t)(
+    const TypecastStreamFormat* format,
+    void* user_data
 );
 
 /**
- * Get a specific voice by ID (V2 API)
- *
- * @param client Pointer to TypecastClient
- * @param voice_id Voice ID to retrieve
- * @return Pointer to Voice, or NULL on failure
- *         (must be freed with typecast_voice_free)
+ * Framing of typecast_text_to_speech_stream_framed(). Zero-initialize; a
+ * zero field means the default.
  */
-TYPECAST_API TypecastVoice* typecast_get_voice(
-    TypecastClient* client,
-    const char* voice_id
-);
+typedef struct {
+    /**
+     * Least audio per chunk in milliseconds (0 = every whole block or
+     * frame as soon as it is complete). The last chunk may be shorter.
+     */
+    unsigned int min_chunk_ms;
+    /** Called once with the sample format before the first chunk (optional) */
+    typecast_stream_format_callback_t on_format;
+} TypecastStreamFraming;
 
 /**
- * Recommend voices for a text query.
+ * Convert text to speech via the streaming endpoint, delivering whole
+ * units of audio.
  *
- * Recommendation results include only voice_id, voice_name, and score.
- * Use typecast_get_voice or typecast_get_voices when detailed voice
- * metadata is needed.
+ * Like typecast_text_to_speech_stream(), but chunks follow the audio
+ * rather than the network: the SDK reads the WAV header or the MP3 frame
+ * headers as they arrive and calls `on_chunk` only with whole PCM blocks
+ * (the header is not passed on; see `on_format`) or whole MP3 frames
+ * (an ID3 tag is skipped), at least `min_chunk_ms` at a time. Audio that
+ * arrives in one network buffer is passed on without a copy.
  *
- * @param client Pointer to TypecastClient
- * @param query Text query used to search similar voices
- * @param count Number of results to return (1-10, default 5 when 0)
- * @return Pointer to RecommendedVoicesResponse, or NULL on failure
- *         (must be freed with typecast_recommended_voices_response_free)
+ * A body that is neither WAV nor MP3 fails with TYPECAST_ERROR_JSON_PARSE.
+ * A non-200 body is not passed to the callbacks.
+ *
+ * @param client    Pointer to TypecastClient (required)
+ * @param request   Streaming TTS request (required)
+ * @param framing   Framing options, or NULL for the defaults
+ * @param on_chunk  Audio callback (required); non-zero aborts
+ * @param user_data Forwarded to on_chunk and framing->on_format
+ * @return TYPECAST_OK on success, otherwise an error code. On error,
+ *         additional details are available via typecast_client_get_error().
+ */
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_stream_framed(
+    TypecastClient* client,
+    const TypecastTTSRequestStream* request,
+    const TypecastStreamFraming* framing,
+    typecast_stream_callback_t on_chunk,
+    void* user_data
+);
+
+/**
+ * Options of a stream buffer. Zero-initialize; a zero field means the
+ * default.
+ */
+typedef struct {
+    /**
+     * Bytes held between the network and the reader (0 = 256 KiB),
+     * rounded up to a power of two and at least 64 KiB
+     */
+    size_t capacity;
+    /**
+     * Bytes buffered before the first read returns any (0 = none; at
+     * most capacity). The end of the stream releases a shorter one.
+     */
+    size_t prebuffer;
+} TypecastStreamBufferOptions;
+
+/** Counters of a stream buffer, see typecast_stream_buffer_stats() */
+typedef struct {
+    size_t capacity;                 /**< after rounding */
+    size_t buffered;                 /**< bytes waiting to be read */
+    uint64_t bytes_written;          /**< audio the network delivered */
+    uint64_t bytes_read;
+    unsigned long pauses;            /**< times the transfer waited for room */
+    unsigned long underruns;         /**< reads after the prebuffer that found nothing */
+} TypecastStreamBufferStats;
+
+/**
+ * Create a single-producer, single-consumer jitter buffer between a
+ * streaming request and a playback thread.
+ *
+ * One thread runs typecast_text_to_speech_stream_buffered(), which writes
+ * the audio into the buffer; another reads it with
+ * typecast_stream_buffer_read(). Neither side takes a lock, so the reader
+ * may be a real-time audio callback. When the buffer is full the transfer
+ * is paused until the reader makes room, so memory stays at `capacity`
+ * however slowly the audio is played. A buffer carries one stream.
+ *
+ * @param options Buffer options, or NULL for the defaults
+ * @return New buffer (free with typecast_stream_buffer_free), NULL on OOM
+ */
+TYPECAST_API TypecastStreamBuffer* typecast_stream_buffer_create(const TypecastStreamBufferOptions* options);
+
+/**
+ * Free a stream buffer. Neither thread may still be using it.
+ */
+TYPECAST_API void typecast_stream_buffer_free(TypecastStreamBuffer* buffer);
+
+/**
+ * Convert text to speech via the streaming endpoint into a stream buffer.
+ *
+ * Blocks until the whole body is in the buffer (not until it is read), the
+ * request fails, or the reader closes the buffer. The stream is paused
+ * while the buffer is full; that time does not count against the request
+ * timeout, while a call deadline and cancel token still apply. A non-200
+ * body is not buffered. Unless an argument is NULL or the buffer already
+ * carried a stream, the buffer reaches its end when this returns.
+ *
+ * @param client  Pointer to TypecastClient (required)
+ * @param request Streaming TTS request (required)
+ * @param buffer  An unused stream buffer (required)
+ * @return TYPECAST_OK on success, TYPECAST_ERROR_CANCELLED when the reader
+ *         closed the buffer, otherwise an error code. On error, additional
+ *         details are available via typecast_client_get_error().
+ */
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_stream_buffered(
+    TypecastClient* client,
+    const TypecastTTSRequestStream* request,
+    TypecastStreamBuffer* buffer
+);
+
+/**
+ * Copy up to `size` buffered bytes to `out` without waiting. Returns 0
+ * until the prebuffer is reached, and when the reader has caught up with
+ * the network (an underrun) or the stream ended. Reader thread only.
+ *
+ * @return Bytes copied
+ */
+TYPECAST_API size_t typecast_stream_buffer_read(TypecastStreamBuffer* buffer, uint8_t* out, size_t size);
+
+/**
+ * Bytes a read would return now (0 while prebuffering). Reader thread only.
+ */
+TYPECAST_API size_t typecast_stream_buffer_available(TypecastStreamBuffer* buffer);
+
+/**
+ * Whether the stream ended and every byte was read. Reader thread only.
+ */
+TYPECAST_API int typecast_stream_buffer_eof(TypecastStreamBuffer* buffer);
+
+/**
+ * Stop reading: the transfer is aborted and the producer call returns
+ * TYPECAST_ERROR_CANCELLED. Reader thread only.
+ */
+TYPECAST_API void typecast_stream_buffer_close(TypecastStreamBuffer* buffer);
+
+/**
+ * Read the buffer's counters. Reader thread only.
+ *
+ * @return TYPECAST_OK, or TYPECAST_ERROR_INVALID_PARAM when an argument is NULL
+ */
+TYPECAST_API TypecastErrorCode typecast_stream_buffer_stats(
+    TypecastStreamBuffer* buffer,
+    TypecastStreamBufferStats* out_stats
+);
+
+/**
+ * Options for typecast_text_to_speech_pipelined(). Zero-initialize; a
+ * zero field means the default.
+ */
+typedef struct {
+    /** Sentence requests rendering at once (0 = 4) */
+    size_t max_in_flight;
+    /**
+     * Pack whole sentences into requests of up to this many characters
+     * (0 = one request per sentence; at most 2000)
+     */
+    size_t max_chars;
+} TypecastPipelineOptions;
+
+/**
+ * Convert a text of any length to speech, sentence by sentence, with
+ * several sentences rendering at once.
+ *
+ * request->text may exceed the 2000-character limit of one request. It
+ * is split at sentence ends (. ? ! and their full-width forms, or a blank
+ * line); a sentence that is still too long is cut at a space. Up to
+ * max_in_flight sentence requests run on the client's async engine, and
+ * the audio is passed to `on_chunk` strictly in order, each sentence as
+ * soon as it and all before it are done — playback can start after the
+ * first sentence.
+ *
+ * WAV output arrives as one stream: a header whose length fields are
+ * 0xFFFFFFFF (the total is not known up front), then the samples of
+ * every sentence. All sentences must come back in the same sample
+ * format. MP3 frames are passed through as they are.
+ *
+ * With a smart emotion prompt, each sentence gets its neighbours as
+ * previous_text / next_text; the prompt's own previous_text / next_text
+ * are used before the first and after the last sentence.
+ *
+ * Runs the async engine of the client until done, so completion
+ * callbacks of other async jobs on the same client may fire meanwhile.
+ *
+ * @param client    Pointer to TypecastClient (required)
+ * @param request   TTS request; text of any length (required)
+ * @param options   Pipeline options, or NULL for the defaults
+ * @param on_chunk  Audio callback (required); non-zero aborts
+ * @param user_data Forwarded to on_chunk
+ * @return TYPECAST_OK on success, otherwise an error code (the first
+ *         failing sentence's error; details via typecast_client_get_error)
+ */
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_pipelined(
+    TypecastClient* client,
+    const TypecastTTSRequest* request,
+    const TypecastPipelineOptions* options,
+    typecast_stream_callback_t on_chunk,
+    void* user_data
+);
+
+/**
+ * Convert text to speech with timestamps, decoding the audio while the
+ * response is still arriving.
+ *
+ * Unlike typecast_text_to_speech_with_timestamps(), the base64 audio is
+ * never kept: with on_audio NULL the decoded bytes are stored in
+ * response->audio_data / audio_size; otherwise they are passed to
+ * on_audio in order as they are decoded and the response holds only the
+ * format, duration and segments. Returning non-zero from on_audio aborts
+ * the request.
+ *
+ * @param client       Pointer to TypecastClient
+ * @param request      TTS with timestamps request (required)
+ * @param on_audio     Decoded audio callback, or NULL to collect the audio
+ * @param user_data    Forwarded to on_audio
+ * @param out_response Set to a newly allocated response on success (must be
+ *                     freed with typecast_tts_with_timestamps_decoded_response_free)
+ * @return TYPECAST_OK on success, otherwise an error code
+ */
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_with_timestamps_decoded(
+    TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request,
+    typecast_stream_callback_t on_audio,
+    void* user_data,
+    TypecastTTSWithTimestampsDecodedResponse** out_response
+);
+
+/**
+ * Free a TypecastTTSWithTimestampsDecodedResponse and all its members.
+ *
+ * @param response Pointer to the response to free (can be NULL)
+ */
+TYPECAST_API void typecast_tts_with_timestamps_decoded_response_free(
+    TypecastTTSWithTimestampsDecodedResponse* response
+);
+
+/** Which segment list an alignment event belongs to */
+typedef enum {
+    TYPECAST_ALIGNMENT_WORD = 0,
+    TYPECAST_ALIGNMENT_CHARACTER = 1
+} TypecastAlignmentKind;
+
+/**
+ * Callback for alignment segments of a streaming with-timestamps request.
+ *
+ * @param kind      Word or character segment
+ * @param segment   The segment; valid only during the call (copy the text
+ *                  to keep it)
+ * @param user_data Opaque pointer forwarded from the call site
+ * @return 0 to continue, non-zero to abort
+ */
+typedef int (*typecast_alignment_callback_t)(
+    TypecastAlignmentKind kind,
+    const TypecastAlignmentSegment* segment,
+    void* user_data
+);
+
+/**
+ * Convert text to speech with timestamps, delivering audio and alignment
+ * segments to callbacks while the response is still arriving.
+ *
+ * Decoded audio goes to on_audio in order, and every word / character
+ * segment goes to on_segment as soon as it has been parsed. Nothing is
+ * kept once delivered, so memory use does not grow with the length of
+ * the utterance. Events follow the order of the response body: segments
+ * that the service sends after the audio arrive once the audio has.
+ * A segment list that turns out malformed part way stops producing
+ * events from that point (the blocking variants drop it altogether).
+ * Returning non-zero from either callback aborts the request.
+ *
+ * @param client     Pointer to TypecastClient (required)
+ * @param request    TTS with timestamps request (required)
+ * @param on_audio   Decoded audio callback, or NULL to skip the audio
+ * @param on_segment Alignment callback (required)
+ * @param user_data  Forwarded to both callbacks
+ * @return TYPECAST_OK on success, otherwise an error code. On error,
+ *         additional details are available via typecast_client_get_error().
+ */
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_with_timestamps_stream(
+    TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request,
+    typecast_stream_callback_t on_audio,
+    typecast_alignment_callback_t on_segment,
+    void* user_data
+);
+
+/* ============================================
+ * Incremental captions
+ * ============================================ */
+
+/** Caption document format */
+typedef enum {
+    TYPECAST_CAPTION_SRT = 0,
+    TYPECAST_CAPTION_VTT = 1
+} TypecastCaptionFormat;
+
+/**
+ * Write the captions of a response to `write` instead of building them in
+ * memory. The output is the same as _to_srt / _to_vtt, written cue by cue.
+ *
+ * @param write     Receives the document bytes; a non-zero return stops
+ *                  the writer with TYPECAST_ERROR_CANCELLED
+ * @param user_data Forwarded to `write`
+ * @return TYPECAST_OK, or TYPECAST_ERROR_INVALID_PARAM when the response
+ *         has no usable segments
+ */
+TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_write_captions(
+    const TypecastTTSWithTimestampsResponse* response,
+    TypecastCaptionFormat format,
+    typecast_stream_callback_t write,
+    void* user_data
+);
+
+/**
+ * Caption writer fed one alignment segment at a time.
+ *
+ * Segments are grouped into cues exactly as by the _to_srt / _to_vtt
+ * helpers (cues end at sentence terminators, 7 seconds or 42 characters),
+ * and each cue is written out as soon as it closes. Only the open cue is
+ * kept, so memory does not grow with the length of the audio.
+ */
+typedef struct TypecastCaptionWriter TypecastCaptionWriter;
+
+/**
+ * Create a writer that hands the document bytes to `write`.
+ *
+ * @param format    SRT or WebVTT
+ * @param kind      Word segments are joined with spaces, character
+ *                  segments are concatenated
+ * @param write     Receives the document bytes (required); a non-zero
+ *                  return stops the writer with TYPECAST_ERROR_CANCELLED
+ * @param user_data Forwarded to `write`
+ * @return Writer (free with typecast_caption_writer_free), or NULL
+ */
+TYPECAST_API TypecastCaptionWriter* typecast_caption_writer_create(
+    TypecastCaptionFormat format,
+    TypecastAlignmentKind kind,
+    typecast_stream_callback_t write,
+    void* user_data
+);
+
+/**
+ * Create a writer that writes to an open stdio stream. A failed write
+ * stops the writer with TYPECAST_ERROR_NETWORK, as for the file APIs.
+ * The stream is not closed by the writer.
+ */
+TYPECAST_API TypecastCaptionWriter* typecast_caption_writer_create_file(
+    TypecastCaptionFormat format,
+    TypecastAlignmentKind kind,
+    FILE* file
+);
+
+/**
+ * Add the next segment. Writes the cue it closes, if any.
+ * Once a write failed, every call returns that error.
+ */
+TYPECAST_API TypecastErrorCode typecast_caption_writer_add(
+    TypecastCaptionWriter* writer,
+    const TypecastAlignmentSegment* segment
+);
+
+/**
+ * Alignment callback feeding a writer, for
+ * typecast_text_to_speech_with_timestamps_stream() with the writer as
+ * user_data. Segments of the other kind are skipped; a writer error
+ * aborts the request.
+ */
+TYPECAST_API int typecast_caption_writer_on_segment(
+    TypecastAlignmentKind kind,
+    const TypecastAlignmentSegment* segment,
+    void* user_data
+);
+
+/**
+ * Write the last open cue.
+ *
+ * @return TYPECAST_OK, TYPECAST_ERROR_INVALID_PARAM when no cue was
+ *         written at all, or the error that stopped the writer
+ */
+TYPECAST_API TypecastErrorCode typecast_caption_writer_finish(TypecastCaptionWriter* writer);
+
+/** Number of cues written so far. */
+TYPECAST_API size_t typecast_caption_writer_cue_count(const TypecastCaptionWriter* writer);
+
+/** Free a writer (may be NULL). Does not finish it. */
+TYPECAST_API void typecast_caption_writer_free(TypecastCaptionWriter* writer);
+
+/* ============================================
+ * Async API
+ * ============================================ */
+
+/**
+ * Completion callback for async jobs.
+ *
+ * Invoked from typecast_async_poll() / typecast_async_wait() on the thread
+ * driving the client's event loop, once the job has finished (successfully
+ * or not). The job may be freed from inside the callback.
+ *
+ * @param job       The finished job
+ * @param user_data Opaque pointer forwarded from the submit call
+ */
+typedef void (*typecast_async_callback_t)(
+    TypecastAsyncJob* job,
+    void* user_data
+);
+
+/**
+ * Submit a text-to-speech request without blocking.
+ *
+ * The request is serialized immediately, so `request` does not need to
+ * outlive this call. Jobs submitted to the same client run concurrently on
+ * a single curl multi handle and share its connection pool; over HTTPS the
+ * transfers are multiplexed on one HTTP/2 connection when the server
+ * supports it. Progress is made only while typecast_async_poll() or
+ * typecast_async_wait() is running.
+ *
+ * @param client    Pointer to TypecastClient (required)
+ * @param request   TTS request (required)
+ * @param on_done   Optional completion callback
+ * @param user_data Opaque pointer forwarded to the callback
+ * @return Job handle (free with typecast_async_job_free), or NULL on
+ *         failure (details via typecast_client_get_error)
+ */
+TYPECAST_API TypecastAsyncJob* typecast_async_text_to_speech(
+    TypecastClient* client,
+    const TypecastTTSRequest* request,
+    typecast_async_callback_t on_done,
+    void* user_data
+);
+
+/**
+ * Submit a text-to-speech with timestamps request without blocking.
+ * See typecast_async_text_to_speech() for the execution model.
+ */
+TYPECAST_API TypecastAsyncJob* typecast_async_text_to_speech_with_timestamps(
+    TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request,
+    typecast_async_callback_t on_done,
+    void* user_data
+);
+
+/**
+ * Submit a streaming text-to-speech request without blocking.
+ *
+ * `on_chunk` is invoked from typecast_async_poll() as audio arrives;
+ * returning non-zero aborts only this job.
+ */
+TYPECAST_API TypecastAsyncJob* typecast_async_text_to_speech_stream(
+    TypecastClient* client,
+    const TypecastTTSRequestStream* request,
+    typecast_stream_callback_t on_chunk,
+    typecast_async_callback_t on_done,
+    void* user_data
+);
+
+/**
+ * Submit a speech composition to the compose endpoint without blocking;
+ * the asynchronous counterpart of typecast_speech_composer_generate().
+ *
+ * The composition is serialized immediately, so the composer may be
+ * changed or destroyed as soon as this returns. The job runs on the event
+ * loop of the composer's client and yields a TTS response.
+ *
+ * @return Job handle (free with typecast_async_job_free), or NULL on
+ *         failure (details via typecast_client_get_error)
+ */
+TYPECAST_API TypecastAsyncJob* typecast_async_speech_composer_generate(
+    TypecastSpeechComposer* composer,
+    TypecastAudioFormat output_format,
+    typecast_async_callback_t on_done,
+    void* user_data
+);
+
+/**
+ * Drive the client's event loop once.
+ *
+ * Waits up to `timeout_ms` for network activity, advances every running
+ * job and invokes completion callbacks for the jobs that finished.
+ *
+ * @param client      Pointer to TypecastClient (required)
+ * @param timeout_ms  Maximum time to wait for activity (0 = do not wait)
+ * @param out_running Optional; set to the number of jobs still running
+ * @return TYPECAST_OK on success, otherwise an error code
+ */
+TYPECAST_API TypecastErrorCode typecast_async_poll(
+    TypecastClient* client,
+    int timeout_ms,
+    size_t* out_running
+);
+
+/**
+ * Make a typecast_async_poll() that is waiting on another thread return
+ * early, e.g. so the thread driving the loop can submit newly queued work.
+ *
+ * Unlike the rest of the async API this may be called from any thread,
+ * provided the first job of the client has been submitted before (the
+ * multi handle is created with it). Before that it does nothing.
+ *
+ * @return TYPECAST_OK on success, otherwise an error code
+ */
+TYPECAST_API TypecastErrorCode typecast_async_wakeup(TypecastClient* client);
+
+/**
+ * Drive the client's event loop until `job` has finished.
+ * Other jobs keep making progress (and may complete) meanwhile.
+ *
+ * @return The job's result code
+ */
+TYPECAST_API TypecastErrorCode typecast_async_wait(
+    TypecastClient* client,
+    TypecastAsyncJob* job
+);
+
+/** Return 1 once the job has finished, 0 while it is still running. */
+TYPECAST_API int typecast_async_job_is_done(const TypecastAsyncJob* job);
+
+/** Return the job's result code (TYPECAST_OK while still running). */
+TYPECAST_API TypecastErrorCode typecast_async_job_result(const TypecastAsyncJob* job);
+
+/**
+ * Return the job's error. The error is owned by the job and stays valid
+ * until typecast_async_job_free().
+ */
+TYPECAST_API const TypecastError* typecast_async_job_error(const TypecastAsyncJob* job);
+
+/**
+ * Take ownership of a finished TTS job's response.
+ * Returns NULL if the job failed, is still running or is not a TTS job.
+ * Free with typecast_tts_response_free().
+ */
+TYPECAST_API TypecastTTSResponse* typecast_async_job_take_tts_response(TypecastAsyncJob* job);
+
+/**
+ * Take ownership of a finished timestamps job's response.
+ * Free with typecast_tts_with_timestamps_response_free().
+ */
+TYPECAST_API TypecastTTSWithTimestampsResponse* typecast_async_job_take_timestamps_response(
+    TypecastAsyncJob* job
+);
+
+/**
+ * Free a job. A job that is still running is cancelled first; its
+ * callbacks are not invoked.
+ *
+ * @param job Job handle (may be NULL)
+ */
+TYPECAST_API void typecast_async_job_free(TypecastAsyncJob* job);
+
+/* ============================================
+ * Voices API
+ * ============================================ */
+
+/**
+ * Get available voices (V2 API)
+ *
+ * @param client Pointer to TypecastClient
+ * @param filter Optional filter (can be NULL)
+ * @return Pointer to VoicesResponse, or NULL on failure
+ *         (must be freed with typecast_voices_response_free)
+ */
+TYPECAST_API TypecastVoicesResponse* typecast_get_voices(
+    TypecastClient* client,
+    const TypecastVoicesFilter* filter
+);
+
+/**
+ * Get a specific voice by ID (V2 API)
+ *
+ * @param client Pointer to TypecastClient
+ * @param voice_id Voice ID to retrieve
+ * @return Pointer to Voice, or NULL on failure
+ *         (must be freed with typecast_voice_free)
+ */
+TYPECAST_API TypecastVoice* typecast_get_voice(
+    TypecastClient* client,
+    const char* voice_id
+);
+
+/**
+ * Recommend voices for a text query.
+ *
+ * Recommendation results include only voice_id, voice_name, and score.
+ * Use typecast_get_voice or typecast_get_voices when detailed voice
+ * metadata is needed.
+ *
+ * @param client Pointer to TypecastClient
+ * @param query Text query used to search similar voices
+ * @param count Number of results to return (1-10, default 5 when 0)
+ * @return Pointer to RecommendedVoicesResponse, or NULL on failure
+ *         (must be freed with typecast_recommended_voices_response_free)
  */
 TYPECAST_API TypecastRecommendedVoicesResponse* typecast_recommend_voices(
     TypecastClient* client,
@@ -774,6 +2091,33 @@ TYPECAST_API TypecastRecommendedVoicesResponse* typecast_recommend_voices(
     int count
 );
 
+/**
+ * Drop every cached voices response of the client, including the
+ * voice_cache_path file. Cloning or deleting a voice does this
+ * automatically. No-op for clients without a voice cache.
+ *
+ * @param client Pointer to TypecastClient
+ */
+TYPECAST_API void typecast_voice_cache_clear(TypecastClient* client);
+
+/**
+ * Read the client's result cache counters. All zero for clients without
+ * a result cache.
+ *
+ * @param client Pointer to TypecastClient
+ * @param out Receives the counters
+ * @return TYPECAST_OK, or TYPECAST_ERROR_INVALID_PARAM for NULL arguments
+ */
+TYPECAST_API TypecastErrorCode typecast_result_cache_stats(TypecastClient* client, TypecastResultCacheStats* out);
+
+/**
+ * Drop the memory tier of the client's result cache and reset its
+ * counters. Files in result_cache_dir are kept.
+ *
+ * @param client Pointer to TypecastClient
+ */
+TYPECAST_API void typecast_result_cache_clear(TypecastClient* client);
+
 /**
  * Free voices response
  *
@@ -882,6 +2226,86 @@ TYPECAST_API TypecastErrorCode typecast_clone_voice(
     TypecastCustomVoice* out
 );
 
+/** Returned by a typecast_read_callback_t to abort the upload */
+#define TYPECAST_READ_ABORT ((size_t)-1)
+
+/**
+ * Supplies the audio of a streamed upload: copy up to `size` bytes into
+ * `buffer` and return how many were copied, or TYPECAST_READ_ABORT.
+ */
+typedef size_t (*typecast_read_callback_t)(char* buffer, size_t size, void* user_data);
+
+/**
+ * Upload progress: `sent` of `total` request body bytes (multipart framing
+ * included). Called whenever `sent` changes. Return non-zero to abort.
+ */
+typedef int (*typecast_upload_progress_callback_t)(uint64_t sent, uint64_t total, void* user_data);
+
+/**
+ * Where the audio of typecast_clone_voice_from_source() comes from. Set
+ * exactly one of path or read.
+ */
+typedef struct {
+    const char* path;                /* read from this file as it is sent */
+    typecast_read_callback_t read;   /* or pulled from this callback */
+    void* read_user_data;
+    size_t size;                     /* bytes `read` supplies (required with read) */
+    const char* filename;            /* multipart filename hint; defaults to path's base name */
+    typecast_upload_progress_callback_t on_progress;  /* optional */
+    void* progress_user_data;
+} TypecastCloneSource;
+
+/**
+ * Clone a custom voice from audio that is streamed to the server instead
+ * of being held in memory: read from a file, or pulled from a callback
+ * (for example from an object store download). The same limits as
+ * typecast_clone_voice() apply; the size is checked before anything is
+ * sent.
+ *
+ * An abort through the read or progress callback fails the call with
+ * TYPECAST_ERROR_NETWORK. Cloning is never retried, so a read callback
+ * is consumed at most once.
+ *
+ * @param client Pointer to an initialized TypecastClient (required)
+ * @param source Audio source (required)
+ * @param name   Voice name, NUL-terminated, 1..30 characters
+ * @param model  Model string: "ssfm-v21" or "ssfm-v30"
+ * @param out    Written on success; must not be NULL
+ * @return TYPECAST_OK (0) on success, non-zero TypecastErrorCode on error
+ */
+TYPECAST_API TypecastErrorCode typecast_clone_voice_from_source(
+    TypecastClient* client,
+    const TypecastCloneSource* source,
+    const char* name,
+    const char* model,
+    TypecastCustomVoice* out
+);
+
+/**
+ * Clone a custom voice from an audio file, streamed from disk. The file
+ * name also serves as the multipart filename hint.
+ */
+TYPECAST_API TypecastErrorCode typecast_clone_voice_from_file(
+    TypecastClient* client,
+    const char* path,
+    const char* name,
+    const char* model,
+    TypecastCustomVoice* out
+);
+
+/**
+ * Clone a custom voice from an open regular file, streamed from its
+ * current offset to its end. The descriptor is not closed.
+ */
+TYPECAST_API TypecastErrorCode typecast_clone_voice_from_fd(
+    TypecastClient* client,
+    int fd,
+    const char* filename,
+    const char* name,
+    const char* model,
+    TypecastCustomVoice* out
+);
+
 /**
  * Soft-delete a custom voice by ID.
  *
@@ -997,6 +2421,26 @@ TYPECAST_API const char* typecast_error_message(TypecastErrorCode code);
 #include <fstream>
 #include <algorithm>
 #include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#define TYPECAST_CPP_HAS_SPAN 1
+#endif
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define TYPECAST_CPP_HAS_COROUTINES 1
+#endif
+#endif
 
 namespace typecast {
 
@@ -1058,23 +2502,232 @@ struct GenerateToFileRequest {
     int seed = 0;
 };
 
-struct TTSResponse {
-    std::vector<uint8_t> audioData;
-    float duration = 0.0f;
-    AudioFormat format = AudioFormat::WAV;
-};
+struct TTSResponse {
+    std::vector<uint8_t> audioData;
+    float duration = 0.0f;
+    AudioFormat format = AudioFormat::WAV;
+};
+
+/* What Client::streamToFile wrote */
+struct GeneratedFile {
+    float duration = 0.0f;
+    AudioFormat format = AudioFormat::WAV;
+};
+
+struct Voice {
+    std::string voiceId;
+    std::string voiceName;
+    std::vector<std::string> emotions;
+};
+
+struct RecommendedVoice {
+    std::string voiceId;
+    std::string voiceName;
+    double score = 0.0;
+};
+
+/* Non-owning view of contiguous bytes, like std::span<const uint8_t> */
+class ByteView {
+public:
+    ByteView() noexcept : data_(nullptr), size_(0) {}
+    ByteView(const uint8_t* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    const uint8_t* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    const uint8_t* begin() const noexcept { return data_; }
+    const uint8_t* end() const noexcept { return data_ + size_; }
+    uint8_t operator[](size_t i) const noexcept { return data_[i]; }
+#ifdef TYPECAST_CPP_HAS_SPAN
+    operator std::span<const uint8_t>() const noexcept { return {data_, size_}; }
+#endif
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+namespace detail {
+
+struct TTSResponseDeleter {
+    void operator()(TypecastTTSResponse* p) const noexcept { typecast_tts_response_free(p); }
+};
+
+struct VoicesDeleter {
+    void operator()(TypecastVoicesResponse* p) const noexcept { typecast_voices_response_free(p); }
+};
+
+struct RecommendedVoicesDeleter {
+    void operator()(TypecastRecommendedVoicesResponse* p) const noexcept {
+        typecast_recommended_voices_response_free(p);
+    }
+};
+
+/* Move-only owner of a C voice list; items are the C structs themselves */
+template <typename Response, typename Item, typename Deleter>
+class ListHandle {
+public:
+    ListHandle() noexcept = default;
+    explicit ListHandle(Response* response) noexcept : resp_(response) {}
+
+    size_t size() const noexcept { return resp_ ? resp_->count : 0; }
+    bool empty() const noexcept { return size() == 0; }
+    const Item* begin() const noexcept { return resp_ ? resp_->voices : nullptr; }
+    const Item* end() const noexcept { return begin() + size(); }
+    const Item& operator[](size_t i) const noexcept { return resp_->voices[i]; }
+
+    const Response* get() const noexcept { return resp_.get(); }
+    /* Hand the C response to the caller, who frees it */
+    Response* release() noexcept { return resp_.release(); }
+
+private:
+    std::unique_ptr<Response, Deleter> resp_;
+};
+
+} // namespace detail
+
+/**
+ * Move-only owner of a C TTS response. The audio stays in the buffer the
+ * SDK received it into; data()/view() expose it without a copy.
+ */
+class AudioBuffer {
+public:
+    AudioBuffer() noexcept = default;
+    explicit AudioBuffer(TypecastTTSResponse* response) noexcept : resp_(response) {}
+
+    const uint8_t* data() const noexcept { return resp_ ? resp_->audio_data : nullptr; }
+    size_t size() const noexcept { return resp_ ? resp_->audio_size : 0; }
+    bool empty() const noexcept { return size() == 0; }
+    const uint8_t* begin() const noexcept { return data(); }
+    const uint8_t* end() const noexcept { return data() + size(); }
+    uint8_t operator[](size_t i) const noexcept { return resp_->audio_data[i]; }
+    ByteView view() const noexcept { return ByteView(data(), size()); }
+
+    float duration() const noexcept { return resp_ ? resp_->duration : 0.0f; }
+    AudioFormat format() const noexcept {
+        return resp_ ? static_cast<AudioFormat>(resp_->format) : AudioFormat::WAV;
+    }
+
+    /* Copy of the audio, for APIs that want a vector */
+    std::vector<uint8_t> toVector() const { return std::vector<uint8_t>(begin(), end()); }
+
+    const TypecastTTSResponse* get() const noexcept { return resp_.get(); }
+    /* Hand the C response to the caller, who frees it with typecast_tts_response_free */
+    TypecastTTSResponse* release() noexcept { return resp_.release(); }
+
+private:
+    std::unique_ptr<TypecastTTSResponse, detail::TTSResponseDeleter> resp_;
+};
+
+/* Voice lists backed by the C responses; strings are the C strings */
+typedef detail::ListHandle<TypecastVoicesResponse, TypecastVoice, detail::VoicesDeleter> VoiceList;
+typedef detail::ListHandle<TypecastRecommendedVoicesResponse, TypecastRecommendedVoice,
+    detail::RecommendedVoicesDeleter> RecommendedVoiceList;
+
+/* Non-owning view of alignment segments */
+class SegmentView {
+public:
+    SegmentView() noexcept : data_(nullptr), size_(0) {}
+    SegmentView(const TypecastAlignmentSegment* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    const TypecastAlignmentSegment* begin() const noexcept { return data_; }
+    const TypecastAlignmentSegment* end() const noexcept { return data_ + size_; }
+    const TypecastAlignmentSegment& operator[](size_t i) const noexcept { return data_[i]; }
+
+private:
+    const TypecastAlignmentSegment* data_;
+    size_t size_;
+};
+
+/* Move-only owner of a C timestamps response */
+class TimestampedAudio {
+public:
+    TimestampedAudio() noexcept = default;
+    explicit TimestampedAudio(TypecastTTSWithTimestampsResponse* response) noexcept : resp_(response) {}
+
+    bool empty() const noexcept { return !resp_; }
+    float duration() const noexcept { return resp_ ? resp_->audio_duration : 0.0f; }
+    SegmentView words() const noexcept {
+        return resp_ ? SegmentView(resp_->words, resp_->words_count) : SegmentView();
+    }
+    SegmentView characters() const noexcept {
+        return resp_ ? SegmentView(resp_->characters, resp_->characters_count) : SegmentView();
+    }
+
+    /* Decoded audio (the response decodes it once and keeps it) */
+    std::vector<uint8_t> audio() const {
+        uint8_t* bytes = nullptr;
+        size_t size = 0;
+        if (!resp_ || typecast_tts_with_timestamps_response_audio_bytes(resp_.get(), &bytes, &size) != TYPECAST_OK) {
+            return std::vector<uint8_t>();
+        }
+        std::vector<uint8_t> result(bytes, bytes + size);
+        std::free(bytes);
+        return result;
+    }
+
+    const TypecastTTSWithTimestampsResponse* get() const noexcept { return resp_.get(); }
+    TypecastTTSWithTimestampsResponse* release() noexcept { return resp_.release(); }
+
+private:
+    struct Deleter {
+        void operator()(TypecastTTSWithTimestampsResponse* p) const noexcept {
+            typecast_tts_with_timestamps_response_free(p);
+        }
+    };
+    std::unique_ptr<TypecastTTSWithTimestampsResponse, Deleter> resp_;
+};
+
+namespace detail {
+
+/* A TTSRequest as the C struct; points into itself and `request` */
+struct CTTSRequest {
+    TypecastTTSRequest req;
+    TypecastPrompt prompt;
+    TypecastOutput output;
+
+    explicit CTTSRequest(const TTSRequest& request) : req(), prompt(), output() {
+        req.text = request.text.c_str();
+        req.voice_id = request.voiceId.c_str();
+        req.model = static_cast<TypecastModel>(request.model);
+
+        if (!request.language.empty()) {
+            req.language = request.language.c_str();
+        }
+
+        prompt.emotion_preset = static_cast<TypecastEmotionPreset>(
+            request.prompt.emotionPreset);
+        prompt.emotion_intensity = request.prompt.emotionIntensity;
+        if (request.prompt.useSmart) {
+            prompt.emotion_type = TYPECAST_EMOTION_TYPE_SMART;
+            if (!request.prompt.previousText.empty()) {
+                prompt.previous_text = request.prompt.previousText.c_str();
+            }
+            if (!request.prompt.nextText.empty()) {
+                prompt.next_text = request.prompt.nextText.c_str();
+            }
+        } else {
+            prompt.emotion_type = TYPECAST_EMOTION_TYPE_PRESET;
+        }
+        req.prompt = &prompt;
+
+        output.volume = request.output.volume;
+        output.audio_pitch = request.output.audioPitch;
+        output.audio_tempo = request.output.audioTempo;
+        output.audio_format = static_cast<TypecastAudioFormat>(
+            request.output.audioFormat);
+        req.output = &output;
+
+        req.seed = request.seed;
+    }
 
-struct Voice {
-    std::string voiceId;
-    std::string voiceName;
-    std::vector<std::string> emotions;
+    CTTSRequest(const CTTSRequest&) = delete;
+    CTTSRequest& operator=(const CTTSRequest&) = delete;
 };
 
-struct RecommendedVoice {
-    std::string voiceId;
-    std::string voiceName;
-    double score = 0.0;
-};
+} // namespace detail
 
 class TypecastException : public std::runtime_error {
 public:
@@ -1119,59 +2772,126 @@ public:
         return *this;
     }
 
+    /* Connect (and optionally fetch the voice catalog) before the first request */
+    void warmup(bool preloadVoices = false) {
+        if (typecast_client_warmup(client_, preloadVoices ? 1 : 0) != TYPECAST_OK) throwLastError();
+    }
+
+    /* The audio in the SDK's own buffer, without a copy */
+    AudioBuffer textToSpeechBuffer(const TTSRequest& request) {
+        detail::CTTSRequest req(request);
+        TypecastTTSResponse* resp = typecast_text_to_speech(client_, &req.req);
+        if (!resp) throwLastError();
+        return AudioBuffer(resp);
+    }
+
     TTSResponse textToSpeech(const TTSRequest& request) {
-        TypecastTTSRequest req = {};
-        req.text = request.text.c_str();
-        req.voice_id = request.voiceId.c_str();
-        req.model = static_cast<TypecastModel>(request.model);
+        AudioBuffer audio = textToSpeechBuffer(request);
+        TTSResponse result;
+        result.audioData = audio.toVector();
+        result.duration = audio.duration();
+        result.format = audio.format();
+        return result;
+    }
 
-        if (!request.language.empty()) {
-            req.language = request.language.c_str();
+    TTSResponse generateToFile(const std::string& filePath, const GenerateToFileRequest& request) {
+        TTSResponse response = textToSpeech(fileRequestFor(filePath, request));
+        std::ofstream out(filePath, std::ios::binary);
+        if (!out) {
+            throw TypecastException(TYPECAST_ERROR_INVALID_PARAM, "Failed to open output file");
         }
+        out.write(reinterpret_cast<const char*>(response.audioData.data()), response.audioData.size());
+        if (!out) {
+            throw TypecastException(TYPECAST_ERROR_NETWORK, "Failed to write output file");
+        }
+        return response;
+    }
 
-        TypecastPrompt prompt = {};
-        prompt.emotion_preset = static_cast<TypecastEmotionPreset>(
-            request.prompt.emotionPreset);
-        prompt.emotion_intensity = request.prompt.emotionIntensity;
-        if (request.prompt.useSmart) {
-            prompt.emotion_type = TYPECAST_EMOTION_TYPE_SMART;
-            if (!request.prompt.previousText.empty()) {
-                prompt.previous_text = request.prompt.previousText.c_str();
-            }
-            if (!request.prompt.nextText.empty()) {
-                prompt.next_text = request.prompt.nextText.c_str();
-            }
-        } else {
-            prompt.emotion_type = TYPECAST_EMOTION_TYPE_PRESET;
+    /**
+     * Like generateToFile, but through typecast_generate_to_file: the audio
+     * is streamed to a temporary file and renamed into place, never held
+     * in memory. Only the duration and format come back.
+     */
+    GeneratedFile streamToFile(const std::string& filePath, const GenerateToFileRequest& request) {
+        /* CTTSRequest borrows its strings, so the request must outlive it */
+        TTSRequest ttsRequest = fileRequestFor(filePath, request);
+        detail::CTTSRequest req(ttsRequest);
+        TypecastGenerateToFileRequest fileRequest = {};
+        fileRequest.text = req.req.text;
+        fileRequest.voice_id = req.req.voice_id;
+        fileRequest.model = req.req.model;
+        fileRequest.use_model = 1;
+        fileRequest.language = req.req.language;
+        fileRequest.prompt = req.req.prompt;
+        fileRequest.output = req.req.output;
+        fileRequest.seed = req.req.seed;
+        TypecastGeneratedAudio info = {};
+        if (typecast_generate_to_file_with_info(client_, filePath.c_str(), &fileRequest, &info) != TYPECAST_OK) {
+            throwLastError();
         }
-        req.prompt = &prompt;
 
-        TypecastOutput output = {};
-        output.volume = request.output.volume;
-        output.audio_pitch = request.output.audioPitch;
-        output.audio_tempo = request.output.audioTempo;
-        output.audio_format = static_cast<TypecastAudioFormat>(
-            request.output.audioFormat);
-        req.output = &output;
+        GeneratedFile result;
+        result.duration = info.duration;
+        result.format = static_cast<AudioFormat>(info.format);
+        return result;
+    }
 
-        req.seed = request.seed;
+    /* The C voice list itself, strings included, without copies */
+    VoiceList getVoiceList() {
+        TypecastVoicesResponse* resp = typecast_get_voices(client_, nullptr);
+        if (!resp) throwLastError();
+        return VoiceList(resp);
+    }
 
-        TypecastTTSResponse* resp = typecast_text_to_speech(client_, &req);
-        if (!resp) {
-            const TypecastError* err = typecast_client_get_error(client_);
-            throw TypecastException(err->code, err->message ? err->message : "Unknown error");
+    std::vector<Voice> getVoices() {
+        VoiceList list = getVoiceList();
+        std::vector<Voice> result;
+        result.reserve(list.size());
+        for (const TypecastVoice& voice : list) {
+            Voice v;
+            v.voiceId = voice.voice_id ? voice.voice_id : "";
+            v.voiceName = voice.voice_name ? voice.voice_name : "";
+            result.push_back(std::move(v));
         }
+        return result;
+    }
 
-        TTSResponse result;
-        result.audioData.assign(resp->audio_data, resp->audio_data + resp->audio_size);
-        result.duration = resp->duration;
-        result.format = static_cast<AudioFormat>(resp->format);
+    /* The C recommendation list itself, without copies */
+    RecommendedVoiceList recommendVoiceList(const std::string& query, int count = 5) {
+        TypecastRecommendedVoicesResponse* resp = typecast_recommend_voices(
+            client_,
+            query.c_str(),
+            count
+        );
+        if (!resp) throwLastError();
+        return RecommendedVoiceList(resp);
+    }
 
-        typecast_tts_response_free(resp);
+    std::vector<RecommendedVoice> recommendVoices(const std::string& query, int count = 5) {
+        RecommendedVoiceList list = recommendVoiceList(query, count);
+        std::vector<RecommendedVoice> result;
+        result.reserve(list.size());
+        for (const TypecastRecommendedVoice& voice : list) {
+            RecommendedVoice v;
+            v.voiceId = voice.voice_id ? voice.voice_id : "";
+            v.voiceName = voice.voice_name ? voice.voice_name : "";
+            v.score = voice.score;
+            result.push_back(std::move(v));
+        }
         return result;
     }
 
-    TTSResponse generateToFile(const std::string& filePath, const GenerateToFileRequest& request) {
+    /* The underlying C client, still owned by this object */
+    TypecastClient* handle() const noexcept { return client_; }
+
+private:
+    [[noreturn]] void throwLastError() const {
+        const TypecastError* err = typecast_client_get_error(client_);
+        throw TypecastException(err->code, err->message ? err->message : "Unknown error");
+    }
+
+    /* The TTS request for a file; a .mp3 / .wav extension picks the format */
+    static TTSRequest fileRequestFor(const std::string& filePath, const GenerateToFileRequest& request) {
         TTSRequest ttsRequest;
         ttsRequest.text = request.text;
         ttsRequest.voiceId = request.voiceId;
@@ -1191,69 +2911,543 @@ public:
                 ttsRequest.output.audioFormat = AudioFormat::WAV;
             }
         }
+        return ttsRequest;
+    }
 
-        TTSResponse response = textToSpeech(ttsRequest);
-        std::ofstream out(filePath, std::ios::binary);
-        if (!out) {
-            throw TypecastException(TYPECAST_ERROR_INVALID_PARAM, "Failed to open output file");
+    TypecastClient* client_;
+};
+
+/* ============================================
+ * Asynchronous C++ API
+ * ============================================ */
+
+/* Runs a completion somewhere else, e.g. posts it to a thread pool */
+typedef std::function<void(std::function<void()>)> Executor;
+
+/* Receives streamed audio on the event-loop thread; return false to abort */
+typedef std::function<bool(ByteView)> ChunkHandler;
+
+#ifdef TYPECAST_CPP_HAS_COROUTINES
+/* Tag selecting the co_await-able overloads of AsyncClient */
+struct UseAwaitable {};
+inline constexpr UseAwaitable useAwaitable{};
+#endif
+
+namespace detail {
+
+class EventLoop;
+
+/* What a finished request hands to its future or coroutine */
+template <typename T>
+struct Outcome {
+    T value;
+    TypecastErrorCode code = TYPECAST_OK;
+    std::string message;
+    std::exception_ptr exception;
+
+    T take() {
+        if (exception) std::rethrow_exception(exception);
+        if (code != TYPECAST_OK) throw TypecastException(code, message);
+        return std::move(value);
+    }
+};
+
+/* One request, owned by the event loop from post() until it completes */
+class AsyncOp {
+public:
+    virtual ~AsyncOp() {}
+    /* Submit the C job, with `this` as user data; runs on the loop thread */
+    virtual TypecastAsyncJob* submit(TypecastClient* client) = 0;
+    /* The job finished; it is freed right after */
+    virtual void complete(TypecastAsyncJob* job) = 0;
+    /* Submission failed, or the loop stopped first */
+    virtual void fail(TypecastErrorCode code, const std::string& message) = 0;
+
+    TypecastAsyncJob* job = nullptr;
+    EventLoop* loop = nullptr;
+};
+
+/**
+ * A thread driving the async engine of one C client. Requests are queued
+ * from any thread and submitted by the loop, which is the only thread
+ * that ever touches the client; typecast_async_wakeup() interrupts its
+ * poll when new work arrives.
+ */
+class EventLoop {
+public:
+    EventLoop(TypecastClient* client, Executor executor)
+        : client_(client), executor_(std::move(executor)), stop_(false), started_(false),
+          thread_([this] { run(); }) {}
+
+    ~EventLoop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            if (started_) typecast_async_wakeup(client_);
         }
-        out.write(reinterpret_cast<const char*>(response.audioData.data()), response.audioData.size());
-        if (!out) {
-            throw TypecastException(TYPECAST_ERROR_NETWORK, "Failed to write output file");
+        cond_.notify_one();
+        thread_.join();
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    void post(std::unique_ptr<AsyncOp> op) {
+        /* From a completion: the loop is here already, submit right away */
+        if (std::this_thread::get_id() == thread_.get_id()) {
+            start(op.release());
+            return;
         }
-        return response;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!stop_) {
+                queue_.push_back(op.release());
+                /* Only once the first job created the multi handle */
+                if (started_) typecast_async_wakeup(client_);
+            }
+        }
+        if (op) {
+            op->fail(TYPECAST_ERROR_INVALID_PARAM, "Async client is shutting down");
+            return;
+        }
+        cond_.notify_one();
     }
 
-    std::vector<Voice> getVoices() {
-        TypecastVoicesResponse* resp = typecast_get_voices(client_, nullptr);
-        if (!resp) {
+    /* Run a completion on the executor, or right here on the loop thread */
+    void deliver(std::function<void()> fn) {
+        if (executor_) {
+            executor_(std::move(fn));
+        } else {
+            fn();
+        }
+    }
+
+    static void jobDone(TypecastAsyncJob* job, void* userData) {
+        AsyncOp* op = static_cast<AsyncOp*>(userData);
+        op->loop->active_.erase(op);
+        op->complete(job);
+        typecast_async_job_free(job);
+        delete op;
+    }
+
+private:
+    void start(AsyncOp* op) {
+        op->loop = this;
+        op->job = op->submit(client_);
+        if (!op->job) {
             const TypecastError* err = typecast_client_get_error(client_);
-            throw TypecastException(err->code, err->message ? err->message : "Unknown error");
+            op->fail(err->code, err->message ? err->message : "Unknown error");
+            delete op;
+            return;
         }
+        active_.insert(op);
+        if (!started_) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            started_ = true;
+        }
+    }
 
-        std::vector<Voice> result;
-        result.reserve(resp->count);
+    void run() {
+        std::vector<AsyncOp*> batch;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this] { return stop_ || !queue_.empty() || !active_.empty(); });
+                if (stop_) break;
+                batch.swap(queue_);
+            }
+            for (size_t i = 0; i < batch.size(); i++) start(batch[i]);
+            batch.clear();
+            /* Returns on network activity, a wakeup, or after a second */
+            if (!active_.empty()) typecast_async_poll(client_, 1000, nullptr);
+        }
 
-        for (size_t i = 0; i < resp->count; i++) {
-            Voice v;
-            v.voiceId = resp->voices[i].voice_id ? resp->voices[i].voice_id : "";
-            v.voiceName = resp->voices[i].voice_name ? resp->voices[i].voice_name : "";
-            result.push_back(std::move(v));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch.swap(queue_);
+        }
+        for (size_t i = 0; i < batch.size(); i++) {
+            batch[i]->fail(TYPECAST_ERROR_NETWORK, "Client destroyed before the request completed");
+            delete batch[i];
         }
+        std::unordered_set<AsyncOp*> active;
+        active.swap(active_);
+        for (AsyncOp* op : active) {
+            typecast_async_job_free(op->job);
+            op->fail(TYPECAST_ERROR_NETWORK, "Client destroyed before the request completed");
+            delete op;
+        }
+    }
 
-        typecast_voices_response_free(resp);
-        return result;
+    TypecastClient* client_;
+    Executor executor_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::vector<AsyncOp*> queue_;       /* guarded by mutex_ */
+    bool stop_;                         /* guarded by mutex_ */
+    bool started_;                      /* written under mutex_ by the loop */
+    std::unordered_set<AsyncOp*> active_; /* loop thread only */
+    std::thread thread_;
+};
+
+/* Base of the request kinds: turns the finished job into an Outcome */
+template <typename T>
+class TypedOp : public AsyncOp {
+public:
+    typedef std::function<void(Outcome<T>)> Handler;
+
+    explicit TypedOp(Handler handler) : handler_(std::move(handler)) {}
+
+    void fail(TypecastErrorCode code, const std::string& message) override {
+        Outcome<T> out;
+        out.code = code;
+        out.message = message;
+        handler_(std::move(out));
     }
 
-    std::vector<RecommendedVoice> recommendVoices(const std::string& query, int count = 5) {
-        TypecastRecommendedVoicesResponse* resp = typecast_recommend_voices(
-            client_,
-            query.c_str(),
-            count
-        );
-        if (!resp) {
-            const TypecastError* err = typecast_client_get_error(client_);
-            throw TypecastException(err->code, err->message ? err->message : "Unknown error");
+protected:
+    void finish(TypecastAsyncJob* finished, T value, std::exception_ptr exception = std::exception_ptr()) {
+        Outcome<T> out;
+        out.code = typecast_async_job_result(finished);
+        out.exception = exception;
+        if (out.code != TYPECAST_OK) {
+            const TypecastError* err = typecast_async_job_error(finished);
+            out.message = err && err->message ? err->message : "Unknown error";
+        } else {
+            out.value = std::move(value);
         }
-        std::unique_ptr<TypecastRecommendedVoicesResponse, decltype(&typecast_recommended_voices_response_free)>
-            managed_resp(resp, typecast_recommended_voices_response_free);
+        handler_(std::move(out));
+    }
 
-        std::vector<RecommendedVoice> result;
-        result.reserve(resp->count);
+    void* self() noexcept { return static_cast<AsyncOp*>(this); }
 
-        for (size_t i = 0; i < resp->count; i++) {
-            RecommendedVoice v;
-            v.voiceId = resp->voices[i].voice_id ? resp->voices[i].voice_id : "";
-            v.voiceName = resp->voices[i].voice_name ? resp->voices[i].voice_name : "";
-            v.score = resp->voices[i].score;
-            result.push_back(std::move(v));
+private:
+    Handler handler_;
+};
+
+class TTSOp : public TypedOp<AudioBuffer> {
+public:
+    TTSOp(const TTSRequest& request, Handler handler)
+        : TypedOp<AudioBuffer>(std::move(handler)), request_(request) {}
+
+    TypecastAsyncJob* submit(TypecastClient* client) override {
+        CTTSRequest req(request_);
+        return typecast_async_text_to_speech(client, &req.req, &EventLoop::jobDone, self());
+    }
+    void complete(TypecastAsyncJob* finished) override {
+        finish(finished, AudioBuffer(typecast_async_job_take_tts_response(finished)));
+    }
+
+private:
+    TTSRequest request_;
+};
+
+class TimestampsOp : public TypedOp<TimestampedAudio> {
+public:
+    TimestampsOp(const TTSRequest& request, const std::string& granularity, Handler handler)
+        : TypedOp<TimestampedAudio>(std::move(handler)), request_(request), granularity_(granularity) {}
+
+    TypecastAsyncJob* submit(TypecastClient* client) override {
+        CTTSRequest req(request_);
+        TypecastTTSRequestWithTimestamps ts = {};
+        ts.text = req.req.text;
+        ts.voice_id = req.req.voice_id;
+        ts.model = req.req.model;
+        ts.language = req.req.language;
+        ts.prompt = req.req.prompt;
+        ts.output = req.req.output;
+        ts.seed = req.req.seed;
+        if (!granularity_.empty()) ts.granularity = granularity_.c_str();
+        return typecast_async_text_to_speech_with_timestamps(client, &ts, &EventLoop::jobDone, self());
+    }
+    void complete(TypecastAsyncJob* finished) override {
+        finish(finished, TimestampedAudio(typecast_async_job_take_timestamps_response(finished)));
+    }
+
+private:
+    TTSRequest request_;
+    std::string granularity_;
+};
+
+/* Yields the number of bytes delivered to the handler */
+class StreamOp : public TypedOp<size_t> {
+public:
+    StreamOp(const TTSRequest& request, ChunkHandler onChunk, Handler handler)
+        : TypedOp<size_t>(std::move(handler)), request_(request), onChunk_(std::move(onChunk)), bytes_(0) {}
+
+    TypecastAsyncJob* submit(TypecastClient* client) override {
+        CTTSRequest req(request_);
+        /* The stream endpoint takes no volume */
+        TypecastOutputStream output = {};
+        output.audio_pitch = req.output.audio_pitch;
+        output.audio_tempo = req.output.audio_tempo;
+        output.audio_format = req.output.audio_format;
+        TypecastTTSRequestStream stream = {};
+        stream.text = req.req.text;
+        stream.voice_id = req.req.voice_id;
+        stream.model = req.req.model;
+        stream.language = req.req.language;
+        stream.prompt = req.req.prompt;
+        stream.output = &output;
+        stream.seed = req.req.seed;
+        return typecast_async_text_to_speech_stream(client, &stream, &StreamOp::chunk,
+            &EventLoop::jobDone, self());
+    }
+    void complete(TypecastAsyncJob* finished) override { finish(finished, bytes_, exception_); }
+
+private:
+    static int chunk(const uint8_t* data, size_t len, void* userData) {
+        StreamOp* op = static_cast<StreamOp*>(static_cast<AsyncOp*>(userData));
+        try {
+            if (!op->onChunk_(ByteView(data, len))) return 1;
+        } catch (...) {
+            /* Resurfaces from the future instead of ending the loop thread */
+            op->exception_ = std::current_exception();
+            return 1;
+        }
+        op->bytes_ += len;
+        return 0;
+    }
+
+    TTSRequest request_;
+    ChunkHandler onChunk_;
+    size_t bytes_;
+    std::exception_ptr exception_;
+};
+
+class ComposeOp : public TypedOp<AudioBuffer> {
+public:
+    /* `submitted`, when set, is signalled once the composer has been read */
+    ComposeOp(TypecastSpeechComposer* composer, AudioFormat format, Handler handler,
+              std::promise<void>* submitted)
+        : TypedOp<AudioBuffer>(std::move(handler)), composer_(composer), format_(format),
+          submitted_(submitted) {}
+
+    TypecastAsyncJob* submit(TypecastClient*) override {
+        TypecastAsyncJob* submittedJob = typecast_async_speech_composer_generate(composer_,
+            static_cast<TypecastAudioFormat>(format_), &EventLoop::jobDone, self());
+        signal();
+        return submittedJob;
+    }
+    void complete(TypecastAsyncJob* finished) override {
+        finish(finished, AudioBuffer(typecast_async_job_take_tts_response(finished)));
+    }
+    void fail(TypecastErrorCode code, const std::string& message) override {
+        signal();
+        TypedOp<AudioBuffer>::fail(code, message);
+    }
+
+private:
+    void signal() {
+        if (submitted_) submitted_->set_value();
+        submitted_ = nullptr;
+    }
+
+    TypecastSpeechComposer* composer_;
+    AudioFormat format_;
+    std::promise<void>* submitted_;
+};
+
+/* Settles a promise through the loop's executor */
+template <typename T>
+std::function<void(Outcome<T>)> promiseHandler(EventLoop* loop, std::shared_ptr<std::promise<T>> promise) {
+    return [loop, promise](Outcome<T> out) {
+        std::shared_ptr<Outcome<T>> result = std::make_shared<Outcome<T>>(std::move(out));
+        loop->deliver([promise, result] {
+            try {
+                promise->set_value(result->take());
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+    };
+}
+
+#ifdef TYPECAST_CPP_HAS_COROUTINES
+template <typename T>
+struct AwaitState {
+    Outcome<T> outcome;
+    std::coroutine_handle<> handle;
+};
+#endif
+
+} // namespace detail
+
+#ifdef TYPECAST_CPP_HAS_COROUTINES
+/**
+ * co_await-able request. The request is sent when awaited, and the
+ * coroutine resumes on the event-loop thread or on the client's executor.
+ */
+template <typename T>
+class Awaitable {
+public:
+    typedef std::function<std::unique_ptr<detail::AsyncOp>(typename detail::TypedOp<T>::Handler)> Factory;
+
+    Awaitable(detail::EventLoop* loop, Factory factory)
+        : loop_(loop), factory_(std::move(factory)), state_(std::make_shared<detail::AwaitState<T>>()) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        state_->handle = handle;
+        detail::EventLoop* loop = loop_;
+        std::shared_ptr<detail::AwaitState<T>> state = state_;
+        /* The coroutine may resume (and this awaiter go away) before post returns */
+        loop->post(factory_([loop, state](detail::Outcome<T> out) {
+            state->outcome = std::move(out);
+            loop->deliver([state] { state->handle.resume(); });
+        }));
+    }
+
+    T await_resume() { return state_->outcome.take(); }
+
+private:
+    detail::EventLoop* loop_;
+    Factory factory_;
+    std::shared_ptr<detail::AwaitState<T>> state_;
+};
+#endif
+
+/**
+ * Client for concurrent requests. Every request runs on one event-loop
+ * thread owned by the client, over a single curl multi handle (HTTP/2
+ * multiplexed where the server supports it), so hundreds of renders can
+ * be in flight without a thread each.
+ *
+ * Results arrive as std::future, or through co_await on C++20 (pass
+ * typecast::useAwaitable). Completions run on the event-loop thread unless
+ * an executor is given; either way they must not block for long, and the
+ * client must not be destroyed from one. Destroying the client cancels
+ * the requests still running; their futures fail with
+ * TYPECAST_ERROR_NETWORK. All methods may be called from any thread.
+ */
+class AsyncClient {
+public:
+    explicit AsyncClient(const std::string& apiKey,
+                         const std::string& host = "https://api.typecast.ai",
+                         Executor executor = Executor())
+    {
+        TypecastClientOptions options = {};
+        options.thread_safe = 1;
+        client_ = typecast_client_create_with_options(apiKey.c_str(), host.c_str(), &options);
+        if (!client_) {
+            throw TypecastException(TYPECAST_ERROR_CURL_INIT,
+                "Failed to create Typecast client");
+        }
+        loop_.reset(new detail::EventLoop(client_, std::move(executor)));
+    }
+
+    ~AsyncClient() {
+        loop_.reset();
+        if (client_) typecast_client_destroy(client_);
+    }
+
+    AsyncClient(const AsyncClient&) = delete;
+    AsyncClient& operator=(const AsyncClient&) = delete;
+
+    AsyncClient(AsyncClient&& other) noexcept
+        : client_(other.client_), loop_(std::move(other.loop_)) {
+        other.client_ = nullptr;
+    }
+
+    AsyncClient& operator=(AsyncClient&& other) noexcept {
+        if (this != &other) {
+            loop_.reset();
+            if (client_) typecast_client_destroy(client_);
+            client_ = other.client_;
+            loop_ = std::move(other.loop_);
+            other.client_ = nullptr;
         }
+        return *this;
+    }
+
+    std::future<AudioBuffer> textToSpeechAsync(const TTSRequest& request) {
+        return submit<AudioBuffer>([&](detail::TypedOp<AudioBuffer>::Handler handler) {
+            return new detail::TTSOp(request, std::move(handler));
+        });
+    }
 
+    /* granularity: "word", "char", or empty for both */
+    std::future<TimestampedAudio> textToSpeechWithTimestampsAsync(const TTSRequest& request,
+                                                                  const std::string& granularity = "") {
+        return submit<TimestampedAudio>([&](detail::TypedOp<TimestampedAudio>::Handler handler) {
+            return new detail::TimestampsOp(request, granularity, std::move(handler));
+        });
+    }
+
+    /**
+     * Stream the audio to onChunk, called on the event-loop thread as it
+     * arrives. The future yields the number of bytes delivered; it fails
+     * when onChunk returns false or throws (with that exception).
+     */
+    std::future<size_t> streamAsync(const TTSRequest& request, ChunkHandler onChunk) {
+        return submit<size_t>([&](detail::TypedOp<size_t>::Handler handler) {
+            return new detail::StreamOp(request, std::move(onChunk), std::move(handler));
+        });
+    }
+
+    /**
+     * Render a composition through the compose endpoint. The composer
+     * must have been created on handle(); it is serialized before this
+     * returns, so it may be changed or destroyed right after.
+     */
+    std::future<AudioBuffer> composeAsync(TypecastSpeechComposer* composer,
+                                          AudioFormat format = AudioFormat::WAV) {
+        std::promise<void> submitted;
+        std::future<void> serialized = submitted.get_future();
+        std::future<AudioBuffer> result = submit<AudioBuffer>([&](detail::TypedOp<AudioBuffer>::Handler handler) {
+            return new detail::ComposeOp(composer, format, std::move(handler), &submitted);
+        });
+        serialized.wait();
         return result;
     }
 
+#ifdef TYPECAST_CPP_HAS_COROUTINES
+    Awaitable<AudioBuffer> textToSpeechAsync(const TTSRequest& request, UseAwaitable) {
+        return Awaitable<AudioBuffer>(loop_.get(), [request](detail::TypedOp<AudioBuffer>::Handler handler) {
+            return std::unique_ptr<detail::AsyncOp>(new detail::TTSOp(request, std::move(handler)));
+        });
+    }
+
+    Awaitable<TimestampedAudio> textToSpeechWithTimestampsAsync(const TTSRequest& request, UseAwaitable,
+                                                                const std::string& granularity = "") {
+        return Awaitable<TimestampedAudio>(loop_.get(),
+            [request, granularity](detail::TypedOp<TimestampedAudio>::Handler handler) {
+                return std::unique_ptr<detail::AsyncOp>(
+                    new detail::TimestampsOp(request, granularity, std::move(handler)));
+            });
+    }
+
+    Awaitable<size_t> streamAsync(const TTSRequest& request, ChunkHandler onChunk, UseAwaitable) {
+        return Awaitable<size_t>(loop_.get(), [request, onChunk](detail::TypedOp<size_t>::Handler handler) {
+            return std::unique_ptr<detail::AsyncOp>(new detail::StreamOp(request, onChunk, std::move(handler)));
+        });
+    }
+
+    /* The composer is read when awaited and must stay alive until then */
+    Awaitable<AudioBuffer> composeAsync(TypecastSpeechComposer* composer, UseAwaitable,
+                                        AudioFormat format = AudioFormat::WAV) {
+        return Awaitable<AudioBuffer>(loop_.get(), [composer, format](detail::TypedOp<AudioBuffer>::Handler handler) {
+            return std::unique_ptr<detail::AsyncOp>(
+                new detail::ComposeOp(composer, format, std::move(handler), nullptr));
+        });
+    }
+#endif
+
+    /* The underlying thread-safe C client, for composers; the event loop drives its async engine */
+    TypecastClient* handle() const noexcept { return client_; }
+
 private:
+    template <typename T, typename Make>
+    std::future<T> submit(Make make) {
+        std::shared_ptr<std::promise<T>> promise = std::make_shared<std::promise<T>>();
+        std::future<T> future = promise->get_future();
+        loop_->post(std::unique_ptr<detail::AsyncOp>(make(detail::promiseHandler<T>(loop_.get(), promise))));
+        return future;
+    }
+
     TypecastClient* client_;
+    std::unique_ptr<detail::EventLoop> loop_;
 };
 
 } // namespace typecast
@@ -19,9 +19,6 @@
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
-#if !defined(_WIN32) && !defined(_WIN64)
-    #include <sys/stat.h>
-#endif
 #if defined(_WIN32) || defined(_WIN64)
     #define strncasecmp _strnicmp
 #else
@@ -30,30 +27,31 @@
 #include <curl/curl.h>
 
 #include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_alloc.h"
+#include "typecast_async.h"
+#include "typecast_base64.h"
+#include "typecast_call.h"
+#include "typecast_clone.h"
+#include "typecast_governor.h"
+#include "typecast_hedge.h"
+#include "typecast_json_writer.h"
+#include "typecast_markup.h"
+#include "typecast_metrics.h"
+#include "typecast_result_cache.h"
+#include "typecast_side_table.h"
+#include "typecast_stream_buffer.h"
+#include "typecast_stream_framer.h"
+#include "typecast_timestamps_parser.h"
+#include "typecast_voice_arena.h"
+#include "typecast_voice_cache.h"
+#include "typecast_wav.h"
 #include "cJSON.h"
 
 /* ============================================
  * Internal Structures
  * ============================================ */
 
-struct TypecastClient {
-    char* api_key;
-    char* host;
-    CURL* curl;
-    TypecastError last_error;
-};
-
-typedef struct {
-    uint8_t* data;
-    size_t size;
-    size_t capacity;
-} ResponseBuffer;
-
-typedef struct {
-    char* data;
-    size_t size;
-} HeaderBuffer;
-
 typedef enum {
     COMPOSER_PART_SPEECH,
     COMPOSER_PART_PAUSE
@@ -62,6 +60,7 @@ typedef enum {
 typedef struct {
     ComposerPartKind kind;
     char* text;
+    size_t text_len;
     float pause_seconds;
     TypecastComposerSettings settings;
 } ComposerPart;
@@ -72,6 +71,7 @@ struct TypecastSpeechComposer {
     ComposerPart* parts;
     size_t count;
     size_t capacity;
+    TcResultCache* segment_cache;        /* rendered segments, NULL when off */
 };
 
 /* ============================================
@@ -135,7 +135,8 @@ static const char* ERROR_MESSAGES[] = {
     "Not found",
     "Unprocessable entity",
     "Rate limit exceeded",
-    "Internal server error"
+    "Internal server error",
+    "Request cancelled"
 };
 
 /* ============================================
@@ -152,7 +153,7 @@ static char* strdup_safe(const char* str) {
     return dup;
 }
 
-static int is_blank_string(const char* str) {
+int tc_is_blank_string(const char* str) {
     if (!str) return 1;
     while (*str) {
         if (!isspace((unsigned char)*str)) return 0;
@@ -172,60 +173,8 @@ static int is_default_host(const char* host) {
     return len == strlen(DEFAULT_HOST) && strncasecmp(host, DEFAULT_HOST, len) == 0;
 }
 
-static int infer_audio_format_from_path(const char* path, TypecastAudioFormat* format) {
-    if (!path || !format) return 0;
-    size_t len = strlen(path);
-    if (len >= 4 && strncasecmp(path + len - 4, ".mp3", 4) == 0) {
-        *format = TYPECAST_AUDIO_FORMAT_MP3;
-        return 1;
-    }
-    if (len >= 4 && strncasecmp(path + len - 4, ".wav", 4) == 0) {
-        *format = TYPECAST_AUDIO_FORMAT_WAV;
-        return 1;
-    }
-    return 0;
-}
-
-static int path_is_directory(const char* path) {
-#if defined(_WIN32) || defined(_WIN64)
-    (void)path;
-    return 0;
-#else
-    struct stat st;
-    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
-#endif
-}
-
-static int build_temp_output_path(const char* file_path, char* temp_path, size_t temp_path_size) {
-    static const char* suffix = ".typecast-tmp";
-    size_t path_len = strlen(file_path);
-    size_t suffix_len = strlen(suffix);
-    if (path_len + suffix_len + 1 > temp_path_size) return 0;
-    memcpy(temp_path, file_path, path_len);
-    memcpy(temp_path + path_len, suffix, suffix_len + 1);
-    return 1;
-}
-
-static int preflight_output_path(const char* file_path, char* temp_path, size_t temp_path_size) {
-    if (is_blank_string(file_path)) return 0;
-    if (path_is_directory(file_path)) return 0;
-    if (!build_temp_output_path(file_path, temp_path, temp_path_size)) return 0;
-
-    FILE* file = fopen(temp_path, "wb");
-    if (!file) return 0;
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="fclose failure after writable preflight is not reliably portable to simulate" */
-    if (fclose(file) != 0) {
-        remove(temp_path);
-        return 0;
-    }
-    /* LCOV_EXCL_STOP */
-    remove(temp_path);
-    return 1;
-}
-
 static struct curl_slist* append_api_key_header(struct curl_slist* headers, const char* api_key) {
-    if (is_blank_string(api_key)) {
+    if (tc_is_blank_string(api_key)) {
         return headers;
     }
 
@@ -291,40 +240,99 @@ static struct curl_slist* append_common_headers(struct curl_slist* headers, cons
     return append_user_agent_header(headers, client, timeout_secs);
 }
 
+/* Header lists never change for the lifetime of a client, so they are
+ * built once at create time and shared by every request. */
+static int build_client_headers(TypecastClient* client) {
+    client->headers[TC_HEADERS_JSON] = append_common_headers(
+        curl_slist_append(NULL, "Content-Type: application/json"), client,
+        tc_client_timeout_secs(&client->options, TC_TIMEOUT_REQUEST));
+    client->headers[TC_HEADERS_QUERY] = append_common_headers(NULL, client,
+        tc_client_timeout_secs(&client->options, TC_TIMEOUT_QUERY));
+    client->headers[TC_HEADERS_UPLOAD] = append_common_headers(NULL, client,
+        tc_client_timeout_secs(&client->options, TC_TIMEOUT_UPLOAD));
+    for (int i = 0; i < TC_HEADERS_COUNT; i++) {
+        if (!client->headers[i]) return 0;
+    }
+    return 1;
+}
+
+void tc_error_set(TypecastError* error, TypecastErrorCode code, const char* message) {
+    if (!error) return;
+
+    error->code = code;
+    if (error->message) {
+        free(error->message);
+    }
+    error->message = message ? strdup_safe(message) : NULL;
+}
+
+void tc_error_clear(TypecastError* error) {
+    if (!error) return;
+    error->code = TYPECAST_OK;
+    if (error->message) {
+        free(error->message);
+        error->message = NULL;
+    }
+}
+
 static void set_error(TypecastClient* client, TypecastErrorCode code, const char* message) {
     if (!client) return;
-    
-    client->last_error.code = code;
-    if (client->last_error.message) {
-        free(client->last_error.message);
-    }
-    client->last_error.message = message ? strdup_safe(message) : NULL;
+    tc_error_set(tc_client_error(client), code, message);
+}
+
+static CURL* acquire_curl(TypecastClient* client) {
+    CURL* curl = tc_client_acquire(client);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="a pooled handle is only unavailable when curl_easy_init runs out of memory" */
+    if (!curl) set_error(client, TYPECAST_ERROR_CURL_INIT, "Failed to initialize CURL");
+    /* LCOV_EXCL_STOP */
+    return curl;
 }
 
 static void clear_error(TypecastClient* client) {
     if (!client) return;
-    client->last_error.code = TYPECAST_OK;
-    if (client->last_error.message) {
-        free(client->last_error.message);
-        client->last_error.message = NULL;
-    }
+    tc_error_clear(tc_client_error(client));
+}
+
+/* Error code of a call that returned `result` (NULL on failure) */
+static TypecastErrorCode call_outcome(TypecastClient* client, const void* result) {
+    if (result || !client) return TYPECAST_OK;
+    return tc_client_error(client)->code;
 }
 
 /* ============================================
  * CURL Callbacks
  * ============================================ */
 
-static size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
+/* A larger Content-Length still grows by doubling rather than trusting
+ * the header with one huge allocation */
+#define MAX_PRESIZE_BYTES ((curl_off_t)256 * 1024 * 1024)
+
+/* First allocation: the whole body when Content-Length is known, so the
+ * buffer is never reallocated, else the caller's hint. A compressed body
+ * decodes to more than its Content-Length, so that one uses the hint. */
+static size_t initial_capacity(const ResponseBuffer* buf) {
+    if (buf->curl && !buf->encoded) {
+        curl_off_t length = -1;
+        if (curl_easy_getinfo(buf->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) == CURLE_OK &&
+            length > 0 && length < MAX_PRESIZE_BYTES) {
+            return (size_t)length + 1;
+        }
+    }
+    return buf->size_hint > 0 ? buf->size_hint + 1 : 4096;
+}
+
+size_t tc_response_write(void* contents, size_t size, size_t nmemb, void* userp) {
     size_t realsize = size * nmemb;
     ResponseBuffer* buf = (ResponseBuffer*)userp;
     
     /* Grow buffer if needed */
     if (buf->size + realsize + 1 > buf->capacity) {
-        size_t new_capacity = (buf->capacity == 0) ? 4096 : buf->capacity * 2;
+        size_t new_capacity = (buf->capacity == 0) ? initial_capacity(buf) : buf->capacity * 2;
         while (new_capacity < buf->size + realsize + 1) {
             new_capacity *= 2;
         }
-        uint8_t* new_data = (uint8_t*)realloc(buf->data, new_capacity);
+        uint8_t* new_data = (uint8_t*)tc_mem_realloc(buf->allocator, buf->data, buf->size, new_capacity);
         if (!new_data) return 0;
         buf->data = new_data;
         buf->capacity = new_capacity;
@@ -354,87 +362,172 @@ static size_t header_callback(char* buffer, size_t size, size_t nitems, void* us
     return realsize;
 }
 
+static size_t stream_write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t realsize = size * nmemb;
+    StreamCallbackCtx* ctx = (StreamCallbackCtx*)userp;
+
+    if (ctx->first_chunk_at == 0) ctx->first_chunk_at = tc_monotonic_us();
+    if (ctx->cb((const uint8_t*)contents, realsize, ctx->user_data) != 0) {
+        ctx->aborted = 1;
+        /* Returning a value different from realsize signals an error to
+         * libcurl, which will abort the transfer with CURLE_WRITE_ERROR. */
+        return 0;
+    }
+    return realsize;
+}
+
+/* A framed stream's 200 body goes through its framer; any other body is
+ * buffered for the error detail instead of reaching the callback. */
+static size_t framed_write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t realsize = size * nmemb;
+    TcTransfer* transfer = (TcTransfer*)userp;
+
+    if (transfer->http_status == 0) {
+        curl_easy_getinfo(transfer->response.curl, CURLINFO_RESPONSE_CODE, &transfer->http_status);
+    }
+    if (transfer->http_status != 200) return tc_response_write(contents, size, nmemb, &transfer->response);
+
+    if (transfer->stream.first_chunk_at == 0) transfer->stream.first_chunk_at = tc_monotonic_us();
+    return tc_framer_feed(transfer->framer, (const uint8_t*)contents, realsize) == 0 ? realsize : 0;
+}
+
+/* A buffered stream's 200 body goes into its stream buffer, pausing the
+ * transfer while the buffer is full; any other body is kept for the error
+ * detail. */
+static size_t buffered_write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t realsize = size * nmemb;
+    TcTransfer* transfer = (TcTransfer*)userp;
+
+    if (transfer->http_status == 0) {
+        curl_easy_getinfo(transfer->response.curl, CURLINFO_RESPONSE_CODE, &transfer->http_status);
+    }
+    if (transfer->http_status != 200) return tc_response_write(contents, size, nmemb, &transfer->response);
+
+    int pushed = tc_stream_buffer_push(transfer->buffer, (const uint8_t*)contents, realsize);
+    if (pushed == 0) return CURL_WRITEFUNC_PAUSE;
+    if (pushed < 0) return 0;
+    if (transfer->stream.first_chunk_at == 0) transfer->stream.first_chunk_at = tc_monotonic_us();
+    return realsize;
+}
+
+/* A 200 body is fed to the with-timestamps parser as it arrives; any
+ * other body is buffered for the error detail. */
+static size_t timestamps_write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t realsize = size * nmemb;
+    TcTransfer* transfer = (TcTransfer*)userp;
+
+    if (transfer->http_status == 0) {
+        curl_easy_getinfo(transfer->response.curl, CURLINFO_RESPONSE_CODE, &transfer->http_status);
+        curl_off_t length = -1;
+        curl_easy_getinfo(transfer->response.curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+        /* Compressed, the length says nothing about the decoded audio */
+        if (length > 0 && !transfer->compressed) tc_ts_parser_expect(transfer->timestamps, (size_t)length);
+    }
+    tc_trace_decoded(&transfer->trace, realsize);
+    if (transfer->http_status != 200) return tc_response_write(contents, size, nmemb, &transfer->response);
+
+    uint64_t fed = tc_monotonic_us();
+    int rc = tc_ts_parser_feed(transfer->timestamps, (const char*)contents, realsize);
+    transfer->trace.m.parse_us += (int64_t)(tc_monotonic_us() - fed);
+    if (rc != 0) return 0;
+    if (transfer->tee && tc_response_write(contents, size, nmemb, transfer->tee) != realsize) {
+        /* LCOV_EXCL_START */
+        /* category=oom reason="result cache copy of the body; the response is just not cached" */
+        transfer->tee = NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    return realsize;
+}
+
 /* ============================================
  * JSON Helpers
  * ============================================ */
 
-static cJSON* build_tts_request_json(const TypecastTTSRequest* request) {
-    cJSON* root = cJSON_CreateObject();
-    if (!root) return NULL;
-    
+static void emit_prompt(TcJsonWriter* w, const TypecastPrompt* prompt) {
+    tc_json_key(w, "prompt");
+    tc_json_begin_object(w);
+    switch (prompt->emotion_type) {
+        case TYPECAST_EMOTION_TYPE_SMART:
+            tc_json_field_string(w, "emotion_type", "smart");
+            if (prompt->previous_text) {
+                tc_json_field_string(w, "previous_text", prompt->previous_text);
+            }
+            if (prompt->next_text) {
+                tc_json_field_string(w, "next_text", prompt->next_text);
+            }
+            break;
+
+        case TYPECAST_EMOTION_TYPE_PRESET:
+            tc_json_field_string(w, "emotion_type", "preset");
+            tc_json_field_string(w, "emotion_preset", typecast_emotion_to_string(prompt->emotion_preset));
+            tc_json_field_number(w, "emotion_intensity", prompt->emotion_intensity);
+            break;
+
+        case TYPECAST_EMOTION_TYPE_NONE:
+        default:
+            /* Basic prompt for ssfm-v21 style */
+            tc_json_field_string(w, "emotion_preset", typecast_emotion_to_string(prompt->emotion_preset));
+            tc_json_field_number(w, "emotion_intensity", prompt->emotion_intensity);
+            break;
+    }
+    tc_json_end_object(w);
+}
+
+/* The members every TTS request object starts with */
+static void emit_tts_head(TcJsonWriter* w, const char* text, size_t text_len, const char* voice_id,
+    TypecastModel model, const char* language, const TypecastPrompt* prompt) {
     /* Required fields */
-    cJSON_AddStringToObject(root, "text", request->text);
-    cJSON_AddStringToObject(root, "voice_id", request->voice_id);
-    cJSON_AddStringToObject(root, "model", typecast_model_to_string(request->model));
-    
+    tc_json_field_string_n(w, "text", text, text_len);
+    tc_json_field_string(w, "voice_id", voice_id);
+    tc_json_field_string(w, "model", typecast_model_to_string(model));
+
     /* Optional: language */
-    if (request->language) {
-        cJSON_AddStringToObject(root, "language", request->language);
+    if (language) {
+        tc_json_field_string(w, "language", language);
     }
-    
+
     /* Optional: prompt */
-    if (request->prompt) {
-        cJSON* prompt = cJSON_CreateObject();
-        if (prompt) {
-            switch (request->prompt->emotion_type) {
-                case TYPECAST_EMOTION_TYPE_SMART:
-                    cJSON_AddStringToObject(prompt, "emotion_type", "smart");
-                    if (request->prompt->previous_text) {
-                        cJSON_AddStringToObject(prompt, "previous_text", request->prompt->previous_text);
-                    }
-                    if (request->prompt->next_text) {
-                        cJSON_AddStringToObject(prompt, "next_text", request->prompt->next_text);
-                    }
-                    break;
-                    
-                case TYPECAST_EMOTION_TYPE_PRESET:
-                    cJSON_AddStringToObject(prompt, "emotion_type", "preset");
-                    cJSON_AddStringToObject(prompt, "emotion_preset", 
-                        typecast_emotion_to_string(request->prompt->emotion_preset));
-                    cJSON_AddNumberToObject(prompt, "emotion_intensity", 
-                        request->prompt->emotion_intensity);
-                    break;
-                    
-                case TYPECAST_EMOTION_TYPE_NONE:
-                default:
-                    /* Basic prompt for ssfm-v21 style */
-                    cJSON_AddStringToObject(prompt, "emotion_preset", 
-                        typecast_emotion_to_string(request->prompt->emotion_preset));
-                    cJSON_AddNumberToObject(prompt, "emotion_intensity", 
-                        request->prompt->emotion_intensity);
-                    break;
-            }
-            cJSON_AddItemToObject(root, "prompt", prompt);
-        }
-    }
-    
+    if (prompt) emit_prompt(w, prompt);
+}
+
+/* `text` / `text_len` stand in for request->text, which is not read */
+static void emit_tts_members_text(TcJsonWriter* w, const TypecastTTSRequest* request,
+    const char* text, size_t text_len) {
+    emit_tts_head(w, text, text_len, request->voice_id, request->model, request->language, request->prompt);
+
     /* Optional: output */
     if (request->output) {
-        cJSON* output = cJSON_CreateObject();
-        if (output) {
-            if (request->output->use_target_lufs) {
-                cJSON_AddNumberToObject(output, "target_lufs", request->output->target_lufs);
-            } else {
-                cJSON_AddNumberToObject(output, "volume", request->output->volume);
-            }
-            if (request->output->audio_pitch != 0) {
-                cJSON_AddNumberToObject(output, "audio_pitch", request->output->audio_pitch);
-            }
-            if (request->output->audio_tempo != 0.0f && request->output->audio_tempo != 1.0f) {
-                cJSON_AddNumberToObject(output, "audio_tempo", request->output->audio_tempo);
-            }
-            cJSON_AddStringToObject(output, "audio_format",
-                typecast_audio_format_to_string(request->output->audio_format));
-            cJSON_AddItemToObject(root, "output", output);
+        tc_json_key(w, "output");
+        tc_json_begin_object(w);
+        if (request->output->use_target_lufs) {
+            tc_json_field_number(w, "target_lufs", request->output->target_lufs);
+        } else {
+            tc_json_field_number(w, "volume", request->output->volume);
+        }
+        if (request->output->audio_pitch != 0) {
+            tc_json_field_number(w, "audio_pitch", request->output->audio_pitch);
         }
+        if (request->output->audio_tempo != 0.0f && request->output->audio_tempo != 1.0f) {
+            tc_json_field_number(w, "audio_tempo", request->output->audio_tempo);
+        }
+        tc_json_field_string(w, "audio_format", typecast_audio_format_to_string(request->output->audio_format));
+        tc_json_end_object(w);
     }
 
     /* Optional: seed */
     if (request->seed != 0) {
-        cJSON_AddNumberToObject(root, "seed", request->seed);
+        tc_json_field_number(w, "seed", request->seed);
     }
-    
-    return root;
+}
+
+static void emit_tts_members(TcJsonWriter* w, const TypecastTTSRequest* request) {
+    emit_tts_members_text(w, request, request->text, request->text ? strlen(request->text) : 0);
+}
+
+static void emit_tts_request(TcJsonWriter* w, const void* ctx) {
+    tc_json_begin_object(w);
+    emit_tts_members(w, (const TypecastTTSRequest*)ctx);
+    tc_json_end_object(w);
 }
 
 static TypecastErrorCode http_status_to_error(long status_code) {
@@ -500,14 +593,14 @@ static TypecastAudioFormat parse_audio_format_header(const char* headers, Typeca
  * Voice Parsing
  * ============================================ */
 
-static TypecastGender parse_gender(const char* str) {
+TypecastGender tc_parse_gender(const char* str) {
     if (!str) return TYPECAST_GENDER_UNKNOWN;
     if (strcmp(str, "male") == 0) return TYPECAST_GENDER_MALE;
     if (strcmp(str, "female") == 0) return TYPECAST_GENDER_FEMALE;
     return TYPECAST_GENDER_UNKNOWN;
 }
 
-static TypecastAge parse_age(const char* str) {
+TypecastAge tc_parse_age(const char* str) {
     if (!str) return TYPECAST_AGE_UNKNOWN;
     if (strcmp(str, "child") == 0) return TYPECAST_AGE_CHILD;
     if (strcmp(str, "teenager") == 0) return TYPECAST_AGE_TEENAGER;
@@ -517,90 +610,6 @@ static TypecastAge parse_age(const char* str) {
     return TYPECAST_AGE_UNKNOWN;
 }
 
-static TypecastVoice* parse_voice_json(cJSON* json) {
-    if (!json || !cJSON_IsObject(json)) return NULL;
-    
-    TypecastVoice* voice = (TypecastVoice*)calloc(1, sizeof(TypecastVoice));
-    if (!voice) return NULL;
-    
-    /* voice_id */
-    cJSON* voice_id = cJSON_GetObjectItem(json, "voice_id");
-    if (cJSON_IsString(voice_id)) {
-        voice->voice_id = strdup_safe(voice_id->valuestring);
-    }
-    
-    /* voice_name */
-    cJSON* voice_name = cJSON_GetObjectItem(json, "voice_name");
-    if (cJSON_IsString(voice_name)) {
-        voice->voice_name = strdup_safe(voice_name->valuestring);
-    }
-    
-    /* gender */
-    cJSON* gender = cJSON_GetObjectItem(json, "gender");
-    if (cJSON_IsString(gender)) {
-        voice->gender = parse_gender(gender->valuestring);
-    }
-    
-    /* age */
-    cJSON* age = cJSON_GetObjectItem(json, "age");
-    if (cJSON_IsString(age)) {
-        voice->age = parse_age(age->valuestring);
-    }
-    
-    /* models */
-    cJSON* models = cJSON_GetObjectItem(json, "models");
-    if (cJSON_IsArray(models)) {
-        voice->models_count = cJSON_GetArraySize(models);
-        voice->models = (TypecastModelInfo*)calloc(voice->models_count, sizeof(TypecastModelInfo));
-        if (voice->models) {
-            for (size_t i = 0; i < voice->models_count; i++) {
-                cJSON* model = cJSON_GetArrayItem(models, (int)i);
-                if (cJSON_IsObject(model)) {
-                    cJSON* version = cJSON_GetObjectItem(model, "version");
-                    if (cJSON_IsString(version)) {
-                        int model_idx = typecast_model_from_string(version->valuestring);
-                        if (model_idx >= 0) {
-                            voice->models[i].version = (TypecastModel)model_idx;
-                        }
-                    }
-                    
-                    cJSON* emotions = cJSON_GetObjectItem(model, "emotions");
-                    if (cJSON_IsArray(emotions)) {
-                        voice->models[i].emotions_count = cJSON_GetArraySize(emotions);
-                        voice->models[i].emotions = (char**)calloc(
-                            voice->models[i].emotions_count, sizeof(char*));
-                        if (voice->models[i].emotions) {
-                            for (size_t j = 0; j < voice->models[i].emotions_count; j++) {
-                                cJSON* emotion = cJSON_GetArrayItem(emotions, (int)j);
-                                if (cJSON_IsString(emotion)) {
-                                    voice->models[i].emotions[j] = strdup_safe(emotion->valuestring);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    
-    /* use_cases */
-    cJSON* use_cases = cJSON_GetObjectItem(json, "use_cases");
-    if (cJSON_IsArray(use_cases)) {
-        voice->use_cases_count = cJSON_GetArraySize(use_cases);
-        voice->use_cases = (char**)calloc(voice->use_cases_count, sizeof(char*));
-        if (voice->use_cases) {
-            for (size_t i = 0; i < voice->use_cases_count; i++) {
-                cJSON* use_case = cJSON_GetArrayItem(use_cases, (int)i);
-                if (cJSON_IsString(use_case)) {
-                    voice->use_cases[i] = strdup_safe(use_case->valuestring);
-                }
-            }
-        }
-    }
-    
-    return voice;
-}
-
 /* ============================================
  * Client API Implementation
  * ============================================ */
@@ -613,9 +622,18 @@ TYPECAST_API TypecastClient* typecast_client_create_with_host(
     const char* api_key,
     const char* host
 ) {
-    if (is_blank_string(api_key) && (is_blank_string(host) || is_default_host(host))) {
+    return typecast_client_create_with_options(api_key, host, NULL);
+}
+
+TYPECAST_API TypecastClient* typecast_client_create_with_options(
+    const char* api_key,
+    const char* host,
+    const TypecastClientOptions* options
+) {
+    if (tc_is_blank_string(api_key) && (tc_is_blank_string(host) || is_default_host(host))) {
         return NULL;
     }
+    if (options && !tc_allocator_valid(&options->allocator)) return NULL;
     
     TypecastClient* client = (TypecastClient*)calloc(1, sizeof(TypecastClient));
     if (!client) return NULL;
@@ -631,352 +649,398 @@ TYPECAST_API TypecastClient* typecast_client_create_with_host(
     }
     /* LCOV_EXCL_STOP */
 
-    /* Initialize CURL globally (safe to call multiple times) */
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+    /* Initialize CURL globally (once per process) */
+    tc_global_init();
 
-    client->curl = curl_easy_init();
     /* LCOV_EXCL_START */
-    /* category=unreachable reason="curl_easy_init failure requires libcurl internal OOM" */
-    if (!client->curl) {
+    /* category=oom reason="handle, pool and share allocation only fail on OOM" */
+    if (tc_client_setup(client, options) != TYPECAST_OK || !build_client_headers(client)) {
         typecast_client_destroy(client);
         return NULL;
     }
     /* LCOV_EXCL_STOP */
-    
+
+    client->voice_cache = tc_voice_cache_new(options, client->host, client->api_key);
+    client->result_cache = tc_result_cache_new(options);
+    client->governor = tc_governor_new(options);
+    client->metrics = tc_metrics_new(options);
+    client->hedge = tc_hedge_new(options);
+    tc_governor_prime(client);
+
     return client;
 }
 
 TYPECAST_API void typecast_client_destroy(TypecastClient* client) {
     if (!client) return;
     
+    tc_async_shutdown(client);
     if (client->api_key) free(client->api_key);
     if (client->host) free(client->host);
     if (client->last_error.message) free(client->last_error.message);
-    if (client->curl) curl_easy_cleanup(client->curl);
+    tc_client_teardown(client);
+    tc_voice_cache_free(client->voice_cache);
+    tc_result_cache_free(client->result_cache);
+    tc_governor_free(client->governor);
+    tc_hedge_free(client->hedge);
+    tc_metrics_free(client->metrics);
+    for (int i = 0; i < TC_HEADERS_COUNT; i++) {
+        curl_slist_free_all(client->headers[i]);
+    }
     
     free(client);
 }
 
 TYPECAST_API const TypecastError* typecast_client_get_error(const TypecastClient* client) {
     if (!client) return NULL;
-    return &client->last_error;
+    /* The per-thread error table is internal bookkeeping, not client state */
+    return tc_client_error((TypecastClient*)client);
 }
 
 /* ============================================
- * Text-to-Speech Implementation
+ * Transfers
+ *
+ * Each request is split into prepare (URL, body, headers), apply (easy
+ * handle options) and finish (status and response mapping) so that the
+ * blocking API and the async engine share the exact same request and
+ * response handling.
  * ============================================ */
 
-TYPECAST_API TypecastTTSResponse* typecast_text_to_speech(
+static char* parse_error_detail(const ResponseBuffer* response) {
+    if (!response->data || response->size == 0) return NULL;
+    char* message = NULL;
+    cJSON* err_json = cJSON_Parse((const char*)response->data);
+    if (err_json) {
+        cJSON* detail = cJSON_GetObjectItem(err_json, "detail");
+        if (cJSON_IsString(detail)) {
+            message = strdup_safe(detail->valuestring);
+        }
+        cJSON_Delete(err_json);
+    }
+    return message;
+}
+
+static TypecastErrorCode transfer_prepare_json(
     TypecastClient* client,
-    const TypecastTTSRequest* request
+    TcTransfer* transfer,
+    TcRequestKind kind,
+    const char* path_and_query,
+    tc_json_emit_t emit,
+    const void* ctx,
+    uint64_t started,
+    TypecastError* error
 ) {
-    if (!client || !request) {
-        if (client) set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
-        return NULL;
-    }
-    
-    if (!request->text || !request->voice_id) {
-        set_error(client, TYPECAST_ERROR_INVALID_PARAM, "text and voice_id are required");
-        return NULL;
-    }
-    
-    clear_error(client);
-    
-    /* Build URL */
-    char url[512];
-    snprintf(url, sizeof(url), "%s/v1/text-to-speech", client->host);
-    
-    /* Build JSON body */
-    cJSON* json = build_tts_request_json(request);
+    static const TypecastRequestType TRACE_TYPES[] = {
+        TYPECAST_REQUEST_TTS, TYPECAST_REQUEST_COMPOSE, TYPECAST_REQUEST_STREAM, TYPECAST_REQUEST_TIMESTAMPS
+    };
+    memset(transfer, 0, sizeof(*transfer));
+    tc_trace_begin(&transfer->trace, TRACE_TYPES[kind], started);
+    transfer->kind = kind;
+    tc_call_settings(client, TC_TIMEOUT_REQUEST, &transfer->call);
+    transfer->format = TYPECAST_AUDIO_FORMAT_WAV;
+    snprintf(transfer->url, sizeof(transfer->url), "%s%s", client->host, path_and_query);
+
+    transfer->body = tc_json_write(emit, ctx, &transfer->body_len);
+
     /* LCOV_EXCL_START */
-    /* category=unreachable reason="cJSON OOM; cannot be triggered in unit tests" */
-    if (!json) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to build JSON");
-        return NULL;
+    /* category=oom reason="request body allocation" */
+    if (!transfer->body) {
+        tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to serialize JSON");
+        return TYPECAST_ERROR_OUT_OF_MEMORY;
     }
     /* LCOV_EXCL_STOP */
 
-    char* json_str = cJSON_PrintUnformatted(json);
-    cJSON_Delete(json);
+    transfer->headers = client->headers[TC_HEADERS_JSON];
+    tc_trace_prepared(&transfer->trace);
+    return TYPECAST_OK;
+}
 
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="cJSON_PrintUnformatted OOM" */
-    if (!json_str) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to serialize JSON");
-        return NULL;
+/* Audio bodies go through the client's allocator and the size hint */
+static void transfer_use_audio_buffer(TypecastClient* client, TcTransfer* transfer) {
+    transfer->response.allocator = &client->options.allocator;
+    transfer->response.size_hint = client->options.response_size_hint;
+}
+
+TypecastErrorCode tc_transfer_prepare_tts(
+    TypecastClient* client,
+    const TypecastTTSRequest* request,
+    TcTransfer* transfer,
+    TypecastError* error
+) {
+    uint64_t started = tc_monotonic_us();
+    TypecastErrorCode err = transfer_prepare_json(client, transfer, TC_REQUEST_TTS,
+        "/v1/text-to-speech", emit_tts_request, request, started, error);
+    transfer_use_audio_buffer(client, transfer);
+    transfer->hedgeable = request->seed != 0;
+    if (request->output) {
+        transfer->format = request->output->audio_format;
     }
-    /* LCOV_EXCL_STOP */
-    
-    /* Setup response buffers */
-    ResponseBuffer response_buf = {0};
-    HeaderBuffer header_buf = {0};
-    
-    /* Setup CURL */
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
-    
-    struct curl_slist* headers = NULL;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = append_common_headers(headers, client, 60L);
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_str);
-    /* Explicit body size — without this libcurl uses strlen() which can
-     * walk past the end of cJSON's print buffer on some platforms/glibc
-     * heap layouts and include stale bytes in the request body. */
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)strlen(json_str));
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_buf);
-    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_callback);
-    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &header_buf);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 60L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    
-    /* Perform request */
-    CURLcode res = curl_easy_perform(curl);
-    
-    cJSON_free(json_str);
-    curl_slist_free_all(headers);
-    
-    if (res != CURLE_OK) {
-        set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(res));
-        if (response_buf.data) free(response_buf.data);
-        if (header_buf.data) free(header_buf.data);
+    return err;
+}
+
+static TypecastErrorCode transfer_prepare_compose(
+    TypecastClient* client,
+    tc_json_emit_t emit,
+    const void* ctx,
+    TypecastAudioFormat format,
+    uint64_t started,
+    TcTransfer* transfer,
+    TypecastError* error
+) {
+    TypecastErrorCode err = transfer_prepare_json(client, transfer, TC_REQUEST_COMPOSE,
+        "/v1/text-to-speech/compose", emit, ctx, started, error);
+    transfer_use_audio_buffer(client, transfer);
+    transfer->format = format;
+    return err;
+}
+
+void tc_transfer_apply(CURL* curl, TcTransfer* transfer) {
+    transfer->response.curl = curl;
+    transfer->response.encoded = transfer->compressed;
+    curl_easy_setopt(curl, CURLOPT_URL, transfer->url);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer->headers);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, transfer->body);
+    /* Explicit body size, tracked by the writer, so libcurl never runs
+     * strlen() over the body */
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)transfer->body_len);
+    /* libcurl decodes in its write path, so callbacks still see the body
+     * as it arrives */
+    if (transfer->compressed) curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    if (transfer->framer) {
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, framed_write_callback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer);
+    } else if (transfer->buffer) {
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, buffered_write_callback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer);
+    } else if (transfer->kind == TC_REQUEST_STREAM) {
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, stream_write_callback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer->stream);
+    } else if (transfer->kind == TC_REQUEST_TIMESTAMPS) {
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, timestamps_write_callback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_callback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer->response_headers);
+    } else {
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, transfer->sink_write ? transfer->sink_write : tc_response_write);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer->sink_write ? transfer->sink_data : (void*)&transfer->response);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_callback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer->response_headers);
+    }
+    tc_call_apply(curl, &transfer->call);
+}
+
+void tc_transfer_cleanup(TcTransfer* transfer) {
+    if (!transfer) return;
+    free(transfer->body);
+    tc_ts_parser_free(transfer->timestamps);
+    tc_framer_free(transfer->framer);
+    tc_mem_free(transfer->response.allocator, transfer->response.data);
+    free(transfer->response_headers.data);
+    memset(transfer, 0, sizeof(*transfer));
+}
+
+TypecastTTSResponse* tc_transfer_finish_tts(
+    TcTransfer* transfer,
+    CURL* curl,
+    CURLcode result,
+    TypecastError* error
+) {
+    if (result != CURLE_OK) {
+        tc_call_error(&transfer->call, result, error);
         return NULL;
     }
-    
+
     /* Check HTTP status */
     long http_code = 0;
     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    
+
     if (http_code != 200) {
         TypecastErrorCode err_code = http_status_to_error(http_code);
-        
+
         /* Try to parse error message from response */
-        char* err_msg = NULL;
-        if (response_buf.data && response_buf.size > 0) {
-            cJSON* err_json = cJSON_Parse((const char*)response_buf.data);
-            if (err_json) {
-                cJSON* detail = cJSON_GetObjectItem(err_json, "detail");
-                if (cJSON_IsString(detail)) {
-                    err_msg = strdup_safe(detail->valuestring);
-                }
-                cJSON_Delete(err_json);
-            }
-        }
-        
-        set_error(client, err_code, err_msg ? err_msg : typecast_error_message(err_code));
+        char* err_msg = transfer->kind == TC_REQUEST_TTS ? parse_error_detail(&transfer->response) : NULL;
+        tc_error_set(error, err_code, err_msg ? err_msg : typecast_error_message(err_code));
         if (err_msg) free(err_msg);
-        if (response_buf.data) free(response_buf.data);
-        if (header_buf.data) free(header_buf.data);
         return NULL;
     }
-    
+
     /* Create response */
-    TypecastTTSResponse* resp = (TypecastTTSResponse*)calloc(1, sizeof(TypecastTTSResponse));
+    TypecastTTSResponse* resp = tc_tts_response_new(transfer->response.allocator);
     /* LCOV_EXCL_START */
     /* category=unreachable reason="calloc OOM; cannot be triggered deterministically" */
     if (!resp) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response");
-        if (response_buf.data) free(response_buf.data);
-        if (header_buf.data) free(header_buf.data);
+        tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response");
         return NULL;
     }
     /* LCOV_EXCL_STOP */
-    
-    resp->audio_data = response_buf.data;
-    resp->audio_size = response_buf.size;
-    resp->duration = parse_duration_header(header_buf.data);
-    
+
+    resp->audio_data = transfer->response.data;
+    resp->audio_size = transfer->response.size;
+    transfer->response.data = NULL;
+    transfer->response.size = 0;
+    transfer->response.capacity = 0;
+    resp->duration = parse_duration_header(transfer->response_headers.data);
+
     /* Determine format from request or content-type */
-    if (request->output) {
-        resp->format = request->output->audio_format;
+    if (transfer->kind == TC_REQUEST_COMPOSE) {
+        resp->format = parse_audio_format_header(transfer->response_headers.data, transfer->format);
     } else {
-        resp->format = TYPECAST_AUDIO_FORMAT_WAV;
+        resp->format = transfer->format;
     }
-    
-    if (header_buf.data) free(header_buf.data);
-    
+
     return resp;
 }
 
-TYPECAST_API void typecast_tts_response_free(TypecastTTSResponse* response) {
-    if (!response) return;
-    if (response->audio_data) free(response->audio_data);
-    free(response);
-}
-
-static TypecastTTSResponse* post_compose_json(TypecastClient* client, cJSON* json, TypecastAudioFormat format) {
-    char* json_str = cJSON_PrintUnformatted(json);
-    if (!json_str) { set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to serialize JSON"); return NULL; }
-    char url[512];
-    snprintf(url, sizeof(url), "%s/v1/text-to-speech/compose", client->host);
-    ResponseBuffer response_buf = {0};
-    HeaderBuffer header_buf = {0};
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
-    struct curl_slist* headers = NULL;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = append_common_headers(headers, client, 60L);
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_str);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)strlen(json_str));
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_buf);
-    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_callback);
-    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &header_buf);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 60L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    CURLcode result = curl_easy_perform(curl);
-    cJSON_free(json_str);
-    curl_slist_free_all(headers);
-    if (result != CURLE_OK) {
-        set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(result));
-        free(response_buf.data); free(header_buf.data); return NULL;
-    }
-    long status = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
-    if (status != 200) {
-        TypecastErrorCode code = http_status_to_error(status);
-        set_error(client, code, typecast_error_message(code));
-        free(response_buf.data); free(header_buf.data); return NULL;
-    }
-    TypecastTTSResponse* response = (TypecastTTSResponse*)calloc(1, sizeof(TypecastTTSResponse));
-    /* LCOV_EXCL_START - allocation failure is not deterministic in unit tests. */
-    if (!response) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response");
-        free(response_buf.data); free(header_buf.data); return NULL;
+void tc_transfer_rewind(TcTransfer* transfer) {
+    tc_mem_free(transfer->response.allocator, transfer->response.data);
+    transfer->response.data = NULL;
+    transfer->response.size = 0;
+    transfer->response.capacity = 0;
+    free(transfer->response_headers.data);
+    transfer->response_headers.data = NULL;
+    transfer->response_headers.size = 0;
+    transfer->http_status = 0;
+}
+
+CURL* tc_transfer_perform(TypecastClient* client, TcTransfer* transfer, CURLcode* result) {
+    CURL* curl = acquire_curl(client);
+    if (!curl) return NULL; /* LCOV_EXCL_LINE category=oom reason="see acquire_curl" */
+
+    /* A stream hands error bodies to the caller's callback, so only the
+     * buffered kinds can be retried */
+    int retryable = transfer->kind != TC_REQUEST_STREAM;
+    int hedged = tc_hedge_applies(client, transfer);
+    for (unsigned int attempt = 0;; attempt++) {
+        long pause;
+        while ((pause = tc_governor_enter(client->governor)) > 0) {
+            if (tc_call_sleep(&transfer->call, pause)) continue;
+            /* Cancelled, or the pause outlasts the deadline */
+            if (!typecast_cancel_token_is_cancelled(transfer->call.cancel)) transfer->call.expired = 1;
+            *result = CURLE_ABORTED_BY_CALLBACK;
+            return curl;
+        }
+        tc_transfer_apply(curl, transfer);
+        if (hedged) {
+            curl = tc_hedge_perform(client, transfer, curl, result);
+        } else if (transfer->buffer) {
+            *result = tc_stream_buffer_perform(transfer->buffer, transfer, curl);
+        } else {
+            *result = curl_easy_perform(curl);
+        }
+        tc_trace_attempt(&transfer->trace, curl);
+        long http_code = 0;
+        if (*result == CURLE_OK) curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        long delay = tc_governor_leave(client->governor, attempt, retryable, http_code,
+            transfer->response_headers.data);
+        if (delay < 0 || !tc_call_sleep(&transfer->call, delay)) break;
+        tc_transfer_rewind(transfer);
     }
-    /* LCOV_EXCL_STOP */
-    response->audio_data = response_buf.data;
-    response->audio_size = response_buf.size;
-    response->duration = parse_duration_header(header_buf.data);
-    response->format = parse_audio_format_header(header_buf.data, format);
-    free(header_buf.data);
-    return response;
+    return curl;
 }
 
 /* ============================================
- * Composed Speech API
+ * Text-to-Speech Implementation
  * ============================================ */
 
-static int parse_pause_token(const char* token, size_t len, float* seconds) {
-    if (!token || !seconds || len < 2 || token[len - 1] != 's') return 0;
-    for (size_t i = 0; i < len - 1; i++) {
-        if (!isdigit((unsigned char)token[i]) && token[i] != '.') return 0;
-    }
-    char buf[64];
-    if (len >= sizeof(buf)) return 0;
-    memcpy(buf, token, len - 1);
-    buf[len - 1] = '\0';
-    char* end = NULL;
-    float value = strtof(buf, &end);
-    if (!end || *end != '\0' || !isfinite(value) || value <= 0.0f) return 0;
-    *seconds = value;
-    return 1;
-}
-
-static TypecastErrorCode append_speech_part(TypecastSpeechPart** parts, size_t* count, size_t* capacity, TypecastSpeechPart part) {
-    if (*count == *capacity) {
-        size_t next = (*capacity == 0) ? 4 : (*capacity * 2);
-        TypecastSpeechPart* resized = (TypecastSpeechPart*)realloc(*parts, next * sizeof(TypecastSpeechPart));
-        if (!resized) return TYPECAST_ERROR_OUT_OF_MEMORY;
-        *parts = resized;
-        *capacity = next;
+TYPECAST_API TypecastTTSResponse* typecast_text_to_speech(
+    TypecastClient* client,
+    const TypecastTTSRequest* request
+) {
+    if (!client || !request) {
+        if (client) set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return NULL;
     }
-    (*parts)[(*count)++] = part;
-    return TYPECAST_OK;
-}
+    
+    if (!request->text || !request->voice_id) {
+        set_error(client, TYPECAST_ERROR_INVALID_PARAM, "text and voice_id are required");
+        return NULL;
+    }
+    
+    clear_error(client);
 
-TYPECAST_API TypecastErrorCode typecast_parse_pause_markup(
-    const char* text,
-    TypecastSpeechPart** out_parts,
-    size_t* out_count
-) {
-    if (!text || !out_parts || !out_count) return TYPECAST_ERROR_INVALID_PARAM;
-    *out_parts = NULL;
-    *out_count = 0;
+    TcTransfer transfer;
+    if (tc_transfer_prepare_tts(client, request, &transfer, tc_client_error(client)) != TYPECAST_OK) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="request serialization only fails on OOM" */
+        tc_transfer_cleanup(&transfer);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
 
-    TypecastSpeechPart* parts = NULL;
-    size_t count = 0;
-    size_t capacity = 0;
-    size_t text_start = 0;
-    size_t search_start = 0;
-    size_t len = strlen(text);
-
-    while (search_start < len) {
-        const char* start_ptr = strstr(text + search_start, "<|");
-        if (!start_ptr) break;
-        size_t start = (size_t)(start_ptr - text);
-        size_t value_start = start + 2;
-        const char* end_ptr = strstr(text + value_start, "|>");
-        if (!end_ptr) break;
-        size_t end = (size_t)(end_ptr - text);
-        float seconds = 0.0f;
-        if (parse_pause_token(text + value_start, end - value_start, &seconds)) {
-            size_t text_len = start - text_start;
-            char* chunk = (char*)malloc(text_len + 1);
-            /* LCOV_EXCL_START */
-            if (!chunk) {
-                typecast_speech_parts_free(parts, count);
-                return TYPECAST_ERROR_OUT_OF_MEMORY;
-            }
-            /* LCOV_EXCL_STOP */
-            memcpy(chunk, text + text_start, text_len);
-            chunk[text_len] = '\0';
-            TypecastErrorCode err = append_speech_part(&parts, &count, &capacity, (TypecastSpeechPart){ .text = chunk, .pause_seconds = 0.0f, .is_pause = 0 });
-            /* LCOV_EXCL_START */
-            if (err != TYPECAST_OK) {
-                free(chunk);
-                typecast_speech_parts_free(parts, count);
-                return err;
-            }
-            /* LCOV_EXCL_STOP */
-            err = append_speech_part(&parts, &count, &capacity, (TypecastSpeechPart){ .text = NULL, .pause_seconds = seconds, .is_pause = 1 });
-            /* LCOV_EXCL_START */
-            if (err != TYPECAST_OK) {
-                typecast_speech_parts_free(parts, count);
-                return err;
-            }
-            /* LCOV_EXCL_STOP */
-            text_start = end + 2;
-            search_start = text_start;
-        } else {
-            search_start = value_start;
+    int cacheable = tc_result_cache_accepts(client->result_cache, request->seed);
+    TcCachedResult cached;
+    if (cacheable && tc_result_cache_lookup(client->result_cache, &transfer, &client->options.allocator, &cached)) {
+        tc_transfer_cleanup(&transfer);
+        TypecastTTSResponse* hit = tc_tts_response_new(&client->options.allocator);
+        /* LCOV_EXCL_START */
+        /* category=oom reason="response allocation" */
+        if (!hit) {
+            tc_mem_free(&client->options.allocator, cached.data);
+            set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response");
+            return NULL;
         }
-    }
+        /* LCOV_EXCL_STOP */
+        hit->audio_data = cached.data;
+        hit->audio_size = cached.size;
+        hit->duration = cached.duration;
+        hit->format = cached.format;
+        return hit;
+    }
+
+    CURLcode res = CURLE_OK;
+    CURL* curl = tc_transfer_perform(client, &transfer, &res);
+    TypecastTTSResponse* resp = curl ? tc_transfer_finish_tts(&transfer, curl, res, tc_client_error(client)) : NULL;
+    tc_client_release(client, curl);
+    tc_trace_end(client, &transfer.trace, resp ? TYPECAST_OK : tc_client_error(client)->code);
+    if (resp && cacheable) {
+        tc_result_cache_store(client->result_cache, &transfer, resp->audio_data, resp->audio_size,
+            resp->duration, resp->format);
+    }
+    tc_transfer_cleanup(&transfer);
+    return resp;
+}
 
-    char* tail = strdup_safe(text + text_start);
-    /* LCOV_EXCL_START */
-    if (!tail) {
-        typecast_speech_parts_free(parts, count);
-        return TYPECAST_ERROR_OUT_OF_MEMORY;
-    }
-    /* LCOV_EXCL_STOP */
-    TypecastErrorCode err = append_speech_part(&parts, &count, &capacity, (TypecastSpeechPart){ .text = tail, .pause_seconds = 0.0f, .is_pause = 0 });
-    /* LCOV_EXCL_START */
-    if (err != TYPECAST_OK) {
-        free(tail);
-        typecast_speech_parts_free(parts, count);
-        return err;
-    }
-    /* LCOV_EXCL_STOP */
+TYPECAST_API void typecast_tts_response_free(TypecastTTSResponse* response) {
+    if (!response) return;
+    TypecastAllocator allocator;
+    tc_tts_response_release(response, &allocator);
+    tc_mem_free(&allocator, response->audio_data);
+    free(response);
+}
 
-    *out_parts = parts;
-    *out_count = count;
-    return TYPECAST_OK;
+TYPECAST_API uint8_t* typecast_tts_response_take_audio(TypecastTTSResponse* response, size_t* size) {
+    if (size) *size = 0;
+    if (!response) return NULL;
+    uint8_t* audio = response->audio_data;
+    if (size) *size = response->audio_size;
+    response->audio_data = NULL;
+    response->audio_size = 0;
+    return audio;
 }
 
-TYPECAST_API void typecast_speech_parts_free(TypecastSpeechPart* parts, size_t count) {
-    if (!parts) return;
-    for (size_t i = 0; i < count; i++) {
-        free(parts[i].text);
+/* `started` is when building the body began, for the call's prepare_us */
+static TypecastTTSResponse* post_compose_json(TypecastClient* client, tc_json_emit_t emit, const void* ctx,
+    TypecastAudioFormat format, uint64_t started) {
+    TcTransfer transfer;
+    if (transfer_prepare_compose(client, emit, ctx, format, started, &transfer, tc_client_error(client)) != TYPECAST_OK) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="request serialization only fails on OOM" */
+        tc_transfer_cleanup(&transfer);
+        return NULL;
+        /* LCOV_EXCL_STOP */
     }
-    free(parts);
+    CURLcode result = CURLE_OK;
+    CURL* curl = tc_transfer_perform(client, &transfer, &result);
+    TypecastTTSResponse* response = curl ? tc_transfer_finish_tts(&transfer, curl, result, tc_client_error(client)) : NULL;
+    tc_client_release(client, curl);
+    tc_trace_end(client, &transfer.trace, response ? TYPECAST_OK : tc_client_error(client)->code);
+    tc_transfer_cleanup(&transfer);
+    return response;
 }
 
+/* ============================================
+ * Composed Speech API
+ * ============================================ */
+
 static TypecastComposerOutput merge_composer_output(TypecastComposerOutput base, TypecastComposerOutput overrides) {
     TypecastComposerOutput out = base;
     if (overrides.use_volume) {
@@ -1046,15 +1110,46 @@ TYPECAST_API TypecastSpeechComposer* typecast_speech_composer_create(TypecastCli
     return composer;
 }
 
-TYPECAST_API void typecast_speech_composer_destroy(TypecastSpeechComposer* composer) {
+TYPECAST_API void typecast_speech_composer_clear(TypecastSpeechComposer* composer) {
     if (!composer) return;
     for (size_t i = 0; i < composer->count; i++) {
         free(composer->parts[i].text);
     }
+    composer->count = 0;
+}
+
+TYPECAST_API void typecast_speech_composer_destroy(TypecastSpeechComposer* composer) {
+    if (!composer) return;
+    typecast_speech_composer_clear(composer);
     free(composer->parts);
+    tc_result_cache_free(composer->segment_cache);
     free(composer);
 }
 
+TYPECAST_API TypecastErrorCode typecast_speech_composer_enable_cache(TypecastSpeechComposer* composer, size_t max_bytes) {
+    if (!composer) return TYPECAST_ERROR_INVALID_PARAM;
+    tc_result_cache_free(composer->segment_cache);
+    composer->segment_cache = NULL;
+    if (max_bytes == 0) return TYPECAST_OK;
+    TypecastClientOptions options = {0};
+    options.result_cache_max_bytes = max_bytes;
+    composer->segment_cache = tc_result_cache_new(&options);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="segment cache allocation" */
+    if (!composer->segment_cache) {
+        set_error(composer->client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate segment cache");
+        return TYPECAST_ERROR_OUT_OF_MEMORY;
+    }
+    /* LCOV_EXCL_STOP */
+    return TYPECAST_OK;
+}
+
+TYPECAST_API TypecastErrorCode typecast_speech_composer_cache_stats(TypecastSpeechComposer* composer, TypecastResultCacheStats* out) {
+    if (!composer || !out) return TYPECAST_ERROR_INVALID_PARAM;
+    tc_result_cache_stats(composer->segment_cache, out);
+    return TYPECAST_OK;
+}
+
 TYPECAST_API TypecastErrorCode typecast_speech_composer_defaults(TypecastSpeechComposer* composer, const TypecastComposerSettings* settings) {
     if (!composer || !settings) return TYPECAST_ERROR_INVALID_PARAM;
     composer->defaults = merge_composer_settings(composer->defaults, *settings);
@@ -1094,12 +1189,35 @@ TYPECAST_API TypecastErrorCode typecast_speech_composer_say(
     ComposerPart part = {0};
     part.kind = COMPOSER_PART_SPEECH;
     part.text = copy;
+    part.text_len = strlen(copy);
     if (overrides) part.settings = *overrides;
     TypecastErrorCode err = append_composer_part(composer, part);
     if (err != TYPECAST_OK) free(copy);
     return err;
 }
 
+TYPECAST_API TypecastErrorCode typecast_speech_composer_set_text(
+    TypecastSpeechComposer* composer,
+    size_t index,
+    const char* text
+) {
+    if (!composer || !text || index >= composer->count) return TYPECAST_ERROR_INVALID_PARAM;
+    ComposerPart* part = &composer->parts[index];
+    if (part->kind != COMPOSER_PART_SPEECH) return TYPECAST_ERROR_INVALID_PARAM;
+    char* copy = strdup_safe(text);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="speech text allocation" */
+    if (!copy) {
+        set_error(composer->client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate speech text");
+        return TYPECAST_ERROR_OUT_OF_MEMORY;
+    }
+    /* LCOV_EXCL_STOP */
+    free(part->text);
+    part->text = copy;
+    part->text_len = strlen(copy);
+    return TYPECAST_OK;
+}
+
 TYPECAST_API TypecastErrorCode typecast_speech_composer_pause(TypecastSpeechComposer* composer, float seconds) {
     if (!composer || !isfinite(seconds) || seconds <= 0.0f) return TYPECAST_ERROR_INVALID_PARAM;
     ComposerPart part = {0};
@@ -1136,7 +1254,7 @@ TYPECAST_API TypecastErrorCode typecast_speech_composer_segment_requests(
     for (size_t i = 0; i < composer->count; i++) {
         if (composer->parts[i].kind != COMPOSER_PART_SPEECH) continue;
         TypecastComposerSettings merged = merge_composer_settings(composer->defaults, composer->parts[i].settings);
-        if (is_blank_string(merged.voice_id)) {
+        if (tc_is_blank_string(merged.voice_id)) {
             free(requests);
             free(outputs);
             set_error(composer->client, TYPECAST_ERROR_INVALID_PARAM, "voice_id is required for composed speech");
@@ -1165,257 +1283,462 @@ TYPECAST_API void typecast_speech_composer_segment_requests_free(TypecastTTSRequ
     free(requests);
 }
 
-TYPECAST_API TypecastTTSResponse* typecast_speech_composer_generate(
-    TypecastSpeechComposer* composer,
-    TypecastAudioFormat output_format
-) {
-    if (!composer) return NULL;
-    cJSON* root = cJSON_CreateObject();
-    cJSON* segments = cJSON_AddArrayToObject(root, "segments");
+/* One renderable step of a composition: a speech request with inline
+ * pause markup already split out, or a pause. The text is a view into
+ * the composer part it came from. */
+typedef struct {
+    int is_pause;
+    float pause_seconds;
+    const char* text;
+    size_t text_len;
+    TypecastComposerSettings settings;   /* defaults merged with overrides */
+} ComposerPiece;
+
+static TypecastErrorCode composer_plan_append(ComposerPiece** pieces, size_t* count, size_t* capacity, ComposerPiece piece) {
+    if (*count == *capacity) {
+        size_t next = (*capacity == 0) ? 8 : *capacity * 2;
+        ComposerPiece* resized = (ComposerPiece*)realloc(*pieces, next * sizeof(ComposerPiece));
+        /* LCOV_EXCL_START */
+        /* category=oom reason="realloc of the composition plan" */
+        if (!resized) return TYPECAST_ERROR_OUT_OF_MEMORY;
+        /* LCOV_EXCL_STOP */
+        *pieces = resized;
+        *capacity = next;
+    }
+    (*pieces)[(*count)++] = piece;
+    return TYPECAST_OK;
+}
+
+static int span_is_blank(const char* text, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (!isspace((unsigned char)text[i])) return 0;
+    }
+    return 1;
+}
+
+/* Markup scan of one speech part into the plan */
+typedef struct {
+    const char* text;
+    const TypecastComposerSettings* settings;
+    ComposerPiece** pieces;
+    size_t* count;
+    size_t* capacity;
+    int has_speech;
+} ComposerScan;
+
+static int composer_plan_span(const TypecastSpeechSpan* span, void* ctx) {
+    ComposerScan* scan = (ComposerScan*)ctx;
+    ComposerPiece piece = {0};
+    if (span->is_pause) {
+        piece.is_pause = 1;
+        piece.pause_seconds = span->pause_seconds;
+    } else if (span_is_blank(scan->text + span->offset, span->length)) {
+        return 0;
+    } else {
+        piece.text = scan->text + span->offset;
+        piece.text_len = span->length;
+        piece.settings = *scan->settings;
+        scan->has_speech = 1;
+    }
+    return composer_plan_append(scan->pieces, scan->count, scan->capacity, piece) != TYPECAST_OK;
+}
+
+static TypecastErrorCode build_composer_plan(TypecastSpeechComposer* composer, ComposerPiece** out_pieces, size_t* out_count) {
+    ComposerPiece* pieces = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
     int has_speech = 0;
-    for (size_t i = 0; i < composer->count; i++) {
+    TypecastErrorCode err = TYPECAST_OK;
+    *out_pieces = NULL;
+    *out_count = 0;
+
+    for (size_t i = 0; i < composer->count && err == TYPECAST_OK; i++) {
         if (composer->parts[i].kind == COMPOSER_PART_PAUSE) {
-            cJSON* pause = cJSON_CreateObject();
-            cJSON_AddStringToObject(pause, "type", "pause");
-            cJSON_AddNumberToObject(pause, "duration_seconds", composer->parts[i].pause_seconds);
-            cJSON_AddItemToArray(segments, pause);
+            ComposerPiece pause = {0};
+            pause.is_pause = 1;
+            pause.pause_seconds = composer->parts[i].pause_seconds;
+            err = composer_plan_append(&pieces, &count, &capacity, pause);
             continue;
         }
         TypecastComposerSettings merged = merge_composer_settings(composer->defaults, composer->parts[i].settings);
-        if (is_blank_string(merged.voice_id)) {
-            cJSON_Delete(root);
+        if (tc_is_blank_string(merged.voice_id)) {
+            free(pieces);
             set_error(composer->client, TYPECAST_ERROR_INVALID_PARAM, "voice_id is required for composed speech");
-            return NULL;
+            return TYPECAST_ERROR_INVALID_PARAM;
         }
-        TypecastSpeechPart* parsed = NULL;
-        size_t parsed_count = 0;
-        TypecastErrorCode err = typecast_parse_pause_markup(composer->parts[i].text, &parsed, &parsed_count);
-        /* LCOV_EXCL_START - valid internal arguments can only fail on allocation. */
-        if (err != TYPECAST_OK) {
-            cJSON_Delete(root);
-            set_error(composer->client, err, "Failed to parse composed speech");
-            return NULL;
+        ComposerScan scan = {composer->parts[i].text, &merged, &pieces, &count, &capacity, 0};
+        if (tc_pause_markup_scan(composer->parts[i].text, composer->parts[i].text_len,
+                                 composer_plan_span, &scan) != 0) {
+            err = TYPECAST_ERROR_OUT_OF_MEMORY; /* LCOV_EXCL_LINE category=oom reason="realloc of the composition plan" */
         }
-        /* LCOV_EXCL_STOP */
-        for (size_t j = 0; j < parsed_count; j++) {
-            if (parsed[j].is_pause) {
-                cJSON* pause = cJSON_CreateObject();
-                cJSON_AddStringToObject(pause, "type", "pause");
-                cJSON_AddNumberToObject(pause, "duration_seconds", parsed[j].pause_seconds);
-                cJSON_AddItemToArray(segments, pause);
-                continue;
-            }
-            if (is_blank_string(parsed[j].text)) continue;
-            TypecastOutput output = composer_output_to_tts(merged.output);
-            output.audio_format = output_format;
-            TypecastTTSRequest request = {0};
-            request.text = parsed[j].text;
-            request.voice_id = merged.voice_id;
-            request.model = merged.use_model ? merged.model : TYPECAST_MODEL_SSFM_V30;
-            request.language = merged.language;
-            request.prompt = merged.prompt;
-            request.output = &output;
-            request.seed = merged.use_seed ? merged.seed : 0;
-            cJSON* speech = build_tts_request_json(&request);
-            cJSON_AddStringToObject(speech, "type", "tts");
-            cJSON_AddItemToArray(segments, speech);
-            has_speech = 1;
-        }
-        typecast_speech_parts_free(parsed, parsed_count);
+        has_speech |= scan.has_speech;
+    }
+    /* LCOV_EXCL_START */
+    /* category=oom reason="realloc of the composition plan" */
+    if (err != TYPECAST_OK) {
+        free(pieces);
+        set_error(composer->client, err, "Failed to allocate composition plan");
+        return err;
     }
+    /* LCOV_EXCL_STOP */
     if (!has_speech) {
-        cJSON_Delete(root);
+        free(pieces);
         set_error(composer->client, TYPECAST_ERROR_INVALID_PARAM, "At least one speech segment is required");
-        return NULL;
+        return TYPECAST_ERROR_INVALID_PARAM;
     }
-    TypecastTTSResponse* response = post_compose_json(composer->client, root, output_format);
-    cJSON_Delete(root);
+    *out_pieces = pieces;
+    *out_count = count;
+    return TYPECAST_OK;
+}
+
+/* `output` must outlive the request. The piece's text is not terminated,
+ * so the request's text is left for the caller. */
+static TypecastTTSRequest composer_piece_request(const ComposerPiece* piece, TypecastOutput* output) {
+    *output = composer_output_to_tts(piece->settings.output);
+    TypecastTTSRequest request = {0};
+    request.voice_id = piece->settings.voice_id;
+    request.model = piece->settings.use_model ? piece->settings.model : TYPECAST_MODEL_SSFM_V30;
+    request.language = piece->settings.language;
+    request.prompt = piece->settings.prompt;
+    request.output = output;
+    request.seed = piece->settings.use_seed ? piece->settings.seed : 0;
+    return request;
+}
+
+typedef struct {
+    const ComposerPiece* pieces;
+    size_t count;
+    TypecastAudioFormat format;
+} ComposeBody;
+
+static void emit_compose_request(TcJsonWriter* w, const void* ctx) {
+    const ComposeBody* body = (const ComposeBody*)ctx;
+    tc_json_begin_object(w);
+    tc_json_key(w, "segments");
+    tc_json_begin_array(w);
+    for (size_t i = 0; i < body->count; i++) {
+        tc_json_begin_object(w);
+        if (body->pieces[i].is_pause) {
+            tc_json_field_string(w, "type", "pause");
+            tc_json_field_number(w, "duration_seconds", body->pieces[i].pause_seconds);
+        } else {
+            TypecastOutput output;
+            TypecastTTSRequest request = composer_piece_request(&body->pieces[i], &output);
+            output.audio_format = body->format;
+            emit_tts_members_text(w, &request, body->pieces[i].text, body->pieces[i].text_len);
+            tc_json_field_string(w, "type", "tts");
+        }
+        tc_json_end_object(w);
+    }
+    tc_json_end_array(w);
+    tc_json_end_object(w);
+}
+
+TYPECAST_API TypecastTTSResponse* typecast_speech_composer_generate(
+    TypecastSpeechComposer* composer,
+    TypecastAudioFormat output_format
+) {
+    if (!composer) return NULL;
+    uint64_t started = tc_monotonic_us();
+    ComposerPiece* pieces = NULL;
+    size_t count = 0;
+    if (build_composer_plan(composer, &pieces, &count) != TYPECAST_OK) return NULL;
+
+    ComposeBody body = {pieces, count, output_format};
+    TypecastTTSResponse* response = post_compose_json(composer->client, emit_compose_request, &body,
+        output_format, started);
+    free(pieces);
     return response;
 }
 
-TYPECAST_API TypecastErrorCode typecast_generate_to_file(
-    TypecastClient* client,
-    const char* file_path,
-    const TypecastGenerateToFileRequest* request
+TypecastErrorCode tc_transfer_prepare_composer(
+    TypecastSpeechComposer* composer,
+    TypecastAudioFormat format,
+    TcTransfer* transfer
 ) {
-    if (!client || !file_path || !request) {
-        if (client) set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
-        return TYPECAST_ERROR_INVALID_PARAM;
-    }
-    if (is_blank_string(request->text) || is_blank_string(request->voice_id)) {
-        set_error(client, TYPECAST_ERROR_INVALID_PARAM, "text and voice_id are required");
-        return TYPECAST_ERROR_INVALID_PARAM;
-    }
+    uint64_t started = tc_monotonic_us();
+    ComposerPiece* pieces = NULL;
+    size_t count = 0;
+    TypecastErrorCode err = build_composer_plan(composer, &pieces, &count);
+    if (err != TYPECAST_OK) return err;
 
-    char temp_path[4096];
-    if (!preflight_output_path(file_path, temp_path, sizeof(temp_path))) {
-        set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Invalid or unwritable output file");
-        return TYPECAST_ERROR_INVALID_PARAM;
-    }
+    ComposeBody body = {pieces, count, format};
+    err = transfer_prepare_compose(composer->client, emit_compose_request, &body, format, started,
+        transfer, tc_client_error(composer->client));
+    free(pieces);
+    return err;
+}
 
-    TypecastTTSRequest tts_request = {0};
-    tts_request.text = request->text;
-    tts_request.voice_id = request->voice_id;
-    tts_request.model = request->use_model ? request->model : TYPECAST_MODEL_SSFM_V30;
-    tts_request.language = request->language;
-    tts_request.prompt = request->prompt;
-    tts_request.output = request->output;
-    tts_request.seed = request->seed;
+TypecastClient* tc_composer_client(const TypecastSpeechComposer* composer) {
+    return composer->client;
+}
 
-    TypecastOutput inferred_output = {0};
-    if (!tts_request.output && infer_audio_format_from_path(file_path, &inferred_output.audio_format)) {
-        inferred_output.volume = 100;
-        inferred_output.audio_pitch = 0;
-        inferred_output.audio_tempo = 1.0f;
-        tts_request.output = &inferred_output;
-    }
+typedef struct {
+    size_t in_flight;
+    TypecastAsyncJob* failed;
+} ParallelProgress;
 
-    TypecastTTSResponse* response = typecast_text_to_speech(client, &tts_request);
-    if (!response) {
-        const TypecastError* error = typecast_client_get_error(client);
-        return error ? error->code : TYPECAST_ERROR_NETWORK;
+/* Segment cache key: the segment's request members, i.e. its text and
+ * merged settings, as they would be sent */
+static void emit_segment_key(TcJsonWriter* w, const void* ctx) {
+    const ComposerPiece* piece = (const ComposerPiece*)ctx;
+    TypecastOutput output;
+    TypecastTTSRequest request = composer_piece_request(piece, &output);
+    tc_json_begin_object(w);
+    emit_tts_members_text(w, &request, piece->text, piece->text_len);
+    tc_json_end_object(w);
+}
+
+typedef struct {
+    char* key;                           /* NULL: not cached */
+    size_t key_len;
+    TcCachedResult hit;                  /* hit.data set: no request needed */
+} SegmentSlot;
+
+/* Look every speech piece up in the segment cache */
+static SegmentSlot* lookup_segments(TcResultCache* cache, const ComposerPiece* pieces, size_t count) {
+    SegmentSlot* slots = (SegmentSlot*)calloc(count, sizeof(SegmentSlot));
+    if (!slots) return NULL; /* LCOV_EXCL_LINE category=oom reason="segment slot allocation" */
+    for (size_t i = 0; i < count; i++) {
+        if (pieces[i].is_pause) continue;
+        slots[i].key = tc_json_write(emit_segment_key, &pieces[i], &slots[i].key_len);
+        if (slots[i].key) tc_result_cache_lookup_key(cache, slots[i].key, slots[i].key_len, NULL, &slots[i].hit);
     }
+    return slots;
+}
+
+static void parallel_job_done(TypecastAsyncJob* job, void* user_data) {
+    ParallelProgress* progress = (ParallelProgress*)user_data;
+    progress->in_flight--;
+    if (!progress->failed && typecast_async_job_result(job) != TYPECAST_OK) progress->failed = job;
+}
 
-    FILE* file = fopen(temp_path, "wb");
+TYPECAST_API TypecastTTSResponse* typecast_speech_composer_generate_parallel(
+    TypecastSpeechComposer* composer,
+    size_t max_concurrency
+) {
+    if (!composer) return NULL;
+    TypecastClient* client = composer->client;
+    ComposerPiece* pieces = NULL;
+    size_t count = 0;
+    if (build_composer_plan(composer, &pieces, &count) != TYPECAST_OK) return NULL;
+    if (max_concurrency == 0) max_concurrency = 4;
+
+    /* Requests take terminated text; each piece is copied into one buffer
+     * in turn, as a submitted job has already serialized its body */
+    size_t longest = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (pieces[i].text_len > longest) longest = pieces[i].text_len;
+    }
+    char* text = (char*)malloc(longest + 1);
+    TypecastAsyncJob** jobs = (TypecastAsyncJob**)calloc(count, sizeof(TypecastAsyncJob*));
+    TypecastTTSResponse** audio = (TypecastTTSResponse**)calloc(count, sizeof(TypecastTTSResponse*));
+    TcWavPiece* stitch = (TcWavPiece*)calloc(count, sizeof(TcWavPiece));
+    SegmentSlot* slots = composer->segment_cache ? lookup_segments(composer->segment_cache, pieces, count) : NULL;
     /* LCOV_EXCL_START */
-    /* category=unreachable reason="preflight already verified temp output writability" */
-    if (!file) {
-        typecast_tts_response_free(response);
-        set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Failed to open output file");
-        return TYPECAST_ERROR_INVALID_PARAM;
+    /* category=oom reason="per-segment bookkeeping arrays" */
+    if (!text || !jobs || !audio || !stitch || (composer->segment_cache && !slots)) {
+        free(text);
+        free(jobs);
+        free(audio);
+        free(stitch);
+        free(slots);
+        free(pieces);
+        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate segment jobs");
+        return NULL;
     }
     /* LCOV_EXCL_STOP */
 
-    size_t written = fwrite(response->audio_data, 1, response->audio_size, file);
-    int close_result = fclose(file);
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="disk-full/write-failure path; cannot be simulated reliably in portable tests" */
-    if (written != response->audio_size || close_result != 0) {
-        remove(temp_path);
-        typecast_tts_response_free(response);
-        set_error(client, TYPECAST_ERROR_NETWORK, "Failed to write output file");
-        return TYPECAST_ERROR_NETWORK;
+    /* Keep at most max_concurrency segments in flight; the async engine
+     * reports completions through parallel_job_done */
+    ParallelProgress progress = {0, NULL};
+    TypecastErrorCode err = TYPECAST_OK;
+    size_t next = 0;
+    while (err == TYPECAST_OK && !progress.failed && (next < count || progress.in_flight > 0)) {
+        while (next < count && progress.in_flight < max_concurrency) {
+            size_t index = next++;
+            if (pieces[index].is_pause || (slots && slots[index].hit.data)) continue;
+            TypecastOutput output;
+            TypecastTTSRequest request = composer_piece_request(&pieces[index], &output);
+            memcpy(text, pieces[index].text, pieces[index].text_len);
+            text[pieces[index].text_len] = '\0';
+            request.text = text;
+            jobs[index] = typecast_async_text_to_speech(client, &request, parallel_job_done, &progress);
+            /* LCOV_EXCL_START */
+            /* category=oom reason="async submission only fails on allocation for a validated request" */
+            if (!jobs[index]) {
+                err = typecast_client_get_error(client)->code;
+                break;
+            }
+            /* LCOV_EXCL_STOP */
+            progress.in_flight++;
+        }
+        if (err == TYPECAST_OK && progress.in_flight > 0) {
+            err = typecast_async_poll(client, 100, NULL);
+        }
     }
-    /* LCOV_EXCL_STOP */
 
-    typecast_tts_response_free(response);
+    TypecastTTSResponse* response = NULL;
+    if (progress.failed) {
+        const TypecastError* job_error = typecast_async_job_error(progress.failed);
+        set_error(client, job_error->code, job_error->message);
+    } else if (err == TYPECAST_OK) {
+        for (size_t i = 0; i < count; i++) {
+            if (pieces[i].is_pause) {
+                stitch[i].pause_seconds = pieces[i].pause_seconds;
+                continue;
+            }
+            if (slots && slots[i].hit.data) {
+                stitch[i].audio = slots[i].hit.data;
+                stitch[i].audio_size = slots[i].hit.size;
+                continue;
+            }
+            audio[i] = typecast_async_job_take_tts_response(jobs[i]);
+            /* An empty body still has to fail WAV parsing, not become silence */
+            stitch[i].audio = audio[i]->audio_data ? audio[i]->audio_data : (const uint8_t*)"";
+            stitch[i].audio_size = audio[i]->audio_size;
+        }
+        clear_error(client);
+        response = tc_wav_stitch(stitch, count, &client->options.allocator, tc_client_error(client));
+    }
 
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="rename failure after same-directory temp write is not reliably portable to simulate" */
-    if (rename(temp_path, file_path) != 0) {
-        remove(file_path);
-        if (rename(temp_path, file_path) != 0) {
-            remove(temp_path);
-            set_error(client, TYPECAST_ERROR_NETWORK, "Failed to move output file into place");
-            return TYPECAST_ERROR_NETWORK;
+    /* Only audio that stitched is worth keeping */
+    for (size_t i = 0; response && slots && i < count; i++) {
+        if (audio[i] && slots[i].key) {
+            tc_result_cache_store_key(composer->segment_cache, slots[i].key, slots[i].key_len,
+                audio[i]->audio_data, audio[i]->audio_size, audio[i]->duration, audio[i]->format);
         }
     }
-    /* LCOV_EXCL_STOP */
 
-    clear_error(client);
-    return TYPECAST_OK;
+    /* Freeing a job that is still running cancels it */
+    for (size_t i = 0; i < count; i++) {
+        typecast_async_job_free(jobs[i]);
+        typecast_tts_response_free(audio[i]);
+        if (slots) {
+            free(slots[i].key);
+            free(slots[i].hit.data);
+        }
+    }
+    free(slots);
+    free(text);
+    free(jobs);
+    free(audio);
+    free(stitch);
+    free(pieces);
+    return response;
 }
 
 /* ============================================
  * Text-to-Speech Streaming Implementation
  * ============================================ */
 
-typedef struct {
-    typecast_stream_callback_t cb;
-    void* user_data;
-    int aborted;
-} StreamCallbackCtx;
+/* Write the streaming JSON body. Mirrors emit_tts_request but the
+ * output object intentionally omits volume (rejected by
+ * /v1/text-to-speech/stream). */
+static void emit_tts_stream_request(TcJsonWriter* w, const void* ctx) {
+    const TypecastTTSRequestStream* request = (const TypecastTTSRequestStream*)ctx;
+    tc_json_begin_object(w);
+    emit_tts_head(w, request->text, request->text ? strlen(request->text) : 0, request->voice_id,
+        request->model, request->language, request->prompt);
 
-static size_t stream_write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
-    size_t realsize = size * nmemb;
-    StreamCallbackCtx* ctx = (StreamCallbackCtx*)userp;
+    if (request->output) {
+        tc_json_key(w, "output");
+        tc_json_begin_object(w);
+        if (request->output->use_target_lufs) {
+            tc_json_field_number(w, "target_lufs", request->output->target_lufs);
+        }
+        if (request->output->audio_pitch != 0) {
+            tc_json_field_number(w, "audio_pitch", request->output->audio_pitch);
+        }
+        if (request->output->audio_tempo != 0.0f && request->output->audio_tempo != 1.0f) {
+            tc_json_field_number(w, "audio_tempo", request->output->audio_tempo);
+        }
+        tc_json_field_string(w, "audio_format", typecast_audio_format_to_string(request->output->audio_format));
+        tc_json_end_object(w);
+    }
 
-    if (ctx->cb((const uint8_t*)contents, realsize, ctx->user_data) != 0) {
-        ctx->aborted = 1;
-        /* Returning a value different from realsize signals an error to
-         * libcurl, which will abort the transfer with CURLE_WRITE_ERROR. */
-        return 0;
+    if (request->seed != 0) {
+        tc_json_field_number(w, "seed", request->seed);
     }
-    return realsize;
+    tc_json_end_object(w);
 }
 
-/* Build the streaming JSON body. Mirrors build_tts_request_json but the
- * output object intentionally omits volume (rejected by
- * /v1/text-to-speech/stream). */
-static cJSON* build_tts_stream_request_json(const TypecastTTSRequestStream* request) {
-    cJSON* root = cJSON_CreateObject();
-    if (!root) return NULL;
-
-    cJSON_AddStringToObject(root, "text", request->text);
-    cJSON_AddStringToObject(root, "voice_id", request->voice_id);
-    cJSON_AddStringToObject(root, "model", typecast_model_to_string(request->model));
-
-    if (request->language) {
-        cJSON_AddStringToObject(root, "language", request->language);
-    }
-
-    if (request->prompt) {
-        cJSON* prompt = cJSON_CreateObject();
-        if (prompt) {
-            switch (request->prompt->emotion_type) {
-                case TYPECAST_EMOTION_TYPE_SMART:
-                    cJSON_AddStringToObject(prompt, "emotion_type", "smart");
-                    if (request->prompt->previous_text) {
-                        cJSON_AddStringToObject(prompt, "previous_text", request->prompt->previous_text);
-                    }
-                    if (request->prompt->next_text) {
-                        cJSON_AddStringToObject(prompt, "next_text", request->prompt->next_text);
-                    }
-                    break;
-
-                case TYPECAST_EMOTION_TYPE_PRESET:
-                    cJSON_AddStringToObject(prompt, "emotion_type", "preset");
-                    cJSON_AddStringToObject(prompt, "emotion_preset",
-                        typecast_emotion_to_string(request->prompt->emotion_preset));
-                    cJSON_AddNumberToObject(prompt, "emotion_intensity",
-                        request->prompt->emotion_intensity);
-                    break;
-
-                case TYPECAST_EMOTION_TYPE_NONE:
-                default:
-                    cJSON_AddStringToObject(prompt, "emotion_preset",
-                        typecast_emotion_to_string(request->prompt->emotion_preset));
-                    cJSON_AddNumberToObject(prompt, "emotion_intensity",
-                        request->prompt->emotion_intensity);
-                    break;
-            }
-            cJSON_AddItemToObject(root, "prompt", prompt);
-        }
+TypecastErrorCode tc_transfer_prepare_stream(
+    TypecastClient* client,
+    const TypecastTTSRequestStream* request,
+    typecast_stream_callback_t on_chunk,
+    void* user_data,
+    TcTransfer* transfer,
+    TypecastError* error
+) {
+    uint64_t started = tc_monotonic_us();
+    TypecastErrorCode err = transfer_prepare_json(client, transfer, TC_REQUEST_STREAM,
+        "/v1/text-to-speech/stream", emit_tts_stream_request, request, started, error);
+    if (request->output) {
+        transfer->format = request->output->audio_format;
     }
+    transfer->stream.cb = on_chunk;
+    transfer->stream.user_data = user_data;
+    transfer->stream.aborted = 0;
+    return err;
+}
 
-    if (request->output) {
-        cJSON* output = cJSON_CreateObject();
-        if (output) {
-            if (request->output->use_target_lufs) {
-                cJSON_AddNumberToObject(output, "target_lufs", request->output->target_lufs);
-            }
-            if (request->output->audio_pitch != 0) {
-                cJSON_AddNumberToObject(output, "audio_pitch", request->output->audio_pitch);
-            }
-            if (request->output->audio_tempo != 0.0f && request->output->audio_tempo != 1.0f) {
-                cJSON_AddNumberToObject(output, "audio_tempo", request->output->audio_tempo);
-            }
-            cJSON_AddStringToObject(output, "audio_format",
-                typecast_audio_format_to_string(request->output->audio_format));
-            cJSON_AddItemToObject(root, "output", output);
+TypecastErrorCode tc_transfer_finish_stream(
+    TcTransfer* transfer,
+    CURL* curl,
+    CURLcode result,
+    TypecastError* error
+) {
+    transfer->trace.first_audio_at = transfer->stream.first_chunk_at;
+    const char* message = NULL;
+    if (result != CURLE_OK) {
+        if (transfer->buffer && tc_stream_buffer_closed(transfer->buffer)) {
+            tc_error_set(error, TYPECAST_ERROR_CANCELLED, "Stream buffer closed by the reader");
+            return TYPECAST_ERROR_CANCELLED;
         }
+        if (transfer->stream.aborted) {
+            tc_error_set(error, TYPECAST_ERROR_NETWORK, "Stream aborted by callback");
+            return TYPECAST_ERROR_NETWORK;
+        }
+        TypecastErrorCode framed = transfer->framer ? tc_framer_error(transfer->framer, &message) : TYPECAST_OK;
+        if (framed != TYPECAST_OK) {
+            tc_error_set(error, framed, message);
+            return framed;
+        }
+        return tc_call_error(&transfer->call, result, error);
     }
 
-    if (request->seed != 0) {
-        cJSON_AddNumberToObject(root, "seed", request->seed);
+    /* Check HTTP status. On non-200 the body went to the user callback,
+     * which is not ideal but matches the streaming model: the SDK has
+     * already started forwarding chunks before the status is known.
+     * For our purposes the body has been consumed; we still need to
+     * surface the proper error code. */
+    long http_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+    if (http_code != 200) {
+        TypecastErrorCode err_code = http_status_to_error(http_code);
+        /* A framed or buffered stream kept the body back for the detail */
+        char* err_msg = transfer->framer || transfer->buffer ? parse_error_detail(&transfer->response) : NULL;
+        tc_error_set(error, err_code, err_msg ? err_msg : typecast_error_message(err_code));
+        free(err_msg);
+        return err_code;
     }
 
-    return root;
+    if (transfer->framer && tc_framer_finish(transfer->framer) != 0) {
+        TypecastErrorCode err_code = tc_framer_error(transfer->framer, &message);
+        tc_error_set(error, err_code, message);
+        return err_code;
+    }
+    return TYPECAST_OK;
 }
 
-TYPECAST_API TypecastErrorCode typecast_text_to_speech_stream(
+/* Blocking stream; `framed` routes the body through a framer */
+static TypecastErrorCode text_to_speech_stream(
     TypecastClient* client,
     const TypecastTTSRequestStream* request,
+    int framed,
+    const TypecastStreamFraming* framing,
     typecast_stream_callback_t on_chunk,
     void* user_data
 ) {
@@ -1431,100 +1754,233 @@ TYPECAST_API TypecastErrorCode typecast_text_to_speech_stream(
 
     clear_error(client);
 
-    /* Build URL */
-    char url[512];
-    snprintf(url, sizeof(url), "%s/v1/text-to-speech/stream", client->host);
-
-    /* Build JSON body */
-    cJSON* json = build_tts_stream_request_json(request);
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="cJSON OOM; cannot be triggered in unit tests" */
-    if (!json) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to build JSON");
-        return TYPECAST_ERROR_OUT_OF_MEMORY;
+    TcTransfer transfer;
+    TypecastErrorCode err = tc_transfer_prepare_stream(client, request, on_chunk, user_data,
+        &transfer, tc_client_error(client));
+    if (err == TYPECAST_OK && framed) {
+        transfer.framer = tc_framer_new(framing, on_chunk, user_data);
+        /* LCOV_EXCL_START */
+        /* category=oom reason="calloc failure" */
+        if (!transfer.framer) {
+            tc_error_set(tc_client_error(client), TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate stream framer");
+            err = TYPECAST_ERROR_OUT_OF_MEMORY;
+        }
+        /* LCOV_EXCL_STOP */
+    }
+    if (err != TYPECAST_OK) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="request serialization only fails on OOM" */
+        tc_transfer_cleanup(&transfer);
+        return err;
+        /* LCOV_EXCL_STOP */
     }
-    /* LCOV_EXCL_STOP */
 
-    char* json_str = cJSON_PrintUnformatted(json);
-    cJSON_Delete(json);
+    CURLcode res = CURLE_OK;
+    CURL* curl = tc_transfer_perform(client, &transfer, &res);
+    err = curl ? tc_transfer_finish_stream(&transfer, curl, res, tc_client_error(client)) : TYPECAST_ERROR_CURL_INIT;
+    tc_client_release(client, curl);
+    tc_trace_end(client, &transfer.trace, err);
+    tc_transfer_cleanup(&transfer);
+    return err;
+}
 
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="cJSON_PrintUnformatted OOM" */
-    if (!json_str) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to serialize JSON");
-        return TYPECAST_ERROR_OUT_OF_MEMORY;
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_stream(
+    TypecastClient* client,
+    const TypecastTTSRequestStream* request,
+    typecast_stream_callback_t on_chunk,
+    void* user_data
+) {
+    return text_to_speech_stream(client, request, 0, NULL, on_chunk, user_data);
+}
+
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_stream_framed(
+    TypecastClient* client,
+    const TypecastTTSRequestStream* request,
+    const TypecastStreamFraming* framing,
+    typecast_stream_callback_t on_chunk,
+    void* user_data
+) {
+    return text_to_speech_stream(client, request, 1, framing, on_chunk, user_data);
+}
+
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_stream_buffered(
+    TypecastClient* client,
+    const TypecastTTSRequestStream* request,
+    TypecastStreamBuffer* buffer
+) {
+    if (!client || !request || !buffer) {
+        if (client) set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    if (!tc_stream_buffer_claim(buffer)) {
+        set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Stream buffer already carried a stream");
+        return TYPECAST_ERROR_INVALID_PARAM;
     }
-    /* LCOV_EXCL_STOP */
 
-    /* Setup CURL */
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
+    TypecastErrorCode err = TYPECAST_ERROR_INVALID_PARAM;
+    if (!request->text || !request->voice_id) {
+        set_error(client, TYPECAST_ERROR_INVALID_PARAM, "text and voice_id are required");
+        tc_stream_buffer_finish(buffer);
+        return err;
+    }
+    clear_error(client);
 
-    struct curl_slist* headers = NULL;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = append_common_headers(headers, client, 60L);
+    TcTransfer transfer;
+    err = tc_transfer_prepare_stream(client, request, NULL, NULL, &transfer, tc_client_error(client));
+    transfer.buffer = buffer;
+    if (err == TYPECAST_OK) {
+        CURLcode res = CURLE_OK;
+        CURL* curl = tc_transfer_perform(client, &transfer, &res);
+        err = curl ? tc_transfer_finish_stream(&transfer, curl, res, tc_client_error(client)) : TYPECAST_ERROR_CURL_INIT;
+        tc_client_release(client, curl);
+        tc_trace_end(client, &transfer.trace, err);
+    }
+    tc_transfer_cleanup(&transfer);
+    tc_stream_buffer_finish(buffer);
+    return err;
+}
 
-    StreamCallbackCtx ctx;
-    ctx.cb = on_chunk;
-    ctx.user_data = user_data;
-    ctx.aborted = 0;
+/* ============================================
+ * Voices API Implementation
+ * ============================================ */
 
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_str);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)strlen(json_str));
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, stream_write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ctx);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 60L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-
-    /* Perform request */
-    CURLcode res = curl_easy_perform(curl);
+/* Conditional GET state: the ETag to revalidate and the one received */
+typedef struct {
+    const char* if_none_match;
+    char* etag;
+    int not_modified;
+} TcConditionalGet;
 
-    cJSON_free(json_str);
-    curl_slist_free_all(headers);
+static size_t etag_header_callback(char* buffer, size_t size, size_t nitems, void* userp) {
+    size_t realsize = size * nitems;
+    TcConditionalGet* cond = (TcConditionalGet*)userp;
+    if (realsize > 5 && strncasecmp(buffer, "ETag:", 5) == 0) {
+        const char* value = buffer + 5;
+        const char* end = buffer + realsize;
+        while (value < end && (*value == ' ' || *value == '\t')) value++;
+        while (end > value && (end[-1] == '\r' || end[-1] == '\n' || end[-1] == ' ')) end--;
+        free(cond->etag);
+        cond->etag = NULL;
+        if (end > value) {
+            cond->etag = (char*)malloc((size_t)(end - value) + 1);
+            if (cond->etag) {
+                memcpy(cond->etag, value, (size_t)(end - value));
+                cond->etag[end - value] = '\0';
+            }
+        }
+    }
+    return realsize;
+}
 
-    if (res != CURLE_OK) {
-        if (ctx.aborted) {
-            set_error(client, TYPECAST_ERROR_NETWORK, "Stream aborted by callback");
-        } else {
-            set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(res));
+/* GET `url` with the query header set and collect the body into `out`.
+ * Transport and non-200 failures set the error and leave `out` empty.
+ * With `cond`, the response ETag is captured and a 304 answer to
+ * cond->if_none_match succeeds with cond->not_modified set. */
+static TypecastErrorCode perform_get_conditional(TypecastClient* client, const char* url,
+    ResponseBuffer* out, TcConditionalGet* cond, TcRequestTrace* trace) {
+    CURL* curl = acquire_curl(client);
+    if (!curl) return TYPECAST_ERROR_CURL_INIT; /* LCOV_EXCL_LINE category=oom reason="see acquire_curl" */
+
+    struct curl_slist* headers = client->headers[TC_HEADERS_QUERY];
+    struct curl_slist* conditional_headers = NULL;
+    if (cond && cond->if_none_match) {
+        for (struct curl_slist* h = headers; h; h = h->next) {
+            conditional_headers = curl_slist_append(conditional_headers, h->data);
         }
-        return TYPECAST_ERROR_NETWORK;
+        char line[512];
+        snprintf(line, sizeof(line), "If-None-Match: %s", cond->if_none_match);
+        conditional_headers = curl_slist_append(conditional_headers, line);
+        if (conditional_headers) headers = conditional_headers;
     }
 
-    /* Check HTTP status. On non-200 the body went to the user callback,
-     * which is not ideal but matches the streaming model: the SDK has
-     * already started forwarding chunks before the status is known.
-     * For our purposes the body has been consumed; we still need to
-     * surface the proper error code. */
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, tc_response_write);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, out);
+    if (!client->options.disable_compression) curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    TcCallSettings call;
+    tc_call_settings(client, TC_TIMEOUT_QUERY, &call);
+    tc_call_apply(curl, &call);
+    if (cond) {
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, etag_header_callback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, cond);
+    }
+
+    tc_trace_prepared(trace);
+    CURLcode res = curl_easy_perform(curl);
+    tc_trace_decoded(trace, out->size);
+    tc_trace_attempt(trace, curl);
     long http_code = 0;
     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    tc_client_release(client, curl);
+    curl_slist_free_all(conditional_headers);
 
-    if (http_code != 200) {
-        TypecastErrorCode err_code = http_status_to_error(http_code);
-        set_error(client, err_code, typecast_error_message(err_code));
-        return err_code;
+    TypecastErrorCode err = TYPECAST_OK;
+    if (res != CURLE_OK) {
+        err = tc_call_error(&call, res, tc_client_error(client));
+    } else if (http_code == 304 && cond && cond->if_none_match) {
+        cond->not_modified = 1;
+    } else if (http_code != 200) {
+        err = http_status_to_error(http_code);
+        set_error(client, err, typecast_error_message(err));
     }
+    if (err != TYPECAST_OK || (cond && cond->not_modified)) {
+        free(out->data);
+        memset(out, 0, sizeof(*out));
+    }
+    return err;
+}
 
-    return TYPECAST_OK;
+static TypecastErrorCode perform_get(TypecastClient* client, const char* url, ResponseBuffer* out,
+    TcRequestTrace* trace) {
+    return perform_get_conditional(client, url, out, NULL, trace);
 }
 
-/* ============================================
- * Voices API Implementation
- * ============================================ */
+/* GET a voices endpoint (`path` is appended to the host) through the
+ * client's voice cache. When `cached` is non-NULL and the cache holds a
+ * parsed copy, *cached receives it and `out` stays empty; otherwise the
+ * body lands in `out` and the caller parses it as usual. */
+static TypecastErrorCode voices_get(TypecastClient* client, const char* path,
+    ResponseBuffer* out, TypecastVoicesResponse** cached, TcRequestTrace* trace) {
+    char url[1280];
+    snprintf(url, sizeof(url), "%s%s", client->host, path);
+    TcVoiceCache* cache = client->voice_cache;
+    if (!cache) return perform_get(client, url, out, trace);
 
-TYPECAST_API TypecastVoicesResponse* typecast_get_voices(
+    TcConditionalGet cond = {0};
+    char* etag = NULL;
+    TcVoiceCacheResult hit = tc_voice_cache_lookup(cache, path, out, cached, &etag);
+    if (hit == TC_VOICE_CACHE_HIT) return TYPECAST_OK;
+    cond.if_none_match = etag;
+
+    TypecastErrorCode err = perform_get_conditional(client, url, out, &cond, trace);
+    if (err == TYPECAST_OK && cond.not_modified) {
+        if (tc_voice_cache_revalidated(cache, path, out, cached) != TC_VOICE_CACHE_HIT) {
+            /* LCOV_EXCL_START */
+            /* category=unreachable reason="needs another thread to clear the cache between the 304 and the lookup" */
+            err = perform_get(client, url, out, trace);
+            /* LCOV_EXCL_STOP */
+        }
+    } else if (err == TYPECAST_OK) {
+        tc_voice_cache_store(cache, path, cond.etag, out);
+    }
+    free(etag);
+    free(cond.etag);
+    return err;
+}
+
+static TypecastVoicesResponse* get_voices_traced(
     TypecastClient* client,
-    const TypecastVoicesFilter* filter
+    const TypecastVoicesFilter* filter,
+    TcRequestTrace* trace
 ) {
     if (!client) return NULL;
     
     clear_error(client);
     
-    /* Build URL with query parameters */
+    /* Build path with query parameters */
     char url[1024];
-    snprintf(url, sizeof(url), "%s/v2/voices", client->host);
+    snprintf(url, sizeof(url), "/v2/voices");
     
     /* Add filter parameters */
     int has_params = 0;
@@ -1555,43 +2011,10 @@ TYPECAST_API TypecastVoicesResponse* typecast_get_voices(
         }
     }
     
-    /* Setup response buffer */
     ResponseBuffer response_buf = {0};
-    
-    /* Setup CURL */
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
-    
-    struct curl_slist* headers = NULL;
-    headers = append_common_headers(headers, client, 30L);
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_buf);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    
-    /* Perform request */
-    CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
-    
-    if (res != CURLE_OK) {
-        set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(res));
-        if (response_buf.data) free(response_buf.data);
-        return NULL;
-    }
-    
-    /* Check HTTP status */
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    
-    if (http_code != 200) {
-        TypecastErrorCode err_code = http_status_to_error(http_code);
-        set_error(client, err_code, typecast_error_message(err_code));
-        if (response_buf.data) free(response_buf.data);
-        return NULL;
-    }
+    TypecastVoicesResponse* cached = NULL;
+    if (voices_get(client, url, &response_buf, &cached, trace) != TYPECAST_OK) return NULL;
+    if (cached) return cached;
     
     /* Parse JSON response */
     cJSON* json = cJSON_Parse((const char*)response_buf.data);
@@ -1608,46 +2031,36 @@ TYPECAST_API TypecastVoicesResponse* typecast_get_voices(
         return NULL;
     }
     
-    /* Create response */
-    TypecastVoicesResponse* resp = (TypecastVoicesResponse*)calloc(1, sizeof(TypecastVoicesResponse));
+    TypecastVoicesResponse* resp = tc_voices_from_json(json);
     /* LCOV_EXCL_START */
-    /* category=unreachable reason="calloc OOM; cannot be triggered deterministically" */
+    /* category=oom reason="voice arena allocation" */
     if (!resp) {
         set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response");
         cJSON_Delete(json);
         return NULL;
     }
-    /* LCOV_EXCL_STOP */
-
-    resp->count = cJSON_GetArraySize(json);
-    resp->voices = (TypecastVoice*)calloc(resp->count, sizeof(TypecastVoice));
-
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="calloc OOM; cannot be triggered deterministically" */
-    if (!resp->voices) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate voices array");
-        free(resp);
-        cJSON_Delete(json);
-        return NULL;
-    }
-    /* LCOV_EXCL_STOP */
-    
-    for (size_t i = 0; i < resp->count; i++) {
-        cJSON* voice_json = cJSON_GetArrayItem(json, (int)i);
-        TypecastVoice* parsed = parse_voice_json(voice_json);
-        if (parsed) {
-            memcpy(&resp->voices[i], parsed, sizeof(TypecastVoice));
-            free(parsed);
-        }
-    }
-    
+    /* LCOV_EXCL_STOP */
+
     cJSON_Delete(json);
+    if (client->voice_cache) tc_voice_cache_attach(client->voice_cache, url, resp);
     return resp;
 }
 
-TYPECAST_API TypecastVoice* typecast_get_voice(
+TYPECAST_API TypecastVoicesResponse* typecast_get_voices(
     TypecastClient* client,
-    const char* voice_id
+    const TypecastVoicesFilter* filter
+) {
+    TcRequestTrace trace;
+    tc_trace_begin(&trace, TYPECAST_REQUEST_VOICES, tc_monotonic_us());
+    TypecastVoicesResponse* result = get_voices_traced(client, filter, &trace);
+    tc_trace_end(client, &trace, call_outcome(client, result));
+    return result;
+}
+
+static TypecastVoice* get_voice_traced(
+    TypecastClient* client,
+    const char* voice_id,
+    TcRequestTrace* trace
 ) {
     if (!client || !voice_id) {
         if (client) set_error(client, TYPECAST_ERROR_INVALID_PARAM, "voice_id is required");
@@ -1656,46 +2069,27 @@ TYPECAST_API TypecastVoice* typecast_get_voice(
     
     clear_error(client);
     
-    /* Build URL */
+    /* A cached voice list may already hold it */
+    if (client->voice_cache) {
+        TypecastVoice* known = tc_voice_cache_find_voice(client->voice_cache, voice_id);
+        if (known) return known;
+    }
+
+    /* Build path */
     char url[512];
-    snprintf(url, sizeof(url), "%s/v2/voices/%s", client->host, voice_id);
+    snprintf(url, sizeof(url), "/v2/voices/%s", voice_id);
     
-    /* Setup response buffer */
     ResponseBuffer response_buf = {0};
-    
-    /* Setup CURL */
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
-    
-    struct curl_slist* headers = NULL;
-    headers = append_common_headers(headers, client, 30L);
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_buf);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    
-    /* Perform request */
-    CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
-    
-    if (res != CURLE_OK) {
-        set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(res));
-        if (response_buf.data) free(response_buf.data);
-        return NULL;
-    }
-    
-    /* Check HTTP status */
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    
-    if (http_code != 200) {
-        TypecastErrorCode err_code = http_status_to_error(http_code);
-        set_error(client, err_code, typecast_error_message(err_code));
-        if (response_buf.data) free(response_buf.data);
-        return NULL;
+    TypecastVoicesResponse* cached = NULL;
+    if (voices_get(client, url, &response_buf, &cached, trace) != TYPECAST_OK) return NULL;
+    if (cached) {
+        /* Single voices are cached as one-element lists */
+        TypecastVoice* voice = tc_voice_copy(&cached->voices[0]);
+        if (!voice) {
+            set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate voice"); /* LCOV_EXCL_LINE category=oom reason="voice allocation" */
+        }
+        typecast_voices_response_free(cached);
+        return voice;
     }
     
     /* Parse JSON response */
@@ -1707,22 +2101,37 @@ TYPECAST_API TypecastVoice* typecast_get_voice(
         return NULL;
     }
     
-    TypecastVoice* voice = parse_voice_json(json);
+    TypecastVoice* voice = tc_voice_from_json(json);
     cJSON_Delete(json);
     
     if (!voice) {
         set_error(client, TYPECAST_ERROR_JSON_PARSE, "Failed to parse voice");
+    } else if (client->voice_cache) {
+        TypecastVoicesResponse single = {voice, 1};
+        tc_voice_cache_attach(client->voice_cache, url, &single);
     }
     
     return voice;
 }
 
-TYPECAST_API TypecastRecommendedVoicesResponse* typecast_recommend_voices(
+TYPECAST_API TypecastVoice* typecast_get_voice(
+    TypecastClient* client,
+    const char* voice_id
+) {
+    TcRequestTrace trace;
+    tc_trace_begin(&trace, TYPECAST_REQUEST_VOICES, tc_monotonic_us());
+    TypecastVoice* result = get_voice_traced(client, voice_id, &trace);
+    tc_trace_end(client, &trace, call_outcome(client, result));
+    return result;
+}
+
+static TypecastRecommendedVoicesResponse* recommend_voices_traced(
     TypecastClient* client,
     const char* query,
-    int count
+    int count,
+    TcRequestTrace* trace
 ) {
-    if (!client || is_blank_string(query)) {
+    if (!client || tc_is_blank_string(query)) {
         if (client) set_error(client, TYPECAST_ERROR_INVALID_PARAM, "query is required");
         return NULL;
     }
@@ -1735,10 +2144,8 @@ TYPECAST_API TypecastRecommendedVoicesResponse* typecast_recommend_voices(
 
     clear_error(client);
 
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
-
-    char* encoded_query = curl_easy_escape(curl, query, 0);
+    /* The handle argument of curl_easy_escape is unused by libcurl */
+    char* encoded_query = curl_easy_escape(NULL, query, 0);
     /* LCOV_EXCL_START */
     /* category=unreachable reason="curl_easy_escape OOM; cannot be simulated without a libcurl malloc shim" */
     if (!encoded_query) {
@@ -1751,8 +2158,7 @@ TYPECAST_API TypecastRecommendedVoicesResponse* typecast_recommend_voices(
     int url_len = snprintf(
         url,
         sizeof(url),
-        "%s/v1/voices/recommendations?query=%s&count=%d",
-        client->host,
+        "/v1/voices/recommendations?query=%s&count=%d",
         encoded_query,
         resolved_count
     );
@@ -1764,35 +2170,7 @@ TYPECAST_API TypecastRecommendedVoicesResponse* typecast_recommend_voices(
     curl_free(encoded_query);
 
     ResponseBuffer response_buf = {0};
-
-    struct curl_slist* headers = NULL;
-    headers = append_common_headers(headers, client, 30L);
-
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_buf);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
-
-    if (res != CURLE_OK) {
-        set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(res));
-        if (response_buf.data) free(response_buf.data);
-        return NULL;
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code != 200) {
-        TypecastErrorCode err_code = http_status_to_error(http_code);
-        set_error(client, err_code, typecast_error_message(err_code));
-        if (response_buf.data) free(response_buf.data);
-        return NULL;
-    }
+    if (voices_get(client, url, &response_buf, NULL, trace) != TYPECAST_OK) return NULL;
 
     cJSON* json = cJSON_Parse((const char*)response_buf.data);
     free(response_buf.data);
@@ -1808,10 +2186,9 @@ TYPECAST_API TypecastRecommendedVoicesResponse* typecast_recommend_voices(
         return NULL;
     }
 
-    TypecastRecommendedVoicesResponse* resp =
-        (TypecastRecommendedVoicesResponse*)calloc(1, sizeof(TypecastRecommendedVoicesResponse));
+    TypecastRecommendedVoicesResponse* resp = tc_recommended_voices_from_json(json);
     /* LCOV_EXCL_START */
-    /* category=unreachable reason="calloc OOM; cannot be triggered deterministically" */
+    /* category=oom reason="voice arena allocation" */
     if (!resp) {
         set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response");
         cJSON_Delete(json);
@@ -1819,47 +2196,30 @@ TYPECAST_API TypecastRecommendedVoicesResponse* typecast_recommend_voices(
     }
     /* LCOV_EXCL_STOP */
 
-    resp->count = cJSON_GetArraySize(json);
-    if (resp->count > 0) {
-        resp->voices = (TypecastRecommendedVoice*)calloc(resp->count, sizeof(TypecastRecommendedVoice));
-        /* LCOV_EXCL_START */
-        /* category=unreachable reason="calloc OOM; cannot be triggered deterministically" */
-        if (!resp->voices) {
-            set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate voices array");
-            free(resp);
-            cJSON_Delete(json);
-            return NULL;
-        }
-        /* LCOV_EXCL_STOP */
-    }
-
-    for (size_t i = 0; i < resp->count; i++) {
-        cJSON* voice_json = cJSON_GetArrayItem(json, (int)i);
-        if (!cJSON_IsObject(voice_json)) continue;
-
-        cJSON* voice_id = cJSON_GetObjectItem(voice_json, "voice_id");
-        if (cJSON_IsString(voice_id)) {
-            resp->voices[i].voice_id = strdup_safe(voice_id->valuestring);
-        }
-
-        cJSON* voice_name = cJSON_GetObjectItem(voice_json, "voice_name");
-        if (cJSON_IsString(voice_name)) {
-            resp->voices[i].voice_name = strdup_safe(voice_name->valuestring);
-        }
-
-        cJSON* score = cJSON_GetObjectItem(voice_json, "score");
-        if (cJSON_IsNumber(score)) {
-            resp->voices[i].score = score->valuedouble;
-        }
-    }
-
     cJSON_Delete(json);
     return resp;
 }
 
+TYPECAST_API TypecastRecommendedVoicesResponse* typecast_recommend_voices(
+    TypecastClient* client,
+    const char* query,
+    int count
+) {
+    TcRequestTrace trace;
+    tc_trace_begin(&trace, TYPECAST_REQUEST_VOICES, tc_monotonic_us());
+    TypecastRecommendedVoicesResponse* result = recommend_voices_traced(client, query, count, &trace);
+    tc_trace_end(client, &trace, call_outcome(client, result));
+    return result;
+}
+
 TYPECAST_API void typecast_voices_response_free(TypecastVoicesResponse* response) {
     if (!response) return;
-    
+    if (tc_voices_response_is_arena(response)) {
+        free(response);
+        return;
+    }
+
+    /* Built field by field outside the SDK */
     for (size_t i = 0; i < response->count; i++) {
         TypecastVoice* voice = &response->voices[i];
         if (voice->voice_id) free(voice->voice_id);
@@ -1885,6 +2245,10 @@ TYPECAST_API void typecast_voices_response_free(TypecastVoicesResponse* response
 
 TYPECAST_API void typecast_recommended_voices_response_free(TypecastRecommendedVoicesResponse* response) {
     if (!response) return;
+    if (tc_recommended_voices_is_arena(response)) {
+        free(response);
+        return;
+    }
 
     for (size_t i = 0; i < response->count; i++) {
         if (response->voices[i].voice_id) free(response->voices[i].voice_id);
@@ -1897,7 +2261,11 @@ TYPECAST_API void typecast_recommended_voices_response_free(TypecastRecommendedV
 
 TYPECAST_API void typecast_voice_free(TypecastVoice* voice) {
     if (!voice) return;
-    
+    if (tc_voice_is_arena(voice)) {
+        free(voice);
+        return;
+    }
+
     if (voice->voice_id) free(voice->voice_id);
     if (voice->voice_name) free(voice->voice_name);
     
@@ -1921,8 +2289,9 @@ TYPECAST_API void typecast_voice_free(TypecastVoice* voice) {
  * Subscription API Implementation
  * ============================================ */
 
-TYPECAST_API TypecastSubscription* typecast_get_my_subscription(
-    TypecastClient* client
+static TypecastSubscription* get_my_subscription_traced(
+    TypecastClient* client,
+    TcRequestTrace* trace
 ) {
     if (!client) return NULL;
 
@@ -1932,44 +2301,9 @@ TYPECAST_API TypecastSubscription* typecast_get_my_subscription(
     char url[512];
     snprintf(url, sizeof(url), "%s/v1/users/me/subscription", client->host);
 
-    /* Setup response buffer */
     ResponseBuffer response_buf = {0};
-
-    /* Setup CURL */
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
-
-    struct curl_slist* headers = NULL;
-    headers = append_common_headers(headers, client, 30L);
-
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_buf);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-
-    /* Perform request */
-    CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
-
-    if (res != CURLE_OK) {
-        set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(res));
-        if (response_buf.data) free(response_buf.data);
-        return NULL;
-    }
-
-    /* Check HTTP status */
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code != 200) {
-        TypecastErrorCode err_code = http_status_to_error(http_code);
-        set_error(client, err_code, typecast_error_message(err_code));
-        if (response_buf.data) free(response_buf.data);
-        return NULL;
-    }
-
+    if (perform_get(client, url, &response_buf, trace) != TYPECAST_OK) return NULL;
+    
     /* Parse JSON response */
     cJSON* json = cJSON_Parse((const char*)response_buf.data);
     free(response_buf.data);
@@ -2046,6 +2380,16 @@ TYPECAST_API TypecastSubscription* typecast_get_my_subscription(
     return sub;
 }
 
+TYPECAST_API TypecastSubscription* typecast_get_my_subscription(
+    TypecastClient* client
+) {
+    TcRequestTrace trace;
+    tc_trace_begin(&trace, TYPECAST_REQUEST_SUBSCRIPTION, tc_monotonic_us());
+    TypecastSubscription* result = get_my_subscription_traced(client, &trace);
+    tc_trace_end(client, &trace, call_outcome(client, result));
+    return result;
+}
+
 TYPECAST_API void typecast_subscription_free(TypecastSubscription* subscription) {
     if (!subscription) return;
     free(subscription);
@@ -2118,679 +2462,131 @@ TYPECAST_API const char* typecast_error_message(TypecastErrorCode code) {
         case TYPECAST_ERROR_UNPROCESSABLE_ENTITY: return ERROR_MESSAGES[10];
         case TYPECAST_ERROR_RATE_LIMIT: return ERROR_MESSAGES[11];
         case TYPECAST_ERROR_INTERNAL_SERVER: return ERROR_MESSAGES[12];
+        case TYPECAST_ERROR_CANCELLED: return ERROR_MESSAGES[13];
         default: return "Unknown error";
     }
 }
 
 /* ============================================
- * Timestamp TTS — Captioning helpers
- * ============================================ */
-
-/* Count UTF-8 codepoints: every byte that is NOT a continuation byte. */
-static size_t utf8_codepoint_count(const char* s) {
-    size_t count = 0;
-    const unsigned char* p = (const unsigned char*)s;
-    for (; *p; p++) {
-        if ((*p & 0xc0) != 0x80) count++;
-    }
-    return count;
-}
-
-/* Sentence-ending terminators (ASCII + full-width punctuation as UTF-8). */
-static const char* CAPTION_TERMINATORS[] = {
-    ".",
-    "?",
-    "!",
-    "\xe3\x80\x82",  /* 。 U+3002 */
-    "\xef\xbc\x9f",  /* ？ U+FF1F */
-    "\xef\xbc\x81",  /* ！ U+FF01 */
-    NULL
-};
-
-static const float CAPTION_MAX_SECONDS = 7.0f;
-static const size_t CAPTION_MAX_CHARS   = 42;
-
-/* Return 1 if haystack ends with needle (both NUL-terminated byte strings). */
-static int ends_with_str(const char* haystack, const char* needle) {
-    size_t hl = strlen(haystack), nl = strlen(needle);
-    if (nl > hl) return 0;
-    return memcmp(haystack + hl - nl, needle, nl) == 0;
-}
-
-/* Return 1 if text (after stripping trailing whitespace) ends in a sentence
- * terminator.  Works with multi-byte UTF-8 terminators. */
-static int ends_in_sentence(const char* text) {
-    /* Make a mutable copy so we can trim in-place. */
-    char* trimmed = strdup_safe(text);
-    if (!trimmed) return 0;
-    size_t n = strlen(trimmed);
-    while (n > 0 && (trimmed[n-1] == ' ' || trimmed[n-1] == '\t' ||
-                     trimmed[n-1] == '\n' || trimmed[n-1] == '\r')) {
-        trimmed[--n] = '\0';
-    }
-    int found = 0;
-    for (int i = 0; CAPTION_TERMINATORS[i]; i++) {
-        if (ends_with_str(trimmed, CAPTION_TERMINATORS[i])) {
-            found = 1;
-            break;
-        }
-    }
-    free(trimmed);
-    return found;
-}
-
-/* Strip leading and trailing ASCII whitespace in-place on buf[0..len].
- * Returns the new (possibly 0) length via *new_len. */
-static void strip_whitespace_inplace(char* buf, size_t* len) {
-    size_t n = *len;
-    /* Trailing */
-    while (n > 0 && (buf[n-1] == ' ' || buf[n-1] == '\t' ||
-                     buf[n-1] == '\n' || buf[n-1] == '\r')) {
-        buf[--n] = '\0';
-    }
-    /* Leading */
-    size_t lead = 0;
-    while (lead < n && (buf[lead] == ' ' || buf[lead] == '\t' ||
-                        buf[lead] == '\n' || buf[lead] == '\r')) {
-        lead++;
-    }
-    if (lead > 0) {
-        memmove(buf, buf + lead, n - lead + 1); /* +1 for '\0' */
-        n -= lead;
-    }
-    *len = n;
-}
-
-/* ---- Dynamic string builder ---- */
-typedef struct {
-    char*  data;
-    size_t len;
-    size_t cap;
-} StrBuf;
-
-static int strbuf_append(StrBuf* b, const char* s) {
-    size_t slen = strlen(s);
-    if (b->len + slen + 1 > b->cap) {
-        size_t new_cap = b->cap ? b->cap * 2 : 256;
-        while (new_cap < b->len + slen + 1) new_cap *= 2;
-        char* nd = (char*)realloc(b->data, new_cap);
-        if (!nd) return 0;
-        b->data = nd;
-        b->cap  = new_cap;
-    }
-    memcpy(b->data + b->len, s, slen);
-    b->len += slen;
-    b->data[b->len] = '\0';
-    return 1;
-}
-
-/* Format seconds -> HH:MM:SS,mmm (SRT) into caller-supplied buf (>=16 bytes) */
-static void fmt_srt_time(float sec, char* buf, size_t buf_size) {
-    int total_ms = (int)(sec * 1000.0f + 0.5f);
-    if (total_ms < 0) total_ms = 0;
-    int ms = total_ms % 1000;
-    int s  = (total_ms / 1000) % 60;
-    int m  = (total_ms / 60000) % 60;
-    int h  = (total_ms / 3600000);
-    snprintf(buf, buf_size, "%02d:%02d:%02d,%03d", h, m, s, ms);
-}
-
-/* Format seconds -> HH:MM:SS.mmm (VTT) */
-static void fmt_vtt_time(float sec, char* buf, size_t buf_size) {
-    int total_ms = (int)(sec * 1000.0f + 0.5f);
-    if (total_ms < 0) total_ms = 0;
-    int ms = total_ms % 1000;
-    int s  = (total_ms / 1000) % 60;
-    int m  = (total_ms / 60000) % 60;
-    int h  = (total_ms / 3600000);
-    snprintf(buf, buf_size, "%02d:%02d:%02d.%03d", h, m, s, ms);
-}
-
-/* ---- Caption cue ---- */
-typedef struct {
-    char*  text;   /* heap-allocated, caller frees */
-    float  start;
-    float  end;
-} CaptionCue;
-
-/* Free an array of CaptionCue.  cues[i].text is freed; then the array. */
-static void cues_free(CaptionCue* cues, int n) {
-    if (!cues) return;
-    for (int i = 0; i < n; i++) {
-        if (cues[i].text) free(cues[i].text);
-    }
-    free(cues);
-}
-
-/*
- * Build caption cues from an alignment segment array.
- *
- * word_mode = 1  ->  parts joined with " "
- * word_mode = 0  ->  parts concatenated directly (char mode)
- *
- * Returns heap-allocated array of CaptionCue (caller must call cues_free).
- * *out_count is set to the number of cues.
- *
- * TODO(TASK-12430-followup): expose max_seconds / max_chars override to match Python/JS API surface. Default 7.0s / 42 chars (BBC/Netflix guideline).
- * TODO(TASK-12430-followup): warn or error when alignment array contains majority-empty text segments — server contract should never produce these but defense-in-depth is desirable.
- */
-static CaptionCue* group_into_cues(
-    const TypecastAlignmentSegment* segs,
-    size_t seg_count,
-    int word_mode,
-    int* out_count
-) {
-    *out_count = 0;
-    if (!segs || seg_count == 0) return NULL;
-
-    /* We build cue text into a dynamic string.
-     * Max cues possible = seg_count (one cue per segment in worst case). */
-    CaptionCue* cues = (CaptionCue*)calloc(seg_count, sizeof(CaptionCue));
-    if (!cues) return NULL;
-
-    int ncues = 0;
-
-    /* Current in-progress cue parts.  We accumulate a single string. */
-    StrBuf cur = {0};
-    float  cur_start = 0.0f;
-    float  last_end  = 0.0f;
-    int    has_cur   = 0;
-
-    for (size_t i = 0; i < seg_count; i++) {
-        const TypecastAlignmentSegment* seg = &segs[i];
-
-        if (has_cur) {
-            /* Build the candidate text if we include this segment. */
-            size_t candidate_len = cur.len
-                + (word_mode ? 1 : 0)   /* space separator */
-                + strlen(seg->text);
-            /* Temp buffer to compute codepoint count.  We only need the count,
-             * not the actual string, so compute it without a full strdup. */
-            size_t candidate_cp;
-            if (word_mode) {
-                /* count = cur codepoints + 1 (space) + seg codepoints */
-                candidate_cp = utf8_codepoint_count(cur.data)
-                             + 1
-                             + utf8_codepoint_count(seg->text);
-            } else {
-                candidate_cp = utf8_codepoint_count(cur.data)
-                             + utf8_codepoint_count(seg->text);
-            }
-            int would_exceed_sec  = (seg->end - cur_start) > CAPTION_MAX_SECONDS;
-            int would_exceed_chars = candidate_cp > CAPTION_MAX_CHARS;
-            (void)candidate_len; /* suppress unused-variable warning */
-
-            if (would_exceed_sec || would_exceed_chars) {
-                /* Flush current cue. */
-                strip_whitespace_inplace(cur.data, &cur.len);
-                if (cur.len > 0) {
-                    char* t = strdup_safe(cur.data);
-                    if (!t) {
-                        /* OOM — free partial work and bail */
-                        /* LCOV_EXCL_START */
-                        free(cur.data);
-                        cues_free(cues, ncues);
-                        return NULL;
-                        /* LCOV_EXCL_STOP */
-                    }
-                    cues[ncues].text  = t;
-                    cues[ncues].start = cur_start;
-                    cues[ncues].end   = last_end;
-                    ncues++;
-                }
-
-                /* Start fresh */
-                cur.len = 0;
-                if (cur.data) cur.data[0] = '\0';
-                has_cur = 0;
-            }
-        }
-
-        if (!has_cur) {
-            cur_start = seg->start;
-            /* Reset accumulated text */
-            cur.len = 0;
-            if (cur.data) cur.data[0] = '\0';
-            if (!strbuf_append(&cur, seg->text)) {
-                /* LCOV_EXCL_START */
-                free(cur.data);
-                cues_free(cues, ncues);
-                return NULL;
-                /* LCOV_EXCL_STOP */
-            }
-            has_cur = 1;
-        } else {
-            /* Append separator + segment */
-            if (word_mode) {
-                if (!strbuf_append(&cur, " ")) {
-                    /* LCOV_EXCL_START */
-                    free(cur.data);
-                    cues_free(cues, ncues);
-                    return NULL;
-                    /* LCOV_EXCL_STOP */
-                }
-            }
-            if (!strbuf_append(&cur, seg->text)) {
-                /* LCOV_EXCL_START */
-                free(cur.data);
-                cues_free(cues, ncues);
-                return NULL;
-                /* LCOV_EXCL_STOP */
-            }
-        }
-        last_end = seg->end;
-
-        if (ends_in_sentence(seg->text)) {
-            /* Flush */
-            strip_whitespace_inplace(cur.data, &cur.len);
-
-            if (cur.len > 0) {
-                char* t = strdup_safe(cur.data);
-                if (!t) {
-                    /* LCOV_EXCL_START */
-                    free(cur.data);
-                    cues_free(cues, ncues);
-                    return NULL;
-                    /* LCOV_EXCL_STOP */
-                }
-                cues[ncues].text  = t;
-                cues[ncues].start = cur_start;
-                cues[ncues].end   = seg->end;
-                ncues++;
-            }
-            cur.len = 0;
-            if (cur.data) cur.data[0] = '\0';
-            has_cur = 0;
-        }
-    }
-
-    /* Flush any remaining partial cue. */
-    if (has_cur && cur.len > 0) {
-        strip_whitespace_inplace(cur.data, &cur.len);
-        if (cur.len > 0) {
-            char* t = strdup_safe(cur.data);
-            if (!t) {
-                /* LCOV_EXCL_START */
-                free(cur.data);
-                cues_free(cues, ncues);
-                return NULL;
-                /* LCOV_EXCL_STOP */
-            }
-            cues[ncues].text  = t;
-            cues[ncues].start = cur_start;
-            cues[ncues].end   = last_end;
-            ncues++;
-        }
-    }
-
-    free(cur.data);
-    *out_count = ncues;
-    return cues;
-}
-
-/*
- * Pick the segment list and word_mode from a response.
- * Returns 1 on success; 0 if no usable segments.
- */
-static int pick_segments(
-    const TypecastTTSWithTimestampsResponse* response,
-    const TypecastAlignmentSegment** segs_out,
-    size_t* count_out,
-    int* word_mode_out
-) {
-    if (response->words && response->words_count >= 2) {
-        *segs_out     = response->words;
-        *count_out    = response->words_count;
-        *word_mode_out = 1;
-        return 1;
-    }
-    if (response->characters && response->characters_count >= 1) {
-        *segs_out     = response->characters;
-        *count_out    = response->characters_count;
-        *word_mode_out = 0;
-        return 1;
-    }
-    /* Single-entry words with no characters -> still valid */
-    if (response->words && response->words_count == 1 &&
-        (!response->characters || response->characters_count == 0)) {
-        *segs_out     = response->words;
-        *count_out    = response->words_count;
-        *word_mode_out = 1;
-        return 1;
-    }
-    return 0;
-}
-
-/* ============================================
- * Base64 decoder (public-domain algorithm)
- * ============================================ */
-
-static const signed char B64_TABLE[256] = {
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,62, -1,-1,-1,63,
-    52,53,54,55, 56,57,58,59, 60,61,-1,-1, -1, 0,-1,-1,
-    -1, 0, 1, 2,  3, 4, 5, 6,  7, 8, 9,10, 11,12,13,14,
-    15,16,17,18, 19,20,21,22, 23,24,25,-1, -1,-1,-1,-1,
-    -1,26,27,28, 29,30,31,32, 33,34,35,36, 37,38,39,40,
-    41,42,43,44, 45,46,47,48, 49,50,51,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1
-};
-
-/* Decode base64 src into newly allocated *out (caller frees).
- * Sets *out_len to decoded byte count.
- * Returns 0 on success, -1 on error. */
-static int base64_decode(const char* src, uint8_t** out, size_t* out_len) {
-    if (!src || !out || !out_len) return -1;
-
-    size_t src_len = strlen(src);
-    /* Remove padding from length calculation */
-    size_t padding = 0;
-    if (src_len >= 1 && src[src_len - 1] == '=') padding++;
-    if (src_len >= 2 && src[src_len - 2] == '=') padding++;
-
-    size_t decoded_len = (src_len / 4) * 3 - padding;
-    uint8_t* buf = (uint8_t*)malloc(decoded_len + 1);
-    if (!buf) return -1;
-
-    size_t j = 0;
-    for (size_t i = 0; i + 3 < src_len; i += 4) {
-        signed char a = B64_TABLE[(unsigned char)src[i]];
-        signed char b = B64_TABLE[(unsigned char)src[i+1]];
-        signed char c = B64_TABLE[(unsigned char)src[i+2]];
-        signed char d = B64_TABLE[(unsigned char)src[i+3]];
-
-        if (a < 0 || b < 0) { free(buf); return -1; }
-
-        buf[j++] = (uint8_t)((a << 2) | (b >> 4));
-        if (src[i+2] != '=') {
-            if (c < 0) { free(buf); return -1; }
-            buf[j++] = (uint8_t)((b << 4) | (c >> 2));
-        }
-        if (src[i+3] != '=') {
-            if (d < 0) { free(buf); return -1; }
-            buf[j++] = (uint8_t)((c << 6) | d);
-        }
-    }
-    buf[j] = 0;
-    *out     = buf;
-    *out_len = j;
-    return 0;
-}
-
-/* ============================================
- * Timestamp TTS — JSON request builder
- * ============================================ */
-
-static cJSON* build_tts_with_timestamps_request_json(
-    const TypecastTTSRequestWithTimestamps* request
-) {
-    /* Re-use the base TTS request builder by mapping fields. */
-    TypecastTTSRequest base = {0};
-    base.text     = request->text;
-    base.voice_id = request->voice_id;
-    base.model    = request->model;
-    base.language = request->language;
-    base.prompt   = request->prompt;
-    base.output   = request->output;
-    base.seed     = request->seed;
-
-    cJSON* root = build_tts_request_json(&base);
-    if (!root) return NULL;
-
-    /* granularity is sent as a query parameter, not in the JSON body */
-
-    return root;
-}
-
-/* ============================================
- * JSON Unicode unescape helper
- *
- * The bundled cJSON replaces \uXXXX with '?' (intentional simplification).
- * We pre-process the JSON body to convert \uXXXX (and surrogate pairs) to
- * their UTF-8 byte sequences before passing to cJSON_Parse so that Japanese,
- * Chinese, and other non-ASCII text survives the round-trip.
- * ============================================ */
-
-/* Write a Unicode codepoint as UTF-8 into buf (must have >= 4 bytes).
- * Returns number of bytes written, or 0 on error. */
-static int codepoint_to_utf8(unsigned int cp, char* buf) {
-    if (cp < 0x80) {
-        buf[0] = (char)(cp);
-        return 1;
-    } else if (cp < 0x800) {
-        buf[0] = (char)(0xC0 | (cp >> 6));
-        buf[1] = (char)(0x80 | (cp & 0x3F));
-        return 2;
-    } else if (cp < 0x10000) {
-        buf[0] = (char)(0xE0 | (cp >> 12));
-        buf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
-        buf[2] = (char)(0x80 | (cp & 0x3F));
-        return 3;
-    } else if (cp < 0x110000) {
-        buf[0] = (char)(0xF0 | (cp >> 18));
-        buf[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
-        buf[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
-        buf[3] = (char)(0x80 | (cp & 0x3F));
-        return 4;
-    }
-    return 0; /* LCOV_EXCL_LINE — parse_hex4 can't return cp >= 0x110000 */
-}
-
-/* Parse 4 hex digits at p; return codepoint or -1 on invalid. */
-static int parse_hex4(const char* p) {
-    unsigned int cp = 0;
-    for (int i = 0; i < 4; i++) {
-        cp <<= 4;
-        char c = p[i];
-        if (c >= '0' && c <= '9') cp |= (unsigned int)(c - '0');
-        else if (c >= 'a' && c <= 'f') cp |= (unsigned int)(c - 'a' + 10);
-        else if (c >= 'A' && c <= 'F') cp |= (unsigned int)(c - 'A' + 10);
-        else return -1;
-    }
-    return (int)cp;
-}
-
-/*
- * Scan the JSON string src and return a heap-allocated copy with all
- * \uXXXX (and surrogate-pair \uD800\uDCxx) sequences replaced by their
- * UTF-8 equivalents.  Caller frees the result.
- *
- * This runs before cJSON_Parse so that non-ASCII characters survive the
- * bundled cJSON's simplified string parser.
- */
-static char* json_unescape_unicode(const char* src) {
-    size_t src_len = strlen(src);
-    /* Worst case: each \uXXXX (6 chars) becomes 4 UTF-8 bytes, so output
-     * fits in src_len bytes (replacement is always shorter or equal). */
-    char* out = (char*)malloc(src_len + 1);
-    if (!out) return NULL;
-
-    const char* r = src;
-    char* w = out;
-    int in_string = 0;
-    char prev = 0;
-
-    while (*r) {
-        if (!in_string) {
-            if (*r == '"') { in_string = 1; *w++ = *r++; continue; }
-            *w++ = *r++;
-            continue;
-        }
-        /* inside a JSON string */
-        if (prev != '\\' && *r == '"') {
-            in_string = 0; *w++ = *r++; prev = '"'; continue;
-        }
-        if (*r == '\\' && r[1] == 'u' && r[2] && r[3] && r[4] && r[5]) {
-            int cp = parse_hex4(r + 2);
-            if (cp < 0) { *w++ = *r++; prev = r[-1]; continue; }
-            /* Handle UTF-16 surrogate pairs */
-            if (cp >= 0xD800 && cp <= 0xDBFF) {
-                /* High surrogate; check for low surrogate immediately after */
-                if (r[6] == '\\' && r[7] == 'u') {
-                    int cp2 = parse_hex4(r + 8);
-                    if (cp2 >= 0xDC00 && cp2 <= 0xDFFF) {
-                        unsigned int full = (unsigned int)(
-                            0x10000 + ((cp - 0xD800) << 10) + (cp2 - 0xDC00));
-                        int written = codepoint_to_utf8(full, w);
-                        if (written > 0) { w += written; r += 12; prev = 0; continue; }
-                        /* LCOV_EXCL_START */
-                    }
-                }
-            }
-            /* LCOV_EXCL_STOP */
-            if (cp >= 0xDC00 && cp <= 0xDFFF) {
-                /* Lone low surrogate — output replacement char */
-                char rep[4]; int rlen = codepoint_to_utf8(0xFFFD, rep);
-                if (rlen > 0) { memcpy(w, rep, (size_t)rlen); w += rlen; }
-                r += 6; prev = 0; continue;
-            }
-            int written = codepoint_to_utf8((unsigned int)cp, w);
-            if (written > 0) { w += written; r += 6; prev = 0; continue; }
-            /* Fallback: copy raw (written==0 is unreachable — codepoint_to_utf8
-             * only returns 0 for cp >= 0x110000, which parse_hex4 cannot produce) */
-        } /* LCOV_EXCL_LINE */
-        prev = *r;
-        *w++ = *r++;
-    }
-    *w = '\0';
-    return out;
-}
-
-/* ============================================
- * Timestamp TTS — Segment array parser
+ * Base64 decoder
  * ============================================ */
 
-static TypecastAlignmentSegment* parse_segment_array(
-    cJSON* arr,
-    size_t* out_count
-) {
-    *out_count = 0;
-    if (!arr || !cJSON_IsArray(arr)) return NULL;
-
-    int n = cJSON_GetArraySize(arr);
-    if (n <= 0) return NULL;
-
-    TypecastAlignmentSegment* segs = (TypecastAlignmentSegment*)calloc(
-        (size_t)n, sizeof(TypecastAlignmentSegment));
-    if (!segs) return NULL;
+/* Decode base64 src into newly allocated *out (caller frees).
+ * Sets *out_len to decoded byte count.
+ * Returns 0 on success, -1 on error. */
+static int base64_decode(const char* src, uint8_t** out, size_t* out_len) {
+    if (!src || !out || !out_len) return -1;
 
-    for (int i = 0; i < n; i++) {
-        cJSON* item = cJSON_GetArrayItem(arr, i);
-        if (!cJSON_IsObject(item)) continue;
+    size_t src_len = strlen(src);
+    uint8_t* buf = (uint8_t*)malloc((src_len / 4) * 3 + 1);
+    if (!buf) return -1;
+    if (tc_base64_decode(src, src_len, buf, out_len) != 0) {
+        free(buf);
+        return -1;
+    }
+    buf[*out_len] = 0;
+    *out = buf;
+    return 0;
+}
 
-        cJSON* jtext  = cJSON_GetObjectItem(item, "text");
-        cJSON* jstart = cJSON_GetObjectItem(item, "start");
-        cJSON* jend   = cJSON_GetObjectItem(item, "end");
+/* ============================================
+ * Timestamp TTS — JSON request builder
+ * ============================================ */
 
-        if (cJSON_IsString(jtext)) {
-            segs[i].text = strdup_safe(jtext->valuestring);
-        } else {
-            /* Missing or non-string text field is malformed — abort. */
-            for (int k = 0; k < i; k++) {
-                if (segs[k].text) free(segs[k].text);
-            }
-            free(segs);
-            *out_count = 0;
-            return NULL;
-        }
-        if (cJSON_IsNumber(jstart)) {
-            segs[i].start = (float)jstart->valuedouble;
-        }
-        if (cJSON_IsNumber(jend)) {
-            segs[i].end = (float)jend->valuedouble;
-        }
-    }
+static void emit_tts_with_timestamps_request(TcJsonWriter* w, const void* ctx) {
+    const TypecastTTSRequestWithTimestamps* request = (const TypecastTTSRequestWithTimestamps*)ctx;
+    /* Re-use the base TTS request members by mapping fields. */
+    TypecastTTSRequest base = {0};
+    base.text     = request->text;
+    base.voice_id = request->voice_id;
+    base.model    = request->model;
+    base.language = request->language;
+    base.prompt   = request->prompt;
+    base.output   = request->output;
+    base.seed     = request->seed;
 
-    *out_count = (size_t)n;
-    return segs;
+    /* granularity is sent as a query parameter, not in the JSON body */
+    emit_tts_request(w, &base);
 }
 
 /* ============================================
  * Timestamp TTS — Public API Implementation
  * ============================================ */
 
-TYPECAST_API TypecastErrorCode typecast_text_to_speech_with_timestamps(
+static TypecastErrorCode transfer_prepare_timestamps(
     TypecastClient* client,
     const TypecastTTSRequestWithTimestamps* request,
-    TypecastTTSWithTimestampsResponse** out_response
+    int decode_audio,
+    typecast_stream_callback_t on_audio,
+    void* user_data,
+    TcTransfer* transfer,
+    TypecastError* error
 ) {
-    if (!client || !request || !out_response) {
-        if (client) set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
-        return TYPECAST_ERROR_INVALID_PARAM;
-    }
-    if (!request->text || !request->voice_id) {
-        set_error(client, TYPECAST_ERROR_INVALID_PARAM, "text and voice_id are required");
-        return TYPECAST_ERROR_INVALID_PARAM;
-    }
-
-    *out_response = NULL;
-    clear_error(client);
-
-    /* Build URL */
-    char url[512];
+    /* granularity is sent as a query parameter, not in the JSON body */
+    char path[256];
     if (request->granularity && strlen(request->granularity) > 0) {
-        snprintf(url, sizeof(url), "%s/v1/text-to-speech/with-timestamps?granularity=%s",
-                 client->host, request->granularity);
+        snprintf(path, sizeof(path), "/v1/text-to-speech/with-timestamps?granularity=%s",
+                 request->granularity);
     } else {
-        snprintf(url, sizeof(url), "%s/v1/text-to-speech/with-timestamps", client->host);
-    }
-
-    /* Build JSON body */
-    cJSON* json = build_tts_with_timestamps_request_json(request);
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="cJSON_CreateObject OOM; requires malloc shim" */
-    if (!json) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to build JSON");
-        return TYPECAST_ERROR_OUT_OF_MEMORY;
+        snprintf(path, sizeof(path), "/v1/text-to-speech/with-timestamps");
     }
-    /* LCOV_EXCL_STOP */
+    uint64_t started = tc_monotonic_us();
+    TypecastErrorCode err = transfer_prepare_json(client, transfer, TC_REQUEST_TIMESTAMPS, path,
+        emit_tts_with_timestamps_request, request, started, error);
+    if (err != TYPECAST_OK) return err; /* LCOV_EXCL_LINE category=oom reason="request serialization only fails on OOM" */
+    transfer->compressed = !client->options.disable_compression;
 
-    char* json_str = cJSON_PrintUnformatted(json);
-    cJSON_Delete(json);
+    transfer->timestamps = tc_ts_parser_new(decode_audio, on_audio, user_data);
     /* LCOV_EXCL_START */
-    /* category=unreachable reason="cJSON_PrintUnformatted OOM; requires malloc shim" */
-    if (!json_str) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to serialize JSON");
+    /* category=oom reason="parser allocation" */
+    if (!transfer->timestamps) {
+        tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response parser");
         return TYPECAST_ERROR_OUT_OF_MEMORY;
     }
     /* LCOV_EXCL_STOP */
+    return TYPECAST_OK;
+}
 
-    /* Setup response buffers */
-    ResponseBuffer response_buf = {0};
-
-    /* Setup CURL */
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
-
-    struct curl_slist* headers = NULL;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = append_common_headers(headers, client, 60L);
-
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_str);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)strlen(json_str));
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_buf);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 60L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-
-    CURLcode res = curl_easy_perform(curl);
-    cJSON_free(json_str);
-    curl_slist_free_all(headers);
-
-    if (res != CURLE_OK) {
-        set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(res));
-        if (response_buf.data) free(response_buf.data);
-        return TYPECAST_ERROR_NETWORK;
+TypecastErrorCode tc_transfer_prepare_timestamps(
+    TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request,
+    TcTransfer* transfer,
+    TypecastError* error
+) {
+    return transfer_prepare_timestamps(client, request, 0, NULL, NULL, transfer, error);
+}
+
+/* The body callback timed the whole parser; split off its base64 work
+ * and the time spent in the caller's audio callback */
+static void trace_timestamps(TcTransfer* transfer) {
+    uint64_t decode_us = 0, callback_us = 0, first_audio_at = 0;
+    tc_ts_parser_times(transfer->timestamps, &decode_us, &callback_us, &first_audio_at);
+    TypecastRequestMetrics* m = &transfer->trace.m;
+    m->decode_us = (int64_t)decode_us;
+    m->parse_us -= (int64_t)(decode_us + callback_us);
+    if (m->parse_us < 0) m->parse_us = 0;
+    transfer->trace.first_audio_at = first_audio_at;
+}
+
+TypecastErrorCode tc_transfer_finish_timestamps(
+    TcTransfer* transfer,
+    CURL* curl,
+    CURLcode result,
+    TypecastTTSWithTimestampsResponse** out_response,
+    TypecastError* error
+) {
+    *out_response = NULL;
+    trace_timestamps(transfer);
+    if (result != CURLE_OK) {
+        /* The parser stops the transfer when the body is malformed or the
+         * audio callback aborts */
+        const char* message = NULL;
+        TypecastErrorCode parse_error = tc_ts_parser_error(transfer->timestamps, &message);
+        if (parse_error != TYPECAST_OK) {
+            tc_error_set(error, parse_error, message);
+            return parse_error;
+        }
+        return tc_call_error(&transfer->call, result, error);
     }
 
     long http_code = 0;
@@ -2798,209 +2594,213 @@ TYPECAST_API TypecastErrorCode typecast_text_to_speech_with_timestamps(
 
     if (http_code != 200) {
         TypecastErrorCode err_code = http_status_to_error(http_code);
-        char* err_msg = NULL;
-        if (response_buf.data && response_buf.size > 0) {
-            cJSON* err_json = cJSON_Parse((const char*)response_buf.data);
-            if (err_json) {
-                cJSON* detail = cJSON_GetObjectItem(err_json, "detail");
-                if (cJSON_IsString(detail)) {
-                    err_msg = strdup_safe(detail->valuestring);
-                }
-                cJSON_Delete(err_json);
-            }
-        }
-        set_error(client, err_code, err_msg ? err_msg : typecast_error_message(err_code));
+        char* err_msg = parse_error_detail(&transfer->response);
+        tc_error_set(error, err_code, err_msg ? err_msg : typecast_error_message(err_code));
         if (err_msg) free(err_msg);
-        if (response_buf.data) free(response_buf.data);
         return err_code;
     }
 
-    /* Pre-process JSON to convert \uXXXX escapes to UTF-8 before cJSON parse,
-     * because the bundled cJSON replaces \uXXXX with '?' (known limitation). */
-    char* raw_json = (char*)response_buf.data;
-    char* unescaped = json_unescape_unicode(raw_json);
-    free(raw_json);
+    return tc_ts_parser_finish(transfer->timestamps, out_response, error);
+}
 
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="malloc OOM in json_unescape_unicode; requires malloc shim" */
-    if (!unescaped) {
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to unescape JSON");
-        return TYPECAST_ERROR_OUT_OF_MEMORY;
+static TypecastErrorCode text_to_speech_with_timestamps(
+    TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request,
+    int decode_audio,
+    typecast_stream_callback_t on_audio,
+    typecast_alignment_callback_t on_segment,
+    void* user_data,
+    TypecastTTSWithTimestampsResponse** out_response
+) {
+    if (!client || !request || !out_response) {
+        if (client) set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return TYPECAST_ERROR_INVALID_PARAM;
     }
-    /* LCOV_EXCL_STOP */
-
-    /* Parse JSON */
-    cJSON* root = cJSON_Parse(unescaped);
-    free(unescaped);
-
-    if (!root) {
-        set_error(client, TYPECAST_ERROR_JSON_PARSE, "Failed to parse JSON response");
-        return TYPECAST_ERROR_JSON_PARSE;
+    if (!request->text || !request->voice_id) {
+        set_error(client, TYPECAST_ERROR_INVALID_PARAM, "text and voice_id are required");
+        return TYPECAST_ERROR_INVALID_PARAM;
     }
 
-    TypecastTTSWithTimestampsResponse* resp =
-        (TypecastTTSWithTimestampsResponse*)calloc(
-            1, sizeof(TypecastTTSWithTimestampsResponse));
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="calloc OOM; requires malloc shim" */
-    if (!resp) {
-        cJSON_Delete(root);
-        set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response");
-        return TYPECAST_ERROR_OUT_OF_MEMORY;
-    }
-    /* LCOV_EXCL_STOP */
+    *out_response = NULL;
+    clear_error(client);
 
-    cJSON* jaudio = cJSON_GetObjectItem(root, "audio");
-    if (cJSON_IsString(jaudio)) {
-        resp->audio_base64 = strdup_safe(jaudio->valuestring);
-    }
-    cJSON* jfmt = cJSON_GetObjectItem(root, "audio_format");
-    if (cJSON_IsString(jfmt)) {
-        resp->audio_format = strdup_safe(jfmt->valuestring);
-    }
-    cJSON* jdur = cJSON_GetObjectItem(root, "audio_duration");
-    if (cJSON_IsNumber(jdur)) {
-        resp->audio_duration = (float)jdur->valuedouble;
+    TcTransfer transfer;
+    TypecastErrorCode err = transfer_prepare_timestamps(client, request, decode_audio, on_audio, user_data,
+        &transfer, tc_client_error(client));
+    if (err != TYPECAST_OK) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="request serialization only fails on OOM" */
+        tc_transfer_cleanup(&transfer);
+        return err;
+        /* LCOV_EXCL_STOP */
     }
+    if (on_segment) tc_ts_parser_stream_segments(transfer.timestamps, on_segment, user_data);
 
-    cJSON* jwords = cJSON_GetObjectItem(root, "words");
-    if (cJSON_IsArray(jwords)) {
-        resp->words = parse_segment_array(jwords, &resp->words_count);
-    }
-    cJSON* jchars = cJSON_GetObjectItem(root, "characters");
-    if (cJSON_IsArray(jchars)) {
-        resp->characters = parse_segment_array(jchars, &resp->characters_count);
+    /* Cached with-timestamps results are the raw body, replayed through
+     * the parser so decoded and callback variants behave the same */
+    int cacheable = tc_result_cache_accepts(client->result_cache, request->seed);
+    TcCachedResult cached;
+    if (cacheable && tc_result_cache_lookup(client->result_cache, &transfer, NULL, &cached)) {
+        tc_ts_parser_expect(transfer.timestamps, cached.size);
+        if (tc_ts_parser_feed(transfer.timestamps, (const char*)cached.data, cached.size) == 0) {
+            err = tc_ts_parser_finish(transfer.timestamps, out_response, tc_client_error(client));
+        } else {
+            const char* message = NULL;
+            err = tc_ts_parser_error(transfer.timestamps, &message);
+            set_error(client, err, message);
+        }
+        free(cached.data);
+        tc_transfer_cleanup(&transfer);
+        return err;
     }
+    ResponseBuffer body = {0};
+    if (cacheable) transfer.tee = &body;
 
-    cJSON_Delete(root);
-    *out_response = resp;
-    return TYPECAST_OK;
+    CURLcode res = CURLE_OK;
+    CURL* curl = tc_transfer_perform(client, &transfer, &res);
+    err = curl ? tc_transfer_finish_timestamps(&transfer, curl, res, out_response, tc_client_error(client))
+               : TYPECAST_ERROR_CURL_INIT;
+    tc_client_release(client, curl);
+    tc_trace_end(client, &transfer.trace, err);
+    if (err == TYPECAST_OK && transfer.tee) {
+        tc_result_cache_store(client->result_cache, &transfer, body.data, body.size, 0.0f, TYPECAST_AUDIO_FORMAT_WAV);
+    }
+    free(body.data);
+    tc_transfer_cleanup(&transfer);
+    return err;
 }
 
-/* ---- to_srt ---- */
-TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_to_srt(
-    const TypecastTTSWithTimestampsResponse* response,
-    char** out_string
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_with_timestamps(
+    TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request,
+    TypecastTTSWithTimestampsResponse** out_response
 ) {
-    if (!response || !out_string) return TYPECAST_ERROR_INVALID_PARAM;
-    *out_string = NULL;
+    return text_to_speech_with_timestamps(client, request, 0, NULL, NULL, NULL, out_response);
+}
 
-    const TypecastAlignmentSegment* segs;
-    size_t seg_count;
-    int word_mode;
-    if (!pick_segments(response, &segs, &seg_count, &word_mode)) {
-        return TYPECAST_ERROR_INVALID_PARAM;
-    }
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_with_timestamps_decoded(
+    TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request,
+    typecast_stream_callback_t on_audio,
+    void* user_data,
+    TypecastTTSWithTimestampsDecodedResponse** out_response
+) {
+    /* The parser's decoded responses are the first member of their result */
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    TypecastErrorCode err = text_to_speech_with_timestamps(client, request, 1, on_audio, NULL, user_data,
+        out_response ? &resp : NULL);
+    if (out_response) *out_response = (TypecastTTSWithTimestampsDecodedResponse*)resp;
+    return err;
+}
 
-    int ncues = 0;
-    CaptionCue* cues = group_into_cues(segs, seg_count, word_mode, &ncues);
-    if (!cues || ncues == 0) {
-        if (cues) cues_free(cues, ncues);
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_with_timestamps_stream(
+    TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request,
+    typecast_stream_callback_t on_audio,
+    typecast_alignment_callback_t on_segment,
+    void* user_data
+) {
+    if (!on_segment) {
+        if (client) set_error(client, TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
         return TYPECAST_ERROR_INVALID_PARAM;
     }
+    /* Everything was delivered; what is left holds format and duration */
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    TypecastErrorCode err = text_to_speech_with_timestamps(client, request, 1, on_audio, on_segment,
+        user_data, &resp);
+    typecast_tts_with_timestamps_decoded_response_free((TypecastTTSWithTimestampsDecodedResponse*)resp);
+    return err;
+}
 
-    StrBuf sb = {0};
-    char timebuf[32];
-    char linebuf[64];
+/* ---- audio_bytes ---- */
 
-    for (int i = 0; i < ncues; i++) {
-        /* Index line */
-        snprintf(linebuf, sizeof(linebuf), "%d\n", i + 1);
-        if (!strbuf_append(&sb, linebuf)) goto oom;
+/* audio_base64 decoded on first use, kept per SDK-created response */
+typedef struct {
+    tc_mutex_t lock;                 /* responses may be read from several threads */
+    uint8_t* data;
+    size_t size;
+    int ready;
+} TcDecodedAudio;
 
-        /* Timecode line: start --> end */
-        fmt_srt_time(cues[i].start, timebuf, sizeof(timebuf));
-        if (!strbuf_append(&sb, timebuf)) goto oom;
-        if (!strbuf_append(&sb, " --> ")) goto oom;
-        fmt_srt_time(cues[i].end, timebuf, sizeof(timebuf));
-        if (!strbuf_append(&sb, timebuf)) goto oom;
-        if (!strbuf_append(&sb, "\n")) goto oom;
+static TcSideTable decoded_audio;    /* response -> TcDecodedAudio */
 
-        /* Text */
-        if (!strbuf_append(&sb, cues[i].text)) goto oom;
-        if (!strbuf_append(&sb, "\n\n")) goto oom;
+void tc_decoded_audio_attach(const TypecastTTSWithTimestampsResponse* response) {
+    TcDecodedAudio* cache = (TcDecodedAudio*)calloc(1, sizeof(*cache));
+    if (!cache) return; /* LCOV_EXCL_LINE category=oom reason="decode cache allocation" */
+    tc_mutex_init(&cache->lock);
+    if (tc_side_put(&decoded_audio, response, cache) != 0) {
+        /* LCOV_EXCL_START */
+        /* category=oom reason="side table entry" */
+        tc_mutex_destroy(&cache->lock);
+        free(cache);
+        /* LCOV_EXCL_STOP */
     }
+}
 
-    cues_free(cues, ncues);
-    *out_string = sb.data;
-    return TYPECAST_OK;
-
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="strbuf_append realloc OOM; requires malloc shim" */
-oom:
-    free(sb.data);
-    cues_free(cues, ncues);
-    return TYPECAST_ERROR_OUT_OF_MEMORY;
-    /* LCOV_EXCL_STOP */
+static void decoded_audio_free(TcDecodedAudio* cache) {
+    if (!cache) return;
+    free(cache->data);
+    tc_mutex_destroy(&cache->lock);
+    free(cache);
 }
 
-/* ---- to_vtt ---- */
-TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_to_vtt(
+/* Point *data at the decoded audio. *owned is set when the bytes were
+ * decoded just for this call (no cache) and must be freed by the caller. */
+static TypecastErrorCode decoded_audio_view(
     const TypecastTTSWithTimestampsResponse* response,
-    char** out_string
+    const uint8_t** data,
+    size_t* size,
+    int* owned
 ) {
-    if (!response || !out_string) return TYPECAST_ERROR_INVALID_PARAM;
-    *out_string = NULL;
-
-    const TypecastAlignmentSegment* segs;
-    size_t seg_count;
-    int word_mode;
-    if (!pick_segments(response, &segs, &seg_count, &word_mode)) {
-        return TYPECAST_ERROR_INVALID_PARAM;
-    }
+    *owned = 0;
+    if (!response->audio_base64) return TYPECAST_ERROR_INVALID_PARAM;
 
-    int ncues = 0;
-    CaptionCue* cues = group_into_cues(segs, seg_count, word_mode, &ncues);
-    if (!cues || ncues == 0) {
-        if (cues) cues_free(cues, ncues);
-        return TYPECAST_ERROR_INVALID_PARAM;
+    TcDecodedAudio* cache = (TcDecodedAudio*)tc_side_get(&decoded_audio, response);
+    if (!cache) {
+        uint8_t* bytes = NULL;
+        if (base64_decode(response->audio_base64, &bytes, size) != 0) return TYPECAST_ERROR_JSON_PARSE;
+        *data = bytes;
+        *owned = 1;
+        return TYPECAST_OK;
     }
 
-    StrBuf sb = {0};
-    char timebuf[32];
-
-    /* VTT header */
-    if (!strbuf_append(&sb, "WEBVTT\n\n")) goto oom;
-
-    for (int i = 0; i < ncues; i++) {
-        /* Timecode line */
-        fmt_vtt_time(cues[i].start, timebuf, sizeof(timebuf));
-        if (!strbuf_append(&sb, timebuf)) goto oom;
-        if (!strbuf_append(&sb, " --> ")) goto oom;
-        fmt_vtt_time(cues[i].end, timebuf, sizeof(timebuf));
-        if (!strbuf_append(&sb, timebuf)) goto oom;
-        if (!strbuf_append(&sb, "\n")) goto oom;
-
-        /* Text */
-        if (!strbuf_append(&sb, cues[i].text)) goto oom;
-        if (!strbuf_append(&sb, "\n\n")) goto oom;
+    TypecastErrorCode rc = TYPECAST_OK;
+    tc_mutex_lock(&cache->lock);
+    if (!cache->ready) {
+        if (base64_decode(response->audio_base64, &cache->data, &cache->size) == 0) {
+            cache->ready = 1;
+        } else {
+            rc = TYPECAST_ERROR_JSON_PARSE;
+        }
     }
-
-    cues_free(cues, ncues);
-    *out_string = sb.data;
-    return TYPECAST_OK;
-
-    /* LCOV_EXCL_START */
-    /* category=unreachable reason="strbuf_append realloc OOM; requires malloc shim" */
-oom:
-    free(sb.data);
-    cues_free(cues, ncues);
-    return TYPECAST_ERROR_OUT_OF_MEMORY;
-    /* LCOV_EXCL_STOP */
+    tc_mutex_unlock(&cache->lock);
+    *data = cache->data;
+    *size = cache->size;
+    return rc;
 }
 
-/* ---- audio_bytes ---- */
 TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_audio_bytes(
     const TypecastTTSWithTimestampsResponse* response,
     uint8_t** out_bytes,
     size_t* out_size
 ) {
     if (!response || !out_bytes || !out_size) return TYPECAST_ERROR_INVALID_PARAM;
-    if (!response->audio_base64) return TYPECAST_ERROR_INVALID_PARAM;
-
-    if (base64_decode(response->audio_base64, out_bytes, out_size) != 0) {
-        return TYPECAST_ERROR_JSON_PARSE;
+    const uint8_t* data = NULL;
+    size_t size = 0;
+    int owned = 0;
+    TypecastErrorCode rc = decoded_audio_view(response, &data, &size, &owned);
+    if (rc != TYPECAST_OK) return rc;
+    if (owned) {
+        *out_bytes = (uint8_t*)data;
+        *out_size = size;
+        return TYPECAST_OK;
     }
+
+    *out_bytes = (uint8_t*)malloc(size + 1);
+    if (!*out_bytes) return TYPECAST_ERROR_OUT_OF_MEMORY; /* LCOV_EXCL_LINE category=oom reason="copy of decoded audio" */
+    memcpy(*out_bytes, data, size);
+    (*out_bytes)[size] = 0;
+    *out_size = size;
     return TYPECAST_OK;
 }
 
@@ -3011,20 +2811,20 @@ TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_save_audio(
 ) {
     if (!response || !path) return TYPECAST_ERROR_INVALID_PARAM;
 
-    uint8_t* bytes = NULL;
-    size_t   size  = 0;
-    TypecastErrorCode rc = typecast_tts_with_timestamps_response_audio_bytes(
-        response, &bytes, &size);
+    const uint8_t* data = NULL;
+    size_t size = 0;
+    int owned = 0;
+    TypecastErrorCode rc = decoded_audio_view(response, &data, &size, &owned);
     if (rc != TYPECAST_OK) return rc;
 
     FILE* f = fopen(path, "wb");
     if (!f) {
-        free(bytes);
+        if (owned) free((void*)data);
         return TYPECAST_ERROR_NETWORK; /* reuse as I/O error */
     }
-    size_t written = fwrite(bytes, 1, size, f);
+    size_t written = fwrite(data, 1, size, f);
     fclose(f);
-    free(bytes);
+    if (owned) free((void*)data);
     if (written != size) {
         return TYPECAST_ERROR_NETWORK; /* LCOV_EXCL_LINE — disk-full path */
     }
@@ -3032,12 +2832,11 @@ TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_save_audio(
 }
 
 /* ---- free ---- */
-TYPECAST_API void typecast_tts_with_timestamps_response_free(
-    TypecastTTSWithTimestampsResponse* response
-) {
-    if (!response) return;
-
-    if (response->audio_base64) free(response->audio_base64);
+static void timestamps_members_free(TypecastTTSWithTimestampsResponse* response) {
+    if (response->audio_base64) {
+        decoded_audio_free((TcDecodedAudio*)tc_side_take(&decoded_audio, response));
+        free(response->audio_base64);
+    }
     if (response->audio_format)  free(response->audio_format);
 
     if (response->words) {
@@ -3052,7 +2851,22 @@ TYPECAST_API void typecast_tts_with_timestamps_response_free(
         }
         free(response->characters);
     }
+}
+
+TYPECAST_API void typecast_tts_with_timestamps_response_free(
+    TypecastTTSWithTimestampsResponse* response
+) {
+    if (!response) return;
+    timestamps_members_free(response);
+    free(response);
+}
 
+TYPECAST_API void typecast_tts_with_timestamps_decoded_response_free(
+    TypecastTTSWithTimestampsDecodedResponse* response
+) {
+    if (!response) return;
+    timestamps_members_free(&response->timestamps);
+    free(response->audio_data);
     free(response);
 }
 
@@ -3080,23 +2894,71 @@ static const char* guess_audio_mime(const char* filename) {
     return "application/octet-stream";
 }
 
-TYPECAST_API TypecastErrorCode typecast_clone_voice(
+/* Feeds a callback upload to curl, stopping at upload->size bytes */
+typedef struct {
+    const TcCloneUpload* upload;
+    size_t sent;
+    int aborted;                     /* the callback returned TYPECAST_READ_ABORT */
+    int short_read;                  /* the callback ran dry before upload->size */
+} CloneReader;
+
+static size_t clone_read(char* buffer, size_t size, size_t nitems, void* arg) {
+    CloneReader* reader = (CloneReader*)arg;
+    size_t want = size * nitems;
+    size_t left = reader->upload->size - reader->sent;
+    if (want > left) want = left;
+    if (want == 0) return 0;
+    size_t n = reader->upload->read(buffer, want, reader->upload->read_user_data);
+    if (n == 0) {
+        reader->short_read = 1;
+        return CURL_READFUNC_ABORT;
+    }
+    if (n == TYPECAST_READ_ABORT || n > want) {
+        reader->aborted = 1;
+        return CURL_READFUNC_ABORT;
+    }
+    reader->sent += n;
+    return n;
+}
+
+/* Feeds an in-memory upload straight from the caller's buffer, which
+ * curl_mime_data would copy whole */
+static size_t clone_read_memory(char* buffer, size_t size, size_t nitems, void* arg) {
+    CloneReader* reader = (CloneReader*)arg;
+    size_t want = size * nitems;
+    size_t left = reader->upload->size - reader->sent;
+    if (want > left) want = left;
+    memcpy(buffer, reader->upload->data + reader->sent, want);
+    reader->sent += want;
+    return want;
+}
+
+/* Lets curl rewind the buffer to send the body again */
+static int clone_seek_memory(void* arg, curl_off_t offset, int origin) {
+    CloneReader* reader = (CloneReader*)arg;
+    if (origin != SEEK_SET || offset < 0 || (uint64_t)offset > (uint64_t)reader->upload->size) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    reader->sent = (size_t)offset;
+    return CURL_SEEKFUNC_OK;
+}
+
+static TypecastErrorCode clone_voice_traced(
     TypecastClient* client,
-    const unsigned char* audio,
-    size_t audio_len,
-    const char* filename,
+    const TcCloneUpload* upload,
     const char* name,
     const char* model,
-    TypecastCustomVoice* out
+    TypecastCustomVoice* out,
+    TcRequestTrace* trace
 ) {
     /* ---- Validate parameters ---- */
     if (!client) return TYPECAST_ERROR_INVALID_PARAM;
 
-    if (!audio || audio_len == 0) {
+    if ((!upload->data && !upload->path && !upload->read) || upload->size == 0) {
         set_error(client, TYPECAST_ERROR_INVALID_PARAM, "audio bytes are required");
         return TYPECAST_ERROR_INVALID_PARAM;
     }
-    if (audio_len > (size_t)TYPECAST_CLONING_MAX_FILE_SIZE) {
+    if (upload->size > (size_t)TYPECAST_CLONING_MAX_FILE_SIZE) {
         set_error(client, TYPECAST_ERROR_INVALID_PARAM,
                   "audio exceeds maximum size of 25 MB");
         return TYPECAST_ERROR_INVALID_PARAM;
@@ -3130,14 +2992,15 @@ TYPECAST_API TypecastErrorCode typecast_clone_voice(
     ResponseBuffer response_buf = {0};
 
     /* ---- Build multipart body ---- */
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
+    CURL* curl = acquire_curl(client);
+    if (!curl) return TYPECAST_ERROR_CURL_INIT; /* LCOV_EXCL_LINE category=oom reason="see acquire_curl" */
 
     curl_mime* mime = curl_mime_init(curl);
     /* LCOV_EXCL_START */
     /* category=unreachable reason="curl_mime_init failure cannot be induced through the public API" */
     if (!mime) {
         set_error(client, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to init mime");
+        tc_client_release(client, curl);
         return TYPECAST_ERROR_OUT_OF_MEMORY;
     }
     /* LCOV_EXCL_STOP */
@@ -3152,40 +3015,60 @@ TYPECAST_API TypecastErrorCode typecast_clone_voice(
     curl_mime_name(part, "model");
     curl_mime_data(part, model, CURL_ZERO_TERMINATED);
 
-    /* "file" field */
+    /* "file" field: a file, callback or buffer is read while the request is sent */
+    const char* filename = upload->filename;
+    CloneReader reader = {0};
+    reader.upload = upload;
     part = curl_mime_addpart(mime);
     curl_mime_name(part, "file");
-    curl_mime_filename(part, filename ? filename : "audio");
+    if (upload->path) {
+        curl_mime_filedata(part, upload->path);  /* names the part after the file */
+        if (!filename) filename = upload->path;
+        if (upload->filename) curl_mime_filename(part, upload->filename);
+    } else if (upload->read) {
+        curl_mime_filename(part, filename ? filename : "audio");
+        curl_mime_data_cb(part, (curl_off_t)upload->size, clone_read, NULL, NULL, &reader);
+    } else {
+        curl_mime_filename(part, filename ? filename : "audio");
+        curl_mime_data_cb(part, (curl_off_t)upload->size, clone_read_memory, clone_seek_memory, NULL, &reader);
+    }
     curl_mime_type(part, guess_audio_mime(filename));
-    curl_mime_data(part, (const char*)audio, audio_len);
-
-    /* ---- Auth header ---- */
-    struct curl_slist* headers = NULL;
-    headers = append_common_headers(headers, client, 120L);
 
     curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, client->headers[TC_HEADERS_UPLOAD]);
     curl_easy_setopt(curl, CURLOPT_MIMEPOST, mime);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, tc_response_write);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_buf);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 120L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+    TcCallSettings call;
+    tc_call_settings(client, TC_TIMEOUT_UPLOAD, &call);
+    call.on_upload = upload->on_progress;
+    call.upload_user_data = upload->progress_user_data;
+    tc_call_apply(curl, &call);
 
     /* ---- Perform ---- */
+    tc_trace_prepared(trace);
     CURLcode res = curl_easy_perform(curl);
+    tc_trace_attempt(trace, curl);
     curl_mime_free(mime);
-    curl_slist_free_all(headers);
+
+    long http_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    tc_client_release(client, curl);
 
     if (res != CURLE_OK) {
-        set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(res));
         if (response_buf.data) free(response_buf.data);
-        return TYPECAST_ERROR_NETWORK;
+        if (reader.aborted) {
+            set_error(client, TYPECAST_ERROR_NETWORK, "Upload aborted by callback");
+            return TYPECAST_ERROR_NETWORK;
+        }
+        if (reader.short_read) {
+            set_error(client, TYPECAST_ERROR_INVALID_PARAM, "read callback supplied fewer bytes than size");
+            return TYPECAST_ERROR_INVALID_PARAM;
+        }
+        return tc_call_error(&call, res, tc_client_error(client));
     }
 
     /* ---- Check HTTP status ---- */
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
     if (http_code != 200 && http_code != 201) {
         TypecastErrorCode err_code = http_status_to_error(http_code);
         char* err_msg = NULL;
@@ -3236,12 +3119,45 @@ TYPECAST_API TypecastErrorCode typecast_clone_voice(
     }
 
     cJSON_Delete(json);
+    /* The new voice is not in any cached catalog yet */
+    tc_voice_cache_clear(client->voice_cache);
     return TYPECAST_OK;
 }
 
-TYPECAST_API TypecastErrorCode typecast_delete_voice(
+TYPECAST_API TypecastErrorCode typecast_clone_voice(
     TypecastClient* client,
-    const char* voice_id
+    const unsigned char* audio,
+    size_t audio_len,
+    const char* filename,
+    const char* name,
+    const char* model,
+    TypecastCustomVoice* out
+) {
+    TcCloneUpload upload = {0};
+    upload.data = audio;
+    upload.size = audio ? audio_len : 0;
+    upload.filename = filename;
+    return tc_clone_voice(client, &upload, name, model, out);
+}
+
+TypecastErrorCode tc_clone_voice(
+    TypecastClient* client,
+    const TcCloneUpload* upload,
+    const char* name,
+    const char* model,
+    TypecastCustomVoice* out
+) {
+    TcRequestTrace trace;
+    tc_trace_begin(&trace, TYPECAST_REQUEST_CLONE, tc_monotonic_us());
+    TypecastErrorCode err = clone_voice_traced(client, upload, name, model, out, &trace);
+    tc_trace_end(client, &trace, err);
+    return err;
+}
+
+static TypecastErrorCode delete_voice_traced(
+    TypecastClient* client,
+    const char* voice_id,
+    TcRequestTrace* trace
 ) {
     if (!client) return TYPECAST_ERROR_INVALID_PARAM;
 
@@ -3260,37 +3176,37 @@ TYPECAST_API TypecastErrorCode typecast_delete_voice(
     ResponseBuffer response_buf = {0};
 
     /* ---- Setup CURL ---- */
-    CURL* curl = client->curl;
-    curl_easy_reset(curl);
-
-    struct curl_slist* headers = NULL;
-    headers = append_common_headers(headers, client, 30L);
+    CURL* curl = acquire_curl(client);
+    if (!curl) return TYPECAST_ERROR_CURL_INIT; /* LCOV_EXCL_LINE category=oom reason="see acquire_curl" */
 
     curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, client->headers[TC_HEADERS_QUERY]);
     curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, tc_response_write);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_buf);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+    TcCallSettings call;
+    tc_call_settings(client, TC_TIMEOUT_QUERY, &call);
+    tc_call_apply(curl, &call);
 
     /* ---- Perform ---- */
+    tc_trace_prepared(trace);
     CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
+    tc_trace_attempt(trace, curl);
+
+    long http_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    tc_client_release(client, curl);
 
     if (res != CURLE_OK) {
-        set_error(client, TYPECAST_ERROR_NETWORK, curl_easy_strerror(res));
         if (response_buf.data) free(response_buf.data);
-        return TYPECAST_ERROR_NETWORK;
+        return tc_call_error(&call, res, tc_client_error(client));
     }
 
     /* ---- Check HTTP status (204 = success for DELETE) ---- */
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
     if (response_buf.data) free(response_buf.data);
 
     if (http_code == 204 || http_code == 200) {
+        tc_voice_cache_clear(client->voice_cache);
         return TYPECAST_OK;
     }
 
@@ -3298,3 +3214,14 @@ TYPECAST_API TypecastErrorCode typecast_delete_voice(
     set_error(client, err_code, typecast_error_message(err_code));
     return err_code;
 }
+
+TYPECAST_API TypecastErrorCode typecast_delete_voice(
+    TypecastClient* client,
+    const char* voice_id
+) {
+    TcRequestTrace trace;
+    tc_trace_begin(&trace, TYPECAST_REQUEST_DELETE, tc_monotonic_us());
+    TypecastErrorCode err = delete_voice_traced(client, voice_id, &trace);
+    tc_trace_end(client, &trace, err);
+    return err;
+}
@@ -0,0 +1,93 @@
+/**
+ * Typecast C/C++ SDK - Pluggable allocation for response audio
+ *
+ * Audio buffers are allocated through the client's TypecastAllocator so
+ * services with their own arenas can take them over without a copy. A
+ * NULL or zero allocator means malloc/realloc/free.
+ *
+ * TypecastTTSResponse keeps its 1.x layout, so the allocator that owns a
+ * response's audio is kept in a side table, keyed by the response. Only
+ * responses of a client with a custom allocator are entered; any other
+ * response, including one the caller built, has its audio freed with
+ * free() as before.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_alloc.h"
+#include "typecast_side_table.h"
+
+static int uses_custom(const TypecastAllocator* allocator) {
+    return allocator && allocator->alloc_fn;
+}
+
+int tc_allocator_valid(const TypecastAllocator* allocator) {
+    if (!allocator) return 1;
+    if (!allocator->alloc_fn != !allocator->free_fn) return 0;
+    return allocator->alloc_fn || !allocator->realloc_fn;
+}
+
+void* tc_mem_alloc(const TypecastAllocator* allocator, size_t size) {
+    if (!uses_custom(allocator)) return malloc(size);
+    return allocator->alloc_fn(size, allocator->user_data);
+}
+
+void* tc_mem_realloc(const TypecastAllocator* allocator, void* ptr, size_t used, size_t size) {
+    if (!uses_custom(allocator)) return realloc(ptr, size);
+    if (!ptr) return allocator->alloc_fn(size, allocator->user_data);
+    if (allocator->realloc_fn) return allocator->realloc_fn(ptr, size, allocator->user_data);
+
+    void* grown = allocator->alloc_fn(size, allocator->user_data);
+    if (!grown) return NULL;
+    memcpy(grown, ptr, used < size ? used : size);
+    allocator->free_fn(ptr, allocator->user_data);
+    return grown;
+}
+
+void tc_mem_free(const TypecastAllocator* allocator, void* ptr) {
+    if (!ptr) return;
+    if (!uses_custom(allocator)) {
+        free(ptr);
+        return;
+    }
+    allocator->free_fn(ptr, allocator->user_data);
+}
+
+/* ============================================
+ * Response owners
+ * ============================================ */
+
+static TcSideTable owners;  /* response -> TypecastAllocator */
+
+TypecastTTSResponse* tc_tts_response_new(const TypecastAllocator* allocator) {
+    TypecastTTSResponse* response = (TypecastTTSResponse*)calloc(1, sizeof(TypecastTTSResponse));
+    if (!response || !uses_custom(allocator)) return response;
+    TypecastAllocator* owner = (TypecastAllocator*)malloc(sizeof(*owner));
+    if (owner) *owner = *allocator;
+    /* LCOV_EXCL_START */
+    /* category=oom reason="owner entry allocation" */
+    if (!owner || tc_side_put(&owners, response, owner) != 0) {
+        free(owner);
+        free(response);
+        return NULL;
+    }
+    /* LCOV_EXCL_STOP */
+    return response;
+}
+
+void tc_tts_response_release(const TypecastTTSResponse* response, TypecastAllocator* out) {
+    memset(out, 0, sizeof(*out));
+    TypecastAllocator* owner = (TypecastAllocator*)tc_side_take(&owners, response);
+    if (!owner) return;
+    *out = *owner;
+    free(owner);
+}
@@ -0,0 +1,23 @@
+/**
+ * Typecast C/C++ SDK - Memory (typecast_alloc.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_ALLOC_H
+#define TYPECAST_ALLOC_H
+
+#include "typecast_internal.h"
+
+int tc_allocator_valid(const TypecastAllocator* allocator);
+void* tc_mem_alloc(const TypecastAllocator* allocator, size_t size);
+/* `used` bytes are preserved when the allocator has no realloc_fn */
+void* tc_mem_realloc(const TypecastAllocator* allocator, void* ptr, size_t used, size_t size);
+void tc_mem_free(const TypecastAllocator* allocator, void* ptr);
+/* A zeroed response whose audio is owned by `allocator` (NULL = malloc);
+ * NULL on allocation failure */
+TypecastTTSResponse* tc_tts_response_new(const TypecastAllocator* allocator);
+/* Forget the response's owner, which `out` receives (zero when malloc) */
+void tc_tts_response_release(const TypecastTTSResponse* response, TypecastAllocator* out);
+
+#endif /* TYPECAST_ALLOC_H */
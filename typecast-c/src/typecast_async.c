@@ -0,0 +1,358 @@
+/**
+ * Typecast C/C++ SDK - Async engine
+ *
+ * Runs many requests concurrently on a single curl multi handle owned by
+ * the client. Requests are prepared and finished by the same transfer
+ * helpers as the blocking API (see typecast_internal.h), so the async
+ * results are identical to their blocking counterparts. The submit calls
+ * and job accessors are in typecast_async_submit.c.
+ *
+ * With a governor (see typecast_governor.c) a job joins the event loop
+ * only once the governor has a slot for it; until then, and while it
+ * waits to retry a 429 or 5xx, it stays queued in the job list and each
+ * poll looks at it again.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <curl/curl.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_async.h"
+#include "typecast_governor.h"
+#include "typecast_metrics.h"
+
+/* Longest wait of a poll with a job queued for a slot: a blocking call of
+ * another thread may free it without waking the loop */
+#define SLOT_POLL_MS 50
+
+/* ============================================
+ * Job bookkeeping
+ * ============================================ */
+
+static void link_job(TypecastClient* client, TypecastAsyncJob* job) {
+    job->prev = NULL;
+    job->next = client->jobs;
+    if (client->jobs) client->jobs->prev = job;
+    client->jobs = job;
+    client->jobs_running++;
+}
+
+static void unlink_job(TypecastClient* client, TypecastAsyncJob* job) {
+    if (job->prev) job->prev->next = job->next;
+    else client->jobs = job->next;
+    if (job->next) job->next->prev = job->prev;
+    job->prev = job->next = NULL;
+    client->jobs_running--;
+}
+
+/* Remove the job's easy handle from the event loop and release the
+ * transfer. Leaves results and error untouched. */
+void tc_async_job_detach(TypecastAsyncJob* job) {
+    TypecastClient* client = job->client;
+    if (job->holds_slot) {
+        tc_governor_leave(client->governor, job->attempt, 0, 0, NULL);
+        job->holds_slot = 0;
+    }
+    if (job->easy) {
+        if (!job->queued) curl_multi_remove_handle(client->multi, job->easy);
+        curl_easy_cleanup(job->easy);
+        job->easy = NULL;
+        unlink_job(client, job);
+    }
+    tc_transfer_cleanup(&job->transfer);
+}
+
+TypecastAsyncJob* tc_async_job_new(
+    TypecastClient* client,
+    typecast_async_callback_t on_done,
+    void* user_data
+) {
+    TypecastAsyncJob* job = (TypecastAsyncJob*)calloc(1, sizeof(TypecastAsyncJob));
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="calloc OOM; cannot be triggered deterministically" */
+    if (!job) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate async job");
+        return NULL;
+    }
+    /* LCOV_EXCL_STOP */
+    job->client = client;
+    job->on_done = on_done;
+    job->user_data = user_data;
+    return job;
+}
+
+void tc_async_job_discard(TypecastAsyncJob* job) {
+    tc_transfer_cleanup(&job->transfer);
+    tc_error_clear(&job->error);
+    free(job);
+}
+
+static TypecastErrorCode ensure_multi(TypecastClient* client) {
+    if (client->multi) return TYPECAST_OK;
+    client->multi = curl_multi_init();
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="curl_multi_init failure requires libcurl internal OOM" */
+    if (!client->multi) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_CURL_INIT, "Failed to initialize CURL multi handle");
+        return TYPECAST_ERROR_CURL_INIT;
+    }
+    /* LCOV_EXCL_STOP */
+    curl_multi_setopt(client->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    return TYPECAST_OK;
+}
+
+static void wake_at(uint64_t* wake, uint64_t at) {
+    if (!*wake || at < *wake) *wake = at;
+}
+
+/* Add a queued job to the event loop once its retry time has come and the
+ * governor has a slot. 0 while it has to wait (*wake gets the time to
+ * look again), -1 when the multi handle refuses it. */
+static int job_launch(TypecastAsyncJob* job, uint64_t now, uint64_t* wake) {
+    TypecastClient* client = job->client;
+    if (job->start_at > now) {
+        wake_at(wake, job->start_at);
+        return 0;
+    }
+    uint64_t paused_until = 0;
+    if (!tc_governor_try_enter(client->governor, &paused_until)) {
+        wake_at(wake, paused_until ? paused_until : now + SLOT_POLL_MS);
+        return 0;
+    }
+    job->holds_slot = client->governor != NULL;
+    tc_transfer_apply(job->easy, &job->transfer);
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="curl_multi_add_handle only fails on OOM or misuse of a fresh handle" */
+    if (curl_multi_add_handle(client->multi, job->easy) != CURLM_OK) return -1;
+    /* LCOV_EXCL_STOP */
+    job->queued = 0;
+    return 1;
+}
+
+/* Hand a prepared job to the event loop. Consumes the job on failure. */
+TypecastAsyncJob* tc_async_job_start(TypecastAsyncJob* job) {
+    TypecastClient* client = job->client;
+    if (ensure_multi(client) != TYPECAST_OK) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="only fails on OOM" */
+        tc_async_job_discard(job);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    CURL* easy = curl_easy_init();
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="curl_easy_init failure requires libcurl internal OOM" */
+    if (!easy) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_CURL_INIT, "Failed to initialize CURL");
+        tc_async_job_discard(job);
+        return NULL;
+    }
+    /* LCOV_EXCL_STOP */
+
+    tc_client_configure_handle(client, easy);
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, job);
+    /* HTTP/2 is negotiated over TLS (see the client's http_version).
+     * Waiting for a connection that can multiplex only pays off for https;
+     * plain http stays HTTP/1.1 and needs one connection per job. */
+    if (strncmp(job->transfer.url, "https://", 8) == 0) {
+        curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+    }
+
+    job->easy = easy;
+    job->queued = 1;
+    link_job(client, job);
+    uint64_t wake = 0;
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="curl_multi_add_handle only fails on OOM or misuse of a fresh handle" */
+    if (job_launch(job, tc_monotonic_ms(), &wake) < 0) {
+        tc_async_job_detach(job);
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_CURL_INIT, "Failed to start async request");
+        tc_async_job_discard(job);
+        return NULL;
+    }
+    /* LCOV_EXCL_STOP */
+    return job;
+}
+
+/* Release the job's slot with its outcome. When the governor retries the
+ * answer, the job is queued again for its back-off time and 1 returned. */
+static int job_retry(TypecastAsyncJob* job, CURLcode result) {
+    TypecastClient* client = job->client;
+    if (!job->holds_slot) return 0;
+    job->holds_slot = 0;
+    long http_code = 0;
+    if (result == CURLE_OK) curl_easy_getinfo(job->easy, CURLINFO_RESPONSE_CODE, &http_code);
+    /* A stream hands error bodies to the caller's callback */
+    long delay = tc_governor_leave(client->governor, job->attempt, job->transfer.kind != TC_REQUEST_STREAM,
+        http_code, job->transfer.response_headers.data);
+    if (delay < 0) return 0;
+    uint64_t at = tc_monotonic_ms() + (uint64_t)delay;
+    TcCallSettings* call = &job->transfer.call;
+    if ((call->deadline && at >= call->deadline) || typecast_cancel_token_is_cancelled(call->cancel)) return 0;
+
+    tc_trace_attempt(&job->transfer.trace, job->easy);
+    curl_multi_remove_handle(client->multi, job->easy);
+    tc_transfer_rewind(&job->transfer);
+    job->attempt++;
+    job->start_at = at;
+    job->queued = 1;
+    return 1;
+}
+
+static void job_complete(TypecastAsyncJob* job, CURLcode result) {
+    if (!job->queued) tc_trace_attempt(&job->transfer.trace, job->easy);
+    switch (job->transfer.kind) {
+        case TC_REQUEST_STREAM:
+            job->result = tc_transfer_finish_stream(&job->transfer, job->easy, result, &job->error);
+            break;
+        case TC_REQUEST_TIMESTAMPS:
+            job->result = tc_transfer_finish_timestamps(&job->transfer, job->easy, result,
+                &job->timestamps_response, &job->error);
+            break;
+        case TC_REQUEST_TTS:
+        case TC_REQUEST_COMPOSE:
+        default:
+            job->tts_response = tc_transfer_finish_tts(&job->transfer, job->easy, result, &job->error);
+            job->result = job->tts_response ? TYPECAST_OK : job->error.code;
+            break;
+    }
+    tc_trace_end(job->client, &job->transfer.trace, job->result);
+    tc_async_job_detach(job);
+    job->done = 1;
+}
+
+/* ============================================
+ * Event loop
+ * ============================================ */
+
+static void job_finish(TypecastAsyncJob* job, CURLcode result) {
+    job_complete(job, result);
+    if (job->on_done) job->on_done(job, job->user_data);
+}
+
+/* Start the queued jobs the governor lets through and end those cancelled
+ * or past their deadline while queued. Returns when to look again, 0 when
+ * nothing is left waiting. Only a governed client queues jobs. */
+static uint64_t start_queued(TypecastClient* client) {
+    if (!client->governor) return 0;
+    uint64_t now = tc_monotonic_ms();
+    uint64_t wake = 0;
+    TypecastAsyncJob* job = client->jobs;
+    while (job) {
+        TypecastAsyncJob* next = job->next;
+        TcCallSettings* call = &job->transfer.call;
+        CURLcode failed = CURLE_OK;
+        if (job->queued) {
+            if (call->deadline && now >= call->deadline) call->expired = 1;
+            if (call->expired || typecast_cancel_token_is_cancelled(call->cancel)) {
+                failed = CURLE_ABORTED_BY_CALLBACK;
+            } else if (job_launch(job, now, &wake) < 0) {
+                failed = CURLE_FAILED_INIT; /* LCOV_EXCL_LINE category=unreachable reason="see job_launch" */
+            }
+        }
+        if (failed == CURLE_OK) {
+            job = next;
+            continue;
+        }
+        job_finish(job, failed);
+        /* on_done may have freed or added jobs: start over */
+        job = client->jobs;
+    }
+    return wake;
+}
+
+TYPECAST_API TypecastErrorCode typecast_async_poll(
+    TypecastClient* client,
+    int timeout_ms,
+    size_t* out_running
+) {
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    if (out_running) *out_running = client->jobs_running;
+    if (!client->multi || client->jobs_running == 0) return TYPECAST_OK;
+
+    uint64_t wake = start_queued(client);
+    int still_running = 0;
+    CURLMcode mc = curl_multi_perform(client->multi, &still_running);
+    if (mc == CURLM_OK && (still_running > 0 || wake) && timeout_ms > 0) {
+        uint64_t now = tc_monotonic_ms();
+        int wait_ms = timeout_ms;
+        if (wake) {
+            uint64_t left = wake > now ? wake - now : 0;
+            if (left < (uint64_t)wait_ms) wait_ms = (int)left;
+        }
+        mc = curl_multi_poll(client->multi, NULL, 0, wait_ms, NULL);
+        if (mc == CURLM_OK) mc = curl_multi_perform(client->multi, &still_running);
+    }
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="curl_multi_perform/poll only fail on OOM or handle misuse" */
+    if (mc != CURLM_OK) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_NETWORK, curl_multi_strerror(mc));
+        return TYPECAST_ERROR_NETWORK;
+    }
+    /* LCOV_EXCL_STOP */
+
+    CURLMsg* msg;
+    int queued = 0;
+    while ((msg = curl_multi_info_read(client->multi, &queued)) != NULL) {
+        if (msg->msg != CURLMSG_DONE) continue; /* LCOV_EXCL_LINE category=unreachable reason="CURLMSG_DONE is the only message type libcurl emits" */
+        CURLcode result = msg->data.result;
+        TypecastAsyncJob* job = NULL;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**)&job);
+        if (job_retry(job, result)) continue;
+        job_finish(job, result);
+    }
+    /* Slots the finished jobs freed */
+    start_queued(client);
+
+    if (out_running) *out_running = client->jobs_running;
+    return TYPECAST_OK;
+}
+
+TYPECAST_API TypecastErrorCode typecast_async_wakeup(TypecastClient* client) {
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    /* No multi handle yet means no job, so nobody is waiting in poll */
+    CURLM* multi = client->multi;
+    if (!multi) return TYPECAST_OK;
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="curl_multi_wakeup only fails when the wakeup socket pair is broken" */
+    if (curl_multi_wakeup(multi) != CURLM_OK) return TYPECAST_ERROR_NETWORK;
+    /* LCOV_EXCL_STOP */
+    return TYPECAST_OK;
+}
+
+TYPECAST_API TypecastErrorCode typecast_async_wait(
+    TypecastClient* client,
+    TypecastAsyncJob* job
+) {
+    if (!client || !job) return TYPECAST_ERROR_INVALID_PARAM;
+    if (!job->done && job->client != client) return TYPECAST_ERROR_INVALID_PARAM;
+    while (!job->done) {
+        TypecastErrorCode err = typecast_async_poll(client, 1000, NULL);
+        if (err != TYPECAST_OK) return err; /* LCOV_EXCL_LINE category=unreachable reason="multi errors only on OOM or handle misuse" */
+    }
+    return job->result;
+}
+
+void tc_async_shutdown(TypecastClient* client) {
+    while (client->jobs) {
+        TypecastAsyncJob* job = client->jobs;
+        tc_async_job_detach(job);
+        job->result = TYPECAST_ERROR_NETWORK;
+        tc_error_set(&job->error, TYPECAST_ERROR_NETWORK, "Client destroyed before the request completed");
+        job->done = 1;
+        job->client = NULL;
+    }
+    if (client->multi) {
+        curl_multi_cleanup(client->multi);
+        client->multi = NULL;
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ * Typecast C/C++ SDK - Async engine (typecast_async.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_ASYNC_H
+#define TYPECAST_ASYNC_H
+
+#include "typecast_internal.h"
+#include "typecast_file.h"
+
+struct TypecastAsyncJob {
+    TypecastClient* client;
+    CURL* easy;
+    TcTransfer transfer;
+    int done;
+    int queued;                      /* not yet (or no longer) on the multi handle */
+    int holds_slot;                  /* entered the governor */
+    unsigned int attempt;
+    uint64_t start_at;               /* tc_monotonic_ms() of the next attempt */
+    TypecastErrorCode result;
+    TypecastError error;
+    TypecastTTSResponse* tts_response;
+    TypecastTTSWithTimestampsResponse* timestamps_response;
+    typecast_async_callback_t on_done;
+    void* user_data;
+    TypecastAsyncJob* prev;
+    TypecastAsyncJob* next;
+};
+
+/* A zeroed job of `client`; NULL (with the client's error set) on OOM */
+TypecastAsyncJob* tc_async_job_new(TypecastClient* client, typecast_async_callback_t on_done, void* user_data);
+/* Free a job that is off the event loop */
+void tc_async_job_discard(TypecastAsyncJob* job);
+/* Hand a prepared job to the event loop. Consumes the job on failure. */
+TypecastAsyncJob* tc_async_job_start(TypecastAsyncJob* job);
+/* Take the job off the event loop and release its transfer, leaving
+ * results and error untouched */
+void tc_async_job_detach(TypecastAsyncJob* job);
+
+void tc_async_shutdown(TypecastClient* client);
+
+/* Submit a TTS request whose body is written to `sink` as it arrives.
+ * The sink must outlive the job. */
+TypecastAsyncJob* tc_async_text_to_sink(TypecastClient* client, const TypecastTTSRequest* request,
+    TcFileSink* sink, typecast_async_callback_t on_done, void* user_data);
+
+#endif /* TYPECAST_ASYNC_H */
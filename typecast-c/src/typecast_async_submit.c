@@ -0,0 +1,196 @@
+/**
+ * Typecast C/C++ SDK - Async submission and job accessors
+ *
+ * Each submit call validates its request, prepares the transfer exactly
+ * as the blocking call would and hands the job to the event loop in
+ * typecast_async.c.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_async.h"
+#include "typecast_file.h"
+
+/* ============================================
+ * Submission
+ * ============================================ */
+
+static int validate_submit(TypecastClient* client, const void* request, const char* text, const char* voice_id) {
+    if (!client) return 0;
+    if (!request) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return 0;
+    }
+    if (!text || !voice_id) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "text and voice_id are required");
+        return 0;
+    }
+    tc_error_clear(tc_client_error(client));
+    return 1;
+}
+
+TYPECAST_API TypecastAsyncJob* typecast_async_text_to_speech(
+    TypecastClient* client,
+    const TypecastTTSRequest* request,
+    typecast_async_callback_t on_done,
+    void* user_data
+) {
+    if (!validate_submit(client, request, request ? request->text : NULL,
+                         request ? request->voice_id : NULL)) {
+        return NULL;
+    }
+    TypecastAsyncJob* job = tc_async_job_new(client, on_done, user_data);
+    if (!job) return NULL; /* LCOV_EXCL_LINE category=unreachable reason="calloc OOM" */
+    if (tc_transfer_prepare_tts(client, request, &job->transfer, tc_client_error(client)) != TYPECAST_OK) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="only fails on OOM" */
+        tc_async_job_discard(job);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    return tc_async_job_start(job);
+}
+
+TYPECAST_API TypecastAsyncJob* typecast_async_text_to_speech_with_timestamps(
+    TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request,
+    typecast_async_callback_t on_done,
+    void* user_data
+) {
+    if (!validate_submit(client, request, request ? request->text : NULL,
+                         request ? request->voice_id : NULL)) {
+        return NULL;
+    }
+    TypecastAsyncJob* job = tc_async_job_new(client, on_done, user_data);
+    if (!job) return NULL; /* LCOV_EXCL_LINE category=unreachable reason="calloc OOM" */
+    if (tc_transfer_prepare_timestamps(client, request, &job->transfer, tc_client_error(client)) != TYPECAST_OK) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="only fails on OOM" */
+        tc_async_job_discard(job);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    return tc_async_job_start(job);
+}
+
+TYPECAST_API TypecastAsyncJob* typecast_async_text_to_speech_stream(
+    TypecastClient* client,
+    const TypecastTTSRequestStream* request,
+    typecast_stream_callback_t on_chunk,
+    typecast_async_callback_t on_done,
+    void* user_data
+) {
+    if (client && !on_chunk) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return NULL;
+    }
+    if (!validate_submit(client, request, request ? request->text : NULL,
+                         request ? request->voice_id : NULL)) {
+        return NULL;
+    }
+    TypecastAsyncJob* job = tc_async_job_new(client, on_done, user_data);
+    if (!job) return NULL; /* LCOV_EXCL_LINE category=unreachable reason="calloc OOM" */
+    if (tc_transfer_prepare_stream(client, request, on_chunk, user_data,
+                                   &job->transfer, tc_client_error(client)) != TYPECAST_OK) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="only fails on OOM" */
+        tc_async_job_discard(job);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    return tc_async_job_start(job);
+}
+
+TYPECAST_API TypecastAsyncJob* typecast_async_speech_composer_generate(
+    TypecastSpeechComposer* composer,
+    TypecastAudioFormat output_format,
+    typecast_async_callback_t on_done,
+    void* user_data
+) {
+    if (!composer) return NULL;
+    TypecastClient* client = tc_composer_client(composer);
+    tc_error_clear(tc_client_error(client));
+    TypecastAsyncJob* job = tc_async_job_new(client, on_done, user_data);
+    if (!job) return NULL; /* LCOV_EXCL_LINE category=unreachable reason="calloc OOM" */
+    /* The plan is serialized here; the composer may change or go away afterwards */
+    if (tc_transfer_prepare_composer(composer, output_format, &job->transfer) != TYPECAST_OK) {
+        tc_async_job_discard(job);
+        return NULL;
+    }
+    return tc_async_job_start(job);
+}
+
+TypecastAsyncJob* tc_async_text_to_sink(
+    TypecastClient* client,
+    const TypecastTTSRequest* request,
+    TcFileSink* sink,
+    typecast_async_callback_t on_done,
+    void* user_data
+) {
+    if (!validate_submit(client, request, request ? request->text : NULL,
+                         request ? request->voice_id : NULL)) {
+        return NULL;
+    }
+    TypecastAsyncJob* job = tc_async_job_new(client, on_done, user_data);
+    if (!job) return NULL; /* LCOV_EXCL_LINE category=unreachable reason="calloc OOM" */
+    if (tc_transfer_prepare_tts(client, request, &job->transfer, tc_client_error(client)) != TYPECAST_OK) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="only fails on OOM" */
+        tc_async_job_discard(job);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    sink->transfer = &job->transfer;
+    job->transfer.sink_write = tc_file_sink_write;
+    job->transfer.sink_data = sink;
+    return tc_async_job_start(job);
+}
+
+/* ============================================
+ * Job accessors
+ * ============================================ */
+
+TYPECAST_API int typecast_async_job_is_done(const TypecastAsyncJob* job) {
+    return job ? job->done : 0;
+}
+
+TYPECAST_API TypecastErrorCode typecast_async_job_result(const TypecastAsyncJob* job) {
+    if (!job) return TYPECAST_ERROR_INVALID_PARAM;
+    return job->done ? job->result : TYPECAST_OK;
+}
+
+TYPECAST_API const TypecastError* typecast_async_job_error(const TypecastAsyncJob* job) {
+    return job ? &job->error : NULL;
+}
+
+TYPECAST_API TypecastTTSResponse* typecast_async_job_take_tts_response(TypecastAsyncJob* job) {
+    if (!job || !job->done) return NULL;
+    TypecastTTSResponse* response = job->tts_response;
+    job->tts_response = NULL;
+    return response;
+}
+
+TYPECAST_API TypecastTTSWithTimestampsResponse* typecast_async_job_take_timestamps_response(
+    TypecastAsyncJob* job
+) {
+    if (!job || !job->done) return NULL;
+    TypecastTTSWithTimestampsResponse* response = job->timestamps_response;
+    job->timestamps_response = NULL;
+    return response;
+}
+
+TYPECAST_API void typecast_async_job_free(TypecastAsyncJob* job) {
+    if (!job) return;
+    if (!job->done) tc_async_job_detach(job);
+    typecast_tts_response_free(job->tts_response);
+    typecast_tts_with_timestamps_response_free(job->timestamps_response);
+    tc_async_job_discard(job);
+}
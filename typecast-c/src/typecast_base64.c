@@ -0,0 +1,302 @@
+/**
+ * Typecast C/C++ SDK - Base64 decoding
+ *
+ * Timestamp responses carry the whole audio as base64, so decoding is a
+ * visible share of CPU time for long renders. Whole strings are decoded
+ * with SIMD where the CPU supports it (AVX2 or SSSE3, chosen at runtime on
+ * x86 with GCC/Clang; NEON on ARM builds that enable it) and a scalar loop
+ * otherwise. The SIMD kernels only take blocks of plain alphabet
+ * characters and leave anything else (padding, invalid input) to the
+ * scalar code, so every path gives the same result.
+ *
+ * The incremental decoder handles text that arrives in arbitrary pieces,
+ * carrying a partial quad between calls, so audio can be decoded while the
+ * response body is still being received.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_base64.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define TC_BASE64_X86 1
+    #include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define TC_BASE64_NEON 1
+    #include <arm_neon.h>
+#endif
+
+/* Decodes whole 4-character groups from the start of src and stops at the
+ * first block it cannot take. Returns the characters consumed (3 output
+ * bytes per group). out must have room for len / 4 * 3 bytes; a kernel may
+ * write scratch bytes past its decoded output within that room. */
+typedef size_t (*BlockDecoder)(const unsigned char* src, size_t len, uint8_t* out);
+
+static const signed char B64_TABLE[256] = {
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,62, -1,-1,-1,63,
+    52,53,54,55, 56,57,58,59, 60,61,-1,-1, -1, 0,-1,-1,
+    -1, 0, 1, 2,  3, 4, 5, 6,  7, 8, 9,10, 11,12,13,14,
+    15,16,17,18, 19,20,21,22, 23,24,25,-1, -1,-1,-1,-1,
+    -1,26,27,28, 29,30,31,32, 33,34,35,36, 37,38,39,40,
+    41,42,43,44, 45,46,47,48, 49,50,51,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1
+};
+
+/* ============================================
+ * SIMD kernels
+ * ============================================ */
+
+#if defined(TC_BASE64_X86)
+
+/* Character classes by low / high nibble: a character is valid when the
+ * two lookups share no bit. The roll table maps each class to the offset
+ * that turns the character into its 6-bit value ('/' shares the high
+ * nibble of '+' and is told apart by an equality test). */
+#define TC_B64_LUT_LO 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, \
+                      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+#define TC_B64_LUT_HI 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, \
+                      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+#define TC_B64_LUT_ROLL 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+#define TC_B64_PACK 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+
+__attribute__((target("ssse3")))
+static size_t decode_ssse3(const unsigned char* src, size_t len, uint8_t* out) {
+    const __m128i lut_lo = _mm_setr_epi8(TC_B64_LUT_LO);
+    const __m128i lut_hi = _mm_setr_epi8(TC_B64_LUT_HI);
+    const __m128i lut_roll = _mm_setr_epi8(TC_B64_LUT_ROLL);
+    const __m128i pack = _mm_setr_epi8(TC_B64_PACK);
+    const __m128i mask_2f = _mm_set1_epi8(0x2F);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    uint8_t* o = out;
+    while (len - i >= 24) {
+        __m128i in = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+        __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(in, mask_2f));
+        __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero)) != 0xFFFF) break;
+
+        __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(in, mask_2f), hi_nibbles));
+        __m128i values = _mm_add_epi8(in, roll);
+        /* Merge 4 x 6 bits into 24 bits per lane, then drop the top byte */
+        __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128((__m128i*)o, _mm_shuffle_epi8(merged, pack));
+        i += 16;
+        o += 12;
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t decode_avx2(const unsigned char* src, size_t len, uint8_t* out) {
+    const __m256i lut_lo = _mm256_setr_epi8(TC_B64_LUT_LO, TC_B64_LUT_LO);
+    const __m256i lut_hi = _mm256_setr_epi8(TC_B64_LUT_HI, TC_B64_LUT_HI);
+    const __m256i lut_roll = _mm256_setr_epi8(TC_B64_LUT_ROLL, TC_B64_LUT_ROLL);
+    const __m256i pack = _mm256_setr_epi8(TC_B64_PACK, TC_B64_PACK);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    uint8_t* o = out;
+    while (len - i >= 48) {
+        __m256i in = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2f);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(in, mask_2f));
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), zero)) != -1) break;
+
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, mask_2f), hi_nibbles));
+        __m256i values = _mm256_add_epi8(in, roll);
+        __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        /* 12 bytes per 128-bit lane; close the gap between the lanes */
+        merged = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, pack), lanes);
+        _mm256_storeu_si256((__m256i*)o, merged);
+        i += 32;
+        o += 24;
+    }
+    return i;
+}
+
+#elif defined(TC_BASE64_NEON)
+
+static uint8x16_t neon_values(uint8x16_t c, uint8x16_t* invalid) {
+    uint8x16_t upper = vsubq_u8(c, vdupq_n_u8('A'));
+    uint8x16_t lower = vsubq_u8(c, vdupq_n_u8('a'));
+    uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t is_upper = vcltq_u8(upper, vdupq_n_u8(26));
+    uint8x16_t is_lower = vcltq_u8(lower, vdupq_n_u8(26));
+    uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10));
+    uint8x16_t is_plus = vceqq_u8(c, vdupq_n_u8('+'));
+    uint8x16_t is_slash = vceqq_u8(c, vdupq_n_u8('/'));
+
+    uint8x16_t v = vandq_u8(is_upper, upper);
+    v = vorrq_u8(v, vandq_u8(is_lower, vaddq_u8(lower, vdupq_n_u8(26))));
+    v = vorrq_u8(v, vandq_u8(is_digit, vaddq_u8(digit, vdupq_n_u8(52))));
+    v = vorrq_u8(v, vandq_u8(is_plus, vdupq_n_u8(62)));
+    v = vorrq_u8(v, vandq_u8(is_slash, vdupq_n_u8(63)));
+
+    uint8x16_t valid = vorrq_u8(vorrq_u8(is_upper, is_lower), vorrq_u8(is_digit, vorrq_u8(is_plus, is_slash)));
+    *invalid = vorrq_u8(*invalid, vmvnq_u8(valid));
+    return v;
+}
+
+static int neon_any(uint8x16_t v) {
+#if defined(__aarch64__)
+    return vmaxvq_u8(v) != 0;
+#else
+    uint8x8_t m = vorr_u8(vget_low_u8(v), vget_high_u8(v));
+    m = vpmax_u8(m, m);
+    m = vpmax_u8(m, m);
+    m = vpmax_u8(m, m);
+    return vget_lane_u8(m, 0) != 0;
+#endif
+}
+
+static size_t decode_neon(const unsigned char* src, size_t len, uint8_t* out) {
+    size_t i = 0;
+    uint8_t* o = out;
+    while (len - i >= 64) {
+        /* De-interleave so each register holds one position of the quads */
+        uint8x16x4_t in = vld4q_u8(src + i);
+        uint8x16_t invalid = vdupq_n_u8(0);
+        uint8x16_t a = neon_values(in.val[0], &invalid);
+        uint8x16_t b = neon_values(in.val[1], &invalid);
+        uint8x16_t c = neon_values(in.val[2], &invalid);
+        uint8x16_t d = neon_values(in.val[3], &invalid);
+        if (neon_any(invalid)) break;
+
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+        vst3q_u8(o, bytes);
+        i += 64;
+        o += 48;
+    }
+    return i;
+}
+
+#endif
+
+static BlockDecoder block_decoder(void) {
+#if defined(TC_BASE64_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return decode_avx2;
+    if (__builtin_cpu_supports("ssse3")) return decode_ssse3;
+    return NULL; /* LCOV_EXCL_LINE category=platform reason="x86 CPUs without SSSE3 predate 2006" */
+#elif defined(TC_BASE64_NEON)
+    return decode_neon;
+#else
+    return NULL;
+#endif
+}
+
+/* ============================================
+ * Whole strings
+ * ============================================ */
+
+int tc_base64_decode(const char* src, size_t len, uint8_t* out, size_t* out_len) {
+    size_t padding = 0;
+    if (len >= 1 && src[len - 1] == '=') padding++;
+    if (len >= 2 && src[len - 2] == '=') padding++;
+    if ((len / 4) * 3 < padding) return -1;
+
+    size_t i = 0;
+    size_t j = 0;
+    BlockDecoder simd = block_decoder();
+    if (simd) {
+        i = simd((const unsigned char*)src, len, out);
+        j = i / 4 * 3;
+    }
+
+    /* Tail, padding, and whatever stopped the SIMD kernel */
+    for (; i + 3 < len; i += 4) {
+        signed char a = B64_TABLE[(unsigned char)src[i]];
+        signed char b = B64_TABLE[(unsigned char)src[i+1]];
+        signed char c = B64_TABLE[(unsigned char)src[i+2]];
+        signed char d = B64_TABLE[(unsigned char)src[i+3]];
+
+        if (a < 0 || b < 0) return -1;
+
+        out[j++] = (uint8_t)((a << 2) | (b >> 4));
+        if (src[i+2] != '=') {
+            if (c < 0) return -1;
+            out[j++] = (uint8_t)((b << 4) | (c >> 2));
+        }
+        if (src[i+3] != '=') {
+            if (d < 0) return -1;
+            out[j++] = (uint8_t)((c << 6) | d);
+        }
+    }
+    *out_len = j;
+    return 0;
+}
+
+/* ============================================
+ * Incremental
+ * ============================================ */
+
+/* Decode the complete (or final partial) quad; returns the byte count */
+static size_t emit_quad(TcBase64Stream* s, uint8_t* out) {
+    out[0] = (uint8_t)((s->quad[0] << 2) | (s->quad[1] >> 4));
+    out[1] = (uint8_t)((s->quad[1] << 4) | (s->quad[2] >> 2));
+    out[2] = (uint8_t)((s->quad[2] << 6) | s->quad[3]);
+    size_t n = (size_t)s->quad_len - 1;
+    s->quad_len = 0;
+    memset(s->quad, 0, sizeof(s->quad));
+    return n;
+}
+
+int tc_base64_stream_update(TcBase64Stream* s, const unsigned char* in, size_t len,
+    uint8_t* out, size_t* out_len) {
+    BlockDecoder simd = block_decoder();
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        /* Between quads, let the SIMD kernel take the next clean run */
+        if (simd && s->quad_len == 0 && !s->padding) {
+            size_t used = simd(in + i, len - i, out + n);
+            n += used / 4 * 3;
+            i += used;
+            if (i == len) break;
+        }
+        unsigned char c = in[i];
+        if (c == '\n' || c == '\r' || c == ' ' || c == '\t') continue;
+        if (c == '=') {
+            s->padding = 1;
+            continue;
+        }
+        int v = B64_TABLE[c];
+        if (v < 0 || s->padding) return -1;
+        s->quad[s->quad_len++] = (unsigned char)v;
+        if (s->quad_len == 4) n += emit_quad(s, out + n);
+    }
+    *out_len = n;
+    return 0;
+}
+
+int tc_base64_stream_final(TcBase64Stream* s, uint8_t* out, size_t* out_len) {
+    *out_len = 0;
+    if (s->quad_len == 0) return 0;
+    if (s->quad_len < 2) return -1;
+    *out_len = emit_quad(s, out);
+    return 0;
+}
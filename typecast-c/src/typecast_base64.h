@@ -0,0 +1,33 @@
+/**
+ * Typecast C/C++ SDK - Base64 (typecast_base64.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BASE64_H
+#define TYPECAST_BASE64_H
+
+#include "typecast_internal.h"
+
+/* Decode `len` characters of src. out must hold len / 4 * 3 bytes. Returns
+ * -1 on invalid input. */
+int tc_base64_decode(const char* src, size_t len, uint8_t* out, size_t* out_len);
+
+/* Zero-initialize before the first update */
+typedef struct {
+    unsigned char quad[4];
+    int quad_len;
+    int padding;                     /* '=' seen; only whitespace may follow */
+} TcBase64Stream;
+
+/* Worst-case output of one update call for `len` input bytes */
+#define TC_BASE64_STREAM_BOUND(len) (((len) / 4 + 1) * 3)
+
+/* Decode `in`, carrying an incomplete quad over to the next call.
+ * Whitespace is skipped. Returns -1 on invalid input. */
+int tc_base64_stream_update(TcBase64Stream* stream, const unsigned char* in, size_t len,
+    uint8_t* out, size_t* out_len);
+/* Flush the final partial quad (at most 2 bytes) */
+int tc_base64_stream_final(TcBase64Stream* stream, uint8_t* out, size_t* out_len);
+
+#endif /* TYPECAST_BASE64_H */
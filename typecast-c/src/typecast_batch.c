@@ -0,0 +1,429 @@
+/**
+ * Typecast C/C++ SDK - Batch generation to files
+ *
+ * Renders many outputs on the client's async engine with a bounded number
+ * of requests in flight. Each output is streamed into a temporary file and
+ * renamed into place like typecast_generate_to_file(), so a file at the
+ * destination path is always complete; that is what lets an interrupted
+ * batch resume by skipping the outputs that already exist.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_async.h"
+#include "typecast_file.h"
+#include "cJSON.h"
+
+#define DEFAULT_MAX_IN_FLIGHT 4
+#define POLL_INTERVAL_MS 100
+
+/* One running item */
+typedef struct {
+    TypecastAsyncJob* job;           /* NULL when the slot is free */
+    size_t index;
+    FILE* file;
+    TcFileSink sink;
+    char temp_path[4096];
+} Slot;
+
+typedef struct {
+    TypecastClient* client;
+    const TypecastBatchItem* items;
+    int overwrite;
+    typecast_batch_callback_t on_item;
+    void* user_data;
+    TypecastBatchSummary summary;
+    TypecastError first_error;       /* first failed item */
+} Batch;
+
+static void report(Batch* batch, size_t index, TypecastBatchItemStatus status, const TypecastError* error) {
+    switch (status) {
+        case TYPECAST_BATCH_ITEM_WRITTEN: batch->summary.written++; break;
+        case TYPECAST_BATCH_ITEM_SKIPPED: batch->summary.skipped++; break;
+        case TYPECAST_BATCH_ITEM_FAILED:
+        default:
+            batch->summary.failed++;
+            if (batch->first_error.code == TYPECAST_OK) {
+                tc_error_set(&batch->first_error, error->code, error->message);
+            }
+            break;
+    }
+    if (batch->on_item) {
+        batch->on_item(index, batch->items[index].path, status,
+            status == TYPECAST_BATCH_ITEM_FAILED ? error : NULL, batch->user_data);
+    }
+}
+
+static void report_failure(Batch* batch, size_t index, TypecastErrorCode code, const char* message) {
+    TypecastError error = {0};
+    tc_error_set(&error, code, message);
+    report(batch, index, TYPECAST_BATCH_ITEM_FAILED, &error);
+    tc_error_clear(&error);
+}
+
+static uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Outputs are only ever renamed into place once complete, so any
+ * non-empty file counts; a WAV must also hold the length its header
+ * declares, which catches files truncated by other writers. */
+static int output_is_complete(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+    uint8_t header[12];
+    size_t got = fread(header, 1, sizeof(header), file);
+    long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    fclose(file);
+    if (got == 0 || size <= 0) return 0;
+    if (got < 4 || memcmp(header, "RIFF", 4) != 0) return 1;
+    if (got < sizeof(header) || memcmp(header + 8, "WAVE", 4) != 0) return 0;
+    uint32_t riff_size = read_le32(header + 4);
+    return riff_size == 0xFFFFFFFFu || (uint64_t)riff_size + 8 <= (uint64_t)size;
+}
+
+/* Start item `index` in `slot`, or report it right away when it is
+ * skipped or cannot be started */
+static void start_item(Batch* batch, Slot* slot, size_t index) {
+    const TypecastBatchItem* item = &batch->items[index];
+    if (tc_is_blank_string(item->path) || tc_is_blank_string(item->request.text) ||
+        tc_is_blank_string(item->request.voice_id)) {
+        report_failure(batch, index, TYPECAST_ERROR_INVALID_PARAM, "path, text and voice_id are required");
+        return;
+    }
+    if (!batch->overwrite && output_is_complete(item->path)) {
+        report(batch, index, TYPECAST_BATCH_ITEM_SKIPPED, NULL);
+        return;
+    }
+    if (!tc_preflight_output_path(item->path, slot->temp_path, sizeof(slot->temp_path))) {
+        report_failure(batch, index, TYPECAST_ERROR_INVALID_PARAM, "Invalid or unwritable output file");
+        return;
+    }
+    slot->file = fopen(slot->temp_path, "wb");
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="preflight already verified temp output writability" */
+    if (!slot->file) {
+        report_failure(batch, index, TYPECAST_ERROR_INVALID_PARAM, "Failed to open output file");
+        return;
+    }
+    /* LCOV_EXCL_STOP */
+
+    TypecastTTSRequest tts_request;
+    TypecastOutput inferred_output;
+    tc_generate_request_to_tts(&item->request, item->path, &tts_request, &inferred_output);
+    memset(&slot->sink, 0, sizeof(slot->sink));
+    slot->sink.file = slot->file;
+    slot->sink.fd = -1;
+    slot->index = index;
+    slot->job = tc_async_text_to_sink(batch->client, &tts_request, &slot->sink, NULL, NULL);
+    if (!slot->job) {
+        /* LCOV_EXCL_START */
+        /* category=oom reason="async submission only fails on allocation for a validated request" */
+        fclose(slot->file);
+        remove(slot->temp_path);
+        const TypecastError* error = typecast_client_get_error(batch->client);
+        report_failure(batch, index, error->code, error->message);
+        /* LCOV_EXCL_STOP */
+    }
+}
+
+static void finish_item(Batch* batch, Slot* slot) {
+    TypecastAsyncJob* job = slot->job;
+    TypecastErrorCode err = typecast_async_job_result(job);
+    const char* message = typecast_async_job_error(job)->message;
+    int close_result = fclose(slot->file);
+    if (slot->sink.write_failed || (err == TYPECAST_OK && close_result != 0)) {
+        err = TYPECAST_ERROR_NETWORK;
+        message = "Failed to write output file";
+    }
+    if (err == TYPECAST_OK && !tc_output_move_into_place(slot->temp_path, batch->items[slot->index].path)) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="see tc_output_move_into_place" */
+        err = TYPECAST_ERROR_NETWORK;
+        message = "Failed to move output file into place";
+        /* LCOV_EXCL_STOP */
+    } else if (err != TYPECAST_OK) {
+        remove(slot->temp_path);
+    }
+
+    if (err == TYPECAST_OK) report(batch, slot->index, TYPECAST_BATCH_ITEM_WRITTEN, NULL);
+    else report_failure(batch, slot->index, err, message);
+    typecast_async_job_free(job);
+    slot->job = NULL;
+    slot->file = NULL;
+}
+
+/* Cancel a running item and drop its temporary file */
+static void abandon_item(Slot* slot) {
+    typecast_async_job_free(slot->job);
+    fclose(slot->file);
+    remove(slot->temp_path);
+    slot->job = NULL;
+    slot->file = NULL;
+}
+
+TYPECAST_API TypecastErrorCode typecast_generate_batch(
+    TypecastClient* client,
+    const TypecastBatchItem* items,
+    size_t count,
+    const TypecastBatchOptions* options,
+    typecast_batch_callback_t on_item,
+    void* user_data,
+    TypecastBatchSummary* out_summary
+) {
+    if (out_summary) memset(out_summary, 0, sizeof(*out_summary));
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    TypecastError* error = tc_client_error(client);
+    if (!items && count > 0) {
+        tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    tc_error_clear(error);
+    if (count == 0) return TYPECAST_OK;
+
+    size_t max_in_flight = options && options->max_in_flight > 0 ? options->max_in_flight : DEFAULT_MAX_IN_FLIGHT;
+    if (max_in_flight > count) max_in_flight = count;
+    int stop_on_error = options && options->stop_on_error;
+    Slot* slots = (Slot*)calloc(max_in_flight, sizeof(Slot));
+    /* LCOV_EXCL_START */
+    /* category=oom reason="slot array allocation" */
+    if (!slots) {
+        tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate batch slots");
+        return TYPECAST_ERROR_OUT_OF_MEMORY;
+    }
+    /* LCOV_EXCL_STOP */
+
+    Batch batch = {0};
+    batch.client = client;
+    batch.items = items;
+    batch.overwrite = options && options->overwrite;
+    batch.on_item = on_item;
+    batch.user_data = user_data;
+
+    size_t next = 0;
+    TypecastErrorCode err = TYPECAST_OK;
+    for (;;) {
+        size_t running = 0;
+        for (size_t s = 0; s < max_in_flight; s++) {
+            while (!slots[s].job && next < count &&
+                   !(stop_on_error && batch.first_error.code != TYPECAST_OK)) {
+                start_item(&batch, &slots[s], next++);
+            }
+            if (slots[s].job) running++;
+        }
+        if (running == 0) break;
+
+        err = typecast_async_poll(client, POLL_INTERVAL_MS, NULL);
+        if (err != TYPECAST_OK) break; /* LCOV_EXCL_LINE category=unreachable reason="multi errors only on OOM or handle misuse" */
+        for (size_t s = 0; s < max_in_flight; s++) {
+            if (slots[s].job && typecast_async_job_is_done(slots[s].job)) finish_item(&batch, &slots[s]);
+        }
+    }
+    for (size_t s = 0; s < max_in_flight; s++) {
+        if (slots[s].job) abandon_item(&slots[s]); /* LCOV_EXCL_LINE category=unreachable reason="only after a multi error" */
+    }
+    free(slots);
+
+    batch.summary.not_started = count - next;
+    if (out_summary) *out_summary = batch.summary;
+    if (err == TYPECAST_OK && batch.first_error.code != TYPECAST_OK) {
+        err = batch.first_error.code;
+        tc_error_set(error, err, batch.first_error.message);
+    }
+    tc_error_clear(&batch.first_error);
+    return err;
+}
+
+/* ============================================
+ * Manifest
+ * ============================================ */
+
+typedef struct {
+    TypecastBatchItem* items;
+    cJSON** lines;                   /* parsed line of each item; strings point into it */
+    char** paths;                    /* resolved paths, owned */
+    size_t count;
+    size_t capacity;
+} Manifest;
+
+static void manifest_free(Manifest* manifest) {
+    for (size_t i = 0; i < manifest->count; i++) {
+        cJSON_Delete(manifest->lines[i]);
+        free(manifest->paths[i]);
+    }
+    free(manifest->items);
+    free(manifest->lines);
+    free(manifest->paths);
+    memset(manifest, 0, sizeof(*manifest));
+}
+
+static const char* string_member(const cJSON* object, const char* name) {
+    const cJSON* item = cJSON_GetObjectItemCaseSensitive(object, name);
+    return cJSON_IsString(item) ? item->valuestring : NULL;
+}
+
+static int path_is_absolute(const char* path) {
+#if defined(_WIN32) || defined(_WIN64)
+    if (path[0] && path[1] == ':') return 1;
+    if (path[0] == '\\') return 1;
+#endif
+    return path[0] == '/';
+}
+
+/* `path` relative to the directory of the manifest (dir_len bytes of
+ * manifest_path, including the trailing separator) */
+static char* resolve_path(const char* manifest_path, size_t dir_len, const char* path) {
+    if (path_is_absolute(path)) dir_len = 0;
+    size_t len = strlen(path);
+    char* out = (char*)malloc(dir_len + len + 1);
+    if (!out) return NULL; /* LCOV_EXCL_LINE category=oom reason="path allocation" */
+    memcpy(out, manifest_path, dir_len);
+    memcpy(out + dir_len, path, len + 1);
+    return out;
+}
+
+/* 1 = added, 0 = invalid line, -1 = out of memory */
+static int manifest_add(Manifest* manifest, const char* manifest_path, size_t dir_len, const char* line) {
+    cJSON* json = cJSON_Parse(line);
+    if (!json) return 0;
+    const char* path = string_member(json, "path");
+    const cJSON* model = cJSON_GetObjectItemCaseSensitive(json, "model");
+    const cJSON* seed = cJSON_GetObjectItemCaseSensitive(json, "seed");
+    int model_value = cJSON_IsString(model) ? typecast_model_from_string(model->valuestring) : -1;
+    if (!cJSON_IsObject(json) || tc_is_blank_string(path) || !string_member(json, "text") ||
+        !string_member(json, "voice_id") || (model && model_value < 0) || (seed && !cJSON_IsNumber(seed))) {
+        cJSON_Delete(json);
+        return 0;
+    }
+
+    if (manifest->count == manifest->capacity) {
+        size_t capacity = manifest->capacity ? manifest->capacity * 2 : 64;
+        TypecastBatchItem* items = (TypecastBatchItem*)realloc(manifest->items, capacity * sizeof(*items));
+        if (items) manifest->items = items;
+        cJSON** lines = items ? (cJSON**)realloc(manifest->lines, capacity * sizeof(*lines)) : NULL;
+        if (lines) manifest->lines = lines;
+        char** paths = lines ? (char**)realloc(manifest->paths, capacity * sizeof(*paths)) : NULL;
+        /* LCOV_EXCL_START */
+        /* category=oom reason="manifest item arrays" */
+        if (!paths) {
+            cJSON_Delete(json);
+            return -1;
+        }
+        /* LCOV_EXCL_STOP */
+        manifest->paths = paths;
+        manifest->capacity = capacity;
+    }
+    char* resolved = resolve_path(manifest_path, dir_len, path);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="path allocation" */
+    if (!resolved) {
+        cJSON_Delete(json);
+        return -1;
+    }
+    /* LCOV_EXCL_STOP */
+
+    TypecastBatchItem* item = &manifest->items[manifest->count];
+    memset(item, 0, sizeof(*item));
+    item->path = resolved;
+    item->request.text = string_member(json, "text");
+    item->request.voice_id = string_member(json, "voice_id");
+    item->request.language = string_member(json, "language");
+    if (model) {
+        item->request.model = (TypecastModel)model_value;
+        item->request.use_model = 1;
+    }
+    if (seed) item->request.seed = seed->valueint;
+    manifest->lines[manifest->count] = json;
+    manifest->paths[manifest->count] = resolved;
+    manifest->count++;
+    return 1;
+}
+
+/* Parse every non-blank line of `text` (which is modified) */
+static TypecastErrorCode manifest_parse(Manifest* manifest, const char* manifest_path, char* text,
+    TypecastError* error) {
+    size_t dir_len = 0;
+    for (size_t i = 0; manifest_path[i]; i++) {
+        if (manifest_path[i] == '/' || manifest_path[i] == '\\') dir_len = i + 1;
+    }
+    size_t line_number = 0;
+    char* line = text;
+    while (line) {
+        char* end = strchr(line, '\n');
+        if (end) *end = '\0';
+        line_number++;
+        if (!tc_is_blank_string(line)) {
+            int added = manifest_add(manifest, manifest_path, dir_len, line);
+            if (added < 0) {
+                /* LCOV_EXCL_START */
+                /* category=oom reason="manifest item allocation" */
+                tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate manifest items");
+                return TYPECAST_ERROR_OUT_OF_MEMORY;
+                /* LCOV_EXCL_STOP */
+            }
+            if (added == 0) {
+                char message[96];
+                snprintf(message, sizeof(message), "Manifest line %lu is not a valid item",
+                    (unsigned long)line_number);
+                tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, message);
+                return TYPECAST_ERROR_INVALID_PARAM;
+            }
+        }
+        line = end ? end + 1 : NULL;
+    }
+    return TYPECAST_OK;
+}
+
+TYPECAST_API TypecastErrorCode typecast_generate_batch_from_manifest(
+    TypecastClient* client,
+    const char* manifest_path,
+    const TypecastBatchOptions* options,
+    typecast_batch_callback_t on_item,
+    void* user_data,
+    TypecastBatchSummary* out_summary
+) {
+    if (out_summary) memset(out_summary, 0, sizeof(*out_summary));
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    TypecastError* error = tc_client_error(client);
+    FILE* file = manifest_path ? fopen(manifest_path, "rb") : NULL;
+    if (!file) {
+        tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, "Failed to read manifest file");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    ResponseBuffer buf = {0};
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        /* LCOV_EXCL_START */
+        /* category=oom reason="manifest buffer" */
+        if (tc_response_write(chunk, 1, n, &buf) != n) {
+            fclose(file);
+            free(buf.data);
+            tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to read manifest file");
+            return TYPECAST_ERROR_OUT_OF_MEMORY;
+        }
+        /* LCOV_EXCL_STOP */
+    }
+    fclose(file);
+
+    Manifest manifest = {0};
+    TypecastErrorCode err = buf.data ? manifest_parse(&manifest, manifest_path, (char*)buf.data, error)
+                                     : TYPECAST_OK;
+    free(buf.data);
+    if (err == TYPECAST_OK) {
+        err = typecast_generate_batch(client, manifest.items, manifest.count, options, on_item, user_data,
+            out_summary);
+    }
+    manifest_free(&manifest);
+    return err;
+}
@@ -0,0 +1,207 @@
+/**
+ * Typecast C/C++ SDK - Timeouts, deadlines and cancellation
+ *
+ * Every request takes its limits from the client's timeout options,
+ * overlaid with the call options the calling thread set through
+ * typecast_set_call_options. curl enforces the timeouts itself; a cancel
+ * token or a deadline additionally installs a progress callback that
+ * aborts the transfer once the token fires or the deadline passes, so a
+ * request its caller gave up on releases the worker early.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+#include <curl/curl.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_call.h"
+
+#define DEFAULT_REQUEST_TIMEOUT_SECS 60L
+#define DEFAULT_QUERY_TIMEOUT_SECS 30L
+#define DEFAULT_UPLOAD_TIMEOUT_SECS 120L
+
+/* Slice of a retry wait between two looks at the cancel token */
+#define SLEEP_SLICE_MS 50L
+
+struct TypecastCancelToken {
+    tc_mutex_t lock;
+    int cancelled;
+};
+
+/* ============================================
+ * Cancel tokens
+ * ============================================ */
+
+TYPECAST_API TypecastCancelToken* typecast_cancel_token_create(void) {
+    TypecastCancelToken* token = (TypecastCancelToken*)calloc(1, sizeof(*token));
+    if (!token) return NULL; /* LCOV_EXCL_LINE category=oom reason="token allocation" */
+    tc_mutex_init(&token->lock);
+    return token;
+}
+
+TYPECAST_API void typecast_cancel_token_cancel(TypecastCancelToken* token) {
+    if (!token) return;
+    tc_mutex_lock(&token->lock);
+    token->cancelled = 1;
+    tc_mutex_unlock(&token->lock);
+}
+
+TYPECAST_API int typecast_cancel_token_is_cancelled(const TypecastCancelToken* token) {
+    if (!token) return 0;
+    TypecastCancelToken* t = (TypecastCancelToken*)token;
+    tc_mutex_lock(&t->lock);
+    int cancelled = t->cancelled;
+    tc_mutex_unlock(&t->lock);
+    return cancelled;
+}
+
+TYPECAST_API void typecast_cancel_token_reset(TypecastCancelToken* token) {
+    if (!token) return;
+    tc_mutex_lock(&token->lock);
+    token->cancelled = 0;
+    tc_mutex_unlock(&token->lock);
+}
+
+TYPECAST_API void typecast_cancel_token_free(TypecastCancelToken* token) {
+    if (!token) return;
+    tc_mutex_destroy(&token->lock);
+    free(token);
+}
+
+/* ============================================
+ * Call options
+ * ============================================ */
+
+TYPECAST_API TypecastErrorCode typecast_set_call_options(
+    TypecastClient* client,
+    const TypecastCallOptions* options
+) {
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    if (options && (options->timeout_ms < 0 || options->connect_timeout_ms < 0 || options->deadline_ms < 0)) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Call option values must not be negative");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    TcCallScope* scope = tc_client_call_scope(client);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="calloc of a per-thread slot" */
+    if (!scope) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to store call options");
+        return TYPECAST_ERROR_OUT_OF_MEMORY;
+    }
+    /* LCOV_EXCL_STOP */
+    if (!options) {
+        scope->active = 0;
+        return TYPECAST_OK;
+    }
+    scope->active = 1;
+    scope->options = *options;
+    scope->deadline = options->deadline_ms > 0 ? tc_monotonic_ms() + (uint64_t)options->deadline_ms : 0;
+    return TYPECAST_OK;
+}
+
+long tc_client_timeout_secs(const TypecastClientOptions* options, TcTimeoutClass timeout) {
+    switch (timeout) {
+        case TC_TIMEOUT_QUERY:
+            return options->query_timeout_secs > 0 ? options->query_timeout_secs : DEFAULT_QUERY_TIMEOUT_SECS;
+        case TC_TIMEOUT_UPLOAD:
+            return options->upload_timeout_secs > 0 ? options->upload_timeout_secs : DEFAULT_UPLOAD_TIMEOUT_SECS;
+        default:
+            return options->request_timeout_secs > 0 ? options->request_timeout_secs : DEFAULT_REQUEST_TIMEOUT_SECS;
+    }
+}
+
+void tc_call_settings(TypecastClient* client, TcTimeoutClass timeout, TcCallSettings* out) {
+    const TypecastClientOptions* options = &client->options;
+    out->timeout_ms = tc_client_timeout_secs(options, timeout) * 1000L;
+    out->connect_timeout_ms = options->connect_timeout_secs > 0 ? options->connect_timeout_secs * 1000L : 0;
+    out->deadline = 0;
+    out->cancel = NULL;
+    out->expired = 0;
+    out->on_upload = NULL;
+    out->upload_user_data = NULL;
+    out->upload_reported = -1;
+    out->upload_aborted = 0;
+
+    TcCallScope* scope = tc_client_call_scope(client);
+    if (!scope || !scope->active) return;
+    if (scope->options.timeout_ms > 0) out->timeout_ms = scope->options.timeout_ms;
+    if (scope->options.connect_timeout_ms > 0) out->connect_timeout_ms = scope->options.connect_timeout_ms;
+    out->deadline = scope->deadline;
+    out->cancel = scope->options.cancel;
+}
+
+/* ============================================
+ * Transfers
+ * ============================================ */
+
+static int call_progress(void* data, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow) {
+    (void)dltotal; (void)dlnow;
+    TcCallSettings* call = (TcCallSettings*)data;
+    if (call->on_upload && ulnow != (curl_off_t)call->upload_reported) {
+        call->upload_reported = (long long)ulnow;
+        if (call->on_upload((uint64_t)ulnow, (uint64_t)ultotal, call->upload_user_data) != 0) {
+            call->upload_aborted = 1;
+            return 1;
+        }
+    }
+    if (typecast_cancel_token_is_cancelled(call->cancel)) return 1;
+    if (call->deadline && tc_monotonic_ms() >= call->deadline) {
+        call->expired = 1;
+        return 1;
+    }
+    return 0;
+}
+
+void tc_call_apply(CURL* curl, TcCallSettings* call) {
+    long timeout_ms = call->timeout_ms;
+    if (call->deadline) {
+        uint64_t now = tc_monotonic_ms();
+        /* 0 would mean no timeout at all */
+        long left = call->deadline > now ? (long)(call->deadline - now) : 1L;
+        if (timeout_ms == 0 || left < timeout_ms) timeout_ms = left;
+    }
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, call->connect_timeout_ms);
+    if (call->cancel || call->deadline || call->on_upload) {
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, call_progress);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, call);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    }
+}
+
+TypecastErrorCode tc_call_error(const TcCallSettings* call, CURLcode result, TypecastError* error) {
+    if (result == CURLE_ABORTED_BY_CALLBACK && call) {
+        if (call->upload_aborted) {
+            tc_error_set(error, TYPECAST_ERROR_NETWORK, "Upload aborted by callback");
+            return TYPECAST_ERROR_NETWORK;
+        }
+        if (call->expired) {
+            tc_error_set(error, TYPECAST_ERROR_NETWORK, "Deadline exceeded");
+            return TYPECAST_ERROR_NETWORK;
+        }
+        if (typecast_cancel_token_is_cancelled(call->cancel)) {
+            tc_error_set(error, TYPECAST_ERROR_CANCELLED, typecast_error_message(TYPECAST_ERROR_CANCELLED));
+            return TYPECAST_ERROR_CANCELLED;
+        }
+    }
+    tc_error_set(error, TYPECAST_ERROR_NETWORK, curl_easy_strerror(result));
+    return TYPECAST_ERROR_NETWORK;
+}
+
+int tc_call_sleep(const TcCallSettings* call, long ms) {
+    uint64_t until = tc_monotonic_ms() + (uint64_t)(ms > 0 ? ms : 0);
+    if (call->deadline && until >= call->deadline) return 0;
+    for (;;) {
+        if (typecast_cancel_token_is_cancelled(call->cancel)) return 0;
+        uint64_t now = tc_monotonic_ms();
+        if (now >= until) return 1;
+        long left = (long)(until - now);
+        tc_sleep_ms(left < SLEEP_SLICE_MS ? left : SLEEP_SLICE_MS);
+    }
+}
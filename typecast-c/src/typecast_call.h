@@ -0,0 +1,26 @@
+/**
+ * Typecast C/C++ SDK - Timeouts and cancellation (typecast_call.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_CALL_H
+#define TYPECAST_CALL_H
+
+#include "typecast_internal.h"
+
+/* Configured timeout of a class in seconds, defaults applied */
+long tc_client_timeout_secs(const TypecastClientOptions* options, TcTimeoutClass timeout);
+/* Resolve the limits of a request about to be made on the calling thread */
+void tc_call_settings(TypecastClient* client, TcTimeoutClass timeout, TcCallSettings* out);
+/* Set timeouts and the cancel/deadline progress callback on `curl`.
+ * `call` must stay valid until the transfer ends. */
+void tc_call_apply(CURL* curl, TcCallSettings* call);
+/* Record a failed curl result. Returns TYPECAST_ERROR_CANCELLED when the
+ * cancel token stopped it, TYPECAST_ERROR_NETWORK otherwise. */
+TypecastErrorCode tc_call_error(const TcCallSettings* call, CURLcode result, TypecastError* error);
+/* Sleep before a retry. 0 (possibly early) when the token fires or the
+ * wait would end past the deadline, so the retry should be skipped. */
+int tc_call_sleep(const TcCallSettings* call, long ms);
+
+#endif /* TYPECAST_CALL_H */
@@ -0,0 +1,415 @@
+/**
+ * Typecast C/C++ SDK - SRT/WebVTT captions
+ *
+ * Alignment segments are grouped into cues in a single pass and every cue
+ * is written out as soon as it closes. Only the text of the open cue is
+ * kept, in one buffer reused from cue to cue, so captioning an hour of
+ * character-level alignments costs no per-cue allocation and no buffer
+ * for the whole document. The same writer consumes segments as they
+ * arrive from typecast_text_to_speech_with_timestamps_stream().
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_captions.h"
+
+/* Count UTF-8 codepoints: every byte that is NOT a continuation byte. */
+size_t tc_utf8_codepoint_count(const char* s) {
+    size_t count = 0;
+    const unsigned char* p = (const unsigned char*)s;
+    for (; *p; p++) {
+        if ((*p & 0xc0) != 0x80) count++;
+    }
+    return count;
+}
+
+/* Sentence-ending terminators (ASCII + full-width punctuation as UTF-8). */
+static const char* CAPTION_TERMINATORS[] = {
+    ".",
+    "?",
+    "!",
+    "\xe3\x80\x82",  /* 。 U+3002 */
+    "\xef\xbc\x9f",  /* ？ U+FF1F */
+    "\xef\xbc\x81",  /* ！ U+FF01 */
+    NULL
+};
+
+size_t tc_sentence_terminator_len(const char* s) {
+    for (int i = 0; CAPTION_TERMINATORS[i]; i++) {
+        size_t n = strlen(CAPTION_TERMINATORS[i]);
+        if (strncmp(s, CAPTION_TERMINATORS[i], n) == 0) return n;
+    }
+    return 0;
+}
+
+/* TODO(TASK-12430-followup): expose max_seconds / max_chars override to match Python/JS API surface. Default 7.0s / 42 chars (BBC/Netflix guideline). */
+static const float CAPTION_MAX_SECONDS = 7.0f;
+static const size_t CAPTION_MAX_CHARS   = 42;
+
+static int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/* 1 if text[0..len], without trailing whitespace, ends in a terminator */
+static int ends_in_sentence(const char* text, size_t len) {
+    while (len > 0 && is_space(text[len - 1])) len--;
+    for (int i = 0; CAPTION_TERMINATORS[i]; i++) {
+        size_t n = strlen(CAPTION_TERMINATORS[i]);
+        if (n <= len && memcmp(text + len - n, CAPTION_TERMINATORS[i], n) == 0) return 1;
+    }
+    return 0;
+}
+
+/* Format seconds -> HH:MM:SS,mmm (SRT) or HH:MM:SS.mmm (VTT) */
+static void format_time(float sec, char separator, char* buf, size_t buf_size) {
+    int total_ms = (int)(sec * 1000.0f + 0.5f);
+    if (total_ms < 0) total_ms = 0;
+    int ms = total_ms % 1000;
+    int s  = (total_ms / 1000) % 60;
+    int m  = (total_ms / 60000) % 60;
+    int h  = (total_ms / 3600000);
+    snprintf(buf, buf_size, "%02d:%02d:%02d%c%03d", h, m, s, separator, ms);
+}
+
+/* ============================================
+ * Caption writer
+ * ============================================ */
+
+struct TypecastCaptionWriter {
+    TypecastCaptionFormat format;
+    TypecastAlignmentKind kind;
+    typecast_stream_callback_t write;
+    void* user_data;
+    FILE* file;
+    /* Raw text of the open cue; reused for every cue */
+    char* text;
+    size_t len;
+    size_t cap;
+    size_t codepoints;
+    float start;
+    float end;
+    int open;
+    size_t cues;
+    TypecastErrorCode error;
+};
+
+static void writer_init(TypecastCaptionWriter* w, TypecastCaptionFormat format, TypecastAlignmentKind kind,
+                        typecast_stream_callback_t write, void* user_data) {
+    memset(w, 0, sizeof(*w));
+    w->format = format;
+    w->kind = kind;
+    w->write = write;
+    w->user_data = user_data;
+}
+
+/* Start over, keeping the text buffer */
+static void writer_restart(TypecastCaptionWriter* w, typecast_stream_callback_t write, void* user_data) {
+    char* text = w->text;
+    size_t cap = w->cap;
+    writer_init(w, w->format, w->kind, write, user_data);
+    w->text = text;
+    w->cap = cap;
+}
+
+static int emit(TypecastCaptionWriter* w, const char* data, size_t len) {
+    if (w->error != TYPECAST_OK || len == 0) return w->error == TYPECAST_OK;
+    if (w->file) {
+        if (fwrite(data, 1, len, w->file) != len) w->error = TYPECAST_ERROR_NETWORK;
+    } else if (w->write((const uint8_t*)data, len, w->user_data) != 0) {
+        w->error = TYPECAST_ERROR_CANCELLED;
+    }
+    return w->error == TYPECAST_OK;
+}
+
+/* Write the open cue, stripped of surrounding whitespace, and close it */
+static void flush_cue(TypecastCaptionWriter* w, float end) {
+    const char* text = w->text;
+    size_t len = w->len;
+    while (len > 0 && is_space(text[len - 1])) len--;
+    while (len > 0 && is_space(*text)) {
+        text++;
+        len--;
+    }
+    w->open = 0;
+    w->len = 0;
+    w->codepoints = 0;
+    if (len == 0) return;
+
+    char line[96];
+    char from[32];
+    char to[32];
+    int vtt = w->format == TYPECAST_CAPTION_VTT;
+    format_time(w->start, vtt ? '.' : ',', from, sizeof(from));
+    format_time(end, vtt ? '.' : ',', to, sizeof(to));
+    int n;
+    if (vtt) {
+        if (w->cues == 0 && !emit(w, "WEBVTT\n\n", 8)) return;
+        n = snprintf(line, sizeof(line), "%s --> %s\n", from, to);
+    } else {
+        n = snprintf(line, sizeof(line), "%zu\n%s --> %s\n", w->cues + 1, from, to);
+    }
+    w->cues++;
+    if (emit(w, line, (size_t)n) && emit(w, text, len)) emit(w, "\n\n", 2);
+}
+
+static int append_text(TypecastCaptionWriter* w, const char* data, size_t len) {
+    if (w->len + len > w->cap) {
+        size_t cap = w->cap ? w->cap * 2 : 128;
+        while (cap < w->len + len) cap *= 2;
+        char* grown = (char*)realloc(w->text, cap);
+        if (!grown) return 0; /* LCOV_EXCL_LINE category=oom reason="cue text buffer growth" */
+        w->text = grown;
+        w->cap = cap;
+    }
+    memcpy(w->text + w->len, data, len);
+    w->len += len;
+    return 1;
+}
+
+static TypecastErrorCode writer_add(TypecastCaptionWriter* w, const TypecastAlignmentSegment* seg) {
+    if (w->error != TYPECAST_OK) return w->error;
+    const char* text = seg->text ? seg->text : "";
+    size_t len = strlen(text);
+    size_t codepoints = tc_utf8_codepoint_count(text);
+    int word_mode = w->kind == TYPECAST_ALIGNMENT_WORD;
+
+    if (w->open) {
+        size_t candidate = w->codepoints + (word_mode ? 1 : 0) + codepoints;
+        if ((seg->end - w->start) > CAPTION_MAX_SECONDS || candidate > CAPTION_MAX_CHARS) {
+            flush_cue(w, w->end);
+        }
+    }
+    if (!w->open) {
+        w->start = seg->start;
+        w->open = 1;
+    } else if (word_mode) {
+        if (!append_text(w, " ", 1)) goto oom;
+        w->codepoints++;
+    }
+    if (!append_text(w, text, len)) goto oom;
+    w->codepoints += codepoints;
+    w->end = seg->end;
+
+    if (ends_in_sentence(text, len)) flush_cue(w, seg->end);
+    return w->error;
+
+    /* LCOV_EXCL_START */
+    /* category=oom reason="cue text buffer growth" */
+oom:
+    w->error = TYPECAST_ERROR_OUT_OF_MEMORY;
+    return w->error;
+    /* LCOV_EXCL_STOP */
+}
+
+static TypecastErrorCode writer_finish(TypecastCaptionWriter* w) {
+    if (w->error == TYPECAST_OK && w->open) flush_cue(w, w->end);
+    if (w->error != TYPECAST_OK) return w->error;
+    /* Nothing to caption, as for _to_srt / _to_vtt */
+    return w->cues > 0 ? TYPECAST_OK : TYPECAST_ERROR_INVALID_PARAM;
+}
+
+TYPECAST_API TypecastCaptionWriter* typecast_caption_writer_create(
+    TypecastCaptionFormat format,
+    TypecastAlignmentKind kind,
+    typecast_stream_callback_t write,
+    void* user_data
+) {
+    if (!write) return NULL;
+    TypecastCaptionWriter* w = (TypecastCaptionWriter*)malloc(sizeof(*w));
+    if (!w) return NULL; /* LCOV_EXCL_LINE category=oom reason="writer allocation" */
+    writer_init(w, format, kind, write, user_data);
+    return w;
+}
+
+TYPECAST_API TypecastCaptionWriter* typecast_caption_writer_create_file(
+    TypecastCaptionFormat format,
+    TypecastAlignmentKind kind,
+    FILE* file
+) {
+    if (!file) return NULL;
+    TypecastCaptionWriter* w = (TypecastCaptionWriter*)malloc(sizeof(*w));
+    if (!w) return NULL; /* LCOV_EXCL_LINE category=oom reason="writer allocation" */
+    writer_init(w, format, kind, NULL, NULL);
+    w->file = file;
+    return w;
+}
+
+TYPECAST_API TypecastErrorCode typecast_caption_writer_add(
+    TypecastCaptionWriter* writer,
+    const TypecastAlignmentSegment* segment
+) {
+    if (!writer || !segment) return TYPECAST_ERROR_INVALID_PARAM;
+    return writer_add(writer, segment);
+}
+
+TYPECAST_API int typecast_caption_writer_on_segment(
+    TypecastAlignmentKind kind,
+    const TypecastAlignmentSegment* segment,
+    void* user_data
+) {
+    TypecastCaptionWriter* writer = (TypecastCaptionWriter*)user_data;
+    if (!writer || !segment) return 1;
+    if (kind != writer->kind) return 0;
+    return writer_add(writer, segment) != TYPECAST_OK;
+}
+
+TYPECAST_API TypecastErrorCode typecast_caption_writer_finish(TypecastCaptionWriter* writer) {
+    if (!writer) return TYPECAST_ERROR_INVALID_PARAM;
+    return writer_finish(writer);
+}
+
+TYPECAST_API size_t typecast_caption_writer_cue_count(const TypecastCaptionWriter* writer) {
+    return writer ? writer->cues : 0;
+}
+
+TYPECAST_API void typecast_caption_writer_free(TypecastCaptionWriter* writer) {
+    if (!writer) return;
+    free(writer->text);
+    free(writer);
+}
+
+/* ============================================
+ * Whole responses
+ * ============================================ */
+
+/*
+ * Pick the segment list and its kind from a response.
+ * Returns 1 on success; 0 if no usable segments.
+ */
+static int pick_segments(
+    const TypecastTTSWithTimestampsResponse* response,
+    const TypecastAlignmentSegment** segs_out,
+    size_t* count_out,
+    TypecastAlignmentKind* kind_out
+) {
+    if (response->words && response->words_count >= 2) {
+        *segs_out  = response->words;
+        *count_out = response->words_count;
+        *kind_out  = TYPECAST_ALIGNMENT_WORD;
+        return 1;
+    }
+    if (response->characters && response->characters_count >= 1) {
+        *segs_out  = response->characters;
+        *count_out = response->characters_count;
+        *kind_out  = TYPECAST_ALIGNMENT_CHARACTER;
+        return 1;
+    }
+    /* Single-entry words with no characters -> still valid */
+    if (response->words && response->words_count == 1 &&
+        (!response->characters || response->characters_count == 0)) {
+        *segs_out  = response->words;
+        *count_out = response->words_count;
+        *kind_out  = TYPECAST_ALIGNMENT_WORD;
+        return 1;
+    }
+    return 0;
+}
+
+static TypecastErrorCode write_segments(TypecastCaptionWriter* w, const TypecastAlignmentSegment* segs,
+                                        size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        TypecastErrorCode err = writer_add(w, &segs[i]);
+        if (err != TYPECAST_OK) return err;
+    }
+    return writer_finish(w);
+}
+
+TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_write_captions(
+    const TypecastTTSWithTimestampsResponse* response,
+    TypecastCaptionFormat format,
+    typecast_stream_callback_t write,
+    void* user_data
+) {
+    if (!response || !write) return TYPECAST_ERROR_INVALID_PARAM;
+    const TypecastAlignmentSegment* segs;
+    size_t count;
+    TypecastAlignmentKind kind;
+    if (!pick_segments(response, &segs, &count, &kind)) return TYPECAST_ERROR_INVALID_PARAM;
+
+    TypecastCaptionWriter w;
+    writer_init(&w, format, kind, write, user_data);
+    TypecastErrorCode err = write_segments(&w, segs, count);
+    free(w.text);
+    return err;
+}
+
+typedef struct {
+    char* data;
+    size_t len;
+} CaptionBuffer;
+
+static int count_bytes(const uint8_t* data, size_t len, void* user_data) {
+    (void)data;
+    ((CaptionBuffer*)user_data)->len += len;
+    return 0;
+}
+
+static int copy_bytes(const uint8_t* data, size_t len, void* user_data) {
+    CaptionBuffer* buf = (CaptionBuffer*)user_data;
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    return 0;
+}
+
+/* Measure the document, then write it into one exact allocation */
+static TypecastErrorCode captions_to_string(
+    const TypecastTTSWithTimestampsResponse* response,
+    TypecastCaptionFormat format,
+    char** out_string
+) {
+    if (!response || !out_string) return TYPECAST_ERROR_INVALID_PARAM;
+    *out_string = NULL;
+    const TypecastAlignmentSegment* segs;
+    size_t count;
+    TypecastAlignmentKind kind;
+    if (!pick_segments(response, &segs, &count, &kind)) return TYPECAST_ERROR_INVALID_PARAM;
+
+    CaptionBuffer buf = {NULL, 0};
+    TypecastCaptionWriter w;
+    writer_init(&w, format, kind, count_bytes, &buf);
+    TypecastErrorCode err = write_segments(&w, segs, count);
+    if (err == TYPECAST_OK) {
+        buf.data = (char*)malloc(buf.len + 1);
+        /* LCOV_EXCL_START */
+        /* category=oom reason="caption document allocation" */
+        if (!buf.data) err = TYPECAST_ERROR_OUT_OF_MEMORY;
+        /* LCOV_EXCL_STOP */
+    }
+    if (err == TYPECAST_OK) {
+        buf.len = 0;
+        writer_restart(&w, copy_bytes, &buf);
+        err = write_segments(&w, segs, count);
+        buf.data[buf.len] = '\0';
+    }
+    free(w.text);
+    if (err != TYPECAST_OK) {
+        free(buf.data);
+        return err;
+    }
+    *out_string = buf.data;
+    return TYPECAST_OK;
+}
+
+TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_to_srt(
+    const TypecastTTSWithTimestampsResponse* response,
+    char** out_string
+) {
+    return captions_to_string(response, TYPECAST_CAPTION_SRT, out_string);
+}
+
+TYPECAST_API TypecastErrorCode typecast_tts_with_timestamps_response_to_vtt(
+    const TypecastTTSWithTimestampsResponse* response,
+    char** out_string
+) {
+    return captions_to_string(response, TYPECAST_CAPTION_VTT, out_string);
+}
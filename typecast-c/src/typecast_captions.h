@@ -0,0 +1,17 @@
+/**
+ * Typecast C/C++ SDK - Captions (typecast_captions.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_CAPTIONS_H
+#define TYPECAST_CAPTIONS_H
+
+#include "typecast_internal.h"
+
+size_t tc_utf8_codepoint_count(const char* s);
+/* Bytes of the sentence terminator (. ? ! and their full-width forms)
+ * starting at s, 0 when there is none */
+size_t tc_sentence_terminator_len(const char* s);
+
+#endif /* TYPECAST_CAPTIONS_H */
@@ -0,0 +1,170 @@
+/**
+ * Typecast C/C++ SDK - Streaming voice cloning uploads
+ *
+ * typecast_clone_voice() sends a caller's buffer; the variants here let
+ * curl read the sample while the request is being sent, from a file, a
+ * descriptor or a callback, so a 25 MB sample is never resident in full.
+ * The multipart request itself is built by tc_clone_voice in typecast.c.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#if defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_clone.h"
+
+/* Sizes past the limit are clamped so they still fail its check */
+static size_t clamp_size(long long size) {
+    long long limit = (long long)TYPECAST_CLONING_MAX_FILE_SIZE + 1;
+    if (size < 0) return 0;
+    return (size_t)(size > limit ? limit : size);
+}
+
+/* Size of a readable regular file, -1 otherwise */
+static long long regular_file_size(const char* path) {
+#if defined(_WIN32) || defined(_WIN64)
+    struct _stat64 st;
+    if (_stat64(path, &st) != 0 || !(st.st_mode & _S_IFREG)) return -1;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return -1;
+#endif
+    FILE* file = fopen(path, "rb");
+    if (!file) return -1;
+    fclose(file);
+    return (long long)st.st_size;
+}
+
+TYPECAST_API TypecastErrorCode typecast_clone_voice_from_source(
+    TypecastClient* client,
+    const TypecastCloneSource* source,
+    const char* name,
+    const char* model,
+    TypecastCustomVoice* out
+) {
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    TypecastError* error = tc_client_error(client);
+    if (!source || !source->path == !source->read) {
+        tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, "Set exactly one of path and read");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+
+    TcCloneUpload upload = {0};
+    upload.path = source->path;
+    upload.read = source->read;
+    upload.read_user_data = source->read_user_data;
+    upload.size = source->size;
+    upload.filename = source->filename;
+    upload.on_progress = source->on_progress;
+    upload.progress_user_data = source->progress_user_data;
+    if (source->path) {
+        long long size = regular_file_size(source->path);
+        if (size < 0) {
+            tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, "Failed to open audio file");
+            return TYPECAST_ERROR_INVALID_PARAM;
+        }
+        upload.size = clamp_size(size);
+    }
+    return tc_clone_voice(client, &upload, name, model, out);
+}
+
+TYPECAST_API TypecastErrorCode typecast_clone_voice_from_file(
+    TypecastClient* client,
+    const char* path,
+    const char* name,
+    const char* model,
+    TypecastCustomVoice* out
+) {
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    if (!path) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Failed to open audio file");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    TypecastCloneSource source = {0};
+    source.path = path;
+    return typecast_clone_voice_from_source(client, &source, name, model, out);
+}
+
+/* ============================================
+ * File descriptors
+ * ============================================ */
+
+typedef struct {
+    int fd;
+    int failed;
+} FdReader;
+
+static size_t fd_read(char* buffer, size_t size, void* user_data) {
+    FdReader* reader = (FdReader*)user_data;
+    for (;;) {
+#if defined(_WIN32) || defined(_WIN64)
+        int n = _read(reader->fd, buffer, (unsigned int)(size > 0x40000000u ? 0x40000000u : size));
+#else
+        ssize_t n = read(reader->fd, buffer, size);
+#endif
+        if (n < 0 && errno == EINTR) continue; /* LCOV_EXCL_LINE category=platform reason="signal delivery during read" */
+        if (n < 0) {
+            /* LCOV_EXCL_START */
+            /* category=platform reason="read failure on a regular file needs an I/O error" */
+            reader->failed = 1;
+            return TYPECAST_READ_ABORT;
+            /* LCOV_EXCL_STOP */
+        }
+        return (size_t)n;
+    }
+}
+
+TYPECAST_API TypecastErrorCode typecast_clone_voice_from_fd(
+    TypecastClient* client,
+    int fd,
+    const char* filename,
+    const char* name,
+    const char* model,
+    TypecastCustomVoice* out
+) {
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    TypecastError* error = tc_client_error(client);
+#if defined(_WIN32) || defined(_WIN64)
+    struct _stat64 st;
+    int regular = fd >= 0 && _fstat64(fd, &st) == 0 && (st.st_mode & _S_IFREG);
+    long long offset = regular ? (long long)_lseeki64(fd, 0, SEEK_CUR) : -1;
+#else
+    struct stat st;
+    int regular = fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    long long offset = regular ? (long long)lseek(fd, 0, SEEK_CUR) : -1;
+#endif
+    if (!regular || offset < 0) {
+        tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, "fd must be an open regular file");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+
+    FdReader reader = {fd, 0};
+    TcCloneUpload upload = {0};
+    upload.read = fd_read;
+    upload.read_user_data = &reader;
+    upload.size = clamp_size((long long)st.st_size - offset);
+    upload.filename = filename;
+    TypecastErrorCode err = tc_clone_voice(client, &upload, name, model, out);
+    if (reader.failed) {
+        /* LCOV_EXCL_START */
+        /* category=platform reason="see fd_read" */
+        tc_error_set(error, TYPECAST_ERROR_NETWORK, "Failed to read audio file descriptor");
+        return TYPECAST_ERROR_NETWORK;
+        /* LCOV_EXCL_STOP */
+    }
+    return err;
+}
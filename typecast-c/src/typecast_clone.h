@@ -0,0 +1,28 @@
+/**
+ * Typecast C/C++ SDK - Voice cloning (typecast.c, typecast_clone.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_CLONE_H
+#define TYPECAST_CLONE_H
+
+#include "typecast_internal.h"
+
+/* Audio of a clone upload: exactly one of data, path and read */
+typedef struct {
+    const unsigned char* data;       /* in memory */
+    const char* path;                /* streamed from this file */
+    typecast_read_callback_t read;   /* streamed from this callback */
+    void* read_user_data;
+    size_t size;                     /* bytes sent */
+    const char* filename;            /* multipart filename hint */
+    typecast_upload_progress_callback_t on_progress;
+    void* progress_user_data;
+} TcCloneUpload;
+
+/* POST /v1/voices/clone, traced as a TYPECAST_REQUEST_CLONE call */
+TypecastErrorCode tc_clone_voice(TypecastClient* client, const TcCloneUpload* upload,
+    const char* name, const char* model, TypecastCustomVoice* out);
+
+#endif /* TYPECAST_CLONE_H */
@@ -0,0 +1,171 @@
+/**
+ * Typecast C/C++ SDK - Per-thread errors
+ *
+ * A thread-safe client keeps each calling thread's last error and call
+ * options in a slot reached through a thread-local key of the client's,
+ * so tc_client_error takes no lock once the thread has its slot. The
+ * key's destructor frees the slot when the thread exits.
+ *
+ * A slot belongs to its thread. Destroying a client frees the calling
+ * thread's slot, marks the others orphaned and hands the key to the next
+ * client; an orphan is freed when its thread exits or meets it under the
+ * reused key. A thread exiting while the client is destroyed therefore
+ * never touches freed memory, and no more keys are held than clients were
+ * ever alive at once. Slot ownership is guarded by the global lock.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+
+struct TcErrorSlot {
+    TypecastClient* client;          /* NULL once the client is destroyed */
+    TypecastError error;
+    TcCallScope scope;
+    struct TcErrorSlot* prev;        /* the client's slots */
+    struct TcErrorSlot* next;
+};
+
+static void slot_free(TcErrorSlot* slot) {
+    tc_error_clear(&slot->error);
+    free(slot);
+}
+
+static void slot_unlink(TcErrorSlot* slot) {
+    if (slot->prev) slot->prev->next = slot->next;
+    else slot->client->error_slots = slot->next;
+    if (slot->next) slot->next->prev = slot->prev;
+    slot->client = NULL;
+}
+
+/* Thread exit */
+static void slot_exit(TcErrorSlot* slot) {
+    tc_global_lock();
+    if (slot->client) slot_unlink(slot);
+    tc_global_unlock();
+    slot_free(slot);
+}
+
+/* ============================================
+ * Keys
+ * ============================================ */
+
+#ifdef _WIN32
+
+static VOID NTAPI key_destructor(PVOID value) {
+    if (value) slot_exit((TcErrorSlot*)value);
+}
+
+static int key_create(tc_tls_key_t* key) {
+    *key = FlsAlloc(key_destructor);
+    return *key == FLS_OUT_OF_INDEXES ? -1 : 0;
+}
+
+static void* key_get(tc_tls_key_t key) { return FlsGetValue(key); }
+static int key_set(tc_tls_key_t key, void* value) { return FlsSetValue(key, value) ? 0 : -1; }
+
+#else
+
+static void key_destructor(void* value) {
+    slot_exit((TcErrorSlot*)value);
+}
+
+static int key_create(tc_tls_key_t* key) {
+    return pthread_key_create(key, key_destructor) == 0 ? 0 : -1;
+}
+
+static void* key_get(tc_tls_key_t key) { return pthread_getspecific(key); }
+static int key_set(tc_tls_key_t key, void* value) { return pthread_setspecific(key, value) == 0 ? 0 : -1; }
+
+#endif
+
+/* Keys of destroyed clients; guarded by the global lock */
+static tc_tls_key_t* spare_keys;
+static size_t spare_key_count;
+static size_t spare_key_capacity;
+
+int tc_error_slots_init(TypecastClient* client) {
+    tc_global_lock();
+    int ready = spare_key_count > 0;
+    if (ready) client->error_key = spare_keys[--spare_key_count];
+    tc_global_unlock();
+    if (!ready && key_create(&client->error_key) != 0) return -1; /* LCOV_EXCL_LINE category=oom reason="thread-local keys exhausted" */
+    client->error_key_ready = 1;
+    return 0;
+}
+
+void tc_error_slots_release(TypecastClient* client) {
+    if (!client->error_key_ready) return;
+    TcErrorSlot* own = (TcErrorSlot*)key_get(client->error_key);
+    if (own && own->client == client) key_set(client->error_key, NULL);
+    else own = NULL;
+
+    tc_global_lock();
+    if (own) slot_unlink(own);
+    while (client->error_slots) slot_unlink(client->error_slots);
+    if (spare_key_count == spare_key_capacity) {
+        size_t capacity = spare_key_capacity ? spare_key_capacity * 2 : 8;
+        tc_tls_key_t* grown = (tc_tls_key_t*)realloc(spare_keys, capacity * sizeof(*grown));
+        if (grown) {
+            spare_keys = grown;
+            spare_key_capacity = capacity;
+        }
+    }
+    /* Without room the key stays allocated but unused */
+    if (spare_key_count < spare_key_capacity) spare_keys[spare_key_count++] = client->error_key;
+    tc_global_unlock();
+
+    if (own) slot_free(own);
+    client->error_key_ready = 0;
+}
+
+static TcErrorSlot* thread_slot(TypecastClient* client) {
+    TcErrorSlot* slot = (TcErrorSlot*)key_get(client->error_key);
+    if (slot && slot->client == client) return slot;
+    if (slot) {
+        /* An orphan left under this key by a destroyed client */
+        key_set(client->error_key, NULL);
+        slot_free(slot);
+    }
+
+    slot = (TcErrorSlot*)calloc(1, sizeof(TcErrorSlot));
+    /* LCOV_EXCL_START */
+    /* category=oom reason="calloc of a per-thread error slot, or thread-local storage for it" */
+    if (!slot) return NULL;
+    if (key_set(client->error_key, slot) != 0) {
+        free(slot);
+        return NULL;
+    }
+    /* LCOV_EXCL_STOP */
+    tc_global_lock();
+    slot->client = client;
+    slot->next = client->error_slots;
+    if (slot->next) slot->next->prev = slot;
+    client->error_slots = slot;
+    tc_global_unlock();
+    return slot;
+}
+
+TypecastError* tc_client_error(TypecastClient* client) {
+    if (!client->thread_safe) return &client->last_error;
+
+    TcErrorSlot* slot = thread_slot(client);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="calloc of a per-thread error slot" */
+    if (!slot) return &client->last_error;
+    /* LCOV_EXCL_STOP */
+    return &slot->error;
+}
+
+TcCallScope* tc_client_call_scope(TypecastClient* client) {
+    if (!client->thread_safe) return &client->call_scope;
+    TcErrorSlot* slot = thread_slot(client);
+    return slot ? &slot->scope : NULL;
+}
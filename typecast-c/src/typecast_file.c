@@ -0,0 +1,382 @@
+/**
+ * Typecast C/C++ SDK - Generating speech to files
+ *
+ * Audio is written to the destination as it arrives instead of being
+ * buffered in memory first, so memory use stays flat regardless of how
+ * long the render is. typecast_generate_to_file() streams into a temporary
+ * file next to the destination and renames it into place on success.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+    #define strncasecmp _strnicmp
+#else
+    #include <strings.h>  /* for strncasecmp */
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#include <curl/curl.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_file.h"
+#include "typecast_metrics.h"
+#include "typecast_result_cache.h"
+
+/* ============================================
+ * Output paths
+ * ============================================ */
+
+static int infer_audio_format_from_path(const char* path, TypecastAudioFormat* format) {
+    if (!path || !format) return 0;
+    size_t len = strlen(path);
+    if (len >= 4 && strncasecmp(path + len - 4, ".mp3", 4) == 0) {
+        *format = TYPECAST_AUDIO_FORMAT_MP3;
+        return 1;
+    }
+    if (len >= 4 && strncasecmp(path + len - 4, ".wav", 4) == 0) {
+        *format = TYPECAST_AUDIO_FORMAT_WAV;
+        return 1;
+    }
+    return 0;
+}
+
+static int path_is_directory(const char* path) {
+#if defined(_WIN32) || defined(_WIN64)
+    (void)path;
+    return 0;
+#else
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+static int build_temp_output_path(const char* file_path, char* temp_path, size_t temp_path_size) {
+    static const char* suffix = ".typecast-tmp";
+    size_t path_len = strlen(file_path);
+    size_t suffix_len = strlen(suffix);
+    if (path_len + suffix_len + 1 > temp_path_size) return 0;
+    memcpy(temp_path, file_path, path_len);
+    memcpy(temp_path + path_len, suffix, suffix_len + 1);
+    return 1;
+}
+
+int tc_preflight_output_path(const char* file_path, char* temp_path, size_t temp_path_size) {
+    if (tc_is_blank_string(file_path)) return 0;
+    if (path_is_directory(file_path)) return 0;
+    if (!build_temp_output_path(file_path, temp_path, temp_path_size)) return 0;
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) return 0;
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="fclose failure after writable preflight is not reliably portable to simulate" */
+    if (fclose(file) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    /* LCOV_EXCL_STOP */
+    remove(temp_path);
+    return 1;
+}
+
+int tc_output_move_into_place(const char* temp_path, const char* file_path) {
+    if (rename(temp_path, file_path) == 0) return 1;
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="rename failure after same-directory temp write is not reliably portable to simulate" */
+    remove(file_path);
+    if (rename(temp_path, file_path) == 0) return 1;
+    remove(temp_path);
+    return 0;
+    /* LCOV_EXCL_STOP */
+}
+
+/* ============================================
+ * Sink
+ * ============================================ */
+
+static int sink_write_all(TcFileSink* sink, const uint8_t* data, size_t size) {
+    if (sink->file) return fwrite(data, 1, size, sink->file) == size;
+
+    while (size > 0) {
+#if defined(_WIN32) || defined(_WIN64)
+        unsigned int chunk = size > 0x40000000u ? 0x40000000u : (unsigned int)size;
+        int n = _write(sink->fd, data, chunk);
+#else
+        ssize_t n = write(sink->fd, data, size);
+#endif
+        if (n < 0 && errno == EINTR) continue; /* LCOV_EXCL_LINE category=platform reason="signal delivery during write" */
+        if (n <= 0) return 0;
+        data += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+size_t tc_file_sink_write(void* contents, size_t size, size_t nmemb, void* userp) {
+    TcFileSink* sink = (TcFileSink*)userp;
+    TcTransfer* transfer = sink->transfer;
+    if (transfer->http_status == 0) {
+        curl_easy_getinfo(transfer->response.curl, CURLINFO_RESPONSE_CODE, &transfer->http_status);
+    }
+
+    /* Only a 200 body is audio. Error bodies are buffered so the API's
+     * detail message is still reported, and a retried 429 leaves the
+     * destination untouched. */
+    if (transfer->http_status != 200) return tc_response_write(contents, size, nmemb, &transfer->response);
+
+    size_t realsize = size * nmemb;
+    if (!sink_write_all(sink, (const uint8_t*)contents, realsize)) {
+        sink->write_failed = 1;
+        return 0;
+    }
+    if (sink->tee && tc_response_write(contents, size, nmemb, sink->tee) != realsize) {
+        /* LCOV_EXCL_START */
+        /* category=oom reason="result cache copy of the audio; the result is just not cached" */
+        sink->tee = NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    return realsize;
+}
+
+static TypecastErrorCode validate_request(TypecastClient* client, const TypecastGenerateToFileRequest* request) {
+    if (!request) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    if (tc_is_blank_string(request->text) || tc_is_blank_string(request->voice_id)) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "text and voice_id are required");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    return TYPECAST_OK;
+}
+
+void tc_generate_request_to_tts(const TypecastGenerateToFileRequest* request, const char* file_path,
+    TypecastTTSRequest* tts_request, TypecastOutput* inferred_output) {
+    memset(tts_request, 0, sizeof(*tts_request));
+    tts_request->text = request->text;
+    tts_request->voice_id = request->voice_id;
+    tts_request->model = request->use_model ? request->model : TYPECAST_MODEL_SSFM_V30;
+    tts_request->language = request->language;
+    tts_request->prompt = request->prompt;
+    tts_request->output = request->output;
+    tts_request->seed = request->seed;
+
+    memset(inferred_output, 0, sizeof(*inferred_output));
+    if (!tts_request->output && infer_audio_format_from_path(file_path, &inferred_output->audio_format)) {
+        inferred_output->volume = 100;
+        inferred_output->audio_pitch = 0;
+        inferred_output->audio_tempo = 1.0f;
+        tts_request->output = inferred_output;
+    }
+}
+
+/* Run the TTS request with the response body going to the sink. The
+ * audio format is inferred from `file_path` when given and the request
+ * has no explicit output settings. */
+static TypecastErrorCode generate_to_sink(
+    TypecastClient* client,
+    const TypecastGenerateToFileRequest* request,
+    const char* file_path,
+    TcFileSink* sink,
+    TypecastGeneratedAudio* info
+) {
+    TypecastError* error = tc_client_error(client);
+
+    TypecastTTSRequest tts_request;
+    TypecastOutput inferred_output;
+    tc_generate_request_to_tts(request, file_path, &tts_request, &inferred_output);
+
+    TcTransfer transfer;
+    TypecastErrorCode err = tc_transfer_prepare_tts(client, &tts_request, &transfer, error);
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="request serialization only fails on OOM" */
+    if (err != TYPECAST_OK) {
+        tc_transfer_cleanup(&transfer);
+        return err;
+    }
+    /* LCOV_EXCL_STOP */
+
+    /* A cached result is written out without a request */
+    int cacheable = tc_result_cache_accepts(client->result_cache, tts_request.seed);
+    TcCachedResult cached;
+    if (cacheable && tc_result_cache_lookup(client->result_cache, &transfer, NULL, &cached)) {
+        tc_transfer_cleanup(&transfer);
+        int written = sink_write_all(sink, cached.data, cached.size);
+        free(cached.data);
+        if (!written || (sink->file && fflush(sink->file) != 0)) {
+            tc_error_set(error, TYPECAST_ERROR_NETWORK, "Failed to write output file");
+            return TYPECAST_ERROR_NETWORK;
+        }
+        if (info) {
+            info->duration = cached.duration;
+            info->format = cached.format;
+        }
+        tc_error_clear(error);
+        return TYPECAST_OK;
+    }
+    ResponseBuffer audio = {0};
+    if (cacheable) sink->tee = &audio;
+
+    sink->transfer = &transfer;
+    transfer.sink_write = tc_file_sink_write;
+    transfer.sink_data = sink;
+    CURLcode res = CURLE_OK;
+    CURL* curl = tc_transfer_perform(client, &transfer, &res);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="a handle is only unavailable when curl_easy_init runs out of memory" */
+    if (!curl) {
+        tc_transfer_cleanup(&transfer);
+        free(audio.data);
+        return error->code;
+    }
+    /* LCOV_EXCL_STOP */
+
+    /* On success the response carries no audio; only the outcome matters */
+    TypecastTTSResponse* response = tc_transfer_finish_tts(&transfer, curl, res, error);
+    tc_client_release(client, curl);
+    if (response && !sink->write_failed && sink->tee) {
+        tc_result_cache_store(client->result_cache, &transfer, audio.data, audio.size,
+            response->duration, response->format);
+    }
+    free(audio.data);
+    sink->tee = NULL;
+    tc_trace_end(client, &transfer.trace, sink->write_failed ? TYPECAST_ERROR_NETWORK
+        : response ? TYPECAST_OK : error->code);
+    tc_transfer_cleanup(&transfer);
+
+    if (sink->write_failed) {
+        typecast_tts_response_free(response);
+        tc_error_set(error, TYPECAST_ERROR_NETWORK, "Failed to write output file");
+        return TYPECAST_ERROR_NETWORK;
+    }
+    if (!response) return error->code;
+    if (info) {
+        info->duration = response->duration;
+        info->format = response->format;
+    }
+    typecast_tts_response_free(response);
+
+    if (sink->file && fflush(sink->file) != 0) {
+        /* LCOV_EXCL_START */
+        /* category=platform reason="flush failure needs a full disk or a revoked descriptor" */
+        tc_error_set(error, TYPECAST_ERROR_NETWORK, "Failed to write output file");
+        return TYPECAST_ERROR_NETWORK;
+        /* LCOV_EXCL_STOP */
+    }
+    tc_error_clear(error);
+    return TYPECAST_OK;
+}
+
+/* ============================================
+ * Public API
+ * ============================================ */
+
+TYPECAST_API TypecastErrorCode typecast_generate_to_file(
+    TypecastClient* client,
+    const char* file_path,
+    const TypecastGenerateToFileRequest* request
+) {
+    return typecast_generate_to_file_with_info(client, file_path, request, NULL);
+}
+
+TYPECAST_API TypecastErrorCode typecast_generate_to_file_with_info(
+    TypecastClient* client,
+    const char* file_path,
+    const TypecastGenerateToFileRequest* request,
+    TypecastGeneratedAudio* out_info
+) {
+    if (!client || !file_path || !request) {
+        if (client) tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    TypecastErrorCode err = validate_request(client, request);
+    if (err != TYPECAST_OK) return err;
+
+    char temp_path[4096];
+    if (!tc_preflight_output_path(file_path, temp_path, sizeof(temp_path))) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Invalid or unwritable output file");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+
+    FILE* file = fopen(temp_path, "wb");
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="preflight already verified temp output writability" */
+    if (!file) {
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Failed to open output file");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    /* LCOV_EXCL_STOP */
+
+    TcFileSink sink = {0};
+    sink.file = file;
+    sink.fd = -1;
+    err = generate_to_sink(client, request, file_path, &sink, out_info);
+    int close_result = fclose(file);
+    if (err != TYPECAST_OK) {
+        remove(temp_path);
+        return err;
+    }
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="disk-full/write-failure path; cannot be simulated reliably in portable tests" */
+    if (close_result != 0) {
+        remove(temp_path);
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_NETWORK, "Failed to write output file");
+        return TYPECAST_ERROR_NETWORK;
+    }
+    /* LCOV_EXCL_STOP */
+
+    if (!tc_output_move_into_place(temp_path, file_path)) {
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="see tc_output_move_into_place" */
+        tc_error_set(tc_client_error(client), TYPECAST_ERROR_NETWORK, "Failed to move output file into place");
+        return TYPECAST_ERROR_NETWORK;
+        /* LCOV_EXCL_STOP */
+    }
+
+    return TYPECAST_OK;
+}
+
+TYPECAST_API TypecastErrorCode typecast_generate_to_fp(
+    TypecastClient* client,
+    FILE* file,
+    const TypecastGenerateToFileRequest* request
+) {
+    if (!client || !file) {
+        if (client) tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    TypecastErrorCode err = validate_request(client, request);
+    if (err != TYPECAST_OK) return err;
+
+    TcFileSink sink = {0};
+    sink.file = file;
+    sink.fd = -1;
+    return generate_to_sink(client, request, NULL, &sink, NULL);
+}
+
+TYPECAST_API TypecastErrorCode typecast_generate_to_fd(
+    TypecastClient* client,
+    int fd,
+    const TypecastGenerateToFileRequest* request
+) {
+    if (!client || fd < 0) {
+        if (client) tc_error_set(tc_client_error(client), TYPECAST_ERROR_INVALID_PARAM, "Invalid parameters");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    TypecastErrorCode err = validate_request(client, request);
+    if (err != TYPECAST_OK) return err;
+
+    TcFileSink sink = {0};
+    sink.fd = fd;
+    return generate_to_sink(client, request, NULL, &sink, NULL);
+}
@@ -0,0 +1,39 @@
+/**
+ * Typecast C/C++ SDK - Files (typecast_file.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_FILE_H
+#define TYPECAST_FILE_H
+
+#include "typecast_internal.h"
+
+/* Body sink of a generate-to-file request. Exactly one of file / fd is the
+ * destination. */
+typedef struct {
+    TcTransfer* transfer;            /* status and error body of the attempt */
+    FILE* file;
+    int fd;
+    int write_failed;
+    ResponseBuffer* tee;             /* copy of the audio for the result cache */
+} TcFileSink;
+
+/* CURLOPT_WRITEFUNCTION writing a 200 body to a TcFileSink */
+size_t tc_file_sink_write(void* contents, size_t size, size_t nmemb, void* userp);
+
+/* Check that file_path can be written and build the temporary path the
+ * audio goes to first. 0 when the path is blank, a directory or not
+ * writable. */
+int tc_preflight_output_path(const char* file_path, char* temp_path, size_t temp_path_size);
+/* Rename the finished temporary file over file_path; 0 (and the temporary
+ * file removed) on failure */
+int tc_output_move_into_place(const char* temp_path, const char* file_path);
+
+/* The TTS request behind a generate-to-file request. inferred_output
+ * receives the format implied by file_path's extension and is used when
+ * the request has no output settings. */
+void tc_generate_request_to_tts(const TypecastGenerateToFileRequest* request, const char* file_path,
+    TypecastTTSRequest* tts_request, TypecastOutput* inferred_output);
+
+#endif /* TYPECAST_FILE_H */
@@ -0,0 +1,227 @@
+/**
+ * Typecast C/C++ SDK - Request governor
+ *
+ * Fanning out TTS calls past the plan's concurrency limit only buys 429s
+ * followed by idle time. A client created with a concurrency cap or retry
+ * options routes its TTS transfers through this governor, the blocking
+ * ones and the async jobs alike:
+ *
+ *  - At most `window` requests are in flight across all threads. The
+ *    window starts at the cap (max_concurrent_requests, or the plan's
+ *    limits.concurrency_limit) and adapts AIMD style: halved on a 429,
+ *    grown by one per window's worth of successes, never above the cap.
+ *  - 429 and 5xx answers are retried up to max_retries times with
+ *    exponential backoff and jitter, or after the server's Retry-After.
+ *    A Retry-After also holds back every other request of the client, so
+ *    the whole fan-out waits rather than collecting more 429s.
+ *
+ * A blocking call waits for its slot; an async job cannot block the event
+ * loop, so it stays queued until tc_governor_try_enter lets it through.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(_WIN32) || defined(_WIN64)
+    #define strncasecmp _strnicmp
+#else
+    #include <strings.h>  /* for strncasecmp */
+#endif
+#include <curl/curl.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_governor.h"
+
+#define DEFAULT_RETRY_BASE_DELAY_MS 500L
+#define DEFAULT_RETRY_MAX_DELAY_MS 30000L
+
+struct TcGovernor {
+    tc_mutex_t lock;
+    tc_cond_t slot_free;
+    int cap;                         /* 0 = no concurrency cap */
+    double window;                   /* current limit, 1 <= window <= cap */
+    int in_flight;
+    int from_subscription;           /* the plan's limit is still to be read */
+    uint64_t paused_until;           /* tc_monotonic_ms() of the last Retry-After */
+    unsigned int max_retries;
+    long base_delay_ms;
+    long max_delay_ms;
+    uint32_t rng;
+};
+
+TcGovernor* tc_governor_new(const TypecastClientOptions* options) {
+    if (!options || (options->max_retries == 0 && options->max_concurrent_requests <= 0 &&
+                     !options->concurrency_from_subscription)) {
+        return NULL;
+    }
+    TcGovernor* governor = (TcGovernor*)calloc(1, sizeof(*governor));
+    if (!governor) return NULL; /* LCOV_EXCL_LINE category=oom reason="governor allocation" */
+    tc_mutex_init(&governor->lock);
+    tc_cond_init(&governor->slot_free);
+    governor->cap = options->max_concurrent_requests > 0 ? options->max_concurrent_requests : 0;
+    governor->window = governor->cap;
+    governor->from_subscription = options->concurrency_from_subscription != 0;
+    governor->max_retries = options->max_retries;
+    governor->base_delay_ms = options->retry_base_delay_ms > 0
+        ? options->retry_base_delay_ms : DEFAULT_RETRY_BASE_DELAY_MS;
+    governor->max_delay_ms = options->retry_max_delay_ms > 0
+        ? options->retry_max_delay_ms : DEFAULT_RETRY_MAX_DELAY_MS;
+    governor->rng = (uint32_t)time(NULL) ^ (uint32_t)(uintptr_t)governor;
+    if (governor->rng == 0) governor->rng = 1; /* LCOV_EXCL_LINE category=unreachable reason="xorshift seed collision" */
+    return governor;
+}
+
+void tc_governor_free(TcGovernor* governor) {
+    if (!governor) return;
+    tc_cond_destroy(&governor->slot_free);
+    tc_mutex_destroy(&governor->lock);
+    free(governor);
+}
+
+/* Read the plan's concurrency limit, once, while the client is created:
+ * no request ever waits on the lookup. A failed lookup leaves the
+ * configured cap (if any) in place and is not retried. */
+void tc_governor_prime(TypecastClient* client) {
+    TcGovernor* governor = client->governor;
+    if (!governor || !governor->from_subscription) return;
+    governor->from_subscription = 0;
+
+    TypecastSubscription* subscription = typecast_get_my_subscription(client);
+    int limit = subscription ? subscription->limits.concurrency_limit : 0;
+    typecast_subscription_free(subscription);
+    /* A failed lookup is not the caller's error to see */
+    tc_error_clear(tc_client_error(client));
+
+    if (limit > 0 && (governor->cap == 0 || limit < governor->cap)) {
+        governor->cap = limit;
+        governor->window = limit;
+    }
+}
+
+long tc_governor_enter(TcGovernor* governor) {
+    if (!governor) return 0;
+    tc_mutex_lock(&governor->lock);
+    long pause = 0;
+    for (;;) {
+        uint64_t now = tc_monotonic_ms();
+        if (governor->paused_until > now) {
+            pause = (long)(governor->paused_until - now);
+            break;
+        }
+        if (governor->cap == 0 || governor->in_flight < (int)governor->window) {
+            governor->in_flight++;
+            break;
+        }
+        tc_cond_wait(&governor->slot_free, &governor->lock);
+    }
+    tc_mutex_unlock(&governor->lock);
+    return pause;
+}
+
+int tc_governor_try_enter(TcGovernor* governor, uint64_t* paused_until) {
+    *paused_until = 0;
+    if (!governor) return 1;
+    tc_mutex_lock(&governor->lock);
+    int entered = 0;
+    if (governor->paused_until > tc_monotonic_ms()) {
+        *paused_until = governor->paused_until;
+    } else if (governor->cap == 0 || governor->in_flight < (int)governor->window) {
+        governor->in_flight++;
+        entered = 1;
+    }
+    tc_mutex_unlock(&governor->lock);
+    return entered;
+}
+
+/* A day or more (or what does not fit) is LONG_MAX, beyond any
+ * retry_max_delay_ms, so the request gives up instead of retrying now */
+static long hint_ms(long long secs) {
+    if (secs <= 0) return 0;
+    return secs < 86400 ? (long)secs * 1000 : LONG_MAX;
+}
+
+/* Milliseconds to wait according to a Retry-After header, -1 without
+ * one. Both forms are accepted: delay-seconds and an HTTP date. */
+static long retry_after_ms(const char* headers) {
+    if (!headers) return -1;
+    for (const char* line = headers; line; line = strchr(line, '\n')) {
+        if (*line == '\n') line++;
+        if (strncasecmp(line, "retry-after:", 12) != 0) continue;
+        const char* value = line + 12;
+        while (*value == ' ' || *value == '\t') value++;
+        if (*value >= '0' && *value <= '9') {
+            char* end = NULL;
+            long long secs = strtoll(value, &end, 10);
+            return hint_ms(secs);
+        }
+        char date[128];
+        size_t len = strcspn(value, "\r\n");
+        if (len >= sizeof(date)) return -1;
+        memcpy(date, value, len);
+        date[len] = '\0';
+        time_t when = curl_getdate(date, NULL);
+        if (when < 0) return -1;
+        time_t now = time(NULL);
+        return hint_ms(when > now ? (long long)(when - now) : 0);
+    }
+    return -1;
+}
+
+static uint32_t next_random(TcGovernor* governor) {
+    uint32_t x = governor->rng;      /* xorshift32 */
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    governor->rng = x;
+    return x;
+}
+
+static int is_retryable(long status) {
+    return status == 429 || (status >= 500 && status <= 599);
+}
+
+long tc_governor_leave(TcGovernor* governor, unsigned int attempt, int retryable,
+    long http_status, const char* headers) {
+    if (!governor) return -1;
+    long hint = http_status == 429 || http_status == 503 ? retry_after_ms(headers) : -1;
+
+    tc_mutex_lock(&governor->lock);
+    governor->in_flight--;
+    if (governor->cap > 0) {
+        if (http_status == 429) {
+            governor->window = governor->window / 2 < 1.0 ? 1.0 : governor->window / 2;
+        } else if (http_status >= 200 && http_status < 300) {
+            governor->window += 1.0 / governor->window;
+            if (governor->window > governor->cap) governor->window = governor->cap;
+        }
+    }
+
+    long delay = -1;
+    if (retryable && is_retryable(http_status) && attempt < governor->max_retries) {
+        if (hint >= 0) {
+            /* Waiting past our own ceiling is giving up, not retrying */
+            if (hint <= governor->max_delay_ms) {
+                delay = hint;
+                uint64_t until = tc_monotonic_ms() + (uint64_t)hint;
+                if (until > governor->paused_until) governor->paused_until = until;
+            }
+        } else {
+            /* Equal jitter: half the backoff fixed, half random */
+            long backoff = governor->base_delay_ms;
+            for (unsigned int i = 0; i < attempt && backoff < governor->max_delay_ms; i++) backoff *= 2;
+            if (backoff > governor->max_delay_ms) backoff = governor->max_delay_ms;
+            delay = backoff / 2 + (long)(next_random(governor) % (uint32_t)(backoff / 2 + 1));
+        }
+    }
+    tc_cond_broadcast(&governor->slot_free);
+    tc_mutex_unlock(&governor->lock);
+    return delay;
+}
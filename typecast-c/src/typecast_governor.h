@@ -0,0 +1,31 @@
+/**
+ * Typecast C/C++ SDK - Governor (typecast_governor.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_GOVERNOR_H
+#define TYPECAST_GOVERNOR_H
+
+#include "typecast_internal.h"
+
+/* NULL when options set no cap and no retries */
+TcGovernor* tc_governor_new(const TypecastClientOptions* options);
+void tc_governor_free(TcGovernor* governor);
+/* Fetch the plan's concurrency limit when configured to. Called once by
+ * typecast_client_create_with_options, before the client is shared. */
+void tc_governor_prime(TypecastClient* client);
+/* Wait for a free slot and take it, returning 0 (NULL: no-op). During a
+ * Retry-After pause no slot is taken: the pause's remaining ms are
+ * returned for the caller to wait out before entering again. */
+long tc_governor_enter(TcGovernor* governor);
+/* Take a slot without waiting (NULL: always). 0 while the window is full
+ * or a Retry-After pause runs; *paused_until then gets the pause's end in
+ * tc_monotonic_ms(), 0 when waiting for a slot. */
+int tc_governor_try_enter(TcGovernor* governor, uint64_t* paused_until);
+/* Release the slot and record the outcome. Returns the delay in ms
+ * before retrying (attempt is 0 for the first try), -1 for no retry. */
+long tc_governor_leave(TcGovernor* governor, unsigned int attempt, int retryable,
+    long http_status, const char* headers);
+
+#endif /* TYPECAST_GOVERNOR_H */
@@ -0,0 +1,260 @@
+/**
+ * Typecast C/C++ SDK - Hedged requests
+ *
+ * A seeded TTS request renders the same audio however often it is sent,
+ * so a slow one can be raced: if no response byte arrived within the
+ * hedge delay, a duplicate goes to the same host or the next configured
+ * one, both run on a private multi handle, and the first definite answer
+ * wins while the other is cancelled. The delay is fixed or follows a
+ * percentile of the first byte times of recent calls.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <curl/curl.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_governor.h"
+#include "typecast_hedge.h"
+
+#define SAMPLES 128                     /* recent first byte times kept */
+#define MIN_SAMPLES 20                  /* before the percentile is trusted */
+
+struct TcHedge {
+    tc_mutex_t lock;                    /* guards samples and next_host */
+    long after_ms;
+    unsigned int percentile;
+    char** hosts;
+    size_t host_count;
+    size_t next_host;
+    int64_t samples[SAMPLES];           /* microseconds, ring */
+    size_t sample_count;
+    size_t sample_next;
+};
+
+TcHedge* tc_hedge_new(const TypecastClientOptions* options) {
+    if (!options || options->hedge_after_ms <= 0) return NULL;
+    TcHedge* hedge = (TcHedge*)calloc(1, sizeof(*hedge));
+    if (!hedge) return NULL; /* LCOV_EXCL_LINE category=oom reason="hedge state allocation" */
+    tc_mutex_init(&hedge->lock);
+    hedge->after_ms = options->hedge_after_ms;
+    hedge->percentile = options->hedge_percentile < 100 ? options->hedge_percentile : 99;
+    if (options->hedge_hosts && options->hedge_host_count > 0) {
+        hedge->hosts = (char**)calloc(options->hedge_host_count, sizeof(char*));
+        for (size_t i = 0; hedge->hosts && i < options->hedge_host_count; i++) {
+            const char* host = options->hedge_hosts[i];
+            if (tc_is_blank_string(host)) continue;
+            size_t len = strlen(host);
+            char* copy = (char*)malloc(len + 1);
+            if (!copy) continue; /* LCOV_EXCL_LINE category=oom reason="hedge host copy" */
+            memcpy(copy, host, len + 1);
+            hedge->hosts[hedge->host_count++] = copy;
+        }
+    }
+    return hedge;
+}
+
+void tc_hedge_free(TcHedge* hedge) {
+    if (!hedge) return;
+    for (size_t i = 0; i < hedge->host_count; i++) free(hedge->hosts[i]);
+    free(hedge->hosts);
+    tc_mutex_destroy(&hedge->lock);
+    free(hedge);
+}
+
+int tc_hedge_applies(const TypecastClient* client, const TcTransfer* transfer) {
+    return client->hedge && transfer->hedgeable && transfer->kind == TC_REQUEST_TTS &&
+        !transfer->sink_write && !transfer->framer;
+}
+
+static int compare_samples(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static long hedge_delay_ms(TcHedge* hedge) {
+    if (hedge->percentile == 0) return hedge->after_ms;
+    int64_t sorted[SAMPLES];
+    tc_mutex_lock(&hedge->lock);
+    size_t count = hedge->sample_count;
+    memcpy(sorted, hedge->samples, count * sizeof(int64_t));
+    tc_mutex_unlock(&hedge->lock);
+    if (count < MIN_SAMPLES) return hedge->after_ms;
+    qsort(sorted, count, sizeof(int64_t), compare_samples);
+    long ms = (long)(sorted[(count - 1) * hedge->percentile / 100] / 1000);
+    return ms > 0 ? ms : 1;
+}
+
+static void hedge_observe(TcHedge* hedge, CURL* curl) {
+    curl_off_t first_byte = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &first_byte) != CURLE_OK || first_byte <= 0) return;
+    tc_mutex_lock(&hedge->lock);
+    hedge->samples[hedge->sample_next] = (int64_t)first_byte;
+    hedge->sample_next = (hedge->sample_next + 1) % SAMPLES;
+    if (hedge->sample_count < SAMPLES) hedge->sample_count++;
+    tc_mutex_unlock(&hedge->lock);
+}
+
+static const char* hedge_host(TypecastClient* client) {
+    TcHedge* hedge = client->hedge;
+    if (hedge->host_count == 0) return client->host;
+    tc_mutex_lock(&hedge->lock);
+    const char* host = hedge->hosts[hedge->next_host++ % hedge->host_count];
+    tc_mutex_unlock(&hedge->lock);
+    return host;
+}
+
+/* The duplicate shares the body and headers of `transfer` and has its own
+ * response buffers and call settings */
+static void prepare_duplicate(TypecastClient* client, const TcTransfer* transfer, TcTransfer* copy) {
+    memset(copy, 0, sizeof(*copy));
+    copy->kind = transfer->kind;
+    copy->call = transfer->call;
+    copy->format = transfer->format;
+    copy->body = transfer->body;
+    copy->body_len = transfer->body_len;
+    copy->headers = transfer->headers;
+    copy->response.allocator = transfer->response.allocator;
+    copy->response.size_hint = transfer->response.size_hint;
+    const char* path = transfer->url + strlen(client->host);
+    snprintf(copy->url, sizeof(copy->url), "%s%s", hedge_host(client), path);
+}
+
+/* A transport success that is not a 429 or 5xx: the other request would
+ * not answer any better */
+static int is_definite(CURL* curl, CURLcode result) {
+    if (result != CURLE_OK) return 0;
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    return status != 429 && status < 500;
+}
+
+static void swap_responses(TcTransfer* a, TcTransfer* b) {
+    ResponseBuffer response = a->response;
+    HeaderBuffer headers = a->response_headers;
+    long status = a->http_status;
+    a->response = b->response;
+    a->response_headers = b->response_headers;
+    a->http_status = b->http_status;
+    b->response = response;
+    b->response_headers = headers;
+    b->http_status = status;
+}
+
+CURL* tc_hedge_perform(TypecastClient* client, TcTransfer* transfer, CURL* curl, CURLcode* result) {
+    CURLM* multi = curl_multi_init();
+    /* LCOV_EXCL_START */
+    /* category=oom reason="curl_multi_init only fails on OOM" */
+    if (!multi) {
+        *result = curl_easy_perform(curl);
+        return curl;
+    }
+    /* LCOV_EXCL_STOP */
+    curl_multi_add_handle(multi, curl);
+
+    uint64_t hedge_at = tc_monotonic_ms() + (uint64_t)hedge_delay_ms(client->hedge);
+    TcTransfer duplicate;
+    memset(&duplicate, 0, sizeof(duplicate));
+    CURL* spare = NULL;
+    CURL* winner = NULL;
+    CURLcode primary_result = CURLE_OK;
+    int primary_done = 0;
+    int spare_done = 0;
+    int hedged = 0;
+
+    while (!winner) {
+        int running = 0;
+        if (curl_multi_perform(multi, &running) != CURLM_OK) break; /* LCOV_EXCL_LINE category=unreachable reason="multi errors need libcurl internal failures" */
+        CURLMsg* msg;
+        int left = 0;
+        while ((msg = curl_multi_info_read(multi, &left)) != NULL) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            CURLcode done = msg->data.result;
+            if (msg->easy_handle == curl) {
+                primary_done = 1;
+                primary_result = done;
+            } else {
+                spare_done = 1;
+            }
+            if (!winner && is_definite(msg->easy_handle, done)) {
+                winner = msg->easy_handle;
+                *result = done;
+            }
+        }
+        if (winner) break;
+        /* Neither answered for sure: report the original request */
+        if (primary_done && (!spare || spare_done)) {
+            winner = curl;
+            *result = primary_result;
+            break;
+        }
+
+        uint64_t now = tc_monotonic_ms();
+        int first_byte = transfer->response_headers.size > 0 || transfer->response.size > 0;
+        if (!hedged && !primary_done && !first_byte && now >= hedge_at) {
+            hedged = 1;
+            /* The duplicate counts against the cap like any other request,
+             * so a full window or a Retry-After pause means no hedge */
+            uint64_t paused_until = 0;
+            if (tc_governor_try_enter(client->governor, &paused_until)) {
+                spare = tc_client_acquire_spare(client);
+                if (spare) {
+                    prepare_duplicate(client, transfer, &duplicate);
+                    tc_transfer_apply(spare, &duplicate);
+                    curl_multi_add_handle(multi, spare);
+                    transfer->trace.m.hedges++;
+                    continue;
+                }
+                /* LCOV_EXCL_START */
+                /* category=oom reason="a spare handle only fails to come when curl_easy_init does" */
+                tc_governor_leave(client->governor, 0, 0, 0, NULL);
+                /* LCOV_EXCL_STOP */
+            }
+        }
+        int wait_ms = 1000;
+        if (!hedged && !primary_done && !first_byte) {
+            wait_ms = now >= hedge_at ? 1 : (int)(hedge_at - now);
+            if (wait_ms > 1000) wait_ms = 1000;
+        }
+        curl_multi_poll(multi, NULL, 0, wait_ms, NULL);
+    }
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="multi errors need libcurl internal failures" */
+    if (!winner) {
+        winner = curl;
+        *result = CURLE_FAILED_INIT;
+    }
+    /* LCOV_EXCL_STOP */
+
+    /* Removing the handle still in flight cancels it */
+    curl_multi_remove_handle(multi, curl);
+    if (spare) curl_multi_remove_handle(multi, spare);
+    curl_multi_cleanup(multi);
+
+    if (*result == CURLE_OK) hedge_observe(client->hedge, winner);
+    if (spare) {
+        /* The spare's answer still tunes the window; one cut short has none */
+        long spare_status = 0;
+        if (spare_done) curl_easy_getinfo(spare, CURLINFO_RESPONSE_CODE, &spare_status);
+        tc_governor_leave(client->governor, 0, 0, spare_status, NULL);
+        if (winner == spare) {
+            swap_responses(transfer, &duplicate);
+            transfer->trace.m.hedge_won = 1;
+            tc_client_settle(client, spare, curl);
+        } else {
+            tc_client_settle(client, curl, spare);
+        }
+        duplicate.body = NULL;           /* borrowed from transfer */
+        tc_transfer_cleanup(&duplicate);
+    }
+    return winner;
+}
@@ -0,0 +1,22 @@
+/**
+ * Typecast C/C++ SDK - Hedging (typecast_hedge.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_HEDGE_H
+#define TYPECAST_HEDGE_H
+
+#include "typecast_internal.h"
+
+/* NULL when options->hedge_after_ms is not set */
+TcHedge* tc_hedge_new(const TypecastClientOptions* options);
+void tc_hedge_free(TcHedge* hedge);
+/* Whether tc_transfer_perform should race a duplicate of this transfer */
+int tc_hedge_applies(const TypecastClient* client, const TcTransfer* transfer);
+/* Run one attempt of `transfer`, already applied to `curl`, and send a
+ * duplicate if no response byte came within the hedge delay. Returns the
+ * handle holding the result, which replaces `curl` for the caller. */
+CURL* tc_hedge_perform(TypecastClient* client, TcTransfer* transfer, CURL* curl, CURLcode* result);
+
+#endif /* TYPECAST_HEDGE_H */
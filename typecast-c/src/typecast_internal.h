@@ -0,0 +1,301 @@
+/**
+ * Typecast C/C++ SDK - Internal declarations
+ *
+ * Shared between the SDK translation units. Not installed and not part of
+ * the public API. Each module's own declarations are in
+ * src/typecast_<module>.h beside its unit.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_INTERNAL_H
+#define TYPECAST_INTERNAL_H
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <curl/curl.h>
+
+#include "typecast.h"
+
+/* ============================================
+ * Threads
+ * ============================================ */
+
+#ifdef _WIN32
+typedef CRITICAL_SECTION tc_mutex_t;
+typedef CONDITION_VARIABLE tc_cond_t;
+typedef DWORD tc_tls_key_t;          /* fiber-local storage index */
+#else
+typedef pthread_mutex_t tc_mutex_t;
+typedef pthread_cond_t tc_cond_t;
+typedef pthread_key_t tc_tls_key_t;
+#endif
+
+void tc_mutex_init(tc_mutex_t* mutex);
+void tc_mutex_destroy(tc_mutex_t* mutex);
+void tc_mutex_lock(tc_mutex_t* mutex);
+void tc_mutex_unlock(tc_mutex_t* mutex);
+
+void tc_cond_init(tc_cond_t* cond);
+void tc_cond_destroy(tc_cond_t* cond);
+void tc_cond_wait(tc_cond_t* cond, tc_mutex_t* mutex);
+void tc_cond_broadcast(tc_cond_t* cond);
+
+void tc_sleep_ms(long ms);
+uint64_t tc_monotonic_ms(void);
+uint64_t tc_monotonic_us(void);
+
+/* ============================================
+ * Internal Structures
+ * ============================================ */
+
+/* Header lists built once per client. All share X-API-KEY and a
+ * User-Agent that reports the request timeout. */
+typedef enum {
+    TC_HEADERS_JSON,                 /* JSON POST, 60s by default (TTS, compose, stream, timestamps) */
+    TC_HEADERS_QUERY,                /* GET / DELETE, 30s by default */
+    TC_HEADERS_UPLOAD,               /* multipart POST, 120s by default (voice cloning) */
+    TC_HEADERS_COUNT
+} TcHeaderSet;
+
+/* Call options set with typecast_set_call_options */
+typedef struct {
+    int active;
+    TypecastCallOptions options;
+    uint64_t deadline;               /* tc_monotonic_ms(), 0 = none */
+} TcCallScope;
+
+/* Per-thread error and call options of a thread-safe client
+ * (see typecast_error_slots.c) */
+typedef struct TcErrorSlot TcErrorSlot;
+
+typedef struct TcVoiceCache TcVoiceCache;
+typedef struct TcResultCache TcResultCache;
+typedef struct TcGovernor TcGovernor;
+typedef struct TcMetrics TcMetrics;
+typedef struct TcHedge TcHedge;
+
+struct TypecastClient {
+    char* api_key;
+    char* host;
+    CURL* curl;                      /* single handle, NULL in thread-safe mode */
+    TypecastError last_error;
+    TcCallScope call_scope;          /* used without thread_safe */
+    TypecastClientOptions options;
+    struct curl_slist* headers[TC_HEADERS_COUNT];
+
+    /* Async engine (see typecast_async.c) */
+    CURLM* multi;
+    TypecastAsyncJob* jobs;
+    size_t jobs_running;
+
+    /* Thread-safe mode (see typecast_pool.c) */
+    int thread_safe;
+    tc_mutex_t lock;                 /* guards idle */
+    CURL** idle;
+    size_t idle_count;
+    size_t idle_capacity;
+    CURLSH* share;
+    tc_mutex_t share_locks[CURL_LOCK_DATA_LAST];
+    tc_tls_key_t error_key;          /* this thread's TcErrorSlot */
+    int error_key_ready;
+    TcErrorSlot* error_slots;        /* all live slots, global lock */
+
+    /* Voice catalog cache (see typecast_voice_cache.c), NULL when off */
+    TcVoiceCache* voice_cache;
+
+    /* TTS result cache (see typecast_result_cache.c), NULL when off */
+    TcResultCache* result_cache;
+
+    /* Concurrency cap and retries (see typecast_governor.c), NULL when off */
+    TcGovernor* governor;
+
+    /* Call metrics totals and callback (see typecast_metrics.c) */
+    TcMetrics* metrics;
+
+    /* Hedging delay and hosts (see typecast_hedge.c), NULL when off */
+    TcHedge* hedge;
+};
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    const TypecastAllocator* allocator; /* NULL = malloc/free */
+    CURL* curl;                      /* set to presize from Content-Length */
+    size_t size_hint;                /* first allocation without Content-Length */
+    int encoded;                     /* libcurl decompresses the body, so
+                                        Content-Length is only the wire size */
+} ResponseBuffer;
+
+typedef struct {
+    char* data;
+    size_t size;
+} HeaderBuffer;
+
+typedef struct {
+    typecast_stream_callback_t cb;
+    void* user_data;
+    int aborted;
+    uint64_t first_chunk_at;         /* tc_monotonic_us() of the first chunk, 0 = none */
+} StreamCallbackCtx;
+
+/* Metrics of one call being made (see typecast_metrics.c) */
+typedef struct {
+    TypecastRequestMetrics m;
+    uint64_t started_at;             /* tc_monotonic_us() */
+    uint64_t transfer_done_at;       /* end of the last attempt, 0 = none yet */
+    uint64_t first_audio_at;         /* first audio to a callback, 0 = none */
+    uint64_t attempt_decoded;        /* body bytes after decoding, this attempt */
+    int decoded_counted;             /* attempt_decoded was reported */
+} TcRequestTrace;
+
+typedef struct TcTimestampsParser TcTimestampsParser;
+typedef struct TcStreamFramer TcStreamFramer;
+
+/* Which client timeout a request falls under */
+typedef enum {
+    TC_TIMEOUT_REQUEST,              /* TTS, compose, stream, timestamps */
+    TC_TIMEOUT_QUERY,                /* GET / DELETE */
+    TC_TIMEOUT_UPLOAD                /* voice cloning */
+} TcTimeoutClass;
+
+/* Limits of one request: the client's options overlaid with the calling
+ * thread's call options (see typecast_call.c) */
+typedef struct {
+    long timeout_ms;
+    long connect_timeout_ms;
+    uint64_t deadline;               /* tc_monotonic_ms(), 0 = none */
+    TypecastCancelToken* cancel;
+    int expired;                     /* aborted by the progress callback at the deadline */
+    typecast_upload_progress_callback_t on_upload;  /* set by uploads that report progress */
+    void* upload_user_data;
+    long long upload_reported;       /* last byte count passed to on_upload */
+    int upload_aborted;              /* on_upload asked to stop */
+} TcCallSettings;
+
+typedef enum {
+    TC_REQUEST_TTS,
+    TC_REQUEST_COMPOSE,
+    TC_REQUEST_STREAM,
+    TC_REQUEST_TIMESTAMPS
+} TcRequestKind;
+
+/**
+ * One prepared HTTP transfer: the serialized body, headers and response
+ * buffers for a single request. The same transfer can be driven either by
+ * curl_easy_perform (blocking API) or by the client's multi handle (async
+ * API); tc_transfer_finish_* turns the outcome into an SDK result.
+ */
+typedef struct {
+    TcRequestKind kind;
+    char url[1024];
+    char* body;                      /* serialized JSON (tc_json_write) */
+    size_t body_len;
+    struct curl_slist* headers;      /* client's prebuilt list, not owned */
+    TcCallSettings call;
+    TcRequestTrace trace;
+    TypecastAudioFormat format;      /* format requested by the caller */
+    ResponseBuffer response;
+    HeaderBuffer response_headers;
+    StreamCallbackCtx stream;
+    TcStreamFramer* framer;          /* frame-aligned stream delivery, NULL = raw chunks */
+    TcTimestampsParser* timestamps; /* with-timestamps body parser */
+    long http_status;                /* cached by body callbacks, 0 = unknown */
+    ResponseBuffer* tee;             /* also receives a with-timestamps 200 body */
+    size_t (*sink_write)(void* contents, size_t size, size_t nmemb, void* userp);
+    void* sink_data;                 /* sink_write replaces the default body callback */
+    int hedgeable;                   /* seeded: a duplicate renders the same audio */
+    int compressed;                  /* ask for a compressed body (CURLOPT_ACCEPT_ENCODING) */
+    TypecastStreamBuffer* buffer;    /* a stream's 200 body goes here, NULL = stream.cb */
+} TcTransfer;
+
+/* ============================================
+ * Errors
+ * ============================================ */
+
+void tc_error_set(TypecastError* error, TypecastErrorCode code, const char* message);
+void tc_error_clear(TypecastError* error);
+
+/* ============================================
+ * Transfers (typecast.c)
+ * ============================================ */
+
+TypecastErrorCode tc_transfer_prepare_tts(TypecastClient* client,
+    const TypecastTTSRequest* request, TcTransfer* transfer, TypecastError* error);
+TypecastErrorCode tc_transfer_prepare_stream(TypecastClient* client,
+    const TypecastTTSRequestStream* request, typecast_stream_callback_t on_chunk,
+    void* user_data, TcTransfer* transfer, TypecastError* error);
+TypecastErrorCode tc_transfer_prepare_timestamps(TypecastClient* client,
+    const TypecastTTSRequestWithTimestamps* request, TcTransfer* transfer, TypecastError* error);
+/* Serializes the composition into a compose endpoint transfer; errors go
+ * to the composer's client */
+TypecastErrorCode tc_transfer_prepare_composer(TypecastSpeechComposer* composer,
+    TypecastAudioFormat format, TcTransfer* transfer);
+TypecastClient* tc_composer_client(const TypecastSpeechComposer* composer);
+
+void tc_transfer_apply(CURL* curl, TcTransfer* transfer);
+
+/* Check out a handle, apply the transfer and perform it, retrying through
+ * the client's governor. The handle stays checked out so the caller can
+ * finish the transfer before releasing it; NULL (with the error set) when
+ * no handle is available. */
+CURL* tc_transfer_perform(TypecastClient* client, TcTransfer* transfer, CURLcode* result);
+
+/* CURLOPT_WRITEFUNCTION that appends to a ResponseBuffer */
+size_t tc_response_write(void* contents, size_t size, size_t nmemb, void* userp);
+int tc_is_blank_string(const char* str);
+void tc_transfer_cleanup(TcTransfer* transfer);
+/* Drop what a failed attempt received so the retry starts clean */
+void tc_transfer_rewind(TcTransfer* transfer);
+
+TypecastTTSResponse* tc_transfer_finish_tts(TcTransfer* transfer, CURL* curl,
+    CURLcode result, TypecastError* error);
+TypecastErrorCode tc_transfer_finish_stream(TcTransfer* transfer, CURL* curl,
+    CURLcode result, TypecastError* error);
+TypecastErrorCode tc_transfer_finish_timestamps(TcTransfer* transfer, CURL* curl,
+    CURLcode result, TypecastTTSWithTimestampsResponse** out_response, TypecastError* error);
+
+/* ============================================
+ * Client handles and errors (typecast_pool.c)
+ * ============================================ */
+
+void tc_global_init(void);
+/* Process-wide lock for library state shared by all clients */
+void tc_global_lock(void);
+void tc_global_unlock(void);
+TypecastErrorCode tc_client_setup(TypecastClient* client, const TypecastClientOptions* options);
+void tc_client_teardown(TypecastClient* client);
+
+/* Error target for the calling thread (never NULL; typecast_error_slots.c) */
+TypecastError* tc_client_error(TypecastClient* client);
+/* Call options of the calling thread (NULL only when out of memory) */
+TcCallScope* tc_client_call_scope(TypecastClient* client);
+/* Per-thread slots of a thread-safe client; init is -1 when no
+ * thread-local key is left, release frees or orphans every slot */
+int tc_error_slots_init(TypecastClient* client);
+void tc_error_slots_release(TypecastClient* client);
+
+/* Check out an easy handle for one request; NULL on OOM. Persistent
+ * options are kept, per-request options are cleared. */
+CURL* tc_client_acquire(TypecastClient* client);
+void tc_client_release(TypecastClient* client, CURL* curl);
+/* A second handle to race the one from tc_client_acquire; NULL on OOM */
+CURL* tc_client_acquire_spare(TypecastClient* client);
+/* After a race, drop `loser` and keep `winner` as the handle the caller
+ * releases */
+void tc_client_settle(TypecastClient* client, CURL* winner, CURL* loser);
+
+/* Apply persistent options (TLS, keep-alive, HTTP version, shared caches)
+ * to a fresh easy handle */
+void tc_client_configure_handle(TypecastClient* client, CURL* curl);
+
+/* Clear every per-request option the SDK sets, keeping persistent ones and
+ * the handle's connection */
+void tc_request_reset(CURL* curl);
+
+#endif /* TYPECAST_INTERNAL_H */
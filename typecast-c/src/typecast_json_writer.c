@@ -0,0 +1,171 @@
+/**
+ * Typecast C/C++ SDK - Direct JSON writer for request bodies
+ *
+ * Request bodies used to be built as a cJSON tree, printed and freed,
+ * one node allocation per field. The writer here emits the text
+ * directly: an emitter runs once to measure the body and once more into
+ * a buffer of exactly that size, so a body costs one allocation however
+ * many segments it holds. The output matches cJSON_PrintUnformatted
+ * byte for byte (same escaping and number format), which keeps result
+ * cache keys stable.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_json_writer.h"
+
+static void put(TcJsonWriter* w, const char* data, size_t len) {
+    if (w->buf) memcpy(w->buf + w->len, data, len);
+    w->len += len;
+}
+
+static void put_char(TcJsonWriter* w, char c) {
+    if (w->buf) w->buf[w->len] = c;
+    w->len++;
+}
+
+/* Separator before a value or key of the innermost container */
+static void begin_item(TcJsonWriter* w) {
+    if (w->after_key) {
+        w->after_key = 0;
+        return;
+    }
+    if (w->depth == 0) return;
+    unsigned int bit = 1u << (w->depth - 1);
+    if (w->has_items & bit) put_char(w, ',');
+    w->has_items |= bit;
+}
+
+static void put_string_n(TcJsonWriter* w, const char* str, size_t len) {
+    static const char HEX[] = "0123456789abcdef";
+    put_char(w, '"');
+    const unsigned char* run = (const unsigned char*)str;
+    const unsigned char* p = run;
+    const unsigned char* end = run + len;
+    for (; p < end; p++) {
+        unsigned char c = *p;
+        if (c > 31 && c != '"' && c != '\\') continue;
+        put(w, (const char*)run, (size_t)(p - run));
+        run = p + 1;
+        char esc[6] = {'\\', 0, 0, 0, 0, 0};
+        size_t len = 2;
+        switch (c) {
+            case '"': esc[1] = '"'; break;
+            case '\\': esc[1] = '\\'; break;
+            case '\b': esc[1] = 'b'; break;
+            case '\f': esc[1] = 'f'; break;
+            case '\n': esc[1] = 'n'; break;
+            case '\r': esc[1] = 'r'; break;
+            case '\t': esc[1] = 't'; break;
+            default:
+                esc[1] = 'u';
+                esc[2] = '0';
+                esc[3] = '0';
+                esc[4] = HEX[c >> 4];
+                esc[5] = HEX[c & 0x0F];
+                len = 6;
+                break;
+        }
+        put(w, esc, len);
+    }
+    put(w, (const char*)run, (size_t)(p - run));
+    put_char(w, '"');
+}
+
+static void put_string(TcJsonWriter* w, const char* str) {
+    put_string_n(w, str, strlen(str));
+}
+
+void tc_json_begin_object(TcJsonWriter* w) {
+    begin_item(w);
+    put_char(w, '{');
+    w->depth++;
+    w->has_items &= ~(1u << (w->depth - 1));
+}
+
+void tc_json_end_object(TcJsonWriter* w) {
+    put_char(w, '}');
+    w->depth--;
+}
+
+void tc_json_begin_array(TcJsonWriter* w) {
+    begin_item(w);
+    put_char(w, '[');
+    w->depth++;
+    w->has_items &= ~(1u << (w->depth - 1));
+}
+
+void tc_json_end_array(TcJsonWriter* w) {
+    put_char(w, ']');
+    w->depth--;
+}
+
+void tc_json_key(TcJsonWriter* w, const char* key) {
+    begin_item(w);
+    put_string(w, key);
+    put_char(w, ':');
+    w->after_key = 1;
+}
+
+void tc_json_string(TcJsonWriter* w, const char* value) {
+    begin_item(w);
+    put_string(w, value ? value : "");
+}
+
+void tc_json_string_n(TcJsonWriter* w, const char* value, size_t len) {
+    begin_item(w);
+    put_string_n(w, value ? value : "", value ? len : 0);
+}
+
+void tc_json_number(TcJsonWriter* w, double value) {
+    begin_item(w);
+    /* Zero too, as the bundled cJSON printer does, so bodies are unchanged */
+    if (!isfinite(value) || value == 0) {
+        put(w, "null", 4);
+        return;
+    }
+    char text[64];
+    int len = snprintf(text, sizeof(text), "%.15g", value);
+    put(w, text, (size_t)len);
+}
+
+void tc_json_field_string(TcJsonWriter* w, const char* key, const char* value) {
+    tc_json_key(w, key);
+    tc_json_string(w, value);
+}
+
+void tc_json_field_string_n(TcJsonWriter* w, const char* key, const char* value, size_t len) {
+    tc_json_key(w, key);
+    tc_json_string_n(w, value, len);
+}
+
+void tc_json_field_number(TcJsonWriter* w, const char* key, double value) {
+    tc_json_key(w, key);
+    tc_json_number(w, value);
+}
+
+char* tc_json_write(tc_json_emit_t emit, const void* ctx, size_t* out_len) {
+    TcJsonWriter w = {0};
+    emit(&w, ctx);
+    size_t len = w.len;
+
+    char* buf = (char*)malloc(len + 1);
+    if (!buf) return NULL; /* LCOV_EXCL_LINE category=oom reason="request body allocation" */
+    memset(&w, 0, sizeof(w));
+    w.buf = buf;
+    emit(&w, ctx);
+    buf[len] = '\0';
+    if (out_len) *out_len = len;
+    return buf;
+}
@@ -0,0 +1,42 @@
+/**
+ * Typecast C/C++ SDK - JSON writer (typecast_json_writer.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_JSON_WRITER_H
+#define TYPECAST_JSON_WRITER_H
+
+#include "typecast_internal.h"
+
+/* Emits JSON text into `buf`, or only counts it in `len` while `buf` is
+ * NULL. Containers nest at most 32 deep. */
+typedef struct {
+    char* buf;
+    size_t len;
+    unsigned int depth;
+    unsigned int has_items;          /* bit per open container */
+    int after_key;
+} TcJsonWriter;
+
+void tc_json_begin_object(TcJsonWriter* w);
+void tc_json_end_object(TcJsonWriter* w);
+void tc_json_begin_array(TcJsonWriter* w);
+void tc_json_end_array(TcJsonWriter* w);
+/* Start a member; the next value or container is its value */
+void tc_json_key(TcJsonWriter* w, const char* key);
+void tc_json_string(TcJsonWriter* w, const char* value);
+/* `len` bytes of value, which need not be NUL-terminated */
+void tc_json_string_n(TcJsonWriter* w, const char* value, size_t len);
+void tc_json_number(TcJsonWriter* w, double value);
+void tc_json_field_string(TcJsonWriter* w, const char* key, const char* value);
+void tc_json_field_string_n(TcJsonWriter* w, const char* key, const char* value, size_t len);
+void tc_json_field_number(TcJsonWriter* w, const char* key, double value);
+
+/* Writes one complete value; must emit the same text on every call */
+typedef void (*tc_json_emit_t)(TcJsonWriter* w, const void* ctx);
+/* Run `emit` to measure, then into one exactly sized, NUL-terminated
+ * allocation (caller frees). NULL on allocation failure. */
+char* tc_json_write(tc_json_emit_t emit, const void* ctx, size_t* out_len);
+
+#endif /* TYPECAST_JSON_WRITER_H */
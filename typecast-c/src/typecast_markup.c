@@ -0,0 +1,156 @@
+/**
+ * Typecast C/C++ SDK - Pause markup
+ *
+ * Splits text at <|{seconds}s|> tokens in one pass. The scanner jumps
+ * between '<' candidates with memchr and reads a token in place, so it
+ * never searches ahead for the closing "|>" and never copies text: each
+ * part is reported as a span of the input. typecast_parse_pause_markup()
+ * keeps its owned-string results on top of the same scanner, with the
+ * part array sized up front.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_markup.h"
+
+#define MAX_TOKEN 64                    /* longest "{seconds}s" accepted */
+
+/* Length of the pause token at `p` ("<|" already matched at p - 2) up to
+ * and including the closing "|>", or 0 when it is not a valid pause */
+static size_t read_pause_token(const char* p, const char* end, float* seconds) {
+    const char* q = p;
+    while (q < end && (isdigit((unsigned char)*q) || *q == '.')) q++;
+    size_t digits = (size_t)(q - p);
+    if (digits == 0 || digits + 1 >= MAX_TOKEN) return 0;
+    if (end - q < 3 || q[0] != 's' || q[1] != '|' || q[2] != '>') return 0;
+
+    char buf[MAX_TOKEN];
+    memcpy(buf, p, digits);
+    buf[digits] = '\0';
+    char* parsed = NULL;
+    float value = strtof(buf, &parsed);
+    if (!parsed || *parsed != '\0' || !isfinite(value) || value <= 0.0f) return 0;
+    *seconds = value;
+    return digits + 3;
+}
+
+int tc_pause_markup_scan(const char* text, size_t len, tc_markup_visit_t visit, void* ctx) {
+    const char* end = text + len;
+    const char* part = text;
+    const char* p = text;
+    int rc;
+
+    while (end - p >= 2) {
+        const char* open = (const char*)memchr(p, '<', (size_t)(end - p - 1));
+        if (!open) break;
+        p = open + 1;
+        if (*p != '|') continue;
+        p++;
+        float seconds = 0.0f;
+        size_t token = read_pause_token(p, end, &seconds);
+        /* An invalid token stays text; a "<|" inside it may still open one */
+        if (token == 0) continue;
+
+        TypecastSpeechSpan span = {(size_t)(part - text), (size_t)(open - part), 0.0f, 0};
+        if ((rc = visit(&span, ctx)) != 0) return rc;
+        TypecastSpeechSpan pause = {(size_t)(open - text), 0, seconds, 1};
+        if ((rc = visit(&pause, ctx)) != 0) return rc;
+        p += token;
+        part = p;
+    }
+    TypecastSpeechSpan tail = {(size_t)(part - text), (size_t)(end - part), 0.0f, 0};
+    return visit(&tail, ctx);
+}
+
+typedef struct {
+    TypecastSpeechSpan* spans;
+    size_t capacity;
+    size_t count;
+} SpanArray;
+
+static int collect_span(const TypecastSpeechSpan* span, void* ctx) {
+    SpanArray* out = (SpanArray*)ctx;
+    if (out->count < out->capacity) out->spans[out->count] = *span;
+    out->count++;
+    return 0;
+}
+
+TYPECAST_API TypecastErrorCode typecast_parse_pause_markup_spans(
+    const char* text,
+    TypecastSpeechSpan* spans,
+    size_t capacity,
+    size_t* out_count
+) {
+    if (!text || !out_count || (!spans && capacity > 0)) return TYPECAST_ERROR_INVALID_PARAM;
+    SpanArray out = {spans, capacity, 0};
+    tc_pause_markup_scan(text, strlen(text), collect_span, &out);
+    *out_count = out.count;
+    return TYPECAST_OK;
+}
+
+typedef struct {
+    const char* text;
+    TypecastSpeechPart* parts;
+    size_t count;
+} PartArray;
+
+static int copy_part(const TypecastSpeechSpan* span, void* ctx) {
+    PartArray* out = (PartArray*)ctx;
+    TypecastSpeechPart* part = &out->parts[out->count];
+    part->is_pause = span->is_pause;
+    part->pause_seconds = span->pause_seconds;
+    part->text = NULL;
+    if (!span->is_pause) {
+        part->text = (char*)malloc(span->length + 1);
+        if (!part->text) return 1; /* LCOV_EXCL_LINE category=oom reason="part text allocation" */
+        memcpy(part->text, out->text + span->offset, span->length);
+        part->text[span->length] = '\0';
+    }
+    out->count++;
+    return 0;
+}
+
+TYPECAST_API TypecastErrorCode typecast_parse_pause_markup(
+    const char* text,
+    TypecastSpeechPart** out_parts,
+    size_t* out_count
+) {
+    if (!text || !out_parts || !out_count) return TYPECAST_ERROR_INVALID_PARAM;
+    *out_parts = NULL;
+    *out_count = 0;
+
+    size_t len = strlen(text);
+    SpanArray measure = {NULL, 0, 0};
+    tc_pause_markup_scan(text, len, collect_span, &measure);
+    PartArray out = {text, (TypecastSpeechPart*)malloc(measure.count * sizeof(TypecastSpeechPart)), 0};
+    if (!out.parts) return TYPECAST_ERROR_OUT_OF_MEMORY; /* LCOV_EXCL_LINE category=oom reason="part array allocation" */
+    /* LCOV_EXCL_START */
+    /* category=oom reason="part text allocation" */
+    if (tc_pause_markup_scan(text, len, copy_part, &out) != 0) {
+        typecast_speech_parts_free(out.parts, out.count);
+        return TYPECAST_ERROR_OUT_OF_MEMORY;
+    }
+    /* LCOV_EXCL_STOP */
+    *out_parts = out.parts;
+    *out_count = out.count;
+    return TYPECAST_OK;
+}
+
+TYPECAST_API void typecast_speech_parts_free(TypecastSpeechPart* parts, size_t count) {
+    if (!parts) return;
+    for (size_t i = 0; i < count; i++) {
+        free(parts[i].text);
+    }
+    free(parts);
+}
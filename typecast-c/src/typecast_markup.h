@@ -0,0 +1,17 @@
+/**
+ * Typecast C/C++ SDK - Pause markup (typecast_markup.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_MARKUP_H
+#define TYPECAST_MARKUP_H
+
+#include "typecast_internal.h"
+
+/* Called with each part in order; a non-zero return stops the scan */
+typedef int (*tc_markup_visit_t)(const TypecastSpeechSpan* span, void* ctx);
+/* 0 after the last part, otherwise what `visit` returned */
+int tc_pause_markup_scan(const char* text, size_t len, tc_markup_visit_t visit, void* ctx);
+
+#endif /* TYPECAST_MARKUP_H */
@@ -0,0 +1,142 @@
+/**
+ * Typecast C/C++ SDK - Call metrics
+ *
+ * Each call that reaches the network carries a TcRequestTrace: the SDK
+ * stamps it when the request is built, after every attempt (libcurl's
+ * phase times, connection reuse, body sizes) and when the result is
+ * ready. The finished TypecastRequestMetrics goes to the client's
+ * metrics_callback and into running totals read with
+ * typecast_client_metrics.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <curl/curl.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_metrics.h"
+
+struct TcMetrics {
+    tc_mutex_t lock;
+    TypecastClientMetrics totals;
+    typecast_metrics_callback_t callback;
+    void* user_data;
+};
+
+TcMetrics* tc_metrics_new(const TypecastClientOptions* options) {
+    TcMetrics* metrics = (TcMetrics*)calloc(1, sizeof(*metrics));
+    if (!metrics) return NULL; /* LCOV_EXCL_LINE category=oom reason="metrics allocation" */
+    tc_mutex_init(&metrics->lock);
+    if (options) {
+        metrics->callback = options->metrics_callback;
+        metrics->user_data = options->metrics_user_data;
+    }
+    return metrics;
+}
+
+void tc_metrics_free(TcMetrics* metrics) {
+    if (!metrics) return;
+    tc_mutex_destroy(&metrics->lock);
+    free(metrics);
+}
+
+TYPECAST_API TypecastErrorCode typecast_client_metrics(TypecastClient* client, TypecastClientMetrics* out) {
+    if (!client || !out) return TYPECAST_ERROR_INVALID_PARAM;
+    memset(out, 0, sizeof(*out));
+    TcMetrics* metrics = client->metrics;
+    if (!metrics) return TYPECAST_OK; /* LCOV_EXCL_LINE category=oom reason="metrics allocation failed at create" */
+    tc_mutex_lock(&metrics->lock);
+    *out = metrics->totals;
+    tc_mutex_unlock(&metrics->lock);
+    return TYPECAST_OK;
+}
+
+TYPECAST_API void typecast_client_metrics_reset(TypecastClient* client) {
+    if (!client || !client->metrics) return;
+    tc_mutex_lock(&client->metrics->lock);
+    memset(&client->metrics->totals, 0, sizeof(client->metrics->totals));
+    tc_mutex_unlock(&client->metrics->lock);
+}
+
+/* ============================================
+ * Traces
+ * ============================================ */
+
+static int64_t since(uint64_t from, uint64_t to) {
+    return to > from ? (int64_t)(to - from) : 0;
+}
+
+void tc_trace_begin(TcRequestTrace* trace, TypecastRequestType type, uint64_t started) {
+    memset(trace, 0, sizeof(*trace));
+    trace->m.type = type;
+    trace->started_at = started;
+}
+
+void tc_trace_prepared(TcRequestTrace* trace) {
+    trace->m.prepare_us = since(trace->started_at, tc_monotonic_us());
+}
+
+void tc_trace_decoded(TcRequestTrace* trace, size_t bytes) {
+    trace->attempt_decoded += bytes;
+    trace->decoded_counted = 1;
+}
+
+void tc_trace_attempt(TcRequestTrace* trace, CURL* curl) {
+    TypecastRequestMetrics* m = &trace->m;
+    curl_off_t value = 0;
+    m->attempts++;
+    if (curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &value) == CURLE_OK) m->dns_us = value;
+    if (curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &value) == CURLE_OK) m->connect_us = value;
+    if (curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &value) == CURLE_OK) m->tls_us = value;
+    if (curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &value) == CURLE_OK) m->first_byte_us = value;
+    if (curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &value) == CURLE_OK) m->transfer_us = value;
+    value = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_SIZE_UPLOAD_T, &value) == CURLE_OK && value > 0) m->bytes_sent += (uint64_t)value;
+    value = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &value) == CURLE_OK && value > 0) m->bytes_received += (uint64_t)value;
+    m->bytes_decoded += trace->decoded_counted ? trace->attempt_decoded : (uint64_t)(value > 0 ? value : 0);
+    trace->attempt_decoded = 0;
+    trace->decoded_counted = 0;
+    long connects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects);
+    m->connection_reused = connects == 0;
+    m->http_status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &m->http_status);
+    trace->transfer_done_at = tc_monotonic_us();
+}
+
+void tc_trace_end(TypecastClient* client, TcRequestTrace* trace, TypecastErrorCode result) {
+    TcMetrics* metrics = client ? client->metrics : NULL;
+    TypecastRequestMetrics* m = &trace->m;
+    if (!metrics || m->attempts == 0) return;
+    uint64_t now = tc_monotonic_us();
+    m->result = result;
+    m->call_us = since(trace->started_at, now);
+    m->parse_us += since(trace->transfer_done_at, now);
+    if (trace->first_audio_at) m->first_audio_us = since(trace->started_at, trace->first_audio_at);
+
+    tc_mutex_lock(&metrics->lock);
+    TypecastClientMetrics* t = &metrics->totals;
+    t->calls++;
+    if (result != TYPECAST_OK) t->failed_calls++;
+    t->attempts += m->attempts;
+    if (m->connection_reused) t->reused_connections++;
+    t->bytes_sent += m->bytes_sent;
+    t->bytes_received += m->bytes_received;
+    t->bytes_decoded += m->bytes_decoded;
+    t->call_us += (unsigned long long)m->call_us;
+    t->first_byte_us += (unsigned long long)m->first_byte_us;
+    t->sdk_us += (unsigned long long)(m->prepare_us + m->parse_us + m->decode_us);
+    if (m->hedges > 0) t->hedged_calls++;
+    if (m->hedge_won) t->hedge_wins++;
+    tc_mutex_unlock(&metrics->lock);
+
+    if (metrics->callback) metrics->callback(m, metrics->user_data);
+}
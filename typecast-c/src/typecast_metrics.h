@@ -0,0 +1,27 @@
+/**
+ * Typecast C/C++ SDK - Metrics (typecast_metrics.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_METRICS_H
+#define TYPECAST_METRICS_H
+
+#include "typecast_internal.h"
+
+TcMetrics* tc_metrics_new(const TypecastClientOptions* options);
+void tc_metrics_free(TcMetrics* metrics);
+/* Start timing a call at `started` (tc_monotonic_us()) */
+void tc_trace_begin(TcRequestTrace* trace, TypecastRequestType type, uint64_t started);
+/* The request is built; the time since the start counts as prepare_us */
+void tc_trace_prepared(TcRequestTrace* trace);
+/* Count `bytes` of the current attempt's body after content decoding.
+ * Attempts that report none count the transferred size. */
+void tc_trace_decoded(TcRequestTrace* trace, size_t bytes);
+/* Read the outcome of an attempt that just ended on `curl` */
+void tc_trace_attempt(TcRequestTrace* trace, CURL* curl);
+/* Finish the call: time since the last attempt counts as parse_us. Reports
+ * to the client's totals and callback unless no attempt was made. */
+void tc_trace_end(TypecastClient* client, TcRequestTrace* trace, TypecastErrorCode result);
+
+#endif /* TYPECAST_METRICS_H */
@@ -0,0 +1,354 @@
+/**
+ * Typecast C/C++ SDK - Pipelined sentence-level TTS
+ *
+ * A text longer than one request allows is split into sentences, which
+ * render as independent TTS requests on the client's async engine while
+ * the audio is handed to the caller in order. At most max_in_flight
+ * sentences are outstanding at once, counting those finished but still
+ * waiting for an earlier one, so buffered audio stays bounded.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_captions.h"
+#include "typecast_wav.h"
+
+#define MAX_REQUEST_CHARS 2000
+#define DEFAULT_MAX_IN_FLIGHT 4
+#define POLL_INTERVAL_MS 100
+
+typedef struct {
+    char** items;
+    size_t count;
+    size_t capacity;
+} SentenceList;
+
+static void sentences_free(SentenceList* list) {
+    for (size_t i = 0; i < list->count; i++) free(list->items[i]);
+    free(list->items);
+    memset(list, 0, sizeof(*list));
+}
+
+/* ============================================
+ * Splitting
+ * ============================================ */
+
+static int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/* Closing quotes and brackets that stay with the sentence they end */
+static size_t closer_len(const char* s) {
+    static const char* const WIDE[] = {
+        "\xe2\x80\x9d",  /* ” U+201D */
+        "\xe2\x80\x99",  /* ’ U+2019 */
+        "\xe3\x80\x8d",  /* 」 U+300D */
+        "\xe3\x80\x8f",  /* 』 U+300F */
+        "\xef\xbc\x89",  /* ） U+FF09 */
+        NULL
+    };
+    if (*s == '"' || *s == '\'' || *s == ')' || *s == ']') return 1;
+    for (int i = 0; WIDE[i]; i++) {
+        if (strncmp(s, WIDE[i], 3) == 0) return 3;
+    }
+    return 0;
+}
+
+static int list_append(SentenceList* list, char* text) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 16;
+        char** items = (char**)realloc(list->items, capacity * sizeof(char*));
+        if (!items) return 0; /* LCOV_EXCL_LINE category=oom reason="growth of the sentence list" */
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = text;
+    return 1;
+}
+
+static char* copy_range(const char* start, size_t len) {
+    char* text = (char*)malloc(len + 1);
+    if (!text) return NULL; /* LCOV_EXCL_LINE category=oom reason="sentence copy" */
+    memcpy(text, start, len);
+    text[len] = '\0';
+    return text;
+}
+
+/* Byte offset just past the first `chars` codepoints of text */
+static size_t codepoint_offset(const char* text, size_t chars) {
+    const unsigned char* p = (const unsigned char*)text;
+    size_t seen = 0, i = 0;
+    for (; p[i]; i++) {
+        if ((p[i] & 0xc0) != 0x80 && seen++ == chars) break;
+    }
+    return i;
+}
+
+/* Add the trimmed range as one sentence, or as several when it is over
+ * the request limit: cut at the last space before the limit, or right at
+ * the limit when there is none */
+static int push_sentence(SentenceList* list, const char* start, size_t len) {
+    while (len > 0 && is_space(*start)) {
+        start++;
+        len--;
+    }
+    while (len > 0 && is_space(start[len - 1])) len--;
+    while (len > 0) {
+        char* text = copy_range(start, len);
+        if (!text) return 0; /* LCOV_EXCL_LINE category=oom reason="sentence copy" */
+        if (tc_utf8_codepoint_count(text) <= MAX_REQUEST_CHARS) {
+            if (!list_append(list, text)) { free(text); return 0; } /* LCOV_EXCL_LINE category=oom reason="growth of the sentence list" */
+            return 1;
+        }
+        size_t cut = codepoint_offset(text, MAX_REQUEST_CHARS);
+        size_t space = cut;
+        while (space > 0 && !is_space(text[space])) space--;
+        if (space > 0) cut = space;
+        free(text);
+
+        size_t head = cut;
+        while (head > 0 && is_space(start[head - 1])) head--;
+        text = copy_range(start, head);
+        if (!text || !list_append(list, text)) { free(text); return 0; } /* LCOV_EXCL_LINE category=oom reason="sentence copy" */
+        start += cut;
+        len -= cut;
+        while (len > 0 && is_space(*start)) {
+            start++;
+            len--;
+        }
+    }
+    return 1;
+}
+
+/* Sentences end at a terminator run (with its closing quotes) followed by
+ * whitespace or the end of the text, after a full-width terminator even
+ * without a space, and at a blank line */
+static int split_sentences(const char* text, SentenceList* list) {
+    const char* start = text;
+    const char* p = text;
+    while (*p) {
+        size_t t = tc_sentence_terminator_len(p);
+        if (t) {
+            int wide = 0;
+            const char* q = p;
+            for (;;) {
+                size_t n = tc_sentence_terminator_len(q);
+                if (n > 1) wide = 1;
+                if (!n) n = closer_len(q);
+                if (!n) break;
+                q += n;
+            }
+            if (wide || *q == '\0' || is_space(*q)) {
+                if (!push_sentence(list, start, (size_t)(q - start))) return 0; /* LCOV_EXCL_LINE category=oom reason="sentence copy" */
+                start = q;
+            }
+            p = q;
+            continue;
+        }
+        if (*p == '\n') {
+            const char* q = p + 1;
+            while (*q == ' ' || *q == '\t' || *q == '\r') q++;
+            if (*q == '\n') {
+                if (!push_sentence(list, start, (size_t)(p - start))) return 0; /* LCOV_EXCL_LINE category=oom reason="sentence copy" */
+                start = q;
+                p = q;
+                continue;
+            }
+        }
+        p++;
+    }
+    return push_sentence(list, start, (size_t)(p - start));
+}
+
+/* Join neighbouring sentences, separated by a space, while the request
+ * stays within max_chars */
+static int pack_sentences(SentenceList* list, size_t max_chars) {
+    if (max_chars == 0 || list->count < 2) return 1;
+    if (max_chars > MAX_REQUEST_CHARS) max_chars = MAX_REQUEST_CHARS;
+    size_t out = 0;
+    size_t out_chars = tc_utf8_codepoint_count(list->items[0]);
+    for (size_t i = 1; i < list->count; i++) {
+        char* next = list->items[i];
+        size_t next_chars = tc_utf8_codepoint_count(next);
+        if (out_chars + 1 + next_chars > max_chars) {
+            list->items[++out] = next;
+            out_chars = next_chars;
+            continue;
+        }
+        size_t a = strlen(list->items[out]), b = strlen(next);
+        char* joined = (char*)realloc(list->items[out], a + 1 + b + 1);
+        /* LCOV_EXCL_START */
+        /* category=oom reason="growth of a packed request" */
+        if (!joined) {
+            list->count = out + 1 + (list->count - i);
+            memmove(list->items + out + 1, list->items + i, (list->count - out - 1) * sizeof(char*));
+            return 0;
+        }
+        /* LCOV_EXCL_STOP */
+        joined[a] = ' ';
+        memcpy(joined + a + 1, next, b + 1);
+        free(next);
+        list->items[out] = joined;
+        out_chars += 1 + next_chars;
+    }
+    list->count = out + 1;
+    return 1;
+}
+
+/* ============================================
+ * Output
+ * ============================================ */
+
+typedef struct {
+    typecast_stream_callback_t on_chunk;
+    void* user_data;
+    int wav;
+    int have_format;
+    TcWavInfo format;
+} Emitter;
+
+static TypecastErrorCode emit(Emitter* e, const uint8_t* data, size_t size, TypecastError* error) {
+    if (size == 0) return TYPECAST_OK;
+    if (e->on_chunk(data, size, e->user_data) != 0) {
+        tc_error_set(error, TYPECAST_ERROR_NETWORK, "Stream aborted by callback");
+        return TYPECAST_ERROR_NETWORK;
+    }
+    return TYPECAST_OK;
+}
+
+static TypecastErrorCode emit_sentence(Emitter* e, const TypecastTTSResponse* audio, TypecastError* error) {
+    const uint8_t* data = audio->audio_data;
+    size_t size = audio->audio_size;
+    if (!e->wav) return emit(e, data, size, error);
+
+    TcWavInfo info;
+    if (!tc_wav_parse(data, size, &info)) {
+        tc_error_set(error, TYPECAST_ERROR_JSON_PARSE, "Segment audio is not a WAV file");
+        return TYPECAST_ERROR_JSON_PARSE;
+    }
+    if (!e->have_format) {
+        uint8_t header[TC_WAV_HEADER_SIZE];
+        e->format = info;
+        e->have_format = 1;
+        tc_wav_write_header(header, &info, 0xFFFFFFFFu);
+        TypecastErrorCode err = emit(e, header, sizeof(header), error);
+        if (err != TYPECAST_OK) return err;
+    } else if (!tc_wav_same_format(&e->format, &info)) {
+        tc_error_set(error, TYPECAST_ERROR_JSON_PARSE, "Segment audio formats differ");
+        return TYPECAST_ERROR_JSON_PARSE;
+    }
+    return emit(e, info.data, info.data_size, error);
+}
+
+/* ============================================
+ * Pipeline
+ * ============================================ */
+
+static TypecastAsyncJob* submit_sentence(TypecastClient* client, const TypecastTTSRequest* request,
+    const SentenceList* list, size_t index) {
+    TypecastTTSRequest sentence = *request;
+    TypecastPrompt prompt;
+    sentence.text = list->items[index];
+    if (request->prompt && request->prompt->emotion_type == TYPECAST_EMOTION_TYPE_SMART) {
+        prompt = *request->prompt;
+        if (index > 0) prompt.previous_text = list->items[index - 1];
+        if (index + 1 < list->count) prompt.next_text = list->items[index + 1];
+        sentence.prompt = &prompt;
+    }
+    return typecast_async_text_to_speech(client, &sentence, NULL, NULL);
+}
+
+TYPECAST_API TypecastErrorCode typecast_text_to_speech_pipelined(
+    TypecastClient* client,
+    const TypecastTTSRequest* request,
+    const TypecastPipelineOptions* options,
+    typecast_stream_callback_t on_chunk,
+    void* user_data
+) {
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    TypecastError* error = tc_client_error(client);
+    if (!request || !on_chunk || !request->text || !request->voice_id) {
+        tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, "request, text, voice_id and on_chunk are required");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    size_t max_in_flight = options && options->max_in_flight > 0 ? options->max_in_flight : DEFAULT_MAX_IN_FLIGHT;
+
+    SentenceList list = {0};
+    if (!split_sentences(request->text, &list) || !pack_sentences(&list, options ? options->max_chars : 0)) {
+        /* LCOV_EXCL_START */
+        /* category=oom reason="sentence list allocation" */
+        sentences_free(&list);
+        tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to split text");
+        return TYPECAST_ERROR_OUT_OF_MEMORY;
+        /* LCOV_EXCL_STOP */
+    }
+    if (list.count == 0) {
+        sentences_free(&list);
+        tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, "At least one speech segment is required");
+        return TYPECAST_ERROR_INVALID_PARAM;
+    }
+    TypecastAsyncJob** jobs = (TypecastAsyncJob**)calloc(list.count, sizeof(TypecastAsyncJob*));
+    /* LCOV_EXCL_START */
+    /* category=oom reason="per-sentence job array" */
+    if (!jobs) {
+        sentences_free(&list);
+        tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate sentence jobs");
+        return TYPECAST_ERROR_OUT_OF_MEMORY;
+    }
+    /* LCOV_EXCL_STOP */
+
+    Emitter emitter = {0};
+    emitter.on_chunk = on_chunk;
+    emitter.user_data = user_data;
+    emitter.wav = !request->output || request->output->audio_format == TYPECAST_AUDIO_FORMAT_WAV;
+
+    tc_error_clear(error);
+    TypecastErrorCode err = TYPECAST_OK;
+    size_t next = 0, emitted = 0;
+    while (err == TYPECAST_OK && emitted < list.count) {
+        while (next < list.count && next - emitted < max_in_flight) {
+            jobs[next] = submit_sentence(client, request, &list, next);
+            /* LCOV_EXCL_START */
+            /* category=oom reason="async submission only fails on allocation for a validated request" */
+            if (!jobs[next]) {
+                err = typecast_client_get_error(client)->code;
+                break;
+            }
+            /* LCOV_EXCL_STOP */
+            next++;
+        }
+        if (err != TYPECAST_OK) break; /* LCOV_EXCL_LINE category=oom reason="see above" */
+
+        TypecastAsyncJob* head = jobs[emitted];
+        if (!typecast_async_job_is_done(head)) {
+            err = typecast_async_poll(client, POLL_INTERVAL_MS, NULL);
+            continue;
+        }
+        err = typecast_async_job_result(head);
+        if (err != TYPECAST_OK) {
+            const TypecastError* job_error = typecast_async_job_error(head);
+            tc_error_set(error, job_error->code, job_error->message);
+            break;
+        }
+        TypecastTTSResponse* audio = typecast_async_job_take_tts_response(head);
+        err = emit_sentence(&emitter, audio, error);
+        typecast_tts_response_free(audio);
+        typecast_async_job_free(head);
+        jobs[emitted++] = NULL;
+    }
+
+    /* Freeing a job that is still running cancels it */
+    for (size_t i = emitted; i < next; i++) typecast_async_job_free(jobs[i]);
+    free(jobs);
+    sentences_free(&list);
+    return err;
+}
@@ -0,0 +1,423 @@
+/**
+ * Typecast C/C++ SDK - Client handles and errors
+ *
+ * A default client owns one easy handle and one last_error. A thread-safe
+ * client instead checks out an easy handle per call from a small pool;
+ * the pooled handles share one CURLSH (connection cache, DNS cache, TLS
+ * sessions) so warm connections are reused across threads, and errors are
+ * kept per calling thread (see typecast_error_slots.c).
+ * typecast_client_warmup() opens the first of those connections ahead of
+ * time.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <curl/curl.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_call.h"
+
+#define DEFAULT_MAX_IDLE_HANDLES 8
+#define DEFAULT_KEEPALIVE_IDLE_SECS 30L
+#define DEFAULT_KEEPALIVE_INTERVAL_SECS 15L
+
+/* ============================================
+ * Threads
+ * ============================================ */
+
+#ifdef _WIN32
+
+void tc_mutex_init(tc_mutex_t* mutex) { InitializeCriticalSection(mutex); }
+void tc_mutex_destroy(tc_mutex_t* mutex) { DeleteCriticalSection(mutex); }
+void tc_mutex_lock(tc_mutex_t* mutex) { EnterCriticalSection(mutex); }
+void tc_mutex_unlock(tc_mutex_t* mutex) { LeaveCriticalSection(mutex); }
+
+void tc_cond_init(tc_cond_t* cond) { InitializeConditionVariable(cond); }
+void tc_cond_destroy(tc_cond_t* cond) { (void)cond; }
+void tc_cond_wait(tc_cond_t* cond, tc_mutex_t* mutex) { SleepConditionVariableCS(cond, mutex, INFINITE); }
+void tc_cond_broadcast(tc_cond_t* cond) { WakeAllConditionVariable(cond); }
+
+void tc_sleep_ms(long ms) { if (ms > 0) Sleep((DWORD)ms); }
+uint64_t tc_monotonic_ms(void) { return (uint64_t)GetTickCount64(); }
+
+uint64_t tc_monotonic_us(void) {
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)(now.QuadPart / frequency.QuadPart) * 1000000u +
+        (uint64_t)(now.QuadPart % frequency.QuadPart) * 1000000u / (uint64_t)frequency.QuadPart;
+}
+
+static INIT_ONCE global_once = INIT_ONCE_STATIC_INIT;
+static tc_mutex_t global_lock;
+
+static BOOL CALLBACK global_lock_once(PINIT_ONCE once, PVOID param, PVOID* context) {
+    (void)once; (void)param; (void)context;
+    tc_mutex_init(&global_lock);
+    return TRUE;
+}
+
+static void global_lock_init(void) {
+    InitOnceExecuteOnce(&global_once, global_lock_once, NULL, NULL);
+}
+
+#else
+
+void tc_mutex_init(tc_mutex_t* mutex) { pthread_mutex_init(mutex, NULL); }
+void tc_mutex_destroy(tc_mutex_t* mutex) { pthread_mutex_destroy(mutex); }
+void tc_mutex_lock(tc_mutex_t* mutex) { pthread_mutex_lock(mutex); }
+void tc_mutex_unlock(tc_mutex_t* mutex) { pthread_mutex_unlock(mutex); }
+
+void tc_cond_init(tc_cond_t* cond) { pthread_cond_init(cond, NULL); }
+void tc_cond_destroy(tc_cond_t* cond) { pthread_cond_destroy(cond); }
+void tc_cond_wait(tc_cond_t* cond, tc_mutex_t* mutex) { pthread_cond_wait(cond, mutex); }
+void tc_cond_broadcast(tc_cond_t* cond) { pthread_cond_broadcast(cond); }
+
+void tc_sleep_ms(long ms) {
+    if (ms <= 0) return;
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+uint64_t tc_monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000L);
+}
+
+uint64_t tc_monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)(ts.tv_nsec / 1000L);
+}
+
+static pthread_once_t global_once = PTHREAD_ONCE_INIT;
+static tc_mutex_t global_lock;
+
+static void global_lock_once(void) {
+    tc_mutex_init(&global_lock);
+}
+
+static void global_lock_init(void) {
+    pthread_once(&global_once, global_lock_once);
+}
+
+#endif
+
+/* ============================================
+ * Global state
+ * ============================================ */
+
+/* curl_global_init is not guaranteed thread-safe on every libcurl build,
+ * so it only runs under global_lock, and only while curl is not set up.
+ * Clients set it up implicitly and never tear it down; global_refs counts
+ * the explicit typecast_global_init() calls that may. */
+static int curl_ready;
+static unsigned long global_refs;
+
+static int global_start(void) {
+    if (!curl_ready) curl_ready = curl_global_init(CURL_GLOBAL_DEFAULT) == CURLE_OK;
+    return curl_ready;
+}
+
+void tc_global_lock(void) {
+    global_lock_init();
+    tc_mutex_lock(&global_lock);
+}
+
+void tc_global_unlock(void) {
+    tc_mutex_unlock(&global_lock);
+}
+
+void tc_global_init(void) {
+    global_lock_init();
+    tc_mutex_lock(&global_lock);
+    global_start();
+    tc_mutex_unlock(&global_lock);
+}
+
+TYPECAST_API TypecastErrorCode typecast_global_init(void) {
+    global_lock_init();
+    tc_mutex_lock(&global_lock);
+    int ready = global_start();
+    if (ready) global_refs++;
+    tc_mutex_unlock(&global_lock);
+    return ready ? TYPECAST_OK : TYPECAST_ERROR_CURL_INIT;
+}
+
+TYPECAST_API void typecast_global_cleanup(void) {
+    global_lock_init();
+    tc_mutex_lock(&global_lock);
+    if (global_refs > 0 && --global_refs == 0 && curl_ready) {
+        curl_global_cleanup();
+        curl_ready = 0;
+    }
+    tc_mutex_unlock(&global_lock);
+}
+
+/* ============================================
+ * Shared caches
+ * ============================================ */
+
+static void share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr) {
+    (void)handle; (void)access;
+    TypecastClient* client = (TypecastClient*)userptr;
+    tc_mutex_lock(&client->share_locks[data]);
+}
+
+static void share_unlock(CURL* handle, curl_lock_data data, void* userptr) {
+    (void)handle;
+    TypecastClient* client = (TypecastClient*)userptr;
+    tc_mutex_unlock(&client->share_locks[data]);
+}
+
+/* ============================================
+ * Handle options
+ * ============================================ */
+
+void tc_client_configure_handle(TypecastClient* client, CURL* curl) {
+    const TypecastClientOptions* options = &client->options;
+
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+
+    if (!options->disable_tcp_keepalive) {
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, options->tcp_keepalive_idle_secs > 0
+            ? options->tcp_keepalive_idle_secs : DEFAULT_KEEPALIVE_IDLE_SECS);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, options->tcp_keepalive_interval_secs > 0
+            ? options->tcp_keepalive_interval_secs : DEFAULT_KEEPALIVE_INTERVAL_SECS);
+    }
+
+    long http_version = CURL_HTTP_VERSION_2TLS;
+    if (options->http_version == TYPECAST_HTTP_VERSION_1_1) {
+        http_version = CURL_HTTP_VERSION_1_1;
+    } else if (options->http_version == TYPECAST_HTTP_VERSION_2) {
+        http_version = CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE;
+    }
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, http_version);
+
+    if (options->disable_connection_reuse) {
+        curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
+    }
+    if (options->max_connection_idle_secs > 0) {
+        curl_easy_setopt(curl, CURLOPT_MAXAGE_CONN, options->max_connection_idle_secs);
+    }
+
+    if (options->low_speed_limit_bytes > 0 && options->low_speed_time_secs > 0) {
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, options->low_speed_limit_bytes);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, options->low_speed_time_secs);
+    }
+
+    if (client->share) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, client->share);
+        curl_easy_setopt(curl, CURLOPT_MAXCONNECTS, (long)client->idle_capacity);
+    }
+}
+
+void tc_request_reset(CURL* curl) {
+    curl_easy_setopt(curl, CURLOPT_URL, NULL);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, NULL);
+    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, NULL);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, -1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, NULL);
+    curl_easy_setopt(curl, CURLOPT_MIMEPOST, NULL);
+    curl_easy_setopt(curl, CURLOPT_NOBODY, 0L);
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, NULL);
+    /* Last: POSTFIELDS and MIMEPOST switch the method even when cleared */
+    curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, NULL);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, NULL);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, NULL);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, NULL);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 0L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 0L);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, NULL);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, NULL);
+}
+
+/* ============================================
+ * Setup / Teardown
+ * ============================================ */
+
+TypecastErrorCode tc_client_setup(TypecastClient* client, const TypecastClientOptions* options) {
+    if (options) client->options = *options;
+
+    if (!client->options.thread_safe) {
+        client->curl = curl_easy_init();
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="curl_easy_init failure requires libcurl internal OOM" */
+        if (!client->curl) return TYPECAST_ERROR_CURL_INIT;
+        /* LCOV_EXCL_STOP */
+        /* A hedge races the single handle with a spare one, and a stream
+         * buffer runs it on its own multi handle; keeping connections in
+         * a share rather than in whichever multi drove the handle keeps
+         * them warm for the next call. One thread only, so the share
+         * needs no locks. */
+        client->idle_capacity = DEFAULT_MAX_IDLE_HANDLES;
+        client->share = curl_share_init();
+        /* LCOV_EXCL_START */
+        /* category=oom reason="curl_share_init only fails on OOM" */
+        if (!client->share) return TYPECAST_ERROR_OUT_OF_MEMORY;
+        /* LCOV_EXCL_STOP */
+        curl_share_setopt(client->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        curl_share_setopt(client->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(client->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        tc_client_configure_handle(client, client->curl);
+        return TYPECAST_OK;
+    }
+
+    client->thread_safe = 1;
+    tc_mutex_init(&client->lock);
+    for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+        tc_mutex_init(&client->share_locks[i]);
+    }
+    if (tc_error_slots_init(client) != 0) return TYPECAST_ERROR_OUT_OF_MEMORY; /* LCOV_EXCL_LINE category=oom reason="thread-local keys exhausted" */
+
+    client->idle_capacity = client->options.max_idle_handles > 0
+        ? client->options.max_idle_handles : DEFAULT_MAX_IDLE_HANDLES;
+    client->idle = (CURL**)calloc(client->idle_capacity, sizeof(CURL*));
+    client->share = curl_share_init();
+    /* LCOV_EXCL_START */
+    /* category=oom reason="calloc / curl_share_init only fail on OOM" */
+    if (!client->idle || !client->share) return TYPECAST_ERROR_OUT_OF_MEMORY;
+    /* LCOV_EXCL_STOP */
+
+    curl_share_setopt(client->share, CURLSHOPT_LOCKFUNC, share_lock);
+    curl_share_setopt(client->share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+    curl_share_setopt(client->share, CURLSHOPT_USERDATA, client);
+    curl_share_setopt(client->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    curl_share_setopt(client->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(client->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    return TYPECAST_OK;
+}
+
+void tc_client_teardown(TypecastClient* client) {
+    if (client->curl) curl_easy_cleanup(client->curl);
+    if (!client->thread_safe) {
+        if (client->share) curl_share_cleanup(client->share);
+        return;
+    }
+
+    for (size_t i = 0; i < client->idle_count; i++) {
+        curl_easy_cleanup(client->idle[i]);
+    }
+    free(client->idle);
+    if (client->share) curl_share_cleanup(client->share);
+
+    tc_error_slots_release(client);
+    for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+        tc_mutex_destroy(&client->share_locks[i]);
+    }
+    tc_mutex_destroy(&client->lock);
+}
+
+/* ============================================
+ * Handles
+ * ============================================ */
+
+CURL* tc_client_acquire(TypecastClient* client) {
+    if (!client->thread_safe) {
+        tc_request_reset(client->curl);
+        return client->curl;
+    }
+
+    CURL* curl = NULL;
+    tc_mutex_lock(&client->lock);
+    if (client->idle_count > 0) curl = client->idle[--client->idle_count];
+    tc_mutex_unlock(&client->lock);
+
+    if (curl) {
+        tc_request_reset(curl);
+        return curl;
+    }
+
+    curl = curl_easy_init();
+    /* LCOV_EXCL_START */
+    /* category=unreachable reason="curl_easy_init failure requires libcurl internal OOM" */
+    if (!curl) return NULL;
+    /* LCOV_EXCL_STOP */
+    tc_client_configure_handle(client, curl);
+    return curl;
+}
+
+void tc_client_release(TypecastClient* client, CURL* curl) {
+    if (!client->thread_safe || !curl) return;
+
+    tc_mutex_lock(&client->lock);
+    if (client->idle_count < client->idle_capacity) {
+        client->idle[client->idle_count++] = curl;
+        curl = NULL;
+    }
+    tc_mutex_unlock(&client->lock);
+    if (curl) curl_easy_cleanup(curl);
+}
+
+CURL* tc_client_acquire_spare(TypecastClient* client) {
+    if (client->thread_safe) return tc_client_acquire(client);
+    CURL* curl = curl_easy_init();
+    if (curl) tc_client_configure_handle(client, curl);
+    return curl;
+}
+
+void tc_client_settle(TypecastClient* client, CURL* winner, CURL* loser) {
+    if (client->thread_safe) {
+        tc_client_release(client, loser);
+        return;
+    }
+    /* The single handle is whichever won; connections live in the share */
+    if (loser == client->curl) client->curl = winner;
+    curl_easy_cleanup(loser);
+}
+
+/* ============================================
+ * Warm-up
+ * ============================================ */
+
+TYPECAST_API TypecastErrorCode typecast_client_warmup(TypecastClient* client, int preload_voices) {
+    if (!client) return TYPECAST_ERROR_INVALID_PARAM;
+    TypecastError* error = tc_client_error(client);
+    tc_error_clear(error);
+
+    CURL* curl = tc_client_acquire(client);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="a pooled handle is only unavailable when curl_easy_init runs out of memory" */
+    if (!curl) {
+        tc_error_set(error, TYPECAST_ERROR_CURL_INIT, "Failed to initialize CURL");
+        return TYPECAST_ERROR_CURL_INIT;
+    }
+    /* LCOV_EXCL_STOP */
+
+    /* HEAD, unauthenticated: the status does not matter, the connection
+     * left in the cache does */
+    char url[1280];
+    snprintf(url, sizeof(url), "%s/", client->host);
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+    curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+    TcCallSettings call;
+    tc_call_settings(client, TC_TIMEOUT_QUERY, &call);
+    tc_call_apply(curl, &call);
+    CURLcode res = curl_easy_perform(curl);
+    tc_client_release(client, curl);
+    if (res != CURLE_OK) return tc_call_error(&call, res, error);
+
+    if (preload_voices) {
+        TypecastVoicesResponse* voices = typecast_get_voices(client, NULL);
+        if (!voices) return typecast_client_get_error(client)->code;
+        typecast_voices_response_free(voices);
+    }
+    return TYPECAST_OK;
+}
@@ -0,0 +1,447 @@
+/**
+ * Typecast C/C++ SDK - TTS result cache
+ *
+ * Much TTS traffic repeats the exact same request (IVR menus, UI strings).
+ * Clients created with result_cache_max_bytes or result_cache_dir keep
+ * successful results keyed by the endpoint and the serialized request
+ * body, which emit_tts_request writes in a fixed field order.
+ * Entries live in an in-memory LRU bounded by byte size and, optionally,
+ * as one file per entry in a directory shared by every process. The key
+ * is an FNV-1a hash of the request; the full request is stored with each
+ * entry so a hash collision is a miss, never a wrong answer.
+ *
+ * Only requests with a fixed seed are cached unless result_cache_unseeded
+ * is set, since without one the server may render differently each time.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_alloc.h"
+#include "typecast_result_cache.h"
+
+#define BUCKET_COUNT 256
+#define FILE_MAGIC "TCR1"
+#define FILE_HEADER_SIZE 24          /* magic, format, duration, key and data sizes */
+
+typedef struct TcResultEntry {
+    uint64_t hash;
+    char* key;                       /* url, '\n', request body */
+    size_t key_len;
+    uint8_t* data;
+    size_t size;
+    float duration;
+    TypecastAudioFormat format;
+    struct TcResultEntry* chain;     /* bucket chain */
+    struct TcResultEntry* prev;      /* LRU list, most recent first */
+    struct TcResultEntry* next;
+} TcResultEntry;
+
+struct TcResultCache {
+    tc_mutex_t lock;                 /* guards everything below except dir */
+    size_t max_bytes;
+    int unseeded;
+    char* dir;
+    TcResultEntry* buckets[BUCKET_COUNT];
+    TcResultEntry* head;
+    TcResultEntry* tail;
+    size_t entries;
+    size_t bytes;
+    unsigned long long hits;
+    unsigned long long disk_hits;
+    unsigned long long misses;
+};
+
+/* ============================================
+ * Keys
+ * ============================================ */
+
+static char* build_key(const TcTransfer* transfer, size_t* key_len) {
+    size_t url_len = strlen(transfer->url);
+    size_t body_len = transfer->body_len;
+    char* key = (char*)malloc(url_len + body_len + 2);
+    if (!key) return NULL; /* LCOV_EXCL_LINE category=oom reason="cache key allocation" */
+    memcpy(key, transfer->url, url_len);
+    key[url_len] = '\n';
+    memcpy(key + url_len + 1, transfer->body, body_len + 1);
+    *key_len = url_len + body_len + 1;
+    return key;
+}
+
+static uint64_t hash_bytes(const char* data, size_t len) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;    /* FNV-1a */
+    }
+    return hash;
+}
+
+/* ============================================
+ * Memory tier
+ * ============================================ */
+
+static void entry_free(TcResultEntry* entry) {
+    free(entry->key);
+    free(entry->data);
+    free(entry);
+}
+
+static void lru_unlink(TcResultCache* cache, TcResultEntry* entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else cache->head = entry->next;
+    if (entry->next) entry->next->prev = entry->prev;
+    else cache->tail = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+static void lru_push_front(TcResultCache* cache, TcResultEntry* entry) {
+    entry->next = cache->head;
+    if (cache->head) cache->head->prev = entry;
+    cache->head = entry;
+    if (!cache->tail) cache->tail = entry;
+}
+
+static void remove_entry(TcResultCache* cache, TcResultEntry* entry) {
+    TcResultEntry** link = &cache->buckets[entry->hash % BUCKET_COUNT];
+    while (*link != entry) link = &(*link)->chain;
+    *link = entry->chain;
+    lru_unlink(cache, entry);
+    cache->entries--;
+    cache->bytes -= entry->size;
+    entry_free(entry);
+}
+
+static TcResultEntry* find_entry(TcResultCache* cache, uint64_t hash, const char* key, size_t key_len) {
+    for (TcResultEntry* e = cache->buckets[hash % BUCKET_COUNT]; e; e = e->chain) {
+        if (e->hash == hash && e->key_len == key_len && memcmp(e->key, key, key_len) == 0) return e;
+    }
+    return NULL;
+}
+
+/* Takes ownership of key and data */
+static void insert_entry(TcResultCache* cache, uint64_t hash, char* key, size_t key_len,
+    uint8_t* data, size_t size, float duration, TypecastAudioFormat format) {
+    if (cache->max_bytes == 0 || size > cache->max_bytes) {
+        free(key);
+        free(data);
+        return;
+    }
+    TcResultEntry* old = find_entry(cache, hash, key, key_len);
+    if (old) remove_entry(cache, old);
+    while (cache->tail && cache->bytes + size > cache->max_bytes) remove_entry(cache, cache->tail);
+
+    TcResultEntry* entry = (TcResultEntry*)calloc(1, sizeof(*entry));
+    /* LCOV_EXCL_START */
+    /* category=oom reason="cache entry allocation" */
+    if (!entry) {
+        free(key);
+        free(data);
+        return;
+    }
+    /* LCOV_EXCL_STOP */
+    entry->hash = hash;
+    entry->key = key;
+    entry->key_len = key_len;
+    entry->data = data;
+    entry->size = size;
+    entry->duration = duration;
+    entry->format = format;
+    entry->chain = cache->buckets[hash % BUCKET_COUNT];
+    cache->buckets[hash % BUCKET_COUNT] = entry;
+    lru_push_front(cache, entry);
+    cache->entries++;
+    cache->bytes += size;
+}
+
+/* ============================================
+ * Disk tier
+ * ============================================ */
+
+static void entry_path(const TcResultCache* cache, uint64_t hash, char* path, size_t path_size) {
+    snprintf(path, path_size, "%s/%016llx.tcr", cache->dir, (unsigned long long)hash);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Header, little-endian: "TCR1", format (u8) and padding, duration
+ * (f32 bits), key size (u32), data size (u32 low, u32 high) */
+static void encode_header(uint8_t* header, size_t key_len, size_t size, float duration,
+    TypecastAudioFormat format) {
+    memset(header, 0, FILE_HEADER_SIZE);
+    memcpy(header, FILE_MAGIC, 4);
+    header[4] = (uint8_t)format;
+    uint32_t bits;
+    memcpy(&bits, &duration, sizeof(bits));
+    put_u32(header + 8, bits);
+    put_u32(header + 12, (uint32_t)key_len);
+    put_u32(header + 16, (uint32_t)((uint64_t)size & 0xFFFFFFFFu));
+    put_u32(header + 20, (uint32_t)((uint64_t)size >> 32));
+}
+
+/* A failed write only loses the disk copy */
+static void disk_store(const TcResultCache* cache, uint64_t hash, const char* key, size_t key_len,
+    const uint8_t* data, size_t size, float duration, TypecastAudioFormat format) {
+    if (key_len > 0xFFFFFFFFu) return; /* LCOV_EXCL_LINE category=unreachable reason="request bodies are far below 4 GiB" */
+    char path[4096];
+    char temp[4096 + 8];
+    entry_path(cache, hash, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+
+    FILE* file = fopen(temp, "wb");
+    if (!file) return;
+    uint8_t header[FILE_HEADER_SIZE];
+    encode_header(header, key_len, size, duration, format);
+    int ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+             fwrite(key, 1, key_len, file) == key_len &&
+             fwrite(data, 1, size, file) == size;
+    ok = fclose(file) == 0 && ok;
+#if defined(_WIN32) || defined(_WIN64)
+    if (ok) remove(path);
+#endif
+    if (!ok || rename(temp, path) != 0) remove(temp);
+}
+
+/* Returns the entry's data (malloc'd) when the file holds exactly `key` */
+static uint8_t* disk_load(const TcResultCache* cache, uint64_t hash, const char* key, size_t key_len,
+    size_t* size, float* duration, TypecastAudioFormat* format) {
+    char path[4096];
+    entry_path(cache, hash, path, sizeof(path));
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    uint8_t header[FILE_HEADER_SIZE];
+    uint8_t* data = NULL;
+    char* stored_key = NULL;
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, FILE_MAGIC, 4) != 0) goto done;
+    uint64_t data_size = (uint64_t)get_u32(header + 16) | ((uint64_t)get_u32(header + 20) << 32);
+    if (get_u32(header + 12) != key_len || data_size > (uint64_t)(size_t)-1) goto done;
+
+    stored_key = (char*)malloc(key_len);
+    if (!stored_key) goto done; /* LCOV_EXCL_LINE category=oom reason="cache file key buffer" */
+    if (fread(stored_key, 1, key_len, file) != key_len || memcmp(stored_key, key, key_len) != 0) goto done;
+
+    data = (uint8_t*)malloc(data_size ? (size_t)data_size : 1);
+    if (data && fread(data, 1, (size_t)data_size, file) != (size_t)data_size) {
+        free(data);
+        data = NULL;
+    }
+    if (data) {
+        uint32_t bits = get_u32(header + 8);
+        memcpy(duration, &bits, sizeof(*duration));
+        *format = (TypecastAudioFormat)header[4];
+        *size = (size_t)data_size;
+    }
+done:
+    free(stored_key);
+    fclose(file);
+    return data;
+}
+
+/* ============================================
+ * Internal API
+ * ============================================ */
+
+TcResultCache* tc_result_cache_new(const TypecastClientOptions* options) {
+    if (!options || (options->result_cache_max_bytes == 0 && tc_is_blank_string(options->result_cache_dir))) {
+        return NULL;
+    }
+    TcResultCache* cache = (TcResultCache*)calloc(1, sizeof(*cache));
+    if (!cache) return NULL; /* LCOV_EXCL_LINE category=oom reason="cache allocation" */
+    tc_mutex_init(&cache->lock);
+    cache->max_bytes = options->result_cache_max_bytes;
+    cache->unseeded = options->result_cache_unseeded;
+    if (!tc_is_blank_string(options->result_cache_dir)) {
+        size_t len = strlen(options->result_cache_dir);
+        while (len > 1 && (options->result_cache_dir[len - 1] == '/' || options->result_cache_dir[len - 1] == '\\')) len--;
+        cache->dir = (char*)malloc(len + 1);
+        if (cache->dir) {
+            memcpy(cache->dir, options->result_cache_dir, len);
+            cache->dir[len] = '\0';
+        }
+    }
+    return cache;
+}
+
+void tc_result_cache_free(TcResultCache* cache) {
+    if (!cache) return;
+    while (cache->head) remove_entry(cache, cache->head);
+    tc_mutex_destroy(&cache->lock);
+    free(cache->dir);
+    free(cache);
+}
+
+int tc_result_cache_accepts(const TcResultCache* cache, int seed) {
+    return cache && (seed != 0 || cache->unseeded);
+}
+
+static char* copy_key(const char* key, size_t key_len) {
+    char* copy = (char*)malloc(key_len + 1);
+    if (!copy) return NULL; /* LCOV_EXCL_LINE category=oom reason="cache key allocation" */
+    memcpy(copy, key, key_len);
+    copy[key_len] = '\0';
+    return copy;
+}
+
+int tc_result_cache_lookup(TcResultCache* cache, const TcTransfer* transfer,
+    const TypecastAllocator* allocator, TcCachedResult* out) {
+    size_t key_len = 0;
+    char* key = build_key(transfer, &key_len);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="cache key allocation" */
+    if (!key) {
+        memset(out, 0, sizeof(*out));
+        return 0;
+    }
+    /* LCOV_EXCL_STOP */
+    int hit = tc_result_cache_lookup_key(cache, key, key_len, allocator, out);
+    free(key);
+    return hit;
+}
+
+int tc_result_cache_lookup_key(TcResultCache* cache, const char* lookup_key, size_t key_len,
+    const TypecastAllocator* allocator, TcCachedResult* out) {
+    memset(out, 0, sizeof(*out));
+    uint64_t hash = hash_bytes(lookup_key, key_len);
+    char* key = NULL;
+
+    int hit = 0;
+    tc_mutex_lock(&cache->lock);
+    TcResultEntry* entry = find_entry(cache, hash, lookup_key, key_len);
+    if (entry) {
+        out->data = (uint8_t*)tc_mem_alloc(allocator, entry->size + 1);
+        if (out->data) {
+            memcpy(out->data, entry->data, entry->size);
+            out->data[entry->size] = 0;
+            out->size = entry->size;
+            out->duration = entry->duration;
+            out->format = entry->format;
+            lru_unlink(cache, entry);
+            lru_push_front(cache, entry);
+            cache->hits++;
+            hit = 1;
+        }
+    }
+    tc_mutex_unlock(&cache->lock);
+    if (hit || !cache->dir) {
+        if (!hit) {
+            tc_mutex_lock(&cache->lock);
+            cache->misses++;
+            tc_mutex_unlock(&cache->lock);
+        }
+        return hit;
+    }
+
+    /* Disk hit: promote into memory */
+    size_t size = 0;
+    float duration = 0.0f;
+    TypecastAudioFormat format = TYPECAST_AUDIO_FORMAT_WAV;
+    uint8_t* data = disk_load(cache, hash, lookup_key, key_len, &size, &duration, &format);
+    if (data) key = copy_key(lookup_key, key_len);
+    if (key) out->data = (uint8_t*)tc_mem_alloc(allocator, size + 1);
+    if (out->data) {
+        memcpy(out->data, data, size);
+        out->data[size] = 0;
+        out->size = size;
+        out->duration = duration;
+        out->format = format;
+        hit = 1;
+    }
+    tc_mutex_lock(&cache->lock);
+    if (hit) {
+        cache->hits++;
+        cache->disk_hits++;
+        insert_entry(cache, hash, key, key_len, data, size, duration, format);
+        key = NULL;
+        data = NULL;
+    } else {
+        cache->misses++;
+    }
+    tc_mutex_unlock(&cache->lock);
+    free(key);
+    free(data);
+    return hit;
+}
+
+/* Takes ownership of key */
+static void store_entry(TcResultCache* cache, char* key, size_t key_len,
+    const uint8_t* data, size_t size, float duration, TypecastAudioFormat format) {
+    uint64_t hash = hash_bytes(key, key_len);
+    if (cache->dir) disk_store(cache, hash, key, key_len, data, size, duration, format);
+
+    uint8_t* copy = NULL;
+    if (cache->max_bytes > 0 && size <= cache->max_bytes) {
+        copy = (uint8_t*)malloc(size ? size : 1);
+        if (copy) memcpy(copy, data, size);
+    }
+    if (!copy) {
+        free(key);
+        return;
+    }
+    tc_mutex_lock(&cache->lock);
+    insert_entry(cache, hash, key, key_len, copy, size, duration, format);
+    tc_mutex_unlock(&cache->lock);
+}
+
+void tc_result_cache_store(TcResultCache* cache, const TcTransfer* transfer,
+    const uint8_t* data, size_t size, float duration, TypecastAudioFormat format) {
+    if (!data) return;
+    size_t key_len = 0;
+    char* key = build_key(transfer, &key_len);
+    if (!key) return; /* LCOV_EXCL_LINE category=oom reason="cache key allocation" */
+    store_entry(cache, key, key_len, data, size, duration, format);
+}
+
+void tc_result_cache_store_key(TcResultCache* cache, const char* key, size_t key_len,
+    const uint8_t* data, size_t size, float duration, TypecastAudioFormat format) {
+    if (!data) return;
+    char* copy = copy_key(key, key_len);
+    if (!copy) return; /* LCOV_EXCL_LINE category=oom reason="cache key allocation" */
+    store_entry(cache, copy, key_len, data, size, duration, format);
+}
+
+void tc_result_cache_stats(TcResultCache* cache, TypecastResultCacheStats* out) {
+    memset(out, 0, sizeof(*out));
+    if (!cache) return;
+    tc_mutex_lock(&cache->lock);
+    out->hits = cache->hits;
+    out->disk_hits = cache->disk_hits;
+    out->misses = cache->misses;
+    out->entries = cache->entries;
+    out->bytes = cache->bytes;
+    tc_mutex_unlock(&cache->lock);
+}
+
+/* ============================================
+ * Public API
+ * ============================================ */
+
+TYPECAST_API TypecastErrorCode typecast_result_cache_stats(TypecastClient* client, TypecastResultCacheStats* out) {
+    if (!client || !out) return TYPECAST_ERROR_INVALID_PARAM;
+    tc_result_cache_stats(client->result_cache, out);
+    return TYPECAST_OK;
+}
+
+TYPECAST_API void typecast_result_cache_clear(TypecastClient* client) {
+    if (!client || !client->result_cache) return;
+    TcResultCache* cache = client->result_cache;
+    tc_mutex_lock(&cache->lock);
+    while (cache->head) remove_entry(cache, cache->head);
+    cache->hits = cache->disk_hits = cache->misses = 0;
+    tc_mutex_unlock(&cache->lock);
+}
@@ -0,0 +1,41 @@
+/**
+ * Typecast C/C++ SDK - Result cache (typecast_result_cache.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_RESULT_CACHE_H
+#define TYPECAST_RESULT_CACHE_H
+
+#include "typecast_internal.h"
+
+typedef struct {
+    uint8_t* data;                   /* NUL-terminated, from the lookup's allocator */
+    size_t size;
+    float duration;
+    TypecastAudioFormat format;
+} TcCachedResult;
+
+/* NULL when options disable the cache */
+TcResultCache* tc_result_cache_new(const TypecastClientOptions* options);
+void tc_result_cache_free(TcResultCache* cache);
+/* Whether a request with this seed may be cached (NULL cache: never) */
+int tc_result_cache_accepts(const TcResultCache* cache, int seed);
+/* Look up a prepared transfer by its URL and body. 1 on a hit, with
+ * out->data allocated from `allocator` (NULL = malloc). Counts the hit
+ * or miss. */
+int tc_result_cache_lookup(TcResultCache* cache, const TcTransfer* transfer,
+    const TypecastAllocator* allocator, TcCachedResult* out);
+/* Remember the successful result of a transfer; `data` is copied */
+void tc_result_cache_store(TcResultCache* cache, const TcTransfer* transfer,
+    const uint8_t* data, size_t size, float duration, TypecastAudioFormat format);
+/* Same as lookup/store for a caller-built key (e.g. a composer segment);
+ * the key is copied where the cache keeps it */
+int tc_result_cache_lookup_key(TcResultCache* cache, const char* key, size_t key_len,
+    const TypecastAllocator* allocator, TcCachedResult* out);
+void tc_result_cache_store_key(TcResultCache* cache, const char* key, size_t key_len,
+    const uint8_t* data, size_t size, float duration, TypecastAudioFormat format);
+/* Snapshot of the counters; zeroes when cache is NULL */
+void tc_result_cache_stats(TcResultCache* cache, TypecastResultCacheStats* out);
+
+#endif /* TYPECAST_RESULT_CACHE_H */
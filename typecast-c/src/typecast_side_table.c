@@ -0,0 +1,73 @@
+/**
+ * Typecast C/C++ SDK - Side tables
+ *
+ * Public response structs keep their 1.x layout, so state the SDK needs
+ * beside one (the allocator that owns its audio, the decoded copy of its
+ * base64) lives in a table keyed by the struct's address. Only values the
+ * SDK created are entered, so a caller's hand-built struct simply has no
+ * entry. Every table is guarded by the global lock.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_side_table.h"
+
+struct TcSideEntry {
+    const void* key;
+    void* value;
+    struct TcSideEntry* next;
+};
+
+static size_t side_bucket(const void* key) {
+    uintptr_t bits = (uintptr_t)key;
+    return (size_t)((bits >> 4) ^ (bits >> 12)) % TC_SIDE_BUCKETS;
+}
+
+int tc_side_put(TcSideTable* table, const void* key, void* value) {
+    TcSideEntry* entry = (TcSideEntry*)malloc(sizeof(*entry));
+    if (!entry) return -1; /* LCOV_EXCL_LINE category=oom reason="side table entry" */
+    entry->key = key;
+    entry->value = value;
+    size_t bucket = side_bucket(key);
+    tc_global_lock();
+    entry->next = table->buckets[bucket];
+    table->buckets[bucket] = entry;
+    tc_global_unlock();
+    return 0;
+}
+
+void* tc_side_get(TcSideTable* table, const void* key) {
+    void* value = NULL;
+    tc_global_lock();
+    for (TcSideEntry* entry = table->buckets[side_bucket(key)]; entry; entry = entry->next) {
+        if (entry->key != key) continue;
+        value = entry->value;
+        break;
+    }
+    tc_global_unlock();
+    return value;
+}
+
+void* tc_side_take(TcSideTable* table, const void* key) {
+    TcSideEntry* found = NULL;
+    tc_global_lock();
+    for (TcSideEntry** at = &table->buckets[side_bucket(key)]; *at; at = &(*at)->next) {
+        if ((*at)->key != key) continue;
+        found = *at;
+        *at = found->next;
+        break;
+    }
+    tc_global_unlock();
+    if (!found) return NULL;
+    void* value = found->value;
+    free(found);
+    return value;
+}
@@ -0,0 +1,27 @@
+/**
+ * Typecast C/C++ SDK - Side tables (typecast_side_table.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_SIDE_TABLE_H
+#define TYPECAST_SIDE_TABLE_H
+
+#include "typecast_internal.h"
+
+#define TC_SIDE_BUCKETS 256
+
+typedef struct TcSideEntry TcSideEntry;
+/* Per-value private state keyed by address; zero-initialised statics */
+typedef struct {
+    TcSideEntry* buckets[TC_SIDE_BUCKETS];
+} TcSideTable;
+
+/* -1 on allocation failure */
+int tc_side_put(TcSideTable* table, const void* key, void* value);
+/* NULL when key has no entry */
+void* tc_side_get(TcSideTable* table, const void* key);
+/* Remove key's entry and return its value (NULL when none) */
+void* tc_side_take(TcSideTable* table, const void* key);
+
+#endif /* TYPECAST_SIDE_TABLE_H */
@@ -0,0 +1,292 @@
+/**
+ * Typecast C/C++ SDK - Stream buffer
+ *
+ * A single-producer, single-consumer ring between a streaming request and
+ * a playback thread. The producer call drives the transfer on the
+ * buffer's own multi handle; its write callback copies each chunk into
+ * the ring or, when the chunk does not fit, pauses the transfer with
+ * CURL_WRITEFUNC_PAUSE. The reader copies out without a lock and, once it
+ * has made room for the held chunk, wakes the producer with
+ * curl_multi_wakeup so the transfer resumes at once. Both positions only
+ * grow; the ring index is the position masked by the power-of-two size.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <curl/curl.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_stream_buffer.h"
+
+#ifndef _WIN32
+#include <stdatomic.h>
+#endif
+
+#define DEFAULT_CAPACITY (256u * 1024u)
+/* libcurl hands the write callback at most CURL_MAX_WRITE_SIZE at once,
+ * so a held chunk always fits once the reader catches up */
+#define MIN_CAPACITY (4u * CURL_MAX_WRITE_SIZE)
+#define CACHE_LINE 64
+/* Longest wait of a paused producer between two looks at the cancel
+ * token; the reader's wake-up normally comes first */
+#define PAUSED_POLL_MS 50
+#define ACTIVE_POLL_MS 1000
+
+/* Sequentially consistent throughout: the wake handshake relies on the
+ * reader's tail store and the producer's wake store not passing the
+ * loads that follow them. That is one locked store per chunk or read. */
+#ifdef _WIN32
+typedef volatile LONG64 TcAtomic;
+static uint64_t load(TcAtomic* a) { return (uint64_t)InterlockedCompareExchange64(a, 0, 0); }
+static void store(TcAtomic* a, uint64_t v) { InterlockedExchange64(a, (LONG64)v); }
+static uint64_t exchange(TcAtomic* a, uint64_t v) { return (uint64_t)InterlockedExchange64(a, (LONG64)v); }
+static void increment(TcAtomic* a) { InterlockedIncrement64(a); }
+#else
+typedef _Atomic uint64_t TcAtomic;
+static uint64_t load(TcAtomic* a) { return atomic_load(a); }
+static void store(TcAtomic* a, uint64_t v) { atomic_store(a, v); }
+static uint64_t exchange(TcAtomic* a, uint64_t v) { return atomic_exchange(a, v); }
+static void increment(TcAtomic* a) { atomic_fetch_add(a, 1); }
+#endif
+
+struct TypecastStreamBuffer {
+    uint8_t* data;
+    size_t capacity;                    /* power of two */
+    size_t prebuffer;
+    CURLM* multi;                       /* runs the producer's transfer */
+    int claimed;                        /* producer: carried a stream */
+    char pad0[CACHE_LINE];
+    /* Written by the producer */
+    TcAtomic head;                      /* bytes written */
+    TcAtomic pending;                   /* size of the held chunk, 0 = not paused */
+    TcAtomic wake;                      /* the reader should wake the producer */
+    TcAtomic finished;
+    TcAtomic pauses;
+    char pad1[CACHE_LINE];
+    /* Written by the reader */
+    TcAtomic tail;                      /* bytes read */
+    TcAtomic closed;
+    int started;                        /* prebuffer reached */
+    unsigned long underruns;
+};
+
+static size_t room(TypecastStreamBuffer* buffer) {
+    return buffer->capacity - (size_t)(load(&buffer->head) - load(&buffer->tail));
+}
+
+/* ============================================
+ * Lifecycle
+ * ============================================ */
+
+TYPECAST_API TypecastStreamBuffer* typecast_stream_buffer_create(const TypecastStreamBufferOptions* options) {
+    size_t want = options && options->capacity ? options->capacity : DEFAULT_CAPACITY;
+    size_t capacity = MIN_CAPACITY;
+    while (capacity < want && capacity <= SIZE_MAX / 2) capacity <<= 1;
+
+    tc_global_init();
+    TypecastStreamBuffer* buffer = (TypecastStreamBuffer*)calloc(1, sizeof(*buffer));
+    if (!buffer) return NULL; /* LCOV_EXCL_LINE category=oom reason="buffer allocation" */
+    buffer->data = (uint8_t*)malloc(capacity);
+    buffer->multi = curl_multi_init();
+    /* LCOV_EXCL_START */
+    /* category=oom reason="ring allocation / curl_multi_init only fail on OOM" */
+    if (!buffer->data || !buffer->multi) {
+        typecast_stream_buffer_free(buffer);
+        return NULL;
+    }
+    /* LCOV_EXCL_STOP */
+    buffer->capacity = capacity;
+    size_t prebuffer = options ? options->prebuffer : 0;
+    buffer->prebuffer = prebuffer < capacity ? prebuffer : capacity;
+    return buffer;
+}
+
+TYPECAST_API void typecast_stream_buffer_free(TypecastStreamBuffer* buffer) {
+    if (!buffer) return;
+    if (buffer->multi) curl_multi_cleanup(buffer->multi);
+    free(buffer->data);
+    free(buffer);
+}
+
+/* ============================================
+ * Producer
+ * ============================================ */
+
+int tc_stream_buffer_claim(TypecastStreamBuffer* buffer) {
+    if (buffer->claimed) return 0;
+    buffer->claimed = 1;
+    return 1;
+}
+
+int tc_stream_buffer_push(TypecastStreamBuffer* buffer, const uint8_t* data, size_t len) {
+    if (load(&buffer->closed)) return -1;
+    if (len > buffer->capacity) return -1; /* LCOV_EXCL_LINE category=unreachable reason="chunks are at most CURL_MAX_WRITE_SIZE" */
+    if (len > room(buffer)) {
+        store(&buffer->pending, len);
+        increment(&buffer->pauses);
+        store(&buffer->wake, 1);
+        return 0;
+    }
+    uint64_t head = load(&buffer->head);
+    size_t at = (size_t)head & (buffer->capacity - 1);
+    size_t first = buffer->capacity - at < len ? buffer->capacity - at : len;
+    memcpy(buffer->data + at, data, first);
+    memcpy(buffer->data, data + first, len - first);
+    store(&buffer->head, head + len);
+    return 1;
+}
+
+int tc_stream_buffer_closed(TypecastStreamBuffer* buffer) {
+    return load(&buffer->closed) != 0;
+}
+
+CURLcode tc_stream_buffer_perform(TypecastStreamBuffer* buffer, TcTransfer* transfer, CURL* curl) {
+    TcCallSettings* call = &transfer->call;
+    /* The request timeout counts only the time the transfer may run: a
+     * reader holding the stream back must not time it out */
+    long budget_ms = call->timeout_ms;
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 0L);
+    curl_multi_add_handle(buffer->multi, curl);
+
+    CURLcode result = CURLE_OK;
+    uint64_t last = tc_monotonic_ms();
+    uint64_t active_ms = 0;
+    int done = 0;
+    while (!done) {
+        int running = 0;
+        /* LCOV_EXCL_START */
+        /* category=unreachable reason="multi errors need libcurl internal failures" */
+        if (curl_multi_perform(buffer->multi, &running) != CURLM_OK) {
+            result = CURLE_FAILED_INIT;
+            break;
+        }
+        /* LCOV_EXCL_STOP */
+        CURLMsg* msg;
+        int left = 0;
+        while ((msg = curl_multi_info_read(buffer->multi, &left)) != NULL) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            result = msg->data.result;
+            done = 1;
+        }
+        if (done) break;
+
+        uint64_t now = tc_monotonic_ms();
+        uint64_t pending = load(&buffer->pending);
+        if (!pending) active_ms += now - last;
+        last = now;
+        if (pending && room(buffer) >= pending) {
+            store(&buffer->wake, 0);
+            store(&buffer->pending, 0);
+            /* Delivers the held chunk, which may pause the transfer again */
+            curl_easy_pause(curl, CURLPAUSE_CONT);
+            continue;
+        }
+
+        if (load(&buffer->closed)) {
+            result = CURLE_WRITE_ERROR;
+            break;
+        }
+        if (typecast_cancel_token_is_cancelled(call->cancel)) {
+            result = CURLE_ABORTED_BY_CALLBACK;
+            break;
+        }
+        if (call->deadline && now >= call->deadline) {
+            call->expired = 1;
+            result = CURLE_ABORTED_BY_CALLBACK;
+            break;
+        }
+        if (budget_ms > 0 && active_ms >= (uint64_t)budget_ms) {
+            result = CURLE_OPERATION_TIMEDOUT;
+            break;
+        }
+
+        long wait_ms = pending ? PAUSED_POLL_MS : ACTIVE_POLL_MS;
+        if (!pending && budget_ms > 0 && (uint64_t)budget_ms - active_ms < (uint64_t)wait_ms) {
+            wait_ms = (long)((uint64_t)budget_ms - active_ms);
+        }
+        if (call->deadline && call->deadline - now < (uint64_t)wait_ms) wait_ms = (long)(call->deadline - now);
+        curl_multi_poll(buffer->multi, NULL, 0, (int)(wait_ms > 0 ? wait_ms : 1), NULL);
+    }
+
+    /* Removing a handle still in flight cancels it */
+    curl_multi_remove_handle(buffer->multi, curl);
+    store(&buffer->pending, 0);
+    store(&buffer->wake, 0);
+    return result;
+}
+
+void tc_stream_buffer_finish(TypecastStreamBuffer* buffer) {
+    store(&buffer->finished, 1);
+}
+
+/* ============================================
+ * Reader
+ * ============================================ */
+
+TYPECAST_API size_t typecast_stream_buffer_available(TypecastStreamBuffer* buffer) {
+    if (!buffer) return 0;
+    int finished = load(&buffer->finished) != 0;
+    size_t buffered = (size_t)(load(&buffer->head) - load(&buffer->tail));
+    if (!buffer->started) {
+        if (buffered < buffer->prebuffer && !finished) return 0;
+        buffer->started = 1;
+    }
+    return buffered;
+}
+
+TYPECAST_API size_t typecast_stream_buffer_read(TypecastStreamBuffer* buffer, uint8_t* out, size_t size) {
+    if (!buffer || !out || size == 0) return 0;
+    size_t n = typecast_stream_buffer_available(buffer);
+    if (n == 0) {
+        if (buffer->started && !load(&buffer->finished)) buffer->underruns++;
+        return 0;
+    }
+    if (n > size) n = size;
+
+    uint64_t tail = load(&buffer->tail);
+    size_t at = (size_t)tail & (buffer->capacity - 1);
+    size_t first = buffer->capacity - at < n ? buffer->capacity - at : n;
+    memcpy(out, buffer->data + at, first);
+    memcpy(out + first, buffer->data, n - first);
+    store(&buffer->tail, tail + n);
+
+    /* Wake a paused producer once its chunk fits, and only once */
+    if (load(&buffer->wake) && room(buffer) >= load(&buffer->pending) && exchange(&buffer->wake, 0)) {
+        curl_multi_wakeup(buffer->multi);
+    }
+    return n;
+}
+
+TYPECAST_API int typecast_stream_buffer_eof(TypecastStreamBuffer* buffer) {
+    if (!buffer) return 1;
+    return load(&buffer->finished) && load(&buffer->head) == load(&buffer->tail);
+}
+
+TYPECAST_API void typecast_stream_buffer_close(TypecastStreamBuffer* buffer) {
+    if (!buffer) return;
+    store(&buffer->closed, 1);
+    curl_multi_wakeup(buffer->multi);
+}
+
+TYPECAST_API TypecastErrorCode typecast_stream_buffer_stats(
+    TypecastStreamBuffer* buffer,
+    TypecastStreamBufferStats* out_stats
+) {
+    if (!buffer || !out_stats) return TYPECAST_ERROR_INVALID_PARAM;
+    uint64_t tail = load(&buffer->tail);
+    uint64_t head = load(&buffer->head);
+    out_stats->capacity = buffer->capacity;
+    out_stats->buffered = (size_t)(head - tail);
+    out_stats->bytes_written = head;
+    out_stats->bytes_read = tail;
+    out_stats->pauses = (unsigned long)load(&buffer->pauses);
+    out_stats->underruns = buffer->underruns;
+    return TYPECAST_OK;
+}
@@ -0,0 +1,24 @@
+/**
+ * Typecast C/C++ SDK - Stream buffer (typecast_stream_buffer.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_STREAM_BUFFER_H
+#define TYPECAST_STREAM_BUFFER_H
+
+#include "typecast_internal.h"
+
+/* Producer side. 1 when all `len` bytes were written, 0 when they do not
+ * fit yet (the transfer must pause), -1 when the reader closed */
+int tc_stream_buffer_push(TypecastStreamBuffer* buffer, const uint8_t* data, size_t len);
+/* Claims an unused buffer for one stream; 0 when it already carried one */
+int tc_stream_buffer_claim(TypecastStreamBuffer* buffer);
+/* Runs one attempt of `transfer` on the buffer's multi handle, pausing
+ * while the buffer is full and resuming when the reader makes room */
+CURLcode tc_stream_buffer_perform(TypecastStreamBuffer* buffer, TcTransfer* transfer, CURL* curl);
+int tc_stream_buffer_closed(TypecastStreamBuffer* buffer);
+/* The producer is done: the reader drains what is left and sees the end */
+void tc_stream_buffer_finish(TypecastStreamBuffer* buffer);
+
+#endif /* TYPECAST_STREAM_BUFFER_H */
@@ -0,0 +1,358 @@
+/**
+ * Typecast C/C++ SDK - Frame-aligned stream delivery
+ *
+ * Sits between libcurl's write callback and the caller's chunk callback
+ * for typecast_text_to_speech_stream_framed(). libcurl hands over bytes
+ * wherever the network happened to split them; the framer reads the WAV
+ * header or the MP3 frame headers as they pass and only calls back with
+ * whole PCM blocks or whole MP3 frames, batched to a minimum duration.
+ *
+ * Runs that lie entirely inside one network buffer are passed on without
+ * a copy. Only a unit that straddles two buffers, or a batch still
+ * waiting for more audio, is gathered in the pending buffer, and that is
+ * topped up just far enough to complete it before going back to passing
+ * the network buffer through.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_stream_framer.h"
+#include "typecast_wav.h"
+
+#define HEADER_LIMIT 65536              /* bytes searched for a WAV data chunk / MP3 sync */
+#define ID3_HEADER_SIZE 10
+#define MP3_HEADER_SIZE 4
+#define UNKNOWN_SIZE UINT64_MAX
+
+typedef enum { P_DETECT, P_WAV_HEADER, P_MP3_SYNC, P_DATA, P_FAILED } Phase;
+
+typedef struct {
+    size_t length;                   /* bytes, header included */
+    uint32_t samples;                /* per channel */
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint32_t bitrate_kbps;
+} Mp3Frame;
+
+struct TcStreamFramer {
+    Phase phase;
+    unsigned int min_ms;
+    typecast_stream_format_callback_t on_format;
+    typecast_stream_callback_t on_chunk;
+    void* user_data;
+    TypecastStreamFormat format;
+
+    uint8_t* pending;
+    size_t pending_len;
+    size_t pending_cap;
+    size_t skip;                     /* ID3 tag bytes still to drop */
+    size_t searched;                 /* bytes passed over looking for an MP3 sync */
+
+    size_t batch_bytes;              /* WAV: whole blocks per chunk, at least */
+    uint64_t data_left;              /* WAV: data chunk bytes to come, UNKNOWN_SIZE */
+    uint64_t batch_samples;          /* MP3: samples per chunk, at least (0 = any) */
+
+    TypecastErrorCode error;
+    const char* message;
+};
+
+static int fail(TcStreamFramer* f, TypecastErrorCode code, const char* message) {
+    f->phase = P_FAILED;
+    f->error = code;
+    f->message = message;
+    return -1;
+}
+
+static int deliver(TcStreamFramer* f, const uint8_t* data, size_t len) {
+    if (len == 0) return 0;
+    if (f->on_chunk(data, len, f->user_data) != 0) {
+        return fail(f, TYPECAST_ERROR_NETWORK, "Stream aborted by callback");
+    }
+    return 0;
+}
+
+static int pending_append(TcStreamFramer* f, const uint8_t* data, size_t len) {
+    if (len == 0) return 0;
+    if (f->pending_len + len > f->pending_cap) {
+        size_t cap = f->pending_cap ? f->pending_cap : 4096;
+        while (cap < f->pending_len + len) cap *= 2;
+        uint8_t* grown = (uint8_t*)realloc(f->pending, cap);
+        if (!grown) return fail(f, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate stream buffer"); /* LCOV_EXCL_LINE category=oom reason="realloc failure" */
+        f->pending = grown;
+        f->pending_cap = cap;
+    }
+    memcpy(f->pending + f->pending_len, data, len);
+    f->pending_len += len;
+    return 0;
+}
+
+static void pending_drop(TcStreamFramer* f, size_t n) {
+    memmove(f->pending, f->pending + n, f->pending_len - n);
+    f->pending_len -= n;
+}
+
+static uint32_t read_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* MPEG audio Layer III frame header; 0 when `p` does not start one */
+static int mp3_parse_header(const uint8_t* p, Mp3Frame* out) {
+    static const uint16_t BITRATES[2][15] = {
+        {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},  /* MPEG-1 */
+        {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}       /* MPEG-2 / 2.5 */
+    };
+    static const uint32_t RATES[3] = {44100, 48000, 32000};
+
+    if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0) return 0;
+    unsigned version = (p[1] >> 3) & 3;      /* 3 = MPEG-1, 2 = MPEG-2, 0 = MPEG-2.5 */
+    unsigned layer = (p[1] >> 1) & 3;        /* 1 = Layer III */
+    unsigned bitrate_index = p[2] >> 4;
+    unsigned rate_index = (p[2] >> 2) & 3;
+    if (version == 1 || layer != 1 || bitrate_index == 0 || bitrate_index == 15 || rate_index == 3) {
+        return 0;
+    }
+
+    int mpeg1 = version == 3;
+    out->sample_rate = RATES[rate_index] >> (mpeg1 ? 0 : version == 2 ? 1 : 2);
+    out->bitrate_kbps = BITRATES[mpeg1 ? 0 : 1][bitrate_index];
+    out->samples = mpeg1 ? 1152 : 576;
+    out->length = (size_t)(out->samples / 8) * out->bitrate_kbps * 1000 / out->sample_rate + ((p[2] >> 1) & 1);
+    out->channels = (p[3] >> 6) == 3 ? 1 : 2;
+    return 1;
+}
+
+/* Pass on the whole blocks at the start of `data` once they make a batch
+ * (any number when `final`); *used is how many bytes are done with */
+static int wav_run(TcStreamFramer* f, const uint8_t* data, size_t len, int final, size_t* used) {
+    *used = 0;
+    if (f->data_left == 0) {
+        /* Chunks after the data chunk are not audio */
+        *used = len;
+        return 0;
+    }
+    size_t usable = (uint64_t)len < f->data_left ? len : (size_t)f->data_left;
+    size_t whole = usable - usable % f->format.block_align;
+    if (!final && whole < f->batch_bytes) return 0;
+    if (deliver(f, data, whole) != 0) return -1;
+    if (f->data_left != UNKNOWN_SIZE) f->data_left -= whole;
+    *used = final || f->data_left == 0 ? len : whole;
+    return 0;
+}
+
+/* Pass on the whole frames at the start of `data`, a batch at a time (all
+ * of them when `final`); *used is how many bytes are done with */
+static int mp3_run(TcStreamFramer* f, const uint8_t* data, size_t len, int final, size_t* used) {
+    size_t pos = 0;
+    size_t start = 0;
+    uint64_t samples = 0;
+
+    *used = 0;
+    while (pos + MP3_HEADER_SIZE <= len) {
+        Mp3Frame frame;
+        if (!mp3_parse_header(data + pos, &frame)) {
+            /* Lost sync: pass on the frames so far and skip to the next
+             * byte that could start a header */
+            if (deliver(f, data + start, pos - start) != 0) return -1;
+            const uint8_t* next = (const uint8_t*)memchr(data + pos + 1, 0xFF, len - pos - 1);
+            pos = next ? (size_t)(next - data) : len;
+            start = pos;
+            samples = 0;
+            continue;
+        }
+        if (frame.length > len - pos) break;
+        pos += frame.length;
+        samples += frame.samples;
+        if (f->batch_samples && samples >= f->batch_samples) {
+            if (deliver(f, data + start, pos - start) != 0) return -1;
+            start = pos;
+            samples = 0;
+        }
+    }
+    if (final || f->batch_samples == 0) {
+        if (deliver(f, data + start, pos - start) != 0) return -1;
+        start = final ? len : pos;
+    }
+    *used = start;
+    return 0;
+}
+
+static int run(TcStreamFramer* f, const uint8_t* data, size_t len, int final, size_t* used) {
+    return f->format.audio_format == TYPECAST_AUDIO_FORMAT_WAV
+        ? wav_run(f, data, len, final, used)
+        : mp3_run(f, data, len, final, used);
+}
+
+static int run_pending(TcStreamFramer* f, int final) {
+    size_t used = 0;
+    if (run(f, f->pending, f->pending_len, final, &used) != 0) return -1;
+    pending_drop(f, used);
+    return 0;
+}
+
+/* Bytes to add to the pending buffer before it may hold a chunk: the rest
+ * of a batch of blocks, or of the frame (header) it ends in. 0 = unknown. */
+static size_t pending_needed(const TcStreamFramer* f) {
+    if (f->format.audio_format == TYPECAST_AUDIO_FORMAT_WAV) {
+        return f->pending_len < f->batch_bytes ? f->batch_bytes - f->pending_len : 0;
+    }
+    size_t pos = 0;
+    while (pos + MP3_HEADER_SIZE <= f->pending_len) {
+        Mp3Frame frame;
+        if (!mp3_parse_header(f->pending + pos, &frame)) return 0;
+        if (frame.length > f->pending_len - pos) return pos + frame.length - f->pending_len;
+        pos += frame.length;
+    }
+    return pos + MP3_HEADER_SIZE - f->pending_len;
+}
+
+static int enter_data(TcStreamFramer* f) {
+    f->phase = P_DATA;
+    if (f->on_format && f->on_format(&f->format, f->user_data) != 0) {
+        return fail(f, TYPECAST_ERROR_NETWORK, "Stream aborted by callback");
+    }
+    return f->pending_len > 0 ? run_pending(f, 0) : 0;
+}
+
+static int wav_header(TcStreamFramer* f) {
+    TcWavInfo info;
+    if (!tc_wav_parse(f->pending, f->pending_len, &info)) {
+        if (f->pending_len > HEADER_LIMIT) return fail(f, TYPECAST_ERROR_JSON_PARSE, "Stream audio is not a WAV file");
+        return 0;
+    }
+    /* Streamed WAVs carry 0 or 0xFFFFFFFF while the length is not known */
+    uint32_t declared = read_u32(info.data - 4);
+    f->data_left = declared == 0 || declared == 0xFFFFFFFFu ? UNKNOWN_SIZE : declared;
+
+    f->format.audio_format = TYPECAST_AUDIO_FORMAT_WAV;
+    f->format.sample_rate = info.sample_rate;
+    f->format.channels = info.channels;
+    f->format.bits_per_sample = info.bits_per_sample;
+    f->format.block_align = info.block_align;
+    f->format.format_tag = info.format_tag;
+    uint64_t frames = (uint64_t)f->min_ms * info.sample_rate / 1000;
+    f->batch_bytes = (size_t)(frames ? frames : 1) * info.block_align;
+
+    pending_drop(f, (size_t)(info.data - f->pending));
+    return enter_data(f);
+}
+
+static int mp3_sync(TcStreamFramer* f) {
+    if (f->pending_len < 3) return 0;
+    if (memcmp(f->pending, "ID3", 3) == 0) {
+        if (f->pending_len < ID3_HEADER_SIZE) return 0;
+        const uint8_t* h = f->pending;
+        size_t size = ((size_t)(h[6] & 0x7F) << 21) | ((size_t)(h[7] & 0x7F) << 14) |
+                      ((size_t)(h[8] & 0x7F) << 7) | (size_t)(h[9] & 0x7F);
+        size_t total = ID3_HEADER_SIZE + size + ((h[5] & 0x10) ? ID3_HEADER_SIZE : 0);
+        size_t dropped = total < f->pending_len ? total : f->pending_len;
+        pending_drop(f, dropped);
+        f->skip = total - dropped;
+        return f->skip ? 0 : mp3_sync(f);
+    }
+
+    size_t pos = 0;
+    while (pos + MP3_HEADER_SIZE <= f->pending_len) {
+        Mp3Frame frame;
+        if (mp3_parse_header(f->pending + pos, &frame)) {
+            pending_drop(f, pos);
+            f->format.audio_format = TYPECAST_AUDIO_FORMAT_MP3;
+            f->format.sample_rate = frame.sample_rate;
+            f->format.channels = frame.channels;
+            f->format.bitrate_kbps = frame.bitrate_kbps;
+            f->batch_samples = (uint64_t)f->min_ms * frame.sample_rate / 1000;
+            return enter_data(f);
+        }
+        pos++;
+    }
+    pending_drop(f, pos);
+    f->searched += pos;
+    if (f->searched > HEADER_LIMIT) return fail(f, TYPECAST_ERROR_JSON_PARSE, "Stream audio is neither WAV nor MP3");
+    return 0;
+}
+
+static int header_step(TcStreamFramer* f) {
+    if (f->phase == P_DETECT) {
+        if (f->pending_len < 4) return 0;
+        f->phase = memcmp(f->pending, "RIFF", 4) == 0 ? P_WAV_HEADER : P_MP3_SYNC;
+    }
+    return f->phase == P_WAV_HEADER ? wav_header(f) : mp3_sync(f);
+}
+
+TcStreamFramer* tc_framer_new(const TypecastStreamFraming* framing,
+    typecast_stream_callback_t on_chunk, void* user_data) {
+    TcStreamFramer* f = (TcStreamFramer*)calloc(1, sizeof(TcStreamFramer));
+    if (!f) return NULL; /* LCOV_EXCL_LINE category=oom reason="calloc failure" */
+    if (framing) {
+        f->min_ms = framing->min_chunk_ms;
+        f->on_format = framing->on_format;
+    }
+    f->on_chunk = on_chunk;
+    f->user_data = user_data;
+    return f;
+}
+
+int tc_framer_feed(TcStreamFramer* f, const uint8_t* data, size_t len) {
+    while (len > 0 && f->phase != P_DATA) {
+        if (f->phase == P_FAILED) return -1;
+        if (f->skip > 0) {
+            size_t n = len < f->skip ? len : f->skip;
+            f->skip -= n;
+            data += n;
+            len -= n;
+            continue;
+        }
+        /* Headers are small; gather them before parsing */
+        if (pending_append(f, data, len) != 0) return -1;
+        len = 0;
+        if (header_step(f) != 0) return -1;
+    }
+    if (f->phase == P_FAILED) return -1;
+    if (len == 0) return 0;
+
+    /* Complete what is pending from the front of the new buffer */
+    while (len > 0 && f->pending_len > 0) {
+        size_t need = pending_needed(f);
+        if (need == 0 || need > len) need = len;
+        if (pending_append(f, data, need) != 0) return -1;
+        data += need;
+        len -= need;
+        if (run_pending(f, 0) != 0) return -1;
+    }
+    if (len == 0) return 0;
+
+    /* The rest goes straight from libcurl's buffer; keep the tail */
+    size_t used = 0;
+    if (run(f, data, len, 0, &used) != 0) return -1;
+    return pending_append(f, data + used, len - used);
+}
+
+int tc_framer_finish(TcStreamFramer* f) {
+    if (f->phase == P_FAILED) return -1;
+    if (f->phase != P_DATA) {
+        /* An empty body has nothing to frame */
+        if (f->phase == P_DETECT && f->pending_len == 0) return 0;
+        return fail(f, TYPECAST_ERROR_JSON_PARSE, f->phase == P_WAV_HEADER
+            ? "Stream audio is not a WAV file" : "Stream audio is neither WAV nor MP3");
+    }
+    return run_pending(f, 1);
+}
+
+TypecastErrorCode tc_framer_error(const TcStreamFramer* f, const char** message) {
+    if (message) *message = f->message;
+    return f->phase == P_FAILED ? f->error : TYPECAST_OK;
+}
+
+void tc_framer_free(TcStreamFramer* f) {
+    if (!f) return;
+    free(f->pending);
+    free(f);
+}
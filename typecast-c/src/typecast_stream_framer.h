@@ -0,0 +1,22 @@
+/**
+ * Typecast C/C++ SDK - Stream framing (typecast_stream_framer.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_STREAM_FRAMER_H
+#define TYPECAST_STREAM_FRAMER_H
+
+#include "typecast_internal.h"
+
+TcStreamFramer* tc_framer_new(const TypecastStreamFraming* framing,
+    typecast_stream_callback_t on_chunk, void* user_data);
+/* 0 to continue; on failure (callback abort, not WAV / MP3, OOM) see
+ * tc_framer_error */
+int tc_framer_feed(TcStreamFramer* framer, const uint8_t* data, size_t len);
+/* End of a 200 body: delivers what is left, shorter than a batch */
+int tc_framer_finish(TcStreamFramer* framer);
+TypecastErrorCode tc_framer_error(const TcStreamFramer* framer, const char** message);
+void tc_framer_free(TcStreamFramer* framer);
+
+#endif /* TYPECAST_STREAM_FRAMER_H */
@@ -0,0 +1,66 @@
+/**
+ * Typecast C/C++ SDK - Audio sink of the with-timestamps parser
+ *
+ * Characters of the "audio" string arrive here in whatever pieces the
+ * network delivers. They are kept as base64 text, or decoded on the fly
+ * into binary that is either collected or handed to the stream callback
+ * in chunks of TC_TS_AUDIO_CHUNK bytes.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include "typecast.h"
+#include "typecast_timestamps_state.h"
+#include "typecast_base64.h"
+
+#define DECODE_STEP 4096                /* base64 characters decoded per pass */
+
+int tc_ts_audio_flush(TcTimestampsParser* p) {
+    if (!p->on_audio || p->audio.size == 0) return 0;
+    uint64_t start = tc_monotonic_us();
+    if (p->first_audio_at == 0) p->first_audio_at = start;
+    int rc = p->on_audio(p->audio.data, p->audio.size, p->user_data);
+    p->callback_us += tc_monotonic_us() - start;
+    p->audio.size = 0;
+    if (rc != 0) return tc_ts_fail(p, TYPECAST_ERROR_NETWORK, "Stream aborted by callback");
+    return 0;
+}
+
+static int invalid_audio(TcTimestampsParser* p) {
+    return tc_ts_fail(p, TYPECAST_ERROR_JSON_PARSE, "Invalid base64 audio");
+}
+
+static int decode_audio(TcTimestampsParser* p, const unsigned char* data, size_t len) {
+    uint8_t out[TC_BASE64_STREAM_BOUND(DECODE_STEP)];
+    while (len > 0) {
+        size_t step = len < DECODE_STEP ? len : DECODE_STEP;
+        size_t n = 0;
+        uint64_t start = tc_monotonic_us();
+        int rc = tc_base64_stream_update(&p->base64, data, step, out, &n);
+        p->decode_us += tc_monotonic_us() - start;
+        if (rc != 0) return invalid_audio(p);
+        if (tc_ts_buffer_append(p, &p->audio, out, n) != 0) return -1;
+        if (p->on_audio && p->audio.size >= TC_TS_AUDIO_CHUNK && tc_ts_audio_flush(p) != 0) return -1;
+        data += step;
+        len -= step;
+    }
+    return 0;
+}
+
+int tc_ts_audio_put(TcTimestampsParser* p, const unsigned char* data, size_t len) {
+    if (p->decode) return decode_audio(p, data, len);
+    return tc_ts_buffer_append(p, &p->audio, data, len);
+}
+
+int tc_ts_audio_finish(TcTimestampsParser* p) {
+    if (!p->decode) return 0;
+    uint8_t out[3];
+    size_t n = 0;
+    if (tc_base64_stream_final(&p->base64, out, &n) != 0) return invalid_audio(p);
+    if (tc_ts_buffer_append(p, &p->audio, out, n) != 0) return -1;
+    return tc_ts_audio_flush(p);
+}
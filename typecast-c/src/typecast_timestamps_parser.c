@@ -0,0 +1,343 @@
+/**
+ * Typecast C/C++ SDK - Incremental parser for with-timestamps responses
+ *
+ * The with-timestamps body is one JSON object whose "audio" member is a
+ * base64 string as large as the audio itself. Instead of buffering the
+ * body and building a DOM, the parser is fed bytes as they arrive: the
+ * audio string is either collected as-is (audio_base64) or decoded on the
+ * fly into binary / a callback, and "words" / "characters" segments are
+ * filled in directly, or handed to a callback one by one when streaming.
+ * Every other value is validated and skipped. This unit drives containers
+ * and members; strings and numbers are read in typecast_timestamps_strings.c
+ * and the audio sink is typecast_timestamps_audio.c.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_timestamps_state.h"
+#include "typecast_timestamps_parser.h"
+
+#define MAX_PRESIZE (256u * 1024 * 1024) /* cap on trusting Content-Length */
+
+int tc_ts_fail(TcTimestampsParser* p, TypecastErrorCode code, const char* message) {
+    if (p->error == TYPECAST_OK) {
+        p->error = code;
+        p->message = message;
+    }
+    return -1;
+}
+
+int tc_ts_syntax_error(TcTimestampsParser* p) {
+    return tc_ts_fail(p, TYPECAST_ERROR_JSON_PARSE, "Failed to parse JSON response");
+}
+
+/* LCOV_EXCL_START */
+/* category=oom reason="buffer growth failure" */
+int tc_ts_oom(TcTimestampsParser* p) {
+    return tc_ts_fail(p, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response");
+}
+/* LCOV_EXCL_STOP */
+
+int tc_ts_buffer_append(TcTimestampsParser* p, ResponseBuffer* buf, const void* data, size_t len) {
+    if (len == 0) return 0;
+    if (tc_response_write((void*)data, 1, len, buf) != len) return tc_ts_oom(p); /* LCOV_EXCL_LINE category=oom reason="buffer growth failure" */
+    return 0;
+}
+
+static void segments_free(SegmentList* list) {
+    for (size_t i = 0; i < list->count; i++) free(list->items[i].text);
+    free(list->items);
+    memset(list, 0, sizeof(*list));
+}
+
+/* ============================================
+ * Values
+ * ============================================ */
+
+static int key_context(const TcTimestampsParser* p) {
+    return (p->depth == 1 && p->stack[0] == '{') || (p->in_segment && p->depth == 3);
+}
+
+int tc_ts_value_done(TcTimestampsParser* p) {
+    p->pending = F_NONE;
+    p->state = p->depth == 0 ? S_DONE : S_AFTER_VALUE;
+    return 0;
+}
+
+static int deliver_segment(TcTimestampsParser* p) {
+    uint64_t start = tc_monotonic_us();
+    int rc = p->on_segment(p->list->kind, &p->segment, p->segment_user_data);
+    p->callback_us += tc_monotonic_us() - start;
+    free(p->segment.text);
+    if (rc != 0) return tc_ts_fail(p, TYPECAST_ERROR_NETWORK, "Stream aborted by callback");
+    return 0;
+}
+
+static int segment_done(TcTimestampsParser* p) {
+    SegmentList* list = p->list;
+    p->in_segment = 0;
+    if (!p->segment.text) list->valid = 0;
+    if (!list->valid) {
+        free(p->segment.text);
+        return 0;
+    }
+    if (p->on_segment) return deliver_segment(p);
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 16;
+        TypecastAlignmentSegment* items = (TypecastAlignmentSegment*)realloc(
+            list->items, capacity * sizeof(*items));
+        /* LCOV_EXCL_START */
+        /* category=oom reason="growth of the segment array" */
+        if (!items) {
+            free(p->segment.text);
+            return tc_ts_oom(p);
+        }
+        /* LCOV_EXCL_STOP */
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = p->segment;
+    return 0;
+}
+
+static int open_container(TcTimestampsParser* p, char c) {
+    if (p->depth >= TC_TS_MAX_DEPTH) return tc_ts_syntax_error(p);
+    Field field = p->pending;
+    p->pending = F_NONE;
+
+    if (c == '[' && (field == F_WORDS || field == F_CHARACTERS) && !p->list) {
+        p->list = field == F_WORDS ? &p->words : &p->characters;
+        p->list->kind = field == F_WORDS ? TYPECAST_ALIGNMENT_WORD : TYPECAST_ALIGNMENT_CHARACTER;
+        p->list->valid = 1;
+    } else if (c == '{' && p->list && p->depth == 2) {
+        memset(&p->segment, 0, sizeof(p->segment));
+        p->seen[F_TEXT] = p->seen[F_START] = p->seen[F_END] = 0;
+        p->in_segment = 1;
+    }
+
+    p->stack[p->depth++] = (unsigned char)c;
+    p->state = c == '{' ? S_KEY_FIRST : S_ARRAY_FIRST;
+    return 0;
+}
+
+static int close_container(TcTimestampsParser* p, char c) {
+    if (p->stack[p->depth - 1] != (c == '}' ? '{' : '[')) return tc_ts_syntax_error(p);
+    p->depth--;
+    if (p->in_segment && p->depth == 2) {
+        if (segment_done(p) != 0) return -1;
+    } else if (p->list && p->depth == 1) {
+        if (!p->list->valid || p->list->count == 0) segments_free(p->list);
+        p->list = NULL;
+    }
+    return tc_ts_value_done(p);
+}
+
+static int begin_value(TcTimestampsParser* p, char c) {
+    Field field = p->pending;
+    if (p->seen[field] && field != F_NONE) field = F_NONE;  /* first member wins */
+    p->seen[field] = 1;
+    p->pending = field;
+
+    /* Segments must be objects with a string "text" */
+    if (p->list && p->depth == 2 && c != '{') p->list->valid = 0;
+    if (field == F_TEXT && c != '"') p->list->valid = 0;
+    if (field == F_AUDIO && c == '"') p->have_audio = 1;
+
+    switch (c) {
+        case '{':
+        case '[':
+            if (field != F_WORDS && field != F_CHARACTERS) p->pending = F_NONE;
+            return open_container(p, c);
+        case '"':
+            p->target = T_DISCARD;
+            if (field == F_AUDIO && !p->skip_audio) p->target = T_AUDIO;
+            if (field == F_FORMAT) p->target = T_FORMAT;
+            if (field == F_TEXT) p->target = T_SEGMENT_TEXT;
+            if (p->target == T_AUDIO && !p->decode && p->expected) p->audio.size_hint = p->expected;
+            if (p->target == T_AUDIO && p->decode && !p->on_audio && p->expected) {
+                p->audio.size_hint = p->expected / 4 * 3;
+            }
+            p->state = S_STRING;
+            return 0;
+        case 't':
+        case 'f':
+        case 'n':
+            p->literal = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+            p->scratch_len = 1;
+            p->state = S_LITERAL;
+            return 0;
+        default:
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+') {
+                if (field != F_DURATION && field != F_START && field != F_END) p->pending = F_NONE;
+                p->scratch[0] = c;
+                p->scratch_len = 1;
+                p->state = S_NUMBER;
+                return 0;
+            }
+            return tc_ts_syntax_error(p);
+    }
+}
+
+/* ============================================
+ * Driver
+ * ============================================ */
+
+static int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/* Consume input starting at data[*i]; advances *i past what was used */
+static int step(TcTimestampsParser* p, const char* data, size_t len, size_t* i) {
+    if (p->state >= S_STRING && p->state <= S_LITERAL) return tc_ts_scan_scalar(p, data, len, i);
+
+    char c = data[*i];
+    (*i)++;
+    if (p->state == S_DONE || is_space(c)) return 0;
+    switch (p->state) {
+        case S_ARRAY_FIRST:
+            if (c == ']') return close_container(p, c);
+            return begin_value(p, c);
+        case S_VALUE:
+            return begin_value(p, c);
+        case S_KEY_FIRST:
+            if (c == '}') return close_container(p, c);
+            /* fall through */
+        case S_KEY:
+            if (c != '"') return tc_ts_syntax_error(p);
+            p->key_len = 0;
+            p->target = key_context(p) ? T_KEY : T_SKIPPED_KEY;
+            p->state = S_STRING;
+            return 0;
+        case S_COLON:
+            if (c != ':') return tc_ts_syntax_error(p);
+            p->state = S_VALUE;
+            return 0;
+        default: /* S_AFTER_VALUE */
+            if (c == ',') {
+                p->state = p->stack[p->depth - 1] == '{' ? S_KEY : S_VALUE;
+                return 0;
+            }
+            if (c == '}' || c == ']') return close_container(p, c);
+            return tc_ts_syntax_error(p);
+    }
+}
+
+TcTimestampsParser* tc_ts_parser_new(int decode_audio, typecast_stream_callback_t on_audio, void* user_data) {
+    TcTimestampsParser* p = (TcTimestampsParser*)calloc(1, sizeof(TcTimestampsParser));
+    if (!p) return NULL; /* LCOV_EXCL_LINE category=oom reason="parser allocation" */
+    p->decode = decode_audio || on_audio;
+    p->on_audio = on_audio;
+    p->user_data = user_data;
+    p->text.size_hint = 32;
+    if (on_audio) p->audio.size_hint = TC_TS_AUDIO_CHUNK;
+    return p;
+}
+
+void tc_ts_parser_stream_segments(TcTimestampsParser* p, typecast_alignment_callback_t on_segment,
+    void* user_data) {
+    p->on_segment = on_segment;
+    p->segment_user_data = user_data;
+    p->skip_audio = !p->on_audio;
+}
+
+void tc_ts_parser_expect(TcTimestampsParser* p, size_t body_size) {
+    if (!p->seen[F_AUDIO]) p->expected = body_size < MAX_PRESIZE ? body_size : MAX_PRESIZE;
+}
+
+int tc_ts_parser_feed(TcTimestampsParser* p, const char* data, size_t len) {
+    if (p->error != TYPECAST_OK) return -1;
+    size_t i = 0;
+    while (i < len) {
+        if (p->state == S_DONE) return 0;  /* trailing bytes are ignored */
+        if (step(p, data, len, &i) != 0) return -1;
+    }
+    /* Hand decoded audio over per network read, not only per full chunk */
+    if (p->target == T_AUDIO && tc_ts_audio_flush(p) != 0) return -1;
+    return 0;
+}
+
+void tc_ts_parser_times(const TcTimestampsParser* p, uint64_t* decode_us, uint64_t* callback_us,
+    uint64_t* first_audio_at) {
+    *decode_us = p->decode_us;
+    *callback_us = p->callback_us;
+    *first_audio_at = p->first_audio_at;
+}
+
+TypecastErrorCode tc_ts_parser_error(const TcTimestampsParser* p, const char** message) {
+    if (message) *message = p->message;
+    return p->error;
+}
+
+TypecastErrorCode tc_ts_parser_finish(
+    TcTimestampsParser* p,
+    TypecastTTSWithTimestampsResponse** out_response,
+    TypecastError* error
+) {
+    *out_response = NULL;
+    if (p->error == TYPECAST_OK && p->state == S_NUMBER && p->depth == 0) tc_ts_number_done(p);
+    if (p->error == TYPECAST_OK && p->state != S_DONE) tc_ts_syntax_error(p);
+    if (p->error != TYPECAST_OK) {
+        tc_error_set(error, p->error, p->message);
+        return p->error;
+    }
+
+    /* Decoded results carry their audio beside the plain response */
+    TypecastTTSWithTimestampsDecodedResponse* decoded = NULL;
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    if (p->decode) {
+        decoded = (TypecastTTSWithTimestampsDecodedResponse*)calloc(1, sizeof(*decoded));
+        if (decoded) resp = &decoded->timestamps;
+    } else {
+        resp = (TypecastTTSWithTimestampsResponse*)calloc(1, sizeof(TypecastTTSWithTimestampsResponse));
+    }
+    /* LCOV_EXCL_START */
+    /* category=oom reason="calloc of the response" */
+    if (!resp) {
+        tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate response");
+        return TYPECAST_ERROR_OUT_OF_MEMORY;
+    }
+    /* LCOV_EXCL_STOP */
+
+    if (p->have_audio && !p->on_audio) {
+        if (decoded) {
+            decoded->audio_data = p->audio.data;
+            decoded->audio_size = p->audio.size;
+        } else {
+            /* "audio": "" leaves no buffer but is still a string */
+            resp->audio_base64 = p->audio.data ? (char*)p->audio.data : (char*)calloc(1, 1);
+            tc_decoded_audio_attach(resp);
+        }
+        memset(&p->audio, 0, sizeof(p->audio));
+    }
+    resp->audio_format = p->audio_format;
+    p->audio_format = NULL;
+    resp->audio_duration = p->audio_duration;
+    resp->words = p->words.items;
+    resp->words_count = p->words.count;
+    resp->characters = p->characters.items;
+    resp->characters_count = p->characters.count;
+    memset(&p->words, 0, sizeof(p->words));
+    memset(&p->characters, 0, sizeof(p->characters));
+
+    *out_response = resp;
+    return TYPECAST_OK;
+}
+
+void tc_ts_parser_free(TcTimestampsParser* p) {
+    if (!p) return;
+    free(p->audio.data);
+    free(p->text.data);
+    free(p->audio_format);
+    if (p->in_segment) free(p->segment.text);
+    segments_free(&p->words);
+    segments_free(&p->characters);
+    free(p);
+}
@@ -0,0 +1,37 @@
+/**
+ * Typecast C/C++ SDK - With-timestamps parser (typecast_timestamps_parser.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_TIMESTAMPS_PARSER_H
+#define TYPECAST_TIMESTAMPS_PARSER_H
+
+#include "typecast_internal.h"
+
+/* decode_audio: decode "audio" into audio_data instead of keeping
+ * audio_base64; the finished response is then the `timestamps` member of
+ * a TypecastTTSWithTimestampsDecodedResponse. A non-NULL on_audio
+ * receives the decoded bytes instead. */
+TcTimestampsParser* tc_ts_parser_new(int decode_audio, typecast_stream_callback_t on_audio, void* user_data);
+/* Hand every parsed segment to on_segment instead of keeping it. Without
+ * an on_audio the audio is skipped rather than kept. */
+void tc_ts_parser_stream_segments(TcTimestampsParser* parser, typecast_alignment_callback_t on_segment,
+    void* user_data);
+/* Body size hint (Content-Length) used to presize the audio buffer */
+void tc_ts_parser_expect(TcTimestampsParser* parser, size_t body_size);
+/* 0 on success; on failure see tc_ts_parser_error */
+int tc_ts_parser_feed(TcTimestampsParser* parser, const char* data, size_t len);
+TypecastErrorCode tc_ts_parser_error(const TcTimestampsParser* parser, const char** message);
+/* Microseconds spent decoding base64 and in the callbacks so far, and when
+ * on_audio first ran (tc_monotonic_us(), 0 = never) */
+void tc_ts_parser_times(const TcTimestampsParser* parser, uint64_t* decode_us, uint64_t* callback_us,
+    uint64_t* first_audio_at);
+TypecastErrorCode tc_ts_parser_finish(TcTimestampsParser* parser,
+    TypecastTTSWithTimestampsResponse** out_response, TypecastError* error);
+void tc_ts_parser_free(TcTimestampsParser* parser);
+/* Give a response with audio_base64 a decode cache for audio_bytes /
+ * save_audio; without one (allocation failed) they decode on every use */
+void tc_decoded_audio_attach(const TypecastTTSWithTimestampsResponse* response);
+
+#endif /* TYPECAST_TIMESTAMPS_PARSER_H */
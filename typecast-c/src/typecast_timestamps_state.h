@@ -0,0 +1,111 @@
+/**
+ * Typecast C/C++ SDK - With-timestamps parser state
+ *
+ * Private to the parser's units: typecast_timestamps_parser.c drives the
+ * containers and members, typecast_timestamps_strings.c the string and
+ * number states, typecast_timestamps_audio.c the audio sink.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_TIMESTAMPS_STATE_H
+#define TYPECAST_TIMESTAMPS_STATE_H
+
+#include "typecast_internal.h"
+#include "typecast_base64.h"
+
+#define TC_TS_MAX_DEPTH 1000                  /* same nesting limit as cJSON */
+#define TC_TS_AUDIO_CHUNK 16384               /* decoded bytes batched per callback */
+
+typedef enum {
+    S_VALUE, S_ARRAY_FIRST, S_KEY_FIRST, S_KEY, S_COLON, S_AFTER_VALUE,
+    S_STRING, S_ESCAPE, S_UNICODE, S_NUMBER, S_LITERAL, S_DONE
+} ParseState;
+
+/* Where the characters of the current string go */
+typedef enum { T_DISCARD, T_KEY, T_SKIPPED_KEY, T_AUDIO, T_FORMAT, T_SEGMENT_TEXT } StringTarget;
+
+/* Members the parser extracts; F_NONE for everything else */
+typedef enum {
+    F_NONE, F_AUDIO, F_FORMAT, F_DURATION, F_WORDS, F_CHARACTERS,
+    F_TEXT, F_START, F_END
+} Field;
+
+typedef struct {
+    TypecastAlignmentSegment* items;
+    size_t count;
+    size_t capacity;
+    TypecastAlignmentKind kind;
+    int valid;                       /* cleared by a malformed segment */
+} SegmentList;
+
+struct TcTimestampsParser {
+    ParseState state;
+    unsigned char stack[TC_TS_MAX_DEPTH];  /* '{' or '[' per open container */
+    size_t depth;
+
+    StringTarget target;
+    char key[24];
+    size_t key_len;
+    Field pending;                   /* member whose value comes next */
+    char scratch[64];                /* number / literal characters */
+    size_t scratch_len;
+    const char* literal;
+    unsigned int unicode;
+    int unicode_digits;
+    unsigned int high_surrogate;
+
+    /* Extracted members */
+    int seen[F_END + 1];
+    int have_audio;                  /* "audio" was a string */
+    ResponseBuffer audio;            /* base64 text, or decoded bytes */
+    ResponseBuffer text;             /* audio_format / segment text scratch */
+    char* audio_format;
+    float audio_duration;
+    SegmentList words;
+    SegmentList characters;
+    SegmentList* list;               /* segment array being read */
+    int in_segment;
+    TypecastAlignmentSegment segment;
+
+    /* Audio decoding */
+    int decode;
+    typecast_stream_callback_t on_audio;
+    void* user_data;
+    TcBase64Stream base64;
+    size_t expected;
+    int skip_audio;
+
+    /* Streaming segments */
+    typecast_alignment_callback_t on_segment;
+    void* segment_user_data;
+
+    /* Time spent in base64 decoding and in the callbacks, for call metrics */
+    uint64_t decode_us;
+    uint64_t callback_us;
+    uint64_t first_audio_at;
+
+    TypecastErrorCode error;
+    const char* message;
+};
+
+/* Errors; each records the first failure and returns -1 */
+int tc_ts_fail(TcTimestampsParser* p, TypecastErrorCode code, const char* message);
+int tc_ts_syntax_error(TcTimestampsParser* p);
+int tc_ts_oom(TcTimestampsParser* p);
+int tc_ts_buffer_append(TcTimestampsParser* p, ResponseBuffer* buf, const void* data, size_t len);
+
+/* Ends the current value and picks the next state */
+int tc_ts_value_done(TcTimestampsParser* p);
+
+/* String and number states (typecast_timestamps_strings.c). scan_scalar
+ * consumes input from data[*i] while in S_STRING..S_LITERAL. */
+int tc_ts_scan_scalar(TcTimestampsParser* p, const char* data, size_t len, size_t* i);
+int tc_ts_number_done(TcTimestampsParser* p);
+
+/* Audio sink (typecast_timestamps_audio.c) */
+int tc_ts_audio_put(TcTimestampsParser* p, const unsigned char* data, size_t len);
+int tc_ts_audio_finish(TcTimestampsParser* p);
+int tc_ts_audio_flush(TcTimestampsParser* p);
+
+#endif /* TYPECAST_TIMESTAMPS_STATE_H */
@@ -0,0 +1,258 @@
+/**
+ * Typecast C/C++ SDK - String and number states of the with-timestamps parser
+ *
+ * Strings are copied in runs up to the next quote or backslash and routed
+ * by target: member keys are matched, audio goes to the audio sink, and
+ * audio_format / segment text collect into the text scratch. Escapes,
+ * surrogate pairs, numbers and the true/false/null literals are read here
+ * as well, so the driver only ever sees whole values.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32) || defined(_WIN64)
+    #define strcasecmp _stricmp
+#else
+    #include <strings.h>  /* for strcasecmp */
+#endif
+
+#include "typecast.h"
+#include "typecast_timestamps_state.h"
+
+/* ============================================
+ * Strings
+ * ============================================ */
+
+static int put(TcTimestampsParser* p, const char* data, size_t len) {
+    if (len == 0) return 0;
+    switch (p->target) {
+        case T_KEY:
+            if (p->key_len + len < sizeof(p->key)) {
+                memcpy(p->key + p->key_len, data, len);
+                p->key_len += len;
+            } else {
+                p->key_len = sizeof(p->key);  /* too long for any known key */
+            }
+            return 0;
+        case T_AUDIO:
+            return tc_ts_audio_put(p, (const unsigned char*)data, len);
+        case T_FORMAT:
+        case T_SEGMENT_TEXT:
+            return tc_ts_buffer_append(p, &p->text, data, len);
+        default:
+            return 0;
+    }
+}
+
+static int put_codepoint(TcTimestampsParser* p, unsigned int cp) {
+    char buf[4];
+    size_t n;
+    if (cp < 0x80) {
+        buf[0] = (char)cp;
+        n = 1;
+    } else if (cp < 0x800) {
+        buf[0] = (char)(0xC0 | (cp >> 6));
+        buf[1] = (char)(0x80 | (cp & 0x3F));
+        n = 2;
+    } else if (cp < 0x10000) {
+        buf[0] = (char)(0xE0 | (cp >> 12));
+        buf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        buf[2] = (char)(0x80 | (cp & 0x3F));
+        n = 3;
+    } else {
+        buf[0] = (char)(0xF0 | (cp >> 18));
+        buf[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        buf[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        buf[3] = (char)(0x80 | (cp & 0x3F));
+        n = 4;
+    }
+    return put(p, buf, n);
+}
+
+/* A high surrogate not followed by a low one is written on its own */
+static int put_text(TcTimestampsParser* p, const char* data, size_t len) {
+    if (p->high_surrogate) {
+        unsigned int high = p->high_surrogate;
+        p->high_surrogate = 0;
+        if (put_codepoint(p, high) != 0) return -1;
+    }
+    return put(p, data, len);
+}
+
+static int put_escape(TcTimestampsParser* p, unsigned int cp) {
+    if (p->high_surrogate && cp >= 0xDC00 && cp <= 0xDFFF) {
+        unsigned int full = 0x10000 + ((p->high_surrogate - 0xD800) << 10) + (cp - 0xDC00);
+        p->high_surrogate = 0;
+        return put_codepoint(p, full);
+    }
+    if (put_text(p, NULL, 0) != 0) return -1;
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        p->high_surrogate = cp;
+        return 0;
+    }
+    if (cp >= 0xDC00 && cp <= 0xDFFF) cp = 0xFFFD;  /* lone low surrogate */
+    return put_codepoint(p, cp);
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static char* take_text(TcTimestampsParser* p) {
+    char* text = (char*)malloc(p->text.size + 1);
+    if (text) {
+        if (p->text.size) memcpy(text, p->text.data, p->text.size);
+        text[p->text.size] = '\0';
+    }
+    p->text.size = 0;
+    return text;
+}
+
+static Field match_key(TcTimestampsParser* p) {
+    if (p->key_len >= sizeof(p->key)) return F_NONE;
+    p->key[p->key_len] = '\0';
+    /* Member lookup is case-insensitive, as with cJSON_GetObjectItem */
+    if (p->depth == 1 && p->stack[0] == '{') {
+        if (strcasecmp(p->key, "audio") == 0) return F_AUDIO;
+        if (strcasecmp(p->key, "audio_format") == 0) return F_FORMAT;
+        if (strcasecmp(p->key, "audio_duration") == 0) return F_DURATION;
+        if (strcasecmp(p->key, "words") == 0) return F_WORDS;
+        if (strcasecmp(p->key, "characters") == 0) return F_CHARACTERS;
+    } else if (p->in_segment && p->depth == 3) {
+        if (strcasecmp(p->key, "text") == 0) return F_TEXT;
+        if (strcasecmp(p->key, "start") == 0) return F_START;
+        if (strcasecmp(p->key, "end") == 0) return F_END;
+    }
+    return F_NONE;
+}
+
+static int string_done(TcTimestampsParser* p) {
+    if (put_text(p, NULL, 0) != 0) return -1;
+    StringTarget target = p->target;
+    p->target = T_DISCARD;
+    switch (target) {
+        case T_KEY:
+            p->pending = match_key(p);
+            p->state = S_COLON;
+            return 0;
+        case T_SKIPPED_KEY:
+            p->pending = F_NONE;
+            p->state = S_COLON;
+            return 0;
+        case T_AUDIO:
+            if (tc_ts_audio_finish(p) != 0) return -1;
+            break;
+        case T_FORMAT:
+            p->audio_format = take_text(p);
+            if (!p->audio_format) return tc_ts_oom(p); /* LCOV_EXCL_LINE category=oom reason="allocation of audio_format" */
+            break;
+        case T_SEGMENT_TEXT:
+            p->segment.text = take_text(p);
+            if (!p->segment.text) return tc_ts_oom(p); /* LCOV_EXCL_LINE category=oom reason="allocation of segment text" */
+            break;
+        default:
+            break;
+    }
+    return tc_ts_value_done(p);
+}
+
+/* ============================================
+ * Numbers
+ * ============================================ */
+
+static int is_number_char(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+int tc_ts_number_done(TcTimestampsParser* p) {
+    char* end = NULL;
+    p->scratch[p->scratch_len] = '\0';
+    /* strtod follows the C locale's decimal point, as cJSON does */
+    char* dot = strchr(p->scratch, '.');
+    char point = localeconv()->decimal_point[0];
+    if (dot && point != '.') *dot = point;
+    double value = strtod(p->scratch, &end);
+    if (p->scratch_len == 0 || *end != '\0') return tc_ts_syntax_error(p);
+
+    if (p->pending == F_DURATION) p->audio_duration = (float)value;
+    if (p->pending == F_START) p->segment.start = (float)value;
+    if (p->pending == F_END) p->segment.end = (float)value;
+    return tc_ts_value_done(p);
+}
+
+/* ============================================
+ * Scanner
+ * ============================================ */
+
+int tc_ts_scan_scalar(TcTimestampsParser* p, const char* data, size_t len, size_t* i) {
+    char c = data[*i];
+    switch (p->state) {
+        case S_STRING: {
+            /* Copy the run up to the next quote or backslash in one go */
+            size_t start = *i, j = start;
+            while (j < len && data[j] != '"' && data[j] != '\\') j++;
+            if (j > start && put_text(p, data + start, j - start) != 0) return -1;
+            *i = j;
+            if (j == len) return 0;
+            (*i)++;
+            if (data[j] == '"') return string_done(p);
+            p->state = S_ESCAPE;
+            return 0;
+        }
+        case S_ESCAPE: {
+            static const char from[] = "\"\\/bfnrt";
+            static const char to[] = "\"\\/\b\f\n\r\t";
+            (*i)++;
+            if (c == 'u') {
+                p->unicode = 0;
+                p->unicode_digits = 0;
+                p->state = S_UNICODE;
+                return 0;
+            }
+            const char* hit = c ? strchr(from, c) : NULL;
+            if (!hit) return tc_ts_syntax_error(p);
+            p->state = S_STRING;
+            return put_text(p, &to[hit - from], 1);
+        }
+        case S_UNICODE: {
+            int v = hex_value(c);
+            if (v < 0) {
+                /* Not a valid escape: keep the characters as written */
+                char raw[6] = {'\\', 'u'};
+                for (int k = 0; k < p->unicode_digits; k++) {
+                    raw[2 + k] = "0123456789abcdef"[(p->unicode >> (4 * (p->unicode_digits - 1 - k))) & 0xF];
+                }
+                p->state = S_STRING;
+                return put_text(p, raw, 2 + (size_t)p->unicode_digits);
+            }
+            (*i)++;
+            p->unicode = (p->unicode << 4) | (unsigned int)v;
+            if (++p->unicode_digits < 4) return 0;
+            p->state = S_STRING;
+            return put_escape(p, p->unicode);
+        }
+        case S_NUMBER:
+            if (is_number_char(c)) {
+                if (p->scratch_len + 1 >= sizeof(p->scratch)) return tc_ts_syntax_error(p);
+                p->scratch[p->scratch_len++] = c;
+                (*i)++;
+                return 0;
+            }
+            return tc_ts_number_done(p);
+        default: /* S_LITERAL */
+            if (c != p->literal[p->scratch_len]) return tc_ts_syntax_error(p);
+            (*i)++;
+            if (p->literal[++p->scratch_len] == '\0') return tc_ts_value_done(p);
+            return 0;
+    }
+}
@@ -0,0 +1,332 @@
+/**
+ * Typecast C/C++ SDK - Arena-backed voice responses
+ *
+ * A voice list used to cost one allocation per voice, model array,
+ * string array and string. Responses are now built in two passes: the
+ * first measures the source, the second fills a single block laid out as
+ *
+ *     [head][tag][items][TypecastModelInfo...][char* slots...][string blob]
+ *
+ * so parsing is one allocation and freeing is one free(). The public
+ * structs are unchanged; the tag word, the block address mixed with a
+ * magic constant, marks an arena. It is read only when the first section
+ * starts right after it, so the word lies inside the value being freed;
+ * hand-built values keep the free functions' field-by-field path.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_voice_arena.h"
+#include "cJSON.h"
+
+typedef union {
+    void* p;
+    double d;
+    long long ll;
+    size_t s;
+} ArenaAlign;
+
+#define ARENA_ALIGN sizeof(ArenaAlign)
+#define ARENA_MAGIC ((uintptr_t)0x5443564f49434541ull)
+
+static size_t align_up(size_t n) {
+    return (n + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+}
+
+static uintptr_t arena_tag(const void* block) {
+    return (uintptr_t)block ^ ARENA_MAGIC;
+}
+
+typedef struct {
+    size_t models;   /* TypecastModelInfo entries */
+    size_t strings;  /* char* slots */
+    size_t bytes;    /* string blob, terminators included */
+} ArenaSize;
+
+typedef struct {
+    char* items;
+    TypecastModelInfo* models;
+    char** strings;
+    char* blob;
+} ArenaCursor;
+
+/* One block holding a `head` of head_size, the tag, `items` entries of
+ * item_size and the sections counted in `size`. Only the blob is left
+ * uninitialised. */
+static void* arena_open(ArenaCursor* c, size_t head_size, size_t items, size_t item_size,
+    const ArenaSize* size) {
+    size_t items_at = align_up(head_size) + ARENA_ALIGN;
+    size_t models_at = align_up(items_at + items * item_size);
+    size_t strings_at = align_up(models_at + size->models * sizeof(TypecastModelInfo));
+    size_t blob_at = align_up(strings_at + size->strings * sizeof(char*));
+    char* block = (char*)malloc(blob_at + size->bytes);
+    if (!block) return NULL; /* LCOV_EXCL_LINE category=oom reason="voice arena" */
+    memset(block, 0, blob_at);
+    uintptr_t tag = arena_tag(block);
+    memcpy(block + align_up(head_size), &tag, sizeof(tag));
+    c->items = block + items_at;
+    c->models = (TypecastModelInfo*)(block + models_at);
+    c->strings = (char**)(block + strings_at);
+    c->blob = block + blob_at;
+    return block;
+}
+
+static int arena_starts_at(const void* block, size_t head_size, const void* first) {
+    const char* tag_at = (const char*)block + align_up(head_size);
+    if (first != (const void*)(tag_at + ARENA_ALIGN)) return 0;
+    uintptr_t tag;
+    memcpy(&tag, tag_at, sizeof(tag));
+    return tag == arena_tag(block);
+}
+
+static char* arena_string(ArenaCursor* c, const char* str) {
+    if (!str) return NULL;
+    size_t len = strlen(str) + 1;
+    char* dst = c->blob;
+    memcpy(dst, str, len);
+    c->blob += len;
+    return dst;
+}
+
+static char** arena_slots(ArenaCursor* c, size_t count) {
+    if (count == 0) return NULL;
+    char** slots = c->strings;
+    c->strings += count;
+    return slots;
+}
+
+static TypecastModelInfo* arena_models(ArenaCursor* c, size_t count) {
+    if (count == 0) return NULL;
+    TypecastModelInfo* models = c->models;
+    c->models += count;
+    return models;
+}
+
+/* ============================================
+ * From JSON
+ * ============================================ */
+
+static const char* json_string(const cJSON* item) {
+    return cJSON_IsString(item) ? item->valuestring : NULL;
+}
+
+static size_t string_size(const char* str) {
+    return str ? strlen(str) + 1 : 0;
+}
+
+static void measure_json_strings(const cJSON* array, ArenaSize* size) {
+    if (!cJSON_IsArray(array)) return;
+    const cJSON* item;
+    cJSON_ArrayForEach(item, array) {
+        size->strings++;
+        size->bytes += string_size(json_string(item));
+    }
+}
+
+static void measure_json_voice(const cJSON* json, ArenaSize* size) {
+    if (!cJSON_IsObject(json)) return;
+    size->bytes += string_size(json_string(cJSON_GetObjectItem(json, "voice_id")));
+    size->bytes += string_size(json_string(cJSON_GetObjectItem(json, "voice_name")));
+    const cJSON* models = cJSON_GetObjectItem(json, "models");
+    if (cJSON_IsArray(models)) {
+        const cJSON* model;
+        cJSON_ArrayForEach(model, models) {
+            size->models++;
+            if (cJSON_IsObject(model)) measure_json_strings(cJSON_GetObjectItem(model, "emotions"), size);
+        }
+    }
+    measure_json_strings(cJSON_GetObjectItem(json, "use_cases"), size);
+}
+
+static char** fill_json_strings(ArenaCursor* c, const cJSON* array, size_t* count) {
+    *count = cJSON_IsArray(array) ? (size_t)cJSON_GetArraySize(array) : 0;
+    char** slots = arena_slots(c, *count);
+    if (!slots) return NULL;
+    size_t i = 0;
+    const cJSON* item;
+    cJSON_ArrayForEach(item, array) slots[i++] = arena_string(c, json_string(item));
+    return slots;
+}
+
+/* Field order matters: the first non-NULL pointer of a single voice must
+ * land at the start of the arena (see tc_voice_is_arena) */
+static void fill_json_voice(ArenaCursor* c, TypecastVoice* voice, const cJSON* json) {
+    if (!cJSON_IsObject(json)) return;
+    voice->voice_id = arena_string(c, json_string(cJSON_GetObjectItem(json, "voice_id")));
+    voice->voice_name = arena_string(c, json_string(cJSON_GetObjectItem(json, "voice_name")));
+
+    const cJSON* gender = cJSON_GetObjectItem(json, "gender");
+    if (cJSON_IsString(gender)) voice->gender = tc_parse_gender(gender->valuestring);
+    const cJSON* age = cJSON_GetObjectItem(json, "age");
+    if (cJSON_IsString(age)) voice->age = tc_parse_age(age->valuestring);
+
+    const cJSON* models = cJSON_GetObjectItem(json, "models");
+    if (cJSON_IsArray(models)) {
+        voice->models_count = (size_t)cJSON_GetArraySize(models);
+        voice->models = arena_models(c, voice->models_count);
+        size_t i = 0;
+        const cJSON* model;
+        cJSON_ArrayForEach(model, models) {
+            TypecastModelInfo* info = &voice->models[i++];
+            if (!cJSON_IsObject(model)) continue;
+            const char* version = json_string(cJSON_GetObjectItem(model, "version"));
+            int model_idx = version ? typecast_model_from_string(version) : -1;
+            if (model_idx >= 0) info->version = (TypecastModel)model_idx;
+            info->emotions = fill_json_strings(c, cJSON_GetObjectItem(model, "emotions"), &info->emotions_count);
+        }
+    }
+    voice->use_cases = fill_json_strings(c, cJSON_GetObjectItem(json, "use_cases"), &voice->use_cases_count);
+}
+
+TypecastVoicesResponse* tc_voices_from_json(const cJSON* array) {
+    size_t count = (size_t)cJSON_GetArraySize(array);
+    ArenaSize size = {0};
+    const cJSON* item;
+    cJSON_ArrayForEach(item, array) measure_json_voice(item, &size);
+
+    ArenaCursor c;
+    TypecastVoicesResponse* resp = (TypecastVoicesResponse*)arena_open(
+        &c, sizeof(TypecastVoicesResponse), count, sizeof(TypecastVoice), &size);
+    if (!resp) return NULL; /* LCOV_EXCL_LINE category=oom reason="voice arena" */
+    resp->voices = (TypecastVoice*)c.items;
+    resp->count = count;
+    size_t i = 0;
+    cJSON_ArrayForEach(item, array) fill_json_voice(&c, &resp->voices[i++], item);
+    return resp;
+}
+
+TypecastVoice* tc_voice_from_json(const cJSON* json) {
+    if (!cJSON_IsObject(json)) return NULL;
+    ArenaSize size = {0};
+    measure_json_voice(json, &size);
+    ArenaCursor c;
+    TypecastVoice* voice = (TypecastVoice*)arena_open(&c, sizeof(TypecastVoice), 0, 0, &size);
+    if (voice) fill_json_voice(&c, voice, json);
+    return voice;
+}
+
+TypecastRecommendedVoicesResponse* tc_recommended_voices_from_json(const cJSON* array) {
+    size_t count = (size_t)cJSON_GetArraySize(array);
+    ArenaSize size = {0};
+    const cJSON* item;
+    cJSON_ArrayForEach(item, array) {
+        if (!cJSON_IsObject(item)) continue;
+        size.bytes += string_size(json_string(cJSON_GetObjectItem(item, "voice_id")));
+        size.bytes += string_size(json_string(cJSON_GetObjectItem(item, "voice_name")));
+    }
+
+    ArenaCursor c;
+    TypecastRecommendedVoicesResponse* resp = (TypecastRecommendedVoicesResponse*)arena_open(
+        &c, sizeof(TypecastRecommendedVoicesResponse), count, sizeof(TypecastRecommendedVoice), &size);
+    if (!resp) return NULL; /* LCOV_EXCL_LINE category=oom reason="voice arena" */
+    resp->voices = count > 0 ? (TypecastRecommendedVoice*)c.items : NULL;
+    resp->count = count;
+    size_t i = 0;
+    cJSON_ArrayForEach(item, array) {
+        TypecastRecommendedVoice* voice = &resp->voices[i++];
+        if (!cJSON_IsObject(item)) continue;
+        voice->voice_id = arena_string(&c, json_string(cJSON_GetObjectItem(item, "voice_id")));
+        voice->voice_name = arena_string(&c, json_string(cJSON_GetObjectItem(item, "voice_name")));
+        const cJSON* score = cJSON_GetObjectItem(item, "score");
+        if (cJSON_IsNumber(score)) voice->score = score->valuedouble;
+    }
+    return resp;
+}
+
+/* ============================================
+ * Copies
+ * ============================================ */
+
+static void measure_strings(char* const* strings, size_t count, ArenaSize* size) {
+    if (!strings) return;
+    size->strings += count;
+    for (size_t i = 0; i < count; i++) size->bytes += string_size(strings[i]);
+}
+
+static void measure_voice(const TypecastVoice* voice, ArenaSize* size) {
+    size->bytes += string_size(voice->voice_id) + string_size(voice->voice_name);
+    if (voice->models) {
+        size->models += voice->models_count;
+        for (size_t i = 0; i < voice->models_count; i++) {
+            measure_strings(voice->models[i].emotions, voice->models[i].emotions_count, size);
+        }
+    }
+    measure_strings(voice->use_cases, voice->use_cases_count, size);
+}
+
+static char** fill_strings(ArenaCursor* c, char* const* src, size_t src_count, size_t* count) {
+    *count = src ? src_count : 0;
+    char** slots = arena_slots(c, *count);
+    for (size_t i = 0; i < *count; i++) slots[i] = arena_string(c, src[i]);
+    return slots;
+}
+
+static void fill_voice(ArenaCursor* c, TypecastVoice* dst, const TypecastVoice* src) {
+    dst->voice_id = arena_string(c, src->voice_id);
+    dst->voice_name = arena_string(c, src->voice_name);
+    dst->gender = src->gender;
+    dst->age = src->age;
+    dst->models_count = src->models ? src->models_count : 0;
+    dst->models = arena_models(c, dst->models_count);
+    for (size_t i = 0; i < dst->models_count; i++) {
+        const TypecastModelInfo* info = &src->models[i];
+        dst->models[i].version = info->version;
+        dst->models[i].emotions = fill_strings(c, info->emotions, info->emotions_count,
+            &dst->models[i].emotions_count);
+    }
+    dst->use_cases = fill_strings(c, src->use_cases, src->use_cases_count, &dst->use_cases_count);
+}
+
+TypecastVoicesResponse* tc_voices_copy(const TypecastVoicesResponse* src) {
+    size_t count = src->voices ? src->count : 0;
+    ArenaSize size = {0};
+    for (size_t i = 0; i < count; i++) measure_voice(&src->voices[i], &size);
+
+    ArenaCursor c;
+    TypecastVoicesResponse* dst = (TypecastVoicesResponse*)arena_open(
+        &c, sizeof(TypecastVoicesResponse), count, sizeof(TypecastVoice), &size);
+    if (!dst) return NULL; /* LCOV_EXCL_LINE category=oom reason="voice arena" */
+    dst->voices = (TypecastVoice*)c.items;
+    dst->count = count;
+    for (size_t i = 0; i < count; i++) fill_voice(&c, &dst->voices[i], &src->voices[i]);
+    return dst;
+}
+
+TypecastVoice* tc_voice_copy(const TypecastVoice* src) {
+    ArenaSize size = {0};
+    measure_voice(src, &size);
+    ArenaCursor c;
+    TypecastVoice* dst = (TypecastVoice*)arena_open(&c, sizeof(TypecastVoice), 0, 0, &size);
+    if (dst) fill_voice(&c, dst, src);
+    return dst;
+}
+
+/* ============================================
+ * Ownership
+ * ============================================ */
+
+int tc_voices_response_is_arena(const TypecastVoicesResponse* response) {
+    return response->voices && arena_starts_at(response, sizeof(*response), response->voices);
+}
+
+int tc_recommended_voices_is_arena(const TypecastRecommendedVoicesResponse* response) {
+    return response->voices && arena_starts_at(response, sizeof(*response), response->voices);
+}
+
+/* The first pointer in arena order (models, string slots, blob) */
+int tc_voice_is_arena(const TypecastVoice* voice) {
+    const void* first = voice->models ? (const void*)voice->models
+        : voice->use_cases ? (const void*)voice->use_cases
+        : voice->voice_id ? (const void*)voice->voice_id
+        : (const void*)voice->voice_name;
+    return first && arena_starts_at(voice, sizeof(*voice), first);
+}
@@ -0,0 +1,32 @@
+/**
+ * Typecast C/C++ SDK - Arena-backed voice responses (typecast_voice_arena.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_VOICE_ARENA_H
+#define TYPECAST_VOICE_ARENA_H
+
+#include "typecast_internal.h"
+
+struct cJSON;
+
+/* Parsed in typecast.c, shared with the arena builders */
+TypecastGender tc_parse_gender(const char* str);
+TypecastAge tc_parse_age(const char* str);
+
+/* Each result is a single allocation that free() releases in full; NULL
+ * on allocation failure (or, for a voice, when `json` is no object).
+ * Non-object array items yield zeroed entries. */
+TypecastVoicesResponse* tc_voices_from_json(const struct cJSON* array);
+TypecastVoice* tc_voice_from_json(const struct cJSON* json);
+TypecastRecommendedVoicesResponse* tc_recommended_voices_from_json(const struct cJSON* array);
+TypecastVoicesResponse* tc_voices_copy(const TypecastVoicesResponse* src);
+TypecastVoice* tc_voice_copy(const TypecastVoice* src);
+/* Whether a value was built by the functions above (nothing to free but
+ * the value itself) */
+int tc_voices_response_is_arena(const TypecastVoicesResponse* response);
+int tc_recommended_voices_is_arena(const TypecastRecommendedVoicesResponse* response);
+int tc_voice_is_arena(const TypecastVoice* voice);
+
+#endif /* TYPECAST_VOICE_ARENA_H */
@@ -0,0 +1,345 @@
+/**
+ * Typecast C/C++ SDK - Voice catalog cache
+ *
+ * Voice metadata changes rarely but is looked up on every job, so clients
+ * created with a voice_cache_ttl_secs keep the responses of the voices
+ * endpoints. Within the TTL a response is served from memory (lists and
+ * single voices as parsed copies, so nothing is re-parsed). Past the TTL
+ * the entry is revalidated with If-None-Match when the server sent an
+ * ETag; a 304 only refreshes the timestamp. With voice_cache_path the
+ * entries are also written to a JSON file and loaded again by the next
+ * client, so cold starts do not need the network.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_voice_arena.h"
+#include "typecast_voice_cache.h"
+#include "cJSON.h"
+
+#define CACHE_FILE_VERSION 1
+
+typedef struct TcVoiceCacheEntry {
+    char* key;                       /* request path and query */
+    char* etag;                      /* NULL when the server sent none */
+    char* body;
+    size_t body_len;
+    time_t fetched_at;
+    TypecastVoicesResponse* voices;  /* parsed copy, NULL until attached */
+    struct TcVoiceCacheEntry* next;
+} TcVoiceCacheEntry;
+
+struct TcVoiceCache {
+    tc_mutex_t lock;
+    unsigned long ttl;
+    char* path;
+    char owner[17];                  /* hash of host and API key, in hex */
+    TcVoiceCacheEntry* entries;
+};
+
+static char* dup_bytes(const char* data, size_t len) {
+    char* copy = (char*)malloc(len + 1);
+    if (!copy) return NULL; /* LCOV_EXCL_LINE category=oom reason="cache string copy" */
+    memcpy(copy, data, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+static char* dup_string(const char* str) {
+    return str ? dup_bytes(str, strlen(str)) : NULL;
+}
+
+/* ============================================
+ * Entries
+ * ============================================ */
+
+static void entry_free(TcVoiceCacheEntry* entry) {
+    free(entry->key);
+    free(entry->etag);
+    free(entry->body);
+    typecast_voices_response_free(entry->voices);
+    free(entry);
+}
+
+static TcVoiceCacheEntry* find_entry(TcVoiceCache* cache, const char* key) {
+    for (TcVoiceCacheEntry* e = cache->entries; e; e = e->next) {
+        if (strcmp(e->key, key) == 0) return e;
+    }
+    return NULL;
+}
+
+static int entry_fresh(const TcVoiceCache* cache, const TcVoiceCacheEntry* entry, time_t now) {
+    return now >= entry->fetched_at && (unsigned long)(now - entry->fetched_at) < cache->ttl;
+}
+
+/* Replace (or add) the entry for `key`; takes ownership of nothing */
+static TcVoiceCacheEntry* put_entry(TcVoiceCache* cache, const char* key, const char* etag,
+    const char* body, size_t body_len, time_t fetched_at) {
+    TcVoiceCacheEntry* entry = (TcVoiceCacheEntry*)calloc(1, sizeof(*entry));
+    if (!entry) return NULL; /* LCOV_EXCL_LINE category=oom reason="cache entry" */
+    entry->key = dup_string(key);
+    entry->etag = dup_string(etag);
+    entry->body = dup_bytes(body, body_len);
+    entry->body_len = body_len;
+    entry->fetched_at = fetched_at;
+    /* LCOV_EXCL_START */
+    /* category=oom reason="cache entry strings" */
+    if (!entry->key || !entry->body || (etag && !entry->etag)) {
+        entry_free(entry);
+        return NULL;
+    }
+    /* LCOV_EXCL_STOP */
+
+    TcVoiceCacheEntry** link = &cache->entries;
+    while (*link && strcmp((*link)->key, key) != 0) link = &(*link)->next;
+    if (*link) {
+        TcVoiceCacheEntry* old = *link;
+        entry->next = old->next;
+        entry_free(old);
+    }
+    *link = entry;
+    return entry;
+}
+
+/* Copy the entry's response out: a parsed copy when one is attached and
+ * wanted, otherwise the raw body */
+static TcVoiceCacheResult serve(const TcVoiceCacheEntry* entry, ResponseBuffer* body,
+    TypecastVoicesResponse** voices) {
+    if (voices && entry->voices) {
+        *voices = tc_voices_copy(entry->voices);
+        if (*voices) return TC_VOICE_CACHE_HIT;
+    }
+    body->data = (uint8_t*)dup_bytes(entry->body, entry->body_len);
+    if (!body->data) return TC_VOICE_CACHE_MISS; /* LCOV_EXCL_LINE category=oom reason="cached body copy" */
+    body->size = entry->body_len;
+    body->capacity = entry->body_len + 1;
+    return TC_VOICE_CACHE_HIT;
+}
+
+/* ============================================
+ * Persistence
+ * ============================================ */
+
+/* Written under the cache lock. A failed write only loses persistence. */
+static void save_file(const TcVoiceCache* cache) {
+    if (!cache->path) return;
+    cJSON* root = cJSON_CreateObject();
+    cJSON* entries = cJSON_CreateArray();
+    if (!root || !entries) {
+        /* LCOV_EXCL_START */
+        /* category=oom reason="cJSON allocation of the cache file" */
+        cJSON_Delete(root);
+        cJSON_Delete(entries);
+        return;
+        /* LCOV_EXCL_STOP */
+    }
+    cJSON_AddNumberToObject(root, "version", CACHE_FILE_VERSION);
+    cJSON_AddStringToObject(root, "owner", cache->owner);
+    cJSON_AddItemToObject(root, "entries", entries);
+    for (const TcVoiceCacheEntry* e = cache->entries; e; e = e->next) {
+        cJSON* item = cJSON_CreateObject();
+        if (!item) continue; /* LCOV_EXCL_LINE category=oom reason="cJSON allocation of the cache file" */
+        cJSON_AddStringToObject(item, "key", e->key);
+        if (e->etag) cJSON_AddStringToObject(item, "etag", e->etag);
+        cJSON_AddNumberToObject(item, "fetched_at", (double)e->fetched_at);
+        cJSON_AddStringToObject(item, "body", e->body);
+        cJSON_AddItemToArray(entries, item);
+    }
+    char* text = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (!text) return; /* LCOV_EXCL_LINE category=oom reason="cJSON print of the cache file" */
+
+    /* Write next to the destination and rename, so readers never see a
+     * partial file */
+    size_t path_len = strlen(cache->path);
+    char* temp = (char*)malloc(path_len + 5);
+    if (temp) {
+        memcpy(temp, cache->path, path_len);
+        memcpy(temp + path_len, ".tmp", 5);
+        FILE* file = fopen(temp, "wb");
+        if (file) {
+            size_t len = strlen(text);
+            int ok = fwrite(text, 1, len, file) == len;
+            ok = fclose(file) == 0 && ok;
+#if defined(_WIN32) || defined(_WIN64)
+            if (ok) remove(cache->path);
+#endif
+            if (!ok || rename(temp, cache->path) != 0) remove(temp);
+        }
+        free(temp);
+    }
+    cJSON_free(text);
+}
+
+static void load_file(TcVoiceCache* cache) {
+    FILE* file = fopen(cache->path, "rb");
+    if (!file) return;
+    ResponseBuffer buf = {0};
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        if (tc_response_write(chunk, 1, n, &buf) != n) break; /* LCOV_EXCL_LINE category=oom reason="cache file buffer" */
+    }
+    fclose(file);
+    cJSON* root = buf.data ? cJSON_Parse((const char*)buf.data) : NULL;
+    free(buf.data);
+    if (!root) return;
+
+    /* Files written for another account or host are ignored */
+    cJSON* version = cJSON_GetObjectItem(root, "version");
+    cJSON* owner = cJSON_GetObjectItem(root, "owner");
+    cJSON* entries = cJSON_GetObjectItem(root, "entries");
+    if (cJSON_IsNumber(version) && version->valueint == CACHE_FILE_VERSION &&
+        cJSON_IsString(owner) && strcmp(owner->valuestring, cache->owner) == 0 &&
+        cJSON_IsArray(entries)) {
+        cJSON* item = NULL;
+        cJSON_ArrayForEach(item, entries) {
+            cJSON* key = cJSON_GetObjectItem(item, "key");
+            cJSON* etag = cJSON_GetObjectItem(item, "etag");
+            cJSON* fetched_at = cJSON_GetObjectItem(item, "fetched_at");
+            cJSON* body = cJSON_GetObjectItem(item, "body");
+            if (!cJSON_IsString(key) || !cJSON_IsString(body) || !cJSON_IsNumber(fetched_at)) continue;
+            put_entry(cache, key->valuestring, cJSON_IsString(etag) ? etag->valuestring : NULL,
+                body->valuestring, strlen(body->valuestring), (time_t)fetched_at->valuedouble);
+        }
+    }
+    cJSON_Delete(root);
+}
+
+/* ============================================
+ * Internal API
+ * ============================================ */
+
+static void hash_string(uint64_t* hash, const char* str) {
+    for (const unsigned char* p = (const unsigned char*)str; *p; p++) {
+        *hash ^= *p;
+        *hash *= 1099511628211ULL;   /* FNV-1a */
+    }
+    *hash ^= 0xFF;                    /* separator, so ("ab","c") != ("a","bc") */
+    *hash *= 1099511628211ULL;
+}
+
+TcVoiceCache* tc_voice_cache_new(const TypecastClientOptions* options, const char* host, const char* api_key) {
+    if (!options || options->voice_cache_ttl_secs == 0) return NULL;
+    TcVoiceCache* cache = (TcVoiceCache*)calloc(1, sizeof(*cache));
+    if (!cache) return NULL; /* LCOV_EXCL_LINE category=oom reason="cache allocation" */
+    tc_mutex_init(&cache->lock);
+    cache->ttl = options->voice_cache_ttl_secs;
+
+    /* The API key itself never goes to disk */
+    uint64_t hash = 14695981039346656037ULL;
+    hash_string(&hash, host);
+    hash_string(&hash, api_key);
+    snprintf(cache->owner, sizeof(cache->owner), "%016llx", (unsigned long long)hash);
+
+    if (!tc_is_blank_string(options->voice_cache_path)) {
+        cache->path = dup_string(options->voice_cache_path);
+        if (cache->path) load_file(cache);
+    }
+    return cache;
+}
+
+void tc_voice_cache_free(TcVoiceCache* cache) {
+    if (!cache) return;
+    while (cache->entries) {
+        TcVoiceCacheEntry* entry = cache->entries;
+        cache->entries = entry->next;
+        entry_free(entry);
+    }
+    free(cache->path);
+    tc_mutex_destroy(&cache->lock);
+    free(cache);
+}
+
+void tc_voice_cache_clear(TcVoiceCache* cache) {
+    if (!cache) return;
+    tc_mutex_lock(&cache->lock);
+    while (cache->entries) {
+        TcVoiceCacheEntry* entry = cache->entries;
+        cache->entries = entry->next;
+        entry_free(entry);
+    }
+    if (cache->path) remove(cache->path);
+    tc_mutex_unlock(&cache->lock);
+}
+
+TcVoiceCacheResult tc_voice_cache_lookup(TcVoiceCache* cache, const char* key,
+    ResponseBuffer* body, TypecastVoicesResponse** voices, char** etag) {
+    TcVoiceCacheResult result = TC_VOICE_CACHE_MISS;
+    *etag = NULL;
+    tc_mutex_lock(&cache->lock);
+    TcVoiceCacheEntry* entry = find_entry(cache, key);
+    if (entry && entry_fresh(cache, entry, time(NULL))) {
+        result = serve(entry, body, voices);
+    } else if (entry && entry->etag) {
+        *etag = dup_string(entry->etag);
+        if (*etag) result = TC_VOICE_CACHE_STALE;
+    }
+    tc_mutex_unlock(&cache->lock);
+    return result;
+}
+
+void tc_voice_cache_store(TcVoiceCache* cache, const char* key, const char* etag,
+    const ResponseBuffer* body) {
+    tc_mutex_lock(&cache->lock);
+    if (put_entry(cache, key, etag, (const char*)body->data, body->size, time(NULL))) save_file(cache);
+    tc_mutex_unlock(&cache->lock);
+}
+
+TcVoiceCacheResult tc_voice_cache_revalidated(TcVoiceCache* cache, const char* key,
+    ResponseBuffer* body, TypecastVoicesResponse** voices) {
+    TcVoiceCacheResult result = TC_VOICE_CACHE_MISS;
+    tc_mutex_lock(&cache->lock);
+    TcVoiceCacheEntry* entry = find_entry(cache, key);
+    if (entry) {
+        entry->fetched_at = time(NULL);
+        save_file(cache);
+        result = serve(entry, body, voices);
+    }
+    tc_mutex_unlock(&cache->lock);
+    return result;
+}
+
+void tc_voice_cache_attach(TcVoiceCache* cache, const char* key, const TypecastVoicesResponse* voices) {
+    tc_mutex_lock(&cache->lock);
+    TcVoiceCacheEntry* entry = find_entry(cache, key);
+    if (entry && !entry->voices) entry->voices = tc_voices_copy(voices);
+    tc_mutex_unlock(&cache->lock);
+}
+
+TypecastVoice* tc_voice_cache_find_voice(TcVoiceCache* cache, const char* voice_id) {
+    TypecastVoice* found = NULL;
+    time_t now = time(NULL);
+    tc_mutex_lock(&cache->lock);
+    for (TcVoiceCacheEntry* e = cache->entries; e && !found; e = e->next) {
+        if (!e->voices || !entry_fresh(cache, e, now)) continue;
+        for (size_t i = 0; i < e->voices->count; i++) {
+            const TypecastVoice* voice = &e->voices->voices[i];
+            if (voice->voice_id && strcmp(voice->voice_id, voice_id) == 0) {
+                found = tc_voice_copy(voice);
+                break;
+            }
+        }
+    }
+    tc_mutex_unlock(&cache->lock);
+    return found;
+}
+
+/* ============================================
+ * Public API
+ * ============================================ */
+
+TYPECAST_API void typecast_voice_cache_clear(TypecastClient* client) {
+    if (client) tc_voice_cache_clear(client->voice_cache);
+}
@@ -0,0 +1,41 @@
+/**
+ * Typecast C/C++ SDK - Voice cache (typecast_voice_cache.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_VOICE_CACHE_H
+#define TYPECAST_VOICE_CACHE_H
+
+#include "typecast_internal.h"
+
+typedef enum {
+    TC_VOICE_CACHE_MISS,
+    TC_VOICE_CACHE_STALE,            /* expired; revalidate with the ETag */
+    TC_VOICE_CACHE_HIT
+} TcVoiceCacheResult;
+
+/* NULL when options disable the cache. host and api_key identify the
+ * owner of a persisted file. */
+TcVoiceCache* tc_voice_cache_new(const TypecastClientOptions* options, const char* host, const char* api_key);
+void tc_voice_cache_free(TcVoiceCache* cache);
+/* Drop every entry and the persisted file (NULL cache is a no-op) */
+void tc_voice_cache_clear(TcVoiceCache* cache);
+/* On a hit, *voices receives a parsed copy when `voices` is non-NULL and
+ * one is attached; otherwise `body` receives a copy of the raw response.
+ * On STALE, *etag is a copy of the entry's ETag (caller frees). */
+TcVoiceCacheResult tc_voice_cache_lookup(TcVoiceCache* cache, const char* key,
+    ResponseBuffer* body, TypecastVoicesResponse** voices, char** etag);
+/* Remember a 200 response */
+void tc_voice_cache_store(TcVoiceCache* cache, const char* key, const char* etag,
+    const ResponseBuffer* body);
+/* After a 304: restart the TTL and serve the entry like a hit. MISS if
+ * the entry was cleared meanwhile. */
+TcVoiceCacheResult tc_voice_cache_revalidated(TcVoiceCache* cache, const char* key,
+    ResponseBuffer* body, TypecastVoicesResponse** voices);
+/* Keep a parsed copy of the entry's response for later hits */
+void tc_voice_cache_attach(TcVoiceCache* cache, const char* key, const TypecastVoicesResponse* voices);
+/* Copy of a voice found in a fresh cached list, or NULL */
+TypecastVoice* tc_voice_cache_find_voice(TcVoiceCache* cache, const char* voice_id);
+
+#endif /* TYPECAST_VOICE_CACHE_H */
@@ -0,0 +1,185 @@
+/**
+ * Typecast C/C++ SDK - WAV parsing and stitching
+ *
+ * Just enough RIFF/WAVE handling to join independently rendered segments
+ * into one file: locate the fmt and data chunks, check that segments share
+ * a sample format, and insert silence for pauses.
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_BUILDING_DLL
+#define TYPECAST_BUILDING_DLL
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "typecast_internal.h"
+#include "typecast_alloc.h"
+#include "typecast_wav.h"
+
+#define WAV_HEADER_SIZE TC_WAV_HEADER_SIZE
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+static uint16_t read_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void write_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void write_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)((v >> 8) & 0xFF);
+    p[2] = (uint8_t)((v >> 16) & 0xFF);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+int tc_wav_parse(const uint8_t* audio, size_t size, TcWavInfo* out) {
+    if (!audio || !out || size < 12) return 0;
+    if (memcmp(audio, "RIFF", 4) != 0 || memcmp(audio + 8, "WAVE", 4) != 0) return 0;
+    memset(out, 0, sizeof(*out));
+
+    int have_fmt = 0;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* chunk = audio + pos;
+        size_t chunk_size = read_u32(chunk + 4);
+        size_t body = pos + 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunk_size < 16 || body + 16 > size) return 0;
+            out->format_tag = read_u16(audio + body);
+            out->channels = read_u16(audio + body + 2);
+            out->sample_rate = read_u32(audio + body + 4);
+            out->block_align = read_u16(audio + body + 12);
+            out->bits_per_sample = read_u16(audio + body + 14);
+            /* WAVE_FORMAT_EXTENSIBLE keeps the real format code at the
+             * start of the SubFormat GUID */
+            if (out->format_tag == WAV_FORMAT_EXTENSIBLE && chunk_size >= 40 && body + 26 <= size) {
+                out->format_tag = read_u16(audio + body + 24);
+            }
+            have_fmt = 1;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt || out->block_align == 0 || out->sample_rate == 0) return 0;
+            /* Streamed WAVs may carry a placeholder size; trust the buffer */
+            size_t available = size - body;
+            size_t data_size = chunk_size < available ? chunk_size : available;
+            out->data = audio + body;
+            out->data_size = data_size - (data_size % out->block_align);
+            return 1;
+        }
+        if (chunk_size >= size - body) break;
+        pos = body + chunk_size + (chunk_size & 1);
+    }
+    return 0;
+}
+
+int tc_wav_same_format(const TcWavInfo* a, const TcWavInfo* b) {
+    return a->format_tag == b->format_tag && a->channels == b->channels &&
+           a->sample_rate == b->sample_rate && a->block_align == b->block_align &&
+           a->bits_per_sample == b->bits_per_sample;
+}
+
+void tc_wav_write_header(uint8_t* out, const TcWavInfo* format, uint32_t data_size) {
+    uint32_t riff_size = data_size > 0xFFFFFFFFu - (WAV_HEADER_SIZE - 8)
+        ? 0xFFFFFFFFu : data_size + (WAV_HEADER_SIZE - 8);
+    memcpy(out, "RIFF", 4);
+    write_u32(out + 4, riff_size);
+    memcpy(out + 8, "WAVEfmt ", 8);
+    write_u32(out + 16, 16);
+    write_u16(out + 20, format->format_tag);
+    write_u16(out + 22, format->channels);
+    write_u32(out + 24, format->sample_rate);
+    write_u32(out + 28, format->sample_rate * format->block_align);
+    write_u16(out + 32, format->block_align);
+    write_u16(out + 34, format->bits_per_sample);
+    memcpy(out + 36, "data", 4);
+    write_u32(out + 40, data_size);
+}
+
+static size_t silence_bytes(const TcWavInfo* format, float seconds) {
+    if (!isfinite(seconds) || seconds <= 0.0f) return 0;
+    size_t frames = (size_t)((double)seconds * format->sample_rate + 0.5);
+    return frames * format->block_align;
+}
+
+TypecastTTSResponse* tc_wav_stitch(const TcWavPiece* pieces, size_t count,
+    const TypecastAllocator* allocator, TypecastError* error) {
+    TcWavInfo format;
+    int have_format = 0;
+    size_t total = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!pieces[i].audio) continue;
+        TcWavInfo info;
+        if (!tc_wav_parse(pieces[i].audio, pieces[i].audio_size, &info)) {
+            tc_error_set(error, TYPECAST_ERROR_JSON_PARSE, "Segment audio is not a WAV file");
+            return NULL;
+        }
+        if (!have_format) {
+            format = info;
+            have_format = 1;
+        } else if (!tc_wav_same_format(&format, &info)) {
+            tc_error_set(error, TYPECAST_ERROR_JSON_PARSE, "Segment audio formats differ");
+            return NULL;
+        }
+        total += info.data_size;
+    }
+    if (!have_format) {
+        tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, "At least one speech segment is required");
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!pieces[i].audio) total += silence_bytes(&format, pieces[i].pause_seconds);
+    }
+    if (total > 0xFFFFFFFFu - (WAV_HEADER_SIZE - 8) || total > (size_t)-1 - WAV_HEADER_SIZE) {
+        tc_error_set(error, TYPECAST_ERROR_INVALID_PARAM, "Stitched audio exceeds the 4 GiB WAV limit");
+        return NULL;
+    }
+
+    TypecastTTSResponse* response = tc_tts_response_new(allocator);
+    uint8_t* out = (uint8_t*)tc_mem_alloc(allocator, WAV_HEADER_SIZE + total);
+    /* LCOV_EXCL_START */
+    /* category=oom reason="allocation of the stitched response" */
+    if (!response || !out) {
+        typecast_tts_response_free(response);
+        tc_mem_free(allocator, out);
+        tc_error_set(error, TYPECAST_ERROR_OUT_OF_MEMORY, "Failed to allocate stitched audio");
+        return NULL;
+    }
+    /* LCOV_EXCL_STOP */
+
+    tc_wav_write_header(out, &format, (uint32_t)total);
+
+    /* 8-bit PCM is unsigned, so its silence is the midpoint */
+    int silence = (format.format_tag == 1 && format.bits_per_sample == 8) ? 0x80 : 0;
+    uint8_t* cursor = out + WAV_HEADER_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        if (pieces[i].audio) {
+            TcWavInfo info;
+            tc_wav_parse(pieces[i].audio, pieces[i].audio_size, &info);
+            memcpy(cursor, info.data, info.data_size);
+            cursor += info.data_size;
+        } else {
+            size_t n = silence_bytes(&format, pieces[i].pause_seconds);
+            memset(cursor, silence, n);
+            cursor += n;
+        }
+    }
+
+    response->audio_data = out;
+    response->audio_size = WAV_HEADER_SIZE + total;
+    response->duration = (float)((double)(total / format.block_align) / format.sample_rate);
+    response->format = TYPECAST_AUDIO_FORMAT_WAV;
+    return response;
+}
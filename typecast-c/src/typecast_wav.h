@@ -0,0 +1,43 @@
+/**
+ * Typecast C/C++ SDK - WAV (typecast_wav.c)
+ *
+ * Copyright (c) 2025 Typecast
+ */
+
+#ifndef TYPECAST_WAV_H
+#define TYPECAST_WAV_H
+
+#include "typecast_internal.h"
+
+typedef struct {
+    uint16_t format_tag;             /* 1 = PCM, 3 = IEEE float */
+    uint16_t channels;
+    uint32_t sample_rate;
+    uint16_t block_align;
+    uint16_t bits_per_sample;
+    const uint8_t* data;             /* points into the parsed buffer */
+    size_t data_size;                /* clamped to the bytes actually present */
+} TcWavInfo;
+
+/* One stitched piece: WAV audio, or `pause_seconds` of silence when
+ * `audio` is NULL */
+typedef struct {
+    const uint8_t* audio;
+    size_t audio_size;
+    float pause_seconds;
+} TcWavPiece;
+
+int tc_wav_parse(const uint8_t* audio, size_t size, TcWavInfo* out);
+int tc_wav_same_format(const TcWavInfo* a, const TcWavInfo* b);
+
+#define TC_WAV_HEADER_SIZE 44
+/* Canonical 44-byte header for `format`. A streamed WAV whose length is
+ * not known yet passes 0xFFFFFFFF as data_size. */
+void tc_wav_write_header(uint8_t* out, const TcWavInfo* format, uint32_t data_size);
+
+/* Concatenate the pieces into one WAV. Every audio piece must share the
+ * sample format of the first one. */
+TypecastTTSResponse* tc_wav_stitch(const TcWavPiece* pieces, size_t count,
+    const TypecastAllocator* allocator, TypecastError* error);
+
+#endif /* TYPECAST_WAV_H */
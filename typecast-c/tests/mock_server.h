@@ -0,0 +1,342 @@
+/**
+ * Concurrent HTTP/1.1 mock server for tests and benchmarks.
+ *
+ * Unlike the single-connection servers embedded in the older test files,
+ * this one serves every connection on its own thread and honours
+ * keep-alive, so it can observe how many requests a client keeps in
+ * flight and whether connections are reused. Responses come from a
+ * handler callback; header-only, no dependencies beyond POSIX sockets.
+ */
+
+#ifndef TYPECAST_TESTS_MOCK_SERVER_H
+#define TYPECAST_TESTS_MOCK_SERVER_H
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MOCK_MAX_CONNECTIONS 256
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+typedef struct {
+    char method[16];
+    char path[1024];
+    char headers[8192];
+    char* body;          /* NUL-terminated, valid during the handler call */
+    size_t body_len;
+    int connection_id;   /* 1-based index of the connection it arrived on */
+} MockRequest;
+
+typedef struct {
+    int status;
+    char headers[1024];  /* extra header lines, each ending in \r\n */
+    const uint8_t* body;
+    size_t body_len;
+    int delay_ms;        /* sleep before sending the response */
+    int close;           /* send Connection: close and drop the connection */
+    int chunk_size;      /* >0: send the body with chunked encoding */
+    int chunk_delay_ms;  /* pause between chunks */
+} MockResponse;
+
+typedef void (*mock_handler_t)(const MockRequest* request, MockResponse* response, void* user_data);
+
+typedef struct {
+    int listen_fd;
+    int port;
+    pthread_t thread;
+    volatile int stopping;
+    mock_handler_t handler;
+    void* user_data;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int active;          /* requests currently being handled */
+    int max_active;
+    int requests;
+    int connections;
+    int open_threads;
+    int fds[MOCK_MAX_CONNECTIONS];
+
+    /* Hold every response until `hold_until` requests are in flight at once
+     * (or `hold_ms` elapsed). Used to prove concurrency. */
+    int hold_until;
+    int hold_ms;
+} MockServer;
+
+typedef struct {
+    MockServer* server;
+    int fd;
+    int id;
+} MockConnection;
+
+static void mock_sleep_ms(int ms) {
+    if (ms <= 0) return;
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+static int mock_send_all(int fd, const void* data, size_t len) {
+    const char* p = (const char*)data;
+    while (len > 0) {
+        ssize_t sent = send(fd, p, len, MSG_NOSIGNAL);
+        if (sent <= 0) return 0;
+        p += sent;
+        len -= (size_t)sent;
+    }
+    return 1;
+}
+
+static const char* mock_find_header(const char* headers, const char* name) {
+    size_t name_len = strlen(name);
+    for (const char* p = headers; *p; p++) {
+        if ((p == headers || p[-1] == '\n') && strncasecmp(p, name, name_len) == 0 && p[name_len] == ':') {
+            p += name_len + 1;
+            while (*p == ' ') p++;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/* Read one request into buf. Returns total bytes consumed, 0 on EOF. */
+static size_t mock_read_request(int fd, char** buf, size_t* cap, size_t* used, MockRequest* req) {
+    for (;;) {
+        char* header_end = NULL;
+        if (*used > 0) {
+            (*buf)[*used] = '\0';
+            header_end = strstr(*buf, "\r\n\r\n");
+        }
+        if (header_end) {
+            size_t header_len = (size_t)(header_end + 4 - *buf);
+            size_t content_length = 0;
+            char saved = header_end[2];
+            header_end[2] = '\0';
+            const char* cl = mock_find_header(*buf, "Content-Length");
+            if (cl) content_length = (size_t)strtoul(cl, NULL, 10);
+            header_end[2] = saved;
+            if (*used >= header_len + content_length) {
+                memset(req, 0, sizeof(*req));
+                sscanf(*buf, "%15s %1023s", req->method, req->path);
+                size_t hl = header_len < sizeof(req->headers) ? header_len : sizeof(req->headers) - 1;
+                memcpy(req->headers, *buf, hl);
+                req->headers[hl] = '\0';
+                req->body = (char*)malloc(content_length + 1);
+                if (req->body) {
+                    memcpy(req->body, *buf + header_len, content_length);
+                    req->body[content_length] = '\0';
+                }
+                req->body_len = content_length;
+                return header_len + content_length;
+            }
+        }
+        if (*used + 4096 + 1 > *cap) {
+            size_t next = *cap * 2 + 8192;
+            char* grown = (char*)realloc(*buf, next);
+            if (!grown) return 0;
+            *buf = grown;
+            *cap = next;
+        }
+        ssize_t received = recv(fd, *buf + *used, *cap - *used - 1, 0);
+        if (received <= 0) return 0;
+        *used += (size_t)received;
+    }
+}
+
+static void mock_send_response(int fd, const MockResponse* resp) {
+    char header[2048];
+    int len;
+    if (resp->chunk_size > 0) {
+        len = snprintf(header, sizeof(header),
+            "HTTP/1.1 %d Mock\r\n%sTransfer-Encoding: chunked\r\n%s\r\n",
+            resp->status, resp->headers, resp->close ? "Connection: close\r\n" : "");
+    } else {
+        len = snprintf(header, sizeof(header),
+            "HTTP/1.1 %d Mock\r\n%sContent-Length: %zu\r\n%s\r\n",
+            resp->status, resp->headers, resp->body_len, resp->close ? "Connection: close\r\n" : "");
+    }
+    if (!mock_send_all(fd, header, (size_t)len)) return;
+    if (resp->chunk_size <= 0) {
+        if (resp->body_len) mock_send_all(fd, resp->body, resp->body_len);
+        return;
+    }
+    size_t off = 0;
+    while (off < resp->body_len) {
+        size_t n = resp->body_len - off;
+        if (n > (size_t)resp->chunk_size) n = (size_t)resp->chunk_size;
+        char size_line[32];
+        int sl = snprintf(size_line, sizeof(size_line), "%zx\r\n", n);
+        if (!mock_send_all(fd, size_line, (size_t)sl)) return;
+        if (!mock_send_all(fd, resp->body + off, n)) return;
+        if (!mock_send_all(fd, "\r\n", 2)) return;
+        off += n;
+        if (off < resp->body_len) mock_sleep_ms(resp->chunk_delay_ms);
+    }
+    mock_send_all(fd, "0\r\n\r\n", 5);
+}
+
+static void mock_hold(MockServer* server) {
+    pthread_mutex_lock(&server->lock);
+    server->active++;
+    server->requests++;
+    if (server->active > server->max_active) server->max_active = server->active;
+    if (server->hold_until > 0 && server->active >= server->hold_until) server->hold_until = 0;
+    pthread_cond_broadcast(&server->cond);
+    if (server->hold_until > 0) {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+        struct timespec deadline;
+        long ms = server->hold_ms > 0 ? server->hold_ms : 2000;
+        deadline.tv_sec = now.tv_sec + ms / 1000;
+        deadline.tv_nsec = (long)now.tv_usec * 1000L + (ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (server->hold_until > 0 && !server->stopping) {
+            if (pthread_cond_timedwait(&server->cond, &server->lock, &deadline) == ETIMEDOUT) break;
+        }
+    }
+    pthread_mutex_unlock(&server->lock);
+}
+
+static void mock_release(MockServer* server) {
+    pthread_mutex_lock(&server->lock);
+    server->active--;
+    pthread_mutex_unlock(&server->lock);
+}
+
+static void* mock_connection_thread(void* arg) {
+    MockConnection* conn = (MockConnection*)arg;
+    MockServer* server = conn->server;
+    size_t cap = 16384, used = 0;
+    char* buf = (char*)malloc(cap);
+    while (buf) {
+        MockRequest req;
+        size_t consumed = mock_read_request(conn->fd, &buf, &cap, &used, &req);
+        if (consumed == 0) break;
+        req.connection_id = conn->id;
+        memmove(buf, buf + consumed, used - consumed);
+        used -= consumed;
+
+        mock_hold(server);
+        MockResponse resp;
+        memset(&resp, 0, sizeof(resp));
+        resp.status = 200;
+        server->handler(&req, &resp, server->user_data);
+        mock_sleep_ms(resp.delay_ms);
+        mock_send_response(conn->fd, &resp);
+        mock_release(server);
+        free(req.body);
+        if (resp.close) break;
+    }
+    free(buf);
+    close(conn->fd);
+    pthread_mutex_lock(&server->lock);
+    server->fds[conn->id - 1] = -1;
+    server->open_threads--;
+    pthread_cond_broadcast(&server->cond);
+    pthread_mutex_unlock(&server->lock);
+    free(conn);
+    return NULL;
+}
+
+static void* mock_accept_thread(void* arg) {
+    MockServer* server = (MockServer*)arg;
+    while (!server->stopping) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) break;
+        MockConnection* conn = (MockConnection*)calloc(1, sizeof(MockConnection));
+        pthread_mutex_lock(&server->lock);
+        if (!conn || server->connections >= MOCK_MAX_CONNECTIONS || server->stopping) {
+            pthread_mutex_unlock(&server->lock);
+            free(conn);
+            close(fd);
+            continue;
+        }
+        /* Headers and body go out in separate sends; without this, Nagle
+         * and delayed ACKs add ~40 ms to every small response */
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        conn->server = server;
+        conn->fd = fd;
+        conn->id = ++server->connections;
+        server->fds[conn->id - 1] = fd;
+        server->open_threads++;
+        pthread_mutex_unlock(&server->lock);
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, mock_connection_thread, conn) != 0) {
+            pthread_mutex_lock(&server->lock);
+            server->fds[conn->id - 1] = -1;
+            server->open_threads--;
+            pthread_mutex_unlock(&server->lock);
+            close(fd);
+            free(conn);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+    return NULL;
+}
+
+static int mock_server_start(MockServer* server, mock_handler_t handler, void* user_data) {
+    memset(server, 0, sizeof(*server));
+    for (int i = 0; i < MOCK_MAX_CONNECTIONS; i++) server->fds[i] = -1;
+    server->handler = handler;
+    server->user_data = user_data;
+    pthread_mutex_init(&server->lock, NULL);
+    pthread_cond_init(&server->cond, NULL);
+    server->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (server->listen_fd < 0) return 0;
+    int opt = 1;
+    setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(server->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) return 0;
+    if (listen(server->listen_fd, 128) != 0) return 0;
+    socklen_t len = sizeof(addr);
+    if (getsockname(server->listen_fd, (struct sockaddr*)&addr, &len) != 0) return 0;
+    server->port = ntohs(addr.sin_port);
+    return pthread_create(&server->thread, NULL, mock_accept_thread, server) == 0;
+}
+
+static void mock_server_host(const MockServer* server, char* host, size_t host_size) {
+    snprintf(host, host_size, "http://127.0.0.1:%d", server->port);
+}
+
+static void mock_server_stop(MockServer* server) {
+    pthread_mutex_lock(&server->lock);
+    server->stopping = 1;
+    pthread_cond_broadcast(&server->cond);
+    for (int i = 0; i < MOCK_MAX_CONNECTIONS; i++) {
+        if (server->fds[i] >= 0) shutdown(server->fds[i], SHUT_RDWR);
+    }
+    pthread_mutex_unlock(&server->lock);
+    shutdown(server->listen_fd, SHUT_RDWR);
+    close(server->listen_fd);
+    pthread_join(server->thread, NULL);
+    pthread_mutex_lock(&server->lock);
+    while (server->open_threads > 0) pthread_cond_wait(&server->cond, &server->lock);
+    pthread_mutex_unlock(&server->lock);
+    pthread_cond_destroy(&server->cond);
+    pthread_mutex_destroy(&server->lock);
+}
+
+#endif /* TYPECAST_TESTS_MOCK_SERVER_H */
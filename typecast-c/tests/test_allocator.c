@@ -0,0 +1,178 @@
+/**
+ * Response allocator tests: audio buffers owned by the client's allocator,
+ * Content-Length presizing and the size hint used without one
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static TypecastClient* new_client(MockServer* server, const TypecastClientOptions* options) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options);
+}
+
+
+typedef struct {
+    int allocs;
+    int reallocs;
+    int frees;
+    size_t first_size;
+} CountingArena;
+
+static void* arena_alloc(size_t size, void* user_data) {
+    CountingArena* arena = (CountingArena*)user_data;
+    if (arena->allocs++ == 0) arena->first_size = size;
+    return malloc(size);
+}
+
+static void* arena_realloc(void* ptr, size_t size, void* user_data) {
+    ((CountingArena*)user_data)->reallocs++;
+    return realloc(ptr, size);
+}
+
+static void arena_free(void* ptr, void* user_data) {
+    ((CountingArena*)user_data)->frees++;
+    free(ptr);
+}
+
+static uint8_t big_audio[300 * 1024];
+
+static void audio_route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    (void)user_data;
+    resp->body = big_audio;
+    resp->body_len = sizeof(big_audio);
+    if (strstr(req->body, "chunked")) resp->chunk_size = 64 * 1024;
+}
+
+static TypecastTTSResponse* speak(TypecastClient* client, const char* text) {
+    TypecastTTSRequest req = {0};
+    req.text = text;
+    req.voice_id = "tc_voice";
+    return typecast_text_to_speech(client, &req);
+}
+
+static void test_allocator_owns_audio_buffers(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, audio_route, NULL));
+    CountingArena arena = {0};
+    TypecastClientOptions options = {0};
+    options.allocator.alloc_fn = arena_alloc;
+    options.allocator.realloc_fn = arena_realloc;
+    options.allocator.free_fn = arena_free;
+    options.allocator.user_data = &arena;
+    TypecastClient* client = new_client(&server, &options);
+    ASSERT(client != NULL);
+
+    /* Content-Length sizes the buffer once: no realloc cascade */
+    TypecastTTSResponse* resp = speak(client, "sized");
+    ASSERT(resp != NULL);
+    ASSERT_EQ(resp->audio_size, sizeof(big_audio));
+    ASSERT_EQ(arena.allocs, 1);
+    ASSERT_EQ(arena.reallocs, 0);
+    ASSERT_EQ(arena.first_size, sizeof(big_audio) + 1);
+    typecast_tts_response_free(resp);
+    ASSERT_EQ(arena.frees, 1);
+
+    /* A taken buffer belongs to the caller */
+    resp = speak(client, "take");
+    size_t size = 0;
+    uint8_t* audio = typecast_tts_response_take_audio(resp, &size);
+    ASSERT(audio != NULL);
+    ASSERT_EQ(size, sizeof(big_audio));
+    ASSERT(resp->audio_data == NULL && resp->audio_size == 0);
+    typecast_tts_response_free(resp);
+    ASSERT_EQ(arena.frees, 1);
+    arena_free(audio, &arena);
+    ASSERT(typecast_tts_response_take_audio(NULL, &size) == NULL);
+    ASSERT_EQ(size, 0);
+
+    /* Without Content-Length the buffer grows through realloc_fn */
+    resp = speak(client, "chunked");
+    ASSERT(resp != NULL);
+    ASSERT_EQ(resp->audio_size, sizeof(big_audio));
+    ASSERT(arena.reallocs > 0);
+    typecast_tts_response_free(resp);
+
+    /* A response built by the caller keeps the 1.x contract: free() */
+    int frees = arena.frees;
+    TypecastTTSResponse* own = (TypecastTTSResponse*)calloc(1, sizeof(TypecastTTSResponse));
+    own->audio_data = (uint8_t*)malloc(16);
+    own->audio_size = 16;
+    typecast_tts_response_free(own);
+    ASSERT_EQ(arena.frees, frees);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_size_hint_without_content_length(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, audio_route, NULL));
+    CountingArena arena = {0};
+    TypecastClientOptions options = {0};
+    options.allocator.alloc_fn = arena_alloc;
+    options.allocator.free_fn = arena_free;   /* no realloc_fn: alloc + copy */
+    options.allocator.user_data = &arena;
+    options.response_size_hint = 100 * 1024;
+    TypecastClient* client = new_client(&server, &options);
+
+    for (size_t i = 0; i < sizeof(big_audio); i++) big_audio[i] = (uint8_t)(i * 7);
+    TypecastTTSResponse* resp = speak(client, "chunked");
+    ASSERT(resp != NULL);
+    ASSERT_EQ(resp->audio_size, sizeof(big_audio));
+    ASSERT(memcmp(resp->audio_data, big_audio, sizeof(big_audio)) == 0);
+    ASSERT_EQ(arena.first_size, 100 * 1024 + 1);
+    /* 100K -> 200K -> 400K, every old buffer released */
+    ASSERT_EQ(arena.allocs, 3);
+    ASSERT_EQ(arena.frees, 2);
+    typecast_tts_response_free(resp);
+    ASSERT_EQ(arena.frees, 3);
+    typecast_client_destroy(client);
+
+    TypecastClientOptions half = {0};
+    half.allocator.alloc_fn = arena_alloc;
+    ASSERT(new_client(&server, &half) == NULL);
+    half.allocator.alloc_fn = NULL;
+    half.allocator.realloc_fn = arena_realloc;
+    ASSERT(new_client(&server, &half) == NULL);
+
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Response Allocator Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(allocator_owns_audio_buffers);
+    RUN(size_hint_without_content_length);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,430 @@
+/**
+ * Async engine tests (curl multi event loop, no API key required)
+ */
+
+#define _GNU_SOURCE  /* memmem */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_STREQ(a, b) ASSERT((a) && strcmp((a), (b)) == 0)
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static const char* TIMESTAMPS_JSON =
+    "{\"audio\":\"QVVESU8=\",\"audio_format\":\"wav\",\"audio_duration\":1.0,"
+    "\"words\":[{\"text\":\"Hello.\",\"start\":0.0,\"end\":0.5},"
+    "{\"text\":\"World.\",\"start\":0.5,\"end\":1.0}],\"characters\":null}";
+
+static const char* STREAM_BODY = "stream-audio-bytes";
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    (void)user_data;
+    if (req->body && strstr(req->body, "unauthorized")) {
+        static const char detail[] = "{\"detail\":\"bad key\"}";
+        resp->status = 401;
+        resp->body = (const uint8_t*)detail;
+        resp->body_len = strlen(detail);
+        return;
+    }
+    if (req->body && strstr(req->body, "slow")) resp->delay_ms = 500;
+    if (strncmp(req->path, "/v1/text-to-speech/with-timestamps", 34) == 0) {
+        snprintf(resp->headers, sizeof(resp->headers), "Content-Type: application/json\r\n");
+        resp->body = (const uint8_t*)TIMESTAMPS_JSON;
+        resp->body_len = strlen(TIMESTAMPS_JSON);
+    } else if (strcmp(req->path, "/v1/text-to-speech/stream") == 0) {
+        resp->body = (const uint8_t*)STREAM_BODY;
+        resp->body_len = strlen(STREAM_BODY);
+        resp->chunk_size = 4;
+    } else {
+        /* Echo the request body so each job can check it got its own audio. */
+        snprintf(resp->headers, sizeof(resp->headers), "X-Audio-Duration: 0.5\r\n");
+        resp->body = (const uint8_t*)req->body;
+        resp->body_len = req->body_len;
+    }
+}
+
+static TypecastClient* new_client(MockServer* server) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_host("test-key", host);
+}
+
+static TypecastTTSRequest tts_request(const char* text) {
+    TypecastTTSRequest req = {0};
+    req.text = text;
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    return req;
+}
+
+static void drain(TypecastClient* client) {
+    size_t running = 1;
+    for (int i = 0; i < 200 && running > 0; i++) {
+        if (typecast_async_poll(client, 100, &running) != TYPECAST_OK) return;
+    }
+}
+
+static void count_done(TypecastAsyncJob* job, void* user_data) {
+    (void)job;
+    (*(int*)user_data)++;
+}
+
+typedef struct {
+    char data[256];
+    size_t len;
+    int calls;
+    int abort_after;
+} StreamSink;
+
+static int collect_chunk(const uint8_t* data, size_t len, void* user_data) {
+    StreamSink* sink = (StreamSink*)user_data;
+    sink->calls++;
+    if (sink->len + len < sizeof(sink->data)) {
+        memcpy(sink->data + sink->len, data, len);
+        sink->len += len;
+    }
+    return sink->abort_after > 0 && sink->calls >= sink->abort_after;
+}
+
+static void test_submit_validation(void) {
+    TypecastTTSRequest req = tts_request("hello");
+    ASSERT(typecast_async_text_to_speech(NULL, &req, NULL, NULL) == NULL);
+
+    TypecastClient* client = typecast_client_create_with_host("test-key", "http://127.0.0.1:1");
+    ASSERT(client != NULL);
+    ASSERT(typecast_async_text_to_speech(client, NULL, NULL, NULL) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INVALID_PARAM);
+
+    req.voice_id = NULL;
+    ASSERT(typecast_async_text_to_speech(client, &req, NULL, NULL) == NULL);
+    ASSERT_STREQ(typecast_client_get_error(client)->message, "text and voice_id are required");
+
+    TypecastTTSRequestWithTimestamps ts = {0};
+    ASSERT(typecast_async_text_to_speech_with_timestamps(client, &ts, NULL, NULL) == NULL);
+    TypecastTTSRequestStream stream = {0};
+    stream.text = "x";
+    stream.voice_id = "v";
+    ASSERT(typecast_async_text_to_speech_stream(client, &stream, NULL, NULL, NULL) == NULL);
+    ASSERT_STREQ(typecast_client_get_error(client)->message, "Invalid parameters");
+
+    size_t running = 99;
+    ASSERT_EQ(typecast_async_poll(client, 0, &running), TYPECAST_OK);
+    ASSERT_EQ(running, 0);
+    ASSERT_EQ(typecast_async_poll(NULL, 0, NULL), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_async_wait(client, NULL), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_async_job_is_done(NULL), 0);
+    ASSERT_EQ(typecast_async_job_result(NULL), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(typecast_async_job_error(NULL) == NULL);
+    ASSERT(typecast_async_job_take_tts_response(NULL) == NULL);
+    ASSERT(typecast_async_job_take_timestamps_response(NULL) == NULL);
+    typecast_async_job_free(NULL);
+    typecast_client_destroy(client);
+}
+
+static void test_many_requests_in_flight_on_one_thread(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    server.hold_until = 4;
+    TypecastClient* client = new_client(&server);
+
+    const char* texts[4] = {"line one", "line two", "line three", "line four"};
+    TypecastAsyncJob* jobs[4];
+    int done = 0;
+    for (int i = 0; i < 4; i++) {
+        TypecastTTSRequest req = tts_request(texts[i]);
+        jobs[i] = typecast_async_text_to_speech(client, &req, count_done, &done);
+        ASSERT(jobs[i] != NULL);
+        ASSERT_EQ(typecast_async_job_is_done(jobs[i]), 0);
+    }
+    drain(client);
+    ASSERT_EQ(done, 4);
+    ASSERT(server.max_active >= 4);
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(typecast_async_job_result(jobs[i]), TYPECAST_OK);
+        TypecastTTSResponse* resp = typecast_async_job_take_tts_response(jobs[i]);
+        ASSERT(resp != NULL);
+        ASSERT(typecast_async_job_take_tts_response(jobs[i]) == NULL);
+        ASSERT(strstr((const char*)resp->audio_data, texts[i]) != NULL);
+        ASSERT(resp->duration > 0.49f && resp->duration < 0.51f);
+        ASSERT_EQ(resp->format, TYPECAST_AUDIO_FORMAT_WAV);
+        typecast_tts_response_free(resp);
+        typecast_async_job_free(jobs[i]);
+    }
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_mixed_request_kinds(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    server.hold_until = 3;
+    TypecastClient* client = new_client(&server);
+
+    TypecastTTSRequest tts = tts_request("plain");
+    TypecastTTSRequestWithTimestamps ts = {0};
+    ts.text = "Hello. World.";
+    ts.voice_id = "tc_voice";
+    ts.granularity = "word";
+    TypecastTTSRequestStream stream = {0};
+    stream.text = "streamed";
+    stream.voice_id = "tc_voice";
+    StreamSink sink = {0};
+
+    TypecastAsyncJob* a = typecast_async_text_to_speech(client, &tts, NULL, NULL);
+    TypecastAsyncJob* b = typecast_async_text_to_speech_with_timestamps(client, &ts, NULL, NULL);
+    TypecastAsyncJob* c = typecast_async_text_to_speech_stream(client, &stream, collect_chunk, NULL, &sink);
+    ASSERT(a && b && c);
+
+    ASSERT_EQ(typecast_async_wait(client, b), TYPECAST_OK);
+    ASSERT(typecast_async_job_take_tts_response(b) == NULL);
+    TypecastTTSWithTimestampsResponse* ts_resp = typecast_async_job_take_timestamps_response(b);
+    ASSERT(ts_resp != NULL);
+    ASSERT_EQ(ts_resp->words_count, 2);
+    ASSERT_STREQ(ts_resp->words[1].text, "World.");
+    ASSERT_STREQ(ts_resp->audio_base64, "QVVESU8=");
+    typecast_tts_with_timestamps_response_free(ts_resp);
+
+    ASSERT_EQ(typecast_async_wait(client, c), TYPECAST_OK);
+    ASSERT_EQ(sink.len, strlen(STREAM_BODY));
+    ASSERT(memcmp(sink.data, STREAM_BODY, sink.len) == 0);
+    ASSERT_EQ(typecast_async_wait(client, a), TYPECAST_OK);
+    ASSERT(server.max_active >= 3);
+
+    typecast_async_job_free(a);
+    typecast_async_job_free(b);
+    typecast_async_job_free(c);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_job_errors_are_per_job(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClient* client = new_client(&server);
+
+    TypecastTTSRequest bad = tts_request("unauthorized");
+    TypecastTTSRequest good = tts_request("fine");
+    TypecastAsyncJob* failing = typecast_async_text_to_speech(client, &bad, NULL, NULL);
+    TypecastAsyncJob* passing = typecast_async_text_to_speech(client, &good, NULL, NULL);
+    drain(client);
+
+    ASSERT_EQ(typecast_async_job_result(failing), TYPECAST_ERROR_UNAUTHORIZED);
+    ASSERT_EQ(typecast_async_job_error(failing)->code, TYPECAST_ERROR_UNAUTHORIZED);
+    ASSERT_STREQ(typecast_async_job_error(failing)->message, "bad key");
+    ASSERT(typecast_async_job_take_tts_response(failing) == NULL);
+    ASSERT_EQ(typecast_async_job_result(passing), TYPECAST_OK);
+    ASSERT_EQ(typecast_async_job_error(passing)->code, TYPECAST_OK);
+
+    TypecastTTSRequestWithTimestamps ts = {0};
+    ts.text = "unauthorized";
+    ts.voice_id = "tc_voice";
+    TypecastAsyncJob* ts_job = typecast_async_text_to_speech_with_timestamps(client, &ts, NULL, NULL);
+    ASSERT_EQ(typecast_async_wait(client, ts_job), TYPECAST_ERROR_UNAUTHORIZED);
+    ASSERT(typecast_async_job_take_timestamps_response(ts_job) == NULL);
+
+    typecast_async_job_free(failing);
+    typecast_async_job_free(passing);
+    typecast_async_job_free(ts_job);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_stream_abort_only_affects_its_job(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClient* client = new_client(&server);
+
+    TypecastTTSRequestStream stream = {0};
+    stream.text = "streamed";
+    stream.voice_id = "tc_voice";
+    StreamSink aborting = {0};
+    aborting.abort_after = 1;
+    StreamSink complete = {0};
+    TypecastAsyncJob* a = typecast_async_text_to_speech_stream(client, &stream, collect_chunk, NULL, &aborting);
+    TypecastAsyncJob* b = typecast_async_text_to_speech_stream(client, &stream, collect_chunk, NULL, &complete);
+    drain(client);
+
+    ASSERT_EQ(typecast_async_job_result(a), TYPECAST_ERROR_NETWORK);
+    ASSERT_STREQ(typecast_async_job_error(a)->message, "Stream aborted by callback");
+    ASSERT_EQ(typecast_async_job_result(b), TYPECAST_OK);
+    ASSERT_EQ(complete.len, strlen(STREAM_BODY));
+
+    typecast_async_job_free(a);
+    typecast_async_job_free(b);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_free_running_job_cancels_it(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClient* client = new_client(&server);
+
+    int done = 0;
+    TypecastTTSRequest req = tts_request("slow");
+    TypecastAsyncJob* job = typecast_async_text_to_speech(client, &req, count_done, &done);
+    ASSERT(job != NULL);
+    size_t running = 0;
+    ASSERT_EQ(typecast_async_poll(client, 0, &running), TYPECAST_OK);
+    ASSERT_EQ(running, 1);
+    typecast_async_job_free(job);
+    ASSERT_EQ(typecast_async_poll(client, 0, &running), TYPECAST_OK);
+    ASSERT_EQ(running, 0);
+    ASSERT_EQ(done, 0);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_destroy_client_fails_running_jobs(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClient* client = new_client(&server);
+
+    TypecastTTSRequest req = tts_request("slow");
+    TypecastAsyncJob* job = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    ASSERT(job != NULL);
+    ASSERT_EQ(typecast_async_poll(client, 10, NULL), TYPECAST_OK);
+    typecast_client_destroy(client);
+
+    ASSERT_EQ(typecast_async_job_is_done(job), 1);
+    ASSERT_EQ(typecast_async_job_result(job), TYPECAST_ERROR_NETWORK);
+    ASSERT(typecast_async_job_take_tts_response(job) == NULL);
+    typecast_async_job_free(job);
+    mock_server_stop(&server);
+}
+
+static void test_network_error_reported_on_job(void) {
+    TypecastClient* client = typecast_client_create_with_host("test-key", "http://127.0.0.1:1");
+    TypecastTTSRequest req = tts_request("hello");
+    TypecastAsyncJob* job = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    ASSERT(job != NULL);
+    ASSERT_EQ(typecast_async_wait(client, job), TYPECAST_ERROR_NETWORK);
+    ASSERT(typecast_async_job_error(job)->message != NULL);
+    /* A finished job reports its result to any caller. */
+    TypecastClient* other = typecast_client_create_with_host("test-key", "http://127.0.0.1:1");
+    ASSERT_EQ(typecast_async_wait(other, job), TYPECAST_ERROR_NETWORK);
+    typecast_async_job_free(job);
+    typecast_client_destroy(other);
+    typecast_client_destroy(client);
+}
+
+static void test_compose_job(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClient* client = new_client(&server);
+
+    /* A composition without speech fails at submission */
+    TypecastSpeechComposer* composer = typecast_speech_composer_create(client);
+    ASSERT(typecast_async_speech_composer_generate(composer, TYPECAST_AUDIO_FORMAT_WAV, NULL, NULL) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(typecast_async_speech_composer_generate(NULL, TYPECAST_AUDIO_FORMAT_WAV, NULL, NULL) == NULL);
+
+    TypecastComposerSettings defaults = {0};
+    defaults.voice_id = "tc_voice";
+    ASSERT_EQ(typecast_speech_composer_defaults(composer, &defaults), TYPECAST_OK);
+    ASSERT_EQ(typecast_speech_composer_say(composer, "composed", NULL), TYPECAST_OK);
+    int done = 0;
+    TypecastAsyncJob* job = typecast_async_speech_composer_generate(composer, TYPECAST_AUDIO_FORMAT_MP3,
+        count_done, &done);
+    ASSERT(job != NULL);
+    /* The body was built at submission */
+    typecast_speech_composer_destroy(composer);
+
+    ASSERT_EQ(typecast_async_wait(client, job), TYPECAST_OK);
+    ASSERT_EQ(done, 1);
+    TypecastTTSResponse* resp = typecast_async_job_take_tts_response(job);
+    ASSERT(resp != NULL);
+    ASSERT_EQ(resp->format, TYPECAST_AUDIO_FORMAT_MP3);
+    ASSERT(memmem(resp->audio_data, resp->audio_size, "\"segments\"", 10) != NULL);
+    ASSERT(memmem(resp->audio_data, resp->audio_size, "composed", 8) != NULL);
+    typecast_tts_response_free(resp);
+    typecast_async_job_free(job);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void* wake_later(void* arg) {
+    usleep(50 * 1000);
+    typecast_async_wakeup((TypecastClient*)arg);
+    return NULL;
+}
+
+static void test_wakeup_interrupts_poll(void) {
+    ASSERT_EQ(typecast_async_wakeup(NULL), TYPECAST_ERROR_INVALID_PARAM);
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClient* client = new_client(&server);
+    /* Nothing to wake before the first job */
+    ASSERT_EQ(typecast_async_wakeup(client), TYPECAST_OK);
+
+    TypecastTTSRequest req = tts_request("slow");
+    TypecastAsyncJob* job = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    ASSERT(job != NULL);
+    ASSERT_EQ(typecast_async_poll(client, 0, NULL), TYPECAST_OK);
+
+    pthread_t waker;
+    ASSERT_EQ(pthread_create(&waker, NULL, wake_later, client), 0);
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    size_t running = 0;
+    ASSERT_EQ(typecast_async_poll(client, 5000, &running), TYPECAST_OK);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    pthread_join(waker, NULL);
+    long waited = (now.tv_sec - start.tv_sec) * 1000L + (now.tv_nsec - start.tv_nsec) / 1000000L;
+    /* Back well before the 500 ms response, with the job still running */
+    ASSERT(waited < 400);
+    ASSERT_EQ(running, 1);
+
+    ASSERT_EQ(typecast_async_wait(client, job), TYPECAST_OK);
+    typecast_async_job_free(job);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Async Engine Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(submit_validation);
+    RUN(many_requests_in_flight_on_one_thread);
+    RUN(mixed_request_kinds);
+    RUN(job_errors_are_per_job);
+    RUN(stream_abort_only_affects_its_job);
+    RUN(free_running_job_cancels_it);
+    RUN(destroy_client_fails_running_jobs);
+    RUN(network_error_reported_on_job);
+    RUN(compose_job);
+    RUN(wakeup_interrupts_poll);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,446 @@
+/**
+ * Batch generation tests: bounded parallelism, atomic outputs, resuming an
+ * interrupted batch and JSON Lines manifests
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+#define MAX_REQUESTS 32
+#define WAV_HEADER 44
+
+/* Each request is answered with its text as the samples of a WAV, or as
+ * the bare bytes when MP3 was asked for */
+typedef struct {
+    pthread_mutex_t lock;
+    char* bodies[MAX_REQUESTS];
+    uint8_t* replies[MAX_REQUESTS];
+    int count;
+    const char* fail_text;           /* answered with 500 */
+    int delay_ms;
+} Plan;
+
+static void put_le32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static size_t make_wav(uint8_t* out, const uint8_t* data, size_t len, uint32_t declared) {
+    static const uint8_t fmt[16] = {1, 0, 1, 0, 0x44, 0xAC, 0, 0, 0x88, 0x58, 0x01, 0, 2, 0, 16, 0};
+    memcpy(out, "RIFF", 4);
+    put_le32(out + 4, (uint32_t)(36 + declared));
+    memcpy(out + 8, "WAVEfmt ", 8);
+    put_le32(out + 16, 16);
+    memcpy(out + 20, fmt, sizeof(fmt));
+    memcpy(out + 36, "data", 4);
+    put_le32(out + 40, declared);
+    memcpy(out + WAV_HEADER, data, len);
+    return WAV_HEADER + len;
+}
+
+static int json_string(const char* body, const char* key, char* out, size_t out_size) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":\"", key);
+    const char* start = strstr(body, pattern);
+    if (!start) return 0;
+    start += strlen(pattern);
+    const char* end = strchr(start, '"');
+    size_t len = end ? (size_t)(end - start) : 0;
+    if (len >= out_size) len = out_size - 1;
+    memcpy(out, start, len);
+    out[len] = '\0';
+    return 1;
+}
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = (Plan*)user_data;
+    const char* body = req->body ? req->body : "";
+    char text[256] = "";
+    json_string(body, "text", text, sizeof(text));
+    size_t len = strlen(text);
+
+    pthread_mutex_lock(&plan->lock);
+    int index = plan->count < MAX_REQUESTS ? plan->count++ : MAX_REQUESTS - 1;
+    free(plan->bodies[index]);
+    plan->bodies[index] = strdup(body);
+    free(plan->replies[index]);
+    plan->replies[index] = (uint8_t*)malloc(WAV_HEADER + len + 1);
+    if (plan->fail_text && strcmp(text, plan->fail_text) == 0) {
+        static const char detail[] = "{\"detail\":\"boom\"}";
+        resp->status = 500;
+        resp->body = (const uint8_t*)detail;
+        resp->body_len = strlen(detail);
+    } else if (strstr(body, "\"audio_format\":\"mp3\"")) {
+        memcpy(plan->replies[index], text, len);
+        resp->body = plan->replies[index];
+        resp->body_len = len;
+    } else {
+        resp->body = plan->replies[index];
+        resp->body_len = make_wav(plan->replies[index], (const uint8_t*)text, len, (uint32_t)len);
+    }
+    resp->delay_ms = plan->delay_ms;
+    pthread_mutex_unlock(&plan->lock);
+}
+
+typedef struct {
+    MockServer server;
+    Plan plan;
+    TypecastClient* client;
+    char dir[64];
+} Fixture;
+
+static void setup(Fixture* f) {
+    memset(f, 0, sizeof(*f));
+    pthread_mutex_init(&f->plan.lock, NULL);
+    mock_server_start(&f->server, route, &f->plan);
+    char host[64];
+    mock_server_host(&f->server, host, sizeof(host));
+    f->client = typecast_client_create_with_host("test-key", host);
+    snprintf(f->dir, sizeof(f->dir), "/tmp/typecast-batch-XXXXXX");
+    if (!mkdtemp(f->dir)) f->dir[0] = '\0';
+}
+
+/* Files in the fixture directory, including leftover temporary files;
+ * each is deleted when `remove` is set */
+static int scan_files(const Fixture* f, int remove) {
+    DIR* dir = opendir(f->dir);
+    if (!dir) return -1;
+    int n = 0;
+    struct dirent* entry;
+    char path[512];
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        n++;
+        snprintf(path, sizeof(path), "%s/%s", f->dir, entry->d_name);
+        if (remove) unlink(path);
+    }
+    closedir(dir);
+    return n;
+}
+
+static void teardown(Fixture* f) {
+    typecast_client_destroy(f->client);
+    mock_server_stop(&f->server);
+    for (int i = 0; i < MAX_REQUESTS; i++) {
+        free(f->plan.bodies[i]);
+        free(f->plan.replies[i]);
+    }
+    pthread_mutex_destroy(&f->plan.lock);
+    if (scan_files(f, 1) >= 0) rmdir(f->dir);
+}
+
+static size_t read_file(const char* path, uint8_t* out, size_t out_size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+    size_t n = fread(out, 1, out_size, file);
+    fclose(file);
+    return n;
+}
+
+static void write_file(const char* path, const void* data, size_t size) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return;
+    fwrite(data, 1, size, file);
+    fclose(file);
+}
+
+#define MAX_ITEMS 8
+
+typedef struct {
+    char paths[MAX_ITEMS][128];
+    char texts[MAX_ITEMS][32];
+    TypecastBatchItem items[MAX_ITEMS];
+} Items;
+
+static void make_items(Items* items, const Fixture* f, size_t count, const char* ext) {
+    memset(items, 0, sizeof(*items));
+    for (size_t i = 0; i < count; i++) {
+        snprintf(items->paths[i], sizeof(items->paths[i]), "%s/line%02u.%s", f->dir, (unsigned)i, ext);
+        snprintf(items->texts[i], sizeof(items->texts[i]), "Line %u", (unsigned)i);
+        items->items[i].path = items->paths[i];
+        items->items[i].request.text = items->texts[i];
+        items->items[i].request.voice_id = "tc_voice";
+    }
+}
+
+typedef struct {
+    int calls;
+    int status_count[3];
+    size_t order[MAX_ITEMS * 2];
+    TypecastErrorCode last_error;
+} Progress;
+
+static void on_item(size_t index, const char* path, TypecastBatchItemStatus status,
+    const TypecastError* error, void* user_data) {
+    (void)path;
+    Progress* p = (Progress*)user_data;
+    if (p->calls < MAX_ITEMS * 2) p->order[p->calls] = index;
+    p->calls++;
+    p->status_count[status]++;
+    p->last_error = error ? error->code : TYPECAST_OK;
+}
+
+static void test_writes_every_output(void) {
+    Fixture f;
+    setup(&f);
+    f.plan.delay_ms = 30;
+    Items items;
+    make_items(&items, &f, 6, "wav");
+    TypecastBatchOptions options = {0};
+    options.max_in_flight = 2;
+    Progress progress = {0};
+    TypecastBatchSummary summary;
+    ASSERT_EQ(typecast_generate_batch(f.client, items.items, 6, &options, on_item, &progress, &summary),
+              TYPECAST_OK);
+
+    ASSERT_EQ(summary.written, 6u);
+    ASSERT_EQ(summary.skipped + summary.failed + summary.not_started, 0u);
+    ASSERT_EQ(progress.status_count[TYPECAST_BATCH_ITEM_WRITTEN], 6);
+    ASSERT_EQ(f.plan.count, 6);
+    ASSERT_EQ(f.server.max_active, 2);
+    /* No temporary files are left behind */
+    ASSERT_EQ(scan_files(&f, 0), 6);
+
+    uint8_t data[256];
+    size_t n = read_file(items.paths[3], data, sizeof(data));
+    ASSERT_EQ(n, WAV_HEADER + strlen("Line 3"));
+    ASSERT(memcmp(data, "RIFF", 4) == 0);
+    ASSERT(memcmp(data + WAV_HEADER, "Line 3", 6) == 0);
+    teardown(&f);
+}
+
+static void test_resume_skips_complete_outputs(void) {
+    Fixture f;
+    setup(&f);
+    Items items;
+    make_items(&items, &f, 4, "wav");
+    uint8_t wav[128];
+    /* 0: complete WAV, 1: WAV cut short of its declared length, 2: empty,
+     * 3: missing */
+    write_file(items.paths[0], wav, make_wav(wav, (const uint8_t*)"done", 4, 4));
+    write_file(items.paths[1], wav, make_wav(wav, (const uint8_t*)"cut", 3, 4000));
+    write_file(items.paths[2], "", 0);
+
+    Progress progress = {0};
+    TypecastBatchSummary summary;
+    ASSERT_EQ(typecast_generate_batch(f.client, items.items, 4, NULL, on_item, &progress, &summary), TYPECAST_OK);
+    ASSERT_EQ(summary.skipped, 1u);
+    ASSERT_EQ(summary.written, 3u);
+    ASSERT_EQ(f.plan.count, 3);
+    ASSERT_EQ(progress.order[0], 0u);
+    uint8_t data[128];
+    ASSERT_EQ(read_file(items.paths[0], data, sizeof(data)), WAV_HEADER + 4u);
+    ASSERT(memcmp(data + WAV_HEADER, "done", 4) == 0);
+
+    /* A second run has nothing left to render */
+    ASSERT_EQ(typecast_generate_batch(f.client, items.items, 4, NULL, NULL, NULL, &summary), TYPECAST_OK);
+    ASSERT_EQ(summary.skipped, 4u);
+    ASSERT_EQ(f.plan.count, 3);
+
+    TypecastBatchOptions options = {0};
+    options.overwrite = 1;
+    ASSERT_EQ(typecast_generate_batch(f.client, items.items, 4, &options, NULL, NULL, &summary), TYPECAST_OK);
+    ASSERT_EQ(summary.written, 4u);
+    ASSERT_EQ(f.plan.count, 7);
+    teardown(&f);
+}
+
+static void test_failed_item_does_not_stop_others(void) {
+    Fixture f;
+    setup(&f);
+    f.plan.fail_text = "Line 1";
+    Items items;
+    make_items(&items, &f, 4, "wav");
+    Progress progress = {0};
+    TypecastBatchSummary summary;
+    ASSERT_EQ(typecast_generate_batch(f.client, items.items, 4, NULL, on_item, &progress, &summary),
+              TYPECAST_ERROR_INTERNAL_SERVER);
+    ASSERT_EQ(summary.written, 3u);
+    ASSERT_EQ(summary.failed, 1u);
+    ASSERT_EQ(progress.status_count[TYPECAST_BATCH_ITEM_FAILED], 1);
+    ASSERT_EQ(typecast_client_get_error(f.client)->code, TYPECAST_ERROR_INTERNAL_SERVER);
+    /* The failed output and its temporary file are gone */
+    ASSERT(access(items.paths[1], F_OK) != 0);
+    ASSERT_EQ(scan_files(&f, 0), 3);
+    teardown(&f);
+}
+
+static void test_stop_on_error(void) {
+    Fixture f;
+    setup(&f);
+    f.plan.fail_text = "Line 1";
+    Items items;
+    make_items(&items, &f, 5, "wav");
+    TypecastBatchOptions options = {0};
+    options.max_in_flight = 1;
+    options.stop_on_error = 1;
+    Progress progress = {0};
+    TypecastBatchSummary summary;
+    ASSERT_EQ(typecast_generate_batch(f.client, items.items, 5, &options, on_item, &progress, &summary),
+              TYPECAST_ERROR_INTERNAL_SERVER);
+    ASSERT_EQ(summary.written, 1u);
+    ASSERT_EQ(summary.failed, 1u);
+    ASSERT_EQ(summary.not_started, 3u);
+    ASSERT_EQ(progress.calls, 2);
+    ASSERT_EQ(f.plan.count, 2);
+    teardown(&f);
+}
+
+static void test_invalid_items_fail_without_requests(void) {
+    Fixture f;
+    setup(&f);
+    Items items;
+    make_items(&items, &f, 3, "wav");
+    items.items[0].path = NULL;
+    items.items[1].request.voice_id = " ";
+    items.items[2].path = f.dir;             /* a directory */
+    Progress progress = {0};
+    TypecastBatchSummary summary;
+    ASSERT_EQ(typecast_generate_batch(f.client, items.items, 3, NULL, on_item, &progress, &summary),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(summary.failed, 3u);
+    ASSERT_EQ(progress.last_error, TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(f.plan.count, 0);
+    teardown(&f);
+}
+
+static void test_format_follows_extension(void) {
+    Fixture f;
+    setup(&f);
+    Items items;
+    make_items(&items, &f, 1, "mp3");
+    ASSERT_EQ(typecast_generate_batch(f.client, items.items, 1, NULL, NULL, NULL, NULL), TYPECAST_OK);
+    ASSERT(strstr(f.plan.bodies[0], "\"audio_format\":\"mp3\"") != NULL);
+    uint8_t data[64];
+    ASSERT_EQ(read_file(items.paths[0], data, sizeof(data)), strlen("Line 0"));
+    teardown(&f);
+}
+
+static void test_manifest(void) {
+    Fixture f;
+    setup(&f);
+    char manifest[128];
+    snprintf(manifest, sizeof(manifest), "%s/jobs.jsonl", f.dir);
+    const char* lines =
+        "{\"path\":\"a.wav\",\"text\":\"Alpha\",\"voice_id\":\"tc_a\"}\n"
+        "\n"
+        "{\"path\":\"b.mp3\",\"text\":\"Beta\",\"voice_id\":\"tc_b\",\"model\":\"ssfm-v21\",\"seed\":7,"
+        "\"language\":\"eng\"}\r\n";
+    write_file(manifest, lines, strlen(lines));
+
+    Progress progress = {0};
+    TypecastBatchSummary summary;
+    TypecastBatchOptions options = {0};
+    options.max_in_flight = 1;
+    ASSERT_EQ(typecast_generate_batch_from_manifest(f.client, manifest, &options, on_item, &progress, &summary),
+              TYPECAST_OK);
+    ASSERT_EQ(summary.written, 2u);
+    ASSERT_EQ(progress.order[1], 1u);
+    ASSERT_EQ(f.plan.count, 2);
+    ASSERT(strstr(f.plan.bodies[1], "\"model\":\"ssfm-v21\"") != NULL);
+    ASSERT(strstr(f.plan.bodies[1], "\"seed\":7") != NULL);
+    ASSERT(strstr(f.plan.bodies[1], "\"language\":\"eng\"") != NULL);
+
+    /* Relative paths land next to the manifest */
+    char path[160];
+    uint8_t data[64];
+    snprintf(path, sizeof(path), "%s/b.mp3", f.dir);
+    ASSERT_EQ(read_file(path, data, sizeof(data)), 4u);
+    ASSERT(memcmp(data, "Beta", 4) == 0);
+
+    ASSERT_EQ(typecast_generate_batch_from_manifest(f.client, manifest, NULL, NULL, NULL, &summary), TYPECAST_OK);
+    ASSERT_EQ(summary.skipped, 2u);
+    ASSERT_EQ(f.plan.count, 2);
+    teardown(&f);
+}
+
+static void test_invalid_manifest(void) {
+    Fixture f;
+    setup(&f);
+    char manifest[128];
+    snprintf(manifest, sizeof(manifest), "%s/jobs.jsonl", f.dir);
+    const char* lines =
+        "{\"path\":\"a.wav\",\"text\":\"Alpha\",\"voice_id\":\"tc_a\"}\n"
+        "{\"path\":\"b.wav\",\"text\":\"Beta\",\"voice_id\":\"tc_b\",\"model\":\"ssfm-v99\"}\n";
+    write_file(manifest, lines, strlen(lines));
+    ASSERT_EQ(typecast_generate_batch_from_manifest(f.client, manifest, NULL, NULL, NULL, NULL),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(strstr(typecast_client_get_error(f.client)->message, "line 2") != NULL);
+    ASSERT_EQ(f.plan.count, 0);
+
+    write_file(manifest, "not json\n", 9);
+    ASSERT_EQ(typecast_generate_batch_from_manifest(f.client, manifest, NULL, NULL, NULL, NULL),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(strstr(typecast_client_get_error(f.client)->message, "line 1") != NULL);
+
+    snprintf(manifest, sizeof(manifest), "%s/missing.jsonl", f.dir);
+    ASSERT_EQ(typecast_generate_batch_from_manifest(f.client, manifest, NULL, NULL, NULL, NULL),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_generate_batch_from_manifest(f.client, NULL, NULL, NULL, NULL, NULL),
+              TYPECAST_ERROR_INVALID_PARAM);
+
+    /* An empty manifest is an empty batch */
+    snprintf(manifest, sizeof(manifest), "%s/empty.jsonl", f.dir);
+    write_file(manifest, "", 0);
+    ASSERT_EQ(typecast_generate_batch_from_manifest(f.client, manifest, NULL, NULL, NULL, NULL), TYPECAST_OK);
+    teardown(&f);
+}
+
+static void test_invalid_params(void) {
+    TypecastBatchSummary summary;
+    ASSERT_EQ(typecast_generate_batch(NULL, NULL, 0, NULL, NULL, NULL, &summary), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_generate_batch_from_manifest(NULL, "x.jsonl", NULL, NULL, NULL, NULL),
+              TYPECAST_ERROR_INVALID_PARAM);
+    TypecastClient* client = typecast_client_create_with_host("test-key", "http://127.0.0.1:1");
+    ASSERT_EQ(typecast_generate_batch(client, NULL, 3, NULL, NULL, NULL, &summary), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_generate_batch(client, NULL, 0, NULL, NULL, NULL, &summary), TYPECAST_OK);
+    ASSERT_EQ(summary.written, 0u);
+    typecast_client_destroy(client);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Batch Generation Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(writes_every_output);
+    RUN(resume_skips_complete_outputs);
+    RUN(failed_item_does_not_stop_others);
+    RUN(stop_on_error);
+    RUN(invalid_items_fail_without_requests);
+    RUN(format_follows_extension);
+    RUN(manifest);
+    RUN(invalid_manifest);
+    RUN(invalid_params);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
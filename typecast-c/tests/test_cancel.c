@@ -0,0 +1,342 @@
+/**
+ * Timeout and cancellation tests: client timeout options, per-call
+ * options, deadlines and cancel tokens fired from another thread
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static const char AUDIO[] = "RIFF-audio-RIFF-audio-RIFF-audio-RIFF-audio-RIFF-audio-RIFF-audio";
+static const char VOICES[] = "[{\"voice_id\":\"tc_1\",\"voice_name\":\"One\",\"models\":[]}]";
+
+typedef struct {
+    int delay_ms;                    /* before every response */
+    int status;                      /* 0 = 200 */
+    int chunk_size;
+    int chunk_delay_ms;
+    int requests;
+} Plan;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = (Plan*)user_data;
+    __sync_fetch_and_add(&plan->requests, 1);
+    resp->delay_ms = plan->delay_ms;
+    resp->status = plan->status ? plan->status : 200;
+    resp->chunk_size = plan->chunk_size;
+    resp->chunk_delay_ms = plan->chunk_delay_ms;
+    const char* body = strncmp(req->path, "/v2/voices", 10) == 0 ? VOICES : AUDIO;
+    resp->body = (const uint8_t*)body;
+    resp->body_len = strlen(body);
+}
+
+static TypecastClient* new_client(MockServer* server, Plan* plan, const TypecastClientOptions* options) {
+    mock_server_start(server, route, plan);
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options);
+}
+
+static TypecastTTSRequest tts_request(void) {
+    TypecastTTSRequest req = {0};
+    req.text = "hello";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    return req;
+}
+
+static long elapsed_ms(const struct timespec* since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000L + (now.tv_nsec - since->tv_nsec) / 1000000L;
+}
+
+typedef struct {
+    TypecastCancelToken* token;
+    int after_ms;
+} Canceller;
+
+static void* canceller_main(void* arg) {
+    Canceller* c = (Canceller*)arg;
+    mock_sleep_ms(c->after_ms);
+    typecast_cancel_token_cancel(c->token);
+    return NULL;
+}
+
+static void test_cancel_from_another_thread(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.delay_ms = 2500;
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastCancelToken* token = typecast_cancel_token_create();
+    TypecastCallOptions call = {0};
+    call.cancel = token;
+    ASSERT_EQ(typecast_set_call_options(client, &call), TYPECAST_OK);
+
+    Canceller canceller = {token, 200};
+    pthread_t thread;
+    pthread_create(&thread, NULL, canceller_main, &canceller);
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TypecastTTSRequest req = tts_request();
+    TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+    long took = elapsed_ms(&start);
+    pthread_join(thread, NULL);
+
+    ASSERT(resp == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_CANCELLED);
+    ASSERT(took < 2000);
+    ASSERT(typecast_cancel_token_is_cancelled(token));
+    typecast_client_destroy(client);
+    typecast_cancel_token_free(token);
+    mock_server_stop(&server);
+}
+
+static void test_cancelled_token_fails_until_reset(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.delay_ms = 300;
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastCancelToken* token = typecast_cancel_token_create();
+    typecast_cancel_token_cancel(token);
+    TypecastCallOptions call = {0};
+    call.cancel = token;
+    typecast_set_call_options(client, &call);
+
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_CANCELLED);
+    ASSERT(strcmp(typecast_client_get_error(client)->message, "Request cancelled") == 0);
+
+    typecast_cancel_token_reset(token);
+    ASSERT(!typecast_cancel_token_is_cancelled(token));
+    TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+    ASSERT_EQ(resp->audio_size, strlen(AUDIO));
+    typecast_tts_response_free(resp);
+    typecast_client_destroy(client);
+    typecast_cancel_token_free(token);
+    mock_server_stop(&server);
+}
+
+static void test_cancel_voices_request(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.delay_ms = 2500;
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastCancelToken* token = typecast_cancel_token_create();
+    TypecastCallOptions call = {0};
+    call.cancel = token;
+    typecast_set_call_options(client, &call);
+
+    Canceller canceller = {token, 100};
+    pthread_t thread;
+    pthread_create(&thread, NULL, canceller_main, &canceller);
+    TypecastVoicesResponse* voices = typecast_get_voices(client, NULL);
+    pthread_join(thread, NULL);
+    ASSERT(voices == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_CANCELLED);
+    typecast_client_destroy(client);
+    typecast_cancel_token_free(token);
+    mock_server_stop(&server);
+}
+
+static void test_call_timeout_and_clear(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.delay_ms = 1500;
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastCallOptions call = {0};
+    call.timeout_ms = 200;
+    typecast_set_call_options(client, &call);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT(elapsed_ms(&start) < 1000);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_NETWORK);
+
+    /* Cleared: back to the client's 60 seconds */
+    plan.delay_ms = 300;
+    ASSERT_EQ(typecast_set_call_options(client, NULL), TYPECAST_OK);
+    TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_client_request_timeout(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.delay_ms = 2000;
+    TypecastClientOptions options = {0};
+    options.request_timeout_secs = 1;
+    TypecastClient* client = new_client(&server, &plan, &options);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    long took = elapsed_ms(&start);
+    ASSERT(took >= 900 && took < 1800);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_NETWORK);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_deadline_spans_calls(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.delay_ms = 250;
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastCallOptions call = {0};
+    call.deadline_ms = 400;
+    typecast_set_call_options(client, &call);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TypecastTTSRequest req = tts_request();
+    TypecastTTSResponse* first = typecast_text_to_speech(client, &req);
+    ASSERT(first != NULL);
+    typecast_tts_response_free(first);
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_NETWORK);
+    ASSERT(elapsed_ms(&start) < 700);
+
+    /* Past the deadline further calls fail without waiting */
+    mock_sleep_ms(50);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT(elapsed_ms(&start) < 150);
+    ASSERT(strcmp(typecast_client_get_error(client)->message, "Deadline exceeded") == 0);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_deadline_skips_retry_wait(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.status = 429;
+    TypecastClientOptions options = {0};
+    options.max_retries = 3;
+    options.retry_base_delay_ms = 2000;
+    TypecastClient* client = new_client(&server, &plan, &options);
+    TypecastCallOptions call = {0};
+    call.deadline_ms = 500;
+    typecast_set_call_options(client, &call);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT(elapsed_ms(&start) < 400);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_RATE_LIMIT);
+    ASSERT_EQ(plan.requests, 1);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_low_speed_limit(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.chunk_size = 4;
+    plan.chunk_delay_ms = 200;
+    TypecastClientOptions options = {0};
+    options.low_speed_limit_bytes = 1000;
+    options.low_speed_time_secs = 1;
+    TypecastClient* client = new_client(&server, &plan, &options);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT(elapsed_ms(&start) < 2500);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_NETWORK);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_thread_safe_options_are_per_thread(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.delay_ms = 300;
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    TypecastClient* client = new_client(&server, &plan, &options);
+    TypecastCancelToken* token = typecast_cancel_token_create();
+    typecast_cancel_token_cancel(token);
+    TypecastCallOptions call = {0};
+    call.cancel = token;
+    typecast_set_call_options(client, &call);
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_CANCELLED);
+    typecast_client_destroy(client);
+    typecast_cancel_token_free(token);
+    mock_server_stop(&server);
+}
+
+static void test_invalid_call_options(void) {
+    TypecastCallOptions call = {0};
+    ASSERT_EQ(typecast_set_call_options(NULL, &call), TYPECAST_ERROR_INVALID_PARAM);
+    TypecastClient* client = typecast_client_create("test-key");
+    call.timeout_ms = -1;
+    ASSERT_EQ(typecast_set_call_options(client, &call), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INVALID_PARAM);
+    typecast_client_destroy(client);
+
+    typecast_cancel_token_cancel(NULL);
+    typecast_cancel_token_reset(NULL);
+    typecast_cancel_token_free(NULL);
+    ASSERT(!typecast_cancel_token_is_cancelled(NULL));
+    ASSERT(strcmp(typecast_error_message(TYPECAST_ERROR_CANCELLED), "Request cancelled") == 0);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Timeout and Cancellation Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(cancel_from_another_thread);
+    RUN(cancelled_token_fails_until_reset);
+    RUN(cancel_voices_request);
+    RUN(call_timeout_and_clear);
+    RUN(client_request_timeout);
+    RUN(deadline_spans_calls);
+    RUN(deadline_skips_retry_wait);
+    RUN(low_speed_limit);
+    RUN(thread_safe_options_are_per_thread);
+    RUN(invalid_call_options);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,293 @@
+/**
+ * Caption writer tests: cue-by-cue SRT/VTT output to callbacks and
+ * FILE*, identical to the string helpers, fed from whole responses or
+ * from the streaming with-timestamps path
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_STREQ(a, b) ASSERT((a) && strcmp((a), (b)) == 0)
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static TypecastAlignmentSegment WORDS[] = {
+    {"Hello", 0.0f, 0.4f},
+    {"world.", 0.5f, 0.9f},
+    {"  Second", 1.0f, 1.4f},
+    {"sentence", 1.5f, 2.0f},
+    {"keeps", 2.1f, 2.5f},
+    {"going", 2.6f, 9.5f},
+    {"to", 9.6f, 9.8f},
+    {"the", 9.9f, 10.0f},
+    {"end", 10.1f, 10.5f},
+};
+
+/* Collects the document; stops after `limit` writes when set */
+typedef struct {
+    char data[4096];
+    size_t len;
+    int writes;
+    int limit;
+} Sink;
+
+static int collect(const uint8_t* data, size_t len, void* user_data) {
+    Sink* sink = (Sink*)user_data;
+    if (sink->limit && sink->writes >= sink->limit) return 1;
+    sink->writes++;
+    if (sink->len + len < sizeof(sink->data)) {
+        memcpy(sink->data + sink->len, data, len);
+        sink->len += len;
+        sink->data[sink->len] = '\0';
+    }
+    return 0;
+}
+
+static TypecastTTSWithTimestampsResponse words_response(void) {
+    TypecastTTSWithTimestampsResponse resp;
+    memset(&resp, 0, sizeof(resp));
+    resp.words = WORDS;
+    resp.words_count = sizeof(WORDS) / sizeof(WORDS[0]);
+    return resp;
+}
+
+static void test_writer_matches_string_helpers(void) {
+    TypecastTTSWithTimestampsResponse resp = words_response();
+    char* srt = NULL;
+    char* vtt = NULL;
+    ASSERT_EQ(typecast_tts_with_timestamps_response_to_srt(&resp, &srt), TYPECAST_OK);
+    ASSERT_EQ(typecast_tts_with_timestamps_response_to_vtt(&resp, &vtt), TYPECAST_OK);
+    ASSERT(strncmp(srt, "1\n00:00:00,000 --> 00:00:00,900\nHello world.\n\n2\n00:00:01,000", 60) == 0);
+    ASSERT(strstr(srt, "\nSecond sentence keeps\n\n") != NULL);  /* 7 s limit before "going" */
+
+    Sink sink = {{0}, 0, 0, 0};
+    ASSERT_EQ(typecast_tts_with_timestamps_response_write_captions(&resp, TYPECAST_CAPTION_SRT, collect, &sink),
+              TYPECAST_OK);
+    ASSERT_STREQ(sink.data, srt);
+
+    /* Segment by segment gives the same document */
+    memset(&sink, 0, sizeof(sink));
+    TypecastCaptionWriter* writer = typecast_caption_writer_create(TYPECAST_CAPTION_VTT,
+        TYPECAST_ALIGNMENT_WORD, collect, &sink);
+    ASSERT(writer != NULL);
+    for (size_t i = 0; i < resp.words_count; i++) {
+        ASSERT_EQ(typecast_caption_writer_add(writer, &WORDS[i]), TYPECAST_OK);
+    }
+    /* Closed cues are out already; the last one waits for finish */
+    ASSERT_EQ(typecast_caption_writer_cue_count(writer), 3);
+    ASSERT_EQ(typecast_caption_writer_finish(writer), TYPECAST_OK);
+    ASSERT_EQ(typecast_caption_writer_cue_count(writer), 4);
+    ASSERT_STREQ(sink.data, vtt);
+    typecast_caption_writer_free(writer);
+
+    free(srt);
+    free(vtt);
+}
+
+static void test_characters_and_long_cues(void) {
+    /* 60 one-letter characters: split at 42 codepoints, no separators */
+    TypecastAlignmentSegment chars[60];
+    char letters[60][2];
+    for (int i = 0; i < 60; i++) {
+        letters[i][0] = (char)('a' + i % 26);
+        letters[i][1] = '\0';
+        chars[i].text = letters[i];
+        chars[i].start = 0.05f * (float)i;
+        chars[i].end = 0.05f * (float)i + 0.04f;
+    }
+    TypecastTTSWithTimestampsResponse resp;
+    memset(&resp, 0, sizeof(resp));
+    resp.characters = chars;
+    resp.characters_count = 60;
+
+    char* srt = NULL;
+    ASSERT_EQ(typecast_tts_with_timestamps_response_to_srt(&resp, &srt), TYPECAST_OK);
+    ASSERT(strstr(srt, "\nabcdefghijklmnopqrstuvwxyzabcdefghijklmnop\n\n2\n") != NULL);
+    Sink sink = {{0}, 0, 0, 0};
+    ASSERT_EQ(typecast_tts_with_timestamps_response_write_captions(&resp, TYPECAST_CAPTION_SRT, collect, &sink),
+              TYPECAST_OK);
+    ASSERT_STREQ(sink.data, srt);
+    free(srt);
+
+    /* One segment longer than any cue still becomes one cue */
+    char big[300];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    TypecastAlignmentSegment seg = {big, 0.0f, 1.0f};
+    memset(&sink, 0, sizeof(sink));
+    TypecastCaptionWriter* writer = typecast_caption_writer_create(TYPECAST_CAPTION_SRT,
+        TYPECAST_ALIGNMENT_CHARACTER, collect, &sink);
+    ASSERT_EQ(typecast_caption_writer_add(writer, &seg), TYPECAST_OK);
+    ASSERT_EQ(typecast_caption_writer_finish(writer), TYPECAST_OK);
+    ASSERT(strstr(sink.data, big) != NULL);
+    typecast_caption_writer_free(writer);
+}
+
+static void test_file_output(void) {
+    TypecastTTSWithTimestampsResponse resp = words_response();
+    FILE* file = tmpfile();
+    ASSERT(file != NULL);
+    TypecastCaptionWriter* writer = typecast_caption_writer_create_file(TYPECAST_CAPTION_VTT,
+        TYPECAST_ALIGNMENT_WORD, file);
+    ASSERT(writer != NULL);
+    for (size_t i = 0; i < resp.words_count; i++) typecast_caption_writer_add(writer, &WORDS[i]);
+    ASSERT_EQ(typecast_caption_writer_finish(writer), TYPECAST_OK);
+    typecast_caption_writer_free(writer);
+
+    char data[4096] = {0};
+    rewind(file);
+    size_t n = fread(data, 1, sizeof(data) - 1, file);
+    fclose(file);
+    char* vtt = NULL;
+    ASSERT_EQ(typecast_tts_with_timestamps_response_to_vtt(&resp, &vtt), TYPECAST_OK);
+    ASSERT_EQ(n, strlen(vtt));
+    /* `data` is an array: no null guard, which -Waddress flags */
+    ASSERT(strcmp(data, vtt) == 0);
+    free(vtt);
+
+    /* A stream that cannot be written stops the writer */
+    file = fopen("/dev/null", "r");
+    ASSERT(file != NULL);
+    setvbuf(file, NULL, _IONBF, 0);
+    writer = typecast_caption_writer_create_file(TYPECAST_CAPTION_SRT, TYPECAST_ALIGNMENT_WORD, file);
+    ASSERT_EQ(typecast_caption_writer_add(writer, &WORDS[0]), TYPECAST_OK);
+    ASSERT_EQ(typecast_caption_writer_add(writer, &WORDS[1]), TYPECAST_ERROR_NETWORK);
+    ASSERT_EQ(typecast_caption_writer_finish(writer), TYPECAST_ERROR_NETWORK);
+    typecast_caption_writer_free(writer);
+    fclose(file);
+}
+
+static void test_errors(void) {
+    ASSERT(typecast_caption_writer_create(TYPECAST_CAPTION_SRT, TYPECAST_ALIGNMENT_WORD, NULL, NULL) == NULL);
+    ASSERT(typecast_caption_writer_create_file(TYPECAST_CAPTION_SRT, TYPECAST_ALIGNMENT_WORD, NULL) == NULL);
+    ASSERT_EQ(typecast_caption_writer_add(NULL, &WORDS[0]), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_caption_writer_finish(NULL), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_caption_writer_cue_count(NULL), 0);
+    ASSERT_EQ(typecast_caption_writer_on_segment(TYPECAST_ALIGNMENT_WORD, &WORDS[0], NULL), 1);
+    typecast_caption_writer_free(NULL);
+
+    TypecastTTSWithTimestampsResponse empty;
+    memset(&empty, 0, sizeof(empty));
+    Sink sink = {{0}, 0, 0, 0};
+    ASSERT_EQ(typecast_tts_with_timestamps_response_write_captions(&empty, TYPECAST_CAPTION_SRT, collect, &sink),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_tts_with_timestamps_response_write_captions(NULL, TYPECAST_CAPTION_SRT, collect, &sink),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(sink.len, 0);
+
+    /* Whitespace-only text writes no cue */
+    TypecastCaptionWriter* writer = typecast_caption_writer_create(TYPECAST_CAPTION_VTT,
+        TYPECAST_ALIGNMENT_WORD, collect, &sink);
+    TypecastAlignmentSegment blank = {"   ", 0.0f, 0.5f};
+    TypecastAlignmentSegment null_text = {NULL, 0.5f, 0.6f};
+    ASSERT_EQ(typecast_caption_writer_add(writer, &blank), TYPECAST_OK);
+    ASSERT_EQ(typecast_caption_writer_add(writer, &null_text), TYPECAST_OK);
+    ASSERT_EQ(typecast_caption_writer_add(writer, NULL), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_caption_writer_finish(writer), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(sink.len, 0);
+    typecast_caption_writer_free(writer);
+
+    /* A callback that stops the writer makes it fail from then on */
+    TypecastTTSWithTimestampsResponse resp = words_response();
+    memset(&sink, 0, sizeof(sink));
+    sink.limit = 2;
+    ASSERT_EQ(typecast_tts_with_timestamps_response_write_captions(&resp, TYPECAST_CAPTION_VTT, collect, &sink),
+              TYPECAST_ERROR_CANCELLED);
+    ASSERT_STREQ(sink.data, "WEBVTT\n\n00:00:00.000 --> 00:00:00.900\n");
+}
+
+/* ---- Streaming path ---- */
+
+static const char STREAM_JSON[] =
+    "{\"audio\":\"QVVESU8=\",\"audio_format\":\"wav\",\"audio_duration\":2.0,"
+    "\"words\":[{\"text\":\"Hello\",\"start\":0.0,\"end\":0.4},{\"text\":\"world.\",\"start\":0.5,\"end\":0.9},"
+    "{\"text\":\"Bye.\",\"start\":1.0,\"end\":2.0}],"
+    "\"characters\":[{\"text\":\"H\",\"start\":0.0,\"end\":0.1}]}";
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    (void)req;
+    (void)user_data;
+    resp->body = (const uint8_t*)STREAM_JSON;
+    resp->body_len = strlen(STREAM_JSON);
+    resp->chunk_size = 9;
+}
+
+static void test_streamed_segments(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    char host[64];
+    mock_server_host(&server, host, sizeof(host));
+    TypecastClient* client = typecast_client_create_with_host("test-key", host);
+
+    TypecastTTSRequestWithTimestamps req = {0};
+    req.text = "Hello world. Bye.";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+
+    Sink sink = {{0}, 0, 0, 0};
+    TypecastCaptionWriter* writer = typecast_caption_writer_create(TYPECAST_CAPTION_SRT,
+        TYPECAST_ALIGNMENT_WORD, collect, &sink);
+    /* Character segments are skipped by a word writer */
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, &req, NULL,
+        typecast_caption_writer_on_segment, writer), TYPECAST_OK);
+    ASSERT_EQ(typecast_caption_writer_finish(writer), TYPECAST_OK);
+    typecast_caption_writer_free(writer);
+
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps(client, &req, &resp), TYPECAST_OK);
+    char* srt = NULL;
+    ASSERT_EQ(typecast_tts_with_timestamps_response_to_srt(resp, &srt), TYPECAST_OK);
+    ASSERT_STREQ(sink.data, srt);
+    ASSERT(strstr(srt, "2\n00:00:01,000 --> 00:00:02,000\nBye.\n\n") != NULL);
+    free(srt);
+    typecast_tts_with_timestamps_response_free(resp);
+
+    /* A writer failure aborts the request */
+    memset(&sink, 0, sizeof(sink));
+    sink.limit = 1;
+    writer = typecast_caption_writer_create(TYPECAST_CAPTION_SRT, TYPECAST_ALIGNMENT_WORD, collect, &sink);
+    ASSERT(typecast_text_to_speech_with_timestamps_stream(client, &req, NULL,
+        typecast_caption_writer_on_segment, writer) != TYPECAST_OK);
+    ASSERT_EQ(typecast_caption_writer_finish(writer), TYPECAST_ERROR_CANCELLED);
+    typecast_caption_writer_free(writer);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Caption Writer Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(writer_matches_string_helpers);
+    RUN(characters_and_long_cues);
+    RUN(file_output);
+    RUN(errors);
+    RUN(streamed_segments);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
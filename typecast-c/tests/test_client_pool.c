@@ -0,0 +1,448 @@
+/**
+ * Client options tests: thread-safe mode (handle pool, shared caches,
+ * per-thread errors), connection reuse and warm-up
+ */
+
+#define _GNU_SOURCE  /* memmem, pthread_barrier_t */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_STREQ(a, b) ASSERT((a) && strcmp((a), (b)) == 0)
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+#define THREADS 4
+#define CALLS_PER_THREAD 5
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    (void)user_data;
+    if (req->body && strstr(req->body, "unauthorized")) {
+        static const char detail[] = "{\"detail\":\"bad key\"}";
+        resp->status = 401;
+        resp->body = (const uint8_t*)detail;
+        resp->body_len = strlen(detail);
+        return;
+    }
+    if (strcmp(req->path, "/v1/users/me/subscription") == 0) {
+        static const char sub[] =
+            "{\"plan\":\"plus\",\"credits\":{\"plan_credits\":100,\"used_credits\":1},"
+            "\"limits\":{\"concurrency_limit\":4}}";
+        resp->body = (const uint8_t*)sub;
+        resp->body_len = strlen(sub);
+        return;
+    }
+    if (strcmp(req->path, "/v2/voices") == 0) {
+        static const char voices[] = "[]";
+        resp->body = (const uint8_t*)voices;
+        resp->body_len = strlen(voices);
+        return;
+    }
+    resp->body = (const uint8_t*)req->body;
+    resp->body_len = req->body_len;
+}
+
+static TypecastClient* new_client(MockServer* server, const TypecastClientOptions* options) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options);
+}
+
+typedef struct {
+    TypecastClient* client;
+    int index;
+    int ok;
+} Worker;
+
+static void* worker_main(void* arg) {
+    Worker* worker = (Worker*)arg;
+    char text[64];
+    for (int i = 0; i < CALLS_PER_THREAD; i++) {
+        snprintf(text, sizeof(text), "thread %d call %d", worker->index, i);
+        TypecastTTSRequest req = {0};
+        req.text = text;
+        req.voice_id = "tc_voice";
+        req.model = TYPECAST_MODEL_SSFM_V30;
+        TypecastTTSResponse* resp = typecast_text_to_speech(worker->client, &req);
+        if (resp && resp->audio_size > strlen(text) &&
+            memmem(resp->audio_data, resp->audio_size, text, strlen(text))) {
+            worker->ok++;
+        }
+        typecast_tts_response_free(resp);
+    }
+    return NULL;
+}
+
+static void test_options_null_matches_default_client(void) {
+    TypecastClient* client = typecast_client_create_with_options("test-key", "http://127.0.0.1:1", NULL);
+    ASSERT(client != NULL);
+    ASSERT(typecast_client_get_error(client) != NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_OK);
+    typecast_client_destroy(client);
+
+    TypecastClientOptions options = {0};
+    ASSERT(typecast_client_create_with_options("", NULL, &options) == NULL);
+}
+
+static void test_shared_client_across_threads(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    TypecastClient* client = new_client(&server, &options);
+    ASSERT(client != NULL);
+
+    pthread_t threads[THREADS];
+    Worker workers[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        workers[i].client = client;
+        workers[i].index = i;
+        workers[i].ok = 0;
+        pthread_create(&threads[i], NULL, worker_main, &workers[i]);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        ASSERT_EQ(workers[i].ok, CALLS_PER_THREAD);
+    }
+
+    /* Warm connections are shared between threads instead of one per call */
+    ASSERT_EQ(server.requests, THREADS * CALLS_PER_THREAD);
+    ASSERT(server.connections <= THREADS);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+#define WIDE_THREADS 12
+
+static void test_connections_kept_for_every_thread(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    /* First wave all in flight at once: one connection per thread */
+    server.hold_until = WIDE_THREADS;
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    options.max_idle_handles = WIDE_THREADS;
+    TypecastClient* client = new_client(&server, &options);
+    ASSERT(client != NULL);
+
+    pthread_t threads[WIDE_THREADS];
+    Worker workers[WIDE_THREADS];
+    for (int i = 0; i < WIDE_THREADS; i++) {
+        workers[i].client = client;
+        workers[i].index = i;
+        workers[i].ok = 0;
+        pthread_create(&threads[i], NULL, worker_main, &workers[i]);
+    }
+    for (int i = 0; i < WIDE_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        ASSERT_EQ(workers[i].ok, CALLS_PER_THREAD);
+    }
+
+    /* The shared cache keeps as many connections as the pool keeps
+     * handles, not libcurl's default of 5 */
+    ASSERT_EQ(server.requests, WIDE_THREADS * CALLS_PER_THREAD);
+    ASSERT_EQ(server.connections, WIDE_THREADS);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+typedef struct {
+    TypecastClient* client;
+    const char* text;
+    TypecastErrorCode seen;
+    char message[64];
+} ErrorWorker;
+
+static pthread_barrier_t error_barrier;
+
+static void* error_worker_main(void* arg) {
+    ErrorWorker* worker = (ErrorWorker*)arg;
+    TypecastTTSRequest req = {0};
+    req.text = worker->text;
+    req.voice_id = "tc_voice";
+    typecast_tts_response_free(typecast_text_to_speech(worker->client, &req));
+    /* Both threads have made their call before either reads its error */
+    pthread_barrier_wait(&error_barrier);
+    const TypecastError* error = typecast_client_get_error(worker->client);
+    worker->seen = error->code;
+    snprintf(worker->message, sizeof(worker->message), "%s", error->message ? error->message : "");
+    return NULL;
+}
+
+static void test_errors_are_per_thread(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    options.max_idle_handles = 1;
+    TypecastClient* client = new_client(&server, &options);
+
+    pthread_barrier_init(&error_barrier, NULL, 2);
+    ErrorWorker failing = {client, "unauthorized", TYPECAST_OK, ""};
+    ErrorWorker passing = {client, "hello", TYPECAST_OK, ""};
+    pthread_t a, b;
+    pthread_create(&a, NULL, error_worker_main, &failing);
+    pthread_create(&b, NULL, error_worker_main, &passing);
+    pthread_join(a, NULL);
+    pthread_join(b, NULL);
+    pthread_barrier_destroy(&error_barrier);
+
+    ASSERT_EQ(failing.seen, TYPECAST_ERROR_UNAUTHORIZED);
+    ASSERT_STREQ(failing.message, "bad key");
+    ASSERT_EQ(passing.seen, TYPECAST_OK);
+    /* The main thread has its own, untouched error */
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_OK);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+typedef struct {
+    TypecastClient* client;
+    TypecastErrorCode first;
+    TypecastErrorCode after_turnover;
+} TurnoverWorker;
+
+static void* turnover_worker_main(void* arg) {
+    TurnoverWorker* worker = (TurnoverWorker*)arg;
+    TypecastTTSRequest req = {0};
+    req.text = "unauthorized";
+    req.voice_id = "tc_voice";
+    typecast_tts_response_free(typecast_text_to_speech(worker->client, &req));
+    worker->first = typecast_client_get_error(worker->client)->code;
+    pthread_barrier_wait(&error_barrier);
+    /* The main thread destroys the client and creates the next one */
+    pthread_barrier_wait(&error_barrier);
+    worker->after_turnover = typecast_client_get_error(worker->client)->code;
+    return NULL;
+}
+
+/* A thread that outlives a client never sees its old error in the next
+ * client, even when that client reuses the thread-local key */
+static void test_errors_do_not_outlive_the_client(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    TurnoverWorker worker = {new_client(&server, &options), TYPECAST_OK, TYPECAST_OK};
+
+    pthread_barrier_init(&error_barrier, NULL, 2);
+    pthread_t thread;
+    pthread_create(&thread, NULL, turnover_worker_main, &worker);
+    pthread_barrier_wait(&error_barrier);
+    TypecastTTSRequest req = {0};
+    req.text = "unauthorized";
+    req.voice_id = "tc_voice";
+    typecast_tts_response_free(typecast_text_to_speech(worker.client, &req));
+    typecast_client_destroy(worker.client);
+    worker.client = new_client(&server, &options);
+    pthread_barrier_wait(&error_barrier);
+    pthread_join(thread, NULL);
+    pthread_barrier_destroy(&error_barrier);
+
+    ASSERT_EQ(worker.first, TYPECAST_ERROR_UNAUTHORIZED);
+    ASSERT_EQ(worker.after_turnover, TYPECAST_OK);
+    ASSERT_EQ(typecast_client_get_error(worker.client)->code, TYPECAST_OK);
+
+    /* Threads that exit leave nothing behind (checked by the ASan build) */
+    for (int round = 0; round < 8; round++) {
+        ErrorWorker failing = {worker.client, "unauthorized", TYPECAST_OK, ""};
+        pthread_barrier_init(&error_barrier, NULL, 1);
+        pthread_create(&thread, NULL, error_worker_main, &failing);
+        pthread_join(thread, NULL);
+        pthread_barrier_destroy(&error_barrier);
+        ASSERT_EQ(failing.seen, TYPECAST_ERROR_UNAUTHORIZED);
+    }
+
+    typecast_client_destroy(worker.client);
+    mock_server_stop(&server);
+}
+
+static void test_pooled_handles_serve_every_endpoint(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    TypecastClient* client = new_client(&server, &options);
+
+    TypecastSubscription* sub = typecast_get_my_subscription(client);
+    ASSERT(sub != NULL);
+    ASSERT_EQ(sub->limits.concurrency_limit, 4);
+    typecast_subscription_free(sub);
+
+    TypecastTTSRequest req = {0};
+    req.text = "async on a pooled client";
+    req.voice_id = "tc_voice";
+    TypecastAsyncJob* job = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    ASSERT_EQ(typecast_async_wait(client, job), TYPECAST_OK);
+    typecast_async_job_free(job);
+
+    ASSERT(typecast_text_to_speech(client, NULL) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INVALID_PARAM);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+typedef struct {
+    char methods[8][16];
+    char agents[8][256];
+    int has_content_type[8];
+    int count;
+} RequestLog;
+
+static void logging_route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    RequestLog* log = (RequestLog*)user_data;
+    if (log->count < 8) {
+        snprintf(log->methods[log->count], sizeof(log->methods[0]), "%s", req->method);
+        const char* agent = strstr(req->headers, "User-Agent: ");
+        const char* end = agent ? strstr(agent, "\r\n") : NULL;
+        if (agent && end) {
+            snprintf(log->agents[log->count], sizeof(log->agents[0]), "%.*s", (int)(end - agent), agent);
+        }
+        log->has_content_type[log->count] = strstr(req->headers, "Content-Type: application/json") != NULL;
+        log->count++;
+    }
+    route(req, resp, NULL);
+}
+
+static void run_mixed_calls(TypecastClient* client) {
+    TypecastTTSRequest req = {0};
+    req.text = "first";
+    req.voice_id = "tc_voice";
+    typecast_tts_response_free(typecast_text_to_speech(client, &req));
+    typecast_subscription_free(typecast_get_my_subscription(client));
+    typecast_tts_response_free(typecast_text_to_speech(client, &req));
+    typecast_delete_voice(client, "tc_voice");
+}
+
+static void test_connection_reused_across_calls(void) {
+    MockServer server;
+    RequestLog log = {0};
+    ASSERT(mock_server_start(&server, logging_route, &log));
+    TypecastClient* client = new_client(&server, NULL);
+
+    run_mixed_calls(client);
+    ASSERT_EQ(server.requests, 4);
+    ASSERT_EQ(server.connections, 1);
+
+    /* Per-request options do not leak from one call into the next */
+    ASSERT_STREQ(log.methods[0], "POST");
+    ASSERT_STREQ(log.methods[1], "GET");
+    ASSERT_STREQ(log.methods[2], "POST");
+    ASSERT_STREQ(log.methods[3], "DELETE");
+    ASSERT(log.has_content_type[0] && !log.has_content_type[1]);
+    ASSERT(strstr(log.agents[0], "timeout=60s") != NULL);
+    ASSERT(strstr(log.agents[1], "timeout=30s") != NULL);
+    ASSERT(strstr(log.agents[1], "base=custom") != NULL);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_connection_reuse_can_be_disabled(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClientOptions options = {0};
+    options.disable_connection_reuse = 1;
+    options.disable_tcp_keepalive = 1;
+    options.http_version = TYPECAST_HTTP_VERSION_1_1;
+    options.max_connection_idle_secs = 5;
+    TypecastClient* client = new_client(&server, &options);
+
+    run_mixed_calls(client);
+    ASSERT_EQ(server.requests, 4);
+    ASSERT_EQ(server.connections, 4);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+static void test_warmup_leaves_a_warm_connection(void) {
+    ASSERT_EQ(typecast_global_init(), TYPECAST_OK);
+    ASSERT_EQ(typecast_global_init(), TYPECAST_OK);
+    typecast_global_cleanup();
+
+    for (int thread_safe = 0; thread_safe <= 1; thread_safe++) {
+        MockServer server;
+        RequestLog log = {0};
+        ASSERT(mock_server_start(&server, logging_route, &log));
+        TypecastClientOptions options = {0};
+        options.thread_safe = thread_safe;
+        options.voice_cache_ttl_secs = 60;
+        TypecastClient* client = new_client(&server, &options);
+
+        ASSERT_EQ(typecast_client_warmup(client, 1), TYPECAST_OK);
+        ASSERT_EQ(server.requests, 2);
+        ASSERT_STREQ(log.methods[0], "HEAD");
+        ASSERT_STREQ(log.methods[1], "GET");
+
+        /* The catalog is cached and the request goes out on the same connection */
+        TypecastVoicesResponse* voices = typecast_get_voices(client, NULL);
+        ASSERT(voices != NULL);
+        typecast_voices_response_free(voices);
+        TypecastTTSRequest req = {0};
+        req.text = "after warmup";
+        req.voice_id = "tc_voice";
+        TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+        ASSERT(resp != NULL);
+        ASSERT(memmem(resp->audio_data, resp->audio_size, "after warmup", 12) != NULL);
+        typecast_tts_response_free(resp);
+        ASSERT_EQ(server.requests, 3);
+        ASSERT_STREQ(log.methods[2], "POST");
+        ASSERT_EQ(server.connections, 1);
+
+        typecast_client_destroy(client);
+        mock_server_stop(&server);
+    }
+
+    TypecastClient* offline = typecast_client_create_with_host("test-key", "http://127.0.0.1:1");
+    ASSERT_EQ(typecast_client_warmup(offline, 0), TYPECAST_ERROR_NETWORK);
+    ASSERT_EQ(typecast_client_get_error(offline)->code, TYPECAST_ERROR_NETWORK);
+    typecast_client_destroy(offline);
+    ASSERT_EQ(typecast_client_warmup(NULL, 0), TYPECAST_ERROR_INVALID_PARAM);
+    typecast_global_cleanup();
+    typecast_global_cleanup();   /* unpaired: no-op */
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Client Options Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(options_null_matches_default_client);
+    RUN(shared_client_across_threads);
+    RUN(connections_kept_for_every_thread);
+    RUN(errors_are_per_thread);
+    RUN(errors_do_not_outlive_the_client);
+    RUN(pooled_handles_serve_every_endpoint);
+    RUN(connection_reused_across_calls);
+    RUN(connection_reuse_can_be_disabled);
+    RUN(warmup_leaves_a_warm_connection);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
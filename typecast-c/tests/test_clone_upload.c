@@ -0,0 +1,359 @@
+/**
+ * Streaming clone upload tests: samples read from a file, a descriptor or
+ * a callback while the request is sent, with upload progress
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+#define SAMPLE_SIZE (48 * 1024)
+
+static const char CLONE_JSON[] = "{\"voice_id\":\"uc_stream\",\"name\":\"Demo\",\"model\":\"ssfm-v30\"}";
+
+typedef struct {
+    pthread_mutex_t lock;
+    char* body;                      /* last request body */
+    size_t body_len;
+    int requests;
+} Plan;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = (Plan*)user_data;
+    pthread_mutex_lock(&plan->lock);
+    free(plan->body);
+    plan->body = (char*)malloc(req->body_len + 1);
+    if (plan->body) {
+        memcpy(plan->body, req->body, req->body_len);
+        plan->body[req->body_len] = '\0';
+    }
+    plan->body_len = req->body_len;
+    plan->requests++;
+    pthread_mutex_unlock(&plan->lock);
+    resp->body = (const uint8_t*)CLONE_JSON;
+    resp->body_len = strlen(CLONE_JSON);
+}
+
+typedef struct {
+    MockServer server;
+    Plan plan;
+    TypecastClient* client;
+    uint8_t sample[SAMPLE_SIZE];
+    char path[64];
+} Fixture;
+
+static void setup(Fixture* f) {
+    memset(f, 0, sizeof(*f));
+    pthread_mutex_init(&f->plan.lock, NULL);
+    mock_server_start(&f->server, route, &f->plan);
+    char host[64];
+    mock_server_host(&f->server, host, sizeof(host));
+    f->client = typecast_client_create_with_host("test-key", host);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < SAMPLE_SIZE; i++) {
+        seed = seed * 1103515245u + 12345u;
+        f->sample[i] = (uint8_t)(seed >> 16);
+    }
+    snprintf(f->path, sizeof(f->path), "/tmp/typecast-clone-%d.wav", (int)getpid());
+    FILE* file = fopen(f->path, "wb");
+    if (file) {
+        fwrite(f->sample, 1, sizeof(f->sample), file);
+        fclose(file);
+    }
+}
+
+static void teardown(Fixture* f) {
+    typecast_client_destroy(f->client);
+    mock_server_stop(&f->server);
+    free(f->plan.body);
+    pthread_mutex_destroy(&f->plan.lock);
+    unlink(f->path);
+}
+
+/* The bytes of `part` appear in the request body */
+static int body_contains(const Plan* plan, const void* part, size_t len) {
+    if (!plan->body || len > plan->body_len) return 0;
+    for (size_t i = 0; i + len <= plan->body_len; i++) {
+        if (memcmp(plan->body + i, part, len) == 0) return 1;
+    }
+    return 0;
+}
+
+static void test_clone_from_file(void) {
+    Fixture f;
+    setup(&f);
+    TypecastCustomVoice out;
+    ASSERT_EQ(typecast_clone_voice_from_file(f.client, f.path, "Demo", "ssfm-v30", &out), TYPECAST_OK);
+    ASSERT(strcmp(out.voice_id, "uc_stream") == 0);
+    ASSERT(body_contains(&f.plan, f.sample, sizeof(f.sample)));
+    char disposition[96];
+    snprintf(disposition, sizeof(disposition), "filename=\"%s\"", strrchr(f.path, '/') + 1);
+    ASSERT(body_contains(&f.plan, disposition, strlen(disposition)));
+    ASSERT(body_contains(&f.plan, "audio/wav", 9));
+    teardown(&f);
+}
+
+static void test_clone_from_memory_streams_the_buffer(void) {
+    Fixture f;
+    setup(&f);
+    TypecastCustomVoice out;
+    ASSERT_EQ(typecast_clone_voice(f.client, f.sample, sizeof(f.sample), "sample.wav", "Demo", "ssfm-v30", &out),
+              TYPECAST_OK);
+    ASSERT(strcmp(out.voice_id, "uc_stream") == 0);
+    ASSERT(body_contains(&f.plan, f.sample, sizeof(f.sample)));
+    ASSERT(body_contains(&f.plan, "filename=\"sample.wav\"", 21));
+    ASSERT(body_contains(&f.plan, "audio/wav", 9));
+    teardown(&f);
+}
+
+static void test_filename_hint_overrides_path(void) {
+    Fixture f;
+    setup(&f);
+    TypecastCloneSource source = {0};
+    source.path = f.path;
+    source.filename = "voice.mp3";
+    TypecastCustomVoice out;
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, &source, "Demo", "ssfm-v30", &out), TYPECAST_OK);
+    ASSERT(body_contains(&f.plan, "filename=\"voice.mp3\"", 20));
+    ASSERT(body_contains(&f.plan, "audio/mpeg", 10));
+    teardown(&f);
+}
+
+static void test_clone_from_fd_starts_at_offset(void) {
+    Fixture f;
+    setup(&f);
+    int fd = open(f.path, O_RDONLY);
+    ASSERT(fd >= 0);
+    ASSERT_EQ(lseek(fd, 1024, SEEK_SET), 1024);
+    TypecastCustomVoice out;
+    ASSERT_EQ(typecast_clone_voice_from_fd(f.client, fd, "clip.ogg", "Demo", "ssfm-v30", &out), TYPECAST_OK);
+    ASSERT(body_contains(&f.plan, f.sample + 1024, sizeof(f.sample) - 1024));
+    ASSERT(!body_contains(&f.plan, f.sample, 64));
+    ASSERT(body_contains(&f.plan, "audio/ogg", 9));
+    /* The descriptor stays open */
+    ASSERT_EQ(lseek(fd, 0, SEEK_CUR), (off_t)sizeof(f.sample));
+    close(fd);
+    teardown(&f);
+}
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    size_t chunk;                    /* largest read answered */
+    size_t abort_at;                 /* non-zero: abort once this much was read */
+    int calls;
+} Reader;
+
+static size_t read_chunks(char* buffer, size_t size, void* user_data) {
+    Reader* r = (Reader*)user_data;
+    r->calls++;
+    if (r->abort_at && r->offset >= r->abort_at) return TYPECAST_READ_ABORT;
+    size_t n = r->size - r->offset;
+    if (n > size) n = size;
+    if (n > r->chunk) n = r->chunk;
+    memcpy(buffer, r->data + r->offset, n);
+    r->offset += n;
+    return n;
+}
+
+typedef struct {
+    uint64_t sent;
+    uint64_t total;
+    int calls;
+    int monotonic;
+    uint64_t abort_after;            /* non-zero: abort once this much was sent */
+} Progress;
+
+static int on_progress(uint64_t sent, uint64_t total, void* user_data) {
+    Progress* p = (Progress*)user_data;
+    if (sent < p->sent) p->monotonic = 0;
+    p->sent = sent;
+    p->total = total;
+    p->calls++;
+    return p->abort_after && sent >= p->abort_after;
+}
+
+static void test_clone_from_callback_reports_progress(void) {
+    Fixture f;
+    setup(&f);
+    Reader reader = {f.sample, sizeof(f.sample), 0, 1000, 0, 0};
+    Progress progress = {0, 0, 0, 1, 0};
+    TypecastCloneSource source = {0};
+    source.read = read_chunks;
+    source.read_user_data = &reader;
+    source.size = sizeof(f.sample);
+    source.filename = "remote.flac";
+    source.on_progress = on_progress;
+    source.progress_user_data = &progress;
+    TypecastCustomVoice out;
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, &source, "Demo", "ssfm-v30", &out), TYPECAST_OK);
+
+    ASSERT(reader.calls > 1);
+    ASSERT(body_contains(&f.plan, f.sample, sizeof(f.sample)));
+    ASSERT(body_contains(&f.plan, "audio/flac", 10));
+    ASSERT(progress.calls >= 1);
+    ASSERT(progress.monotonic);
+    ASSERT_EQ(progress.total, (uint64_t)f.plan.body_len);
+    ASSERT_EQ(progress.sent, progress.total);
+    teardown(&f);
+}
+
+static void test_read_callback_abort(void) {
+    Fixture f;
+    setup(&f);
+    Reader reader = {f.sample, sizeof(f.sample), 0, 4096, 8192, 0};
+    TypecastCloneSource source = {0};
+    source.read = read_chunks;
+    source.read_user_data = &reader;
+    source.size = sizeof(f.sample);
+    TypecastCustomVoice out;
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, &source, "Demo", "ssfm-v30", &out), TYPECAST_ERROR_NETWORK);
+    ASSERT(strstr(typecast_client_get_error(f.client)->message, "aborted") != NULL);
+    ASSERT_EQ(f.plan.requests, 0);
+    teardown(&f);
+}
+
+static void test_progress_callback_abort(void) {
+    Fixture f;
+    setup(&f);
+    Progress progress = {0, 0, 0, 1, 1};
+    TypecastCloneSource source = {0};
+    source.path = f.path;
+    source.on_progress = on_progress;
+    source.progress_user_data = &progress;
+    TypecastCustomVoice out;
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, &source, "Demo", "ssfm-v30", &out), TYPECAST_ERROR_NETWORK);
+    ASSERT(strstr(typecast_client_get_error(f.client)->message, "aborted") != NULL);
+    teardown(&f);
+}
+
+static void test_short_read(void) {
+    Fixture f;
+    setup(&f);
+    Reader reader = {f.sample, 100, 0, 4096, 0, 0};
+    TypecastCloneSource source = {0};
+    source.read = read_chunks;
+    source.read_user_data = &reader;
+    source.size = sizeof(f.sample);
+    TypecastCustomVoice out;
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, &source, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(strstr(typecast_client_get_error(f.client)->message, "fewer bytes") != NULL);
+    teardown(&f);
+}
+
+static void test_invalid_sources(void) {
+    Fixture f;
+    setup(&f);
+    TypecastCustomVoice out;
+    Reader reader = {f.sample, sizeof(f.sample), 0, 4096, 0, 0};
+    TypecastCloneSource source = {0};
+    ASSERT_EQ(typecast_clone_voice_from_source(NULL, &source, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, NULL, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, &source, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    source.path = f.path;
+    source.read = read_chunks;
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, &source, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    /* A callback without a size has nothing to send */
+    source.path = NULL;
+    source.read_user_data = &reader;
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, &source, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(strstr(typecast_client_get_error(f.client)->message, "required") != NULL);
+    /* The usual name checks still apply */
+    source.size = sizeof(f.sample);
+    ASSERT_EQ(typecast_clone_voice_from_source(f.client, &source, "", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+
+    ASSERT_EQ(typecast_clone_voice_from_file(NULL, f.path, "Demo", "ssfm-v30", &out), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_clone_voice_from_file(f.client, NULL, "Demo", "ssfm-v30", &out), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_clone_voice_from_file(f.client, "/tmp", "Demo", "ssfm-v30", &out), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_clone_voice_from_file(f.client, "/nonexistent/clip.wav", "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+
+    ASSERT_EQ(typecast_clone_voice_from_fd(NULL, 0, NULL, "Demo", "ssfm-v30", &out), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_clone_voice_from_fd(f.client, -1, NULL, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    int pipe_fds[2];
+    ASSERT(pipe(pipe_fds) == 0);
+    ASSERT_EQ(typecast_clone_voice_from_fd(f.client, pipe_fds[0], NULL, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    ASSERT_EQ(f.plan.requests, 0);
+    teardown(&f);
+}
+
+static void test_size_limits_checked_before_sending(void) {
+    Fixture f;
+    setup(&f);
+    TypecastCustomVoice out;
+    /* A sparse file just past the limit */
+    int fd = open(f.path, O_RDWR | O_TRUNC);
+    ASSERT(fd >= 0);
+    ASSERT(ftruncate(fd, (off_t)TYPECAST_CLONING_MAX_FILE_SIZE + 1) == 0);
+    ASSERT_EQ(typecast_clone_voice_from_file(f.client, f.path, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(strstr(typecast_client_get_error(f.client)->message, "25 MB") != NULL);
+    ASSERT_EQ(typecast_clone_voice_from_fd(f.client, fd, NULL, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(ftruncate(fd, 0) == 0);
+    ASSERT_EQ(typecast_clone_voice_from_fd(f.client, fd, NULL, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_clone_voice_from_file(f.client, f.path, "Demo", "ssfm-v30", &out),
+              TYPECAST_ERROR_INVALID_PARAM);
+    close(fd);
+    ASSERT_EQ(f.plan.requests, 0);
+    teardown(&f);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Streaming Clone Upload Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(clone_from_file);
+    RUN(clone_from_memory_streams_the_buffer);
+    RUN(filename_hint_overrides_path);
+    RUN(clone_from_fd_starts_at_offset);
+    RUN(clone_from_callback_reports_progress);
+    RUN(read_callback_abort);
+    RUN(progress_callback_abort);
+    RUN(short_read);
+    RUN(invalid_sources);
+    RUN(size_limits_checked_before_sending);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -106,6 +106,51 @@ static void test_parse_pause_markup_preserves_invalid_tokens(void) {
     typecast_speech_parts_free(parts, count);
 }
 
+static void test_pause_markup_spans_match_parts(void) {
+    const char* inputs[] = {
+        "a<|0.3s|>b<|abc|>c<|3s|>", "<|<|1.5s|>x", "tail<|1s", "x<|1s|", "<|0s|>", "<|1.2.3s|>",
+        "", "<|2s|><|1s|>", "<|s|>", "<<||1s|>|>", "<|12345678901234567890123456789012345678901234567890123456789012s|>",
+    };
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        TypecastSpeechPart* parts = NULL;
+        size_t count = 0;
+        ASSERT_EQ(typecast_parse_pause_markup(inputs[i], &parts, &count), TYPECAST_OK);
+        TypecastSpeechSpan spans[8];
+        size_t span_count = 0;
+        ASSERT_EQ(typecast_parse_pause_markup_spans(inputs[i], spans, 8, &span_count), TYPECAST_OK);
+        ASSERT_EQ(span_count, count);
+        for (size_t j = 0; j < count; j++) {
+            ASSERT_EQ(spans[j].is_pause, parts[j].is_pause);
+            ASSERT(spans[j].pause_seconds == parts[j].pause_seconds);
+            if (parts[j].is_pause) continue;
+            ASSERT_EQ(spans[j].length, strlen(parts[j].text));
+            ASSERT(memcmp(inputs[i] + spans[j].offset, parts[j].text, spans[j].length) == 0);
+        }
+        typecast_speech_parts_free(parts, count);
+    }
+
+    /* A long script is measured without a buffer, then filled */
+    size_t pauses = 1000;
+    char* script = (char*)malloc(pauses * 10 + 1);
+    ASSERT(script != NULL);
+    size_t len = 0;
+    for (size_t i = 0; i < pauses; i++) len += (size_t)sprintf(script + len, "ab<|1.5s|>");
+    size_t total = 0;
+    ASSERT_EQ(typecast_parse_pause_markup_spans(script, NULL, 0, &total), TYPECAST_OK);
+    ASSERT_EQ(total, pauses * 2 + 1);
+    TypecastSpeechSpan few[3];
+    ASSERT_EQ(typecast_parse_pause_markup_spans(script, few, 3, &total), TYPECAST_OK);
+    ASSERT_EQ(total, pauses * 2 + 1);
+    ASSERT(few[1].is_pause && few[1].pause_seconds == 1.5f && few[1].offset == 2);
+    ASSERT_EQ(few[2].offset, 10);
+    ASSERT_EQ(few[2].length, 2);
+    free(script);
+
+    ASSERT_EQ(typecast_parse_pause_markup_spans(NULL, NULL, 0, &total), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_parse_pause_markup_spans("x", NULL, 2, &total), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_parse_pause_markup_spans("x", NULL, 0, NULL), TYPECAST_ERROR_INVALID_PARAM);
+}
+
 static void test_segment_requests_merge_defaults_and_overrides(void) {
     TypecastClient* client = typecast_client_create_with_host("test-key", "http://localhost:1");
     TypecastSpeechComposer* composer = typecast_speech_composer_create(client);
@@ -275,6 +320,7 @@ static void test_generate_propagates_network_and_http_errors(void) {
 
 int main(void) {
     RUN(parse_pause_markup_preserves_invalid_tokens);
+    RUN(pause_markup_spans_match_parts);
     RUN(segment_requests_merge_defaults_and_overrides);
     RUN(generate_uses_compose_api_once);
     RUN(generate_uses_response_content_type);
@@ -0,0 +1,274 @@
+/**
+ * Parallel composer tests: segments generated concurrently, stitched
+ * into one WAV in order, and reused from the composer's segment cache
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_STREQ(a, b) ASSERT((a) && strcmp((a), (b)) == 0)
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+/* Segment "segN" renders as 10*N mono 16-bit frames of value N at 1 kHz.
+ * Lower-numbered segments answer last, so stitching must restore order. */
+typedef struct {
+    uint8_t wav[4096];
+} SegmentAudio;
+
+static size_t build_segment_wav(uint8_t* out, int value, int frames, uint32_t sample_rate) {
+    uint32_t data_size = (uint32_t)frames * 2;
+    memcpy(out, "RIFF", 4);
+    uint32_t riff = 36 + data_size;
+    memcpy(out + 4, &riff, 4);
+    memcpy(out + 8, "WAVEfmt ", 8);
+    uint32_t fmt_size = 16;
+    uint16_t pcm = 1, channels = 1, block = 2, bits = 16;
+    uint32_t byte_rate = sample_rate * 2;
+    memcpy(out + 16, &fmt_size, 4);
+    memcpy(out + 20, &pcm, 2);
+    memcpy(out + 22, &channels, 2);
+    memcpy(out + 24, &sample_rate, 4);
+    memcpy(out + 28, &byte_rate, 4);
+    memcpy(out + 32, &block, 2);
+    memcpy(out + 34, &bits, 2);
+    memcpy(out + 36, "data", 4);
+    memcpy(out + 40, &data_size, 4);
+    for (int i = 0; i < frames; i++) {
+        int16_t sample = (int16_t)value;
+        memcpy(out + 44 + i * 2, &sample, 2);
+    }
+    return 44 + data_size;
+}
+
+static void segment_route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    SegmentAudio* slots = (SegmentAudio*)user_data;
+    const char* text = req->body ? strstr(req->body, "\"text\":\"") : NULL;
+    if (!text) {
+        resp->status = 400;
+        return;
+    }
+    text += strlen("\"text\":\"");
+    if (strncmp(text, "fail", 4) == 0) {
+        resp->status = 500;
+        return;
+    }
+    if (strncmp(text, "mp3", 3) == 0) {
+        static const char not_wav[] = "ID3-not-a-wav";
+        resp->body = (const uint8_t*)not_wav;
+        resp->body_len = strlen(not_wav);
+        return;
+    }
+    int value = (text[0] == 'h') ? 9 : atoi(text + 3);   /* "segN" or "hz..." */
+    uint32_t rate = (text[0] == 'h') ? 2000 : 1000;
+    if (value < 1 || value > 9) value = 1;
+    resp->delay_ms = (10 - value) * 20;
+    resp->body = slots[value].wav;
+    resp->body_len = build_segment_wav(slots[value].wav, value, value * 10, rate);
+}
+
+static TypecastSpeechComposer* segment_composer(TypecastClient* client) {
+    TypecastSpeechComposer* composer = typecast_speech_composer_create(client);
+    TypecastComposerSettings defaults = {0};
+    defaults.voice_id = "voice-a";
+    typecast_speech_composer_defaults(composer, &defaults);
+    return composer;
+}
+
+static void test_generate_parallel_stitches_segments_in_order(void) {
+    static SegmentAudio slots[10];
+    MockServer server;
+    ASSERT(mock_server_start(&server, segment_route, slots));
+    server.hold_until = 3;
+    char host[64];
+    mock_server_host(&server, host, sizeof(host));
+    TypecastClient* client = typecast_client_create_with_host("test-key", host);
+    TypecastSpeechComposer* composer = segment_composer(client);
+    ASSERT_EQ(typecast_speech_composer_say(composer, "seg1", NULL), TYPECAST_OK);
+    ASSERT_EQ(typecast_speech_composer_pause(composer, 0.005f), TYPECAST_OK);
+    ASSERT_EQ(typecast_speech_composer_say(composer, "seg2<|0.01s|>seg3", NULL), TYPECAST_OK);
+
+    TypecastTTSResponse* response = typecast_speech_composer_generate_parallel(composer, 3);
+    ASSERT(response != NULL);
+    ASSERT(server.max_active >= 3);
+    ASSERT_EQ(server.requests, 3);
+    ASSERT_EQ(response->format, TYPECAST_AUDIO_FORMAT_WAV);
+
+    /* 10 + 5 (pause) + 20 + 10 (pause) + 30 frames */
+    const int expected_runs[][2] = {{1, 10}, {0, 5}, {2, 20}, {0, 10}, {3, 30}};
+    ASSERT_EQ(response->audio_size, 44 + 75 * 2);
+    ASSERT(memcmp(response->audio_data, "RIFF", 4) == 0);
+    uint32_t data_size = 0;
+    memcpy(&data_size, response->audio_data + 40, 4);
+    ASSERT_EQ(data_size, 75 * 2);
+    ASSERT(response->duration > 0.0749f && response->duration < 0.0751f);
+    const uint8_t* cursor = response->audio_data + 44;
+    for (size_t run = 0; run < 5; run++) {
+        for (int i = 0; i < expected_runs[run][1]; i++) {
+            int16_t sample;
+            memcpy(&sample, cursor, 2);
+            ASSERT_EQ(sample, expected_runs[run][0]);
+            cursor += 2;
+        }
+    }
+
+    typecast_tts_response_free(response);
+    typecast_speech_composer_destroy(composer);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_generate_parallel_reports_segment_errors(void) {
+    static SegmentAudio slots[10];
+    MockServer server;
+    ASSERT(mock_server_start(&server, segment_route, slots));
+    char host[64];
+    mock_server_host(&server, host, sizeof(host));
+    TypecastClient* client = typecast_client_create_with_host("test-key", host);
+
+    TypecastSpeechComposer* failing = segment_composer(client);
+    typecast_speech_composer_say(failing, "seg1", NULL);
+    typecast_speech_composer_say(failing, "fail", NULL);
+    typecast_speech_composer_say(failing, "seg2", NULL);
+    ASSERT(typecast_speech_composer_generate_parallel(failing, 0) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INTERNAL_SERVER);
+    typecast_speech_composer_destroy(failing);
+
+    TypecastSpeechComposer* not_wav = segment_composer(client);
+    typecast_speech_composer_say(not_wav, "mp3", NULL);
+    ASSERT(typecast_speech_composer_generate_parallel(not_wav, 2) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_JSON_PARSE);
+    ASSERT_STREQ(typecast_client_get_error(client)->message, "Segment audio is not a WAV file");
+    typecast_speech_composer_destroy(not_wav);
+
+    TypecastSpeechComposer* mixed = segment_composer(client);
+    typecast_speech_composer_say(mixed, "seg1", NULL);
+    typecast_speech_composer_say(mixed, "hz2000", NULL);
+    ASSERT(typecast_speech_composer_generate_parallel(mixed, 2) == NULL);
+    ASSERT_STREQ(typecast_client_get_error(client)->message, "Segment audio formats differ");
+    typecast_speech_composer_destroy(mixed);
+
+    TypecastSpeechComposer* empty = segment_composer(client);
+    typecast_speech_composer_pause(empty, 1.0f);
+    ASSERT(typecast_speech_composer_generate_parallel(empty, 2) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INVALID_PARAM);
+    typecast_speech_composer_destroy(empty);
+    ASSERT(typecast_speech_composer_generate_parallel(NULL, 2) == NULL);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_generate_parallel_reuses_cached_segments(void) {
+    static SegmentAudio slots[10];
+    MockServer server;
+    ASSERT(mock_server_start(&server, segment_route, slots));
+    char host[64];
+    mock_server_host(&server, host, sizeof(host));
+    TypecastClient* client = typecast_client_create_with_host("test-key", host);
+    TypecastSpeechComposer* composer = segment_composer(client);
+    ASSERT_EQ(typecast_speech_composer_enable_cache(composer, 1 << 20), TYPECAST_OK);
+    typecast_speech_composer_say(composer, "seg1", NULL);
+    typecast_speech_composer_say(composer, "fail", NULL);
+    ASSERT(typecast_speech_composer_generate_parallel(composer, 2) == NULL);
+    TypecastResultCacheStats stats;
+    ASSERT_EQ(typecast_speech_composer_cache_stats(composer, &stats), TYPECAST_OK);
+    ASSERT_EQ(stats.entries, 0u);   /* nothing is kept from a failed render */
+
+    ASSERT_EQ(typecast_speech_composer_set_text(composer, 1, "seg2"), TYPECAST_OK);
+    ASSERT_EQ(typecast_speech_composer_pause(composer, 0.005f), TYPECAST_OK);
+    ASSERT_EQ(typecast_speech_composer_say(composer, "seg3", NULL), TYPECAST_OK);
+    ASSERT_EQ(typecast_speech_composer_set_text(composer, 2, "seg4"), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_speech_composer_set_text(composer, 4, "seg4"), TYPECAST_ERROR_INVALID_PARAM);
+    int before = server.requests;
+    TypecastTTSResponse* first = typecast_speech_composer_generate_parallel(composer, 2);
+    ASSERT(first != NULL);
+    ASSERT_EQ(server.requests - before, 3);
+    ASSERT_EQ(typecast_speech_composer_cache_stats(composer, &stats), TYPECAST_OK);
+    ASSERT_EQ(stats.entries, 3u);
+
+    /* Unchanged script: served entirely from the cache */
+    before = server.requests;
+    TypecastTTSResponse* again = typecast_speech_composer_generate_parallel(composer, 2);
+    ASSERT(again != NULL);
+    ASSERT_EQ(server.requests, before);
+    ASSERT_EQ(again->audio_size, first->audio_size);
+    ASSERT(memcmp(again->audio_data, first->audio_data, first->audio_size) == 0);
+
+    /* One edited sentence: only that segment goes out */
+    ASSERT_EQ(typecast_speech_composer_set_text(composer, 1, "seg5"), TYPECAST_OK);
+    TypecastTTSResponse* edited = typecast_speech_composer_generate_parallel(composer, 2);
+    ASSERT(edited != NULL);
+    ASSERT_EQ(server.requests - before, 1);
+    /* 10 + 50 + 5 (pause) + 30 frames */
+    ASSERT_EQ(edited->audio_size, 44 + 95 * 2);
+    int16_t sample = 0;
+    memcpy(&sample, edited->audio_data + 44 + 10 * 2, 2);
+    ASSERT_EQ(sample, 5);
+    memcpy(&sample, edited->audio_data + 44 + 65 * 2, 2);
+    ASSERT_EQ(sample, 3);
+
+    /* A changed default re-keys every segment relying on it */
+    TypecastComposerSettings defaults = {0};
+    defaults.language = "eng";
+    typecast_speech_composer_defaults(composer, &defaults);
+    before = server.requests;
+    TypecastTTSResponse* relanguaged = typecast_speech_composer_generate_parallel(composer, 2);
+    ASSERT(relanguaged != NULL);
+    ASSERT_EQ(server.requests - before, 3);
+
+    /* A rebuilt script keeps the cache */
+    typecast_speech_composer_clear(composer);
+    typecast_speech_composer_say(composer, "seg3 <|0.01s|> seg5", NULL);
+    before = server.requests;
+    TypecastTTSResponse* rebuilt = typecast_speech_composer_generate_parallel(composer, 2);
+    ASSERT(rebuilt != NULL);
+    ASSERT_EQ(server.requests - before, 2);   /* the split pieces carry spaces */
+    ASSERT_EQ(typecast_speech_composer_cache_stats(composer, &stats), TYPECAST_OK);
+    ASSERT(stats.hits >= 3 && stats.misses >= 8);
+
+    ASSERT_EQ(typecast_speech_composer_enable_cache(composer, 0), TYPECAST_OK);
+    ASSERT_EQ(typecast_speech_composer_cache_stats(composer, &stats), TYPECAST_OK);
+    ASSERT_EQ(stats.entries, 0u);
+    ASSERT_EQ(typecast_speech_composer_cache_stats(NULL, &stats), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_speech_composer_enable_cache(NULL, 1), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_speech_composer_set_text(NULL, 0, "x"), TYPECAST_ERROR_INVALID_PARAM);
+    typecast_speech_composer_clear(NULL);
+
+    typecast_tts_response_free(first);
+    typecast_tts_response_free(again);
+    typecast_tts_response_free(edited);
+    typecast_tts_response_free(relanguaged);
+    typecast_tts_response_free(rebuilt);
+    typecast_speech_composer_destroy(composer);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    RUN(generate_parallel_stitches_segments_in_order);
+    RUN(generate_parallel_reports_segment_errors);
+    RUN(generate_parallel_reuses_cached_segments);
+    printf("\nParallel composer tests: %d run, %d failed\n", tests_run, tests_failed);
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+/**
+ * Asynchronous C++ API tests: std::future and (on C++20) co_await over
+ * the async engine, one event-loop thread per client, executors,
+ * streaming, compose and cancellation on destruction
+ */
+
+#define TYPECAST_CPP_WRAPPER
+#include "typecast.h"
+#include "mock_server.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static const char TIMESTAMPS_JSON[] =
+    "{\"audio\":\"QVVESU8=\",\"audio_format\":\"wav\",\"audio_duration\":1.0,"
+    "\"words\":[{\"text\":\"Hello.\",\"start\":0.0,\"end\":0.5},"
+    "{\"text\":\"World.\",\"start\":0.5,\"end\":1.0}],\"characters\":null}";
+static const char STREAM_BODY[] = "stream-audio-bytes";
+
+static void route(const MockRequest* req, MockResponse* resp, void*) {
+    if (req->body && strstr(req->body, "\"text\":\"fail\"")) {
+        static const char error[] = "{\"message\":\"boom\"}";
+        resp->status = 500;
+        resp->body = reinterpret_cast<const uint8_t*>(error);
+        resp->body_len = strlen(error);
+        return;
+    }
+    if (req->body && strstr(req->body, "slow")) resp->delay_ms = 2000;
+    if (strncmp(req->path, "/v1/text-to-speech/with-timestamps", 34) == 0) {
+        snprintf(resp->headers, sizeof(resp->headers), "Content-Type: application/json\r\n");
+        resp->body = reinterpret_cast<const uint8_t*>(TIMESTAMPS_JSON);
+        resp->body_len = strlen(TIMESTAMPS_JSON);
+    } else if (strcmp(req->path, "/v1/text-to-speech/stream") == 0) {
+        resp->body = reinterpret_cast<const uint8_t*>(STREAM_BODY);
+        resp->body_len = strlen(STREAM_BODY);
+        resp->chunk_size = 4;
+    } else {
+        /* Echo the body so every request can check it got its own audio */
+        resp->body = reinterpret_cast<const uint8_t*>(req->body);
+        resp->body_len = req->body_len;
+    }
+}
+
+struct Fixture {
+    MockServer server;
+    std::string host;
+
+    Fixture() {
+        mock_server_start(&server, route, NULL);
+        char buf[64];
+        mock_server_host(&server, buf, sizeof(buf));
+        host = buf;
+    }
+    ~Fixture() { mock_server_stop(&server); }
+};
+
+static typecast::TTSRequest request(const std::string& text) {
+    typecast::TTSRequest req;
+    req.text = text;
+    req.voiceId = "tc_voice";
+    return req;
+}
+
+static bool contains(const typecast::AudioBuffer& audio, const std::string& needle) {
+    std::string body(reinterpret_cast<const char*>(audio.data()), audio.size());
+    return body.find(needle) != std::string::npos;
+}
+
+static void test_many_futures_on_one_loop(void) {
+    Fixture f;
+    typecast::AsyncClient client("test-key", f.host);
+
+    std::vector<std::future<typecast::AudioBuffer>> futures;
+    for (int i = 0; i < 64; i++) {
+        futures.push_back(client.textToSpeechAsync(request("line " + std::to_string(i))));
+    }
+    for (int i = 0; i < 64; i++) {
+        typecast::AudioBuffer audio = futures[i].get();
+        ASSERT(contains(audio, "\"text\":\"line " + std::to_string(i) + "\""));
+    }
+}
+
+static void test_errors_surface_from_the_future(void) {
+    Fixture f;
+    typecast::AsyncClient client("test-key", f.host);
+
+    std::future<typecast::AudioBuffer> failed = client.textToSpeechAsync(request("fail"));
+    TypecastSpeechComposer* empty = typecast_speech_composer_create(client.handle());
+    std::future<typecast::AudioBuffer> rejected = client.composeAsync(empty);
+    typecast_speech_composer_destroy(empty);
+
+    TypecastErrorCode code = TYPECAST_OK;
+    try {
+        failed.get();
+    } catch (const typecast::TypecastException& e) {
+        code = e.code;
+    }
+    ASSERT_EQ(code, TYPECAST_ERROR_INTERNAL_SERVER);
+    /* A request the C layer refuses fails without reaching the server */
+    code = TYPECAST_OK;
+    try {
+        rejected.get();
+    } catch (const typecast::TypecastException& e) {
+        code = e.code;
+    }
+    ASSERT_EQ(code, TYPECAST_ERROR_INVALID_PARAM);
+}
+
+static void test_timestamps_and_stream(void) {
+    Fixture f;
+    typecast::AsyncClient client("test-key", f.host);
+
+    std::future<typecast::TimestampedAudio> stamped =
+        client.textToSpeechWithTimestampsAsync(request("hello"), "word");
+    std::string streamed;
+    std::future<size_t> stream = client.streamAsync(request("hello"), [&](typecast::ByteView chunk) {
+        streamed.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+        return true;
+    });
+
+    typecast::TimestampedAudio result = stamped.get();
+    ASSERT_EQ(result.words().size(), 2u);
+    ASSERT(strcmp(result.words()[1].text, "World.") == 0);
+    ASSERT(result.characters().empty());
+    std::vector<uint8_t> audio = result.audio();
+    ASSERT(std::string(audio.begin(), audio.end()) == "AUDIO");
+
+    ASSERT_EQ(stream.get(), strlen(STREAM_BODY));
+    ASSERT(streamed == STREAM_BODY);
+
+    /* Stopping the stream fails its future; a throwing handler rethrows */
+    std::future<size_t> stopped = client.streamAsync(request("hello"), [](typecast::ByteView) { return false; });
+    std::future<size_t> thrown = client.streamAsync(request("hello"), [](typecast::ByteView) -> bool {
+        throw std::runtime_error("handler failed");
+    });
+    bool failed = false;
+    try {
+        stopped.get();
+    } catch (const typecast::TypecastException& e) {
+        failed = e.code == TYPECAST_ERROR_NETWORK;
+    }
+    ASSERT(failed);
+    std::string message;
+    try {
+        thrown.get();
+    } catch (const std::runtime_error& e) {
+        message = e.what();
+    }
+    ASSERT(message == "handler failed");
+}
+
+static void test_compose_serializes_before_returning(void) {
+    Fixture f;
+    typecast::AsyncClient client("test-key", f.host);
+
+    TypecastSpeechComposer* composer = typecast_speech_composer_create(client.handle());
+    TypecastComposerSettings defaults = {};
+    defaults.voice_id = "tc_voice";
+    typecast_speech_composer_defaults(composer, &defaults);
+    typecast_speech_composer_say(composer, "composed", NULL);
+    std::future<typecast::AudioBuffer> composed = client.composeAsync(composer, typecast::AudioFormat::MP3);
+    typecast_speech_composer_destroy(composer);
+
+    typecast::AudioBuffer audio = composed.get();
+    ASSERT(audio.format() == typecast::AudioFormat::MP3);
+    ASSERT(contains(audio, "\"segments\""));
+    ASSERT(contains(audio, "composed"));
+}
+
+/* Runs completions only when the test asks it to */
+struct ManualExecutor {
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<std::function<void()>> tasks;
+
+    typecast::Executor executor() {
+        return [this](std::function<void()> task) {
+            std::lock_guard<std::mutex> guard(lock);
+            tasks.push_back(std::move(task));
+            ready.notify_one();
+        };
+    }
+    bool runOne() {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            if (!ready.wait_for(guard, std::chrono::seconds(5), [this] { return !tasks.empty(); })) return false;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+        return true;
+    }
+};
+
+static void test_completions_run_on_the_executor(void) {
+    Fixture f;
+    ManualExecutor manual;
+    typecast::AsyncClient client("test-key", f.host, manual.executor());
+
+    std::future<typecast::AudioBuffer> future = client.textToSpeechAsync(request("hello"));
+    std::unique_lock<std::mutex> guard(manual.lock);
+    ASSERT(manual.ready.wait_for(guard, std::chrono::seconds(5), [&] { return !manual.tasks.empty(); }));
+    guard.unlock();
+    /* Finished on the wire, but not settled until the executor runs it */
+    ASSERT(future.wait_for(std::chrono::milliseconds(0)) == std::future_status::timeout);
+    ASSERT(manual.runOne());
+    ASSERT(contains(future.get(), "\"text\":\"hello\""));
+}
+
+static void test_destroy_cancels_running_requests(void) {
+    Fixture f;
+    std::future<typecast::AudioBuffer> future;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+        typecast::AsyncClient client("test-key", f.host);
+        future = client.textToSpeechAsync(request("slow"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    TypecastErrorCode code = TYPECAST_OK;
+    try {
+        future.get();
+    } catch (const typecast::TypecastException& e) {
+        code = e.code;
+    }
+    ASSERT_EQ(code, TYPECAST_ERROR_NETWORK);
+    /* Cancelled, not waited for */
+    ASSERT(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1500));
+}
+
+#ifdef TYPECAST_CPP_HAS_COROUTINES
+/* Minimal fire-and-forget coroutine for driving the awaitables */
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return Detached(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+static Detached render(typecast::AsyncClient& client, std::promise<std::string>& out) {
+    std::string result;
+    try {
+        typecast::AudioBuffer audio = co_await client.textToSpeechAsync(request("awaited"), typecast::useAwaitable);
+        typecast::TimestampedAudio stamped = co_await client.textToSpeechWithTimestampsAsync(
+            request("awaited"), typecast::useAwaitable);
+        result = contains(audio, "\"text\":\"awaited\"") ? "audio" : "wrong audio";
+        result += "|" + std::to_string(stamped.words().size());
+        co_await client.textToSpeechAsync(request("fail"), typecast::useAwaitable);
+        out.set_value(result);
+    } catch (const typecast::TypecastException& e) {
+        out.set_value(result + (e.code == TYPECAST_ERROR_INTERNAL_SERVER ? "|caught" : "|wrong code"));
+    }
+}
+
+static void test_coroutines_await_requests(void) {
+    Fixture f;
+    std::promise<std::string> done;
+    std::future<std::string> result = done.get_future();
+    typecast::AsyncClient client("test-key", f.host);
+    render(client, done);
+    ASSERT(result.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    ASSERT(result.get() == "audio|2|caught");
+}
+#endif
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - C++ Async Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(many_futures_on_one_loop);
+    RUN(errors_surface_from_the_future);
+    RUN(timestamps_and_stream);
+    RUN(compose_serializes_before_returning);
+    RUN(completions_run_on_the_executor);
+    RUN(destroy_cancels_running_requests);
+#ifdef TYPECAST_CPP_HAS_COROUTINES
+    RUN(coroutines_await_requests);
+#endif
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,272 @@
+/**
+ * C++ wrapper tests: move-only handles over the C responses (audio and
+ * voice lists without copies), streamToFile through the C file writer,
+ * and the copying convenience calls built on top of them
+ */
+
+#define TYPECAST_CPP_WRAPPER
+#include "typecast.h"
+#include "mock_server.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static_assert(!std::is_copy_constructible<typecast::AudioBuffer>::value, "AudioBuffer is move-only");
+static_assert(std::is_nothrow_move_constructible<typecast::AudioBuffer>::value, "AudioBuffer moves cheaply");
+static_assert(!std::is_copy_constructible<typecast::VoiceList>::value, "VoiceList is move-only");
+
+static const char AUDIO[] = "RIFF-audio-bytes";
+static const char VOICES[] =
+    "[{\"voice_id\":\"tc_one\",\"voice_name\":\"One\",\"models\":[{\"version\":\"ssfm-v30\","
+    "\"emotions\":[\"normal\"]}]},{\"voice_id\":\"tc_two\",\"voice_name\":\"Two\"}]";
+static const char RECOMMENDED[] = "[{\"voice_id\":\"tc_one\",\"voice_name\":\"One\",\"score\":0.75}]";
+
+typedef struct {
+    pthread_mutex_t lock;
+    std::string last_body;
+} Plan;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = static_cast<Plan*>(user_data);
+    pthread_mutex_lock(&plan->lock);
+    plan->last_body.assign(req->body ? req->body : "", req->body_len);
+    pthread_mutex_unlock(&plan->lock);
+
+    const char* body = AUDIO;
+    if (req->body && strstr(req->body, "\"text\":\"fail\"")) {
+        resp->status = 500;
+        body = "{\"message\":\"boom\"}";
+    } else if (strncmp(req->path, "/v2/voices", 10) == 0) {
+        body = VOICES;
+    } else if (strncmp(req->path, "/v1/voices/recommendations", 26) == 0) {
+        body = RECOMMENDED;
+    } else {
+        snprintf(resp->headers, sizeof(resp->headers), "Content-Type: audio/wav\r\nX-Audio-Duration: 1.5\r\n");
+    }
+    resp->body = reinterpret_cast<const uint8_t*>(body);
+    resp->body_len = strlen(body);
+}
+
+struct Fixture {
+    MockServer server;
+    Plan plan;
+    std::string host;
+
+    Fixture() {
+        pthread_mutex_init(&plan.lock, NULL);
+        mock_server_start(&server, route, &plan);
+        char buf[64];
+        mock_server_host(&server, buf, sizeof(buf));
+        host = buf;
+    }
+    ~Fixture() {
+        mock_server_stop(&server);
+        pthread_mutex_destroy(&plan.lock);
+    }
+    std::string lastBody() {
+        pthread_mutex_lock(&plan.lock);
+        std::string body = plan.last_body;
+        pthread_mutex_unlock(&plan.lock);
+        return body;
+    }
+};
+
+static typecast::TTSRequest request(const char* text) {
+    typecast::TTSRequest req;
+    req.text = text;
+    req.voiceId = "tc_voice";
+    return req;
+}
+
+static void test_audio_buffer_owns_the_c_response(void) {
+    Fixture f;
+    typecast::Client client("test-key", f.host);
+
+    typecast::AudioBuffer audio = client.textToSpeechBuffer(request("hello"));
+    ASSERT_EQ(audio.size(), strlen(AUDIO));
+    ASSERT(memcmp(audio.data(), AUDIO, audio.size()) == 0);
+    ASSERT_EQ(audio.data(), audio.get()->audio_data);
+    ASSERT(audio.duration() > 1.4f && audio.duration() < 1.6f);
+    ASSERT(audio.format() == typecast::AudioFormat::WAV);
+
+    /* Moving hands over the same bytes */
+    const uint8_t* bytes = audio.data();
+    typecast::AudioBuffer moved = std::move(audio);
+    ASSERT_EQ(moved.data(), bytes);
+    ASSERT(audio.empty());
+    ASSERT(audio.data() == NULL);
+
+    typecast::ByteView view = moved.view();
+    ASSERT_EQ(view.data(), bytes);
+    ASSERT_EQ(view.size(), moved.size());
+    ASSERT_EQ(view[0], 'R');
+    size_t counted = 0;
+    for (uint8_t b : moved) counted += b ? 1 : 0;
+    ASSERT_EQ(counted, moved.size());
+
+    TypecastTTSResponse* raw = moved.release();
+    ASSERT(raw != NULL);
+    ASSERT(moved.empty());
+    typecast_tts_response_free(raw);
+}
+
+static void test_text_to_speech_still_returns_a_vector(void) {
+    Fixture f;
+    typecast::Client client("test-key", f.host);
+    typecast::TTSResponse resp = client.textToSpeech(request("hello"));
+    ASSERT_EQ(resp.audioData.size(), strlen(AUDIO));
+    ASSERT(memcmp(resp.audioData.data(), AUDIO, resp.audioData.size()) == 0);
+    ASSERT(f.lastBody().find("\"voice_id\":\"tc_voice\"") != std::string::npos);
+}
+
+static void test_errors_throw_with_the_c_code(void) {
+    Fixture f;
+    typecast::Client client("test-key", f.host);
+    bool thrown = false;
+    try {
+        client.textToSpeechBuffer(request("fail"));
+    } catch (const typecast::TypecastException& e) {
+        thrown = true;
+        ASSERT_EQ(e.code, TYPECAST_ERROR_INTERNAL_SERVER);
+    }
+    ASSERT(thrown);
+}
+
+static void test_stream_to_file_uses_the_c_writer(void) {
+    Fixture f;
+    typecast::Client client("test-key", f.host);
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/typecast_cpp_%d.mp3", (int)getpid());
+    remove(path);
+
+    typecast::GenerateToFileRequest req;
+    req.text = "hello";
+    req.voiceId = "tc_voice";
+    typecast::GeneratedFile resp = client.streamToFile(path, req);
+    ASSERT(resp.format == typecast::AudioFormat::MP3);
+    ASSERT(resp.duration > 1.4f && resp.duration < 1.6f);
+    ASSERT(f.lastBody().find("\"audio_format\":\"mp3\"") != std::string::npos);
+
+    FILE* file = fopen(path, "rb");
+    ASSERT(file != NULL);
+    char data[64] = {0};
+    size_t n = fread(data, 1, sizeof(data), file);
+    fclose(file);
+    ASSERT_EQ(n, strlen(AUDIO));
+    ASSERT(memcmp(data, AUDIO, n) == 0);
+    remove(path);
+
+    /* A failed request leaves no file behind */
+    req.text = "fail";
+    bool thrown = false;
+    try {
+        client.streamToFile(path, req);
+    } catch (const typecast::TypecastException&) {
+        thrown = true;
+    }
+    ASSERT(thrown);
+    ASSERT(fopen(path, "rb") == NULL);
+}
+
+static void test_generate_to_file_keeps_the_audio(void) {
+    Fixture f;
+    typecast::Client client("test-key", f.host);
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/typecast_cpp_mem_%d.wav", (int)getpid());
+    remove(path);
+
+    typecast::GenerateToFileRequest req;
+    req.text = "hello";
+    req.voiceId = "tc_voice";
+    typecast::TTSResponse resp = client.generateToFile(path, req);
+    ASSERT_EQ(resp.audioData.size(), strlen(AUDIO));
+    ASSERT(memcmp(resp.audioData.data(), AUDIO, resp.audioData.size()) == 0);
+    ASSERT(f.lastBody().find("\"audio_format\":\"wav\"") != std::string::npos);
+
+    FILE* file = fopen(path, "rb");
+    ASSERT(file != NULL);
+    char data[64] = {0};
+    size_t n = fread(data, 1, sizeof(data), file);
+    fclose(file);
+    remove(path);
+    ASSERT_EQ(n, strlen(AUDIO));
+
+    /* An unwritable path is still an invalid parameter */
+    int code = TYPECAST_OK;
+    try {
+        client.generateToFile("/nonexistent-dir/out.wav", req);
+    } catch (const typecast::TypecastException& e) {
+        code = e.code;
+    }
+    ASSERT_EQ(code, TYPECAST_ERROR_INVALID_PARAM);
+}
+
+static void test_voice_lists_are_views(void) {
+    Fixture f;
+    typecast::Client client("test-key", f.host);
+
+    typecast::VoiceList voices = client.getVoiceList();
+    ASSERT_EQ(voices.size(), 2u);
+    ASSERT(strcmp(voices[0].voice_id, "tc_one") == 0);
+    ASSERT(strcmp(voices[0].models[0].emotions[0], "normal") == 0);
+    ASSERT_EQ(voices[1].voice_name, voices.get()->voices[1].voice_name);
+    size_t seen = 0;
+    for (const TypecastVoice& voice : voices) seen += voice.voice_id ? 1 : 0;
+    ASSERT_EQ(seen, 2u);
+
+    typecast::VoiceList moved = std::move(voices);
+    ASSERT(voices.empty());
+    ASSERT_EQ(moved.size(), 2u);
+
+    std::vector<typecast::Voice> copies = client.getVoices();
+    ASSERT_EQ(copies.size(), 2u);
+    ASSERT(copies[1].voiceName == "Two");
+
+    typecast::RecommendedVoiceList rec = client.recommendVoiceList("calm", 1);
+    ASSERT_EQ(rec.size(), 1u);
+    ASSERT(strcmp(rec[0].voice_name, "One") == 0);
+    ASSERT(rec[0].score > 0.7);
+    std::vector<typecast::RecommendedVoice> recCopies = client.recommendVoices("calm", 1);
+    ASSERT_EQ(recCopies.size(), 1u);
+    ASSERT(recCopies[0].voiceId == "tc_one");
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - C++ Wrapper Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(audio_buffer_owns_the_c_response);
+    RUN(text_to_speech_still_returns_a_vector);
+    RUN(errors_throw_with_the_c_code);
+    RUN(stream_to_file_uses_the_c_writer);
+    RUN(generate_to_file_keeps_the_audio);
+    RUN(voice_lists_are_views);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,364 @@
+/**
+ * Governor tests: retries of 429 / 5xx with backoff and Retry-After
+ * (the concurrency cap is covered by test_governor_concurrency.c)
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static const char AUDIO[] = "RIFF-audio";
+
+/* The first statuses[] answers go out as given, every later one is 200 */
+typedef struct {
+    pthread_mutex_t lock;
+    int statuses[8];
+    int status_count;
+    const char* extra_headers;
+    int tts_requests;
+    int subscription_requests;
+    int concurrency_limit;
+    int hold_ms;                     /* time each TTS request is held */
+    int active;
+    int max_active;
+} Plan;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = (Plan*)user_data;
+    if (strcmp(req->path, "/v1/users/me/subscription") == 0) {
+        static char sub[256];
+        pthread_mutex_lock(&plan->lock);
+        plan->subscription_requests++;
+        snprintf(sub, sizeof(sub),
+            "{\"plan\":\"plus\",\"credits\":{\"plan_credits\":100,\"used_credits\":1},"
+            "\"limits\":{\"concurrency_limit\":%d}}", plan->concurrency_limit);
+        pthread_mutex_unlock(&plan->lock);
+        resp->body = (const uint8_t*)sub;
+        resp->body_len = strlen(sub);
+        return;
+    }
+
+    pthread_mutex_lock(&plan->lock);
+    int n = plan->tts_requests++;
+    int status = n < plan->status_count ? plan->statuses[n] : 200;
+    if (++plan->active > plan->max_active) plan->max_active = plan->active;
+    pthread_mutex_unlock(&plan->lock);
+    mock_sleep_ms(plan->hold_ms);
+    pthread_mutex_lock(&plan->lock);
+    plan->active--;
+    pthread_mutex_unlock(&plan->lock);
+
+    resp->status = status;
+    if (status != 200) {
+        static const char detail[] = "{\"detail\":\"slow down\"}";
+        if (plan->extra_headers) snprintf(resp->headers, sizeof(resp->headers), "%s", plan->extra_headers);
+        resp->body = (const uint8_t*)detail;
+        resp->body_len = strlen(detail);
+        return;
+    }
+    resp->body = (const uint8_t*)AUDIO;
+    resp->body_len = strlen(AUDIO);
+}
+
+static void start(MockServer* server, Plan* plan, const int* statuses, int count) {
+    memset(plan, 0, sizeof(*plan));
+    pthread_mutex_init(&plan->lock, NULL);
+    for (int i = 0; i < count; i++) plan->statuses[i] = statuses[i];
+    plan->status_count = count;
+    mock_server_start(server, route, plan);
+}
+
+static TypecastClient* new_client(MockServer* server, const TypecastClientOptions* options) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options);
+}
+
+static TypecastTTSRequest tts_request(void) {
+    TypecastTTSRequest req = {0};
+    req.text = "hello";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    return req;
+}
+
+static long elapsed_ms(const struct timespec* since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000L + (now.tv_nsec - since->tv_nsec) / 1000000L;
+}
+
+static void test_no_retries_by_default(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {429};
+    start(&server, &plan, statuses, 1);
+    TypecastClient* client = new_client(&server, NULL);
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_RATE_LIMIT);
+    ASSERT_EQ(plan.tts_requests, 1);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_rate_limit_and_server_errors_are_retried(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {429, 503, 500};
+    start(&server, &plan, statuses, 3);
+    TypecastClientOptions options = {0};
+    options.max_retries = 3;
+    options.retry_base_delay_ms = 10;
+    TypecastClient* client = new_client(&server, &options);
+
+    TypecastTTSRequest req = tts_request();
+    TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+    ASSERT_EQ(resp->audio_size, strlen(AUDIO));
+    ASSERT(memcmp(resp->audio_data, AUDIO, resp->audio_size) == 0);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_OK);
+    typecast_tts_response_free(resp);
+    ASSERT_EQ(plan.tts_requests, 4);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_retries_give_up_with_last_error(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {429, 429, 429, 429};
+    start(&server, &plan, statuses, 4);
+    TypecastClientOptions options = {0};
+    options.max_retries = 2;
+    options.retry_base_delay_ms = 5;
+    TypecastClient* client = new_client(&server, &options);
+
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_RATE_LIMIT);
+    ASSERT(strcmp(typecast_client_get_error(client)->message, "slow down") == 0);
+    ASSERT_EQ(plan.tts_requests, 3);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_client_errors_are_not_retried(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {400};
+    start(&server, &plan, statuses, 1);
+    TypecastClientOptions options = {0};
+    options.max_retries = 3;
+    options.retry_base_delay_ms = 5;
+    TypecastClient* client = new_client(&server, &options);
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_BAD_REQUEST);
+    ASSERT_EQ(plan.tts_requests, 1);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_retry_after_is_honored(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {429};
+    start(&server, &plan, statuses, 1);
+    plan.extra_headers = "Retry-After: 1\r\n";
+    TypecastClientOptions options = {0};
+    options.max_retries = 1;
+    options.retry_base_delay_ms = 1;
+    TypecastClient* client = new_client(&server, &options);
+
+    struct timespec begin;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    TypecastTTSRequest req = tts_request();
+    TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+    ASSERT(elapsed_ms(&begin) >= 900);
+    ASSERT_EQ(plan.tts_requests, 2);
+    typecast_client_destroy(client);
+
+    /* A Retry-After beyond retry_max_delay_ms is not waited for */
+    plan.tts_requests = 0;
+    options.retry_max_delay_ms = 100;
+    client = new_client(&server, &options);
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT(elapsed_ms(&begin) < 900);
+    ASSERT_EQ(plan.tts_requests, 1);
+    typecast_client_destroy(client);
+
+    /* A day-long (or overflowing) back-off gives up rather than retrying now */
+    const char* huge[] = {"Retry-After: 86400\r\n", "Retry-After: 99999999999999999999\r\n",
+                          "Retry-After: Fri, 01 Jan 2100 00:00:00 GMT\r\n"};
+    options.retry_max_delay_ms = 0;
+    for (size_t i = 0; i < sizeof(huge) / sizeof(huge[0]); i++) {
+        plan.tts_requests = 0;
+        plan.extra_headers = huge[i];
+        client = new_client(&server, &options);
+        ASSERT(typecast_text_to_speech(client, &req) == NULL);
+        ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_RATE_LIMIT);
+        ASSERT_EQ(plan.tts_requests, 1);
+        typecast_client_destroy(client);
+    }
+    mock_server_stop(&server);
+}
+
+static void* tts_main(void* arg) {
+    TypecastTTSRequest req = tts_request();
+    return typecast_text_to_speech((TypecastClient*)arg, &req);
+}
+
+static void test_pause_keeps_deadlines_and_cancels(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {429};
+    start(&server, &plan, statuses, 1);
+    plan.extra_headers = "Retry-After: 2\r\n";
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    options.max_retries = 1;
+    TypecastClient* client = new_client(&server, &options);
+    pthread_t thread;
+    pthread_create(&thread, NULL, tts_main, client);
+    for (;;) {
+        pthread_mutex_lock(&plan.lock);
+        int seen = plan.tts_requests;
+        pthread_mutex_unlock(&plan.lock);
+        if (seen > 0) break;
+        mock_sleep_ms(5);
+    }
+    mock_sleep_ms(100);
+
+    /* Requests entering the Retry-After pause give up at their deadline
+     * or on cancel instead of sitting it out */
+    struct timespec begin;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    TypecastCallOptions call = {0};
+    call.deadline_ms = 300;
+    typecast_set_call_options(client, &call);
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_NETWORK);
+    TypecastCancelToken* token = typecast_cancel_token_create();
+    typecast_cancel_token_cancel(token);
+    call.deadline_ms = 0;
+    call.cancel = token;
+    typecast_set_call_options(client, &call);
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_CANCELLED);
+    typecast_set_call_options(client, NULL);
+    ASSERT(elapsed_ms(&begin) < 1000);
+
+    void* resp = NULL;
+    pthread_join(thread, &resp);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free((TypecastTTSResponse*)resp);
+    ASSERT_EQ(plan.tts_requests, 2);
+    typecast_cancel_token_free(token);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_generate_to_file_retry_keeps_error_body_out(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {429};
+    start(&server, &plan, statuses, 1);
+    TypecastClientOptions options = {0};
+    options.max_retries = 1;
+    options.retry_base_delay_ms = 5;
+    TypecastClient* client = new_client(&server, &options);
+
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/typecast_governor_%d.wav", (int)getpid());
+    TypecastGenerateToFileRequest req = {0};
+    req.text = "hello";
+    req.voice_id = "tc_voice";
+    ASSERT_EQ(typecast_generate_to_file(client, path, &req), TYPECAST_OK);
+    FILE* f = fopen(path, "rb");
+    ASSERT(f != NULL);
+    char buf[64];
+    size_t n = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    remove(path);
+    ASSERT_EQ(n, strlen(AUDIO));
+    ASSERT(memcmp(buf, AUDIO, n) == 0);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static int discard(const uint8_t* data, size_t len, void* user_data) {
+    (void)data; (void)len; (void)user_data;
+    return 0;
+}
+
+static void test_streams_are_not_retried(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {429};
+    start(&server, &plan, statuses, 1);
+    TypecastClientOptions options = {0};
+    options.max_retries = 2;
+    options.retry_base_delay_ms = 5;
+    TypecastClient* client = new_client(&server, &options);
+    TypecastTTSRequestStream req = {0};
+    req.text = "hello";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    ASSERT_EQ(typecast_text_to_speech_stream(client, &req, discard, NULL), TYPECAST_ERROR_RATE_LIMIT);
+    ASSERT_EQ(plan.tts_requests, 1);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Governor Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(no_retries_by_default);
+    RUN(rate_limit_and_server_errors_are_retried);
+    RUN(retries_give_up_with_last_error);
+    RUN(client_errors_are_not_retried);
+    RUN(retry_after_is_honored);
+    RUN(pause_keeps_deadlines_and_cancels);
+    RUN(generate_to_file_retry_keeps_error_body_out);
+    RUN(streams_are_not_retried);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,302 @@
+/**
+ * Governor concurrency tests: the cap from options or the subscription's
+ * limits, shared by blocking calls and async jobs
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+#define THREADS 6
+
+static const char AUDIO[] = "RIFF-audio";
+
+/* The first statuses[] answers go out as given, every later one is 200 */
+typedef struct {
+    pthread_mutex_t lock;
+    int statuses[8];
+    int status_count;
+    const char* extra_headers;
+    int tts_requests;
+    int subscription_requests;
+    int concurrency_limit;
+    int hold_ms;                     /* time each TTS request is held */
+    int active;
+    int max_active;
+} Plan;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = (Plan*)user_data;
+    if (strcmp(req->path, "/v1/users/me/subscription") == 0) {
+        static char sub[256];
+        pthread_mutex_lock(&plan->lock);
+        plan->subscription_requests++;
+        snprintf(sub, sizeof(sub),
+            "{\"plan\":\"plus\",\"credits\":{\"plan_credits\":100,\"used_credits\":1},"
+            "\"limits\":{\"concurrency_limit\":%d}}", plan->concurrency_limit);
+        pthread_mutex_unlock(&plan->lock);
+        resp->body = (const uint8_t*)sub;
+        resp->body_len = strlen(sub);
+        return;
+    }
+
+    pthread_mutex_lock(&plan->lock);
+    int n = plan->tts_requests++;
+    int status = n < plan->status_count ? plan->statuses[n] : 200;
+    if (++plan->active > plan->max_active) plan->max_active = plan->active;
+    pthread_mutex_unlock(&plan->lock);
+    mock_sleep_ms(plan->hold_ms);
+    pthread_mutex_lock(&plan->lock);
+    plan->active--;
+    pthread_mutex_unlock(&plan->lock);
+
+    resp->status = status;
+    if (status != 200) {
+        static const char detail[] = "{\"detail\":\"slow down\"}";
+        if (plan->extra_headers) snprintf(resp->headers, sizeof(resp->headers), "%s", plan->extra_headers);
+        resp->body = (const uint8_t*)detail;
+        resp->body_len = strlen(detail);
+        return;
+    }
+    resp->body = (const uint8_t*)AUDIO;
+    resp->body_len = strlen(AUDIO);
+}
+
+static void start(MockServer* server, Plan* plan, const int* statuses, int count) {
+    memset(plan, 0, sizeof(*plan));
+    pthread_mutex_init(&plan->lock, NULL);
+    for (int i = 0; i < count; i++) plan->statuses[i] = statuses[i];
+    plan->status_count = count;
+    mock_server_start(server, route, plan);
+}
+
+static TypecastClient* new_client(MockServer* server, const TypecastClientOptions* options) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options);
+}
+
+static TypecastTTSRequest tts_request(void) {
+    TypecastTTSRequest req = {0};
+    req.text = "hello";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    return req;
+}
+
+typedef struct {
+    TypecastClient* client;
+    int ok;
+} Worker;
+
+static void* worker_main(void* arg) {
+    Worker* worker = (Worker*)arg;
+    TypecastTTSRequest req = tts_request();
+    for (int i = 0; i < 3; i++) {
+        TypecastTTSResponse* resp = typecast_text_to_speech(worker->client, &req);
+        if (resp) worker->ok++;
+        typecast_tts_response_free(resp);
+    }
+    return NULL;
+}
+
+static int run_workers(TypecastClient* client) {
+    pthread_t threads[THREADS];
+    Worker workers[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        workers[i].client = client;
+        workers[i].ok = 0;
+        pthread_create(&threads[i], NULL, worker_main, &workers[i]);
+    }
+    int ok = 0;
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        ok += workers[i].ok;
+    }
+    return ok;
+}
+
+static void test_concurrency_cap(void) {
+    MockServer server;
+    Plan plan;
+    start(&server, &plan, NULL, 0);
+    plan.hold_ms = 30;
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    options.max_concurrent_requests = 2;
+    TypecastClient* client = new_client(&server, &options);
+    ASSERT_EQ(run_workers(client), THREADS * 3);
+    ASSERT(plan.max_active <= 2);
+    ASSERT(plan.max_active >= 1);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+/* Submits `count` async jobs and waits for them; returns how many succeeded */
+static int run_async(TypecastClient* client, int count) {
+    TypecastAsyncJob* jobs[THREADS];
+    TypecastTTSRequest req = tts_request();
+    for (int i = 0; i < count; i++) jobs[i] = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    int ok = 0;
+    for (int i = 0; i < count; i++) {
+        if (!jobs[i]) continue;
+        if (typecast_async_wait(client, jobs[i]) == TYPECAST_OK) {
+            TypecastTTSResponse* resp = typecast_async_job_take_tts_response(jobs[i]);
+            if (resp && resp->audio_size == strlen(AUDIO)) ok++;
+            typecast_tts_response_free(resp);
+        }
+        typecast_async_job_free(jobs[i]);
+    }
+    return ok;
+}
+
+static void test_concurrency_from_subscription(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {429, 429};
+    start(&server, &plan, statuses, 2);
+    plan.hold_ms = 20;
+    plan.concurrency_limit = 1;
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    options.concurrency_from_subscription = 1;
+    options.max_concurrent_requests = 4;
+    options.max_retries = 3;
+    options.retry_base_delay_ms = 5;
+    TypecastClient* client = new_client(&server, &options);
+    /* Read while the client is created, never inside a request */
+    ASSERT_EQ(plan.subscription_requests, 1);
+    ASSERT_EQ(run_workers(client), THREADS * 3);
+    ASSERT_EQ(plan.max_active, 1);
+    ASSERT_EQ(plan.subscription_requests, 1);
+    ASSERT_EQ(plan.tts_requests, THREADS * 3 + 2);
+    typecast_client_destroy(client);
+
+    /* Async jobs keep to the plan's limit as well */
+    plan.max_active = 0;
+    client = new_client(&server, &options);
+    ASSERT_EQ(run_async(client, THREADS), THREADS);
+    ASSERT_EQ(plan.max_active, 1);
+    ASSERT_EQ(plan.subscription_requests, 2);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_async_jobs_share_the_window(void) {
+    MockServer server;
+    Plan plan;
+    start(&server, &plan, NULL, 0);
+    plan.hold_ms = 50;
+    TypecastClientOptions options = {0};
+    options.max_concurrent_requests = 2;
+    TypecastClient* client = new_client(&server, &options);
+    size_t running = 0;
+    ASSERT_EQ(run_async(client, THREADS), THREADS);
+    ASSERT_EQ(plan.tts_requests, THREADS);
+    ASSERT(plan.max_active <= 2);
+    ASSERT_EQ(typecast_async_poll(client, 0, &running), TYPECAST_OK);
+    ASSERT_EQ(running, 0u);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_async_jobs_are_retried(void) {
+    MockServer server;
+    Plan plan;
+    int statuses[] = {429, 503};
+    start(&server, &plan, statuses, 2);
+    TypecastClientOptions options = {0};
+    options.max_retries = 3;
+    options.retry_base_delay_ms = 10;
+    TypecastClient* client = new_client(&server, &options);
+    ASSERT_EQ(run_async(client, 1), 1);
+    ASSERT_EQ(plan.tts_requests, 3);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+
+    /* A Retry-After past the ceiling gives up with the 429 */
+    start(&server, &plan, statuses, 1);
+    plan.extra_headers = "Retry-After: 86400\r\n";
+    client = new_client(&server, &options);
+    TypecastTTSRequest req = tts_request();
+    TypecastAsyncJob* job = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    ASSERT_EQ(typecast_async_wait(client, job), TYPECAST_ERROR_RATE_LIMIT);
+    ASSERT(strcmp(typecast_async_job_error(job)->message, "slow down") == 0);
+    ASSERT_EQ(plan.tts_requests, 1);
+    typecast_async_job_free(job);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_queued_async_jobs_can_be_cancelled(void) {
+    MockServer server;
+    Plan plan;
+    start(&server, &plan, NULL, 0);
+    plan.hold_ms = 200;
+    TypecastClientOptions options = {0};
+    options.max_concurrent_requests = 1;
+    TypecastClient* client = new_client(&server, &options);
+    TypecastTTSRequest req = tts_request();
+    TypecastAsyncJob* first = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    TypecastCancelToken* token = typecast_cancel_token_create();
+    TypecastCallOptions call = {0};
+    call.cancel = token;
+    typecast_set_call_options(client, &call);
+    TypecastAsyncJob* queued = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    typecast_set_call_options(client, NULL);
+    typecast_cancel_token_cancel(token);
+
+    ASSERT_EQ(typecast_async_wait(client, queued), TYPECAST_ERROR_CANCELLED);
+    ASSERT(!typecast_async_job_is_done(first));
+    /* A job freed while queued gives nothing back to the window */
+    TypecastAsyncJob* dropped = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    typecast_async_job_free(dropped);
+    ASSERT_EQ(typecast_async_wait(client, first), TYPECAST_OK);
+    ASSERT_EQ(plan.tts_requests, 1);
+    ASSERT_EQ(run_async(client, 2), 2);
+    typecast_async_job_free(first);
+    typecast_async_job_free(queued);
+    typecast_cancel_token_free(token);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Governor Concurrency Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(concurrency_cap);
+    RUN(concurrency_from_subscription);
+    RUN(async_jobs_share_the_window);
+    RUN(async_jobs_are_retried);
+    RUN(queued_async_jobs_can_be_cancelled);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
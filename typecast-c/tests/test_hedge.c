@@ -0,0 +1,276 @@
+/**
+ * Hedging tests: a seeded request without a response byte in time is
+ * duplicated to the same or an alternate host, the first answer wins and
+ * the hedge shows up in the metrics
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+/* The first `slow` TTS requests are held for slow_ms, later ones answer
+ * at once with `audio` */
+typedef struct {
+    pthread_mutex_t lock;
+    int slow;
+    int slow_ms;
+    int status;
+    int requests;
+    const char* audio;
+} Plan;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = (Plan*)user_data;
+    pthread_mutex_lock(&plan->lock);
+    int n = plan->requests++;
+    pthread_mutex_unlock(&plan->lock);
+    if (n < plan->slow) resp->delay_ms = plan->slow_ms;
+    if (plan->status) resp->status = plan->status;
+    resp->body = (const uint8_t*)plan->audio;
+    resp->body_len = strlen(plan->audio);
+    (void)req;
+}
+
+static TypecastRequestMetrics last_metrics;
+
+static void record_metrics(const TypecastRequestMetrics* metrics, void* user_data) {
+    (void)user_data;
+    last_metrics = *metrics;
+}
+
+static long elapsed_ms(const struct timespec* from) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - from->tv_sec) * 1000L + (now.tv_nsec - from->tv_nsec) / 1000000L;
+}
+
+static TypecastTTSResponse* speak(TypecastClient* client, int seed) {
+    TypecastTTSRequest req = {0};
+    req.text = "hedged";
+    req.voice_id = "tc_voice";
+    req.seed = seed;
+    return typecast_text_to_speech(client, &req);
+}
+
+static void test_hedge_to_same_host_wins(void) {
+    for (int thread_safe = 0; thread_safe <= 1; thread_safe++) {
+        Plan plan = {PTHREAD_MUTEX_INITIALIZER, 1, 1500, 0, 0, "RIFF-fast"};
+        MockServer server;
+        ASSERT(mock_server_start(&server, route, &plan));
+        char host[64];
+        mock_server_host(&server, host, sizeof(host));
+        TypecastClientOptions options = {0};
+        options.thread_safe = thread_safe;
+        options.hedge_after_ms = 100;
+        options.metrics_callback = record_metrics;
+        TypecastClient* client = typecast_client_create_with_options("test-key", host, &options);
+
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        TypecastTTSResponse* resp = speak(client, 7);
+        ASSERT(resp != NULL);
+        ASSERT(elapsed_ms(&start) < 1000);
+        ASSERT_EQ(resp->audio_size, strlen("RIFF-fast"));
+        ASSERT(memcmp(resp->audio_data, "RIFF-fast", resp->audio_size) == 0);
+        ASSERT_EQ(last_metrics.hedges, 1u);
+        ASSERT_EQ(last_metrics.hedge_won, 1);
+        ASSERT_EQ(server.requests, 2);
+        typecast_tts_response_free(resp);
+
+        /* A fast answer is never duplicated, and the winner's connection stays warm */
+        resp = speak(client, 7);
+        ASSERT(resp != NULL);
+        ASSERT_EQ(last_metrics.hedges, 0u);
+        ASSERT_EQ(last_metrics.connection_reused, 1);
+        typecast_tts_response_free(resp);
+
+        TypecastClientMetrics totals;
+        ASSERT_EQ(typecast_client_metrics(client, &totals), TYPECAST_OK);
+        ASSERT_EQ(totals.hedged_calls, 1u);
+        ASSERT_EQ(totals.hedge_wins, 1u);
+
+        typecast_client_destroy(client);
+        mock_server_stop(&server);
+    }
+}
+
+static void test_hedge_goes_to_alternate_host(void) {
+    Plan slow = {PTHREAD_MUTEX_INITIALIZER, 100, 1500, 0, 0, "RIFF-primary"};
+    Plan fast = {PTHREAD_MUTEX_INITIALIZER, 0, 0, 0, 0, "RIFF-alternate"};
+    MockServer primary, alternate;
+    ASSERT(mock_server_start(&primary, route, &slow));
+    ASSERT(mock_server_start(&alternate, route, &fast));
+    char host[64], alt[64];
+    mock_server_host(&primary, host, sizeof(host));
+    mock_server_host(&alternate, alt, sizeof(alt));
+    const char* hosts[] = {alt};
+    TypecastClientOptions options = {0};
+    options.hedge_after_ms = 100;
+    options.hedge_hosts = hosts;
+    options.hedge_host_count = 1;
+    options.metrics_callback = record_metrics;
+    TypecastClient* client = typecast_client_create_with_options("test-key", host, &options);
+
+    TypecastTTSResponse* resp = speak(client, 3);
+    ASSERT(resp != NULL);
+    ASSERT(memcmp(resp->audio_data, "RIFF-alternate", resp->audio_size) == 0);
+    ASSERT_EQ(last_metrics.hedge_won, 1);
+    ASSERT_EQ(alternate.requests, 1);
+    typecast_tts_response_free(resp);
+
+    /* Unseeded requests may render differently, so they are never hedged */
+    resp = speak(client, 0);
+    ASSERT(resp != NULL);
+    ASSERT(memcmp(resp->audio_data, "RIFF-primary", resp->audio_size) == 0);
+    ASSERT_EQ(last_metrics.hedges, 0u);
+    ASSERT_EQ(alternate.requests, 1);
+    typecast_tts_response_free(resp);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&primary);
+    mock_server_stop(&alternate);
+}
+
+static void test_hedge_waits_for_a_definite_answer(void) {
+    /* The duplicate fails fast with a 503; the slow original still wins */
+    Plan slow = {PTHREAD_MUTEX_INITIALIZER, 100, 400, 0, 0, "RIFF-primary"};
+    Plan failing = {PTHREAD_MUTEX_INITIALIZER, 0, 0, 503, 0, "{\"detail\":\"busy\"}"};
+    MockServer primary, alternate;
+    ASSERT(mock_server_start(&primary, route, &slow));
+    ASSERT(mock_server_start(&alternate, route, &failing));
+    char host[64], alt[64];
+    mock_server_host(&primary, host, sizeof(host));
+    mock_server_host(&alternate, alt, sizeof(alt));
+    const char* hosts[] = {alt};
+    TypecastClientOptions options = {0};
+    options.hedge_after_ms = 50;
+    options.hedge_hosts = hosts;
+    options.hedge_host_count = 1;
+    options.metrics_callback = record_metrics;
+    TypecastClient* client = typecast_client_create_with_options("test-key", host, &options);
+
+    TypecastTTSResponse* resp = speak(client, 3);
+    ASSERT(resp != NULL);
+    ASSERT(memcmp(resp->audio_data, "RIFF-primary", resp->audio_size) == 0);
+    ASSERT_EQ(last_metrics.hedges, 1u);
+    ASSERT_EQ(last_metrics.hedge_won, 0);
+    typecast_tts_response_free(resp);
+
+    /* Both fail: the original's error is reported */
+    slow.status = 500;
+    resp = speak(client, 3);
+    ASSERT(resp == NULL);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INTERNAL_SERVER);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&primary);
+    mock_server_stop(&alternate);
+}
+
+static void test_percentile_delay_follows_observed_latency(void) {
+    Plan plan = {PTHREAD_MUTEX_INITIALIZER, 0, 0, 0, 0, "RIFF-fast"};
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, &plan));
+    char host[64];
+    mock_server_host(&server, host, sizeof(host));
+    TypecastClientOptions options = {0};
+    options.hedge_after_ms = 5000;
+    options.hedge_percentile = 95;
+    options.metrics_callback = record_metrics;
+    TypecastClient* client = typecast_client_create_with_options("test-key", host, &options);
+
+    /* Fast calls pull the delay far below hedge_after_ms */
+    for (int i = 0; i < 25; i++) {
+        typecast_tts_response_free(speak(client, 1));
+        ASSERT_EQ(last_metrics.hedges, 0u);
+    }
+    pthread_mutex_lock(&plan.lock);
+    plan.slow = plan.requests + 1;
+    plan.slow_ms = 1500;
+    pthread_mutex_unlock(&plan.lock);
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TypecastTTSResponse* resp = speak(client, 1);
+    ASSERT(resp != NULL);
+    ASSERT(elapsed_ms(&start) < 1000);
+    ASSERT_EQ(last_metrics.hedge_won, 1);
+    typecast_tts_response_free(resp);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_hedge_takes_a_governor_slot(void) {
+    Plan plan = {PTHREAD_MUTEX_INITIALIZER, 1, 600, 0, 0, "RIFF-fast"};
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, &plan));
+    char host[64];
+    mock_server_host(&server, host, sizeof(host));
+    TypecastClientOptions options = {0};
+    options.thread_safe = 1;
+    options.hedge_after_ms = 50;
+    options.max_concurrent_requests = 1;
+    options.metrics_callback = record_metrics;
+    TypecastClient* client = typecast_client_create_with_options("test-key", host, &options);
+
+    /* The original holds the only slot, so there is no duplicate */
+    TypecastTTSResponse* resp = speak(client, 5);
+    ASSERT(resp != NULL);
+    ASSERT_EQ(last_metrics.hedges, 0u);
+    ASSERT_EQ(server.requests, 1);
+    typecast_tts_response_free(resp);
+    typecast_client_destroy(client);
+
+    /* With room for it the duplicate goes out, and its slot comes back:
+     * otherwise the second call would find the window full */
+    options.max_concurrent_requests = 2;
+    client = typecast_client_create_with_options("test-key", host, &options);
+    for (int round = 0; round < 2; round++) {
+        pthread_mutex_lock(&plan.lock);
+        plan.slow = plan.requests + 1;
+        pthread_mutex_unlock(&plan.lock);
+        resp = speak(client, 5);
+        ASSERT(resp != NULL);
+        ASSERT_EQ(last_metrics.hedges, 1u);
+        ASSERT_EQ(last_metrics.hedge_won, 1);
+        typecast_tts_response_free(resp);
+    }
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    RUN(hedge_to_same_host_wins);
+    RUN(hedge_goes_to_alternate_host);
+    RUN(hedge_waits_for_a_definite_answer);
+    RUN(percentile_delay_follows_observed_latency);
+    RUN(hedge_takes_a_governor_slot);
+    printf("\nHedge tests: %d run, %d failed\n", tests_run, tests_failed);
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,436 @@
+/**
+ * Call metrics tests: the per-call breakdown handed to metrics_callback
+ * and the client's running totals
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static const char AUDIO[] = "RIFF-metrics-audio";
+static const char VOICES[] = "[{\"voice_id\":\"tc_1\",\"voice_name\":\"One\",\"models\":[]}]";
+static const char TIMESTAMPS_JSON[] =
+    "{\"audio\":\"QVVESU8tQVVESU8tQVVESU8=\",\"audio_format\":\"wav\",\"audio_duration\":1.0,"
+    "\"words\":[{\"text\":\"Hello.\",\"start\":0.0,\"end\":0.5}],\"characters\":null}";
+
+typedef struct {
+    int fail_first;                  /* answer the first N TTS requests with 500 */
+    int tts_requests;
+} Plan;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = (Plan*)user_data;
+    const char* body = AUDIO;
+    if (strcmp(req->method, "DELETE") == 0) {
+        resp->status = 204;
+        body = "";
+    } else if (strncmp(req->path, "/v2/voices", 10) == 0) {
+        body = VOICES;
+    } else if (strncmp(req->path, "/v1/text-to-speech/with-timestamps", 34) == 0) {
+        body = TIMESTAMPS_JSON;
+    } else if (strcmp(req->path, "/v1/text-to-speech/stream") == 0) {
+        resp->chunk_size = 4;
+    } else if (plan->tts_requests++ < plan->fail_first) {
+        resp->status = 500;
+        body = "{\"detail\":\"busy\"}";
+    }
+    resp->body = (const uint8_t*)body;
+    resp->body_len = strlen(body);
+}
+
+#define MAX_SEEN 8
+
+typedef struct {
+    TypecastRequestMetrics seen[MAX_SEEN];
+    int count;
+} Recorder;
+
+static void record(const TypecastRequestMetrics* metrics, void* user_data) {
+    Recorder* r = (Recorder*)user_data;
+    if (r->count < MAX_SEEN) r->seen[r->count] = *metrics;
+    r->count++;
+}
+
+static TypecastClient* new_client(MockServer* server, Plan* plan, Recorder* recorder, TypecastClientOptions* options) {
+    TypecastClientOptions defaults = {0};
+    if (!options) options = &defaults;
+    options->metrics_callback = record;
+    options->metrics_user_data = recorder;
+    mock_server_start(server, route, plan);
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options);
+}
+
+static TypecastTTSRequest tts_request(void) {
+    TypecastTTSRequest req = {0};
+    req.text = "hello";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    return req;
+}
+
+static int on_chunk(const uint8_t* data, size_t size, void* user_data) {
+    (void)data;
+    *(size_t*)user_data += size;
+    return 0;
+}
+
+static void test_tts_breakdown(void) {
+    MockServer server;
+    Plan plan = {0};
+    Recorder rec = {0};
+    TypecastClient* client = new_client(&server, &plan, &rec, NULL);
+    TypecastTTSRequest req = tts_request();
+    TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+    resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+
+    ASSERT_EQ(rec.count, 2);
+    const TypecastRequestMetrics* m = &rec.seen[0];
+    ASSERT_EQ(m->type, TYPECAST_REQUEST_TTS);
+    ASSERT_EQ(m->result, TYPECAST_OK);
+    ASSERT_EQ(m->http_status, 200);
+    ASSERT_EQ(m->attempts, 1u);
+    ASSERT(!m->connection_reused);
+    ASSERT(rec.seen[1].connection_reused);
+    ASSERT_EQ(m->bytes_received, (uint64_t)strlen(AUDIO));
+    ASSERT(m->bytes_sent > 0);
+    ASSERT(m->connect_us >= m->dns_us);
+    ASSERT(m->first_byte_us >= m->connect_us);
+    ASSERT(m->transfer_us >= m->first_byte_us);
+    ASSERT(m->transfer_us > 0);
+    ASSERT(m->call_us >= m->transfer_us);
+    ASSERT(m->prepare_us >= 0 && m->parse_us >= 0);
+    ASSERT_EQ(m->first_audio_us, 0);
+    ASSERT_EQ(m->decode_us, 0);
+
+    TypecastClientMetrics totals;
+    ASSERT_EQ(typecast_client_metrics(client, &totals), TYPECAST_OK);
+    ASSERT_EQ(totals.calls, 2ull);
+    ASSERT_EQ(totals.failed_calls, 0ull);
+    ASSERT_EQ(totals.attempts, 2ull);
+    ASSERT_EQ(totals.reused_connections, 1ull);
+    ASSERT_EQ(totals.bytes_received, 2ull * strlen(AUDIO));
+    ASSERT(totals.call_us >= totals.first_byte_us);
+
+    typecast_client_metrics_reset(client);
+    ASSERT_EQ(typecast_client_metrics(client, &totals), TYPECAST_OK);
+    ASSERT_EQ(totals.calls, 0ull);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_retries_and_failures(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.fail_first = 3;
+    Recorder rec = {0};
+    TypecastClientOptions options = {0};
+    options.max_retries = 1;
+    options.retry_base_delay_ms = 1;
+    TypecastClient* client = new_client(&server, &plan, &rec, &options);
+    TypecastTTSRequest req = tts_request();
+    ASSERT(typecast_text_to_speech(client, &req) == NULL);
+    TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+
+    ASSERT_EQ(rec.count, 2);
+    ASSERT_EQ(rec.seen[0].result, TYPECAST_ERROR_INTERNAL_SERVER);
+    ASSERT_EQ(rec.seen[0].http_status, 500);
+    ASSERT_EQ(rec.seen[0].attempts, 2u);
+    ASSERT_EQ(rec.seen[1].result, TYPECAST_OK);
+    ASSERT_EQ(rec.seen[1].attempts, 2u);
+    /* The 500 body of the first attempt counts too */
+    ASSERT_EQ(rec.seen[1].bytes_received, (uint64_t)(strlen(AUDIO) + strlen("{\"detail\":\"busy\"}")));
+
+    TypecastClientMetrics totals;
+    typecast_client_metrics(client, &totals);
+    ASSERT_EQ(totals.calls, 2ull);
+    ASSERT_EQ(totals.failed_calls, 1ull);
+    ASSERT_EQ(totals.attempts, 4ull);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_stream_first_audio(void) {
+    MockServer server;
+    Plan plan = {0};
+    Recorder rec = {0};
+    TypecastClient* client = new_client(&server, &plan, &rec, NULL);
+    TypecastTTSRequestStream req = {0};
+    req.text = "hello";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    size_t received = 0;
+    ASSERT_EQ(typecast_text_to_speech_stream(client, &req, on_chunk, &received), TYPECAST_OK);
+    ASSERT_EQ(received, strlen(AUDIO));
+    ASSERT_EQ(rec.count, 1);
+    ASSERT_EQ(rec.seen[0].type, TYPECAST_REQUEST_STREAM);
+    ASSERT(rec.seen[0].first_audio_us > 0);
+    ASSERT(rec.seen[0].first_audio_us <= rec.seen[0].call_us);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_timestamps_decode(void) {
+    MockServer server;
+    Plan plan = {0};
+    Recorder rec = {0};
+    TypecastClient* client = new_client(&server, &plan, &rec, NULL);
+    TypecastTTSRequestWithTimestamps req = {0};
+    req.text = "hello";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    TypecastTTSWithTimestampsDecodedResponse* resp = NULL;
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_decoded(client, &req, NULL, NULL, &resp), TYPECAST_OK);
+    ASSERT(resp != NULL);
+    typecast_tts_with_timestamps_decoded_response_free(resp);
+
+    size_t received = 0;
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_decoded(client, &req, on_chunk, &received, &resp), TYPECAST_OK);
+    typecast_tts_with_timestamps_decoded_response_free(resp);
+    ASSERT_EQ(received, strlen("AUDIO-AUDIO-AUDIO"));
+
+    ASSERT_EQ(rec.count, 2);
+    ASSERT_EQ(rec.seen[0].type, TYPECAST_REQUEST_TIMESTAMPS);
+    ASSERT_EQ(rec.seen[0].bytes_received, (uint64_t)strlen(TIMESTAMPS_JSON));
+    ASSERT(rec.seen[0].decode_us >= 0);
+    ASSERT(rec.seen[0].parse_us >= 0);
+    ASSERT_EQ(rec.seen[0].first_audio_us, 0);
+    ASSERT(rec.seen[1].first_audio_us > 0);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_query_and_delete_calls(void) {
+    MockServer server;
+    Plan plan = {0};
+    Recorder rec = {0};
+    TypecastClient* client = new_client(&server, &plan, &rec, NULL);
+    TypecastVoicesResponse* voices = typecast_get_voices(client, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+    ASSERT_EQ(typecast_delete_voice(client, "uc_1"), TYPECAST_OK);
+    /* Rejected before any request: not reported */
+    ASSERT_EQ(typecast_delete_voice(client, ""), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(typecast_get_voices(NULL, NULL) == NULL);
+
+    ASSERT_EQ(rec.count, 2);
+    ASSERT_EQ(rec.seen[0].type, TYPECAST_REQUEST_VOICES);
+    ASSERT_EQ(rec.seen[0].http_status, 200);
+    ASSERT_EQ(rec.seen[0].bytes_received, (uint64_t)strlen(VOICES));
+    ASSERT_EQ(rec.seen[0].bytes_sent, 0u);
+    ASSERT_EQ(rec.seen[1].type, TYPECAST_REQUEST_DELETE);
+    ASSERT_EQ(rec.seen[1].http_status, 204);
+    ASSERT_EQ(rec.seen[1].result, TYPECAST_OK);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_cache_hits_not_reported(void) {
+    MockServer server;
+    Plan plan = {0};
+    Recorder rec = {0};
+    TypecastClientOptions options = {0};
+    options.result_cache_max_bytes = 4096;
+    TypecastClient* client = new_client(&server, &plan, &rec, &options);
+    TypecastTTSRequest req = tts_request();
+    req.seed = 7;
+    for (int i = 0; i < 2; i++) {
+        TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+        ASSERT(resp != NULL);
+        typecast_tts_response_free(resp);
+    }
+    ASSERT_EQ(rec.count, 1);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_async_job_reported(void) {
+    MockServer server;
+    Plan plan = {0};
+    Recorder rec = {0};
+    TypecastClient* client = new_client(&server, &plan, &rec, NULL);
+    TypecastTTSRequest req = tts_request();
+    TypecastAsyncJob* job = typecast_async_text_to_speech(client, &req, NULL, NULL);
+    ASSERT(job != NULL);
+    ASSERT_EQ(typecast_async_wait(client, job), TYPECAST_OK);
+    typecast_async_job_free(job);
+    ASSERT_EQ(rec.count, 1);
+    ASSERT_EQ(rec.seen[0].type, TYPECAST_REQUEST_TTS);
+    ASSERT_EQ(rec.seen[0].attempts, 1u);
+    ASSERT_EQ(rec.seen[0].bytes_received, (uint64_t)strlen(AUDIO));
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+/* GZIP_DOC decompresses to the document build_words_doc() writes: with
+ * timestamps for 40 words */
+static const uint8_t GZIP_DOC[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x65, 0xd5, 0xcb, 0x6a, 0x02, 0x41,
+    0x10, 0x85, 0xe1, 0x77, 0xe9, 0xb5, 0x88, 0x55, 0xd5, 0xb7, 0x11, 0xb2, 0xcc, 0x03, 0x84, 0x10,
+    0x37, 0x21, 0x84, 0x41, 0x0d, 0x11, 0x8c, 0xc2, 0x38, 0xc6, 0x80, 0xf8, 0xee, 0x19, 0x93, 0x78,
+    0x38, 0xa9, 0x59, 0xf5, 0x85, 0x6f, 0xd5, 0x3f, 0xdd, 0x7d, 0x0e, 0xed, 0x71, 0xb5, 0xd9, 0x87,
+    0x79, 0x78, 0x58, 0x2c, 0xee, 0x1f, 0x9f, 0x6a, 0xef, 0xc6, 0xbb, 0x30, 0xf9, 0x25, 0xaf, 0x6f,
+    0xfb, 0xee, 0xa3, 0xed, 0x07, 0x79, 0x6a, 0x3f, 0xb1, 0xb9, 0x3a, 0x76, 0x6d, 0xbf, 0xd9, 0xef,
+    0xc2, 0x3c, 0x4e, 0x67, 0x93, 0x70, 0xda, 0x77, 0xab, 0x43, 0x98, 0x3f, 0x9f, 0x43, 0xbf, 0xfe,
+    0xfa, 0xb1, 0xc3, 0xc6, 0x6c, 0xd0, 0x87, 0xbe, 0xed, 0x86, 0xf5, 0xec, 0x8a, 0xd6, 0xbb, 0xd5,
+    0x75, 0x26, 0x97, 0xc9, 0x3f, 0x26, 0xcc, 0x04, 0x4c, 0x1d, 0x53, 0x66, 0x0a, 0x66, 0x8e, 0x19,
+    0x33, 0x03, 0x8b, 0x8e, 0x45, 0x66, 0x11, 0x2c, 0x39, 0x96, 0x98, 0x25, 0xb0, 0xec, 0x58, 0x66,
+    0x96, 0xc1, 0x8a, 0x63, 0x85, 0x59, 0x01, 0xab, 0x8e, 0x55, 0x66, 0x15, 0xac, 0x71, 0xac, 0x61,
+    0xd6, 0xfc, 0x31, 0x99, 0xce, 0xfc, 0xf1, 0x52, 0x06, 0x41, 0x06, 0x19, 0x67, 0x10, 0x76, 0x02,
+    0xe7, 0x3b, 0x88, 0xb2, 0x53, 0x38, 0x1f, 0x42, 0x8c, 0x9d, 0xc1, 0xf9, 0x12, 0x12, 0xd9, 0x45,
+    0x38, 0x9f, 0x42, 0x12, 0xbb, 0x04, 0xe7, 0x5b, 0x48, 0x66, 0x97, 0xe1, 0x7c, 0x0c, 0x29, 0xec,
+    0x0a, 0x9c, 0xaf, 0x21, 0x95, 0x5d, 0x85, 0xf3, 0x39, 0xa4, 0x61, 0x77, 0xeb, 0xa1, 0xa3, 0x1e,
+    0x4a, 0x3d, 0x14, 0x3d, 0x74, 0xd4, 0x43, 0x85, 0x9d, 0xc0, 0x8d, 0xee, 0x85, 0xb2, 0x53, 0x38,
+    0xdf, 0x43, 0x8d, 0x9d, 0xc1, 0xf9, 0x1e, 0x1a, 0xd9, 0x45, 0x38, 0xdf, 0x43, 0x13, 0xbb, 0x04,
+    0xe7, 0x7b, 0x68, 0x66, 0x97, 0xe1, 0x7c, 0x0f, 0x2d, 0xec, 0x0a, 0x9c, 0xef, 0xa1, 0x95, 0x5d,
+    0x85, 0xf3, 0x3d, 0xb4, 0x61, 0x77, 0xeb, 0x61, 0xa3, 0x1e, 0x46, 0x3d, 0x0c, 0x3d, 0x6c, 0xd4,
+    0xc3, 0x84, 0x9d, 0xc0, 0xf9, 0x1e, 0xa6, 0xec, 0x14, 0x6e, 0xf4, 0x50, 0x19, 0x3b, 0x83, 0xf3,
+    0x3d, 0x2c, 0xb2, 0x8b, 0x70, 0xbe, 0x87, 0x25, 0x76, 0x09, 0xce, 0xf7, 0xb0, 0xcc, 0x2e, 0xc3,
+    0xf9, 0x1e, 0x56, 0xd8, 0x15, 0x38, 0xdf, 0xc3, 0x2a, 0xbb, 0x0a, 0xe7, 0x7b, 0x58, 0xc3, 0xee,
+    0xd6, 0x63, 0xf8, 0x3d, 0x2e, 0x2f, 0x93, 0xb0, 0x7c, 0x6f, 0xbb, 0x76, 0xd9, 0xaf, 0xbb, 0xe1,
+    0x13, 0xd9, 0x1d, 0xb7, 0xdb, 0xcb, 0x37, 0x05, 0x4d, 0xf5, 0x8e, 0xa0, 0x06, 0x00, 0x00
+};
+
+static size_t build_words_doc(char* out, size_t size) {
+    size_t n = (size_t)snprintf(out, size, "{\"audio\":\"QVVESU8tQVVESU8tQVVESU8=\",\"audio_format\":\"wav\","
+                                "\"audio_duration\":4.0,\"words\":[");
+    for (int i = 0; i < 40; i++) {
+        n += (size_t)snprintf(out + n, size - n, "%s{\"text\":\"word%d\",\"start\":%.1f,\"end\":%.1f}",
+                              i ? "," : "", i, i / 10.0, (i + 1) / 10.0);
+    }
+    n += (size_t)snprintf(out + n, size - n, "],\"characters\":null}");
+    return n;
+}
+
+typedef struct {
+    const char* plain;
+    int accept_encoding[3];          /* per request kind: timestamps, voices, tts */
+} CompressPlan;
+
+static void compress_route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    CompressPlan* plan = (CompressPlan*)user_data;
+    int asked = strstr(req->headers, "Accept-Encoding:") != NULL;
+    if (strncmp(req->path, "/v1/text-to-speech/with-timestamps", 34) == 0) {
+        plan->accept_encoding[0] = asked;
+        if (asked && strstr(req->headers, "gzip")) {
+            snprintf(resp->headers, sizeof(resp->headers), "Content-Encoding: gzip\r\n");
+            resp->body = GZIP_DOC;
+            resp->body_len = sizeof(GZIP_DOC);
+            return;
+        }
+        resp->body = (const uint8_t*)plan->plain;
+    } else if (strncmp(req->path, "/v2/voices", 10) == 0) {
+        plan->accept_encoding[1] = asked;
+        resp->body = (const uint8_t*)VOICES;
+    } else {
+        plan->accept_encoding[2] = asked;
+        resp->body = (const uint8_t*)AUDIO;
+    }
+    resp->body_len = strlen((const char*)resp->body);
+}
+
+static void test_compressed_json(void) {
+    char plain[2048];
+    size_t plain_len = build_words_doc(plain, sizeof(plain));
+    for (int disabled = 0; disabled <= 1; disabled++) {
+        CompressPlan plan = {plain, {0, 0, 0}};
+        MockServer server;
+        ASSERT(mock_server_start(&server, compress_route, &plan));
+        char host[64];
+        mock_server_host(&server, host, sizeof(host));
+        Recorder rec = {0};
+        TypecastClientOptions options = {0};
+        options.disable_compression = disabled;
+        options.metrics_callback = record;
+        options.metrics_user_data = &rec;
+        TypecastClient* client = typecast_client_create_with_options("test-key", host, &options);
+
+        TypecastTTSRequestWithTimestamps req = {0};
+        req.text = "hello";
+        req.voice_id = "tc_voice";
+        req.model = TYPECAST_MODEL_SSFM_V30;
+        TypecastTTSWithTimestampsResponse* resp = NULL;
+        ASSERT_EQ(typecast_text_to_speech_with_timestamps(client, &req, &resp), TYPECAST_OK);
+        ASSERT_EQ(resp->words_count, 40u);
+        typecast_tts_with_timestamps_response_free(resp);
+        typecast_voices_response_free(typecast_get_voices(client, NULL));
+        TypecastTTSRequest tts = tts_request();
+        typecast_tts_response_free(typecast_text_to_speech(client, &tts));
+
+        /* Audio bodies are never negotiated */
+        ASSERT_EQ(plan.accept_encoding[0], !disabled);
+        ASSERT_EQ(plan.accept_encoding[1], !disabled);
+        ASSERT_EQ(plan.accept_encoding[2], 0);
+        ASSERT_EQ(rec.count, 3);
+        ASSERT_EQ(rec.seen[0].bytes_decoded, (uint64_t)plain_len);
+        ASSERT_EQ(rec.seen[0].bytes_received, disabled ? (uint64_t)plain_len : (uint64_t)sizeof(GZIP_DOC));
+        ASSERT_EQ(rec.seen[2].bytes_decoded, rec.seen[2].bytes_received);
+        TypecastClientMetrics totals;
+        ASSERT_EQ(typecast_client_metrics(client, &totals), TYPECAST_OK);
+        ASSERT(totals.bytes_decoded >= (unsigned long long)plain_len);
+        typecast_client_destroy(client);
+        mock_server_stop(&server);
+    }
+}
+
+static void test_invalid_arguments(void) {
+    TypecastClientMetrics totals;
+    ASSERT_EQ(typecast_client_metrics(NULL, &totals), TYPECAST_ERROR_INVALID_PARAM);
+    TypecastClient* client = typecast_client_create("test-key");
+    ASSERT_EQ(typecast_client_metrics(client, NULL), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_client_metrics(client, &totals), TYPECAST_OK);
+    ASSERT_EQ(totals.calls, 0ull);
+    typecast_client_metrics_reset(client);
+    typecast_client_metrics_reset(NULL);
+    typecast_client_destroy(client);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Metrics Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(tts_breakdown);
+    RUN(retries_and_failures);
+    RUN(stream_first_audio);
+    RUN(timestamps_decode);
+    RUN(query_and_delete_calls);
+    RUN(cache_hits_not_reported);
+    RUN(async_job_reported);
+    RUN(compressed_json);
+    RUN(invalid_arguments);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
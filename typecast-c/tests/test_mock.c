@@ -16,7 +16,9 @@
 #include <stdarg.h>
 #include <errno.h>
 #include <pthread.h>
+#include <signal.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -24,6 +26,10 @@
 
 #include "typecast.h"
 
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
 /* ============================================
  * Test bookkeeping
  * ============================================ */
@@ -240,7 +246,7 @@ static void send_all(int fd, const void* data, size_t len) {
     const uint8_t* p = (const uint8_t*)data;
     size_t off = 0;
     while (off < len) {
-        ssize_t n = send(fd, p + off, len - off, 0);
+        ssize_t n = send(fd, p + off, len - off, MSG_NOSIGNAL);
         if (n <= 0) return;
         off += (size_t)n;
     }
@@ -694,6 +700,38 @@ static void test_tts_with_output_volume_mp3(void) {
     typecast_client_destroy(c);
 }
 
+/* The whole body, byte for byte: escaping, number format and field order */
+static void test_tts_body_serialization_exact(void) {
+    TypecastClient* c = new_client();
+    mock_enqueue_text(200, NULL, "MP3DATA");
+
+    TypecastPrompt prompt = {0};
+    prompt.emotion_type = TYPECAST_EMOTION_TYPE_PRESET;
+    prompt.emotion_preset = TYPECAST_EMOTION_HAPPY;
+    prompt.emotion_intensity = 0.3f;
+    TypecastOutput out = TYPECAST_OUTPUT_DEFAULT();
+    out.volume = 80; out.audio_pitch = -2; out.audio_tempo = 1.25f;
+    out.audio_format = TYPECAST_AUDIO_FORMAT_MP3;
+
+    TypecastTTSRequest req = {0};
+    req.text = "say \"hi\"\n\tback\\slash \x01 caf\xC3\xA9";
+    req.voice_id = "tc_xx"; req.model = TYPECAST_MODEL_SSFM_V30;
+    req.language = "eng"; req.prompt = &prompt; req.output = &out; req.seed = 42;
+
+    TypecastTTSResponse* r = typecast_text_to_speech(c, &req);
+    ASSERT_NOT_NULL(r);
+    ASSERT_STREQ(g_server.last_body,
+        "{\"text\":\"say \\\"hi\\\"\\n\\tback\\\\slash \\u0001 caf\xC3\xA9\",\"voice_id\":\"tc_xx\","
+        "\"model\":\"ssfm-v30\",\"language\":\"eng\",\"prompt\":{\"emotion_type\":\"preset\","
+        "\"emotion_preset\":\"happy\",\"emotion_intensity\":0.300000011920929},"
+        "\"output\":{\"volume\":80,\"audio_pitch\":-2,\"audio_tempo\":1.25,\"audio_format\":\"mp3\"},"
+        "\"seed\":42}");
+    ASSERT_EQ(g_server.last_body_len, strlen(g_server.last_body));
+
+    typecast_tts_response_free(r);
+    typecast_client_destroy(c);
+}
+
 static void test_tts_with_output_lufs(void) {
     TypecastClient* c = new_client();
     mock_enqueue_text(200, NULL, "WAV");
@@ -813,6 +851,102 @@ static void test_generate_to_file_infers_wav_and_handles_errors(void) {
     typecast_client_destroy(c);
 }
 
+static void test_generate_to_file_streams_large_chunked_body(void) {
+    TypecastClient* c = new_client();
+    static uint8_t audio[200 * 1024];
+    for (size_t i = 0; i < sizeof(audio); i++) audio[i] = (uint8_t)(i * 31);
+    mock_enqueue_chunked(200, audio, sizeof(audio));
+
+    char path[256];
+    snprintf(path, sizeof(path), "/tmp/typecast-generate-%d-large.wav", (int)getpid());
+    unlink(path);
+    TypecastGenerateToFileRequest req = {0};
+    req.text = "long render";
+    req.voice_id = "tc_file";
+    ASSERT_EQ(typecast_generate_to_file(c, path, &req), TYPECAST_OK);
+
+    FILE* f = fopen(path, "rb");
+    ASSERT_NOT_NULL(f);
+    static uint8_t back[sizeof(audio) + 1];
+    size_t n = fread(back, 1, sizeof(back), f);
+    fclose(f);
+    unlink(path);
+    ASSERT_EQ(n, sizeof(audio));
+    ASSERT(memcmp(back, audio, sizeof(audio)) == 0);
+
+    /* A failed render leaves neither the destination nor the temp file */
+    char temp_path[300];
+    snprintf(temp_path, sizeof(temp_path), "%s.typecast-tmp", path);
+    mock_enqueue_text(500, NULL, "{\"detail\":\"boom\"}");
+    ASSERT_EQ(typecast_generate_to_file(c, path, &req), TYPECAST_ERROR_INTERNAL_SERVER);
+    ASSERT(access(path, F_OK) != 0);
+    ASSERT(access(temp_path, F_OK) != 0);
+
+    typecast_client_destroy(c);
+}
+
+static void test_generate_to_fp_and_fd(void) {
+    TypecastClient* c = new_client();
+    TypecastGenerateToFileRequest req = {0};
+    req.text = "hello stream";
+    req.voice_id = "tc_file";
+
+    FILE* f = tmpfile();
+    ASSERT_NOT_NULL(f);
+    fputs("HDR:", f);
+    mock_enqueue_text(200, NULL, "FPDATA");
+    ASSERT_EQ(typecast_generate_to_fp(c, f, &req), TYPECAST_OK);
+    ASSERT_EQ(typecast_client_get_error(c)->code, TYPECAST_OK);
+    /* No file name, so no inferred format */
+    ASSERT(strstr(g_server.last_body, "\"audio_format\"") == NULL);
+
+    /* Error bodies are reported, not written to the stream */
+    mock_enqueue_text(401, NULL, "{\"detail\":\"bad\"}");
+    ASSERT_EQ(typecast_generate_to_fp(c, f, &req), TYPECAST_ERROR_UNAUTHORIZED);
+    ASSERT_STREQ(typecast_client_get_error(c)->message, "bad");
+    rewind(f);
+    char buf[32] = {0};
+    fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    ASSERT_STREQ(buf, "HDR:FPDATA");
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    TypecastOutput out = TYPECAST_OUTPUT_DEFAULT();
+    out.audio_format = TYPECAST_AUDIO_FORMAT_MP3;
+    req.output = &out;
+    mock_enqueue_chunked(200, (const uint8_t*)"FD-CHUNKED", 10);
+    ASSERT_EQ(typecast_generate_to_fd(c, fds[1], &req), TYPECAST_OK);
+    ASSERT(strstr(g_server.last_body, "\"audio_format\":\"mp3\"") != NULL);
+    close(fds[1]);
+    memset(buf, 0, sizeof(buf));
+    ssize_t n = read(fds[0], buf, sizeof(buf) - 1);
+    close(fds[0]);
+    ASSERT_EQ(n, 10);
+    ASSERT_STREQ(buf, "FD-CHUNKED");
+
+    /* A descriptor that cannot be written fails the call */
+    int ro = open("/dev/null", O_RDONLY);
+    ASSERT(ro >= 0);
+    mock_enqueue_text(200, NULL, "AUDIO");
+    ASSERT_EQ(typecast_generate_to_fd(c, ro, &req), TYPECAST_ERROR_NETWORK);
+    ASSERT_STREQ(typecast_client_get_error(c)->message, "Failed to write output file");
+    close(ro);
+
+    mock_enqueue_close();
+    ASSERT_EQ(typecast_generate_to_fd(c, STDERR_FILENO, &req), TYPECAST_ERROR_NETWORK);
+
+    ASSERT_EQ(typecast_generate_to_fp(NULL, stdout, &req), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_generate_to_fp(c, NULL, &req), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_generate_to_fp(c, stdout, NULL), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_generate_to_fd(NULL, 1, &req), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_generate_to_fd(c, -1, &req), TYPECAST_ERROR_INVALID_PARAM);
+    req.voice_id = " ";
+    ASSERT_EQ(typecast_generate_to_fd(c, 1, &req), TYPECAST_ERROR_INVALID_PARAM);
+
+    typecast_client_destroy(c);
+}
+
 static void test_tts_prompt_preset(void) {
     TypecastClient* c = new_client();
     mock_enqueue_text(200, NULL, "AUDIO");
@@ -1890,6 +2024,10 @@ int main(void) {
     printf("Typecast C SDK Mock Coverage Tests\n");
     printf("===========================================\n\n");
 
+    /* The client may hang up while the mock is still writing a body, and
+     * the fd tests write to pipes; neither may kill the run */
+    signal(SIGPIPE, SIG_IGN);
+
     mock_init();
 
     /* Pure utilities */
@@ -1919,9 +2057,12 @@ int main(void) {
     RUN(tts_proxy_without_api_key_omits_header);
     RUN(tts_with_output_volume_mp3);
     RUN(tts_with_output_lufs);
+    RUN(tts_body_serialization_exact);
     RUN(generate_to_file_infers_mp3_and_writes_file);
     RUN(generate_to_file_validation_and_explicit_output);
     RUN(generate_to_file_infers_wav_and_handles_errors);
+    RUN(generate_to_file_streams_large_chunked_body);
+    RUN(generate_to_fp_and_fd);
     RUN(tts_prompt_preset);
     RUN(tts_prompt_smart);
     RUN(tts_prompt_smart_no_context);
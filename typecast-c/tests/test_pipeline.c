@@ -0,0 +1,435 @@
+/**
+ * Pipelined sentence TTS tests: splitting, in-order delivery while later
+ * sentences render, smart-emotion context and failure handling
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+#define MAX_REQUESTS 32
+#define WAV_HEADER 44
+
+/* Every sentence comes back as a 16-bit mono WAV whose samples are the
+ * sentence text (padded to whole samples), so the output shows which
+ * sentences arrived in which order */
+typedef struct {
+    pthread_mutex_t lock;
+    char* bodies[MAX_REQUESTS];      /* request bodies, in arrival order */
+    uint8_t* replies[MAX_REQUESTS];
+    int count;
+    const char* slow_text;           /* this sentence answers after slow_ms */
+    int slow_ms;
+    const char* fail_text;           /* this sentence answers 500 */
+    int mp3;                         /* answer with the bare text */
+    int odd_rate_text;               /* sentence index answered at 22050 Hz (1-based) */
+} Plan;
+
+static void put_le32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_le16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static size_t make_wav(uint8_t* out, const char* text, size_t len, uint32_t rate) {
+    size_t data = len + (len & 1);
+    memcpy(out, "RIFF", 4);
+    put_le32(out + 4, (uint32_t)(36 + data));
+    memcpy(out + 8, "WAVEfmt ", 8);
+    put_le32(out + 16, 16);
+    put_le16(out + 20, 1);
+    put_le16(out + 22, 1);
+    put_le32(out + 24, rate);
+    put_le32(out + 28, rate * 2);
+    put_le16(out + 32, 2);
+    put_le16(out + 34, 16);
+    memcpy(out + 36, "data", 4);
+    put_le32(out + 40, (uint32_t)data);
+    memcpy(out + WAV_HEADER, text, len);
+    if (len & 1) out[WAV_HEADER + len] = '_';
+    return WAV_HEADER + data;
+}
+
+/* Value of a string member in the request JSON (no escapes in tests) */
+static int json_string(const char* body, const char* key, char* out, size_t out_size) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":\"", key);
+    const char* start = strstr(body, pattern);
+    if (!start) return 0;
+    start += strlen(pattern);
+    const char* end = strchr(start, '"');
+    size_t len = end ? (size_t)(end - start) : 0;
+    if (len >= out_size) len = out_size - 1;
+    memcpy(out, start, len);
+    out[len] = '\0';
+    return 1;
+}
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = (Plan*)user_data;
+    static char text[4096];
+    pthread_mutex_lock(&plan->lock);
+    int index = plan->count < MAX_REQUESTS ? plan->count++ : MAX_REQUESTS - 1;
+    free(plan->bodies[index]);
+    plan->bodies[index] = strdup(req->body ? req->body : "");
+    if (!json_string(req->body ? req->body : "", "text", text, sizeof(text))) text[0] = '\0';
+    size_t len = strlen(text);
+    free(plan->replies[index]);
+    plan->replies[index] = (uint8_t*)malloc(WAV_HEADER + len + 2);
+    if (plan->fail_text && strcmp(text, plan->fail_text) == 0) {
+        static const char detail[] = "{\"detail\":\"boom\"}";
+        resp->status = 500;
+        resp->body = (const uint8_t*)detail;
+        resp->body_len = strlen(detail);
+    } else if (plan->mp3) {
+        memcpy(plan->replies[index], text, len);
+        resp->body = plan->replies[index];
+        resp->body_len = len;
+    } else {
+        uint32_t rate = plan->odd_rate_text == index + 1 ? 22050 : 44100;
+        resp->body = plan->replies[index];
+        resp->body_len = make_wav(plan->replies[index], text, len, rate);
+    }
+    if (plan->slow_text && strcmp(text, plan->slow_text) == 0) resp->delay_ms = plan->slow_ms;
+    pthread_mutex_unlock(&plan->lock);
+}
+
+typedef struct {
+    uint8_t data[16384];
+    size_t size;
+    int calls;
+    int abort_at;                    /* non-zero: abort on this call */
+    uint64_t first_at;
+} Sink;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000);
+}
+
+static int collect(const uint8_t* data, size_t len, void* user_data) {
+    Sink* sink = (Sink*)user_data;
+    if (sink->calls++ == 0) sink->first_at = now_ms();
+    if (sink->size + len <= sizeof(sink->data)) memcpy(sink->data + sink->size, data, len);
+    sink->size += len;
+    return sink->abort_at && sink->calls >= sink->abort_at;
+}
+
+static TypecastClient* start(MockServer* server, Plan* plan) {
+    pthread_mutex_init(&plan->lock, NULL);
+    mock_server_start(server, route, plan);
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_host("test-key", host);
+}
+
+static void stop(MockServer* server, Plan* plan, TypecastClient* client) {
+    typecast_client_destroy(client);
+    mock_server_stop(server);
+    for (int i = 0; i < MAX_REQUESTS; i++) {
+        free(plan->bodies[i]);
+        free(plan->replies[i]);
+    }
+    pthread_mutex_destroy(&plan->lock);
+}
+
+static TypecastTTSRequest tts_request(const char* text) {
+    TypecastTTSRequest req = {0};
+    req.text = text;
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    return req;
+}
+
+/* The samples after the streamed header, as a string */
+static const char* samples(Sink* sink) {
+    sink->data[sink->size < sizeof(sink->data) ? sink->size : sizeof(sink->data) - 1] = '\0';
+    return (const char*)sink->data + WAV_HEADER;
+}
+
+static void test_sentences_in_order(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.slow_text = "One.";
+    plan.slow_ms = 150;
+    TypecastClient* client = start(&server, &plan);
+    /* Hold the first answers until two sentences are in flight together */
+    server.hold_until = 2;
+    TypecastTTSRequest req = tts_request("One. Two! Three?  Four.");
+    Sink sink = {0};
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, NULL, collect, &sink), TYPECAST_OK);
+
+    ASSERT_EQ(plan.count, 4);
+    ASSERT(memcmp(sink.data, "RIFF\xff\xff\xff\xff" "WAVE", 12) == 0);
+    ASSERT(memcmp(sink.data + 36, "data\xff\xff\xff\xff", 8) == 0);
+    /* The slow first sentence does not let later ones overtake it */
+    ASSERT(strcmp(samples(&sink), "One.Two!Three?Four._") == 0);
+    ASSERT(server.max_active >= 2);
+
+    stop(&server, &plan, client);
+}
+
+static void test_first_sentence_before_last_finishes(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.slow_text = "Last.";
+    plan.slow_ms = 300;
+    TypecastClient* client = start(&server, &plan);
+    TypecastTTSRequest req = tts_request("First. Second. Last.");
+    Sink sink = {0};
+    uint64_t started = now_ms();
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, NULL, collect, &sink), TYPECAST_OK);
+    uint64_t finished = now_ms();
+    ASSERT(finished - started >= 300);
+    ASSERT(sink.first_at - started < 200);
+    ASSERT(strcmp(samples(&sink), "First.Second._Last._") == 0);
+
+    stop(&server, &plan, client);
+}
+
+static void test_in_flight_is_bounded(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.slow_text = "A.";
+    plan.slow_ms = 100;
+    TypecastClient* client = start(&server, &plan);
+    TypecastTTSRequest req = tts_request("A. B. C. D. E. F.");
+    TypecastPipelineOptions options = {0};
+    options.max_in_flight = 2;
+    Sink sink = {0};
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, &options, collect, &sink), TYPECAST_OK);
+    ASSERT_EQ(plan.count, 6);
+    ASSERT(server.max_active <= 2);
+    ASSERT(strcmp(samples(&sink), "A.B.C.D.E.F.") == 0);
+
+    stop(&server, &plan, client);
+}
+
+static void test_long_text_is_split_and_packed(void) {
+    static char text[6000];
+    size_t len = 0;
+    for (int i = 0; len + 64 < sizeof(text) - 1; i++) {
+        len += (size_t)snprintf(text + len, sizeof(text) - len, "Sentence number %03d is rather ordinary. ", i);
+    }
+    MockServer server;
+    Plan plan = {0};
+    TypecastClient* client = start(&server, &plan);
+    TypecastTTSRequest req = tts_request(text);
+    req.output = NULL;
+    TypecastPipelineOptions options = {0};
+    options.max_chars = 1000;
+    Sink sink = {0};
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, &options, collect, &sink), TYPECAST_OK);
+
+    ASSERT(plan.count >= 6 && plan.count <= 8);
+    static char sent[4096];
+    for (int i = 0; i < plan.count; i++) {
+        ASSERT(json_string(plan.bodies[i], "text", sent, sizeof(sent)));
+        ASSERT(strlen(sent) <= 1000);
+        ASSERT(strncmp(sent, "Sentence number", 15) == 0);
+        ASSERT(sent[strlen(sent) - 1] == '.');
+    }
+
+    stop(&server, &plan, client);
+}
+
+static void test_overlong_sentence_cut_at_space(void) {
+    static char text[3100];
+    for (size_t i = 0; i < 3000; i += 10) memcpy(text + i, "abcdefghi ", 10);
+    text[3000] = '\0';
+    MockServer server;
+    Plan plan = {0};
+    TypecastClient* client = start(&server, &plan);
+    TypecastTTSRequest req = tts_request(text);
+    Sink sink = {0};
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, NULL, collect, &sink), TYPECAST_OK);
+    ASSERT_EQ(plan.count, 2);
+    static char first[4096], second[4096];
+    ASSERT(json_string(plan.bodies[0], "text", first, sizeof(first)));
+    ASSERT(json_string(plan.bodies[1], "text", second, sizeof(second)));
+    if (strlen(first) > strlen(second)) {
+        /* requests may arrive in either order */
+        char* tmp = (char*)malloc(sizeof(first));
+        ASSERT(tmp != NULL);
+        memcpy(tmp, first, sizeof(first));
+        memcpy(first, second, sizeof(first));
+        memcpy(second, tmp, sizeof(first));
+        free(tmp);
+    }
+    ASSERT_EQ(strlen(second), 1999u);
+    ASSERT_EQ(strlen(first), 999u);
+    ASSERT(second[1998] == 'i');
+
+    stop(&server, &plan, client);
+}
+
+static void test_full_width_terminators(void) {
+    MockServer server;
+    Plan plan = {0};
+    TypecastClient* client = start(&server, &plan);
+    TypecastTTSRequest req = tts_request("\xec\x95\x88\xeb\x85\x95\xe3\x80\x82\xeb\xb0\x98\xea\xb0\x91\xec\x8a\xb5\xeb\x8b\x88\xeb\x8b\xa4\xef\xbc\x81");
+    TypecastPipelineOptions options = {0};
+    options.max_in_flight = 1;
+    Sink sink = {0};
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, &options, collect, &sink), TYPECAST_OK);
+    ASSERT_EQ(plan.count, 2);
+
+    stop(&server, &plan, client);
+}
+
+static void test_smart_context_from_neighbours(void) {
+    MockServer server;
+    Plan plan = {0};
+    TypecastClient* client = start(&server, &plan);
+    TypecastPrompt prompt = {0};
+    prompt.emotion_type = TYPECAST_EMOTION_TYPE_SMART;
+    prompt.previous_text = "Before.";
+    TypecastTTSRequest req = tts_request("One. Two. Three.");
+    req.prompt = &prompt;
+    TypecastPipelineOptions options = {0};
+    options.max_in_flight = 1;
+    Sink sink = {0};
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, &options, collect, &sink), TYPECAST_OK);
+    ASSERT_EQ(plan.count, 3);
+
+    char value[64];
+    ASSERT(json_string(plan.bodies[0], "previous_text", value, sizeof(value)) && strcmp(value, "Before.") == 0);
+    ASSERT(json_string(plan.bodies[0], "next_text", value, sizeof(value)) && strcmp(value, "Two.") == 0);
+    ASSERT(json_string(plan.bodies[1], "previous_text", value, sizeof(value)) && strcmp(value, "One.") == 0);
+    ASSERT(json_string(plan.bodies[1], "next_text", value, sizeof(value)) && strcmp(value, "Three.") == 0);
+    ASSERT(json_string(plan.bodies[2], "previous_text", value, sizeof(value)) && strcmp(value, "Two.") == 0);
+    ASSERT(!json_string(plan.bodies[2], "next_text", value, sizeof(value)));
+    /* The caller's prompt is untouched */
+    ASSERT(prompt.next_text == NULL);
+
+    stop(&server, &plan, client);
+}
+
+static void test_mp3_passthrough(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.mp3 = 1;
+    TypecastClient* client = start(&server, &plan);
+    TypecastOutput output = {0};
+    output.volume = 100;
+    output.audio_tempo = 1.0f;
+    output.audio_format = TYPECAST_AUDIO_FORMAT_MP3;
+    TypecastTTSRequest req = tts_request("Hi. There.");
+    req.output = &output;
+    Sink sink = {0};
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, NULL, collect, &sink), TYPECAST_OK);
+    ASSERT_EQ(sink.size, strlen("Hi.There."));
+    ASSERT(memcmp(sink.data, "Hi.There.", sink.size) == 0);
+
+    stop(&server, &plan, client);
+}
+
+static void test_failed_sentence(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.fail_text = "Three.";
+    TypecastClient* client = start(&server, &plan);
+    TypecastTTSRequest req = tts_request("One. Two. Three. Four.");
+    TypecastPipelineOptions options = {0};
+    options.max_in_flight = 1;
+    Sink sink = {0};
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, &options, collect, &sink),
+              TYPECAST_ERROR_INTERNAL_SERVER);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INTERNAL_SERVER);
+    ASSERT_EQ(plan.count, 3);
+    ASSERT(strcmp(samples(&sink), "One.Two.") == 0);
+
+    stop(&server, &plan, client);
+}
+
+static void test_callback_abort(void) {
+    MockServer server;
+    Plan plan = {0};
+    TypecastClient* client = start(&server, &plan);
+    TypecastTTSRequest req = tts_request("One. Two. Three.");
+    Sink sink = {0};
+    sink.abort_at = 2;
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, NULL, collect, &sink), TYPECAST_ERROR_NETWORK);
+    ASSERT_EQ(sink.calls, 2);
+
+    stop(&server, &plan, client);
+}
+
+static void test_format_mismatch(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.odd_rate_text = 2;
+    TypecastClient* client = start(&server, &plan);
+    TypecastTTSRequest req = tts_request("One. Two.");
+    TypecastPipelineOptions options = {0};
+    options.max_in_flight = 1;
+    Sink sink = {0};
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, &options, collect, &sink), TYPECAST_ERROR_JSON_PARSE);
+    ASSERT(strstr(typecast_client_get_error(client)->message, "formats differ") != NULL);
+
+    stop(&server, &plan, client);
+}
+
+static void test_invalid_params(void) {
+    Sink sink = {0};
+    TypecastTTSRequest req = tts_request("Hello.");
+    ASSERT_EQ(typecast_text_to_speech_pipelined(NULL, &req, NULL, collect, &sink), TYPECAST_ERROR_INVALID_PARAM);
+    TypecastClient* client = typecast_client_create_with_host("test-key", "http://127.0.0.1:1");
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, NULL, NULL, collect, &sink), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &req, NULL, NULL, &sink), TYPECAST_ERROR_INVALID_PARAM);
+    TypecastTTSRequest blank = tts_request("  \n\n  ");
+    ASSERT_EQ(typecast_text_to_speech_pipelined(client, &blank, NULL, collect, &sink), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(sink.calls, 0);
+    typecast_client_destroy(client);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Sentence Pipeline Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(sentences_in_order);
+    RUN(first_sentence_before_last_finishes);
+    RUN(in_flight_is_bounded);
+    RUN(long_text_is_split_and_packed);
+    RUN(overlong_sentence_cut_at_space);
+    RUN(full_width_terminators);
+    RUN(smart_context_from_neighbours);
+    RUN(mp3_passthrough);
+    RUN(failed_sentence);
+    RUN(callback_abort);
+    RUN(format_mismatch);
+    RUN(invalid_params);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
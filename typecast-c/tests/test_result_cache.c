@@ -0,0 +1,401 @@
+/**
+ * Result cache tests: repeated TTS, generate-to-file and with-timestamps
+ * requests are answered from the memory LRU (the directory tier is
+ * covered by test_result_cache_disk.c)
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_STREQ(a, b) ASSERT((a) && strcmp((a), (b)) == 0)
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static const char TIMESTAMPS[] =
+    "{\"audio\":\"QVVESU8=\",\"audio_format\":\"wav\",\"audio_duration\":1.5,"
+    "\"words\":[{\"text\":\"Hi\",\"start\":0.0,\"end\":1.5}],\"characters\":null}";
+
+typedef struct {
+    pthread_mutex_t lock;
+    int requests;
+    int fail;            /* answer every request with a 500 */
+    char audio[8][1024]; /* per-request bodies, so they outlive the handler */
+} Server;
+
+/* TTS audio is "AUDIO:" plus the request body, so different requests get
+ * different audio */
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Server* state = (Server*)user_data;
+    pthread_mutex_lock(&state->lock);
+    int n = state->requests++;
+    pthread_mutex_unlock(&state->lock);
+
+    if (state->fail) {
+        static const char detail[] = "{\"detail\":\"boom\"}";
+        resp->status = 500;
+        resp->body = (const uint8_t*)detail;
+        resp->body_len = strlen(detail);
+        return;
+    }
+    if (strncmp(req->path, "/v1/text-to-speech/with-timestamps", 34) == 0) {
+        resp->body = (const uint8_t*)TIMESTAMPS;
+        resp->body_len = strlen(TIMESTAMPS);
+        return;
+    }
+    char* audio = state->audio[n % 8];
+    snprintf(audio, sizeof(state->audio[0]), "AUDIO:%s", req->body ? req->body : "");
+    snprintf(resp->headers, sizeof(resp->headers), "X-Audio-Duration: 1.25\r\n");
+    resp->body = (const uint8_t*)audio;
+    resp->body_len = strlen(audio);
+}
+
+static int request_count(Server* state) {
+    pthread_mutex_lock(&state->lock);
+    int n = state->requests;
+    pthread_mutex_unlock(&state->lock);
+    return n;
+}
+
+static void start(MockServer* server, Server* state) {
+    memset(state, 0, sizeof(*state));
+    pthread_mutex_init(&state->lock, NULL);
+    mock_server_start(server, route, state);
+}
+
+static TypecastClient* new_client(MockServer* server, const TypecastClientOptions* options) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options);
+}
+
+static TypecastTTSRequest seeded_request(const char* text, int seed) {
+    TypecastTTSRequest req = {0};
+    req.text = text;
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    req.seed = seed;
+    return req;
+}
+
+static void test_disabled_by_default(void) {
+    MockServer server;
+    Server state;
+    start(&server, &state);
+    TypecastClient* client = new_client(&server, NULL);
+    TypecastTTSRequest req = seeded_request("hello", 7);
+    for (int i = 0; i < 2; i++) {
+        TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+        ASSERT(resp != NULL);
+        typecast_tts_response_free(resp);
+    }
+    ASSERT_EQ(request_count(&state), 2);
+
+    TypecastResultCacheStats stats;
+    ASSERT_EQ(typecast_result_cache_stats(client, &stats), TYPECAST_OK);
+    ASSERT_EQ(stats.hits + stats.misses, 0);
+    ASSERT_EQ(typecast_result_cache_stats(NULL, &stats), TYPECAST_ERROR_INVALID_PARAM);
+    typecast_result_cache_clear(client);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_seeded_request_served_from_memory(void) {
+    MockServer server;
+    Server state;
+    start(&server, &state);
+    TypecastClientOptions options = {0};
+    options.result_cache_max_bytes = 1 << 20;
+    TypecastClient* client = new_client(&server, &options);
+
+    TypecastTTSRequest req = seeded_request("Press one for sales", 42);
+    TypecastTTSResponse* first = typecast_text_to_speech(client, &req);
+    TypecastTTSResponse* second = typecast_text_to_speech(client, &req);
+    ASSERT(first != NULL && second != NULL);
+    ASSERT_EQ(request_count(&state), 1);
+    ASSERT_EQ(second->audio_size, first->audio_size);
+    ASSERT(memcmp(second->audio_data, first->audio_data, first->audio_size) == 0);
+    ASSERT(second->audio_data != first->audio_data);
+    ASSERT(second->duration > 1.24f && second->duration < 1.26f);
+    ASSERT_EQ(second->format, TYPECAST_AUDIO_FORMAT_WAV);
+    typecast_tts_response_free(first);
+    typecast_tts_response_free(second);
+
+    /* Any field change is a different result */
+    TypecastTTSRequest other_seed = seeded_request("Press one for sales", 43);
+    TypecastTTSResponse* resp = typecast_text_to_speech(client, &other_seed);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+    ASSERT_EQ(request_count(&state), 2);
+
+    TypecastResultCacheStats stats;
+    typecast_result_cache_stats(client, &stats);
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(stats.misses, 2);
+    ASSERT_EQ(stats.disk_hits, 0);
+    ASSERT_EQ(stats.entries, 2);
+
+    typecast_result_cache_clear(client);
+    typecast_result_cache_stats(client, &stats);
+    ASSERT_EQ(stats.entries, 0);
+    ASSERT_EQ(stats.bytes, 0);
+    ASSERT_EQ(stats.hits, 0);
+    resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+    ASSERT_EQ(request_count(&state), 3);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_unseeded_requests_opt_in(void) {
+    MockServer server;
+    Server state;
+    start(&server, &state);
+    TypecastClientOptions options = {0};
+    options.result_cache_max_bytes = 1 << 20;
+    TypecastClient* client = new_client(&server, &options);
+    TypecastTTSRequest req = seeded_request("no seed", 0);
+    for (int i = 0; i < 2; i++) {
+        TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+        ASSERT(resp != NULL);
+        typecast_tts_response_free(resp);
+    }
+    ASSERT_EQ(request_count(&state), 2);
+    TypecastResultCacheStats stats;
+    typecast_result_cache_stats(client, &stats);
+    ASSERT_EQ(stats.hits + stats.misses, 0);
+    typecast_client_destroy(client);
+
+    options.result_cache_unseeded = 1;
+    client = new_client(&server, &options);
+    for (int i = 0; i < 2; i++) {
+        TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+        ASSERT(resp != NULL);
+        typecast_tts_response_free(resp);
+    }
+    ASSERT_EQ(request_count(&state), 3);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_least_recently_used_is_evicted(void) {
+    MockServer server;
+    Server state;
+    start(&server, &state);
+    TypecastTTSRequest a = seeded_request("a", 1);
+    TypecastTTSRequest b = seeded_request("b", 1);
+    TypecastTTSRequest c = seeded_request("c", 1);
+
+    /* Measure one result to size the cache for exactly two */
+    TypecastClient* probe = new_client(&server, NULL);
+    TypecastTTSResponse* resp = typecast_text_to_speech(probe, &a);
+    ASSERT(resp != NULL);
+    size_t one = resp->audio_size;
+    typecast_tts_response_free(resp);
+    typecast_client_destroy(probe);
+
+    TypecastClientOptions options = {0};
+    options.result_cache_max_bytes = one * 2;
+    TypecastClient* client = new_client(&server, &options);
+    const TypecastTTSRequest* order[] = {&a, &b, &a, &c, &a, &b};
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        resp = typecast_text_to_speech(client, order[i]);
+        ASSERT(resp != NULL);
+        typecast_tts_response_free(resp);
+    }
+    /* a, b fetched; a hit; c evicts b; a hit; b fetched again */
+    TypecastResultCacheStats stats;
+    typecast_result_cache_stats(client, &stats);
+    ASSERT_EQ(stats.hits, 2);
+    ASSERT_EQ(stats.misses, 4);
+    ASSERT_EQ(stats.entries, 2);
+    ASSERT_EQ(stats.bytes, one * 2);
+    ASSERT_EQ(request_count(&state), 1 + 4);
+
+    /* Results larger than the whole cache are not kept */
+    char text[512];
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    TypecastTTSRequest big = seeded_request(text, 1);
+    resp = typecast_text_to_speech(client, &big);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+    typecast_result_cache_stats(client, &stats);
+    ASSERT_EQ(stats.entries, 2);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_errors_are_not_cached(void) {
+    MockServer server;
+    Server state;
+    start(&server, &state);
+    state.fail = 1;
+    TypecastClientOptions options = {0};
+    options.result_cache_max_bytes = 1 << 20;
+    TypecastClient* client = new_client(&server, &options);
+    TypecastTTSRequest req = seeded_request("fails", 9);
+    for (int i = 0; i < 2; i++) {
+        ASSERT(typecast_text_to_speech(client, &req) == NULL);
+        ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INTERNAL_SERVER);
+    }
+    ASSERT_EQ(request_count(&state), 2);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_generate_to_file_shares_entries(void) {
+    MockServer server;
+    Server state;
+    start(&server, &state);
+    TypecastClientOptions options = {0};
+    options.result_cache_max_bytes = 1 << 20;
+    TypecastClient* client = new_client(&server, &options);
+
+    TypecastOutput output = {0};
+    output.volume = 100;
+    output.audio_tempo = 1.0f;
+    output.audio_format = TYPECAST_AUDIO_FORMAT_WAV;
+    TypecastTTSRequest req = seeded_request("shared", 3);
+    req.output = &output;
+    TypecastTTSResponse* resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+
+    TypecastGenerateToFileRequest file_req = {0};
+    file_req.text = req.text;
+    file_req.voice_id = req.voice_id;
+    file_req.output = &output;
+    file_req.seed = 3;
+    char path[256];
+    snprintf(path, sizeof(path), "/tmp/typecast_result_cache_%d.wav", (int)getpid());
+    TypecastGeneratedAudio info = {0};
+    ASSERT_EQ(typecast_generate_to_file_with_info(client, path, &file_req, &info), TYPECAST_OK);
+    ASSERT_EQ(request_count(&state), 1);
+    ASSERT(info.duration > 1.2f && info.duration < 1.3f);
+    ASSERT_EQ(info.format, TYPECAST_AUDIO_FORMAT_WAV);
+
+    FILE* f = fopen(path, "rb");
+    ASSERT(f != NULL);
+    char buf[2048];
+    size_t n = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    ASSERT_EQ(n, resp->audio_size);
+    ASSERT(memcmp(buf, resp->audio_data, n) == 0);
+    typecast_tts_response_free(resp);
+
+    /* A file generated first feeds the cache too */
+    file_req.seed = 4;
+    FILE* devnull = fopen("/dev/null", "wb");
+    ASSERT(devnull != NULL);
+    TypecastErrorCode rc = typecast_generate_to_fp(client, devnull, &file_req);
+    fclose(devnull);
+    ASSERT_EQ(rc, TYPECAST_OK);
+    req.seed = 4;
+    resp = typecast_text_to_speech(client, &req);
+    ASSERT(resp != NULL);
+    ASSERT(strstr((const char*)resp->audio_data, "\"seed\":4") != NULL);
+    typecast_tts_response_free(resp);
+    ASSERT_EQ(request_count(&state), 2);
+
+    remove(path);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+typedef struct {
+    size_t bytes;
+} AudioSink;
+
+static int collect_audio(const uint8_t* data, size_t len, void* user_data) {
+    (void)data;
+    ((AudioSink*)user_data)->bytes += len;
+    return 0;
+}
+
+static void test_with_timestamps_replayed_from_cache(void) {
+    MockServer server;
+    Server state;
+    start(&server, &state);
+    TypecastClientOptions options = {0};
+    options.result_cache_max_bytes = 1 << 20;
+    TypecastClient* client = new_client(&server, &options);
+
+    TypecastTTSRequestWithTimestamps req = {0};
+    req.text = "Hi";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    req.seed = 11;
+    for (int i = 0; i < 2; i++) {
+        TypecastTTSWithTimestampsResponse* resp = NULL;
+        ASSERT_EQ(typecast_text_to_speech_with_timestamps(client, &req, &resp), TYPECAST_OK);
+        ASSERT_STREQ(resp->audio_base64, "QVVESU8=");
+        ASSERT_EQ(resp->words_count, 1);
+        ASSERT_STREQ(resp->words[0].text, "Hi");
+        typecast_tts_with_timestamps_response_free(resp);
+    }
+    ASSERT_EQ(request_count(&state), 1);
+
+    /* The decoded variant replays the same body through the callback */
+    AudioSink sink = {0};
+    TypecastTTSWithTimestampsDecodedResponse* decoded = NULL;
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_decoded(client, &req, collect_audio, &sink, &decoded),
+              TYPECAST_OK);
+    ASSERT_EQ(sink.bytes, 5);
+    ASSERT(decoded->timestamps.audio_base64 == NULL);
+    typecast_tts_with_timestamps_decoded_response_free(decoded);
+    ASSERT_EQ(request_count(&state), 1);
+
+    /* Granularity is part of the key */
+    req.granularity = "word";
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps(client, &req, &resp), TYPECAST_OK);
+    typecast_tts_with_timestamps_response_free(resp);
+    ASSERT_EQ(request_count(&state), 2);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Result Cache Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(disabled_by_default);
+    RUN(seeded_request_served_from_memory);
+    RUN(unseeded_requests_opt_in);
+    RUN(least_recently_used_is_evicted);
+    RUN(errors_are_not_cached);
+    RUN(generate_to_file_shares_entries);
+    RUN(with_timestamps_replayed_from_cache);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
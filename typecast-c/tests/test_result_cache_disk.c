@@ -0,0 +1,174 @@
+/**
+ * Result cache directory tier tests: entries persisted by one client are
+ * served to the next, promoted to memory, and rewritten when damaged
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+typedef struct {
+    pthread_mutex_t lock;
+    int requests;
+    char audio[8][1024]; /* per-request bodies, so they outlive the handler */
+} Server;
+
+/* TTS audio is "AUDIO:" plus the request body, so different requests get
+ * different audio */
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Server* state = (Server*)user_data;
+    pthread_mutex_lock(&state->lock);
+    int n = state->requests++;
+    pthread_mutex_unlock(&state->lock);
+
+    char* audio = state->audio[n % 8];
+    snprintf(audio, sizeof(state->audio[0]), "AUDIO:%s", req->body ? req->body : "");
+    snprintf(resp->headers, sizeof(resp->headers), "X-Audio-Duration: 1.25\r\n");
+    resp->body = (const uint8_t*)audio;
+    resp->body_len = strlen(audio);
+}
+
+static int request_count(Server* state) {
+    pthread_mutex_lock(&state->lock);
+    int n = state->requests;
+    pthread_mutex_unlock(&state->lock);
+    return n;
+}
+
+static void start(MockServer* server, Server* state) {
+    memset(state, 0, sizeof(*state));
+    pthread_mutex_init(&state->lock, NULL);
+    mock_server_start(server, route, state);
+}
+
+static TypecastClient* new_client(MockServer* server, const TypecastClientOptions* options) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options);
+}
+
+static TypecastTTSRequest seeded_request(const char* text, int seed) {
+    TypecastTTSRequest req = {0};
+    req.text = text;
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    req.seed = seed;
+    return req;
+}
+
+static void make_dir(char* path, size_t size, const char* name) {
+    snprintf(path, size, "/tmp/typecast_result_cache_%d_%s", (int)getpid(), name);
+    mkdir(path, 0700);
+}
+
+static int count_files(const char* dir) {
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "ls %s | wc -l", dir);
+    FILE* p = popen(cmd, "r");
+    int n = -1;
+    if (p) {
+        if (fscanf(p, "%d", &n) != 1) n = -1;
+        pclose(p);
+    }
+    return n;
+}
+
+static void remove_dir(const char* dir) {
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+    if (system(cmd) != 0) fprintf(stderr, "could not remove %s\n", dir);
+}
+
+static void test_directory_tier_shared_between_clients(void) {
+    MockServer server;
+    Server state;
+    start(&server, &state);
+    char dir[256];
+    make_dir(dir, sizeof(dir), "disk");
+
+    TypecastClientOptions options = {0};
+    options.result_cache_dir = dir;
+    TypecastClient* writer = new_client(&server, &options);
+    TypecastTTSRequest req = seeded_request("persist me", 5);
+    TypecastTTSResponse* fetched = typecast_text_to_speech(writer, &req);
+    ASSERT(fetched != NULL);
+    typecast_client_destroy(writer);
+    ASSERT_EQ(count_files(dir), 1);
+
+    /* Directory plus memory: the disk hit is promoted */
+    options.result_cache_max_bytes = 1 << 20;
+    TypecastClient* reader = new_client(&server, &options);
+    for (int i = 0; i < 2; i++) {
+        TypecastTTSResponse* resp = typecast_text_to_speech(reader, &req);
+        ASSERT(resp != NULL);
+        ASSERT_EQ(resp->audio_size, fetched->audio_size);
+        ASSERT(memcmp(resp->audio_data, fetched->audio_data, resp->audio_size) == 0);
+        ASSERT(resp->duration > 1.24f && resp->duration < 1.26f);
+        typecast_tts_response_free(resp);
+    }
+    ASSERT_EQ(request_count(&state), 1);
+    TypecastResultCacheStats stats;
+    typecast_result_cache_stats(reader, &stats);
+    ASSERT_EQ(stats.hits, 2);
+    ASSERT_EQ(stats.disk_hits, 1);
+    ASSERT_EQ(stats.entries, 1);
+    typecast_client_destroy(reader);
+    typecast_tts_response_free(fetched);
+
+    /* A damaged file is a miss and gets rewritten */
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "for f in %s/*.tcr; do printf TCR1junk > \"$f\"; done", dir);
+    ASSERT_EQ(system(cmd), 0);
+    options.result_cache_max_bytes = 0;
+    reader = new_client(&server, &options);
+    TypecastTTSResponse* resp = typecast_text_to_speech(reader, &req);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+    ASSERT_EQ(request_count(&state), 2);
+    resp = typecast_text_to_speech(reader, &req);
+    ASSERT(resp != NULL);
+    typecast_tts_response_free(resp);
+    ASSERT_EQ(request_count(&state), 2);
+    typecast_client_destroy(reader);
+
+    remove_dir(dir);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Result Cache Directory Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(directory_tier_shared_between_clients);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
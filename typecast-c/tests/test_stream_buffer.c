@@ -0,0 +1,275 @@
+/**
+ * Stream buffer tests: a producer thread streams into the ring while the
+ * reader drains it; reads wait for the prebuffer, a full ring pauses the
+ * transfer instead of growing, and the reader can stop the stream
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+#define AUDIO_BYTES (512 * 1024)
+#define STREAM_CAPACITY (64 * 1024)
+
+static uint8_t AUDIO[AUDIO_BYTES];
+
+typedef struct {
+    int status;                      /* 0 = 200 with AUDIO */
+    int delay_ms;
+    int chunk_delay_ms;
+} Plan;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Plan* plan = (Plan*)user_data;
+    (void)req;
+    resp->delay_ms = plan->delay_ms;
+    if (plan->status) {
+        static const char detail[] = "{\"detail\":\"bad key\"}";
+        resp->status = plan->status;
+        resp->body = (const uint8_t*)detail;
+        resp->body_len = strlen(detail);
+        return;
+    }
+    resp->body = AUDIO;
+    resp->body_len = sizeof(AUDIO);
+    resp->chunk_size = 8192;
+    resp->chunk_delay_ms = plan->chunk_delay_ms;
+}
+
+typedef struct {
+    TypecastClient* client;
+    TypecastStreamBuffer* buffer;
+    TypecastErrorCode result;
+    pthread_t thread;
+} Producer;
+
+static void* produce(void* arg) {
+    Producer* p = (Producer*)arg;
+    TypecastTTSRequestStream req = {0};
+    req.text = "buffered";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    p->result = typecast_text_to_speech_stream_buffered(p->client, &req, p->buffer);
+    return NULL;
+}
+
+static TypecastClient* new_client(MockServer* server, Plan* plan, TypecastClientOptions* options) {
+    TypecastClientOptions defaults = {0};
+    mock_server_start(server, route, plan);
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options ? options : &defaults);
+}
+
+static void start(Producer* p, TypecastClient* client, TypecastStreamBuffer* buffer) {
+    p->client = client;
+    p->buffer = buffer;
+    p->result = TYPECAST_OK;
+    pthread_create(&p->thread, NULL, produce, p);
+}
+
+/* Reads everything into `out`, `step` bytes every `pace_us` */
+static size_t drain(TypecastStreamBuffer* buffer, uint8_t* out, size_t step, int pace_us) {
+    size_t got = 0;
+    while (!typecast_stream_buffer_eof(buffer)) {
+        size_t n = typecast_stream_buffer_read(buffer, out + got, step);
+        got += n;
+        if (pace_us) usleep(pace_us);
+        else if (n == 0) usleep(200);
+    }
+    return got;
+}
+
+static void test_prebuffer_and_backpressure(void) {
+    MockServer server;
+    Plan plan = {0};
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastStreamBufferOptions options = {STREAM_CAPACITY, 32 * 1024};
+    TypecastStreamBuffer* buffer = typecast_stream_buffer_create(&options);
+    ASSERT(buffer != NULL);
+    Producer producer;
+    start(&producer, client, buffer);
+
+    /* Nothing comes out before the prebuffer is in */
+    uint8_t* out = (uint8_t*)malloc(AUDIO_BYTES);
+    size_t first = 0;
+    while ((first = typecast_stream_buffer_available(buffer)) == 0) usleep(200);
+    ASSERT(first >= 32 * 1024);
+
+    /* Left alone, the ring fills and the transfer waits */
+    usleep(200 * 1000);
+    TypecastStreamBufferStats stats;
+    ASSERT_EQ(typecast_stream_buffer_stats(buffer, &stats), TYPECAST_OK);
+    ASSERT_EQ(stats.capacity, (size_t)STREAM_CAPACITY);
+    ASSERT(stats.buffered <= (size_t)STREAM_CAPACITY);
+    ASSERT(stats.buffered > (size_t)STREAM_CAPACITY - 16384);
+    ASSERT(stats.pauses >= 1);
+    ASSERT(!typecast_stream_buffer_eof(buffer));
+
+    size_t got = drain(buffer, out, 4096, 100);
+    pthread_join(producer.thread, NULL);
+    ASSERT_EQ(producer.result, TYPECAST_OK);
+    ASSERT_EQ(got, (size_t)AUDIO_BYTES);
+    ASSERT(memcmp(out, AUDIO, AUDIO_BYTES) == 0);
+    ASSERT_EQ(typecast_stream_buffer_stats(buffer, &stats), TYPECAST_OK);
+    ASSERT_EQ(stats.bytes_written, (uint64_t)AUDIO_BYTES);
+    ASSERT_EQ(stats.bytes_read, (uint64_t)AUDIO_BYTES);
+    ASSERT(stats.pauses > 1);
+    ASSERT_EQ(typecast_stream_buffer_read(buffer, out, 16), 0u);
+
+    /* A buffer carries one stream */
+    start(&producer, client, buffer);
+    pthread_join(producer.thread, NULL);
+    ASSERT_EQ(producer.result, TYPECAST_ERROR_INVALID_PARAM);
+
+    free(out);
+    typecast_stream_buffer_free(buffer);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_paused_time_is_not_timed_out(void) {
+    MockServer server;
+    Plan plan = {0};
+    TypecastClientOptions options = {0};
+    options.request_timeout_secs = 1;
+    TypecastClient* client = new_client(&server, &plan, &options);
+    TypecastStreamBufferOptions buffer_options = {STREAM_CAPACITY, 0};
+    TypecastStreamBuffer* buffer = typecast_stream_buffer_create(&buffer_options);
+    Producer producer;
+    start(&producer, client, buffer);
+
+    /* The reader holds the stream back longer than the request timeout */
+    usleep(1500 * 1000);
+    uint8_t* out = (uint8_t*)malloc(AUDIO_BYTES);
+    size_t got = drain(buffer, out, 16384, 0);
+    pthread_join(producer.thread, NULL);
+    ASSERT_EQ(producer.result, TYPECAST_OK);
+    ASSERT_EQ(got, (size_t)AUDIO_BYTES);
+    typecast_stream_buffer_free(buffer);
+
+    /* A server that does not answer still times out */
+    plan.delay_ms = 2000;
+    buffer = typecast_stream_buffer_create(NULL);
+    start(&producer, client, buffer);
+    pthread_join(producer.thread, NULL);
+    ASSERT_EQ(producer.result, TYPECAST_ERROR_NETWORK);
+    ASSERT(typecast_stream_buffer_eof(buffer));
+
+    free(out);
+    typecast_stream_buffer_free(buffer);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_reader_close_stops_the_stream(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.chunk_delay_ms = 20;
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastStreamBuffer* buffer = typecast_stream_buffer_create(NULL);
+    Producer producer;
+    start(&producer, client, buffer);
+
+    uint8_t out[4096];
+    size_t got = 0;
+    while (got < sizeof(out)) got += typecast_stream_buffer_read(buffer, out, sizeof(out) - got);
+    typecast_stream_buffer_close(buffer);
+    pthread_join(producer.thread, NULL);
+    ASSERT_EQ(producer.result, TYPECAST_ERROR_CANCELLED);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_CANCELLED);
+    typecast_stream_buffer_free(buffer);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_error_body_is_not_buffered(void) {
+    MockServer server;
+    Plan plan = {0};
+    plan.status = 401;
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastStreamBuffer* buffer = typecast_stream_buffer_create(NULL);
+    Producer producer;
+    start(&producer, client, buffer);
+    pthread_join(producer.thread, NULL);
+    ASSERT_EQ(producer.result, TYPECAST_ERROR_UNAUTHORIZED);
+    ASSERT(strcmp(typecast_client_get_error(client)->message, "bad key") == 0);
+    ASSERT(typecast_stream_buffer_eof(buffer));
+    TypecastStreamBufferStats stats;
+    ASSERT_EQ(typecast_stream_buffer_stats(buffer, &stats), TYPECAST_OK);
+    ASSERT_EQ(stats.bytes_written, 0u);
+    typecast_stream_buffer_free(buffer);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_invalid_arguments(void) {
+    TypecastStreamBufferOptions options = {100000, 1 << 20};
+    TypecastStreamBuffer* buffer = typecast_stream_buffer_create(&options);
+    TypecastStreamBufferStats stats;
+    ASSERT_EQ(typecast_stream_buffer_stats(buffer, &stats), TYPECAST_OK);
+    ASSERT_EQ(stats.capacity, (size_t)131072);
+    options.capacity = 1;
+    TypecastStreamBuffer* small = typecast_stream_buffer_create(&options);
+    ASSERT_EQ(typecast_stream_buffer_stats(small, &stats), TYPECAST_OK);
+    ASSERT_EQ(stats.capacity, (size_t)STREAM_CAPACITY);
+    typecast_stream_buffer_free(small);
+
+    TypecastClient* client = typecast_client_create("test-key");
+    TypecastTTSRequestStream req = {0};
+    ASSERT_EQ(typecast_text_to_speech_stream_buffered(NULL, &req, buffer), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_text_to_speech_stream_buffered(client, &req, NULL), TYPECAST_ERROR_INVALID_PARAM);
+    /* A rejected request still ends the stream */
+    ASSERT(!typecast_stream_buffer_eof(buffer));
+    ASSERT_EQ(typecast_text_to_speech_stream_buffered(client, &req, buffer), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT(typecast_stream_buffer_eof(buffer));
+
+    uint8_t out[8];
+    ASSERT_EQ(typecast_stream_buffer_read(NULL, out, sizeof(out)), 0u);
+    ASSERT_EQ(typecast_stream_buffer_read(buffer, NULL, sizeof(out)), 0u);
+    ASSERT_EQ(typecast_stream_buffer_available(NULL), 0u);
+    ASSERT(typecast_stream_buffer_eof(NULL));
+    ASSERT_EQ(typecast_stream_buffer_stats(NULL, &stats), TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_stream_buffer_stats(buffer, NULL), TYPECAST_ERROR_INVALID_PARAM);
+    typecast_stream_buffer_close(NULL);
+    typecast_stream_buffer_free(NULL);
+    typecast_stream_buffer_free(buffer);
+    typecast_client_destroy(client);
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(AUDIO); i++) AUDIO[i] = (uint8_t)(i * 7 + (i >> 11));
+
+    RUN(prebuffer_and_backpressure);
+    RUN(paused_time_is_not_timed_out);
+    RUN(reader_close_stops_the_stream);
+    RUN(error_body_is_not_buffered);
+    RUN(invalid_arguments);
+    printf("\nStream buffer tests: %d run, %d failed\n", tests_run, tests_failed);
+    return tests_failed == 0 ? 0 : 1;
+}
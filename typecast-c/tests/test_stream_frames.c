@@ -0,0 +1,340 @@
+/**
+ * Framed streaming tests: the WAV header and MP3 frame headers are read
+ * as the body arrives in odd-sized pieces, and the callback only ever
+ * sees whole PCM blocks / whole MP3 frames of at least the minimum
+ * duration, after the sample format
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_STREQ(a, b) ASSERT((a) && strcmp((a), (b)) == 0)
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+/* ---- Fixtures: 1 s of 16 kHz mono PCM, 40 MP3 frames ---- */
+
+#define PCM_BYTES 32000
+#define MP3_FRAMES 40
+
+static uint8_t WAV_BODY[44 + 12 + PCM_BYTES + 16];
+static size_t wav_len;
+static uint8_t MP3_BODY[30 + MP3_FRAMES * 418];
+static size_t mp3_len;
+static size_t frame_offsets[MP3_FRAMES + 1];  /* into MP3_BODY */
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void build_fixtures(void) {
+    /* RIFF, fmt, a LIST chunk before the data and one after it */
+    uint8_t* w = WAV_BODY;
+    memcpy(w, "RIFF", 4);
+    put_u32(w + 4, (uint32_t)sizeof(WAV_BODY) - 8);
+    memcpy(w + 8, "WAVEfmt ", 8);
+    put_u32(w + 16, 16);
+    put_u16(w + 20, 1);
+    put_u16(w + 22, 1);
+    put_u32(w + 24, 16000);
+    put_u32(w + 28, 32000);
+    put_u16(w + 32, 2);
+    put_u16(w + 34, 16);
+    memcpy(w + 36, "LIST", 4);
+    put_u32(w + 40, 4);
+    memcpy(w + 44, "INFO", 4);
+    memcpy(w + 48, "data", 4);
+    put_u32(w + 52, PCM_BYTES);
+    for (size_t i = 0; i < PCM_BYTES; i++) w[56 + i] = (uint8_t)(i * 31 + 7);
+    memcpy(w + 56 + PCM_BYTES, "LIST", 4);
+    put_u32(w + 60 + PCM_BYTES, 8);
+    memcpy(w + 64 + PCM_BYTES, "INFOjunk", 8);
+    wav_len = sizeof(WAV_BODY);
+
+    /* A 20-byte ID3v2 tag, then MPEG-1 Layer III 128 kbps 44.1 kHz joint
+     * stereo frames of 417 bytes, every third one padded to 418 */
+    uint8_t* m = MP3_BODY;
+    memcpy(m, "ID3\x04\x00\x00\x00\x00\x00\x14", 10);
+    memset(m + 10, 0xFF, 20);
+    size_t pos = 30;
+    for (int i = 0; i < MP3_FRAMES; i++) {
+        int padded = i % 3 == 2;
+        size_t length = padded ? 418 : 417;
+        frame_offsets[i] = pos;
+        m[pos] = 0xFF;
+        m[pos + 1] = 0xFB;
+        m[pos + 2] = padded ? 0x92 : 0x90;
+        m[pos + 3] = 0x44;
+        for (size_t j = 4; j < length; j++) m[pos + j] = (uint8_t)((i + j) & 0x7F);
+        pos += length;
+    }
+    frame_offsets[MP3_FRAMES] = pos;
+    mp3_len = pos;
+}
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    (void)user_data;
+    const char* body = req->body ? req->body : "";
+    if (strstr(body, "\"text\":\"fail\"")) {
+        static const char error[] = "{\"detail\":\"voice not found\"}";
+        resp->status = 404;
+        resp->body = (const uint8_t*)error;
+        resp->body_len = strlen(error);
+        return;
+    }
+    if (strstr(body, "\"text\":\"junk\"")) {
+        static const char junk[] = "this is not audio at all";
+        resp->body = (const uint8_t*)junk;
+        resp->body_len = strlen(junk);
+    } else if (strstr(body, "\"audio_format\":\"mp3\"")) {
+        resp->body = MP3_BODY;
+        resp->body_len = mp3_len;
+    } else {
+        resp->body = WAV_BODY;
+        resp->body_len = wav_len;
+    }
+    /* Odd, small pieces so that blocks and frames straddle them */
+    resp->chunk_size = 333;
+    resp->chunk_delay_ms = 1;
+}
+
+/* ---- Collector ---- */
+
+typedef struct {
+    TypecastStreamFormat format;
+    int formats;
+    int format_after_chunk;
+    int stop_format;
+    int stop_after;                  /* stop at this chunk, 0 = never */
+    uint8_t* data;
+    size_t len;
+    size_t sizes[256];
+    int chunks;
+} Frames;
+
+static int on_format(const TypecastStreamFormat* format, void* user_data) {
+    Frames* f = (Frames*)user_data;
+    f->format = *format;
+    f->formats++;
+    if (f->chunks > 0) f->format_after_chunk = 1;
+    return f->stop_format;
+}
+
+static int on_chunk(const uint8_t* data, size_t len, void* user_data) {
+    Frames* f = (Frames*)user_data;
+    if (f->stop_after && f->chunks + 1 == f->stop_after) return 1;
+    if (f->chunks < 256) f->sizes[f->chunks] = len;
+    f->chunks++;
+    f->data = (uint8_t*)realloc(f->data, f->len + len);
+    memcpy(f->data + f->len, data, len);
+    f->len += len;
+    return 0;
+}
+
+static TypecastClient* new_client(MockServer* server) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_host("test-key", host);
+}
+
+static TypecastTTSRequestStream stream_request(const char* text, TypecastAudioFormat format) {
+    static TypecastOutputStream output;
+    TypecastTTSRequestStream req;
+    memset(&req, 0, sizeof(req));
+    memset(&output, 0, sizeof(output));
+    output.audio_format = format;
+    req.text = text;
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    req.output = &output;
+    return req;
+}
+
+static void test_wav_whole_blocks(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClient* client = new_client(&server);
+    TypecastTTSRequestStream req = stream_request("hello", TYPECAST_AUDIO_FORMAT_WAV);
+
+    /* 100 ms batches: at least 3200 bytes, whole 2-byte blocks */
+    TypecastStreamFraming framing = {100, on_format};
+    Frames f;
+    memset(&f, 0, sizeof(f));
+    ASSERT_EQ(typecast_text_to_speech_stream_framed(client, &req, &framing, on_chunk, &f), TYPECAST_OK);
+    ASSERT_EQ(f.formats, 1);
+    ASSERT_EQ(f.format_after_chunk, 0);
+    ASSERT_EQ(f.format.audio_format, TYPECAST_AUDIO_FORMAT_WAV);
+    ASSERT_EQ(f.format.sample_rate, 16000);
+    ASSERT_EQ(f.format.channels, 1);
+    ASSERT_EQ(f.format.bits_per_sample, 16);
+    ASSERT_EQ(f.format.block_align, 2);
+    ASSERT_EQ(f.format.format_tag, 1);
+    ASSERT(f.chunks > 1);
+    for (int i = 0; i < f.chunks; i++) {
+        ASSERT_EQ(f.sizes[i] % 2, 0);
+        if (i + 1 < f.chunks) ASSERT(f.sizes[i] >= 3200);
+    }
+    /* Exactly the samples: no header, no trailing chunk */
+    ASSERT_EQ(f.len, PCM_BYTES);
+    ASSERT(memcmp(f.data, WAV_BODY + 56, PCM_BYTES) == 0);
+    free(f.data);
+
+    /* Without framing options every whole block goes out as it completes */
+    memset(&f, 0, sizeof(f));
+    ASSERT_EQ(typecast_text_to_speech_stream_framed(client, &req, NULL, on_chunk, &f), TYPECAST_OK);
+    ASSERT_EQ(f.formats, 0);
+    ASSERT(f.chunks > 10);
+    ASSERT_EQ(f.len, PCM_BYTES);
+    for (int i = 0; i < f.chunks && i < 256; i++) ASSERT_EQ(f.sizes[i] % 2, 0);
+    ASSERT(memcmp(f.data, WAV_BODY + 56, PCM_BYTES) == 0);
+    free(f.data);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+/* True when `len` bytes at MP3 offset `start` are a run of whole frames */
+static int whole_frames(size_t start, size_t len, int* frames) {
+    int first = -1;
+    for (int i = 0; i <= MP3_FRAMES; i++) {
+        if (frame_offsets[i] == start) first = i;
+    }
+    if (first < 0) return 0;
+    for (int i = first; i <= MP3_FRAMES; i++) {
+        if (frame_offsets[i] == start + len) {
+            *frames = i - first;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void test_mp3_whole_frames(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClient* client = new_client(&server);
+    TypecastTTSRequestStream req = stream_request("hello", TYPECAST_AUDIO_FORMAT_MP3);
+
+    /* 100 ms = 4410 samples: four 1152-sample frames per chunk */
+    TypecastStreamFraming framing = {100, on_format};
+    Frames f;
+    memset(&f, 0, sizeof(f));
+    ASSERT_EQ(typecast_text_to_speech_stream_framed(client, &req, &framing, on_chunk, &f), TYPECAST_OK);
+    ASSERT_EQ(f.formats, 1);
+    ASSERT_EQ(f.format.audio_format, TYPECAST_AUDIO_FORMAT_MP3);
+    ASSERT_EQ(f.format.sample_rate, 44100);
+    ASSERT_EQ(f.format.channels, 2);
+    ASSERT_EQ(f.format.bitrate_kbps, 128);
+    ASSERT_EQ(f.format.block_align, 0);
+    ASSERT_EQ(f.chunks, MP3_FRAMES / 4);
+    size_t start = frame_offsets[0];
+    for (int i = 0; i < f.chunks; i++) {
+        int frames = 0;
+        ASSERT(whole_frames(start, f.sizes[i], &frames));
+        ASSERT_EQ(frames, 4);
+        start += f.sizes[i];
+    }
+    /* The ID3 tag is skipped, every frame is passed on unchanged */
+    ASSERT_EQ(f.len, mp3_len - 30);
+    ASSERT(memcmp(f.data, MP3_BODY + 30, f.len) == 0);
+    free(f.data);
+
+    /* A batch longer than the rest of the audio ends in a short chunk */
+    framing.min_chunk_ms = 300;
+    memset(&f, 0, sizeof(f));
+    ASSERT_EQ(typecast_text_to_speech_stream_framed(client, &req, &framing, on_chunk, &f), TYPECAST_OK);
+    ASSERT_EQ(f.chunks, 4);  /* 12 + 12 + 12 + 4 frames */
+    int frames = 0;
+    ASSERT(whole_frames(frame_offsets[36], f.sizes[3], &frames));
+    ASSERT_EQ(frames, 4);
+    ASSERT_EQ(f.len, mp3_len - 30);
+    free(f.data);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_errors_and_aborts(void) {
+    MockServer server;
+    ASSERT(mock_server_start(&server, route, NULL));
+    TypecastClient* client = new_client(&server);
+    TypecastStreamFraming framing = {20, on_format};
+    Frames f;
+
+    /* Not audio: nothing reaches the callbacks */
+    TypecastTTSRequestStream req = stream_request("junk", TYPECAST_AUDIO_FORMAT_WAV);
+    memset(&f, 0, sizeof(f));
+    ASSERT_EQ(typecast_text_to_speech_stream_framed(client, &req, &framing, on_chunk, &f),
+              TYPECAST_ERROR_JSON_PARSE);
+    ASSERT_EQ(f.formats + f.chunks, 0);
+
+    /* An error body is kept back for its detail */
+    req = stream_request("fail", TYPECAST_AUDIO_FORMAT_WAV);
+    ASSERT_EQ(typecast_text_to_speech_stream_framed(client, &req, &framing, on_chunk, &f),
+              TYPECAST_ERROR_NOT_FOUND);
+    ASSERT_STREQ(typecast_client_get_error(client)->message, "voice not found");
+    ASSERT_EQ(f.formats + f.chunks, 0);
+
+    /* Either callback stops the stream */
+    req = stream_request("hello", TYPECAST_AUDIO_FORMAT_MP3);
+    f.stop_format = 1;
+    ASSERT_EQ(typecast_text_to_speech_stream_framed(client, &req, &framing, on_chunk, &f),
+              TYPECAST_ERROR_NETWORK);
+    ASSERT_STREQ(typecast_client_get_error(client)->message, "Stream aborted by callback");
+    ASSERT_EQ(f.chunks, 0);
+
+    memset(&f, 0, sizeof(f));
+    f.stop_after = 2;
+    ASSERT_EQ(typecast_text_to_speech_stream_framed(client, &req, &framing, on_chunk, &f),
+              TYPECAST_ERROR_NETWORK);
+    ASSERT_EQ(f.chunks, 1);
+    free(f.data);
+
+    ASSERT_EQ(typecast_text_to_speech_stream_framed(client, &req, &framing, NULL, &f),
+              TYPECAST_ERROR_INVALID_PARAM);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Framed Stream Tests\n");
+    printf("===========================================\n\n");
+
+    build_fixtures();
+    RUN(wav_whole_blocks);
+    RUN(mp3_whole_frames);
+    RUN(errors_and_aborts);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -12,6 +12,7 @@
  * TYPECAST_FIXTURE_DIR.
  */
 
+#define _GNU_SOURCE  /* strcasestr */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -928,7 +929,7 @@ static void test_http_response_with_characters(void) {
 }
 
 /* HTTP response where text contains a \uXXXX Unicode escape.
- * Exercises json_unescape_unicode, parse_hex4, and codepoint_to_utf8.
+ * Exercises the parser's \u escape and UTF-8 encoding paths.
  * Word 0: é (2-byte UTF-8, é)
  * Word 1: ハ (3-byte UTF-8, ハ)
  * Word 2: A (1-byte ASCII, A)
@@ -1216,6 +1217,437 @@ static void test_http_malformed_segment_no_text(void) {
     typecast_client_destroy(client);
 }
 
+/* ============================================
+ * Incremental parser / decoded audio tests
+ * ============================================ */
+
+static TypecastTTSRequestWithTimestamps http_default_request(void) {
+    TypecastTTSRequestWithTimestamps req = {0};
+    req.text     = "test";
+    req.voice_id = "tc_test";
+    req.model    = TYPECAST_MODEL_SSFM_V30;
+    return req;
+}
+
+static const char B64_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Base64-encode `len` bytes into out (room for (len + 2) / 3 * 4 + 1) */
+static size_t b64_encode(const uint8_t* in, size_t len, char* out) {
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        out[o++] = B64_ALPHABET[(v >> 18) & 63];
+        out[o++] = B64_ALPHABET[(v >> 12) & 63];
+        out[o++] = i + 1 < len ? B64_ALPHABET[(v >> 6) & 63] : '=';
+        out[o++] = i + 2 < len ? B64_ALPHABET[v & 63] : '=';
+    }
+    out[o] = '\0';
+    return o;
+}
+
+/* Response whose audio is `len` bytes of base64, with '/' written as the
+ * JSON escape "\/" so the parser has to unescape inside the audio string.
+ * A non-zero `wrap` breaks the base64 into lines of that many characters
+ * with escaped newlines, the way MIME encoders do. */
+static char* build_wrapped_audio_response_json(const uint8_t* audio, size_t len, size_t wrap) {
+    static const char* head = "{\"audio\":\"";
+    static const char* tail =
+        "\",\"audio_format\":\"wav\",\"audio_duration\":1.5,"
+        "\"words\":[{\"text\":\"Hi\",\"start\":0.0,\"end\":1.5}],"
+        "\"characters\":null}";
+    size_t b64_cap = (len + 2) / 3 * 4 + 1;
+    char* b64 = (char*)malloc(b64_cap);
+    char* json = (char*)malloc(strlen(head) + b64_cap * 4 + strlen(tail) + 1);
+    if (!b64 || !json) {
+        free(b64);
+        free(json);
+        return NULL;
+    }
+    size_t b64_len = b64_encode(audio, len, b64);
+    char* p = json + sprintf(json, "%s", head);
+    for (size_t i = 0; i < b64_len; i++) {
+        if (wrap && i > 0 && i % wrap == 0) {
+            *p++ = '\\';
+            *p++ = 'n';
+        }
+        if (b64[i] == '/') *p++ = '\\';
+        *p++ = b64[i];
+    }
+    strcpy(p, tail);
+    free(b64);
+    return json;
+}
+
+static char* build_audio_response_json(const uint8_t* audio, size_t len) {
+    return build_wrapped_audio_response_json(audio, len, 0);
+}
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    int calls;
+    int abort_after;
+} AudioCollector;
+
+static int collect_audio(const uint8_t* data, size_t len, void* user_data) {
+    AudioCollector* c = (AudioCollector*)user_data;
+    uint8_t* grown = (uint8_t*)realloc(c->data, c->size + len);
+    if (!grown) return 1;
+    memcpy(grown + c->size, data, len);
+    c->data = grown;
+    c->size += len;
+    c->calls++;
+    return c->abort_after > 0 && c->calls >= c->abort_after;
+}
+
+/* Decoded variant without a callback stores raw audio, not base64 */
+static void test_http_decoded_collects_audio(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+    mini_mock_enqueue_json(200, build_word_only_response_json());
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    TypecastTTSWithTimestampsDecodedResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps_decoded(client, &req, NULL, NULL, &resp);
+    ASSERT(rc == TYPECAST_OK);
+    ASSERT_NOT_NULL(resp);
+    ASSERT(resp->timestamps.audio_base64 == NULL);
+    ASSERT(resp->audio_size == 5);
+    ASSERT(memcmp(resp->audio_data, "AUDIO", 5) == 0);
+    ASSERT_STREQ(resp->timestamps.audio_format, "wav");
+    ASSERT(resp->timestamps.words_count == 4);
+    ASSERT_STREQ(resp->timestamps.words[3].text, "you?");
+
+    /* The embedded response works with the caption helpers */
+    char* srt = NULL;
+    rc = typecast_tts_with_timestamps_response_to_srt(&resp->timestamps, &srt);
+    ASSERT(rc == TYPECAST_OK);
+    ASSERT(srt && strstr(srt, "you?") != NULL);
+    free(srt);
+
+    typecast_tts_with_timestamps_decoded_response_free(resp);
+    typecast_client_destroy(client);
+}
+
+/* Audio larger than the decode chunk arrives through the callback intact */
+static void test_http_decoded_callback_large_audio(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+
+    size_t len = 100000;
+    uint8_t* audio = (uint8_t*)malloc(len);
+    ASSERT_NOT_NULL(audio);
+    for (size_t i = 0; i < len; i++) audio[i] = (uint8_t)((i * 131u) ^ (i >> 7));
+    char* json = build_audio_response_json(audio, len);
+    ASSERT_NOT_NULL(json);
+    mini_mock_enqueue_json(200, json);
+    free(json);
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    AudioCollector collector = {0};
+    TypecastTTSWithTimestampsDecodedResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps_decoded(
+        client, &req, collect_audio, &collector, &resp);
+    int matches = collector.size == len && memcmp(collector.data, audio, len) == 0;
+    free(collector.data);
+    free(audio);
+    ASSERT(rc == TYPECAST_OK);
+    ASSERT_NOT_NULL(resp);
+    ASSERT(matches);
+    ASSERT(collector.calls > 1);
+    ASSERT(resp->timestamps.audio_base64 == NULL && resp->audio_data == NULL);
+    ASSERT(resp->timestamps.words_count == 1);
+
+    typecast_tts_with_timestamps_decoded_response_free(resp);
+    typecast_client_destroy(client);
+}
+
+/* The default API keeps escaped base64 byte-identical after unescaping */
+static void test_http_escaped_base64_roundtrip(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+
+    uint8_t audio[300];
+    for (size_t i = 0; i < sizeof(audio); i++) audio[i] = (uint8_t)(255 - i);
+    char* json = build_audio_response_json(audio, sizeof(audio));
+    ASSERT_NOT_NULL(json);
+    mini_mock_enqueue_json(200, json);
+    free(json);
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps(client, &req, &resp);
+    ASSERT(rc == TYPECAST_OK);
+    ASSERT_NOT_NULL(resp);
+    ASSERT(strchr(resp->audio_base64, '\\') == NULL);
+
+    uint8_t* bytes = NULL;
+    size_t size = 0;
+    rc = typecast_tts_with_timestamps_response_audio_bytes(resp, &bytes, &size);
+    ASSERT(rc == TYPECAST_OK);
+    int matches = size == sizeof(audio) && memcmp(bytes, audio, size) == 0;
+    free(bytes);
+    ASSERT(matches);
+
+    typecast_tts_with_timestamps_response_free(resp);
+    typecast_client_destroy(client);
+}
+
+static void test_http_decoded_callback_abort(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+    mini_mock_enqueue_json(200, build_word_only_response_json());
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    AudioCollector collector = {0};
+    collector.abort_after = 1;
+    TypecastTTSWithTimestampsDecodedResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps_decoded(
+        client, &req, collect_audio, &collector, &resp);
+    free(collector.data);
+    ASSERT(rc == TYPECAST_ERROR_NETWORK);
+    ASSERT(resp == NULL);
+    ASSERT_STREQ(typecast_client_get_error(client)->message, "Stream aborted by callback");
+
+    typecast_client_destroy(client);
+}
+
+static void test_http_decoded_invalid_base64(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+    mini_mock_enqueue_json(200,
+        "{\"audio\":\"QVV*ESU8=\",\"audio_format\":\"wav\",\"audio_duration\":1.0}");
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    TypecastTTSWithTimestampsDecodedResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps_decoded(client, &req, NULL, NULL, &resp);
+    ASSERT(rc == TYPECAST_ERROR_JSON_PARSE);
+    ASSERT(resp == NULL);
+
+    typecast_client_destroy(client);
+}
+
+/* Unknown members of any shape are skipped; key lookup is case-insensitive
+ * and the first occurrence of a key wins, as with cJSON */
+static void test_http_skips_unknown_fields(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+    mini_mock_enqueue_json(200,
+        "{ \"meta\" : {\"nested\":[1,-2.5e3,{\"x\":\"}]\\\"\"},true,false,null]} ,\n"
+        "  \"Audio\":\"QVVESU8=\", \"audio\":\"ignored\",\n"
+        "  \"audio_format\":\"mp3\", \"audio_duration\": 2.5E0,\n"
+        "  \"words\":[{\"extra\":{\"a\":[]},\"TEXT\":\"\\\"q\\\"\\n\",\"start\":1e-1,\"end\":5E-1}]\n"
+        "} trailing");
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps(client, &req, &resp);
+    ASSERT(rc == TYPECAST_OK);
+    ASSERT_NOT_NULL(resp);
+    ASSERT_STREQ(resp->audio_base64, "QVVESU8=");
+    ASSERT_STREQ(resp->audio_format, "mp3");
+    ASSERT(resp->audio_duration > 2.49f && resp->audio_duration < 2.51f);
+    ASSERT(resp->words_count == 1);
+    ASSERT_STREQ(resp->words[0].text, "\"q\"\n");
+    ASSERT(resp->words[0].start > 0.09f && resp->words[0].start < 0.11f);
+    ASSERT(resp->words[0].end > 0.49f && resp->words[0].end < 0.51f);
+    ASSERT(resp->characters == NULL);
+
+    typecast_tts_with_timestamps_response_free(resp);
+    typecast_client_destroy(client);
+}
+
+/* A list element that is not an object invalidates the whole list */
+static void test_http_non_object_segment(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+    mini_mock_enqueue_json(200,
+        "{\"audio\":\"\",\"audio_format\":\"wav\",\"audio_duration\":1.0,"
+        "\"words\":[{\"text\":\"a\",\"start\":0,\"end\":1},\"b\"],"
+        "\"characters\":[{\"text\":\"c\",\"start\":0,\"end\":1}]}");
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps(client, &req, &resp);
+    ASSERT(rc == TYPECAST_OK);
+    ASSERT_NOT_NULL(resp);
+    ASSERT_STREQ(resp->audio_base64, "");
+    ASSERT(resp->words == NULL && resp->words_count == 0);
+    ASSERT(resp->characters_count == 1);
+
+    typecast_tts_with_timestamps_response_free(resp);
+    typecast_client_destroy(client);
+}
+
+static void test_http_truncated_json(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+    mini_mock_enqueue_json(200, "{\"audio\":\"QVVESU8=\",\"words\":[{\"text\":\"a\"");
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps(client, &req, &resp);
+    ASSERT(rc == TYPECAST_ERROR_JSON_PARSE);
+    ASSERT(resp == NULL);
+
+    typecast_client_destroy(client);
+}
+
+/* ============================================
+ * Base64 decoding tests
+ * ============================================ */
+
+static void fill_pattern(uint8_t* buf, size_t len, uint32_t seed) {
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+static int decodes_to(const char* b64, const uint8_t* expected, size_t len) {
+    TypecastTTSWithTimestampsResponse resp = {0};
+    resp.audio_base64 = (char*)b64;
+    uint8_t* bytes = NULL;
+    size_t size = 0;
+    if (typecast_tts_with_timestamps_response_audio_bytes(&resp, &bytes, &size) != TYPECAST_OK) return 0;
+    int ok = size == len && (len == 0 || memcmp(bytes, expected, len) == 0);
+    free(bytes);
+    return ok;
+}
+
+/* Every length around the SIMD block sizes decodes like the scalar loop */
+static void test_audio_bytes_lengths(void) {
+    static const size_t large[] = {1000, 4099, 65536, 100003};
+    uint8_t* audio = (uint8_t*)malloc(100003);
+    char* b64 = (char*)malloc((100003 + 2) / 3 * 4 + 1);
+    ASSERT_NOT_NULL(audio);
+    ASSERT_NOT_NULL(b64);
+    fill_pattern(audio, 100003, 7);
+
+    int ok = 1;
+    for (size_t len = 0; len <= 200 && ok; len++) {
+        b64_encode(audio, len, b64);
+        ok = decodes_to(b64, audio, len);
+    }
+    for (size_t k = 0; k < sizeof(large) / sizeof(large[0]) && ok; k++) {
+        b64_encode(audio, large[k], b64);
+        ok = decodes_to(b64, audio, large[k]);
+    }
+    free(audio);
+    free(b64);
+    ASSERT(ok);
+}
+
+/* A bad character is rejected wherever it falls, inside a SIMD block or
+ * in the scalar tail */
+static void test_audio_bytes_invalid_anywhere(void) {
+    uint8_t audio[150];
+    char b64[201];
+    fill_pattern(audio, sizeof(audio), 11);
+    size_t b64_len = b64_encode(audio, sizeof(audio), b64);
+
+    int rejected = 1;
+    for (size_t pos = 0; pos < b64_len && rejected; pos++) {
+        char saved = b64[pos];
+        b64[pos] = (pos % 3 == 0) ? '*' : (pos % 3 == 1 ? '\x80' : '-');
+        TypecastTTSWithTimestampsResponse resp = {0};
+        resp.audio_base64 = b64;
+        uint8_t* bytes = NULL;
+        size_t size = 0;
+        rejected = typecast_tts_with_timestamps_response_audio_bytes(&resp, &bytes, &size)
+                   == TYPECAST_ERROR_JSON_PARSE;
+        free(bytes);
+        b64[pos] = saved;
+    }
+    ASSERT(rejected);
+
+    /* Every byte value at a position the vector kernels handle */
+    int classified = 1;
+    for (int c = 1; c < 256 && classified; c++) {
+        if (c == '=') continue;
+        char saved = b64[5];
+        b64[5] = (char)c;
+        TypecastTTSWithTimestampsResponse resp = {0};
+        resp.audio_base64 = b64;
+        uint8_t* bytes = NULL;
+        size_t size = 0;
+        TypecastErrorCode rc = typecast_tts_with_timestamps_response_audio_bytes(&resp, &bytes, &size);
+        int valid = strchr(B64_ALPHABET, c) != NULL;
+        classified = valid ? (rc == TYPECAST_OK && size == sizeof(audio)) : rc == TYPECAST_ERROR_JSON_PARSE;
+        free(bytes);
+        b64[5] = saved;
+    }
+    ASSERT(classified);
+}
+
+/* SDK responses decode once; later calls reuse the result */
+static void test_http_audio_bytes_cached(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+    mini_mock_enqueue_json(200, build_word_only_response_json());
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    TypecastTTSWithTimestampsResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps(client, &req, &resp);
+    ASSERT(rc == TYPECAST_OK);
+    ASSERT_NOT_NULL(resp);
+
+    uint8_t* first = NULL;
+    size_t first_size = 0;
+    rc = typecast_tts_with_timestamps_response_audio_bytes(resp, &first, &first_size);
+    ASSERT(rc == TYPECAST_OK);
+
+    /* Were the base64 decoded again, this would now fail */
+    resp->audio_base64[0] = '!';
+    uint8_t* second = NULL;
+    size_t second_size = 0;
+    rc = typecast_tts_with_timestamps_response_audio_bytes(resp, &second, &second_size);
+    int same = rc == TYPECAST_OK && second_size == first_size && memcmp(first, second, first_size) == 0;
+    int distinct = first != second;
+    free(first);
+    free(second);
+    ASSERT(same);
+    ASSERT(distinct);
+
+    char tmp_path[256];
+    snprintf(tmp_path, sizeof(tmp_path), "/tmp/typecast_test_cached_%d.wav", (int)getpid());
+    rc = typecast_tts_with_timestamps_response_save_audio(resp, tmp_path);
+    remove(tmp_path);
+    ASSERT(rc == TYPECAST_OK);
+
+    typecast_tts_with_timestamps_response_free(resp);
+    typecast_client_destroy(client);
+}
+
+/* Line-wrapped base64 interleaves vector blocks with scalar whitespace */
+static void test_http_decoded_wrapped_base64(void) {
+    TypecastClient* client = mini_new_client();
+    ASSERT_NOT_NULL(client);
+
+    size_t len = 20000;
+    uint8_t* audio = (uint8_t*)malloc(len);
+    ASSERT_NOT_NULL(audio);
+    fill_pattern(audio, len, 3);
+    char* json = build_wrapped_audio_response_json(audio, len, 76);
+    ASSERT_NOT_NULL(json);
+    mini_mock_enqueue_json(200, json);
+    free(json);
+
+    TypecastTTSRequestWithTimestamps req = http_default_request();
+    TypecastTTSWithTimestampsDecodedResponse* resp = NULL;
+    TypecastErrorCode rc = typecast_text_to_speech_with_timestamps_decoded(client, &req, NULL, NULL, &resp);
+    int matches = rc == TYPECAST_OK && resp && resp->audio_size == len &&
+                  memcmp(resp->audio_data, audio, len) == 0;
+    free(audio);
+    ASSERT(matches);
+
+    typecast_tts_with_timestamps_decoded_response_free(resp);
+    typecast_client_destroy(client);
+}
+
 /* ============================================
  * main
  * ============================================ */
@@ -1267,6 +1699,18 @@ int main(void) {
     RUN(http_malformed_second_segment_no_text);
     RUN(http_response_with_characters);
     RUN(http_response_unicode_escape);
+    RUN(http_decoded_collects_audio);
+    RUN(http_decoded_callback_large_audio);
+    RUN(http_escaped_base64_roundtrip);
+    RUN(http_decoded_callback_abort);
+    RUN(http_decoded_invalid_base64);
+    RUN(http_skips_unknown_fields);
+    RUN(http_non_object_segment);
+    RUN(http_truncated_json);
+    RUN(audio_bytes_lengths);
+    RUN(audio_bytes_invalid_anywhere);
+    RUN(http_audio_bytes_cached);
+    RUN(http_decoded_wrapped_base64);
 
     mini_mock_shutdown();
 
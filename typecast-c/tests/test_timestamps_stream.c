@@ -0,0 +1,271 @@
+/**
+ * Streaming with-timestamps tests: audio chunks and alignment segments
+ * delivered to callbacks while the response arrives
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+/* "AUDIO-AUDIO-AUDIO" */
+static const char BOTH_JSON[] =
+    "{\"audio\":\"QVVESU8tQVVESU8tQVVESU8=\",\"audio_format\":\"wav\",\"audio_duration\":1.0,"
+    "\"words\":[{\"text\":\"Hello\",\"start\":0.0,\"end\":0.4},{\"text\":\"world\",\"start\":0.5,\"end\":0.9}],"
+    "\"characters\":[{\"text\":\"H\",\"start\":0.0,\"end\":0.1}]}";
+
+static const char BROKEN_WORDS_JSON[] =
+    "{\"audio\":\"QVVESU8=\",\"words\":[{\"text\":\"one\",\"start\":0,\"end\":1},7,"
+    "{\"text\":\"two\",\"start\":1,\"end\":2}],\"characters\":[{\"text\":\"o\",\"start\":0,\"end\":0.5}]}";
+
+typedef struct {
+    const char* body;
+    size_t body_len;
+    int chunk_size;
+    int chunk_delay_ms;
+    int requests;
+} Plan;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    (void)req;
+    Plan* plan = (Plan*)user_data;
+    plan->requests++;
+    resp->body = (const uint8_t*)plan->body;
+    resp->body_len = plan->body_len ? plan->body_len : strlen(plan->body);
+    resp->chunk_size = plan->chunk_size;
+    resp->chunk_delay_ms = plan->chunk_delay_ms;
+}
+
+#define MAX_EVENTS 16
+
+typedef struct {
+    TypecastAlignmentKind kinds[MAX_EVENTS];
+    char texts[MAX_EVENTS][16];
+    float starts[MAX_EVENTS];
+    int count;
+    int abort_after;                 /* non-zero: abort at this event */
+    uint8_t audio[256];
+    size_t audio_size;
+    int audio_calls;
+    uint64_t first_segment_at;
+    uint64_t first_audio_at;
+} Events;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000);
+}
+
+static int on_segment(TypecastAlignmentKind kind, const TypecastAlignmentSegment* segment, void* user_data) {
+    Events* e = (Events*)user_data;
+    if (e->count == 0) e->first_segment_at = now_ms();
+    if (e->count < MAX_EVENTS) {
+        e->kinds[e->count] = kind;
+        snprintf(e->texts[e->count], sizeof(e->texts[0]), "%s", segment->text);
+        e->starts[e->count] = segment->start;
+    }
+    e->count++;
+    return e->abort_after && e->count >= e->abort_after;
+}
+
+static int on_audio(const uint8_t* data, size_t len, void* user_data) {
+    Events* e = (Events*)user_data;
+    if (e->audio_calls++ == 0) e->first_audio_at = now_ms();
+    if (e->audio_size + len <= sizeof(e->audio)) memcpy(e->audio + e->audio_size, data, len);
+    e->audio_size += len;
+    return 0;
+}
+
+static TypecastClient* new_client(MockServer* server, Plan* plan, const TypecastClientOptions* options) {
+    mock_server_start(server, route, plan);
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    return typecast_client_create_with_options("test-key", host, options);
+}
+
+static TypecastTTSRequestWithTimestamps ts_request(void) {
+    TypecastTTSRequestWithTimestamps req = {0};
+    req.text = "Hello world";
+    req.voice_id = "tc_voice";
+    req.model = TYPECAST_MODEL_SSFM_V30;
+    return req;
+}
+
+static void test_delivers_audio_and_segments(void) {
+    MockServer server;
+    Plan plan = {BOTH_JSON, 0, 7, 0, 0};
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastTTSRequestWithTimestamps req = ts_request();
+    Events e = {0};
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, &req, on_audio, on_segment, &e), TYPECAST_OK);
+
+    ASSERT_EQ(e.audio_size, strlen("AUDIO-AUDIO-AUDIO"));
+    ASSERT(memcmp(e.audio, "AUDIO-AUDIO-AUDIO", e.audio_size) == 0);
+    ASSERT_EQ(e.count, 3);
+    ASSERT_EQ(e.kinds[0], TYPECAST_ALIGNMENT_WORD);
+    ASSERT(strcmp(e.texts[0], "Hello") == 0);
+    ASSERT(strcmp(e.texts[1], "world") == 0);
+    ASSERT(e.starts[1] > 0.49f && e.starts[1] < 0.51f);
+    ASSERT_EQ(e.kinds[2], TYPECAST_ALIGNMENT_CHARACTER);
+    ASSERT(strcmp(e.texts[2], "H") == 0);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+/* Segments sent ahead of a long audio string reach the caller before the
+ * rest of the body has arrived */
+static void test_first_caption_before_body_ends(void) {
+    size_t audio_chars = 64 * 1024;
+    char* body = (char*)malloc(audio_chars + 256);
+    ASSERT(body != NULL);
+    int len = snprintf(body, 256,
+        "{\"words\":[{\"text\":\"Early\",\"start\":0,\"end\":0.3}],\"audio_format\":\"wav\",\"audio\":\"");
+    memset(body + len, 'A', audio_chars);
+    strcpy(body + len + audio_chars, "\"}");
+
+    MockServer server;
+    Plan plan = {body, 0, 4096, 15, 0};
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastTTSRequestWithTimestamps req = ts_request();
+    Events e = {0};
+    uint64_t started = now_ms();
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, &req, on_audio, on_segment, &e), TYPECAST_OK);
+    uint64_t finished = now_ms();
+
+    ASSERT_EQ(e.count, 1);
+    ASSERT(strcmp(e.texts[0], "Early") == 0);
+    ASSERT_EQ(e.audio_size, audio_chars / 4 * 3);
+    /* ~16 chunks 15 ms apart: the caption came with the first one, and
+     * audio was handed over chunk by chunk */
+    ASSERT(finished - started >= 150);
+    ASSERT(e.first_segment_at - started < (finished - started) / 2);
+    ASSERT(e.audio_calls > 1);
+    ASSERT(e.first_audio_at < finished - 50);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+    free(body);
+}
+
+static void test_segments_without_audio(void) {
+    MockServer server;
+    Plan plan = {BOTH_JSON, 0, 0, 0, 0};
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastTTSRequestWithTimestamps req = ts_request();
+    Events e = {0};
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, &req, NULL, on_segment, &e), TYPECAST_OK);
+    ASSERT_EQ(e.count, 3);
+    ASSERT_EQ(e.audio_calls, 0);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_segment_callback_aborts(void) {
+    MockServer server;
+    Plan plan = {BOTH_JSON, 0, 0, 0, 0};
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastTTSRequestWithTimestamps req = ts_request();
+    Events e = {0};
+    e.abort_after = 1;
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, &req, on_audio, on_segment, &e),
+              TYPECAST_ERROR_NETWORK);
+    ASSERT_EQ(e.count, 1);
+    const TypecastError* error = typecast_client_get_error(client);
+    ASSERT(error->message && strstr(error->message, "aborted") != NULL);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_malformed_list_stops_its_events(void) {
+    MockServer server;
+    Plan plan = {BROKEN_WORDS_JSON, 0, 0, 0, 0};
+    TypecastClient* client = new_client(&server, &plan, NULL);
+    TypecastTTSRequestWithTimestamps req = ts_request();
+    Events e = {0};
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, &req, on_audio, on_segment, &e), TYPECAST_OK);
+    ASSERT_EQ(e.count, 2);
+    ASSERT(strcmp(e.texts[0], "one") == 0);
+    ASSERT_EQ(e.kinds[1], TYPECAST_ALIGNMENT_CHARACTER);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_cached_result_replays_events(void) {
+    MockServer server;
+    Plan plan = {BOTH_JSON, 0, 0, 0, 0};
+    TypecastClientOptions options = {0};
+    options.result_cache_max_bytes = 1 << 20;
+    TypecastClient* client = new_client(&server, &plan, &options);
+    TypecastTTSRequestWithTimestamps req = ts_request();
+    req.seed = 42;
+    Events first = {0}, second = {0};
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, &req, on_audio, on_segment, &first), TYPECAST_OK);
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, &req, on_audio, on_segment, &second), TYPECAST_OK);
+    ASSERT_EQ(plan.requests, 1);
+    ASSERT_EQ(second.count, first.count);
+    ASSERT_EQ(second.audio_size, first.audio_size);
+    ASSERT(strcmp(second.texts[1], "world") == 0);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_invalid_params(void) {
+    TypecastTTSRequestWithTimestamps req = ts_request();
+    Events e = {0};
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(NULL, &req, on_audio, on_segment, &e),
+              TYPECAST_ERROR_INVALID_PARAM);
+    TypecastClient* client = typecast_client_create_with_host("test-key", "http://127.0.0.1:1");
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, &req, on_audio, NULL, &e),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_client_get_error(client)->code, TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(typecast_text_to_speech_with_timestamps_stream(client, NULL, on_audio, on_segment, &e),
+              TYPECAST_ERROR_INVALID_PARAM);
+    ASSERT_EQ(e.count, 0);
+    typecast_client_destroy(client);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Streaming Timestamps Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(delivers_audio_and_segments);
+    RUN(first_caption_before_body_ends);
+    RUN(segments_without_audio);
+    RUN(segment_callback_aborts);
+    RUN(malformed_list_stops_its_events);
+    RUN(cached_result_replays_events);
+    RUN(invalid_params);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
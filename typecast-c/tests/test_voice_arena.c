@@ -0,0 +1,320 @@
+/**
+ * Voice arena tests: voice lists, single voices and recommendations are
+ * parsed into one block each, keep every field of the old layout, and
+ * values built outside the SDK are still released by the free functions
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_STREQ(a, b) ASSERT((a) && strcmp((a), (b)) == 0)
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+static const char VOICES[] =
+    "[{\"voice_id\":\"tc_one\",\"voice_name\":\"One\",\"gender\":\"female\",\"age\":\"young_adult\","
+    "\"models\":[{\"version\":\"ssfm-v30\",\"emotions\":[\"normal\",\"happy\",\"sad\"]},"
+    "{\"version\":\"ssfm-v21\",\"emotions\":[\"normal\"]}],\"use_cases\":[\"Audiobook\",\"Ads\"]},"
+    "{\"voice_id\":\"tc_two\",\"voice_name\":\"Two\",\"gender\":\"male\",\"age\":\"elder\","
+    "\"models\":[{\"version\":\"ssfm-v21\",\"emotions\":[\"normal\"]}]}]";
+static const char ODD_VOICES[] =
+    "[42,{\"voice_name\":\"Nameless\",\"models\":[\"bogus\",{\"version\":\"nope\",\"emotions\":[1,\"calm\"]}],"
+    "\"use_cases\":[]},{}]";
+static const char VOICE_ONE[] =
+    "{\"voice_id\":\"tc_one\",\"voice_name\":\"One\",\"models\":[{\"version\":\"ssfm-v30\","
+    "\"emotions\":[\"normal\",\"happy\"]}],\"use_cases\":[\"Audiobook\"]}";
+static const char VOICE_NAME_ONLY[] = "{\"voice_name\":\"Only a name\"}";
+static const char VOICE_USE_CASES[] = "{\"use_cases\":[\"Game\"],\"voice_id\":\"tc_game\"}";
+static const char RECOMMENDED[] =
+    "[{\"voice_id\":\"tc_one\",\"voice_name\":\"One\",\"score\":0.91},"
+    "\"junk\",{\"voice_id\":\"tc_two\",\"score\":0.5}]";
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    (void)user_data;
+    const char* body = VOICES;
+    if (strncmp(req->path, "/v2/voices?model=ssfm-v21", 25) == 0) body = ODD_VOICES;
+    else if (strcmp(req->path, "/v2/voices/tc_one") == 0) body = VOICE_ONE;
+    else if (strcmp(req->path, "/v2/voices/name_only") == 0) body = VOICE_NAME_ONLY;
+    else if (strcmp(req->path, "/v2/voices/game") == 0) body = VOICE_USE_CASES;
+    else if (strncmp(req->path, "/v1/voices/recommendations", 26) == 0) {
+        body = strstr(req->path, "count=1") ? "[]" : RECOMMENDED;
+    }
+    resp->body = (const uint8_t*)body;
+    resp->body_len = strlen(body);
+}
+
+static TypecastClient* new_client(MockServer* server, unsigned long cache_ttl) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    TypecastClientOptions options = {0};
+    options.voice_cache_ttl_secs = cache_ttl;
+    return typecast_client_create_with_options("test-key", host, &options);
+}
+
+/* The strings of an arena value follow the value itself */
+static int inside(const void* base, const void* p) {
+    return (uintptr_t)p > (uintptr_t)base && (uintptr_t)p < (uintptr_t)base + 4096;
+}
+
+static void test_list_keeps_every_field(void) {
+    MockServer server;
+    mock_server_start(&server, route, NULL);
+    TypecastClient* client = new_client(&server, 0);
+
+    TypecastVoicesResponse* voices = typecast_get_voices(client, NULL);
+    ASSERT(voices != NULL);
+    ASSERT_EQ(voices->count, 2);
+    TypecastVoice* one = &voices->voices[0];
+    ASSERT_STREQ(one->voice_id, "tc_one");
+    ASSERT_STREQ(one->voice_name, "One");
+    ASSERT_EQ(one->gender, TYPECAST_GENDER_FEMALE);
+    ASSERT_EQ(one->age, TYPECAST_AGE_YOUNG_ADULT);
+    ASSERT_EQ(one->models_count, 2);
+    ASSERT_EQ(one->models[0].version, TYPECAST_MODEL_SSFM_V30);
+    ASSERT_EQ(one->models[0].emotions_count, 3);
+    ASSERT_STREQ(one->models[0].emotions[2], "sad");
+    ASSERT_EQ(one->models[1].version, TYPECAST_MODEL_SSFM_V21);
+    ASSERT_STREQ(one->models[1].emotions[0], "normal");
+    ASSERT_EQ(one->use_cases_count, 2);
+    ASSERT_STREQ(one->use_cases[1], "Ads");
+    ASSERT_STREQ(voices->voices[1].voice_id, "tc_two");
+    ASSERT_EQ(voices->voices[1].gender, TYPECAST_GENDER_MALE);
+    ASSERT_EQ(voices->voices[1].age, TYPECAST_AGE_ELDER);
+    ASSERT(voices->voices[1].use_cases == NULL);
+    ASSERT_EQ(voices->voices[1].use_cases_count, 0);
+
+    ASSERT(inside(voices, voices->voices));
+    ASSERT(inside(voices, one->models));
+    ASSERT(inside(voices, one->models[0].emotions));
+    ASSERT(inside(voices, one->use_cases[1]));
+    ASSERT(inside(voices, voices->voices[1].voice_name));
+    /* Strings sit back to back in one blob */
+    ASSERT(one->voice_name == one->voice_id + strlen("tc_one") + 1);
+
+    typecast_voices_response_free(voices);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_odd_items_are_tolerated(void) {
+    MockServer server;
+    mock_server_start(&server, route, NULL);
+    TypecastClient* client = new_client(&server, 0);
+
+    TypecastModel model = TYPECAST_MODEL_SSFM_V21;
+    TypecastVoicesFilter filter = {0};
+    filter.model = &model;
+    TypecastVoicesResponse* voices = typecast_get_voices(client, &filter);
+    ASSERT(voices != NULL);
+    ASSERT_EQ(voices->count, 3);
+    ASSERT(voices->voices[0].voice_id == NULL);
+    ASSERT(voices->voices[0].models == NULL);
+    TypecastVoice* nameless = &voices->voices[1];
+    ASSERT(nameless->voice_id == NULL);
+    ASSERT_STREQ(nameless->voice_name, "Nameless");
+    ASSERT_EQ(nameless->models_count, 2);
+    ASSERT(nameless->models[0].emotions == NULL);
+    ASSERT_EQ(nameless->models[1].emotions_count, 2);
+    ASSERT(nameless->models[1].emotions[0] == NULL);
+    ASSERT_STREQ(nameless->models[1].emotions[1], "calm");
+    ASSERT(nameless->use_cases == NULL);
+    ASSERT_EQ(nameless->use_cases_count, 0);
+    ASSERT(voices->voices[2].voice_name == NULL);
+
+    typecast_voices_response_free(voices);
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_single_voices_free_in_one_call(void) {
+    MockServer server;
+    mock_server_start(&server, route, NULL);
+    TypecastClient* client = new_client(&server, 0);
+
+    TypecastVoice* voice = typecast_get_voice(client, "tc_one");
+    ASSERT(voice != NULL);
+    ASSERT_STREQ(voice->voice_id, "tc_one");
+    ASSERT_STREQ(voice->models[0].emotions[1], "happy");
+    ASSERT(inside(voice, voice->use_cases[0]));
+    typecast_voice_free(voice);
+
+    voice = typecast_get_voice(client, "name_only");
+    ASSERT(voice != NULL);
+    ASSERT(voice->voice_id == NULL);
+    ASSERT_STREQ(voice->voice_name, "Only a name");
+    typecast_voice_free(voice);
+
+    voice = typecast_get_voice(client, "game");
+    ASSERT(voice != NULL);
+    ASSERT(voice->models == NULL);
+    ASSERT_STREQ(voice->use_cases[0], "Game");
+    ASSERT_STREQ(voice->voice_id, "tc_game");
+    typecast_voice_free(voice);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_cached_copies_are_arenas(void) {
+    MockServer server;
+    mock_server_start(&server, route, NULL);
+    TypecastClient* client = new_client(&server, 60);
+
+    TypecastVoicesResponse* first = typecast_get_voices(client, NULL);
+    TypecastVoicesResponse* second = typecast_get_voices(client, NULL);
+    ASSERT(first != NULL && second != NULL);
+    ASSERT(inside(second, second->voices[0].models[0].emotions[2]));
+    ASSERT_STREQ(second->voices[0].models[0].emotions[2], "sad");
+    typecast_voices_response_free(first);
+    typecast_voices_response_free(second);
+
+    /* Found in the cached list */
+    TypecastVoice* voice = typecast_get_voice(client, "tc_two");
+    ASSERT(voice != NULL);
+    ASSERT_STREQ(voice->voice_name, "Two");
+    ASSERT(inside(voice, voice->voice_name));
+    typecast_voice_free(voice);
+
+    /* Cached as a one-element list */
+    for (int i = 0; i < 2; i++) {
+        voice = typecast_get_voice(client, "game");
+        ASSERT(voice != NULL);
+        ASSERT_STREQ(voice->use_cases[0], "Game");
+        typecast_voice_free(voice);
+    }
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_recommendations(void) {
+    MockServer server;
+    mock_server_start(&server, route, NULL);
+    TypecastClient* client = new_client(&server, 0);
+
+    TypecastRecommendedVoicesResponse* rec = typecast_recommend_voices(client, "warm", 3);
+    ASSERT(rec != NULL);
+    ASSERT_EQ(rec->count, 3);
+    ASSERT_STREQ(rec->voices[0].voice_name, "One");
+    ASSERT(rec->voices[0].score > 0.9);
+    ASSERT(rec->voices[1].voice_id == NULL);
+    ASSERT_STREQ(rec->voices[2].voice_id, "tc_two");
+    ASSERT(rec->voices[2].voice_name == NULL);
+    ASSERT(inside(rec, rec->voices[2].voice_id));
+    typecast_recommended_voices_response_free(rec);
+
+    rec = typecast_recommend_voices(client, "warm", 1);
+    ASSERT(rec != NULL);
+    ASSERT_EQ(rec->count, 0);
+    typecast_recommended_voices_response_free(rec);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static char* copy_string(const char* s) {
+    char* copy = (char*)malloc(strlen(s) + 1);
+    strcpy(copy, s);
+    return copy;
+}
+
+static TypecastVoice hand_built_voice(void) {
+    TypecastVoice voice = {0};
+    voice.voice_id = copy_string("mine");
+    voice.voice_name = copy_string("Mine");
+    voice.models_count = 1;
+    voice.models = (TypecastModelInfo*)calloc(1, sizeof(TypecastModelInfo));
+    voice.models[0].emotions_count = 1;
+    voice.models[0].emotions = (char**)calloc(1, sizeof(char*));
+    voice.models[0].emotions[0] = copy_string("normal");
+    voice.use_cases_count = 1;
+    voice.use_cases = (char**)calloc(1, sizeof(char*));
+    voice.use_cases[0] = copy_string("Podcast");
+    return voice;
+}
+
+/* Heap bytes in use where glibc reports them, 0 elsewhere (sanitizer
+ * builds check the same through their leak report) */
+static size_t heap_in_use(void) {
+#if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
+#if __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#endif
+#endif
+    return 0;
+}
+
+static void free_hand_built_values(void) {
+    TypecastVoice* voice = (TypecastVoice*)malloc(sizeof(TypecastVoice));
+    *voice = hand_built_voice();
+    typecast_voice_free(voice);
+
+    TypecastVoicesResponse* list = (TypecastVoicesResponse*)malloc(sizeof(TypecastVoicesResponse));
+    list->count = 2;
+    list->voices = (TypecastVoice*)calloc(2, sizeof(TypecastVoice));
+    list->voices[0] = hand_built_voice();
+    list->voices[1] = hand_built_voice();
+    typecast_voices_response_free(list);
+
+    TypecastRecommendedVoicesResponse* rec =
+        (TypecastRecommendedVoicesResponse*)malloc(sizeof(TypecastRecommendedVoicesResponse));
+    rec->count = 1;
+    rec->voices = (TypecastRecommendedVoice*)calloc(1, sizeof(TypecastRecommendedVoice));
+    rec->voices[0].voice_id = copy_string("mine");
+    typecast_recommended_voices_response_free(rec);
+}
+
+/* Hand-built values are freed field by field: were any taken for an arena,
+ * the strings and arrays under it would pile up round after round (several
+ * hundred bytes each), far past what the allocator keeps cached */
+static void test_hand_built_values_still_free(void) {
+    free_hand_built_values();
+    size_t before = heap_in_use();
+    for (int round = 0; round < 1000; round++) free_hand_built_values();
+    size_t after = heap_in_use();
+    ASSERT(after < before + 64 * 1024);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Voice Arena Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(list_keeps_every_field);
+    RUN(odd_items_are_tolerated);
+    RUN(single_voices_free_in_one_call);
+    RUN(cached_copies_are_arenas);
+    RUN(recommendations);
+    RUN(hand_built_values_still_free);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,377 @@
+/**
+ * Voice cache tests: TTL hits, ETag revalidation, on-disk persistence and
+ * invalidation after voice cloning or deletion
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "typecast.h"
+#include "mock_server.h"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n  Assertion failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        return; \
+    } \
+} while (0)
+#define ASSERT_EQ(a, b) ASSERT((a) == (b))
+#define ASSERT_STREQ(a, b) ASSERT((a) && strcmp((a), (b)) == 0)
+#define RUN(name) do { \
+    printf("Running %s... ", #name); \
+    tests_run++; \
+    int before = tests_failed; \
+    test_##name(); \
+    if (tests_failed == before) printf("PASSED\n"); \
+} while (0)
+
+#define ETAG "\"catalog-v1\""
+
+static const char VOICES[] =
+    "[{\"voice_id\":\"tc_one\",\"voice_name\":\"One\",\"gender\":\"female\",\"age\":\"young_adult\","
+    "\"models\":[{\"version\":\"ssfm-v30\",\"emotions\":[\"normal\",\"happy\"]}],\"use_cases\":[\"Audiobook\"]},"
+    "{\"voice_id\":\"tc_two\",\"voice_name\":\"Two\",\"models\":[{\"version\":\"ssfm-v21\",\"emotions\":[\"normal\"]}]}]";
+static const char VOICE_THREE[] =
+    "{\"voice_id\":\"tc_three\",\"voice_name\":\"Three\",\"models\":[{\"version\":\"ssfm-v30\",\"emotions\":[\"normal\"]}]}";
+static const char RECOMMENDED[] = "[{\"voice_id\":\"tc_one\",\"voice_name\":\"One\"}]";
+
+typedef struct {
+    pthread_mutex_t lock;
+    int requests;
+    int conditional;     /* requests carrying If-None-Match */
+    int not_modified;    /* 304 answers sent */
+} Counters;
+
+static void route(const MockRequest* req, MockResponse* resp, void* user_data) {
+    Counters* counters = (Counters*)user_data;
+    const char* if_none_match = mock_find_header(req->headers, "If-None-Match");
+    pthread_mutex_lock(&counters->lock);
+    counters->requests++;
+    if (if_none_match) counters->conditional++;
+    pthread_mutex_unlock(&counters->lock);
+
+    if (strcmp(req->method, "DELETE") == 0) {
+        resp->status = 204;
+        return;
+    }
+    if (if_none_match && strncmp(if_none_match, ETAG, strlen(ETAG)) == 0) {
+        pthread_mutex_lock(&counters->lock);
+        counters->not_modified++;
+        pthread_mutex_unlock(&counters->lock);
+        resp->status = 304;
+        return;
+    }
+    const char* body = VOICES;
+    if (strncmp(req->path, "/v2/voices/tc_three", 19) == 0) body = VOICE_THREE;
+    else if (strncmp(req->path, "/v1/voices/recommendations", 26) == 0) body = RECOMMENDED;
+    snprintf(resp->headers, sizeof(resp->headers), "ETag: %s\r\n", ETAG);
+    resp->body = (const uint8_t*)body;
+    resp->body_len = strlen(body);
+}
+
+static int request_count(Counters* counters) {
+    pthread_mutex_lock(&counters->lock);
+    int n = counters->requests;
+    pthread_mutex_unlock(&counters->lock);
+    return n;
+}
+
+static void start(MockServer* server, Counters* counters) {
+    memset(counters, 0, sizeof(*counters));
+    pthread_mutex_init(&counters->lock, NULL);
+    mock_server_start(server, route, counters);
+}
+
+static TypecastClient* new_client(MockServer* server, const char* api_key, unsigned long ttl, const char* path) {
+    char host[64];
+    mock_server_host(server, host, sizeof(host));
+    TypecastClientOptions options = {0};
+    options.voice_cache_ttl_secs = ttl;
+    options.voice_cache_path = path;
+    return typecast_client_create_with_options(api_key, host, &options);
+}
+
+static void temp_path(char* path, size_t size, const char* name) {
+    snprintf(path, size, "/tmp/typecast_voice_cache_%d_%s.json", (int)getpid(), name);
+    remove(path);
+}
+
+static char* read_file(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* data = (char*)malloc((size_t)len + 1);
+    if (data && fread(data, 1, (size_t)len, f) != (size_t)len) {
+        free(data);
+        data = NULL;
+    }
+    if (data) data[len] = '\0';
+    fclose(f);
+    return data;
+}
+
+/* Age every saved entry so the next lookup has to revalidate */
+static void expire_file(const char* path) {
+    char* data = read_file(path);
+    if (!data) return;
+    FILE* f = fopen(path, "wb");
+    for (char* p = data; *p; ) {
+        char* field = strstr(p, "\"fetched_at\":");
+        if (!field) {
+            fputs(p, f);
+            break;
+        }
+        field += strlen("\"fetched_at\":");
+        fwrite(p, 1, (size_t)(field - p), f);
+        fputs("0", f);
+        p = field;
+        while (*p >= '0' && *p <= '9') p++;
+    }
+    fclose(f);
+    free(data);
+}
+
+static void test_disabled_by_default(void) {
+    MockServer server;
+    Counters counters;
+    start(&server, &counters);
+    TypecastClient* client = new_client(&server, "test-key", 0, NULL);
+    ASSERT(client != NULL);
+
+    for (int i = 0; i < 2; i++) {
+        TypecastVoicesResponse* voices = typecast_get_voices(client, NULL);
+        ASSERT(voices != NULL);
+        typecast_voices_response_free(voices);
+    }
+    ASSERT_EQ(request_count(&counters), 2);
+    typecast_voice_cache_clear(client);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_fresh_entry_skips_network(void) {
+    MockServer server;
+    Counters counters;
+    start(&server, &counters);
+    TypecastClient* client = new_client(&server, "test-key", 3600, NULL);
+
+    TypecastVoicesResponse* first = typecast_get_voices(client, NULL);
+    TypecastVoicesResponse* second = typecast_get_voices(client, NULL);
+    ASSERT(first != NULL && second != NULL);
+    ASSERT_EQ(request_count(&counters), 1);
+    ASSERT_EQ(second->count, 2);
+    ASSERT(second->voices != first->voices);
+    ASSERT_STREQ(second->voices[0].voice_id, "tc_one");
+    ASSERT_STREQ(second->voices[0].voice_name, "One");
+    ASSERT_EQ(second->voices[0].models_count, first->voices[0].models_count);
+    ASSERT_STREQ(second->voices[0].models[0].emotions[1], "happy");
+    ASSERT_STREQ(second->voices[0].use_cases[0], "Audiobook");
+    typecast_voices_response_free(first);
+    typecast_voices_response_free(second);
+
+    /* Different filters are different entries */
+    TypecastModel model = TYPECAST_MODEL_SSFM_V30;
+    TypecastVoicesFilter filter = {0};
+    filter.model = &model;
+    TypecastVoicesResponse* filtered = typecast_get_voices(client, &filter);
+    ASSERT(filtered != NULL);
+    typecast_voices_response_free(filtered);
+    ASSERT_EQ(request_count(&counters), 2);
+
+    /* Recommendations are cached as raw bodies and parsed per call */
+    for (int i = 0; i < 2; i++) {
+        TypecastRecommendedVoicesResponse* rec = typecast_recommend_voices(client, "calm narrator", 1);
+        ASSERT(rec != NULL);
+        ASSERT_EQ(rec->count, 1);
+        typecast_recommended_voices_response_free(rec);
+    }
+    ASSERT_EQ(request_count(&counters), 3);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_single_voice_from_catalog(void) {
+    MockServer server;
+    Counters counters;
+    start(&server, &counters);
+    TypecastClient* client = new_client(&server, "test-key", 3600, NULL);
+
+    TypecastVoicesResponse* voices = typecast_get_voices(client, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+
+    TypecastVoice* two = typecast_get_voice(client, "tc_two");
+    ASSERT(two != NULL);
+    ASSERT_STREQ(two->voice_name, "Two");
+    typecast_voice_free(two);
+    ASSERT_EQ(request_count(&counters), 1);
+
+    /* Voices missing from the catalog get their own entry */
+    for (int i = 0; i < 2; i++) {
+        TypecastVoice* three = typecast_get_voice(client, "tc_three");
+        ASSERT(three != NULL);
+        ASSERT_STREQ(three->voice_id, "tc_three");
+        typecast_voice_free(three);
+    }
+    ASSERT_EQ(request_count(&counters), 2);
+
+    typecast_client_destroy(client);
+    mock_server_stop(&server);
+}
+
+static void test_stale_entry_revalidates_with_etag(void) {
+    MockServer server;
+    Counters counters;
+    start(&server, &counters);
+    char path[256];
+    temp_path(path, sizeof(path), "stale");
+
+    TypecastClient* writer = new_client(&server, "test-key", 3600, path);
+    TypecastVoicesResponse* voices = typecast_get_voices(writer, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+    typecast_client_destroy(writer);
+    expire_file(path);
+
+    TypecastClient* client = new_client(&server, "test-key", 3600, path);
+    voices = typecast_get_voices(client, NULL);
+    ASSERT(voices != NULL);
+    ASSERT_EQ(voices->count, 2);
+    ASSERT_STREQ(voices->voices[1].voice_id, "tc_two");
+    typecast_voices_response_free(voices);
+    ASSERT_EQ(counters.conditional, 1);
+    ASSERT_EQ(counters.not_modified, 1);
+
+    /* The 304 refreshed the entry */
+    voices = typecast_get_voices(client, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+    ASSERT_EQ(request_count(&counters), 2);
+
+    typecast_client_destroy(client);
+    remove(path);
+    mock_server_stop(&server);
+}
+
+static void test_disk_cache_warms_new_client(void) {
+    MockServer server;
+    Counters counters;
+    start(&server, &counters);
+    char path[256];
+    temp_path(path, sizeof(path), "warm");
+
+    TypecastClient* writer = new_client(&server, "test-key", 3600, path);
+    TypecastVoicesResponse* voices = typecast_get_voices(writer, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+    typecast_client_destroy(writer);
+
+    char* saved = read_file(path);
+    ASSERT(saved != NULL);
+    ASSERT(strstr(saved, "test-key") == NULL);
+    free(saved);
+
+    TypecastClient* reader = new_client(&server, "test-key", 3600, path);
+    voices = typecast_get_voices(reader, NULL);
+    ASSERT(voices != NULL);
+    ASSERT_EQ(voices->count, 2);
+    typecast_voices_response_free(voices);
+    ASSERT_EQ(request_count(&counters), 1);
+    typecast_client_destroy(reader);
+
+    /* Another API key must not read the first key's catalog */
+    TypecastClient* other = new_client(&server, "other-key", 3600, path);
+    voices = typecast_get_voices(other, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+    ASSERT_EQ(request_count(&counters), 2);
+    ASSERT_EQ(counters.conditional, 0);
+    typecast_client_destroy(other);
+
+    remove(path);
+    mock_server_stop(&server);
+}
+
+static void test_corrupt_file_is_ignored(void) {
+    MockServer server;
+    Counters counters;
+    start(&server, &counters);
+    char path[256];
+    temp_path(path, sizeof(path), "corrupt");
+    FILE* f = fopen(path, "wb");
+    fputs("{\"version\":1,\"entries\":[", f);
+    fclose(f);
+
+    TypecastClient* client = new_client(&server, "test-key", 3600, path);
+    ASSERT(client != NULL);
+    TypecastVoicesResponse* voices = typecast_get_voices(client, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+    ASSERT_EQ(request_count(&counters), 1);
+
+    typecast_client_destroy(client);
+    remove(path);
+    mock_server_stop(&server);
+}
+
+static void test_clear_and_delete_invalidate(void) {
+    MockServer server;
+    Counters counters;
+    start(&server, &counters);
+    char path[256];
+    temp_path(path, sizeof(path), "clear");
+    TypecastClient* client = new_client(&server, "test-key", 3600, path);
+
+    TypecastVoicesResponse* voices = typecast_get_voices(client, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+    ASSERT(access(path, F_OK) == 0);
+
+    typecast_voice_cache_clear(client);
+    ASSERT(access(path, F_OK) != 0);
+    voices = typecast_get_voices(client, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+    ASSERT_EQ(request_count(&counters), 2);
+
+    ASSERT_EQ(typecast_delete_voice(client, "uc_gone"), TYPECAST_OK);
+    voices = typecast_get_voices(client, NULL);
+    ASSERT(voices != NULL);
+    typecast_voices_response_free(voices);
+    ASSERT_EQ(request_count(&counters), 4);
+    ASSERT_EQ(counters.conditional, 0);
+
+    typecast_client_destroy(client);
+    remove(path);
+    mock_server_stop(&server);
+}
+
+int main(void) {
+    printf("===========================================\n");
+    printf("Typecast C SDK - Voice Cache Tests\n");
+    printf("===========================================\n\n");
+
+    RUN(disabled_by_default);
+    RUN(fresh_entry_skips_network);
+    RUN(single_voice_from_catalog);
+    RUN(stale_entry_revalidates_with_etag);
+    RUN(disk_cache_warms_new_client);
+    RUN(corrupt_file_is_ignored);
+    RUN(clear_and_delete_invalidate);
+
+    printf("\n===========================================\n");
+    printf("Tests run: %d, Failed: %d\n", tests_run, tests_failed);
+    printf("===========================================\n");
+    return tests_failed > 0 ? 1 : 0;
+}